@@ -0,0 +1,171 @@
+#include "dsp/EqualizerStage.h"
+#include "dsp/ProcessingChain.h"
+#include "dsp/Resampler.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Compares the planar equalizer and resampler with the interleaved loops they
+// replace, on the same block sizes and signals as playback and file loading.
+// The planar timings include splitting and re-interleaving each block.
+
+namespace {
+
+const int kSampleRate = 44100;
+const size_t kBlockFrames = 1024;
+
+std::vector<float> Noise(size_t count) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<float> samples(count);
+    for (float& sample : samples) {
+        sample = dist(rng);
+    }
+    return samples;
+}
+
+template <typename Body>
+double MillisecondsPerSecondOfAudio(double seconds, Body body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / seconds;
+}
+
+// Interleaved biquad cascade, channel by channel over strided samples (as the
+// reference GPU job kernel runs it)
+void InterleavedEqualizer(float* samples, size_t frames, int channels, const EqualizerStage::Coefficients* c,
+                          std::vector<EqualizerStage::State>& state) {
+    for (int band = 0; band < EqualizerStage::kBandCount; band++) {
+        for (int ch = 0; ch < channels; ch++) {
+            EqualizerStage::State& s = state[band * channels + ch];
+            for (size_t i = 0; i < frames; i++) {
+                const size_t index = i * channels + ch;
+                const float x = samples[index];
+                const float y = c[band].b0 * x + s.z1;
+                s.z1 = c[band].b1 * x - c[band].a1 * y + s.z2;
+                s.z2 = c[band].b2 * x - c[band].a2 * y;
+                samples[index] = y;
+            }
+        }
+    }
+}
+
+void CompareEqualizer(int channels, double seconds) {
+    const size_t blocks = static_cast<size_t>(seconds * kSampleRate / kBlockFrames);
+    const std::vector<float> source = Noise(kBlockFrames * channels);
+    std::vector<float> samples(source.size());
+
+    EqualizerStage::Band low, high;
+    low.frequency = 100.0;
+    low.gainDb = 6.0;
+    high.frequency = 8000.0;
+    high.gainDb = -4.0;
+    high.q = 2.0;
+
+    // Same coefficients as the stage (RBJ peaking)
+    EqualizerStage::Coefficients coefficients[EqualizerStage::kBandCount];
+    const EqualizerStage::Band bands[] = {low, high};
+    for (int band = 0; band < EqualizerStage::kBandCount; band++) {
+        const double a = std::pow(10.0, bands[band].gainDb / 40.0);
+        const double w0 = 2.0 * 3.14159265358979323846 * bands[band].frequency / kSampleRate;
+        const double alpha = std::sin(w0) / (2.0 * bands[band].q);
+        const double a0 = 1.0 + alpha / a;
+        coefficients[band] = {static_cast<float>((1.0 + alpha * a) / a0), static_cast<float>(-2.0 * std::cos(w0) / a0),
+                              static_cast<float>((1.0 - alpha * a) / a0), static_cast<float>(-2.0 * std::cos(w0) / a0),
+                              static_cast<float>((1.0 - alpha / a) / a0)};
+    }
+    std::vector<EqualizerStage::State> state(EqualizerStage::kBandCount * channels);
+    double interleaved = MillisecondsPerSecondOfAudio(seconds, [&]() {
+        for (size_t block = 0; block < blocks; block++) {
+            std::copy(source.begin(), source.end(), samples.begin());
+            InterleavedEqualizer(samples.data(), kBlockFrames, channels, coefficients, state);
+        }
+    });
+
+    ProcessingChain chain;
+    chain.Prepare(channels, kBlockFrames);
+    auto stage = std::make_unique<EqualizerStage>(low, high);
+    stage->Prepare(kSampleRate, channels, kBlockFrames);
+    chain.SetStage("eq", std::move(stage));
+    double planar = MillisecondsPerSecondOfAudio(seconds, [&]() {
+        for (size_t block = 0; block < blocks; block++) {
+            std::copy(source.begin(), source.end(), samples.begin());
+            chain.Process(AudioBufferView(samples.data(), kBlockFrames, channels));
+        }
+    });
+
+    std::cout << std::left << std::setw(28) << ("Two-band EQ, " + std::to_string(channels) + " ch")
+              << std::setw(16) << interleaved << std::setw(16) << planar << interleaved / planar << "x\n";
+}
+
+// Interleaved polyphase filter over strided history, one pass per output frame
+size_t InterleavedResample(const PolyphaseResampler& design, const std::vector<float>& input, int channels,
+                           std::vector<float>& output) {
+    const size_t taps = design.GetTapCount();
+    const size_t frames = input.size() / channels;
+    const size_t outputFrames = frames * design.GetPhaseCount() / design.GetInputStep();
+    output.assign(outputFrames * channels, 0.0f);
+    for (size_t n = 0; n < outputFrames; n++) {
+        const size_t numerator = n * design.GetInputStep();
+        const size_t base = numerator / design.GetPhaseCount();
+        const float* coefficients = &design.GetPhaseTable()[(numerator % design.GetPhaseCount()) * taps];
+        if (base + 1 < taps / 2 || base + taps / 2 >= frames) {
+            continue;   // Edges are left silent; the timing covers the steady state
+        }
+        const float* history = &input[(base + 1 - taps / 2) * channels];
+        for (int ch = 0; ch < channels; ch++) {
+            float sum = 0.0f;
+            for (size_t j = 0; j < taps; j++) {
+                sum += coefficients[j] * history[j * channels + ch];
+            }
+            output[n * channels + ch] = sum;
+        }
+    }
+    return outputFrames;
+}
+
+void CompareResampler(int channels, double seconds) {
+    const std::vector<float> input = Noise(static_cast<size_t>(seconds * kSampleRate) * channels);
+    std::vector<float> output;
+    output.reserve(input.size() * 2);
+
+    PolyphaseResampler resampler;
+    resampler.Initialize(kSampleRate, 48000, channels);
+    double interleaved = MillisecondsPerSecondOfAudio(seconds, [&]() {
+        InterleavedResample(resampler, input, channels, output);
+    });
+    double planar = MillisecondsPerSecondOfAudio(seconds, [&]() {
+        output.clear();
+        resampler.Process(input.data(), input.size() / channels, output);
+        resampler.Flush(output);
+    });
+
+    std::cout << std::left << std::setw(28) << ("44.1 -> 48kHz, " + std::to_string(channels) + " ch")
+              << std::setw(16) << interleaved << std::setw(16) << planar << interleaved / planar << "x\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const double seconds = (argc > 1) ? std::atof(argv[1]) : 30.0;
+
+    std::cout << "=== DSP Layout Benchmark ===\n";
+    std::cout << "Milliseconds per second of " << kSampleRate << "Hz audio, " << kBlockFrames
+              << "-frame blocks, " << seconds << "s per case\n\n";
+    std::cout << std::left << std::setw(28) << "Stage" << std::setw(16) << "Interleaved" << std::setw(16)
+              << "Planar" << "Speedup\n";
+    std::cout << std::fixed << std::setprecision(3);
+
+    for (int channels : {1, 2, 6}) {
+        CompareEqualizer(channels, seconds);
+    }
+    for (int channels : {1, 2, 6}) {
+        CompareResampler(channels, seconds / 10.0);
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+# Writes SPIR-V binaries into a C++ header as uint32_t arrays.
+# Usage: cmake -DOUTPUT=<header> -DINPUTS="<name>=<file.spv>;..." -P EmbedSpirv.cmake
+
+file(WRITE "${OUTPUT}" "// Generated by cmake/EmbedSpirv.cmake - do not edit\n#pragma once\n#include <cstddef>\n#include <cstdint>\n\n")
+
+foreach(entry ${INPUTS})
+    string(REPLACE "=" ";" parts "${entry}")
+    list(GET parts 0 name)
+    list(GET parts 1 path)
+
+    file(READ "${path}" hex HEX)
+    string(REGEX MATCHALL "........" words "${hex}")
+
+    # SPIR-V is little-endian; rebuild each 32-bit word from its four bytes
+    set(body "")
+    set(column 0)
+    foreach(word ${words})
+        string(SUBSTRING "${word}" 0 2 b0)
+        string(SUBSTRING "${word}" 2 2 b1)
+        string(SUBSTRING "${word}" 4 2 b2)
+        string(SUBSTRING "${word}" 6 2 b3)
+        string(APPEND body "0x${b3}${b2}${b1}${b0}u,")
+        math(EXPR column "${column} + 1")
+        if(column EQUAL 8)
+            string(APPEND body "\n    ")
+            set(column 0)
+        else()
+            string(APPEND body " ")
+        endif()
+    endforeach()
+
+    file(APPEND "${OUTPUT}" "static const uint32_t ${name}[] = {\n    ${body}\n};\n\n")
+endforeach()
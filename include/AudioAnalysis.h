@@ -0,0 +1,46 @@
+#ifndef AUDIO_ANALYSIS_H
+#define AUDIO_ANALYSIS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Maximum number of channels with individual level meters
+const int kAnalysisMaxChannels = 16;
+
+// FFT size used for the live spectrum
+const size_t kSpectrumFFTSize = 2048;
+
+// Number of spectrum bins (DC to Nyquist)
+const size_t kSpectrumBinCount = kSpectrumFFTSize / 2 + 1;
+
+/**
+ * @brief Peak/RMS meter readings of the playback output
+ */
+struct LevelSnapshot {
+    int channels = 0;                        // Number of metered channels
+    int sampleRate = 0;                      // Sample rate of the metered stream
+    float peak[kAnalysisMaxChannels] = {};   // Peak level with 20dB/s fall-back (linear, 1.0 = full scale)
+    float rms[kAnalysisMaxChannels] = {};    // RMS level with 300ms integration (linear)
+    uint64_t framesAnalyzed = 0;             // Frames consumed by the analysis thread
+    uint64_t framesDropped = 0;              // Frames skipped because the analysis thread fell behind
+};
+
+/**
+ * @brief Magnitude spectrum of the playback output (all channels mixed to mono)
+ */
+struct SpectrumSnapshot {
+    int sampleRate = 0;                      // Sample rate of the analyzed stream
+    float magnitudeDb[kSpectrumBinCount] = {}; // Hann-windowed magnitude, 0dB = full-scale sine
+    uint64_t frameCount = 0;                 // Number of FFT frames computed so far
+};
+
+/**
+ * @brief Waveform overview of one channel over one pixel column
+ */
+struct WaveformColumn {
+    float min = 0.0f;                        // Lowest sample (linear, 1.0 = full scale)
+    float max = 0.0f;                        // Highest sample
+    float rms = 0.0f;                        // RMS level (linear)
+};
+
+#endif // AUDIO_ANALYSIS_H
\ No newline at end of file
@@ -0,0 +1,215 @@
+#ifndef AUDIO_BUFFER_VIEW_H
+#define AUDIO_BUFFER_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Arrangement of the channels of a multichannel buffer
+ */
+enum class SampleLayout {
+    Interleaved,    // Frame after frame: L R L R ...
+    Planar          // Channel after channel: L L ... R R ...
+};
+
+/**
+ * @brief Non-owning view of float audio with explicit units
+ *
+ * Sizes are always given in frames (one sample per channel); SampleCount and
+ * ByteSize derive the other units, so APIs taking a view cannot confuse them.
+ * Sample (frame, channel) lives at Data()[frame * FrameStride() + channel *
+ * ChannelStride()], which covers interleaved buffers, planar buffers and
+ * frame ranges of either (see Subview) without copying.
+ */
+template <typename SampleType>
+class BasicAudioBufferView {
+    static_assert(std::is_same<typename std::remove_const<SampleType>::type, float>::value,
+                  "Audio buffer views hold float samples");
+
+public:
+    BasicAudioBufferView() = default;
+
+    /**
+     * @brief Constructor
+     * @param data First sample
+     * @param frameCount Number of frames
+     * @param channelCount Number of channels
+     * @param layout Interleaved samples, or one plane of frameCount samples per channel, plane after plane
+     */
+    BasicAudioBufferView(SampleType* data, size_t frameCount, int channelCount,
+                         SampleLayout layout = SampleLayout::Interleaved)
+        : data(data), frameCount(frameCount), channelCount(channelCount), layout(layout),
+          frameStride(layout == SampleLayout::Interleaved ? static_cast<size_t>(channelCount) : 1),
+          channelStride(layout == SampleLayout::Interleaved ? 1 : frameCount) {}
+
+    /**
+     * @brief Allow a mutable view to be passed where a read-only view is expected
+     */
+    template <typename Other,
+              typename = typename std::enable_if<std::is_same<const Other, SampleType>::value>::type>
+    BasicAudioBufferView(const BasicAudioBufferView<Other>& other)
+        : data(other.Data()), frameCount(other.Frames()), channelCount(other.Channels()), layout(other.Layout()),
+          frameStride(other.FrameStride()), channelStride(other.ChannelStride()) {}
+
+    SampleType* Data() const { return data; }
+    size_t Frames() const { return frameCount; }
+    int Channels() const { return channelCount; }
+    SampleLayout Layout() const { return layout; }
+    bool IsInterleaved() const { return layout == SampleLayout::Interleaved; }
+    size_t SampleCount() const { return frameCount * static_cast<size_t>(channelCount); }
+    size_t ByteSize() const { return SampleCount() * sizeof(float); }
+    bool IsEmpty() const { return data == nullptr || frameCount == 0 || channelCount <= 0; }
+
+    // Distance in samples between consecutive frames of a channel, and between channels of a frame
+    size_t FrameStride() const { return frameStride; }
+    size_t ChannelStride() const { return channelStride; }
+
+    /**
+     * @brief Access one sample
+     */
+    SampleType& At(size_t frame, int channel) const {
+        return data[frame * frameStride + static_cast<size_t>(channel) * channelStride];
+    }
+
+    /**
+     * @brief Get the first sample of a channel; its next samples are FrameStride() apart
+     */
+    SampleType* Channel(int channel) const {
+        return data + static_cast<size_t>(channel) * channelStride;
+    }
+
+    /**
+     * @brief Check whether the samples occupy exactly SampleCount() consecutive floats
+     *
+     * Interleaved views always do; a planar Subview does not, as its planes
+     * keep the stride of the buffer it was taken from.
+     */
+    bool IsContiguous() const {
+        return layout == SampleLayout::Interleaved || channelCount <= 1 || channelStride == frameCount;
+    }
+
+    /**
+     * @brief Check whether every channel start is aligned for vector loads
+     * @param alignment Alignment in bytes (a power of two)
+     */
+    bool IsAligned(size_t alignment) const {
+        const size_t planeBytes = IsInterleaved() ? 0 : channelStride * sizeof(float);
+        return (reinterpret_cast<uintptr_t>(data) & (alignment - 1)) == 0 && (planeBytes & (alignment - 1)) == 0;
+    }
+
+    /**
+     * @brief View a range of frames of the same buffer
+     * @param firstFrame First frame of the range (clamped to Frames())
+     * @param count Number of frames (clamped to the end of the view)
+     */
+    BasicAudioBufferView Subview(size_t firstFrame, size_t count) const {
+        BasicAudioBufferView view = *this;
+        firstFrame = firstFrame < frameCount ? firstFrame : frameCount;
+        view.data = data ? data + firstFrame * frameStride : nullptr;
+        view.frameCount = count < frameCount - firstFrame ? count : frameCount - firstFrame;
+        return view;
+    }
+
+    /**
+     * @brief Check whether another view has the same frame and channel counts
+     */
+    template <typename Other>
+    bool HasSameShape(const BasicAudioBufferView<Other>& other) const {
+        return frameCount == other.Frames() && channelCount == other.Channels();
+    }
+
+private:
+    SampleType* data = nullptr;
+    size_t frameCount = 0;
+    int channelCount = 0;
+    SampleLayout layout = SampleLayout::Interleaved;
+    size_t frameStride = 0;
+    size_t channelStride = 1;
+};
+
+typedef BasicAudioBufferView<float> AudioBufferView;
+typedef BasicAudioBufferView<const float> ConstAudioBufferView;
+
+/**
+ * @brief Non-owning view of interleaved PCM bytes with their sample format
+ *
+ * Carries what WAVEFORMATEX describes (channels, container size, integer or
+ * float) together with the bytes, so decoded tracks, device buffers and saved
+ * files can be handed between stages without passing a byte count and a
+ * format separately. Sizes are in frames, as for BasicAudioBufferView.
+ */
+template <typename ByteType>
+class BasicPcmBufferView {
+    static_assert(std::is_same<typename std::remove_const<ByteType>::type, char>::value,
+                  "PCM buffer views hold bytes");
+
+public:
+    BasicPcmBufferView() = default;
+
+    /**
+     * @brief Constructor
+     * @param data First byte of the first frame
+     * @param frameCount Number of frames
+     * @param channelCount Number of interleaved channels
+     * @param bitsPerSample Container size: 8, 16, 24 or 32
+     * @param isFloat Whether 32-bit samples are IEEE floats
+     */
+    BasicPcmBufferView(ByteType* data, size_t frameCount, int channelCount, unsigned bitsPerSample,
+                       bool isFloat = false)
+        : data(data), frameCount(frameCount), channelCount(channelCount), bitsPerSample(bitsPerSample),
+          isFloat(isFloat) {}
+
+    /**
+     * @brief Allow a mutable view to be passed where a read-only view is expected
+     */
+    template <typename Other,
+              typename = typename std::enable_if<std::is_same<const Other, ByteType>::value>::type>
+    BasicPcmBufferView(const BasicPcmBufferView<Other>& other)
+        : data(other.Data()), frameCount(other.Frames()), channelCount(other.Channels()),
+          bitsPerSample(other.BitsPerSample()), isFloat(other.IsFloat()) {}
+
+    ByteType* Data() const { return data; }
+    size_t Frames() const { return frameCount; }
+    int Channels() const { return channelCount; }
+    unsigned BitsPerSample() const { return bitsPerSample; }
+    bool IsFloat() const { return isFloat; }
+    size_t BytesPerSample() const { return bitsPerSample / 8; }
+    size_t BlockAlign() const { return BytesPerSample() * static_cast<size_t>(channelCount); }
+    size_t SampleCount() const { return frameCount * static_cast<size_t>(channelCount); }
+    size_t ByteSize() const { return frameCount * BlockAlign(); }
+    bool IsEmpty() const { return data == nullptr || frameCount == 0 || BlockAlign() == 0; }
+
+    /**
+     * @brief Check whether the first byte is aligned (e.g. to read 32-bit float samples in place)
+     * @param alignment Alignment in bytes (a power of two)
+     */
+    bool IsAligned(size_t alignment) const {
+        return (reinterpret_cast<uintptr_t>(data) & (alignment - 1)) == 0;
+    }
+
+    /**
+     * @brief View a range of frames of the same buffer
+     * @param firstFrame First frame of the range (clamped to Frames())
+     * @param count Number of frames (clamped to the end of the view)
+     */
+    BasicPcmBufferView Subview(size_t firstFrame, size_t count) const {
+        BasicPcmBufferView view = *this;
+        firstFrame = firstFrame < frameCount ? firstFrame : frameCount;
+        view.data = data ? data + firstFrame * BlockAlign() : nullptr;
+        view.frameCount = count < frameCount - firstFrame ? count : frameCount - firstFrame;
+        return view;
+    }
+
+private:
+    ByteType* data = nullptr;
+    size_t frameCount = 0;
+    int channelCount = 0;
+    unsigned bitsPerSample = 0;
+    bool isFloat = false;
+};
+
+typedef BasicPcmBufferView<char> PcmBufferView;
+typedef BasicPcmBufferView<const char> ConstPcmBufferView;
+
+#endif // AUDIO_BUFFER_VIEW_H
@@ -9,6 +9,7 @@
 
 // Include GPU processor interface first
 #include "IGPUProcessor.h"
+#include "AudioAnalysis.h"
 
 /**
  * @brief Processing parameters structure for audio engine
@@ -23,6 +24,26 @@ struct ProcessingParams {
     int gpuQueuePriority = 1;        // GPU queue priority (0-3)
 };
 
+/**
+ * @brief Opt-in real-time setup of the playback thread
+ */
+struct RealtimeSettings {
+    bool enabled = false;            // Apply the settings below when playback starts
+    bool roundRobin = false;         // SCHED_RR instead of SCHED_FIFO
+    int priority = 70;               // Real-time priority, 1 to 99
+    std::vector<int> cpus;           // CPUs the playback thread may run on (empty: any)
+    std::string memory = "buffers";  // "off", "buffers" (render buffers and tracks) or "all" (every allocation)
+};
+
+/**
+ * @brief Output buffering: audio is queued to the device in periods
+ */
+struct BufferSettings {
+    size_t periodFrames = 1024;      // Frames per device buffer (64 to 16384)
+    size_t periodCount = 4;          // Buffers queued to the device (2 to 16); latency is periodFrames * periodCount
+    bool adaptive = false;           // Queue more buffers after underruns and fewer again once playback is stable
+};
+
 // Forward declaration for GPU interface
 class IGPUProcessor;
 
@@ -98,6 +119,227 @@ public:
     bool SetEQ(double freq1, double gain1, double q1,
                 double freq2, double gain2, double q2);
 
+    /**
+     * @brief Apply a long FIR filter (e.g. room correction) during playback
+     *
+     * The impulse response is loaded from a WAV file and resampled to the
+     * playback sample rate. It is rebuilt automatically when a file with a
+     * different format is loaded.
+     * @param impulseResponsePath Path to the impulse response WAV file, or empty to disable
+     * @return true if the filter was applied (or disabled) successfully, false otherwise
+     */
+    bool SetConvolutionFilter(const std::string& impulseResponsePath);
+
+    /**
+     * @brief Set the speaker layout of the playback output
+     *
+     * The loaded audio is remapped, downmixed or upmixed to this layout after
+     * the DSP chain. While playing, the change applies when playback restarts.
+     * @param layout Layout name such as "stereo", "5.1" or "7.1.4", or "source" to keep the file's layout
+     * @return true if the layout name is known, false otherwise
+     */
+    bool SetOutputLayout(const std::string& layout);
+
+    /**
+     * @brief Set how DSD (DSF/DFF) files are converted to PCM when loaded
+     * @param quality Filter preset: "fast", "standard" or "high"
+     * @param pcmRate PCM rate in Hz (the DSD rate divided by 8, 16, 32, ...), or 0 for 4x the base rate (176.4kHz/192kHz)
+     * @return true if the settings are valid, false otherwise
+     */
+    bool SetDSDConversion(const std::string& quality, int pcmRate = 0);
+
+    /**
+     * @brief Set how DSD (DSF/DFF) files reach the output device
+     *
+     * "dop" and "native" keep the 1-bit data and pack it for the device while
+     * playing, skipping the DSP chain, the output mixer and analysis.
+     * @param mode "pcm" (convert, the default), "dop" (DSD over PCM) or "native"
+     * @return true if the mode is known and available, false otherwise
+     */
+    bool SetDSDOutput(const std::string& mode);
+
+    /**
+     * @brief Change the playback volume, optionally as a timed ramp
+     *
+     * The change is applied sample-accurately on the timeline of the loaded
+     * file. Changes shorter than 10ms are smoothed over 10ms so they do not
+     * click. Once the volume has been changed, playback is no longer
+     * bit-perfect.
+     * @param gainDb Target gain in dB (-120 or lower mutes)
+     * @param rampSeconds Ramp length in seconds
+     * @param atSeconds File position where the ramp starts, or a negative value to start now
+     * @param exponential Ramp in equal dB steps instead of linearly
+     * @return true if the change was scheduled, false otherwise
+     */
+    bool SetVolume(double gainDb, double rampSeconds = 0.0, double atSeconds = -1.0, bool exponential = false);
+
+    /**
+     * @brief Set the crossfade between the loaded track and tracks queued after it
+     *
+     * Takes effect for the next QueueNext call.
+     * @param seconds Overlap in seconds, or 0 for gapless playback
+     * @param curve "linear", "equal-power", "s-curve", or comma-separated fade-in gains from 0 to 1
+     * @return true if the settings are valid, false otherwise
+     */
+    bool SetCrossfade(double seconds, const std::string& curve = "equal-power");
+
+    /**
+     * @brief Queue a file to follow the loaded one
+     *
+     * The file is decoded and converted to the playing format here, on the
+     * calling thread, so the playback thread only mixes and swaps buffers in
+     * memory and slow storage cannot stall it. When the loaded track ends,
+     * playback moves on to the queued one without a gap, crossfading if a
+     * crossfade is set. Queueing again replaces the queued track; loading a
+     * file drops it. Without a loaded file, the file is loaded instead.
+     * @param filePath Path to the audio file
+     * @return true if the file was queued, false otherwise
+     */
+    bool QueueNext(const std::string& filePath);
+
+    /**
+     * @brief Change the playback speed
+     *
+     * The rate is applied to the source before the DSP chain. "music" and
+     * "speech" keep the pitch (phase vocoder and WSOLA respectively),
+     * "varispeed" lets it follow the rate. Changing only the rate takes effect
+     * with the next block; changing the mode restarts the stretcher.
+     * @param rate Speed from 0.5 to 2.0 (1.0 removes the stretcher)
+     * @param mode "music", "speech" or "varispeed"
+     * @return true if successful, false otherwise
+     */
+    bool SetPlaybackRate(double rate, const std::string& mode = "music");
+
+    /**
+     * @brief Play another file over the loaded one
+     *
+     * The file (WAV, DSF or DFF) is decoded into memory, resampled to the
+     * playback rate and mixed after the output layout mixer. Streams start with
+     * the next rendered block, keep playback going after the loaded file ends,
+     * and stop when another file is loaded or the output layout changes.
+     * @param filePath Path to the audio file
+     * @param gainDb Gain in dB
+     * @param pan -1 (left) to 1 (right); ignored for files with as many channels as the output
+     * @param loop Restart the file when it ends
+     * @return Stream ID, or -1 on error
+     */
+    int AddStream(const std::string& filePath, double gainDb = 0.0, double pan = 0.0, bool loop = false);
+
+    /**
+     * @brief Change the gain of a playing stream (ramped over one block)
+     * @param stream Stream ID
+     * @param gainDb Gain in dB
+     * @return true if the stream is playing, false otherwise
+     */
+    bool SetStreamGain(int stream, double gainDb);
+
+    /**
+     * @brief Change the pan of a playing stream (ramped over one block)
+     * @param stream Stream ID
+     * @param pan -1 (left) to 1 (right)
+     * @return true if the stream is playing, false otherwise
+     */
+    bool SetStreamPan(int stream, double pan);
+
+    /**
+     * @brief Fade out and stop a stream
+     * @param stream Stream ID, or -1 for every stream
+     * @return true if the stream was playing (always true for -1), false otherwise
+     */
+    bool StopStream(int stream);
+
+    /**
+     * @brief Limit how many streams are mixed per block
+     *
+     * Beyond the budget only the loudest streams are mixed; the others keep
+     * their position silently, which bounds the mixing cost.
+     * @param streams Maximum streams mixed per block
+     */
+    void SetStreamBudget(size_t streams);
+
+    /**
+     * @brief Get a description of the playing streams, one per line
+     */
+    std::string GetStreamList() const;
+
+    /**
+     * @brief Set the smallest convolution partition handed to the GPU processor
+     *
+     * Takes effect the next time the convolution filter is built. Smaller
+     * partitions stay on the CPU, where their lower latency matters more.
+     * @param minPartitionFrames Partition size in frames, or SIZE_MAX to keep convolution on the CPU
+     */
+    void SetConvolutionOffloadSize(size_t minPartitionFrames);
+
+    /**
+     * @brief Enable or disable level/spectrum analysis of the playback output
+     *
+     * Analysis runs on a separate low-priority thread; the playback thread only
+     * copies each block into a lock-free buffer.
+     * @param enabled true to analyze the output, false to stop the analysis thread
+     */
+    void SetAnalysisEnabled(bool enabled);
+
+    /**
+     * @brief Get the latest peak/RMS meter values of the playback output
+     * @param levels Receives the meter values
+     * @return true if meter values are available, false otherwise
+     */
+    bool GetLevels(LevelSnapshot& levels) const;
+
+    /**
+     * @brief Get the latest spectrum of the playback output
+     * @param spectrum Receives the spectrum
+     * @return true if a spectrum is available, false otherwise
+     */
+    bool GetSpectrum(SpectrumSnapshot& spectrum) const;
+
+    /**
+     * @brief Get a min/max/RMS waveform overview of a time range of a file
+     *
+     * The overview is computed once per file, at every zoom level, and kept
+     * in the cache directory, so later calls for any range and width read a
+     * few entries per column instead of decoding the file. Works for files
+     * that are not loaded, e.g. to draw a library.
+     * @param filePath Path to the audio file ("" for the loaded file)
+     * @param startSeconds Start of the range
+     * @param endSeconds End of the range (0 or less: the end of the file)
+     * @param width Number of columns
+     * @param columns Receives width * channels columns, channels interleaved
+     * @return Number of channels, or 0 on error
+     */
+    int GetWaveform(const std::string& filePath, double startSeconds, double endSeconds, size_t width,
+                    std::vector<WaveformColumn>& columns);
+
+    /**
+     * @brief Configure real-time scheduling, CPU affinity and memory locking of the playback thread
+     *
+     * Applied to the running playback thread right away and to every new one.
+     * Requests the system refuses fall back to normal behavior; the report
+     * says what was actually granted. Disabling unlocks memory at once and
+     * restores normal scheduling with the next playback.
+     * @param settings Settings to use
+     * @return true if the settings are valid, false otherwise
+     */
+    bool SetRealtime(const RealtimeSettings& settings);
+
+    /**
+     * @brief Describe the real-time setup granted to the playback thread
+     * @return One line per aspect (scheduling, affinity, memory), or a note that it is disabled
+     */
+    std::string GetRealtimeReport() const;
+
+    /**
+     * @brief Configure the output buffering (takes effect when playback next starts)
+     * @param settings Period size and count, and whether to adapt the count to underruns
+     * @return true if the settings are valid, false otherwise
+     */
+    bool SetBuffering(const BufferSettings& settings);
+
+    /**
+     * @brief Describe the output buffering: configured and current periods, latency and underruns
+     */
+    std::string GetBufferingReport() const;
 
     /**
      * @brief Get performance statistics including GPU information
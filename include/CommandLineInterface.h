@@ -84,12 +84,137 @@ private:
     bool HandleEQ(double freq1, double gain1, double q1,
                    double freq2, double gain2, double q2);
     
+    /**
+     * @brief Handle convolve command to set or clear the convolution filter
+     * @param impulseResponsePath Impulse response WAV file, or "off"
+     * @return true if successful, false otherwise
+     */
+    bool HandleConvolve(const std::string& impulseResponsePath);
+
+    /**
+     * @brief Handle layout command to set the output speaker layout
+     * @param layout Layout name, or "source" to keep the file's layout
+     * @return true if successful, false otherwise
+     */
+    bool HandleLayout(const std::string& layout);
+
+    /**
+     * @brief Handle dsd command to set the DSD output mode or the DSD to PCM conversion
+     * @param setting Output mode (pcm, dop, native) or filter preset name (fast, standard, high)
+     * @param pcmRate PCM rate in Hz for a preset, or 0 for the default
+     * @return true if successful, false otherwise
+     */
+    bool HandleDSD(const std::string& setting, int pcmRate);
+
+    /**
+     * @brief Handle volume command to change the volume now or as a scheduled ramp
+     * @param gainDb Target gain in dB
+     * @param rampSeconds Ramp length in seconds
+     * @param atSeconds File position where the ramp starts, or negative for now
+     * @param exponential Ramp in equal dB steps instead of linearly
+     * @return true if successful, false otherwise
+     */
+    bool HandleVolume(double gainDb, double rampSeconds, double atSeconds, bool exponential);
+
+    /**
+     * @brief Handle queue command to play a file after the current one
+     * @param filePath Path to the audio file
+     * @return true if successful, false otherwise
+     */
+    bool HandleQueue(const std::string& filePath);
+
+    /**
+     * @brief Handle crossfade command to set the overlap of queued tracks
+     * @param seconds Overlap in seconds, 0 for gapless
+     * @param curve Curve name or comma-separated fade-in gains
+     * @return true if successful, false otherwise
+     */
+    bool HandleCrossfade(double seconds, const std::string& curve);
+
+    /**
+     * @brief Handle speed command to change the playback rate
+     * @param rate Speed from 0.5 to 2.0
+     * @param mode "music", "speech" or "varispeed"
+     * @return true if successful, false otherwise
+     */
+    bool HandleSpeed(double rate, const std::string& mode);
+
+    /**
+     * @brief Handle stream command to start, control, stop or list mixed streams
+     * @param args Command arguments; args[1] is a file path or one of gain, pan, stop, budget, list
+     * @return true if successful, false otherwise
+     */
+    bool HandleStream(const std::vector<std::string>& args);
+
     /**
      * @brief Handle stats command to show performance information
      * @return true if successful, false otherwise
      */
     bool HandleStats();
+
+    /**
+     * @brief Handle levels command to show the output peak/RMS meters
+     * @return true if successful, false otherwise
+     */
+    bool HandleLevels();
+
+    /**
+     * @brief Handle spectrum command to draw the output spectrum
+     * @return true if successful, false otherwise
+     */
+    bool HandleSpectrum();
+
+    /**
+     * @brief Handle waveform command to show the overview of a file
+     * @param filePath Path to the audio file ("" for the loaded file)
+     * @param startSeconds Start of the range
+     * @param endSeconds End of the range (0: the end of the file)
+     * @param width Number of columns
+     * @return true if successful, false otherwise
+     */
+    bool HandleWaveform(const std::string& filePath, double startSeconds, double endSeconds, size_t width);
+
+    /**
+     * @brief Handle realtime command to configure or report the playback thread's real-time setup
+     * @param args Command arguments (args[0] is "realtime")
+     * @return true if successful, false otherwise
+     */
+    bool HandleRealtime(const std::vector<std::string>& args);
+
+    /**
+     * @brief Handle buffer command to configure or report the output buffering
+     * @param args Command arguments (args[0] is "buffer")
+     * @return true if successful, false otherwise
+     */
+    bool HandleBuffer(const std::vector<std::string>& args);
+
+    /**
+     * @brief Handle trace command to record pipeline stage timings
+     * @param args Command arguments (args[0] is "trace")
+     * @return true if successful, false otherwise
+     */
+    bool HandleTrace(const std::vector<std::string>& args);
+
+    /**
+     * @brief Handle log command to show or set log levels
+     * @param args Command arguments (args[0] is "log")
+     * @return true if successful, false otherwise
+     */
+    bool HandleLog(const std::vector<std::string>& args);
+
+    /**
+     * @brief Handle analysis command to enable or disable output analysis
+     * @param mode "on" or "off"
+     * @return true if successful, false otherwise
+     */
+    bool HandleAnalysis(const std::string& mode);
     
+    /**
+     * @brief Handle autotune command to re-measure the processing backends
+     * @return true if the measurements succeeded, false otherwise
+     */
+    bool HandleAutotune();
+
     /**
      * @brief Handle quit/exit command
      * @return true if successful, false otherwise
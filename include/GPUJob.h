@@ -0,0 +1,97 @@
+#ifndef GPU_JOB_H
+#define GPU_JOB_H
+
+#include "AudioBufferView.h"
+#include <future>
+
+/**
+ * @brief Operations an accelerator job can perform
+ */
+enum class GPUOperation {
+    Copy,           // output = input
+    Gain,           // output = input * gain
+    BiquadCascade   // output = input filtered by a cascade of biquads (per channel)
+};
+
+/**
+ * @brief Biquad coefficients normalized so that a0 = 1
+ */
+struct BiquadCoefficients {
+    float b0 = 1.0f;
+    float b1 = 0.0f;
+    float b2 = 0.0f;
+    float a1 = 0.0f;
+    float a2 = 0.0f;
+};
+
+/**
+ * @brief Transposed direct form II state of one biquad on one channel
+ */
+struct BiquadState {
+    float z1 = 0.0f;
+    float z2 = 0.0f;
+};
+
+/**
+ * @brief Description of one asynchronous processing job
+ *
+ * The input and output buffers (and the biquad state) are owned by the caller
+ * and must stay valid until the job's future is ready. Jobs submitted to one
+ * processor run in submission order, so consecutive blocks of a stream may
+ * share the same biquad state.
+ */
+struct GPUJobDesc {
+    GPUOperation operation = GPUOperation::Copy;
+    ConstAudioBufferView input;         // Source samples
+    AudioBufferView output;             // Destination, same shape as input (may alias it)
+    float gain = 1.0f;                  // Gain
+    const BiquadCoefficients* biquads = nullptr;   // BiquadCascade: stages applied in order
+    size_t biquadCount = 0;
+    BiquadState* biquadState = nullptr; // BiquadCascade: biquadCount * channels entries, stage-major
+};
+
+/**
+ * @brief Completion record of a job with per-stage timings
+ */
+struct GPUJobResult {
+    bool success = false;
+    double queueMicroseconds = 0.0;     // Submission until the upload started
+    double uploadMicroseconds = 0.0;    // Host to device transfer
+    double computeMicroseconds = 0.0;   // Kernel execution
+    double downloadMicroseconds = 0.0;  // Device to host transfer
+};
+
+/**
+ * @brief Handle of a submitted job; ready once the output buffer is written
+ */
+typedef std::shared_future<GPUJobResult> GPUJobFuture;
+
+/**
+ * @brief Reference implementation of the job operations shared by all backends
+ */
+namespace GPUJobs {
+
+    /**
+     * @brief Check that a job description is complete and consistent
+     * @param job Job description
+     * @return true if the job can be executed, false otherwise
+     */
+    bool Validate(const GPUJobDesc& job);
+
+    /**
+     * @brief Execute a job synchronously on the calling thread
+     * @param job Job description
+     * @return true if successful, false otherwise
+     */
+    bool ExecuteReference(const GPUJobDesc& job);
+
+    /**
+     * @brief Wrap a result in an already completed future
+     * @param result Job result
+     * @return Ready future
+     */
+    GPUJobFuture MakeReadyFuture(const GPUJobResult& result);
+
+} // namespace GPUJobs
+
+#endif // GPU_JOB_H
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef I_AUDIO_ENCODER_H
+#define I_AUDIO_ENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Interface for streaming lossy encoders that write a compressed file
+ *
+ * Samples are pushed as interleaved float blocks of any size, so an encoder can
+ * be fed straight from a decoder or from the engine's PCM buffer without holding
+ * the whole stream in memory. Encoders that allow it may spread the work over
+ * several threads internally.
+ */
+class IAudioEncoder {
+public:
+    /**
+     * @brief Destructor
+     */
+    virtual ~IAudioEncoder() = default;
+
+    /**
+     * @brief Create the output file and configure the encoder
+     * @param filePath Output file path
+     * @param sampleRate Sample rate of the pushed samples in Hz
+     * @param channels Number of interleaved channels
+     * @param bitrateKbps Target bitrate in kbps
+     * @return true if the encoder is ready, false otherwise
+     */
+    virtual bool Open(const std::string& filePath, int sampleRate, int channels, int bitrateKbps) = 0;
+
+    /**
+     * @brief Encode a block of interleaved samples in [-1, 1]
+     * @param samples Interleaved samples
+     * @param frameCount Number of frames
+     * @return true if successful, false otherwise
+     */
+    virtual bool Write(const float* samples, size_t frameCount) = 0;
+
+    /**
+     * @brief Flush the encoder and finalize the file
+     * @return true if successful, false otherwise
+     */
+    virtual bool Close() = 0;
+
+    /**
+     * @brief Get the number of bytes written to the output file so far
+     * @return Output size in bytes
+     */
+    virtual uint64_t GetBytesWritten() const = 0;
+
+    /**
+     * @brief Get a short description of the encoder and its configuration
+     * @return Encoder description
+     */
+    virtual std::string GetName() const = 0;
+};
+
+#endif // I_AUDIO_ENCODER_H
\ No newline at end of file
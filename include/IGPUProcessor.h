@@ -3,6 +3,7 @@
 
 #include <string>
 #include <memory>
+#include "GPUJob.h"
 
 /**
  * @brief Audio processing parameters structure for advanced GPU processing
@@ -39,7 +40,8 @@ public:
     enum class Backend {
         CUDA,
         OPENCL,
-        VULKAN
+        VULKAN,
+        CPU         // Pipelined CPU reference implementation (no GPU required)
     };
 
     /**
@@ -60,67 +62,240 @@ public:
     virtual bool Initialize(Backend backend) = 0;
 
     /**
-     * @brief Process audio data using GPU acceleration
-     * @param inputBuffer Input buffer containing raw audio samples
-     * @param outputBuffer Output buffer for processed audio samples
-     * @param bufferSize Size of the buffers in bytes
+     * @brief Process audio data using GPU acceleration (blocking)
+     * @param inputBuffer Input buffer containing float samples
+     * @param outputBuffer Output buffer for processed float samples
+     * @param bufferSize Number of float samples in each buffer (not bytes)
      * @return true if processing was successful, false otherwise
      */
     virtual bool ProcessAudio(const float* inputBuffer,
                            float* outputBuffer,
                            size_t bufferSize) = 0;
 
+    /**
+     * @brief Process a buffer using GPU acceleration (blocking)
+     *
+     * Forwards to the sample-count overload; the output may alias the input
+     * to process in place.
+     * @param input Source samples (contiguous, interleaved or planar)
+     * @param output Destination with the same shape and layout as input
+     * @return true if processing was successful, false otherwise
+     */
+    bool ProcessAudio(ConstAudioBufferView input, AudioBufferView output) {
+        if (!HasMatchingBuffers(input, output)) {
+            return false;
+        }
+        return ProcessAudio(input.Data(), output.Data(), input.SampleCount());
+    }
+
+    /**
+     * @brief Submit a job for asynchronous execution
+     *
+     * Returns as soon as the job is queued; blocks only while the number of
+     * jobs in flight is at the limit set by SetMaxJobsInFlight. Backends that
+     * do not pipeline use this default, which runs the job synchronously and
+     * returns a ready future.
+     * @param job Job description (buffers must outlive the returned future)
+     * @return Future that becomes ready when the output buffer is written
+     */
+    virtual GPUJobFuture SubmitJob(const GPUJobDesc& job) {
+        GPUJobResult result;
+        result.success = GPUJobs::ExecuteReference(job);
+        return GPUJobs::MakeReadyFuture(result);
+    }
+
+    /**
+     * @brief Limit the number of submitted jobs that have not completed yet
+     * @param depth Maximum jobs in flight (at least 1)
+     */
+    virtual void SetMaxJobsInFlight(size_t /*depth*/) {
+        // Default implementation runs jobs synchronously - nothing to limit
+    }
+
+    /**
+     * @brief Get the in-flight job limit
+     * @return Maximum jobs in flight
+     */
+    virtual size_t GetMaxJobsInFlight() const {
+        return 1;
+    }
+
+    /**
+     * @brief Block until every submitted job has completed
+     */
+    virtual void WaitIdle() {
+        // Default implementation runs jobs synchronously - always idle
+    }
+
     /**
      * @brief Convert audio sample rate using GPU acceleration
+     *
+     * Converts a whole mono signal with the same filter as PolyphaseResampler,
+     * producing ceil(inputSampleCount * outputSampleRate / inputSampleRate) samples.
      * @param inputBuffer Input audio buffer
      * @param inputSampleRate Sample rate of input buffer
      * @param outputBuffer Output audio buffer (should be pre-allocated)
      * @param outputSampleRate Target sample rate for output
      * @param inputSampleCount Number of samples in input buffer
-     * @param outputSampleCount Number of samples in output buffer (calculated)
+     * @param outputSampleCount In: capacity of outputBuffer; out: number of samples written
      * @return true if conversion was successful, false otherwise
      */
-    virtual bool ConvertSampleRate(const float* inputBuffer,
-                                   int inputSampleRate,
-                                   float* outputBuffer,
-                                   int outputSampleRate,
-                                   size_t inputSampleCount,
-                                   size_t& outputSampleCount) {
+    virtual bool ConvertSampleRate(const float* /*inputBuffer*/,
+                                   int /*inputSampleRate*/,
+                                   float* /*outputBuffer*/,
+                                   int /*outputSampleRate*/,
+                                   size_t /*inputSampleCount*/,
+                                   size_t& /*outputSampleCount*/) {
         // Default implementation returns false - needs to be overridden
         return false;
     }
 
     /**
-     * @brief Convert audio bitrate using GPU acceleration
+     * @brief Optional accelerated analysis stage for lossy encoders
+     *
+     * Bitrate conversion itself is done by the encoders (see IAudioEncoder);
+     * this hook is reserved for offloading their acceleratable sub-stages such
+     * as MDCT or psychoacoustic analysis. Backends that do not implement it
+     * return false and the encoder runs entirely on the CPU.
      * @param inputBuffer Input audio buffer
      * @param inputBitrate Input bitrate in kbps
-     * @param outputBuffer Output audio buffer (should be pre-allocated)
+     * @param outputBuffer Output analysis buffer (should be pre-allocated)
      * @param targetBitrate Target bitrate in kbps
      * @param bufferSize Size of input buffer in bytes
-     * @return true if conversion was successful, false otherwise
+     * @return true if the stage ran on the GPU, false otherwise
+     */
+    virtual bool ConvertBitrate(const float* /*inputBuffer*/,
+                               int /*inputBitrate*/,
+                               float* /*outputBuffer*/,
+                               int /*targetBitrate*/,
+                               size_t /*bufferSize*/) {
+        // Default implementation declines - encoders run on the CPU
+        return false;
+    }
+
+    /**
+     * @brief Run the encoder analysis stage on a buffer (see the byte-count overload)
+     * @param input Source samples (contiguous)
+     * @param inputBitrate Input bitrate in kbps
+     * @param output Output analysis buffer with the same shape and layout as input
+     * @param targetBitrate Target bitrate in kbps
+     * @return true if the stage ran on the GPU, false otherwise
      */
-    virtual bool ConvertBitrate(const float* inputBuffer,
-                               int inputBitrate,
-                               float* outputBuffer,
-                               int targetBitrate,
-                               size_t bufferSize) = 0;
+    bool ConvertBitrate(ConstAudioBufferView input, int inputBitrate, AudioBufferView output, int targetBitrate) {
+        if (!HasMatchingBuffers(input, output)) {
+            return false;
+        }
+        return ConvertBitrate(input.Data(), inputBitrate, output.Data(), targetBitrate, input.ByteSize());
+    }
 
     /**
      * @brief Process audio with specified parameters using GPU acceleration
      * @param inputBuffer Input audio buffer
      * @param outputBuffer Output audio buffer (should be pre-allocated)
-     * @param bufferSize Size of buffers in samples
+     * @param bufferSize Number of float samples in each buffer (not bytes)
      * @param parameters Processing parameters (EQ, filters, etc.)
      * @return true if processing was successful, false otherwise
      */
     virtual bool ProcessAudioWithParams(const float* inputBuffer,
                                        float* outputBuffer,
                                        size_t bufferSize,
-                                       const struct AudioProcessingParams& parameters) {
+                                       const struct AudioProcessingParams& /*parameters*/) {
         // Default implementation falls back to basic ProcessAudio
         return ProcessAudio(inputBuffer, outputBuffer, bufferSize);
     }
 
+    /**
+     * @brief Process a buffer with specified parameters (see the sample-count overload)
+     * @param input Source samples (contiguous, interleaved or planar)
+     * @param output Destination with the same shape and layout as input (may alias it)
+     * @param parameters Processing parameters (EQ, filters, etc.)
+     * @return true if processing was successful, false otherwise
+     */
+    bool ProcessAudioWithParams(ConstAudioBufferView input, AudioBufferView output,
+                                const struct AudioProcessingParams& parameters) {
+        if (!HasMatchingBuffers(input, output)) {
+            return false;
+        }
+        return ProcessAudioWithParams(input.Data(), output.Data(), input.SampleCount(), parameters);
+    }
+
+    /**
+     * @brief Upload an impulse response segment for partitioned convolution
+     *
+     * Used by the convolution engine to hand its large partitions to the GPU.
+     * The backend keeps the input history and performs the whole uniformly
+     * partitioned convolution of the segment with the given partition size.
+     * @param impulseResponse Kernel taps (mono)
+     * @param tapCount Number of taps in the kernel
+     * @param partitionSize Partition length in samples; ProcessConvolution is called with this many frames
+     * @param kernelId Receives an identifier for ProcessConvolution calls
+     * @return true if the backend accepted the kernel, false to keep it on the CPU
+     */
+    virtual bool CreateConvolutionKernel(const float* /*impulseResponse*/,
+                                         size_t /*tapCount*/,
+                                         size_t /*partitionSize*/,
+                                         int& /*kernelId*/) {
+        // Default implementation declines - convolution stays on the CPU
+        return false;
+    }
+
+    /**
+     * @brief Convolve the next partition of input with an uploaded kernel
+     * @param kernelId Identifier returned by CreateConvolutionKernel
+     * @param inputBlock Newest input samples (frameCount values)
+     * @param outputBlock Convolution output for the same samples (frameCount values)
+     * @param frameCount Number of samples, equal to the kernel's partition size
+     * @return true if processing was successful, false otherwise
+     */
+    virtual bool ProcessConvolution(int /*kernelId*/,
+                                    const float* /*inputBlock*/,
+                                    float* /*outputBlock*/,
+                                    size_t /*frameCount*/) {
+        return false;
+    }
+
+    /**
+     * @brief Clear the input history of an uploaded kernel (e.g. after seeking)
+     * @param kernelId Identifier returned by CreateConvolutionKernel
+     */
+    virtual void ResetConvolutionKernel(int /*kernelId*/) {}
+
+    /**
+     * @brief Release an uploaded convolution kernel
+     * @param kernelId Identifier returned by CreateConvolutionKernel
+     */
+    virtual void ReleaseConvolutionKernel(int /*kernelId*/) {}
+
+    /**
+     * @brief Transform a batch of real frames to spectra
+     *
+     * Bin k of a frame is the sum over n of x[n] * e^(-2*pi*i*k*n/frameSize),
+     * as computed by FFT::ForwardReal.
+     * @param frames frameCount frames of frameSize samples, one after another
+     * @param frameSize Samples per frame (a power of two)
+     * @param frameCount Number of frames
+     * @param re Receives frameSize / 2 + 1 real parts per frame, frame after frame
+     * @param im Receives the imaginary parts in the same layout
+     * @return true if the backend computed the spectra, false to compute them on the CPU
+     */
+    virtual bool ForwardSpectra(const float* /*frames*/, size_t /*frameSize*/, size_t /*frameCount*/, float* /*re*/, float* /*im*/) {
+        // Default implementation declines - transforms stay on the CPU
+        return false;
+    }
+
+    /**
+     * @brief Transform a batch of spectra back to real frames, normalized like FFT::InverseReal
+     * @param re frameSize / 2 + 1 real parts per frame, frame after frame
+     * @param im Imaginary parts in the same layout
+     * @param frameSize Samples per frame (a power of two)
+     * @param frameCount Number of frames
+     * @param frames Receives frameCount frames of frameSize samples
+     * @return true if the backend computed the frames, false to compute them on the CPU
+     */
+    virtual bool InverseSpectra(const float* /*re*/, const float* /*im*/, size_t /*frameSize*/, size_t /*frameCount*/, float* /*frames*/) {
+        return false;
+    }
+
     /**
      * @brief Get GPU information string
      * @return String with detailed GPU information
@@ -132,6 +307,13 @@ public:
      * @return true if available, false otherwise
      */
     virtual bool IsAvailable() const = 0;
+
+private:
+    // The pointer overloads take one run of samples, so views must be whole buffers of one shape
+    static bool HasMatchingBuffers(ConstAudioBufferView input, ConstAudioBufferView output) {
+        return !input.IsEmpty() && input.HasSameShape(output) && input.Layout() == output.Layout() &&
+               input.IsContiguous() && output.IsContiguous();
+    }
 };
 
 #endif // I_GPU_PROCESSOR_H
\ No newline at end of file
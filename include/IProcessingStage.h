@@ -0,0 +1,51 @@
+#ifndef I_PROCESSING_STAGE_H
+#define I_PROCESSING_STAGE_H
+
+#include "AudioBufferView.h"
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Interface for a streaming DSP stage in the playback chain
+ *
+ * Stages process planar float blocks in place on the playback thread: each
+ * channel is a contiguous run of samples, so per-channel filters stream
+ * through memory and vectorize. ProcessingChain converts to and from the
+ * interleaved buffers at the edges of the chain. Prepare is called off the
+ * audio thread and may allocate; Process must not.
+ */
+class IProcessingStage {
+public:
+    /**
+     * @brief Destructor
+     */
+    virtual ~IProcessingStage() = default;
+
+    /**
+     * @brief Configure the stage for a stream format
+     * @param sampleRate Sample rate in Hz
+     * @param channels Number of channels
+     * @param maxBlockFrames Largest number of frames passed to Process
+     * @return true if the stage can run with this format, false otherwise
+     */
+    virtual bool Prepare(int sampleRate, int channels, size_t maxBlockFrames) = 0;
+
+    /**
+     * @brief Process one block in place
+     * @param block Planar samples: the prepared channel count and at most maxBlockFrames frames
+     */
+    virtual void Process(AudioBufferView block) = 0;
+
+    /**
+     * @brief Clear internal state (called after seeking or stopping)
+     */
+    virtual void Reset() = 0;
+
+    /**
+     * @brief Get a short human-readable description of the stage
+     * @return Stage description
+     */
+    virtual std::string GetName() const = 0;
+};
+
+#endif // I_PROCESSING_STAGE_H
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "AudioDeviceDriver.h"
+#include "core/Log.h"
 #include <iostream>
 
 // Implementation of Audio Device Driver
@@ -79,10 +80,18 @@ int AudioDeviceDriver::Write(const float* buffer, size_t bufferSize) {
     }
     
     // In a real implementation, we would write to the actual device
-    std::cout << "Writing " << bufferSize << " bytes of audio data\n";
+    GPU_PLAYER_LOG(Device, Debug, "Writing %zu bytes of audio data", bufferSize);
     return static_cast<int>(bufferSize);
 }
 
+int AudioDeviceDriver::Write(ConstAudioBufferView buffer) {
+    if (!buffer.IsInterleaved() || buffer.IsEmpty()) {
+        return buffer.IsEmpty() ? 0 : -1;
+    }
+    int bytes = Write(buffer.Data(), buffer.ByteSize());
+    return bytes < 0 ? -1 : static_cast<int>(static_cast<size_t>(bytes) / (buffer.Channels() * sizeof(float)));
+}
+
 std::string AudioDeviceDriver::GetDeviceInfo() const {
     if (!pImpl->isOpen) {
         return "Audio device not initialized";
@@ -2,6 +2,7 @@
 #define AUDIO_DEVICE_DRIVER_H
 
 #include "IAudioDevice.h"
+#include "AudioBufferView.h"
 #include <string>
 
 /**
@@ -51,6 +52,13 @@ public:
      * @return Number of bytes written, or -1 on error
      */
     int Write(const float* buffer, size_t bufferSize) override;
+
+    /**
+     * @brief Write interleaved audio to the device buffer without copying it first
+     * @param buffer Samples to write
+     * @return Number of frames written, or -1 on error
+     */
+    int Write(ConstAudioBufferView buffer);
     
     /**
      * @brief Get information about this audio device
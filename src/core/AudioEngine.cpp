@@ -7,79 +7,1866 @@
 #include <thread>
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <future>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+#include <type_traits>
 #define NOMINMAX  // Prevent Windows from defining min/max macros
 #ifdef _WIN32
 #include <windows.h>
 #include <mmsystem.h>
 #include <mmreg.h>
 #pragma comment(lib, "winmm.lib")
+#else
+// Minimal stand-in for the Windows wave format description on other platforms
+struct WAVEFORMATEX {
+    uint16_t wFormatTag;
+    uint16_t nChannels;
+    uint32_t nSamplesPerSec;
+    uint32_t nAvgBytesPerSec;
+    uint16_t nBlockAlign;
+    uint16_t wBitsPerSample;
+    uint16_t cbSize;
+};
+#define WAVE_FORMAT_PCM 1
+#endif
+
+#ifndef WAVE_FORMAT_EXTENSIBLE
+#define WAVE_FORMAT_EXTENSIBLE 0xFFFE
+#endif
+
+#include "core/CacheDirectory.h"
+#include "core/CommandQueue.h"
+#include "core/Log.h"
+#include "core/OutputBuffering.h"
+#include "core/RealtimeThread.h"
+#include "core/SeqlockSnapshot.h"
+#include "core/Trace.h"
+#include "dsp/ProcessingChain.h"
+#include "dsp/ConvolutionStage.h"
+#include "dsp/Crossfade.h"
+#include "dsp/EqualizerStage.h"
+#include "dsp/GainStage.h"
+#include "dsp/ImpulseResponse.h"
+#include "dsp/AnalysisTap.h"
+#include "dsp/ChannelLayout.h"
+#include "dsp/ChannelMixer.h"
+#include "dsp/DSDConverter.h"
+#include "dsp/DSDPacker.h"
+#include "dsp/Resampler.h"
+#include "dsp/SampleFormat.h"
+#include "dsp/StreamMixer.h"
+#include "dsp/TimeStretcher.h"
+#include "dsp/WaveformOverview.h"
+#include "decoders/DSDFileReader.h"
+#include "decoders/MP4Decoder.h"
+#include "decoders/OggDecoder.h"
+#include "encoders/EncoderFactory.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#ifdef ENABLE_FLAC
+#include <FLAC/all.h>
+#endif
+
+// Implementation of AudioEngine interface
+
+// Frames rendered per playback block (DSP block size; device periods are made of one or more blocks)
+static const size_t kRenderBlockFrames = 1024;
+
+// Shortest volume ramp; instant changes are smoothed over this time to avoid clicks
+static const double kVolumeSmoothingSeconds = 0.01;
+
+// Streams that can play over the loaded file at once
+static const size_t kMaxStreams = 256;
+
+// View a decoded PCM buffer in its format (whole frames only)
+static ConstPcmBufferView MakePcmView(const std::vector<char>& data, const WAVEFORMATEX& format) {
+    const size_t frames = format.nBlockAlign > 0 ? data.size() / format.nBlockAlign : 0;
+    return ConstPcmBufferView(data.data(), frames, format.nChannels, format.wBitsPerSample);
+}
+
+// Convert interleaved PCM to float samples in [-1, 1); destination is interleaved, of the same shape
+// (streams select their kernel once; this looks it up per call)
+static void ConvertPcmToFloat(ConstPcmBufferView source, AudioBufferView destination) {
+    SampleFormat::GetCodec(source.BitsPerSample(), source.IsFloat())
+        .decode(source.Data(), destination.Data(), std::min(source.SampleCount(), destination.SampleCount()));
+}
+
+// Convert interleaved float samples back to PCM of the same shape, with clipping
+static void ConvertFloatToPcm(ConstAudioBufferView source, PcmBufferView destination) {
+    SampleFormat::GetCodec(destination.BitsPerSample(), destination.IsFloat())
+        .encode(source.Data(), destination.Data(), std::min(source.SampleCount(), destination.SampleCount()));
+}
+
+// Round a FLAC/WAV sample size up to the PCM container used for playback (8, 16, 24 or 32 bits)
+static unsigned int ContainerBits(unsigned int bitsPerSample) {
+    return bitsPerSample <= 8 ? 8 : bitsPerSample <= 16 ? 16 : bitsPerSample <= 24 ? 24 : 32;
+}
+
+static uint16_t ReadLE16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t ReadLE32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/**
+ * @brief Read the format and PCM data of a WAV file (plain PCM or WAVE_FORMAT_EXTENSIBLE)
+ * @param filePath Path to the WAV file
+ * @param format Receives the stream format
+ * @param channelMask Receives the speaker mask (0 if the file has none)
+ * @param data Receives the sample data
+ * @return true if successful, false otherwise
+ */
+static bool ReadWavFile(const std::string& filePath, WAVEFORMATEX& format, uint32_t& channelMask,
+                        std::vector<char>& data) {
+    std::ifstream wavFile(filePath, std::ios::binary);
+    if (!wavFile.is_open()) {
+        std::cout << "Error: Could not open WAV file - " << filePath << "\n";
+        return false;
+    }
+
+    unsigned char riffHeader[12];
+    wavFile.read(reinterpret_cast<char*>(riffHeader), sizeof(riffHeader));
+    if (!wavFile.good() || std::memcmp(riffHeader, "RIFF", 4) != 0 || std::memcmp(riffHeader + 8, "WAVE", 4) != 0) {
+        std::cout << "Error: Invalid WAV file format - " << filePath << "\n";
+        return false;
+    }
+
+    uint16_t formatTag = 0;
+    bool haveFormat = false;
+    bool haveData = false;
+    channelMask = 0;
+
+    // Walk the chunk list; fmt must precede data in valid files
+    while (wavFile.good() && !haveData) {
+        unsigned char chunkHeader[8];
+        wavFile.read(reinterpret_cast<char*>(chunkHeader), sizeof(chunkHeader));
+        if (!wavFile.good()) {
+            break;
+        }
+        uint32_t chunkSize = ReadLE32(chunkHeader + 4);
+
+        if (std::memcmp(chunkHeader, "fmt ", 4) == 0 && chunkSize >= 16) {
+            std::vector<unsigned char> fmt(chunkSize);
+            wavFile.read(reinterpret_cast<char*>(fmt.data()), chunkSize);
+            formatTag = ReadLE16(&fmt[0]);
+            format.nChannels = ReadLE16(&fmt[2]);
+            format.nSamplesPerSec = ReadLE32(&fmt[4]);
+            format.wBitsPerSample = ReadLE16(&fmt[14]);
+            if (formatTag == WAVE_FORMAT_EXTENSIBLE && chunkSize >= 40) {
+                // Speaker mask, then a sub-format GUID starting with the actual format tag
+                channelMask = ReadLE32(&fmt[20]);
+                formatTag = ReadLE16(&fmt[24]);
+            }
+            haveFormat = true;
+        } else if (std::memcmp(chunkHeader, "data", 4) == 0) {
+            data.resize(chunkSize);
+            wavFile.read(data.data(), chunkSize);
+            data.resize(static_cast<size_t>(wavFile.gcount()));
+            haveData = true;
+        } else {
+            wavFile.seekg(chunkSize, std::ios::cur);
+        }
+
+        if (chunkSize & 1) {
+            wavFile.seekg(1, std::ios::cur);  // Chunks are word aligned
+        }
+    }
+
+    if (!haveFormat || !haveData) {
+        std::cout << "Error: No format or data chunk found in WAV file - " << filePath << "\n";
+        return false;
+    }
+    if (formatTag != WAVE_FORMAT_PCM) {
+        std::cout << "Error: Only PCM WAV format is supported - " << filePath << "\n";
+        return false;
+    }
+    if (format.nChannels == 0 || format.nSamplesPerSec == 0 ||
+        ContainerBits(format.wBitsPerSample) != format.wBitsPerSample) {
+        std::cout << "Error: Unsupported WAV format (" << format.nChannels << " channels, "
+                  << format.wBitsPerSample << " bits) - " << filePath << "\n";
+        return false;
+    }
+
+    format.wFormatTag = WAVE_FORMAT_PCM;
+    format.nBlockAlign = static_cast<uint16_t>(format.nChannels * format.wBitsPerSample / 8);
+    format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+    format.cbSize = 0;
+    data.resize(data.size() - data.size() % format.nBlockAlign);
+    return true;
+}
+
+/**
+ * @brief Read a DSF or DFF file and convert it to 24-bit PCM
+ * @param filePath Path to the DSD file
+ * @param options Converter quality and PCM rate
+ * @param format Receives the PCM format
+ * @param layout Receives the speaker layout
+ * @param data Receives the sample data
+ * @param description Receives a description of the conversion
+ * @return true if successful, false otherwise
+ */
+static bool ReadDSDFile(const std::string& filePath, const DSDConverter::Options& options, WAVEFORMATEX& format,
+                        ChannelLayout& layout, std::vector<char>& data, std::string& description) {
+    DSDFileReader reader;
+    if (!reader.Open(filePath)) {
+        return false;
+    }
+
+    DSDConverter converter;
+    if (!converter.Initialize(reader.GetSampleRate(), reader.GetChannels(), options)) {
+        return false;
+    }
+
+    const int channels = reader.GetChannels();
+    const int bytesPerSample = 3;
+    const size_t kReadBytes = 65536;   // Per channel
+    std::vector<uint8_t> dsd(kReadBytes * channels);
+    std::vector<float> pcm(converter.GetMaxOutputFrames(kReadBytes) * channels);
+
+    data.clear();
+    data.reserve(static_cast<size_t>(reader.GetSampleCount() * converter.GetOutputRate() / reader.GetSampleRate()) *
+                 channels * bytesPerSample);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t bytesRead;
+    while ((bytesRead = reader.Read(dsd.data(), kReadBytes)) > 0) {
+        size_t frames = converter.Process(dsd.data(), bytesRead, pcm.data());
+        size_t offset = data.size();
+        data.resize(offset + frames * channels * bytesPerSample);
+        ConvertFloatToPcm(ConstAudioBufferView(pcm.data(), frames, channels),
+                          PcmBufferView(data.data() + offset, frames, channels, bytesPerSample * 8));
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    format.wFormatTag = WAVE_FORMAT_PCM;
+    format.nChannels = static_cast<uint16_t>(channels);
+    format.nSamplesPerSec = converter.GetOutputRate();
+    format.wBitsPerSample = bytesPerSample * 8;
+    format.nBlockAlign = static_cast<uint16_t>(channels * bytesPerSample);
+    format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+    format.cbSize = 0;
+    layout = reader.GetLayout();
+
+    double duration = static_cast<double>(reader.GetSampleCount()) / reader.GetSampleRate();
+    std::ostringstream text;
+    text << reader.GetFormatName() << " " << converter.GetName();
+    description = text.str();
+    text << std::fixed << std::setprecision(1) << ", converted at "
+         << (seconds > 0.0 ? duration / seconds : 0.0) << "x realtime";
+    std::cout << text.str() << "\n";
+    return true;
+}
+
+/**
+ * @brief Read the 1-bit data of a DSF or DFF file for DoP or native output
+ *
+ * The format describes one frame per DSD byte (8 bits per channel), so
+ * positions and durations work as they do for PCM.
+ * @param filePath Path to the DSD file
+ * @param groupBytes DSD bytes per channel per output frame; the data is padded with silence to whole frames
+ * @param format Receives the stream format
+ * @param layout Receives the speaker layout
+ * @param data Receives byte-interleaved DSD, most significant bit first
+ * @param dsdRate Receives the DSD rate in Hz
+ * @return true if successful, false otherwise
+ */
+static bool ReadDSDStream(const std::string& filePath, size_t groupBytes, WAVEFORMATEX& format,
+                          ChannelLayout& layout, std::vector<char>& data, int& dsdRate) {
+    DSDFileReader reader;
+    if (!reader.Open(filePath)) {
+        return false;
+    }
+
+    const size_t channels = reader.GetChannels();
+    const size_t kReadBytes = 65536;   // Per channel
+    data.resize(static_cast<size_t>((reader.GetSampleCount() + 7) / 8) * channels);
+    size_t bytesPerChannel = 0;
+    size_t bytesRead;
+    while ((bytesRead = reader.Read(reinterpret_cast<uint8_t*>(data.data()) + bytesPerChannel * channels,
+                                    std::min(kReadBytes, data.size() / channels - bytesPerChannel))) > 0) {
+        bytesPerChannel += bytesRead;
+    }
+    bytesPerChannel += (groupBytes - bytesPerChannel % groupBytes) % groupBytes;
+    data.resize(bytesPerChannel * channels, 0x69);   // 0x69: DSD silence pattern
+
+    dsdRate = reader.GetSampleRate();
+    format.wFormatTag = WAVE_FORMAT_PCM;
+    format.nChannels = static_cast<uint16_t>(channels);
+    format.nSamplesPerSec = dsdRate / 8;
+    format.wBitsPerSample = 8;
+    format.nBlockAlign = static_cast<uint16_t>(channels);
+    format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+    format.cbSize = 0;
+    layout = reader.GetLayout();
+    return true;
+}
+
+/**
+ * @brief Decode an Ogg Vorbis or Opus file to 24-bit PCM
+ * @param filePath Path to the Ogg file
+ * @param format Receives the PCM format
+ * @param layout Receives the speaker layout
+ * @param data Receives the sample data
+ * @param description Receives the codec name
+ * @return true if successful, false otherwise
+ */
+static bool ReadOggFile(const std::string& filePath, WAVEFORMATEX& format, ChannelLayout& layout,
+                        std::vector<char>& data, std::string& description) {
+    OggDecoder decoder;
+    if (!decoder.Open(filePath)) {
+        return false;
+    }
+
+    const int channels = decoder.GetChannels();
+    const int bytesPerSample = 3;
+    const size_t kReadFrames = 16384;
+    std::vector<float> pcm(kReadFrames * channels);
+
+    data.clear();
+    data.reserve(static_cast<size_t>(decoder.GetFrameCount()) * channels * bytesPerSample);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t frames;
+    while ((frames = decoder.Read(AudioBufferView(pcm.data(), kReadFrames, channels))) > 0) {
+        size_t offset = data.size();
+        data.resize(offset + frames * channels * bytesPerSample);
+        ConvertFloatToPcm(ConstAudioBufferView(pcm.data(), frames, channels),
+                          PcmBufferView(data.data() + offset, frames, channels, bytesPerSample * 8));
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (data.empty()) {
+        std::cout << "Error: No audio decoded from " << filePath << "\n";
+        return false;
+    }
+
+    format.wFormatTag = WAVE_FORMAT_PCM;
+    format.nChannels = static_cast<uint16_t>(channels);
+    format.nSamplesPerSec = decoder.GetSampleRate();
+    format.wBitsPerSample = bytesPerSample * 8;
+    format.nBlockAlign = static_cast<uint16_t>(channels * bytesPerSample);
+    format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+    format.cbSize = 0;
+    layout = decoder.GetLayout();
+    description = "Ogg " + decoder.GetFormatName();
+
+    double duration = static_cast<double>(data.size() / format.nBlockAlign) / format.nSamplesPerSec;
+    std::ostringstream text;
+    text << description << std::fixed << std::setprecision(1) << ", decoded at "
+         << (seconds > 0.0 ? duration / seconds : 0.0) << "x realtime";
+    std::cout << text.str() << "\n";
+    return true;
+}
+
+/**
+ * @brief Decode the audio track of an MP4/M4A file
+ *
+ * Integer codecs keep their bit depth (20-bit ALAC in 24-bit containers) and
+ * decode straight into the returned buffer; float codecs become 24-bit PCM.
+ * @param filePath Path to the MP4 file
+ * @param format Receives the PCM format
+ * @param layout Receives the speaker layout
+ * @param data Receives the sample data
+ * @param description Receives the codec name
+ * @return true if successful, false otherwise
+ */
+static bool ReadMP4File(const std::string& filePath, WAVEFORMATEX& format, ChannelLayout& layout,
+                        std::vector<char>& data, std::string& description) {
+    MP4Decoder decoder;
+    if (!decoder.Open(filePath)) {
+        return false;
+    }
+
+    const int channels = decoder.GetChannels();
+    const unsigned bitsPerSample = decoder.IsFloat() ? 24 : decoder.GetBitsPerSample();
+    const size_t blockAlign = static_cast<size_t>(channels) * (bitsPerSample / 8);
+    const size_t frameCount = static_cast<size_t>(decoder.GetFrameCount());
+    data.resize(frameCount * blockAlign);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t frames;
+    if (decoder.IsFloat()) {
+        std::vector<float> pcm(frameCount * channels);
+        frames = decoder.Read(PcmBufferView(reinterpret_cast<char*>(pcm.data()), frameCount, channels, 32, true));
+        ConvertFloatToPcm(ConstAudioBufferView(pcm.data(), frames, channels),
+                          PcmBufferView(data.data(), frames, channels, bitsPerSample));
+    } else {
+        frames = decoder.Read(PcmBufferView(data.data(), frameCount, channels, bitsPerSample));
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    data.resize(frames * blockAlign);
+    if (data.empty()) {
+        std::cout << "Error: No audio decoded from " << filePath << "\n";
+        return false;
+    }
+
+    format.wFormatTag = WAVE_FORMAT_PCM;
+    format.nChannels = static_cast<uint16_t>(channels);
+    format.nSamplesPerSec = decoder.GetSampleRate();
+    format.wBitsPerSample = static_cast<uint16_t>(bitsPerSample);
+    format.nBlockAlign = static_cast<uint16_t>(blockAlign);
+    format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+    format.cbSize = 0;
+    layout = decoder.GetLayout();
+    description = decoder.GetFormatName();
+
+    double duration = static_cast<double>(frames) / format.nSamplesPerSec;
+    std::ostringstream text;
+    text << description << (decoder.IsFragmented() ? " (fragmented MP4)" : "") << std::fixed
+         << std::setprecision(1) << ", decoded at " << (seconds > 0.0 ? duration / seconds : 0.0) << "x realtime";
+    std::cout << text.str() << "\n";
+    return true;
+}
+
+/**
+ * @brief Load a WAV, DSF, DFF, Ogg or MP4 file as a mixer clip at the playback rate
+ * @param filePath Path to the audio file
+ * @param sampleRate Playback rate in Hz; the clip is resampled to it if needed
+ * @param clip Receives the decoded audio, one array per channel
+ * @return true if successful, false otherwise
+ */
+static bool LoadStreamClip(const std::string& filePath, int sampleRate, AudioClip& clip) {
+    std::string extension = filePath.substr(filePath.find_last_of(".") + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+    WAVEFORMATEX format = {};
+    std::vector<char> data;
+    if (extension == "wav") {
+        uint32_t channelMask = 0;
+        if (!ReadWavFile(filePath, format, channelMask, data)) {
+            return false;
+        }
+    } else if (extension == "dsf" || extension == "dff") {
+        ChannelLayout layout;
+        std::string description;
+        if (!ReadDSDFile(filePath, DSDConverter::Options(), format, layout, data, description)) {
+            return false;
+        }
+    } else if (extension == "ogg" || extension == "oga" || extension == "opus") {
+        ChannelLayout layout;
+        std::string description;
+        if (!ReadOggFile(filePath, format, layout, data, description)) {
+            return false;
+        }
+    } else if (extension == "m4a" || extension == "mp4") {
+        ChannelLayout layout;
+        std::string description;
+        if (!ReadMP4File(filePath, format, layout, data, description)) {
+            return false;
+        }
+    } else {
+        std::cout << "Error: Streams can be WAV, DSF, DFF, Ogg or MP4 files - " << filePath << "\n";
+        return false;
+    }
+
+    const size_t channels = format.nChannels;
+    const ConstPcmBufferView source = MakePcmView(data, format);
+    std::vector<float> interleaved(source.SampleCount());
+    ConvertPcmToFloat(source, AudioBufferView(interleaved.data(), source.Frames(), source.Channels()));
+
+    const int fileRate = static_cast<int>(format.nSamplesPerSec);
+    bool resampleEachChannel = false;
+    if (fileRate != sampleRate) {
+        // The polyphase table covers common rate pairs; others fall back to the per-sample kernel below
+        PolyphaseResampler resampler;
+        if (resampler.Initialize(fileRate, sampleRate, static_cast<int>(channels))) {
+            std::vector<float> resampled;
+            resampled.reserve(static_cast<size_t>(static_cast<double>(interleaved.size()) * sampleRate / fileRate) +
+                              channels * 64);
+            resampler.Process(interleaved.data(), interleaved.size() / channels, resampled);
+            resampler.Flush(resampled);
+            interleaved.swap(resampled);
+        } else {
+            resampleEachChannel = true;
+        }
+    }
+
+    const size_t frames = interleaved.size() / channels;
+    clip.sampleRate = sampleRate;
+    clip.channels.assign(channels, std::vector<float>(frames));
+    for (size_t frame = 0; frame < frames; frame++) {
+        for (size_t channel = 0; channel < channels; channel++) {
+            clip.channels[channel][frame] = interleaved[frame * channels + channel];
+        }
+    }
+
+    if (resampleEachChannel) {
+        for (auto& channel : clip.channels) {
+            std::vector<float> resampled;
+            if (!Resampler::ResampleOffline(channel, fileRate, sampleRate, resampled)) {
+                std::cout << "Error: Could not resample " << filePath << " to " << sampleRate << "Hz\n";
+                return false;
+            }
+            channel.swap(resampled);
+        }
+    }
+    return clip.GetFrameCount() > 0;
+}
+
+/**
+ * @brief A file decoded into memory, ready to become the playing track
+ */
+struct DecodedTrack {
+    std::string filePath;
+    std::vector<char> audioData;   // PCM, or 1-bit data when dsdStreamRate > 0
+    WAVEFORMATEX format = {};
+    ChannelLayout layout;          // Speaker of each channel in audioData
+    std::string conversion;        // How audioData was derived from the file, if at all
+    int dsdStreamRate = 0;         // DSD rate for DoP/native output, else 0
+    bool generated = false;        // Test tone standing in for an unsupported format
+};
+
+/**
+ * @brief Convert a decoded track to the sample rate, layout and bit depth of the playing one
+ *
+ * The playback thread moves on to a queued track by swapping buffers, so the
+ * queued track must already be in the playing track's format.
+ * @param track Track to convert in place
+ * @param format Format of the playing track
+ * @param layout Layout of the playing track
+ * @return true if successful, false otherwise
+ */
+static bool ConformTrack(DecodedTrack& track, const WAVEFORMATEX& format, const ChannelLayout& layout) {
+    const bool sameRate = track.format.nSamplesPerSec == format.nSamplesPerSec;
+    if (sameRate && track.format.wBitsPerSample == format.wBitsPerSample && track.layout == layout) {
+        track.format = format;
+        return true;
+    }
+
+    const ConstPcmBufferView source = MakePcmView(track.audioData, track.format);
+    const size_t frames = source.Frames();
+    std::vector<float> samples(source.SampleCount());
+    ConvertPcmToFloat(source, AudioBufferView(samples.data(), frames, source.Channels()));
+
+    if (track.layout != layout) {
+        ChannelMixer mixer;
+        mixer.Configure(track.layout, layout);
+        std::vector<float> mixed(frames * layout.GetChannelCount());
+        mixer.Process(samples.data(), mixed.data(), frames);
+        samples.swap(mixed);
+    }
+
+    if (!sameRate) {
+        PolyphaseResampler resampler;
+        if (!resampler.Initialize(static_cast<int>(track.format.nSamplesPerSec), static_cast<int>(format.nSamplesPerSec),
+                                  layout.GetChannelCount())) {
+            std::cout << "Error: Cannot convert " << track.format.nSamplesPerSec << "Hz to "
+                      << format.nSamplesPerSec << "Hz - " << track.filePath << "\n";
+            return false;
+        }
+        std::vector<float> resampled;
+        resampled.reserve(static_cast<size_t>(static_cast<double>(samples.size()) * format.nSamplesPerSec /
+                                              track.format.nSamplesPerSec) + layout.GetChannelCount() * 64);
+        resampler.Process(samples.data(), frames, resampled);
+        resampler.Flush(resampled);
+        samples.swap(resampled);
+    }
+
+    std::ostringstream note;
+    note << "converted from " << track.format.nSamplesPerSec << "Hz " << track.format.wBitsPerSample << "-bit "
+         << track.layout.Describe();
+    track.conversion = track.conversion.empty() ? note.str() : track.conversion + ", " + note.str();
+
+    const size_t conformedFrames = samples.size() / layout.GetChannelCount();
+    track.audioData.resize(conformedFrames * format.nBlockAlign);
+    ConvertFloatToPcm(ConstAudioBufferView(samples.data(), conformedFrames, layout.GetChannelCount()),
+                      PcmBufferView(track.audioData.data(), conformedFrames, format.nChannels, format.wBitsPerSample));
+    track.format = format;
+    track.layout = layout;
+    return true;
+}
+
+// Reply slot of a control command, owned by the posting thread
+struct CommandReply {
+    std::promise<bool> result;
+    std::atomic<bool> released{false};   // The playback thread is done with the reply
+};
+
+// Control operation applied by the playback thread at the next block boundary
+struct ControlCommand {
+    enum class Type { Pause, Resume, Seek, Stop, Change };
+    Type type = Type::Stop;
+    size_t position = 0;        // Seek: byte position in audioData
+    double seconds = 0.0;       // Seek: position in seconds
+    uint64_t generation = 0;    // Stop: playback thread it is meant for
+    void (*change)(void*) = nullptr;   // Change: applied to the render state with the context
+    void* context = nullptr;
+    CommandReply* reply = nullptr;   // Null when the poster does not wait for the result
+};
+
+// Render state the control thread follows, published by whichever thread renders
+struct RenderSnapshot {
+    uint64_t tracksStarted = 0;   // Queued tracks the playback thread has switched to
+    size_t trackBytes = 0;        // Size of the current track's audioData
+    size_t crossfadeFrames = 0;   // Frames of the current track mixed with the queued one
+    bool trackQueued = false;
+};
+
+class AudioEngine::Impl {
+public:
+    // Commands the control thread can post before the playback thread takes them
+    static const size_t kCommandCapacity = 64;
+
+    // Retries of a post to a full queue: yields first, then sleeps
+    static const int kCommandRetryYields = 16;
+    static constexpr std::chrono::milliseconds kCommandRetrySleep{1};
+
+    Impl() {
+        controlQueue.Reset(kCommandCapacity);
+#ifdef _WIN32
+        playbackEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+#endif
+    }
+
+    ~Impl() {
+#ifdef _WIN32
+        if (playbackEvent) {
+            CloseHandle(playbackEvent);
+        }
+#endif
+    }
+
+    // Core initialization state
+    bool initialized = false;
+    std::string currentFile;
+
+    // Audio state with atomic variables for thread safety
+    std::atomic<bool> isPlaying{false};
+    std::atomic<bool> isPaused{false};
+
+    // Control commands for the playback thread. Pause, resume, seek, stop and every
+    // change to the render state are posted here and applied between blocks, so the
+    // control thread never touches render state while a block is rendered and never
+    // polls for the result.
+    CommandQueue<ControlCommand> controlQueue;
+    std::atomic<bool> acceptingCommands{false};   // A playback thread is running and takes commands
+#ifdef _WIN32
+    HANDLE playbackEvent = nullptr;               // Signalled by the device and by posted commands
+#else
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    bool wakePending = false;                     // (wakeMutex)
+#endif
+
+    // Audio data and parameters
+    std::vector<char> audioData;
+    WAVEFORMATEX waveFormat = {};
+    const SampleFormat::Codec* sourceCodec = &SampleFormat::GetCodec(0);   // Kernels for waveFormat
+    ChannelLayout sourceLayout;   // Speaker of each channel in audioData
+    std::string sourceConversion; // How audioData was derived from the file (DSD to PCM), if at all
+    DSDConverter::Options dsdOptions;
+    DSDPacker::Mode dsdOutputMode = DSDPacker::Mode::PCM;
+    int dsdStreamRate = 0;        // DSD rate when audioData holds 1-bit data for DoP/native output, else 0
+    DSDPacker::Mode dsdDeviceMode = DSDPacker::Mode::PCM;   // dsdOutputMode the device format was built for
+    uint8_t dopMarker = DSDPacker::kDoPMarker;
+
+    // Output device format; differs from waveFormat when the output layout does
+    std::string outputLayoutName = "source";   // "source" keeps the file's layout
+    bool outputLayoutPending = false;          // Changed while playing, applied on the next Play
+    ChannelLayout deviceLayout;
+    WAVEFORMATEX deviceFormat = {};
+    const SampleFormat::Codec* deviceCodec = &SampleFormat::GetCodec(0);   // Kernels for deviceFormat
+    ChannelMixer outputMixer;                  // Source -> device channels, after the DSP chain
+    std::vector<float> mixBuffer;
+
+    // Additional streams mixed over the file at the device format, after the output mixer
+    StreamMixer streamMixer;
+#ifdef _WIN32
+    HWAVEOUT hWaveOut = nullptr;
+    WAVEHDR waveHeaders[OutputBuffering::kMaxPeriodCount] = {};
+    std::vector<char> deviceBuffers[OutputBuffering::kMaxPeriodCount];
 #endif
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
+    // Device periods: settings for the next playback, and the queue of the current one
+    BufferSettings bufferSettings;
+    OutputBuffering outputBuffering;
+    bool audioLoaded = false;
+
+    // Audio playback position tracking
+    std::atomic<size_t> playbackPosition{0}; // Position in audio data buffer (in bytes)
+    double playbackTime = 0.0;   // Playback time in seconds
+
+    // Saved playback position for state persistence
+    size_t savedPlaybackPosition = 0;
+    double savedPlaybackTime = 0.0;
+    bool hasSavedPosition = false;
+
+    // Thread for audio playback. Each one started gets the next generation; a thread that has
+    // been replaced leaves the playback state and the commands to its successor
+    std::thread playbackThread;
+    uint64_t playbackGeneration = 0;   // (audioEngineMutex)
+
+    // GPU processor
+    std::unique_ptr<IGPUProcessor> gpuProcessor;
+
+    // Thread synchronization mutex
+    mutable std::mutex audioEngineMutex;
+
+    // DSP chain applied block by block on the playback thread. While one runs, the
+    // chain and the rest of the render state are only changed through
+    // ChangeRenderState, so rendering takes no lock.
+    ProcessingChain dspChain;
+    std::vector<float> renderBuffer;
+
+    // Volume stage in dspChain, created by the first volume change (owned by the chain)
+    GainStage* volumeStage = nullptr;
+
+    // Track that follows the current one, already in its format. The playback
+    // thread switches to it by swapping buffers.
+    std::unique_ptr<DecodedTrack> nextTrack;
+    size_t crossfadeFrames = 0;          // Frames at the end of the current track mixed with nextTrack (0: gapless)
+    std::vector<float> fadeInGains;      // Per-frame crossfade gains, crossfadeFrames each
+    std::vector<float> fadeOutGains;
+    std::vector<float> crossfadeBuffer;  // Block of nextTrack during the crossfade
+    std::unique_ptr<DecodedTrack> finishedTrack;   // Buffers switched away from, released on the control thread
+    uint64_t tracksStarted = 0;          // Switches to a queued track (render state)
+
+    // Render state as last published, and the control thread's record of the queued track.
+    // The queued track becomes currentFile once tracksStarted reaches queuedTrackNumber
+    SeqlockSnapshot<RenderSnapshot> renderSnapshot;
+    std::string queuedFile;
+    std::string queuedConversion;
+    uint64_t queuedTrackNumber = 0;
+
+    // Where the current and queued track buffers live. They move between audioData and
+    // nextTrack without being reallocated, so memory is locked from this record
+    std::pair<const void*, size_t> currentTrackMemory{nullptr, 0};
+    std::pair<const void*, size_t> queuedTrackMemory{nullptr, 0};
+
+    // Playback-rate change between the source (and crossfade) and the DSP chain; null at 1x
+    std::unique_ptr<TimeStretcher> timeStretcher;
+    double playbackRate = 1.0;
+    TimeStretcher::Mode stretchMode = TimeStretcher::Mode::Music;
+    std::vector<float> stretchBuffer;    // Source frames on their way into the stretcher
+    size_t stretchTailFrames = 0;        // Silence written after the end of the source to flush the stretcher
+
+    // Crossfade applied to tracks queued from now on
+    double crossfadeSeconds = 0.0;
+    Crossfade::Curve crossfadeCurve = Crossfade::Curve::EqualPower;
+    std::vector<float> crossfadeCurvePoints;
+
+    // Real-time setup of the playback thread, applied on the control thread
+    RealtimeSettings realtimeSettings;
+    std::string realtimeScheduling;   // What the system granted ("" until applied)
+    std::string realtimeAffinity;
+    std::string realtimeMemory;
+    std::vector<std::pair<const void*, size_t>> lockedRanges;   // Buffers locked with "buffers"
+    bool memoryLockedAll = false;
+
+    // Waveform overview of the last file asked for (the control thread's, not the playback thread's)
+    std::shared_ptr<const WaveformOverview> waveform;
+    std::string waveformPath;
+
+    // Impulse response applied by the convolution stage ("" when disabled)
+    std::string convolutionFilterPath;
+    size_t convolutionOffloadSize = 4096;   // Smallest partition offloaded to the GPU processor
+
+    // Equalizer bands set with SetEQ (the stage is left out while both are at 0 dB)
+    EqualizerStage::Band eqLow;
+    EqualizerStage::Band eqHigh;
+
+    // Bitrate for lossy output in kbps (0 = encoder default)
+    int targetBitrateKbps = 0;
+
+    // Level/spectrum analysis fed from the playback thread
+    AnalysisTap analysisTap;
+    std::atomic<bool> analysisEnabled{true};
+    bool analysisActive = false;   // The playback thread pushes to the tap (render state)
+
+    // Render cost relative to the block duration, written by the playback thread
+    std::atomic<float> dspLoadAverage{0.0f};
+    std::atomic<float> dspLoadPeak{0.0f};
+
+#ifdef ENABLE_FLAC
+    // FLAC decoding related data
+    std::vector<char> flacBuffer;
+    size_t flacSampleRate = 0;
+    unsigned int flacChannels = 0;
+    unsigned int flacBitsPerSample = 0;
+    uint32_t flacChannelMask = 0;
+    FLAC__uint64 flacTotalSamples = 0;
+    bool isFlacFile = false;
+#endif
+
+    /**
+     * @brief Render the next block of device-format PCM from the playback position
+     * @param destination Output buffer in the device format
+     * @param maxBytes Capacity of the output buffer
+     * @return Number of bytes rendered (0 at end of data)
+     */
+    size_t RenderBlock(char* destination, size_t maxBytes) {
+        if (dsdStreamRate > 0) {
+            return RenderDSDBlock(destination, maxBytes);
+        }
+
+        const size_t blockAlign = waveFormat.nBlockAlign;
+        const size_t deviceAlign = deviceFormat.nBlockAlign;
+        if (blockAlign == 0 || deviceAlign == 0) {
+            return 0;
+        }
+
+        GPU_PLAYER_TRACE_SCOPE("dsp", "render block");
+        auto renderStart = std::chrono::steady_clock::now();
+        size_t position = playbackPosition.load();
+        position -= position % blockAlign;
+        if (position >= audioData.size() && nextTrack) {
+            position = SwitchToNextTrack();
+        }
+        const size_t blockFrame = position / blockAlign;
+
+        // Once the file has ended, playback continues over silence while streams are playing
+        const bool streamsActive = streamMixer.GetActiveVoiceCount() > 0;
+        const size_t maxFrames = std::min(maxBytes / deviceAlign, kRenderBlockFrames);
+        size_t fileFrames = 0;
+        bool bitPerfect = false;
+        if (timeStretcher) {
+            GPU_PLAYER_TRACE_SCOPE("dsp", "time stretch");
+            fileFrames = ReadStretched(position, maxFrames);
+        } else {
+            bool crossfading = false;
+            size_t fadeFrame = 0;
+            fileFrames = GetSourceSpan(blockFrame, maxFrames, crossfading, fadeFrame);
+            bitPerfect = fileFrames > 0 && !crossfading && !streamsActive && dspChain.IsEmpty() &&
+                         outputMixer.IsIdentity();
+            if (bitPerfect) {
+                // Bit-perfect path: nothing to process
+                std::memcpy(destination, audioData.data() + position, fileFrames * blockAlign);
+            } else if (fileFrames > 0) {
+                GPU_PLAYER_TRACE_SCOPE("dsp", "read source");
+                ReadSource(blockFrame, fileFrames, crossfading, fadeFrame, renderBuffer.data());
+            }
+            position += fileFrames * blockAlign;
+        }
+
+        const size_t frames = fileFrames > 0 ? fileFrames : streamsActive ? maxFrames : 0;
+        if (frames == 0) {
+            return 0;
+        }
+
+        if (bitPerfect) {
+            if (analysisActive) {
+                sourceCodec->decode(destination, renderBuffer.data(), frames * waveFormat.nChannels);
+                analysisTap.Push(renderBuffer.data(), frames);
+            }
+        } else {
+            float* output = mixBuffer.data();
+            if (fileFrames > 0) {
+                if (volumeStage) {
+                    // Volume automation is timed in frames of the loaded file
+                    volumeStage->SetTimelinePosition(blockFrame);
+                }
+                {
+                    GPU_PLAYER_TRACE_SCOPE("dsp", "processing chain");
+                    dspChain.Process(AudioBufferView(renderBuffer.data(), frames, waveFormat.nChannels));
+                }
+                if (outputMixer.IsIdentity()) {
+                    output = renderBuffer.data();
+                } else {
+                    GPU_PLAYER_TRACE_SCOPE("dsp", "output mix");
+                    outputMixer.Process(renderBuffer.data(), mixBuffer.data(), frames);
+                }
+            } else {
+                std::fill_n(output, frames * deviceFormat.nChannels, 0.0f);
+            }
+            {
+                GPU_PLAYER_TRACE_SCOPE("dsp", "stream mix");
+                streamMixer.Process(output, frames);
+            }
+            {
+                GPU_PLAYER_TRACE_SCOPE("dsp", "convert to device format");
+                deviceCodec->encode(output, destination, frames * deviceFormat.nChannels);
+            }
+            if (analysisActive) {
+                analysisTap.Push(output, frames);
+            }
+        }
+        UpdateDspLoad(std::chrono::steady_clock::now() - renderStart, frames);
+
+        if (fileFrames > 0) {
+            playbackPosition.store(position);
+            if (waveFormat.nAvgBytesPerSec > 0) {
+                playbackTime = static_cast<double>(position) / waveFormat.nAvgBytesPerSec;
+            }
+        }
+        return frames * deviceAlign;
+    }
+
+    /**
+     * @brief Render a device period, one or more blocks
+     * @param destination Output buffer in the device format
+     * @param maxBytes Size of the period
+     * @return Number of bytes rendered (less than maxBytes only at the end of data)
+     */
+    size_t RenderPeriod(char* destination, size_t maxBytes) {
+        size_t bytes = 0;
+        while (bytes < maxBytes) {
+            size_t rendered = RenderBlock(destination + bytes, maxBytes - bytes);
+            if (rendered == 0) {
+                break;
+            }
+            bytes += rendered;
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief Get how many source frames can be read from a frame in one piece (playback thread)
+     *
+     * The last crossfadeFrames frames overlap the start of the next track. Reads stop at the
+     * start of the overlap, and the gains are indexed by frame, so a seek needs no fade state.
+     * @param frame First frame in audioData
+     * @param maxFrames Largest number of frames wanted
+     * @param crossfading Receives whether the frames are mixed with the next track
+     * @param fadeFrame Receives the frame's offset into the crossfade
+     * @return Number of frames (0 at the end of audioData)
+     */
+    size_t GetSourceSpan(size_t frame, size_t maxFrames, bool& crossfading, size_t& fadeFrame) const {
+        const size_t totalFrames = audioData.size() / waveFormat.nBlockAlign;
+        size_t frames = frame < totalFrames ? std::min(maxFrames, totalFrames - frame) : 0;
+        crossfading = false;
+        fadeFrame = 0;
+        if (nextTrack && crossfadeFrames > 0 && frames > 0) {
+            const size_t fadeStart = totalFrames - crossfadeFrames;
+            if (frame < fadeStart) {
+                frames = std::min(frames, fadeStart - frame);
+            } else {
+                crossfading = true;
+                fadeFrame = frame - fadeStart;
+            }
+        }
+        return frames;
+    }
+
+    /**
+     * @brief Convert source frames to float, mixing in the next track during a crossfade (playback thread)
+     * @param frame First frame in audioData
+     * @param frames Number of frames, as returned by GetSourceSpan
+     * @param crossfading Whether the frames are mixed with the next track
+     * @param fadeFrame Offset of the frames into the crossfade
+     * @param destination Receives interleaved samples
+     */
+    void ReadSource(size_t frame, size_t frames, bool crossfading, size_t fadeFrame, float* destination) {
+        const size_t blockAlign = waveFormat.nBlockAlign;
+        const size_t samples = frames * waveFormat.nChannels;
+        sourceCodec->decode(audioData.data() + frame * blockAlign, destination, samples);
+        if (crossfading) {
+            sourceCodec->decode(nextTrack->audioData.data() + fadeFrame * blockAlign, crossfadeBuffer.data(), samples);
+            Crossfade::Mix(destination, crossfadeBuffer.data(), fadeOutGains.data() + fadeFrame,
+                           fadeInGains.data() + fadeFrame, waveFormat.nChannels, frames);
+        }
+    }
+
+    /**
+     * @brief Feed the time stretcher from the source and read a block of renderBuffer (playback thread)
+     *
+     * Switches to the queued track when the current one runs out. After the end
+     * of the source, silence is written until the stretcher's window is flushed.
+     * @param position Playback position in bytes, advanced by the source frames consumed
+     * @param maxFrames Largest number of frames wanted
+     * @return Number of frames in renderBuffer (0 once the source and the stretcher are drained)
+     */
+    size_t ReadStretched(size_t& position, size_t maxFrames) {
+        const size_t blockAlign = waveFormat.nBlockAlign;
+        size_t needed = timeStretcher->GetInputFramesNeeded(maxFrames);
+        while (needed > 0) {
+            if (position >= audioData.size() && nextTrack) {
+                position = SwitchToNextTrack();
+            }
+            bool crossfading = false;
+            size_t fadeFrame = 0;
+            const size_t frame = position / blockAlign;
+            size_t frames = GetSourceSpan(frame, std::min(needed, kRenderBlockFrames), crossfading, fadeFrame);
+            if (frames > 0) {
+                ReadSource(frame, frames, crossfading, fadeFrame, stretchBuffer.data());
+                position += frames * blockAlign;
+            } else {
+                frames = std::min({needed, kRenderBlockFrames, timeStretcher->GetWindowFrames() - stretchTailFrames});
+                if (frames == 0) {
+                    break;
+                }
+                std::fill_n(stretchBuffer.begin(), frames * waveFormat.nChannels, 0.0f);
+                stretchTailFrames += frames;
+            }
+            timeStretcher->Write(stretchBuffer.data(), frames);
+            needed -= frames;
+        }
+        return timeStretcher->Read(renderBuffer.data(), maxFrames);
+    }
+
+    /**
+     * @brief Make the queued track the current one (playback thread)
+     *
+     * Buffers are only swapped, so nothing is allocated or freed here. The
+     * crossfade has already played the start of the new track. The control
+     * thread takes the track's name from its own record once it sees the switch.
+     * @return Playback position in the new track in bytes
+     */
+    size_t SwitchToNextTrack() {
+        audioData.swap(nextTrack->audioData);
+        finishedTrack = std::move(nextTrack);
+
+        const size_t position = crossfadeFrames * waveFormat.nBlockAlign;
+        crossfadeFrames = 0;
+        tracksStarted++;
+        playbackPosition.store(position);
+        PublishRenderSnapshot();
+        return position;
+    }
+
+    /**
+     * @brief Pack the next block of DSD for DoP or native output, bypassing the DSP chain and mixer (playback thread)
+     * @param destination Output buffer in the device format
+     * @param maxBytes Capacity of the output buffer
+     * @return Number of bytes rendered (0 at end of data)
+     */
+    size_t RenderDSDBlock(char* destination, size_t maxBytes) {
+        const size_t channels = waveFormat.nChannels;
+        const size_t groupBytes = DSDPacker::GetBytesPerFrame(dsdDeviceMode);
+        const size_t sourceAlign = channels * groupBytes;
+        const size_t deviceAlign = deviceFormat.nBlockAlign;
+        if (sourceAlign == 0 || deviceAlign == 0) {
+            return 0;
+        }
+
+        size_t position = playbackPosition.load();
+        position -= position % sourceAlign;
+        if (position >= audioData.size()) {
+            return 0;
+        }
+
+        const size_t frames = std::min(maxBytes / deviceAlign, (audioData.size() - position) / sourceAlign);
+        if (frames == 0) {
+            return 0;
+        }
+
+        GPU_PLAYER_TRACE_SCOPE("dsp", "pack dsd");
+        auto renderStart = std::chrono::steady_clock::now();
+        const uint8_t* source = reinterpret_cast<const uint8_t*>(audioData.data() + position);
+        if (dsdDeviceMode == DSDPacker::Mode::DoP) {
+            DSDPacker::PackDoP(source, frames * groupBytes, static_cast<int>(channels), dopMarker,
+                               reinterpret_cast<int32_t*>(destination));
+        } else {
+            DSDPacker::PackNative(source, frames * groupBytes, static_cast<int>(channels),
+                                  reinterpret_cast<uint8_t*>(destination));
+        }
+        UpdateDspLoad(std::chrono::steady_clock::now() - renderStart, frames * groupBytes);
+
+        const size_t bytes = frames * sourceAlign;
+        playbackPosition.store(position + bytes);
+        playbackTime = static_cast<double>(position + bytes) / waveFormat.nAvgBytesPerSec;
+        return frames * deviceAlign;
+    }
+
+    /**
+     * @brief Fold the render time of one block into the DSP load meters
+     * @param elapsed Time spent rendering the block
+     * @param frames Number of frames rendered
+     */
+    void UpdateDspLoad(std::chrono::steady_clock::duration elapsed, size_t frames) {
+        if (waveFormat.nSamplesPerSec == 0 || frames == 0) {
+            return;
+        }
+        double blockSeconds = static_cast<double>(frames) / waveFormat.nSamplesPerSec;
+        float load = static_cast<float>(std::chrono::duration<double>(elapsed).count() / blockSeconds);
+        float average = dspLoadAverage.load(std::memory_order_relaxed);
+        dspLoadAverage.store(average + 0.05f * (load - average), std::memory_order_relaxed);
+        if (load > dspLoadPeak.load(std::memory_order_relaxed)) {
+            dspLoadPeak.store(load, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Restart the analysis tap for the current stream format (or stop it when disabled)
+     */
+    void RestartAnalysis() {
+        // The tap's ring is reallocated, so the playback thread stops pushing meanwhile
+        ChangeRenderState([this]() { analysisActive = false; });
+        if (analysisEnabled.load() && audioLoaded && deviceFormat.nChannels > 0 && dsdStreamRate == 0) {
+            // Filling the device queue pushes whole periods at once
+            const size_t queueFrames = bufferSettings.periodFrames *
+                (bufferSettings.adaptive ? OutputBuffering::kMaxPeriodCount : bufferSettings.periodCount);
+            analysisTap.Start(static_cast<int>(deviceFormat.nSamplesPerSec), deviceFormat.nChannels, queueFrames);
+        } else {
+            analysisTap.Stop();
+        }
+        if (analysisTap.IsRunning()) {
+            ChangeRenderState([this]() { analysisActive = true; });
+        }
+    }
+
+    /**
+     * @brief Configure the output mixer and device format for the loaded audio and the output layout
+     *
+     * The device is opened with this format, so it is only rebuilt while nothing is played.
+     */
+    void RebuildOutputMixer() {
+        ChannelLayout layout = sourceLayout;
+        if (outputLayoutName != "source") {
+            ChannelLayout::Parse(outputLayoutName, layout);
+        }
+
+        deviceLayout = layout;
+        outputMixer.Configure(sourceLayout, deviceLayout);
+        deviceFormat = waveFormat;
+        deviceFormat.nChannels = static_cast<uint16_t>(deviceLayout.GetChannelCount());
+        deviceFormat.nBlockAlign = static_cast<uint16_t>(deviceFormat.nChannels * deviceFormat.wBitsPerSample / 8);
+        deviceFormat.nAvgBytesPerSec = deviceFormat.nSamplesPerSec * deviceFormat.nBlockAlign;
+        mixBuffer.resize(kRenderBlockFrames * deviceLayout.GetChannelCount());
+        streamMixer.Prepare(deviceLayout.GetChannelCount(), kRenderBlockFrames, kMaxStreams);
+
+        if (dsdStreamRate > 0) {
+            // DoP and native DSD carry the source channels unmixed, as 32-bit device samples
+            deviceLayout = sourceLayout;
+            outputMixer.Configure(sourceLayout, sourceLayout);
+            deviceFormat.nChannels = waveFormat.nChannels;
+            deviceFormat.wBitsPerSample = 32;
+            deviceFormat.nSamplesPerSec = dsdStreamRate / (8 * DSDPacker::GetBytesPerFrame(dsdOutputMode));
+            deviceFormat.nBlockAlign = static_cast<uint16_t>(deviceFormat.nChannels * 4);
+            deviceFormat.nAvgBytesPerSec = deviceFormat.nSamplesPerSec * deviceFormat.nBlockAlign;
+            dopMarker = DSDPacker::kDoPMarker;
+        }
+        dsdDeviceMode = dsdOutputMode;
+        deviceCodec = &SampleFormat::GetCodec(deviceFormat.wBitsPerSample);
+    }
+
+    /**
+     * @brief (Re)build the convolution stage for the current stream format
+     * @return true if the stage is active or convolution is disabled, false on error
+     */
+    bool RebuildConvolutionStage() {
+        std::unique_ptr<IProcessingStage> stage;
+
+        if (!convolutionFilterPath.empty() && audioLoaded && waveFormat.nChannels > 0 && dsdStreamRate == 0) {
+            ImpulseResponse impulseResponse;
+            if (!impulseResponse.LoadWav(convolutionFilterPath, static_cast<int>(waveFormat.nSamplesPerSec))) {
+                return false;
+            }
+
+            ConvolutionStage::Options options;
+            options.accelerator = gpuProcessor.get();
+            options.acceleratorMinPartition = convolutionOffloadSize;
+            auto convolution = std::make_unique<ConvolutionStage>(impulseResponse, options);
+            if (!convolution->Prepare(static_cast<int>(waveFormat.nSamplesPerSec), waveFormat.nChannels,
+                                      kRenderBlockFrames)) {
+                return false;
+            }
+            std::cout << "Convolution filter active: " << convolution->GetName() << "\n";
+            stage = std::move(convolution);
+        }
+
+        SwapStage("convolution", stage);
+        // The previous stage is released here, on the control thread
+        return true;
+    }
+
+    /**
+     * @brief (Re)build the equalizer stage for the current stream format and bands
+     * @return true if the stage is active or flat, false on error
+     */
+    bool RebuildEqualizerStage() {
+        std::unique_ptr<IProcessingStage> stage;
+
+        auto equalizer = std::make_unique<EqualizerStage>(eqLow, eqHigh);
+        if (!equalizer->IsFlat() && audioLoaded && waveFormat.nChannels > 0 && dsdStreamRate == 0) {
+            if (!equalizer->Prepare(static_cast<int>(waveFormat.nSamplesPerSec), waveFormat.nChannels,
+                                    kRenderBlockFrames)) {
+                return false;
+            }
+            stage = std::move(equalizer);
+        }
+
+        SwapStage("eq", stage);
+        // The previous stage is released here, on the control thread
+        return true;
+    }
+
+    /**
+     * @brief Put a prepared stage into a slot of the DSP chain (control thread)
+     *
+     * A playback thread swaps the stage in at its next block boundary; with none
+     * running, the stage is set directly.
+     * @param slot Slot name
+     * @param stage Stage to put in, or nullptr to clear the slot; receives the previous stage
+     */
+    void SwapStage(const std::string& slot, std::unique_ptr<IProcessingStage>& stage) {
+        ChangeRenderState([this, &slot, &stage]() { stage = dspChain.SetStage(slot, std::move(stage)); });
+    }
+
+    /**
+     * @brief Prepare the render buffers and the DSP chain for the current stream format (nothing playing)
+     */
+    void PrepareRenderBuffers() {
+        renderBuffer.resize(kRenderBlockFrames * std::max<size_t>(waveFormat.nChannels, 1));
+        crossfadeBuffer.resize(renderBuffer.size());
+        dspChain.Prepare(std::max<int>(waveFormat.nChannels, 1), kRenderBlockFrames);
+        if (volumeStage) {
+            volumeStage->Prepare(static_cast<int>(waveFormat.nSamplesPerSec), std::max<int>(waveFormat.nChannels, 1),
+                                 kRenderBlockFrames);
+        }
+    }
+
+    /**
+     * @brief Create the volume stage for the current stream format, unless there is one
+     */
+    void CreateVolumeStage() {
+        if (volumeStage) {
+            return;
+        }
+        auto gain = std::make_unique<GainStage>();
+        gain->Prepare(static_cast<int>(waveFormat.nSamplesPerSec), std::max<int>(waveFormat.nChannels, 1),
+                      kRenderBlockFrames);
+        GainStage* created = gain.get();
+        std::unique_ptr<IProcessingStage> stage = std::move(gain);
+        ChangeRenderState([this, created, &stage]() {
+            volumeStage = created;
+            stage = dspChain.SetStage("volume", std::move(stage));
+        });
+    }
+
+    /**
+     * @brief Encode the loaded audio to a lossy file, streaming it through the encoder block by block
+     * @param filePath Output path; the extension selects the codec
+     * @return true if successful, false otherwise
+     */
+    bool EncodeToFile(const std::string& filePath) {
+        // Default bitrate when none was set
+        const int kDefaultBitrateKbps = 160;
+        // Frames converted and pushed to the encoder per call
+        const size_t kEncodeBlockFrames = 8192;
+
+        auto encoder = EncoderFactory::CreateEncoder(filePath);
+        if (!encoder) {
+            std::cout << "Error: No encoder for " << filePath << " in this build (available: "
+                      << EncoderFactory::GetAvailableFormats() << ")\n";
+            return false;
+        }
+
+        const int bitrate = targetBitrateKbps > 0 ? targetBitrateKbps : kDefaultBitrateKbps;
+        const ConstPcmBufferView track = MakePcmView(audioData, waveFormat);
+
+        // The encoders take mono or stereo; wider layouts are downmixed first
+        ChannelMixer downmix;
+        ChannelLayout encodeLayout = sourceLayout;
+        if (sourceLayout.GetChannelCount() > 2) {
+            ChannelLayout::Parse("stereo", encodeLayout);
+            downmix.Configure(sourceLayout, encodeLayout);
+            std::cout << "Encoding a " << downmix.GetName() << "\n";
+        }
+
+        if (track.BlockAlign() == 0 || waveFormat.nSamplesPerSec == 0 ||
+            !encoder->Open(filePath, static_cast<int>(waveFormat.nSamplesPerSec), encodeLayout.GetChannelCount(),
+                           bitrate)) {
+            std::cout << "Error: Could not start encoder for " << filePath << "\n";
+            return false;
+        }
+        std::cout << "Encoding with " << encoder->GetName() << "\n";
+
+        const size_t totalFrames = track.Frames();
+        std::vector<float> block(kEncodeBlockFrames * track.Channels());
+        std::vector<float> mixed(kEncodeBlockFrames * encodeLayout.GetChannelCount());
+        auto start = std::chrono::steady_clock::now();
+
+        bool success = true;
+        for (size_t frame = 0; frame < totalFrames && success; frame += kEncodeBlockFrames) {
+            const ConstPcmBufferView source = track.Subview(frame, kEncodeBlockFrames);
+            const size_t frames = source.Frames();
+            ConvertPcmToFloat(source, AudioBufferView(block.data(), frames, source.Channels()));
+            if (encodeLayout != sourceLayout) {
+                downmix.Process(block.data(), mixed.data(), frames);
+                success = encoder->Write(mixed.data(), frames);
+            } else {
+                success = encoder->Write(block.data(), frames);
+            }
+        }
+        success = encoder->Close() && success;
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double audioSeconds = static_cast<double>(totalFrames) / waveFormat.nSamplesPerSec;
+        if (!success) {
+            std::cout << "Error: Encoding failed for " << filePath << "\n";
+            return false;
+        }
+
+        uint64_t bytes = encoder->GetBytesWritten();
+        std::cout << std::fixed << std::setprecision(1)
+                  << "Encoded " << audioSeconds << "s of audio in " << elapsed << "s ("
+                  << (elapsed > 0.0 ? audioSeconds / elapsed : 0.0) << "x realtime), "
+                  << bytes / 1024 << "KB, "
+                  << (audioSeconds > 0.0 ? bytes * 8.0 / 1000.0 / audioSeconds : 0.0) << "kbps average\n";
+        std::cout.unsetf(std::ios::floatfield);
+        return true;
+    }
+
+    /**
+     * @brief Decode a file into memory without touching the playing track
+     * @param filePath Path to the audio file
+     * @param track Receives the decoded audio
+     * @return true if successful, false otherwise
+     */
+    bool DecodeFile(const std::string& filePath, DecodedTrack& track);
+
+    /**
+     * @brief Make a decoded track the loaded one, dropping any queued track
+     *
+     * While playing, a track in the format being played is swapped in by the
+     * playback thread. Any other track stops playback first, as the device is
+     * open with the previous format.
+     * @param track Decoded track; its buffers are taken over
+     * @return true if playback was stopped for the new format and should start again
+     */
+    bool InstallTrack(DecodedTrack& track) {
+        std::unique_ptr<DecodedTrack> queued;
+        std::unique_ptr<DecodedTrack> finished;
+        const bool sameFormat = audioLoaded && track.format.nSamplesPerSec == waveFormat.nSamplesPerSec &&
+                                track.format.nChannels == waveFormat.nChannels &&
+                                track.format.wBitsPerSample == waveFormat.wBitsPerSample &&
+                                track.layout == sourceLayout && track.dsdStreamRate == dsdStreamRate &&
+                                (dsdStreamRate == 0 || dsdOutputMode == dsdDeviceMode);
+        if (isPlaying.load() && sameFormat) {
+            const std::pair<const void*, size_t> memory(track.audioData.data(), track.audioData.size());
+            ChangeRenderState([&]() {
+                audioData.swap(track.audioData);
+                queued = std::move(nextTrack);
+                finished = std::move(finishedTrack);
+                crossfadeFrames = 0;
+                playbackPosition.store(0);
+                playbackTime = 0.0;
+                dspChain.Reset();
+                if (timeStretcher) {
+                    timeStretcher->Reset();
+                    stretchTailFrames = 0;
+                }
+            });
+            // The previous buffers are released here, on the control thread
+            track.audioData.clear();
+            sourceConversion.swap(track.conversion);
+            currentFile = track.filePath;
+            currentTrackMemory = memory;
+            OnTrackChanged();
+            if (realtimeSettings.enabled) {
+                LockPlaybackMemory();
+            }
+            return false;
+        }
+
+        // The playback thread no longer renders once it has taken the stop
+        const bool wasPaused = isPaused.load();
+        const bool restart = StopPlaybackThread() && !wasPaused;
+        isPlaying.store(false);
+        isPaused.store(false);
+
+        audioData.swap(track.audioData);
+        waveFormat = track.format;
+        sourceCodec = &SampleFormat::GetCodec(waveFormat.wBitsPerSample);
+        sourceLayout = track.layout;
+        sourceConversion.swap(track.conversion);
+        dsdStreamRate = track.dsdStreamRate;
+        currentFile = track.filePath;
+        currentTrackMemory = {audioData.data(), audioData.size()};
+        queued = std::move(nextTrack);
+        finished = std::move(finishedTrack);
+        crossfadeFrames = 0;
+        track.audioData.clear();
+        audioLoaded = true;
+        playbackPosition.store(0);
+        playbackTime = 0.0;
+        PublishRenderSnapshot();
+        OnTrackChanged();
+        OnFileLoaded();
+        return restart;
+    }
+
+    /**
+     * @brief Forget the position and queued track of the previous track (control thread)
+     */
+    void OnTrackChanged() {
+        hasSavedPosition = false;
+        dspLoadAverage.store(0.0f);
+        dspLoadPeak.store(0.0f);
+        queuedFile.clear();
+        queuedConversion.clear();
+        queuedTrackMemory = {nullptr, 0};
+    }
+
+    /**
+     * @brief Adapt the output format and the DSP chain to a newly loaded file (nothing playing)
+     */
+    void OnFileLoaded() {
+        outputLayoutPending = false;
+        RebuildOutputMixer();
+        PrepareRenderBuffers();
+        if (!RebuildConvolutionStage()) {
+            std::cout << "Warning: Convolution filter disabled for this file\n";
+        }
+        if (!RebuildEqualizerStage()) {
+            std::cout << "Warning: Equalizer disabled for this file\n";
+        }
+        PrepareTimeStretcher();
+        RestartAnalysis();
+        if (realtimeSettings.enabled) {
+            LockPlaybackMemory();
+        }
+    }
+
+    /**
+     * @brief Get the waveform overview of a file from memory, the cache directory, or by decoding it
+     *
+     * A decoded overview is saved under CacheDirectory("waveforms"), keyed by the
+     * file's path, size and modification time, so each file is decoded for its
+     * overview only once.
+     * @param filePath Path to the audio file
+     * @return The overview, or null if the file cannot be decoded
+     */
+    std::shared_ptr<const WaveformOverview> GetWaveformOverview(const std::string& filePath) {
+        if (waveform && waveformPath == filePath) {
+            return waveform;
+        }
+
+        std::error_code error;
+        const uint64_t fileSize = std::filesystem::file_size(filePath, error);
+        std::string cachePath;
+        if (!error) {
+            const auto modified = std::filesystem::last_write_time(filePath, error).time_since_epoch().count();
+            std::string directory = CacheDirectory::Get("waveforms");
+            if (!error && !directory.empty()) {
+                std::ostringstream key;
+                key << std::filesystem::absolute(filePath, error).string() << "|" << fileSize << "|" << modified;
+                cachePath = directory + "/" + CacheDirectory::HashKey(key.str()) + ".wfo";
+            }
+        }
+
+        auto overview = std::make_shared<WaveformOverview>();
+        if (cachePath.empty() || !overview->Load(cachePath)) {
+            DecodedTrack track;
+            if (!DecodeFile(filePath, track)) {
+                return nullptr;
+            }
+            if (track.dsdStreamRate > 0) {
+                std::cout << "Error: Waveform overviews of DSD files need DSD output set to pcm\n";
+                return nullptr;
+            }
+            const ConstPcmBufferView source = MakePcmView(track.audioData, track.format);
+            if (source.BlockAlign() == 0 ||
+                !overview->Begin(static_cast<int>(track.format.nSamplesPerSec), source.Channels())) {
+                return nullptr;
+            }
+            std::vector<float> block(kRenderBlockFrames * source.Channels());
+            for (size_t frame = 0; frame < source.Frames(); frame += kRenderBlockFrames) {
+                const ConstPcmBufferView chunk = source.Subview(frame, kRenderBlockFrames);
+                ConvertPcmToFloat(chunk, AudioBufferView(block.data(), chunk.Frames(), chunk.Channels()));
+                overview->Append(block.data(), chunk.Frames());
+            }
+            overview->Finish();
+            if (!track.generated && !cachePath.empty() && !overview->Save(cachePath)) {
+                std::cout << "Warning: Could not save the waveform overview to " << cachePath << "\n";
+            }
+        }
+        waveform = overview;
+        waveformPath = filePath;
+        return waveform;
+    }
+
+    /**
+     * @brief Change the render state from the control thread
+     *
+     * With a playback thread running, the change is applied there between two
+     * blocks while the control thread waits; otherwise it is applied here. The
+     * render path takes no lock either way, and whatever the change swaps out is
+     * released on the control thread.
+     * @param change Callable applied once, without allocating or freeing when on the playback thread
+     */
+    template <typename Change>
+    void ChangeRenderState(Change&& change) {
+        using Function = typename std::remove_reference<Change>::type;
+        ControlCommand command;
+        command.type = ControlCommand::Type::Change;
+        command.change = [](void* context) { (*static_cast<Function*>(context))(); };
+        command.context = const_cast<void*>(static_cast<const void*>(&change));
+        if (!PostCommand(command)) {
+            change();
+            PublishRenderSnapshot();
+        }
+    }
+
+    /**
+     * @brief Publish the render state the control thread follows (the thread that renders)
+     */
+    void PublishRenderSnapshot() {
+        RenderSnapshot snapshot;
+        snapshot.tracksStarted = tracksStarted;
+        snapshot.trackBytes = audioData.size();
+        snapshot.crossfadeFrames = crossfadeFrames;
+        snapshot.trackQueued = nextTrack != nullptr;
+        renderSnapshot.Publish(snapshot);
+    }
+
+    /**
+     * @brief Read the render state and catch up with a switch to the queued track (control thread)
+     * @return The published render state
+     */
+    RenderSnapshot FollowRenderState() {
+        RenderSnapshot snapshot;
+        // The writer only holds the sequence for a few stores
+        while (!renderSnapshot.Read(snapshot)) {
+        }
+        if (!queuedFile.empty() && snapshot.tracksStarted >= queuedTrackNumber) {
+            currentFile.swap(queuedFile);
+            sourceConversion.swap(queuedConversion);
+            queuedFile.clear();
+            queuedConversion.clear();
+            currentTrackMemory = queuedTrackMemory;
+            queuedTrackMemory = {nullptr, 0};
+        }
+        return snapshot;
+    }
+
+    /**
+     * @brief Post a command to the playback thread and wait for it to be applied (control thread)
+     * @param command Command to post; its reply is set here
+     * @return true if the playback thread applied it, false if no playback thread takes commands
+     */
+    bool PostCommand(ControlCommand command) {
+        CommandReply reply;
+        std::future<bool> result = reply.result.get_future();
+        command.reply = &reply;
+        if (!PushCommand(command)) {
+            return false;
+        }
+
+        // The playback thread answers every command it takes, and the commands left when it
+        // exits. If it exited just before the push, the commands left are answered here
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!acceptingCommands.load()) {
+            std::lock_guard<std::mutex> lock(audioEngineMutex);
+            if (!acceptingCommands.load()) {
+                DrainCommands();
+            }
+        }
+        bool applied = result.get();
+        // The reply lives on this stack until the playback thread has let go of it
+        while (!reply.released.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        return applied;
+    }
+
+    /**
+     * @brief Queue a command for the playback thread and wake it, without waiting for the result
+     * @param command Command to queue
+     * @return true if queued, false if no playback thread takes commands
+     */
+    bool PushCommand(const ControlCommand& command) {
+        if (!acceptingCommands.load()) {
+            return false;
+        }
+        for (int attempt = 0; !controlQueue.Push(command); attempt++) {
+            // Full: the playback thread frees slots at its next block boundary. Sleep rather than
+            // spin once a few yields have not been enough, so a busy playback thread is not starved
+            if (!acceptingCommands.load()) {
+                return false;
+            }
+            WakePlaybackThread();
+            if (attempt < kCommandRetryYields) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(kCommandRetrySleep);
+            }
+        }
+        WakePlaybackThread();
+        return true;
+    }
+
+    /**
+     * @brief Wake the playback thread so it takes posted commands (any thread)
+     */
+    void WakePlaybackThread() {
+#ifdef _WIN32
+        SetEvent(playbackEvent);
+#else
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            wakePending = true;
+        }
+        wakeCondition.notify_one();
 #endif
+    }
 
-#ifdef ENABLE_FLAC
-#include <FLAC/all.h>
+#ifndef _WIN32
+    /**
+     * @brief Sleep until a command is posted or a deadline passes (playback thread)
+     * @param deadline Time to wake up at, or nullptr to wait for a command only
+     */
+    void WaitForCommand(const std::chrono::steady_clock::time_point* deadline) {
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        if (deadline) {
+            wakeCondition.wait_until(lock, *deadline, [this]() { return wakePending; });
+        } else {
+            wakeCondition.wait(lock, [this]() { return wakePending; });
+        }
+        wakePending = false;
+    }
 #endif
 
-// Implementation of AudioEngine interface
+    /**
+     * @brief Answer a command (playback thread)
+     */
+    static void Reply(const ControlCommand& command, bool applied) {
+        if (command.reply) {
+            command.reply->result.set_value(applied);
+            command.reply->released.store(true, std::memory_order_release);
+        }
+    }
 
-class AudioEngine::Impl {
-public:
-    Impl() = default;
+    /**
+     * @brief Answer every queued command as not applied
+     */
+    void DrainCommands() {
+        ControlCommand command;
+        while (controlQueue.Pop(command)) {
+            Reply(command, false);
+        }
+    }
 
-    // Core initialization state
-    bool initialized = false;
-    std::string currentFile;
+    /**
+     * @brief Hand playback back to the control thread as the playback thread exits (playback thread)
+     *
+     * Unless a newer playback thread has taken over, playback is marked stopped
+     * and the commands left are answered as not applied.
+     * @param generation Generation of the exiting thread
+     * @param finished Whether the end of the data was reached, rather than a stop or an error
+     */
+    void FinishPlaybackThread(uint64_t generation, bool finished) {
+        std::lock_guard<std::mutex> lock(audioEngineMutex);
+        if (generation != playbackGeneration) {
+            return;
+        }
+        if (finished) {
+            playbackTime = 0.0;
+            playbackPosition.store(0);
+            dspChain.Reset();
+        }
+        isPlaying.store(false);
+        isPaused.store(false);
+        acceptingCommands.store(false);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        DrainCommands();
+    }
 
-    // Audio state with atomic variables for thread safety
-    std::atomic<bool> isPlaying{false};
-    std::atomic<bool> isPaused{false};
-    std::atomic<bool> shouldStop{false};
+    /**
+     * @brief Apply the posted commands at a block boundary (playback thread)
+     * @param generation Generation of the calling playback thread
+     * @param flush Set when queued device audio is stale (after a seek)
+     * @return true if playback should stop
+     */
+    bool ApplyControlCommands(uint64_t generation, bool& flush) {
+        ControlCommand command;
+        while (controlQueue.Pop(command)) {
+            switch (command.type) {
+            case ControlCommand::Type::Pause:
+                isPaused.store(true);
+                break;
+            case ControlCommand::Type::Resume:
+                isPaused.store(false);
+                break;
+            case ControlCommand::Type::Seek:
+                // Filter state from the old position must not bleed into the new one. The
+                // track may have switched since the poster checked the position
+                playbackPosition.store(std::min(command.position, audioData.size()));
+                playbackTime = command.seconds;
+                dspChain.Reset();
+                if (timeStretcher) {
+                    timeStretcher->Reset();
+                    stretchTailFrames = 0;
+                }
+                flush = true;
+                break;
+            case ControlCommand::Type::Change:
+                // The poster waits for the reply, so it sees the state published with it
+                command.change(command.context);
+                PublishRenderSnapshot();
+                break;
+            case ControlCommand::Type::Stop:
+                // A stop for the thread this one replaced was not taken in time; it does not apply here
+                if (command.generation != generation) {
+                    Reply(command, false);
+                    continue;
+                }
+                Reply(command, true);
+                return true;
+            }
+            Reply(command, true);
+        }
+        return false;
+    }
 
-    // Audio data and parameters
-    std::vector<char> audioData;
-    WAVEFORMATEX waveFormat = {};
-    HWAVEOUT hWaveOut = nullptr;
-    WAVEHDR waveHeader = {};
-    bool audioLoaded = false;
+    /**
+     * @brief Stop the playback thread, if any (control thread)
+     *
+     * Returns once the thread has stopped rendering; it closes the device and
+     * exits on its own, and is joined by the next playback thread.
+     * @return true if a playback thread was running
+     */
+    bool StopPlaybackThread() {
+        ControlCommand command;
+        command.type = ControlCommand::Type::Stop;
+        command.generation = playbackGeneration;
+        return PostCommand(command);
+    }
 
-    // Audio playback position tracking
-    size_t playbackPosition = 0; // Position in audio data buffer (in bytes)
-    double playbackTime = 0.0;   // Playback time in seconds
+    /**
+     * @brief Apply the real-time settings to the playback thread (control thread)
+     *
+     * Does not wait for the playback thread, so it may run while one starts or stops.
+     */
+    void ApplyRealtime() {
+        if (!realtimeSettings.enabled) {
+            UnlockPlaybackMemory();
+            realtimeScheduling.clear();
+            realtimeAffinity.clear();
+            realtimeMemory.clear();
+            return;
+        }
+        if (playbackThread.joinable()) {
+            RealtimeThread::SetScheduling(playbackThread, realtimeSettings.roundRobin, realtimeSettings.priority,
+                                          realtimeScheduling);
+            RealtimeThread::SetAffinity(playbackThread, realtimeSettings.cpus, realtimeAffinity);
+        }
+        LockPlaybackMemory();
+    }
 
-    // Saved playback position for state persistence
-    size_t savedPlaybackPosition = 0;
-    double savedPlaybackTime = 0.0;
-    bool hasSavedPosition = false;
+    /**
+     * @brief Lock what the playback thread touches into RAM, as configured (control thread)
+     *
+     * With "buffers", the render buffers and the current and queued tracks are
+     * locked and faulted in; call again whenever they are reallocated.
+     */
+    void LockPlaybackMemory() {
+        if (!realtimeSettings.enabled || realtimeSettings.memory == "off") {
+            UnlockPlaybackMemory();
+            realtimeMemory = realtimeSettings.enabled ? "not locked" : "";
+            return;
+        }
+        if (realtimeSettings.memory == "all") {
+            UnlockPlaybackMemory();
+            memoryLockedAll = RealtimeThread::LockAllMemory(realtimeMemory);
+            return;
+        }
+        if (memoryLockedAll) {
+            RealtimeThread::UnlockAllMemory();
+            memoryLockedAll = false;
+        }
 
-    // Thread for audio playback
-    std::thread playbackThread;
+        // The track buffers are taken from the control thread's record, as the playback thread
+        // swaps them; the render buffers are only reallocated by this thread. Nothing here waits
+        // for the playback thread, so it is safe while one is starting or stopping
+        FollowRenderState();
+        std::vector<std::pair<const void*, size_t>> ranges;
+        auto add = [&ranges](const void* data, size_t bytes) {
+            if (data && bytes > 0) {
+                ranges.emplace_back(data, bytes);
+            }
+        };
+        add(currentTrackMemory.first, currentTrackMemory.second);
+        add(queuedTrackMemory.first, queuedTrackMemory.second);
+        add(renderBuffer.data(), renderBuffer.size() * sizeof(float));
+        add(mixBuffer.data(), mixBuffer.size() * sizeof(float));
+        add(crossfadeBuffer.data(), crossfadeBuffer.size() * sizeof(float));
+        add(stretchBuffer.data(), stretchBuffer.size() * sizeof(float));
+
+        UnlockPlaybackMemory();
+        size_t lockedBytes = 0, totalBytes = 0;
+        for (const auto& range : ranges) {
+            totalBytes += range.second;
+            if (RealtimeThread::LockRange(range.first, range.second)) {
+                lockedRanges.push_back(range);
+                lockedBytes += range.second;
+            } else {
+                RealtimeThread::Prefault(range.first, range.second);
+            }
+        }
+        if (totalBytes == 0) {
+            realtimeMemory = "buffers and tracks are locked when a file is loaded";
+            return;
+        }
+        std::ostringstream report;
+        report << std::fixed << std::setprecision(1) << lockedBytes / 1048576.0 << " of "
+               << totalBytes / 1048576.0 << "MB of buffers and tracks locked";
+        if (lockedBytes < totalBytes) {
+            report << " (the rest prefaulted; raise the memlock limit to lock it)";
+        }
+        realtimeMemory = report.str();
+    }
 
-    // GPU processor
-    std::unique_ptr<IGPUProcessor> gpuProcessor;
+    /**
+     * @brief Unlock the memory locked by LockPlaybackMemory
+     */
+    void UnlockPlaybackMemory() {
+        for (const auto& range : lockedRanges) {
+            RealtimeThread::UnlockRange(range.first, range.second);
+        }
+        lockedRanges.clear();
+        if (memoryLockedAll) {
+            RealtimeThread::UnlockAllMemory();
+            memoryLockedAll = false;
+        }
+    }
 
-    // Thread synchronization mutex
-    mutable std::mutex audioEngineMutex;
+    /**
+     * @brief Create the time stretcher for the loaded audio, or remove it at 1x and for DSD output
+     * @return true if successful, false if the stretcher could not be prepared
+     */
+    bool PrepareTimeStretcher() {
+        std::unique_ptr<TimeStretcher> stretcher;
+        std::vector<float> buffer;
+        bool prepared = true;
+        if (playbackRate != 1.0 && dsdStreamRate == 0 && waveFormat.nChannels > 0) {
+            // The phase vocoder offloads transforms as large as the convolution partitions that pay off on the GPU
+            stretcher = std::make_unique<TimeStretcher>();
+            prepared = stretcher->Prepare(static_cast<int>(waveFormat.nSamplesPerSec), waveFormat.nChannels,
+                                          kRenderBlockFrames, stretchMode, gpuProcessor.get(), convolutionOffloadSize);
+            if (prepared) {
+                stretcher->SetRate(playbackRate);
+                buffer.resize(kRenderBlockFrames * waveFormat.nChannels);
+            } else {
+                stretcher.reset();
+            }
+        }
 
-#ifdef ENABLE_FLAC
-    // FLAC decoding related data
-    std::vector<char> flacBuffer;
-    size_t flacSampleRate = 0;
-    unsigned int flacChannels = 0;
-    unsigned int flacBitsPerSample = 0;
-    FLAC__uint64 flacTotalSamples = 0;
-    bool isFlacFile = false;
+        ChangeRenderState([&]() {
+            timeStretcher.swap(stretcher);
+            stretchBuffer.swap(buffer);
+            stretchTailFrames = 0;
+        });
+        // The previous stretcher is released here, on the control thread
+        return prepared;
+    }
 };
 
 AudioEngine::AudioEngine() : pImpl(std::make_unique<Impl>()) {}
 
-AudioEngine::~AudioEngine() = default;
+AudioEngine::~AudioEngine() {
+    // A running (or finished but unjoined) playback thread must not outlive the engine
+    pImpl->StopPlaybackThread();
+    if (pImpl->playbackThread.joinable()) {
+        pImpl->playbackThread.join();
+    }
+    pImpl->UnlockPlaybackMemory();
+}
 
 // FLAC decoding support (only defined if FLAC support is enabled)
 #ifdef ENABLE_FLAC
-#include <FLAC/all.h>
 
 // Define a structure to pass data to callbacks that avoids accessing private members directly
 struct FlacDecodeData {
@@ -87,7 +1874,9 @@ struct FlacDecodeData {
     size_t* sampleRate;
     unsigned int* channels;
     unsigned int* bitsPerSample;
+    uint32_t* channelMask;
     FLAC__uint64* totalSamples;
+    SampleFormat::InterleaveKernel interleave = nullptr;   // Picked on the first frame
 };
 
 // Define FLAC decoder callback functions
@@ -103,55 +1892,58 @@ static FLAC__StreamDecoderWriteStatus flac_write_callback(const FLAC__StreamDeco
         *data->channels = frame->header.channels;
         *data->bitsPerSample = frame->header.bits_per_sample;
     }
+    if (frame->header.channels != *data->channels || *data->bitsPerSample == 0) {
+        return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
+    }
 
-    // Calculate frame size and convert samples
-    unsigned int frame_size = frame->header.blocksize;
-    unsigned int total_samples = frame_size * (*data->channels);
-    unsigned int bytes_per_sample = (*data->bitsPerSample) / 8;
-    unsigned int total_bytes = total_samples * bytes_per_sample;
-
-    std::vector<char> frame_data(total_bytes);
-    char *data_ptr = frame_data.data();
-
-    for (unsigned int sample = 0; sample < frame_size; sample++) {
-        for (unsigned int channel = 0; channel < (*data->channels); channel++) {
-            FLAC__int32 sample_value = buffer[channel][sample];
-
-            if ((*data->bitsPerSample) == 16) {
-                short pcm_value = static_cast<short>(sample_value);
-                *reinterpret_cast<short*>(data_ptr) = pcm_value;
-                data_ptr += sizeof(short);
-            } else if ((*data->bitsPerSample) == 24) {
-                // Handle 24-bit audio by packing as 3 bytes
-                *reinterpret_cast<unsigned char*>(data_ptr) = static_cast<unsigned char>(sample_value & 0xFF);
-                data_ptr++;
-                *reinterpret_cast<unsigned char*>(data_ptr) = static_cast<unsigned char>((sample_value >> 8) & 0xFF);
-                data_ptr++;
-                *reinterpret_cast<unsigned char*>(data_ptr) = static_cast<unsigned char>((sample_value >> 16) & 0xFF);
-                data_ptr++;
-            } else {
-                // Default to 16-bit for other formats
-                short pcm_value = static_cast<short>(sample_value);
-                *reinterpret_cast<short*>(data_ptr) = pcm_value;
-                data_ptr += sizeof(short);
-            }
-        }
+    // libFLAC has already undone the stereo decorrelation (left/side, mid/side), so
+    // every channel is independent. Samples are stored left-justified in the
+    // smallest PCM container (8-bit WAV samples are unsigned).
+    const unsigned int channels = *data->channels;
+    const unsigned int containerBits = ContainerBits(*data->bitsPerSample);
+    const unsigned int shift = containerBits - *data->bitsPerSample;
+    const unsigned int bytesPerSample = containerBits / 8;
+    const unsigned int frameSize = frame->header.blocksize;
+
+    // Container size and channel count are fixed for the stream, so the kernel is picked once
+    if (!data->interleave) {
+        data->interleave = SampleFormat::GetInterleaveKernel(containerBits, channels);
     }
 
-    // Add the frame data to the buffer
-    data->audioBuffer->insert(data->audioBuffer->end(), frame_data.begin(), frame_data.end());
+    size_t offset = data->audioBuffer->size();
+    data->audioBuffer->resize(offset + static_cast<size_t>(frameSize) * channels * bytesPerSample);
+    data->interleave(buffer, channels, frameSize, shift, data->audioBuffer->data() + offset);
     return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
 }
 
 static void flac_metadata_callback(const FLAC__StreamDecoder *decoder, const FLAC__StreamMetadata *metadata, void *client_data) {
-    if (metadata->type == FLAC__METADATA_TYPE_STREAMINFO) {
-        FlacDecodeData *data = static_cast<FlacDecodeData*>(client_data);
-        if (!data) return;
+    FlacDecodeData *data = static_cast<FlacDecodeData*>(client_data);
+    if (!data) return;
 
+    if (metadata->type == FLAC__METADATA_TYPE_STREAMINFO) {
         *data->totalSamples = metadata->data.stream_info.total_samples;
         *data->sampleRate = metadata->data.stream_info.sample_rate;
         *data->channels = metadata->data.stream_info.channels;
         *data->bitsPerSample = metadata->data.stream_info.bits_per_sample;
+
+        // Reserve the whole stream up front when its length is known
+        data->audioBuffer->reserve(static_cast<size_t>(*data->totalSamples) * *data->channels *
+                                   (ContainerBits(*data->bitsPerSample) / 8));
+    } else if (metadata->type == FLAC__METADATA_TYPE_VORBIS_COMMENT) {
+        // Speakers other than the default assignment for the channel count are
+        // stored as a WAVEFORMATEXTENSIBLE_CHANNEL_MASK=0x... comment
+        static const std::string kMaskField = "WAVEFORMATEXTENSIBLE_CHANNEL_MASK=";
+        const FLAC__StreamMetadata_VorbisComment& comments = metadata->data.vorbis_comment;
+        for (FLAC__uint32 i = 0; i < comments.num_comments; i++) {
+            std::string entry(reinterpret_cast<const char*>(comments.comments[i].entry), comments.comments[i].length);
+            if (entry.size() > kMaskField.size()) {
+                std::string field = entry.substr(0, kMaskField.size());
+                std::transform(field.begin(), field.end(), field.begin(), ::toupper);
+                if (field == kMaskField) {
+                    *data->channelMask = static_cast<uint32_t>(std::strtoul(entry.c_str() + kMaskField.size(), nullptr, 0));
+                }
+            }
+        }
     }
 }
 
@@ -178,10 +1970,9 @@ bool AudioEngine::Initialize(std::unique_ptr<IGPUProcessor> gpuProcessor) {
     return false;
 }
 
-bool AudioEngine::LoadFile(const std::string& filePath) {
-    if (!pImpl->initialized) {
-        return false;
-    }
+bool AudioEngine::Impl::DecodeFile(const std::string& filePath, DecodedTrack& track) {
+    GPU_PLAYER_TRACE_SCOPE("decode", "decode file");
+    track.filePath = filePath;
 
     // Check if file exists first
     std::ifstream file(filePath, std::ios::binary);
@@ -204,16 +1995,25 @@ bool AudioEngine::LoadFile(const std::string& filePath) {
     std::string extension = filePath.substr(filePath.find_last_of(".") + 1);
     std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
 
-    if (extension != "wav" && extension != "mp3" && extension != "flac" && extension != "ogg" && extension != "m4a") {
+    const bool isOgg = extension == "ogg" || extension == "oga" || extension == "opus";
+    const bool isMP4 = extension == "m4a" || extension == "mp4";
+    if (extension != "wav" && extension != "mp3" && extension != "flac" && extension != "dsf" && extension != "dff" &&
+        !isOgg && !isMP4) {
         std::cout << "Warning: Unsupported file format (" << extension << ") - " << filePath << "\n";
-        std::cout << "Supported formats: WAV, MP3, FLAC, OGG, M4A\n";
-        std::cout << "Only WAV format is currently implemented for playback\n";
+        std::cout << "Supported formats: WAV, FLAC, DSF, DFF, MP3, OGG, OPUS, M4A\n";
+        std::cout << "Only WAV, FLAC, DSF, DFF, Ogg Vorbis, Ogg Opus and ALAC in M4A are currently implemented "
+                     "for playback\n";
         // For demo purposes, we'll try to load WAV files, others will use tone generation
         if (extension != "wav") {
             std::cout << "Will generate a tone instead of playing the file\n";
             // Generate a tone to simulate playback for non-WAV files
             const int sampleRate = 44100;
-            const int channels = 2; // Stereo
+            // Stereo, or the output layout when one is set so every speaker can be checked
+            ChannelLayout toneLayout = ChannelLayout::Default(2);
+            if (outputLayoutName != "source") {
+                ChannelLayout::Parse(outputLayoutName, toneLayout);
+            }
+            const int channels = toneLayout.GetChannelCount();
             const int bitsPerSample = 16;
             const int bytesPerSample = bitsPerSample / 8;
             const int frequency = 440; // A4 note
@@ -223,9 +2023,9 @@ bool AudioEngine::LoadFile(const std::string& filePath) {
             int totalBytes = numSamples * channels * bytesPerSample;
 
             // Resize audio data vector
-            pImpl->audioData.resize(totalBytes);
+            track.audioData.resize(totalBytes);
 
-            // Create simple sine wave
+            // Create simple sine wave on every channel
             for (int i = 0; i < numSamples; ++i) {
                 double time = static_cast<double>(i) / sampleRate;
                 double value = std::sin(2.0 * M_PI * frequency * time);
@@ -233,106 +2033,105 @@ bool AudioEngine::LoadFile(const std::string& filePath) {
                 // Convert to 16-bit signed integer
                 short sample = static_cast<short>(value * 32767);
 
-                // Write to audio data (stereo)
                 int offset = i * channels * bytesPerSample;
-                memcpy(&pImpl->audioData[offset], &sample, bytesPerSample);
-                memcpy(&pImpl->audioData[offset + bytesPerSample], &sample, bytesPerSample);
+                for (int channel = 0; channel < channels; ++channel) {
+                    memcpy(&track.audioData[offset + channel * bytesPerSample], &sample, bytesPerSample);
+                }
             }
 
             // Set up wave format for the generated tone
-            pImpl->waveFormat.wFormatTag = WAVE_FORMAT_PCM;
-            pImpl->waveFormat.nChannels = channels;
-            pImpl->waveFormat.nSamplesPerSec = sampleRate;
-            pImpl->waveFormat.nAvgBytesPerSec = sampleRate * channels * bytesPerSample;
-            pImpl->waveFormat.nBlockAlign = channels * bytesPerSample;
-            pImpl->waveFormat.wBitsPerSample = bitsPerSample;
-            pImpl->waveFormat.cbSize = 0;
-
-            pImpl->audioLoaded = true;
-            pImpl->currentFile = filePath;
+            track.format.wFormatTag = WAVE_FORMAT_PCM;
+            track.format.nChannels = channels;
+            track.format.nSamplesPerSec = sampleRate;
+            track.format.nAvgBytesPerSec = sampleRate * channels * bytesPerSample;
+            track.format.nBlockAlign = channels * bytesPerSample;
+            track.format.wBitsPerSample = bitsPerSample;
+            track.format.cbSize = 0;
+            track.layout = toneLayout;
+            track.generated = true;
+
             return true;
         }
     }
 
     if (extension == "wav") {
-        std::ifstream wavFile(filePath, std::ios::binary);
-        if (!wavFile.is_open()) {
-            std::cout << "Error: Could not open WAV file - " << filePath << "\n";
+        WAVEFORMATEX format = {};
+        uint32_t channelMask = 0;
+        std::vector<char> data;
+        if (!ReadWavFile(filePath, format, channelMask, data)) {
             return false;
         }
 
-        // Read WAV header
-        char chunkId[4];
-        wavFile.read(chunkId, 4);
-        if (std::string(chunkId, 4) != "RIFF") {
-            std::cout << "Error: Invalid WAV file format - " << filePath << "\n";
-            wavFile.close();
-            return false;
+        track.audioData.swap(data);
+        track.format = format;
+        track.layout = ChannelLayout::FromMask(channelMask, format.nChannels);
+
+        std::cout << "Successfully loaded WAV file: " << filePath << " (" << track.audioData.size()
+                  << " bytes of audio data, " << track.layout.Describe() << ")\n";
+        return true;
+    }
+    else if (extension == "dsf" || extension == "dff") {
+        WAVEFORMATEX format = {};
+        ChannelLayout layout;
+        std::vector<char> data;
+        std::string conversion;
+        int dsdRate = 0;
+        if (dsdOutputMode == DSDPacker::Mode::PCM) {
+            if (!ReadDSDFile(filePath, dsdOptions, format, layout, data, conversion)) {
+                return false;
+            }
+        } else {
+            // Bit-perfect output: keep the 1-bit data and pack it while playing
+            if (!ReadDSDStream(filePath, DSDPacker::GetBytesPerFrame(dsdOutputMode), format, layout, data, dsdRate)) {
+                return false;
+            }
+            conversion = DSDConverter::GetRateName(dsdRate) + " as " +
+                         (dsdOutputMode == DSDPacker::Mode::DoP ? "DoP" : "native DSD") + " (bit-perfect)";
         }
 
-        // Read the complete file header to get format info
-        wavFile.seekg(20); // Skip to format data
-        short audioFormat;
-        wavFile.read(reinterpret_cast<char*>(&audioFormat), sizeof(audioFormat));
+        track.audioData.swap(data);
+        track.format = format;
+        track.layout = layout;
+        track.conversion = conversion;
+        track.dsdStreamRate = dsdRate;
 
-        if (audioFormat != 1) { // PCM format
-            std::cout << "Error: Only PCM WAV format is supported - " << filePath << "\n";
-            wavFile.close();
+        std::cout << "Successfully loaded DSD file: " << filePath << " (" << track.layout.Describe() << ")\n";
+        return true;
+    }
+    else if (isOgg) {
+        WAVEFORMATEX format = {};
+        ChannelLayout layout;
+        std::vector<char> data;
+        std::string description;
+        if (!ReadOggFile(filePath, format, layout, data, description)) {
             return false;
         }
 
-        short numChannels;
-        wavFile.read(reinterpret_cast<char*>(&numChannels), sizeof(numChannels));
-
-        int sampleRate;
-        wavFile.read(reinterpret_cast<char*>(&sampleRate), sizeof(sampleRate));
-
-        wavFile.seekg(34); // Skip to bits per sample
-        short bitsPerSample;
-        wavFile.read(reinterpret_cast<char*>(&bitsPerSample), sizeof(bitsPerSample));
-
-        // Find data chunk
-        char dataChunk[4];
-        int chunkSize;
-        bool foundData = false;
-        wavFile.seekg(36); // Start looking for data chunk after the format info
-
-        while (wavFile.good()) {
-            wavFile.read(dataChunk, 4);
-            if (!wavFile.good()) break;
-
-            wavFile.read(reinterpret_cast<char*>(&chunkSize), sizeof(chunkSize));
-            if (std::string(dataChunk, 4) == "data") {
-                foundData = true;
-                break;
-            }
-            // Skip this chunk and continue
-            wavFile.seekg(chunkSize, std::ios::cur);
-        }
+        track.audioData.swap(data);
+        track.format = format;
+        track.layout = layout;
+        track.conversion = description + " decoded to 24-bit PCM";
 
-        if (!foundData) {
-            std::cout << "Error: No data chunk found in WAV file - " << filePath << "\n";
-            wavFile.close();
+        std::cout << "Successfully loaded " << description << " file: " << filePath << " ("
+                  << track.format.nSamplesPerSec << "Hz, " << track.layout.Describe() << ")\n";
+        return true;
+    }
+    else if (isMP4) {
+        WAVEFORMATEX format = {};
+        ChannelLayout layout;
+        std::vector<char> data;
+        std::string description;
+        if (!ReadMP4File(filePath, format, layout, data, description)) {
             return false;
         }
 
-        // Read audio data from the data chunk
-        pImpl->audioData.resize(chunkSize);
-        wavFile.read(pImpl->audioData.data(), chunkSize);
-        wavFile.close();
-
-        // Set up wave format based on the actual file
-        pImpl->waveFormat.wFormatTag = WAVE_FORMAT_PCM;
-        pImpl->waveFormat.nChannels = numChannels;
-        pImpl->waveFormat.nSamplesPerSec = sampleRate;
-        pImpl->waveFormat.wBitsPerSample = bitsPerSample;
-        pImpl->waveFormat.nBlockAlign = (numChannels * bitsPerSample) / 8;
-        pImpl->waveFormat.nAvgBytesPerSec = sampleRate * pImpl->waveFormat.nBlockAlign;
-        pImpl->waveFormat.cbSize = 0;
+        track.audioData.swap(data);
+        track.format = format;
+        track.layout = layout;
 
-        pImpl->audioLoaded = true;
-        pImpl->currentFile = filePath;
-        std::cout << "Successfully loaded WAV file: " << filePath << " (" << chunkSize << " bytes of audio data)\n";
+        std::cout << "Successfully loaded " << description << " file: " << filePath << " ("
+                  << track.format.nSamplesPerSec << "Hz, " << track.format.wBitsPerSample << "-bit, "
+                  << track.layout.Describe() << ")\n";
         return true;
     }
     else if (extension == "flac") {
@@ -348,18 +2147,23 @@ bool AudioEngine::LoadFile(const std::string& filePath) {
 
         // Prepare data structure to pass to callbacks
         FlacDecodeData decodeData;
-        decodeData.audioBuffer = &pImpl->flacBuffer;
-        decodeData.sampleRate = &pImpl->flacSampleRate;
-        decodeData.channels = &pImpl->flacChannels;
-        decodeData.bitsPerSample = &pImpl->flacBitsPerSample;
-        decodeData.totalSamples = &pImpl->flacTotalSamples;
+        decodeData.audioBuffer = &flacBuffer;
+        decodeData.sampleRate = &flacSampleRate;
+        decodeData.channels = &flacChannels;
+        decodeData.bitsPerSample = &flacBitsPerSample;
+        decodeData.channelMask = &flacChannelMask;
+        decodeData.totalSamples = &flacTotalSamples;
 
         // Reset values
-        pImpl->flacSampleRate = 0;
-        pImpl->flacChannels = 0;
-        pImpl->flacBitsPerSample = 0;
-        pImpl->flacTotalSamples = 0;
-        pImpl->flacBuffer.clear();
+        flacSampleRate = 0;
+        flacChannels = 0;
+        flacBitsPerSample = 0;
+        flacChannelMask = 0;
+        flacTotalSamples = 0;
+        flacBuffer.clear();
+
+        // The channel mask comment describes non-default speaker assignments
+        FLAC__stream_decoder_set_metadata_respond(decoder, FLAC__METADATA_TYPE_VORBIS_COMMENT);
 
         // Initialize the decoder with the file
         FLAC__StreamDecoderInitStatus init_status = FLAC__stream_decoder_init_file(
@@ -392,10 +2196,10 @@ bool AudioEngine::LoadFile(const std::string& filePath) {
         FLAC__stream_decoder_delete(decoder);
 
         // Copy decoded data to main audio buffer with bounds checking
-        if (!pImpl->flacBuffer.empty()) {
+        if (!flacBuffer.empty()) {
             try {
-                pImpl->audioData.resize(pImpl->flacBuffer.size());
-                std::copy(pImpl->flacBuffer.begin(), pImpl->flacBuffer.end(), pImpl->audioData.begin());
+                track.audioData.resize(flacBuffer.size());
+                std::copy(flacBuffer.begin(), flacBuffer.end(), track.audioData.begin());
             } catch (const std::exception& e) {
                 std::cout << "Error: Could not copy decoded audio data: " << e.what() << "\n";
                 return false;
@@ -403,21 +2207,20 @@ bool AudioEngine::LoadFile(const std::string& filePath) {
         }
 
         // Set up wave format for the decoded audio
-        pImpl->waveFormat.wFormatTag = WAVE_FORMAT_PCM;
-        pImpl->waveFormat.nChannels = pImpl->flacChannels;
-        pImpl->waveFormat.nSamplesPerSec = pImpl->flacSampleRate;
-        pImpl->waveFormat.wBitsPerSample = pImpl->flacBitsPerSample;
-        pImpl->waveFormat.nBlockAlign = (pImpl->flacChannels * pImpl->flacBitsPerSample) / 8;
-        pImpl->waveFormat.nAvgBytesPerSec = pImpl->flacSampleRate * pImpl->waveFormat.nBlockAlign;
-        pImpl->waveFormat.cbSize = 0;
+        track.format.wFormatTag = WAVE_FORMAT_PCM;
+        track.format.nChannels = flacChannels;
+        track.format.nSamplesPerSec = flacSampleRate;
+        track.format.wBitsPerSample = ContainerBits(flacBitsPerSample);
+        track.format.nBlockAlign = (flacChannels * track.format.wBitsPerSample) / 8;
+        track.format.nAvgBytesPerSec = flacSampleRate * track.format.nBlockAlign;
+        track.format.cbSize = 0;
+        track.layout = ChannelLayout::FromMask(flacChannelMask, flacChannels);
 
-        pImpl->audioLoaded = true;
-        pImpl->currentFile = filePath;
 
         std::cout << "FLAC file decoded successfully: " << filePath << "\n";
-        std::cout << "Format: " << pImpl->flacSampleRate << "Hz, "
-                  << pImpl->flacChannels << " channels, "
-                  << pImpl->flacBitsPerSample << " bits\n";
+        std::cout << "Format: " << flacSampleRate << "Hz, "
+                  << track.layout.Describe() << ", "
+                  << flacBitsPerSample << " bits\n";
 
         return true;
 #else
@@ -433,6 +2236,22 @@ bool AudioEngine::LoadFile(const std::string& filePath) {
     }
 }
 
+bool AudioEngine::LoadFile(const std::string& filePath) {
+    if (!pImpl->initialized) {
+        return false;
+    }
+
+    DecodedTrack track;
+    if (!pImpl->DecodeFile(filePath, track)) {
+        return false;
+    }
+    if (pImpl->InstallTrack(track)) {
+        // Playback stopped to reopen the device in the new format
+        return Play();
+    }
+    return true;
+}
+
 bool AudioEngine::Play() {
     if (!pImpl->initialized) {
         return false;
@@ -450,112 +2269,258 @@ bool AudioEngine::Play() {
         return false;
     }
 
-    // If already playing, stop current playback first
-    if (pImpl->isPlaying) {
-        std::cout << "Stopping previous playback first...\n";
-        // Send stop signal to any existing thread
-        pImpl->shouldStop = true;
-
-        // Join any existing playback thread if it exists
-        if (pImpl->playbackThread.joinable()) {
-            pImpl->playbackThread.join();
-        }
+    // An output layout chosen during the previous playback applies once that playback has stopped
+    if (pImpl->outputLayoutPending) {
+        pImpl->StopPlaybackThread();
+        pImpl->outputLayoutPending = false;
+        pImpl->RebuildOutputMixer();
+        pImpl->RestartAnalysis();
     }
 
-    // Start a new playback thread to avoid blocking the command interface
-    pImpl->shouldStop = false;
-    pImpl->playbackThread = std::thread([this]() {
-        std::cout << "Playing audio: Actual playback started\n";
+    // A running playback thread is told to stop at its next block boundary. The new thread
+    // waits for it to exit before it takes over, so the command interface is not blocked.
+    // The lock covers only the handoff: the previous thread takes it on its way out
+    std::unique_lock<std::mutex> lock(pImpl->audioEngineMutex);
+    std::thread previous = std::move(pImpl->playbackThread);
+    ControlCommand stop;
+    stop.type = ControlCommand::Type::Stop;
+    stop.generation = pImpl->playbackGeneration;
+    pImpl->PushCommand(stop);
+
+    const uint64_t generation = ++pImpl->playbackGeneration;
+    pImpl->isPaused.store(false);
+    pImpl->isPlaying.store(true);
+    pImpl->acceptingCommands.store(true);
+    const bool realtime = pImpl->realtimeSettings.enabled;
+    pImpl->playbackThread = std::thread([this, realtime, generation, previous = std::move(previous)]() mutable {
+        // However the thread exits, playback goes back to the control thread unless a newer thread took over
+        bool finished = false;
+        struct Finisher {
+            Impl* impl;
+            uint64_t generation;
+            const bool& finished;
+            ~Finisher() { impl->FinishPlaybackThread(generation, finished); }
+        } finisher{pImpl.get(), generation, finished};
+
+        if (previous.joinable()) {
+            previous.join();
+        }
+        // Commands taken by the previous thread may have paused it
+        pImpl->isPaused.store(false);
+        pImpl->outputBuffering.Start(pImpl->bufferSettings, static_cast<int>(pImpl->deviceFormat.nSamplesPerSec));
 
-#ifdef _WIN32
-        // Initialize the audio output device
-        MMRESULT result = waveOutOpen(&pImpl->hWaveOut, WAVE_MAPPER, &pImpl->waveFormat, 0, 0, CALLBACK_NULL);
-        if (result != MMSYSERR_NOERROR) {
-            std::cout << "Error: Could not open audio output device\n";
-            return;
+        if (realtime) {
+            RealtimeThread::PrefaultStack();
         }
+        GPU_PLAYER_TRACE_THREAD("playback");
+        GPU_PLAYER_LOG(Playback, Info, "Playing audio: Actual playback started");
 
-        // Prepare the audio buffer header
-        pImpl->waveHeader.lpData = pImpl->audioData.data() + pImpl->playbackPosition; // Start from current position
-        size_t remainingDataSize = pImpl->audioData.size() - pImpl->playbackPosition;
-        pImpl->waveHeader.dwBufferLength = remainingDataSize;
-        pImpl->waveHeader.dwFlags = 0;
-        pImpl->waveHeader.dwUser = 0;
+        OutputBuffering& buffering = pImpl->outputBuffering;
+        const size_t periodBytes = buffering.GetPeriodFrames() * std::max<size_t>(pImpl->deviceFormat.nBlockAlign, 1);
+        bool stopped = false;
 
-        result = waveOutPrepareHeader(pImpl->hWaveOut, &pImpl->waveHeader, sizeof(WAVEHDR));
-        if (result != MMSYSERR_NOERROR) {
-            std::cout << "Error: Could not prepare audio header\n";
-            waveOutClose(pImpl->hWaveOut);
-            return;
+#ifdef _WIN32
+        // More than two channels or more than 16 bits need WAVE_FORMAT_EXTENSIBLE with a speaker mask
+        static const GUID kSubtypePcm = {0x00000001, 0x0000, 0x0010, {0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71}};
+        WAVEFORMATEXTENSIBLE deviceWaveFormat = {};
+        deviceWaveFormat.Format = pImpl->deviceFormat;
+        if (pImpl->deviceFormat.nChannels > 2 || pImpl->deviceFormat.wBitsPerSample > 16) {
+            deviceWaveFormat.Format.wFormatTag = WAVE_FORMAT_EXTENSIBLE;
+            deviceWaveFormat.Format.cbSize = sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX);
+            // DoP is 24-bit PCM carried in 32-bit samples
+            deviceWaveFormat.Samples.wValidBitsPerSample = pImpl->dsdStreamRate > 0 ? 24 : pImpl->deviceFormat.wBitsPerSample;
+            deviceWaveFormat.dwChannelMask = pImpl->deviceLayout.GetMask();
+            deviceWaveFormat.SubFormat = kSubtypePcm;
         }
 
-        // Write the audio data to the device
-        result = waveOutWrite(pImpl->hWaveOut, &pImpl->waveHeader, sizeof(WAVEHDR));
+        // Initialize the audio output device
+        // The device signals the playback event whenever it finishes a buffer, and so does every
+        // posted command, so the thread sleeps until there is work
+        MMRESULT result = waveOutOpen(&pImpl->hWaveOut, WAVE_MAPPER, &deviceWaveFormat.Format,
+                                      reinterpret_cast<DWORD_PTR>(pImpl->playbackEvent), 0, CALLBACK_EVENT);
         if (result != MMSYSERR_NOERROR) {
-            std::cout << "Error: Could not write audio data\n";
-            waveOutUnprepareHeader(pImpl->hWaveOut, &pImpl->waveHeader, sizeof(WAVEHDR));
-            waveOutClose(pImpl->hWaveOut);
+            GPU_PLAYER_LOG(Device, Error, "Could not open audio output device");
             return;
         }
 
-        // Track playback time and handle pause/stop
-        while (!(pImpl->waveHeader.dwFlags & WHDR_DONE)) {
-            // Check if we should pause playback
+        // Stream through a ring of device buffers so the DSP chain runs period by period
+        // on this thread, starting from the current position. There is a buffer for the
+        // longest queue adaptive buffering can grow to
+        for (size_t i = 0; i < OutputBuffering::kMaxPeriodCount; i++) {
+            pImpl->deviceBuffers[i].resize(periodBytes);
+            pImpl->waveHeaders[i] = {};
+        }
+        auto releaseHeaders = [this]() {
+            for (size_t i = 0; i < OutputBuffering::kMaxPeriodCount; i++) {
+                if (pImpl->waveHeaders[i].dwFlags & WHDR_PREPARED) {
+                    waveOutUnprepareHeader(pImpl->hWaveOut, &pImpl->waveHeaders[i], sizeof(WAVEHDR));
+                }
+            }
+        };
+
+        bool endOfData = false;
+        bool primed = false;
+        while (true) {
+            // Control commands take effect between periods
+            const bool wasPaused = pImpl->isPaused.load();
+            bool flush = false;
+            if (pImpl->ApplyControlCommands(generation, flush)) {
+                stopped = true;
+                break;
+            }
+            if (flush) {
+                // Drop what the device still has queued from before a seek (marks every buffer done)
+                waveOutReset(pImpl->hWaveOut);
+                endOfData = false;
+                primed = false;
+            }
+            if (pImpl->isPaused.load() != wasPaused) {
+                MMRESULT pauseResult = pImpl->isPaused.load() ? waveOutPause(pImpl->hWaveOut) : waveOutRestart(pImpl->hWaveOut);
+                if (pauseResult != MMSYSERR_NOERROR) {
+                    GPU_PLAYER_LOG(Device, Warning, "Could not pause or resume audio output");
+                }
+            }
             if (pImpl->isPaused.load()) {
-                // Give more control to pause
-                Sleep(50); // Longer sleep while paused to reduce CPU usage
-                continue;  // Stay in the loop while paused
+                // A paused device finishes no buffers, so only a command wakes the thread
+                WaitForSingleObject(pImpl->playbackEvent, INFINITE);
+                continue;
             }
 
-            // Check if we should stop playback early
-            if (pImpl->shouldStop.load()) {
-                std::cout << "Playback stopped by user request\n";
-                waveOutReset(pImpl->hWaveOut);
-                waveOutUnprepareHeader(pImpl->hWaveOut, &pImpl->waveHeader, sizeof(WAVEHDR));
-                waveOutClose(pImpl->hWaveOut);
-                pImpl->hWaveOut = nullptr;
+            // The device ran dry if it finished every queued buffer before the end of the data
+            size_t queued = 0;
+            for (size_t i = 0; i < OutputBuffering::kMaxPeriodCount; i++) {
+                const DWORD flags = pImpl->waveHeaders[i].dwFlags;
+                if ((flags & WHDR_PREPARED) && !(flags & WHDR_DONE)) {
+                    queued++;
+                }
+            }
+            if (primed && queued == 0 && !endOfData) {
+                buffering.OnUnderrun();
+            }
+
+            // Refill finished buffers up to the current queue depth
+            const size_t periods = buffering.GetPeriodCount();
+            for (size_t i = 0; i < OutputBuffering::kMaxPeriodCount && queued < periods && !endOfData; i++) {
+                WAVEHDR& header = pImpl->waveHeaders[i];
+                if ((header.dwFlags & WHDR_PREPARED) && !(header.dwFlags & WHDR_DONE)) {
+                    continue;
+                }
+                if (header.dwFlags & WHDR_PREPARED) {
+                    waveOutUnprepareHeader(pImpl->hWaveOut, &header, sizeof(WAVEHDR));
+                }
+
+                size_t bytes = pImpl->RenderPeriod(pImpl->deviceBuffers[i].data(), periodBytes);
+                if (bytes == 0) {
+                    endOfData = true;
+                    break;
+                }
 
-                // Use atomic operation
-                pImpl->isPlaying.store(false);
-                return;
+                GPU_PLAYER_TRACE_SCOPE("device", "device write");
+                header = {};
+                header.lpData = pImpl->deviceBuffers[i].data();
+                header.dwBufferLength = static_cast<DWORD>(bytes);
+                if (waveOutPrepareHeader(pImpl->hWaveOut, &header, sizeof(WAVEHDR)) != MMSYSERR_NOERROR ||
+                    waveOutWrite(pImpl->hWaveOut, &header, sizeof(WAVEHDR)) != MMSYSERR_NOERROR) {
+                    GPU_PLAYER_LOG(Device, Error, "Could not write audio data");
+                    endOfData = true;
+                    break;
+                }
+                queued++;
+                buffering.OnPeriodQueued();
             }
-            Sleep(10); // Brief sleep to allow other threads and commands to run
-        }
+            primed = true;
 
-        // Cleanup - only if not stopped externally
-        if (!pImpl->shouldStop.load()) {
-            waveOutUnprepareHeader(pImpl->hWaveOut, &pImpl->waveHeader, sizeof(WAVEHDR));
-            waveOutClose(pImpl->hWaveOut);
-            pImpl->hWaveOut = nullptr;
+            if (endOfData && queued == 0) {
+                break;
+            }
+            // Wake up when a buffer is done or a command is posted
+            GPU_PLAYER_TRACE_SCOPE("device", "device wait");
+            WaitForSingleObject(pImpl->playbackEvent, INFINITE);
         }
 
-        if (!pImpl->shouldStop.load()) {
-            std::cout << "Playback finished\n";
+        if (stopped) {
+            waveOutReset(pImpl->hWaveOut);
         }
+        releaseHeaders();
+        waveOutClose(pImpl->hWaveOut);
+        pImpl->hWaveOut = nullptr;
 #else
-        // For non-Windows platforms, simulate playback with sleep
-        std::cout << "Playing audio: Simulating playback for 5 seconds...\n";
-        for (int i = 0; i < 50 && !pImpl->shouldStop.load(); ++i) {  // 50 iterations with 100ms each = 5 sec
-            if (!pImpl->isPaused.load()) {
-                // Only advance time if not paused
-                pImpl->playbackTime += 0.1;
+        // No audio device on this platform yet: render through the DSP chain at real-time pace
+        // into a simulated device that plays the queued periods back to back. Times are absolute,
+        // so render time and wake-up latency do not add up, and running out of queued audio
+        // counts as an underrun as it would on a real device
+        using Clock = std::chrono::steady_clock;
+        auto toDuration = [](double seconds) {
+            return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+        };
+        const double bytesPerSecond = std::max<double>(pImpl->deviceFormat.nAvgBytesPerSec, 1.0);
+        const Clock::duration period = toDuration(periodBytes / bytesPerSecond);
+        std::vector<char> deviceBuffer(periodBytes);
+        bool endOfData = false;
+        bool primed = false;
+        Clock::time_point queueEnd = Clock::now();   // When the queued audio runs out
+        while (true) {
+            // Control commands take effect between periods
+            bool flush = false;
+            if (pImpl->ApplyControlCommands(generation, flush)) {
+                stopped = true;
+                break;
+            }
+            if (flush) {
+                // Drop what the device still has queued from before a seek
+                endOfData = false;
+                primed = false;
+            }
+            if (pImpl->isPaused.load()) {
+                primed = false;
+                pImpl->WaitForCommand(nullptr);
+                continue;
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
 
-        if (pImpl->shouldStop.load()) {
-            std::cout << "Playback stopped by user request\n";
-        } else {
-            std::cout << "Playback finished\n";
+            const Clock::time_point now = Clock::now();
+            if (primed && now > queueEnd && !endOfData) {
+                buffering.OnUnderrun();
+            }
+            if (!primed || (now > queueEnd && !endOfData)) {
+                queueEnd = now;
+            }
+
+            // Top the queue up to the current depth
+            while (!endOfData && queueEnd - now < period * static_cast<int>(buffering.GetPeriodCount())) {
+                size_t bytes = pImpl->RenderPeriod(deviceBuffer.data(), deviceBuffer.size());
+                if (bytes == 0) {
+                    endOfData = true;
+                    break;
+                }
+                queueEnd += toDuration(bytes / bytesPerSecond);
+                buffering.OnPeriodQueued();
+            }
+            primed = true;
+
+            // At the end of the data, the device plays what is still queued
+            if (endOfData && Clock::now() >= queueEnd) {
+                break;
+            }
+
+            // Wake up when the device has played one period (or all of it at the end), or for a command
+            const Clock::time_point wakeUp = endOfData ? queueEnd :
+                queueEnd - period * static_cast<int>(buffering.GetPeriodCount() - 1);
+            GPU_PLAYER_TRACE_SCOPE("device", "device wait");
+            pImpl->WaitForCommand(&wakeUp);
         }
 #endif
-        // Reset playing state when done with atomic operations
-        pImpl->isPlaying.store(false);
-        pImpl->isPaused.store(false);
-        pImpl->playbackTime = 0.0;  // Reset playback time when done
+        if (stopped) {
+            GPU_PLAYER_LOG(Playback, Info, "Playback stopped by user request");
+            return;
+        }
+        GPU_PLAYER_LOG(Playback, Info, "Playback finished");
+        finished = true;
     });
+    lock.unlock();
 
-    pImpl->isPlaying.store(true);  // Use atomic operation
+    // Neither waits for the playback thread, so the handoff above is not held up
+    pImpl->ApplyRealtime();
+    pImpl->FollowRenderState();
     std::cout << "Starting playback of " << pImpl->currentFile << " (background)\n";
     return true;
 }
@@ -565,38 +2530,12 @@ bool AudioEngine::Pause() {
         return false;
     }
 
-    // Use mutex to protect state changes
-    std::lock_guard<std::mutex> lock(pImpl->audioEngineMutex);
-
-    if (pImpl->isPlaying.load()) {
-        bool currentPaused = pImpl->isPaused.load();  // Atomic read
-        pImpl->isPaused.store(!currentPaused);        // Toggle with atomic write
-
-        if (currentPaused) {
-            std::cout << "Playback resumed\n";
-
-#ifdef _WIN32
-            // Actually resume the audio output device
-            if (pImpl->hWaveOut) {
-                MMRESULT result = waveOutRestart(pImpl->hWaveOut);
-                if (result != MMSYSERR_NOERROR) {
-                    std::cout << "Warning: Could not resume audio output\n";
-                }
-#endif
-            }
-        } else {
-            std::cout << "Playback paused\n";
-
-#ifdef _WIN32
-            // Actually pause the audio output device if we have it
-            if (pImpl->hWaveOut) {
-                MMRESULT result = waveOutPause(pImpl->hWaveOut);
-                if (result != MMSYSERR_NOERROR) {
-                    std::cout << "Warning: Could not pause audio output\n";
-                }
-#endif
-            }
-        }
+    // The playback thread pauses or resumes the device at its next block boundary
+    ControlCommand command;
+    bool resume = pImpl->isPaused.load();
+    command.type = resume ? ControlCommand::Type::Resume : ControlCommand::Type::Pause;
+    if (pImpl->PostCommand(command)) {
+        std::cout << (resume ? "Playback resumed\n" : "Playback paused\n");
     } else {
         std::cout << "No playback active to pause/resume\n";
     }
@@ -608,9 +2547,9 @@ bool AudioEngine::Stop() {
         return false;
     }
 
-    // Check current state before acquiring lock
-    bool wasPlaying = pImpl->isPlaying.load();  // Use atomic access
-    bool wasPaused = pImpl->isPaused.load();    // Use atomic access
+    // The playback thread stops at its next block boundary and exits
+    bool wasPaused = pImpl->isPaused.load();
+    bool wasPlaying = pImpl->StopPlaybackThread();
 
     // Save the current playback position for potential resumption later
     if (wasPlaying || wasPaused) {
@@ -619,24 +2558,13 @@ bool AudioEngine::Stop() {
         pImpl->hasSavedPosition = true;
     }
 
-    // Signal the playback thread to stop
-    pImpl->shouldStop = true;
-
-    // If there's an active playback thread, join it
-    if (pImpl->playbackThread.joinable()) {
-        // Wait for the thread to finish if it's joinable
-        pImpl->playbackThread.join();
-    }
-
-#ifdef _WIN32
-    // Stop the audio output device if it's open
-    if (pImpl->hWaveOut != nullptr) {
-        waveOutReset(pImpl->hWaveOut);  // Immediately stop any playback
-        waveOutUnprepareHeader(pImpl->hWaveOut, &pImpl->waveHeader, sizeof(WAVEHDR));
-        waveOutClose(pImpl->hWaveOut);
-        pImpl->hWaveOut = nullptr;
+    // The playback thread closes the audio output device itself on its way out, and no
+    // longer renders. Drop filter tails so a restart does not replay stale output
+    pImpl->dspChain.Reset();
+    if (pImpl->timeStretcher) {
+        pImpl->timeStretcher->Reset();
+        pImpl->stretchTailFrames = 0;
     }
-#endif
 
     // Use atomic operations to reset states
     pImpl->isPlaying.store(false);
@@ -691,30 +2619,33 @@ bool AudioEngine::Seek(double seconds) {
         newPosition = static_cast<size_t>(seconds * kDefaultBytesPerSec);
     }
 
-    if (newPosition >= pImpl->audioData.size()) {
+    // Keep the position on a frame boundary
+    if (pImpl->waveFormat.nBlockAlign > 0) {
+        newPosition -= newPosition % pImpl->waveFormat.nBlockAlign;
+    }
+
+    // The playback thread may have switched to the queued track
+    if (newPosition >= pImpl->FollowRenderState().trackBytes) {
         std::cout << "Error: Requested position exceeds file length\n";
         return false;
     }
 
-    // If not playing, just update the playback position for when playback starts
-    if (!pImpl->isPlaying.load()) {
-        pImpl->playbackPosition = newPosition;
-        pImpl->playbackTime = seconds;
-        std::cout << "Seek position set to " << seconds << " seconds. Playback will start from this position.\n";
+    // While playing, the playback thread moves to the new position at its next block boundary
+    ControlCommand command;
+    command.type = ControlCommand::Type::Seek;
+    command.position = newPosition;
+    command.seconds = seconds;
+    if (pImpl->PostCommand(command)) {
+        std::cout << "Seek operation: Position adjusted to " << seconds << " seconds in current playback\n";
         return true;
     }
 
-    // If actively playing, update the position for future playback
-    // For true real-time seeking, we would need to properly interrupt and restart the playback thread
-    std::cout << "Seeking to " << seconds << " seconds in current playback\n";
-
-    // Store the new position for the next playback cycle
+    // Not playing: update the position for when playback starts. Filter state from
+    // the old position must not bleed into the new one
+    pImpl->dspChain.Reset();
     pImpl->playbackPosition = newPosition;
     pImpl->playbackTime = seconds;
-
-    std::cout << "Seek operation: Position adjusted to " << seconds << " seconds\n";
-    std::cout << "Seek completed. New position will be used in next playback operation.\n";
-
+    std::cout << "Seek position set to " << seconds << " seconds. Playback will start from this position.\n";
     return true;
 }
 
@@ -762,16 +2693,23 @@ bool AudioEngine::SetEQ(double freq1, double gain1, double q1,
         return false;
     }
 
-    // In a real implementation, this would set EQ parameters with GPU acceleration
     std::cout << "Setting EQ parameters:\n";
     std::cout << "  Low band: F=" << freq1 << "Hz, G=" << gain1 << "dB, Q=" << q1 << "\n";
     std::cout << "  High band: F=" << freq2 << "Hz, G=" << gain2 << "dB, Q=" << q2 << "\n";
 
-    if (pImpl->gpuProcessor) {
-        // Use GPU processor for EQ if available
-        std::cout << "Applying EQ settings with GPU acceleration\n";
+    const EqualizerStage::Band previousLow = pImpl->eqLow;
+    const EqualizerStage::Band previousHigh = pImpl->eqHigh;
+    pImpl->eqLow = {freq1, gain1, q1};
+    pImpl->eqHigh = {freq2, gain2, q2};
+    if (!pImpl->RebuildEqualizerStage()) {
+        std::cout << "Error: Could not set up the equalizer for this stream\n";
+        pImpl->eqLow = previousLow;
+        pImpl->eqHigh = previousHigh;
+        return false;
+    }
+    if (gain1 == 0.0 && gain2 == 0.0) {
+        std::cout << "Both bands are flat; the equalizer is bypassed\n";
     }
-
     return true;
 }
 
@@ -780,211 +2718,589 @@ std::string AudioEngine::GetStats() {
         return "Audio engine not initialized";
     }
 
-    // In a real implementation, this would return detailed performance stats
-    return "Performance statistics:\n"
-            "- CPU usage: 2-4%\n"
-            "- GPU usage: 15-25%\n"
-            "- Memory usage: 60-80MB\n"
-            "- Latency: 2-4ms\n";
+    // The rest of the render state is read from the playback thread's snapshot
+    const RenderSnapshot render = pImpl->FollowRenderState();
+
+    std::ostringstream stats;
+    stats << std::fixed << std::setprecision(1);
+    stats << "Performance statistics:\n";
+
+    switch (GetPlaybackState()) {
+        case PlaybackState::Playing: stats << "- State: playing"; break;
+        case PlaybackState::Paused:  stats << "- State: paused"; break;
+        default:                     stats << "- State: stopped"; break;
+    }
+    stats << " at " << GetCurrentPosition() << "s\n";
+
+    if (pImpl->audioLoaded && pImpl->waveFormat.nSamplesPerSec > 0) {
+        const WAVEFORMATEX& format = pImpl->waveFormat;
+        if (pImpl->dsdStreamRate > 0) {
+            stats << "- Stream: " << DSDConverter::GetRateName(pImpl->dsdStreamRate) << " ("
+                  << pImpl->dsdStreamRate << "Hz 1-bit), " << pImpl->sourceLayout.Describe() << "\n";
+        } else {
+            stats << "- Stream: " << format.nSamplesPerSec << "Hz, " << format.wBitsPerSample << "-bit, "
+                  << pImpl->sourceLayout.Describe() << "\n";
+        }
+        if (!pImpl->sourceConversion.empty()) {
+            stats << "- Source: " << pImpl->sourceConversion << "\n";
+        }
+        if (!pImpl->outputMixer.IsIdentity()) {
+            stats << "- Output: " << pImpl->outputMixer.GetName() << "\n";
+        }
+        if (pImpl->timeStretcher) {
+            stats << "- Time stretch: " << pImpl->timeStretcher->GetName() << ", ~"
+                  << static_cast<int>(pImpl->timeStretcher->GetOperationsPerFrame()) << " ops/frame/channel\n";
+        }
+        if (pImpl->streamMixer.GetActiveVoiceCount() > 0) {
+            stats << "- Streams: " << pImpl->streamMixer.GetActiveVoiceCount() << " playing ("
+                  << pImpl->streamMixer.GetMixedVoiceCount() << " mixed)\n";
+        }
+        if (pImpl->realtimeSettings.enabled && !pImpl->realtimeScheduling.empty()) {
+            stats << "- Playback thread: " << pImpl->realtimeScheduling << ", " << pImpl->realtimeAffinity << "\n";
+        }
+        stats << "- Output buffering: " << pImpl->outputBuffering.Describe() << "\n";
+        stats << "- DSP load: " << 100.0f * pImpl->dspLoadAverage.load() << "% average, "
+              << 100.0f * pImpl->dspLoadPeak.load() << "% peak\n";
+    }
+
+    LevelSnapshot levels;
+    if (pImpl->analysisTap.IsRunning() && pImpl->analysisTap.GetLevels(levels) && levels.channels > 0) {
+        stats << "- Levels (peak/RMS dBFS):";
+        for (int ch = 0; ch < levels.channels; ch++) {
+            stats << " " << 20.0f * std::log10(std::max(levels.peak[ch], 1e-7f)) << "/"
+                  << 20.0f * std::log10(std::max(levels.rms[ch], 1e-7f));
+        }
+        stats << "\n";
+        if (levels.framesDropped > 0) {
+            stats << "- Analysis frames dropped: " << levels.framesDropped << "\n";
+        }
+    }
+
+    if (pImpl->gpuProcessor) {
+        std::string gpuInfo = pImpl->gpuProcessor->GetGPUInfo();
+        stats << "- GPU: " << gpuInfo.substr(0, gpuInfo.find('\n')) << "\n";
+    }
+
+    if (render.trackQueued && !pImpl->queuedFile.empty()) {
+        stats << "- Next: " << pImpl->queuedFile;
+        if (render.crossfadeFrames > 0) {
+            stats << " (" << static_cast<double>(render.crossfadeFrames) / pImpl->waveFormat.nSamplesPerSec
+                  << "s crossfade)\n";
+        } else {
+            stats << " (gapless)\n";
+        }
+        if (!pImpl->queuedConversion.empty()) {
+            stats << "  " << pImpl->queuedConversion << "\n";
+        }
+    }
+    // Stages are only swapped while the control thread waits, so it can read the chain
+    if (pImpl->audioLoaded && pImpl->dsdStreamRate > 0) {
+        stats << "- DSP chain: bypassed (DSD output)\n";
+    } else if (pImpl->audioLoaded && pImpl->dspChain.IsEmpty() && !pImpl->outputMixer.IsIdentity()) {
+        stats << "- DSP chain: bypassed (output is mixed, not bit-perfect)\n";
+    } else {
+        stats << pImpl->dspChain.Describe();
+    }
+    return stats.str();
+}
+
+void AudioEngine::SetAnalysisEnabled(bool enabled) {
+    pImpl->analysisEnabled.store(enabled);
+    pImpl->RestartAnalysis();
 }
 
-bool AudioEngine::SetTargetBitrate(int targetBitrate) {
+bool AudioEngine::GetLevels(LevelSnapshot& levels) const {
+    if (!pImpl->initialized || !pImpl->analysisTap.IsRunning()) {
+        return false;
+    }
+    return pImpl->analysisTap.GetLevels(levels);
+}
+
+bool AudioEngine::GetSpectrum(SpectrumSnapshot& spectrum) const {
+    if (!pImpl->initialized || !pImpl->analysisTap.IsRunning()) {
+        return false;
+    }
+    return pImpl->analysisTap.GetSpectrum(spectrum);
+}
+
+bool AudioEngine::SetOutputLayout(const std::string& layout) {
     if (!pImpl->initialized) {
         return false;
     }
 
-    // Get currently loaded audio data
-    if (pImpl->audioData.empty()) {
-        std::cout << "No audio data loaded for bitrate conversion\n";
+    ChannelLayout parsed;
+    if (layout != "source" && !ChannelLayout::Parse(layout, parsed)) {
+        std::cout << "Error: Unknown speaker layout '" << layout << "' (known: source, "
+                  << ChannelLayout::GetKnownNames() << ", or a channel count)\n";
         return false;
     }
 
-    // Determine the current bitrate based on file format parameters
-    // Calculate actual bitrate from format information
-    int estimatedInputBitrate;
-    if (pImpl->waveFormat.nAvgBytesPerSec > 0) {
-        // Calculate from format parameters: bytes per sec * 8 bits / 1000 = kbps
-        estimatedInputBitrate = (pImpl->waveFormat.nAvgBytesPerSec * 8) / 1000;
+    pImpl->outputLayoutName = layout;
+    if (!pImpl->audioLoaded) {
+        std::cout << "Output layout set to " << layout << "\n";
+        return true;
+    }
+    if (pImpl->isPlaying.load()) {
+        // The device is open with the current format
+        pImpl->outputLayoutPending = true;
+        std::cout << "Output layout set to " << layout << "; applies when playback restarts\n";
+        return true;
+    }
+
+    pImpl->outputLayoutPending = false;
+    pImpl->RebuildOutputMixer();
+    pImpl->RestartAnalysis();
+    std::cout << "Output layout: " << pImpl->deviceLayout.Describe()
+              << (pImpl->outputMixer.IsIdentity() ? "" : " (" + pImpl->outputMixer.GetName() + ")") << "\n";
+    return true;
+}
+
+bool AudioEngine::SetDSDConversion(const std::string& quality, int pcmRate) {
+    DSDConverter::Quality parsed;
+    if (!DSDConverter::ParseQuality(quality, parsed)) {
+        std::cout << "Error: Unknown DSD conversion quality '" << quality << "' (known: fast, standard, high)\n";
+        return false;
+    }
+    if (pcmRate < 0) {
+        std::cout << "Error: Invalid PCM rate " << pcmRate << "\n";
+        return false;
+    }
+
+    pImpl->dsdOptions.quality = parsed;
+    pImpl->dsdOptions.outputRate = pcmRate;
+    std::cout << "DSD conversion: " << quality << " quality, "
+              << (pcmRate > 0 ? std::to_string(pcmRate) + "Hz" : std::string("4x base rate")) << " PCM"
+              << " (applies to the next DSD file loaded)\n";
+    return true;
+}
+
+bool AudioEngine::SetDSDOutput(const std::string& mode) {
+    DSDPacker::Mode parsed;
+    if (!DSDPacker::ParseMode(mode, parsed)) {
+        std::cout << "Error: Unknown DSD output mode '" << mode << "' (known: pcm, dop, native)\n";
+        return false;
+    }
+#ifdef _WIN32
+    if (parsed == DSDPacker::Mode::Native) {
+        std::cout << "Error: Native DSD output needs an ASIO driver; waveOut devices take DSD as DoP\n";
+        return false;
+    }
+#endif
+
+    pImpl->dsdOutputMode = parsed;
+    std::cout << "DSD output: " << (parsed == DSDPacker::Mode::PCM ? "converted to PCM" :
+                                    parsed == DSDPacker::Mode::DoP ? "DoP (DSD over 24-bit PCM)" : "native DSD")
+              << " (applies to the next DSD file loaded)\n";
+    return true;
+}
+
+bool AudioEngine::SetVolume(double gainDb, double rampSeconds, double atSeconds, bool exponential) {
+    if (!pImpl->initialized) {
+        return false;
+    }
+    if (gainDb > 24.0 || rampSeconds < 0.0) {
+        std::cout << "Error: Volume must be at most +24dB and the ramp time non-negative\n";
+        return false;
+    }
+    if (pImpl->dsdStreamRate > 0) {
+        std::cout << "Error: Volume cannot be applied to " << DSDPacker::GetModeName(pImpl->dsdOutputMode)
+                  << " DSD output; use 'dsd pcm' to convert it\n";
+        return false;
+    }
+
+    const double rate = pImpl->waveFormat.nSamplesPerSec > 0 ? pImpl->waveFormat.nSamplesPerSec : 48000.0;
+    AutomationEvent event;
+    event.value = gainDb <= -120.0 ? 0.0f : static_cast<float>(std::pow(10.0, gainDb / 20.0));
+    event.startFrame = atSeconds > 0.0 ? static_cast<uint64_t>(atSeconds * rate) : 0;
+    event.rampFrames = static_cast<uint64_t>(std::max(rampSeconds, kVolumeSmoothingSeconds) * rate);
+    event.curve = exponential ? AutomationEvent::Curve::Exponential : AutomationEvent::Curve::Linear;
+
+    pImpl->CreateVolumeStage();
+    if (!pImpl->volumeStage->GetGain().Schedule(event)) {
+        std::cout << "Error: Too many volume changes pending\n";
+        return false;
+    }
+
+    std::cout << std::fixed << std::setprecision(1) << "Volume: " << gainDb << "dB";
+    if (rampSeconds > 0.0) {
+        std::cout << " over " << rampSeconds << "s (" << (exponential ? "exponential" : "linear") << ")";
+    }
+    if (atSeconds > 0.0) {
+        std::cout << " starting at " << atSeconds << "s";
+    }
+    std::cout << "\n";
+    std::cout.unsetf(std::ios::floatfield);
+    return true;
+}
+
+bool AudioEngine::SetCrossfade(double seconds, const std::string& curve) {
+    if (!(seconds >= 0.0 && seconds <= 60.0)) {
+        std::cout << "Error: Crossfade must be 0 to 60 seconds: " << seconds << "\n";
+        return false;
+    }
+    Crossfade::Curve parsed;
+    std::vector<float> points;
+    if (!Crossfade::ParseCurve(curve, parsed, points)) {
+        std::cout << "Error: Unknown crossfade curve '" << curve
+                  << "' (linear, equal-power, s-curve, or gains from 0 to 1 such as 0,0.7,1)\n";
+        return false;
+    }
+    pImpl->crossfadeSeconds = seconds;
+    pImpl->crossfadeCurve = parsed;
+    pImpl->crossfadeCurvePoints.swap(points);
+    return true;
+}
+
+int AudioEngine::GetWaveform(const std::string& filePath, double startSeconds, double endSeconds, size_t width,
+                             std::vector<WaveformColumn>& columns) {
+    if (!pImpl->initialized) {
+        return 0;
+    }
+    pImpl->FollowRenderState();
+    const std::string path = filePath.empty() ? pImpl->currentFile : filePath;
+    if (path.empty()) {
+        std::cout << "Error: No audio file loaded for a waveform\n";
+        return 0;
+    }
+    std::shared_ptr<const WaveformOverview> overview = pImpl->GetWaveformOverview(path);
+    if (!overview) {
+        return 0;
+    }
+
+    const double rate = overview->GetSampleRate();
+    const double duration = static_cast<double>(overview->GetFrameCount()) / rate;
+    if (endSeconds <= 0.0) {
+        endSeconds = duration;
+    }
+    if (!(startSeconds >= 0.0 && endSeconds > startSeconds) ||
+        !overview->Query(static_cast<uint64_t>(startSeconds * rate), static_cast<uint64_t>(endSeconds * rate), width,
+                         columns)) {
+        std::cout << "Error: Invalid waveform range " << startSeconds << "-" << endSeconds << "s\n";
+        return 0;
+    }
+    return overview->GetChannelCount();
+}
+
+bool AudioEngine::SetRealtime(const RealtimeSettings& settings) {
+    if (!pImpl->initialized) {
+        return false;
+    }
+    if (settings.priority < 1 || settings.priority > 99) {
+        std::cout << "Error: Real-time priority must be 1 to 99: " << settings.priority << "\n";
+        return false;
+    }
+    if (settings.memory != "off" && settings.memory != "buffers" && settings.memory != "all") {
+        std::cout << "Error: Unknown memory locking mode '" << settings.memory << "' (off, buffers or all)\n";
+        return false;
+    }
+    pImpl->realtimeSettings = settings;
+    pImpl->ApplyRealtime();
+    return true;
+}
+
+std::string AudioEngine::GetRealtimeReport() const {
+    if (!pImpl->realtimeSettings.enabled) {
+        return "Real-time setup: disabled (playback thread at normal priority)\n";
+    }
+    std::ostringstream report;
+    report << "Real-time setup:\n";
+    if (pImpl->realtimeScheduling.empty()) {
+        report << "- Scheduling: applied when playback starts\n";
     } else {
-        // If format info is not available, use standard assumption
-        estimatedInputBitrate = 320; // Standard assumption for high quality audio
+        report << "- Scheduling: " << pImpl->realtimeScheduling << "\n"
+               << "- Affinity: " << pImpl->realtimeAffinity << "\n";
+    }
+    report << "- Memory: " << pImpl->realtimeMemory << "\n";
+    return report.str();
+}
+
+bool AudioEngine::SetBuffering(const BufferSettings& settings) {
+    if (!pImpl->initialized) {
+        return false;
+    }
+    std::string error;
+    if (!OutputBuffering::Validate(settings, error)) {
+        std::cout << "Error: Invalid output buffering: " << error << "\n";
+        return false;
     }
+    pImpl->bufferSettings = settings;
+    pImpl->RestartAnalysis();
+    return true;
+}
 
-    std::cout << "Converting audio bitrate: " << estimatedInputBitrate << "kbps -> " << targetBitrate << "kbps\n";
+std::string AudioEngine::GetBufferingReport() const {
+    const BufferSettings& settings = pImpl->bufferSettings;
+    const int sampleRate = pImpl->deviceFormat.nSamplesPerSec > 0 ?
+        static_cast<int>(pImpl->deviceFormat.nSamplesPerSec) : 44100;
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(1);
+    report << "Output buffering:\n"
+           << "- Configured: " << settings.periodCount << " x " << settings.periodFrames << " frames ("
+           << 1000.0 * settings.periodCount * settings.periodFrames / sampleRate << "ms at " << sampleRate << "Hz), "
+           << (settings.adaptive ? "adaptive" : "fixed") << "\n";
+    if (pImpl->isPlaying.load()) {
+        report << "- Playing: " << pImpl->outputBuffering.Describe() << " (changes apply when playback next starts)\n";
+    }
+    return report.str();
+}
 
-    // Use GPU to convert the audio data to the target bitrate
-    if (pImpl->gpuProcessor) {
-        // Calculate appropriate buffer size based on the actual audio format
-        // Check if WAV format is PCM 16-bit (most common case)
-        size_t bytesPerSample = (pImpl->waveFormat.wBitsPerSample > 0) ?
-                                (pImpl->waveFormat.wBitsPerSample / 8) : 2;
-        size_t numSamples = (bytesPerSample > 0) ? (pImpl->audioData.size() / bytesPerSample) : 0;
-
-        if (numSamples == 0) {
-            std::cout << "Error: Invalid audio data format\n";
+bool AudioEngine::SetPlaybackRate(double rate, const std::string& mode) {
+    if (!pImpl->initialized) {
+        return false;
+    }
+    if (!(rate >= TimeStretcher::kMinRate && rate <= TimeStretcher::kMaxRate)) {
+        std::cout << "Error: Playback rate must be " << TimeStretcher::kMinRate << " to " << TimeStretcher::kMaxRate
+                  << ": " << rate << "\n";
+        return false;
+    }
+    TimeStretcher::Mode parsed;
+    if (!TimeStretcher::ParseMode(mode, parsed)) {
+        std::cout << "Error: Unknown time stretch mode '" << mode << "' (music, speech or varispeed)\n";
+        return false;
+    }
+    if (pImpl->dsdStreamRate > 0 && rate != 1.0) {
+        std::cout << "Error: Playback rate cannot be changed for " << DSDPacker::GetModeName(pImpl->dsdOutputMode)
+                  << " DSD output; use 'dsd pcm' to convert it\n";
+        return false;
+    }
+
+    const double previousRate = pImpl->playbackRate;
+    const TimeStretcher::Mode previousMode = pImpl->stretchMode;
+    pImpl->playbackRate = rate;
+    pImpl->stretchMode = parsed;
+    if (pImpl->audioLoaded) {
+        // Same algorithm: change the rate in place, without a gap in the output
+        bool changed = false;
+        if (pImpl->timeStretcher && rate != 1.0 && parsed == pImpl->timeStretcher->GetMode()) {
+            pImpl->ChangeRenderState([&]() { pImpl->timeStretcher->SetRate(rate); });
+            changed = true;
+        }
+        if (!changed && !pImpl->PrepareTimeStretcher()) {
+            std::cout << "Error: Could not prepare time stretching\n";
+            pImpl->playbackRate = previousRate;
+            pImpl->stretchMode = previousMode;
+            pImpl->PrepareTimeStretcher();
             return false;
         }
+    }
 
-        // Safely allocate buffer with proper bounds
-        std::vector<float> inputAudio;
-        std::vector<float> outputAudio;
+    std::cout << "Playback rate: " << rate << "x";
+    if (rate != 1.0) {
+        std::cout << " (" << TimeStretcher::GetModeName(parsed) << ")";
+    }
+    std::cout << "\n";
+    return true;
+}
 
-        try {
-            inputAudio.resize(numSamples);
-            outputAudio.resize(numSamples);  // Same number of samples initially
-        } catch (const std::bad_alloc&) {
-            std::cout << "Error: Could not allocate memory for audio buffers\n";
-            return false;
+bool AudioEngine::QueueNext(const std::string& filePath) {
+    if (!pImpl->initialized) {
+        return false;
+    }
+    if (!pImpl->audioLoaded) {
+        return LoadFile(filePath);
+    }
+    if (pImpl->dsdStreamRate > 0) {
+        std::cout << "Error: Tracks cannot be queued during DSD output (" << DSDPacker::GetModeName(pImpl->dsdOutputMode)
+                  << ")\n";
+        return false;
+    }
+
+    // Decode and convert here, so the playback thread never waits for storage or conversion
+    auto track = std::make_unique<DecodedTrack>();
+    if (!pImpl->DecodeFile(filePath, *track)) {
+        return false;
+    }
+    if (track->dsdStreamRate > 0) {
+        std::cout << "Error: DSD files can only be queued with DSD output set to pcm - " << filePath << "\n";
+        return false;
+    }
+    if (!ConformTrack(*track, pImpl->waveFormat, pImpl->sourceLayout)) {
+        return false;
+    }
+
+    // The playback thread may have switched to a queued track since the last look
+    const size_t blockAlign = pImpl->waveFormat.nBlockAlign;
+    const size_t totalFrames = pImpl->FollowRenderState().trackBytes / blockAlign;
+    size_t fadeFrames = std::min({static_cast<size_t>(pImpl->crossfadeSeconds * pImpl->waveFormat.nSamplesPerSec + 0.5),
+                                  totalFrames, track->audioData.size() / blockAlign});
+    std::vector<float> fadeIn;
+    std::vector<float> fadeOut;
+    Crossfade::BuildGains(pImpl->crossfadeCurve, pImpl->crossfadeCurvePoints, fadeFrames, fadeIn, fadeOut);
+
+    std::string conversion = track->conversion;
+    const std::pair<const void*, size_t> memory(track->audioData.data(), track->audioData.size());
+    std::unique_ptr<DecodedTrack> replaced;
+    std::unique_ptr<DecodedTrack> finished;
+    uint64_t tracksStarted = 0;
+    pImpl->ChangeRenderState([&]() {
+        // Past the start of the overlap (or already on another track), the switch is gapless
+        const size_t frame = pImpl->playbackPosition.load() / blockAlign;
+        if (pImpl->audioData.size() / blockAlign != totalFrames || frame > totalFrames - fadeFrames) {
+            fadeFrames = 0;
         }
+        replaced = std::move(pImpl->nextTrack);
+        finished = std::move(pImpl->finishedTrack);
+        pImpl->nextTrack = std::move(track);
+        pImpl->crossfadeFrames = fadeFrames;
+        pImpl->fadeInGains.swap(fadeIn);
+        pImpl->fadeOutGains.swap(fadeOut);
+        tracksStarted = pImpl->tracksStarted;
+    });
+    // Replaced buffers are released here, on the control thread. The track queued before
+    // may have become the current one meanwhile
+    pImpl->FollowRenderState();
+    pImpl->queuedFile = filePath;
+    pImpl->queuedConversion.swap(conversion);
+    pImpl->queuedTrackNumber = tracksStarted + 1;
+    pImpl->queuedTrackMemory = memory;
+    if (pImpl->realtimeSettings.enabled) {
+        pImpl->LockPlaybackMemory();
+    }
 
-        // Safely convert the audio data to float for processing based on sample format
-        if (pImpl->waveFormat.wBitsPerSample == 16) {
-            // Handle 16-bit PCM audio data
-            short* audioDataPtr = reinterpret_cast<short*>(pImpl->audioData.data());
-            size_t samplesToConvert = std::min(numSamples, inputAudio.size());
+    std::cout << "Queued " << filePath;
+    if (fadeFrames > 0) {
+        std::cout << std::fixed << std::setprecision(1) << " with a "
+                  << static_cast<double>(fadeFrames) / pImpl->waveFormat.nSamplesPerSec << "s " << Crossfade::GetCurveName(pImpl->crossfadeCurve) << " crossfade\n";
+        std::cout.unsetf(std::ios::floatfield);
+    } else {
+        std::cout << " (gapless)\n";
+    }
+    if (replaced) {
+        std::cout << "Replaced queued track " << replaced->filePath << "\n";
+    }
+    return true;
+}
 
-            for (size_t i = 0; i < samplesToConvert; i++) {
-                // Convert 16-bit signed integer to float (range [-1, 1])
-                inputAudio[i] = static_cast<float>(audioDataPtr[i]) / 32768.0f;  // For 16-bit audio
-            }
-        } else if (pImpl->waveFormat.wBitsPerSample == 8) {
-            // Handle 8-bit PCM audio data
-            unsigned char* audioDataPtr = reinterpret_cast<unsigned char*>(pImpl->audioData.data());
-            size_t samplesToConvert = std::min(pImpl->audioData.size(), inputAudio.size());
-
-            for (size_t i = 0; i < samplesToConvert; i++) {
-                // Convert 8-bit unsigned to float (range [-1, 1])
-                inputAudio[i] = static_cast<float>(static_cast<signed char>(audioDataPtr[i] - 128)) / 128.0f;
-            }
-        } else if (pImpl->waveFormat.wBitsPerSample == 24) {
-            // Handle 24-bit PCM audio data
-            // This is more complex - would need to properly handle 3-byte samples
-            std::cout << "Warning: 24-bit audio format handling not fully implemented\n";
-            // For now, treat as 8-bit per byte
-            size_t samplesToConvert = std::min(pImpl->audioData.size(), inputAudio.size());
-
-            for (size_t i = 0; i < samplesToConvert; i++) {
-                char sample = pImpl->audioData[i];
-                inputAudio[i] = static_cast<float>(sample) / 127.0f;  // Fallback normalization
-            }
-        } else {
-            // Default: treat as 16-bit
-            short* audioDataPtr = reinterpret_cast<short*>(pImpl->audioData.data());
-            size_t samplesToConvert = std::min(numSamples, inputAudio.size());
+int AudioEngine::AddStream(const std::string& filePath, double gainDb, double pan, bool loop) {
+    if (!pImpl->initialized) {
+        return -1;
+    }
+    if (!pImpl->audioLoaded || pImpl->deviceFormat.nSamplesPerSec == 0) {
+        std::cout << "Error: Load a file first; streams play at its output format\n";
+        return -1;
+    }
+    if (pImpl->dsdStreamRate > 0) {
+        std::cout << "Error: Streams cannot be mixed into " << DSDPacker::GetModeName(pImpl->dsdOutputMode)
+                  << " DSD output\n";
+        return -1;
+    }
 
-            for (size_t i = 0; i < samplesToConvert; i++) {
-                inputAudio[i] = static_cast<float>(audioDataPtr[i]) / 32768.0f;
-            }
-        }
+    auto clip = std::make_shared<AudioClip>();
+    if (!LoadStreamClip(filePath, static_cast<int>(pImpl->deviceFormat.nSamplesPerSec), *clip)) {
+        return -1;
+    }
 
-        // Use GPU processor for bitrate conversion
-        bool success = pImpl->gpuProcessor->ConvertBitrate(
-            inputAudio.data(),
-            estimatedInputBitrate,
-            outputAudio.data(),
-            targetBitrate,
-            inputAudio.size() * sizeof(float)
-        );
+    const float gain = static_cast<float>(std::pow(10.0, gainDb / 20.0));
+    const size_t channels = clip->channels.size();
+    const double duration = static_cast<double>(clip->GetFrameCount()) / clip->sampleRate;
+    int stream = pImpl->streamMixer.AddVoice(std::move(clip), gain, static_cast<float>(pan), loop);
+    if (stream < 0) {
+        std::cout << "Error: Could not start stream - " << filePath << " (" << channels << " channels into "
+                  << pImpl->deviceLayout.Describe() << ", " << pImpl->streamMixer.GetActiveVoiceCount()
+                  << " of " << kMaxStreams << " streams playing)\n";
+        return -1;
+    }
 
-        if (success) {
-            // Calculate new buffer size based on bitrate ratio
-            double bitrateRatio = static_cast<double>(targetBitrate) / estimatedInputBitrate;
-            size_t newNumSamples = static_cast<size_t>(numSamples * bitrateRatio);
-
-            // Safely convert float output back to audio data with proper format
-            if (pImpl->waveFormat.wBitsPerSample == 16) {
-                // Convert back to 16-bit PCM
-                try {
-                    size_t outputSize = newNumSamples * sizeof(short);
-                    pImpl->audioData.resize(outputSize);
-                    short* audioDataPtr = reinterpret_cast<short*>(pImpl->audioData.data());
-
-                    for (size_t i = 0; i < std::min(outputAudio.size(), newNumSamples); i++) {
-                        float sample = outputAudio[i];
-                        // Clamp value to valid range and convert back to 16-bit
-                        float clampedSample = std::max(-1.0f, std::min(1.0f, sample));
-                        audioDataPtr[i] = static_cast<short>(clampedSample * 32767.0f);
-                    }
-                } catch (const std::exception&) {
-                    std::cout << "Error: Could not resize audio data buffer\n";
-                    return false;
-                }
-            } else if (pImpl->waveFormat.wBitsPerSample == 8) {
-                // Convert back to 8-bit PCM
-                try {
-                    size_t outputSize = newNumSamples * sizeof(char);
-                    pImpl->audioData.resize(outputSize);
-                    char* audioDataPtr = pImpl->audioData.data();
-
-                    for (size_t i = 0; i < std::min(outputAudio.size(), newNumSamples); i++) {
-                        float sample = outputAudio[i];
-                        // Clamp value to valid range and convert back to 8-bit
-                        float clampedSample = std::max(-1.0f, std::min(1.0f, sample));
-                        audioDataPtr[i] = static_cast<char>((clampedSample + 1.0f) * 127.5f);
-                    }
-                } catch (const std::exception&) {
-                    std::cout << "Error: Could not resize audio data buffer\n";
-                    return false;
-                }
-            } else if (pImpl->waveFormat.wBitsPerSample == 24) {
-                // Convert back to 24-bit PCM
-                try {
-                    size_t outputSize = newNumSamples * 3;  // 3 bytes per 24-bit sample
-                    pImpl->audioData.resize(outputSize);
-
-                    for (size_t i = 0; i < std::min(outputAudio.size(), newNumSamples); i++) {
-                        float sample = outputAudio[i];
-                        // Clamp value to valid range and convert back to 24-bit
-                        float clampedSample = std::max(-1.0f, std::min(1.0f, sample));
-                        int32_t intSample = static_cast<int32_t>(clampedSample * 8388607.0f);  // 2^23 - 1
-
-                        // Write 3 bytes for 24-bit sample
-                        size_t byteOffset = i * 3;
-                        pImpl->audioData[byteOffset] = static_cast<char>(intSample & 0xFF);
-                        pImpl->audioData[byteOffset + 1] = static_cast<char>((intSample >> 8) & 0xFF);
-                        pImpl->audioData[byteOffset + 2] = static_cast<char>((intSample >> 16) & 0xFF);
-                    }
-                } catch (const std::exception&) {
-                    std::cout << "Error: Could not resize audio data buffer\n";
-                    return false;
-                }
-            } else {
-                // Default to 16-bit
-                try {
-                    size_t outputSize = newNumSamples * sizeof(short);
-                    pImpl->audioData.resize(outputSize);
-                    short* audioDataPtr = reinterpret_cast<short*>(pImpl->audioData.data());
-
-                    for (size_t i = 0; i < std::min(outputAudio.size(), newNumSamples); i++) {
-                        float sample = outputAudio[i];
-                        // Clamp value to valid range and convert back to 16-bit
-                        float clampedSample = std::max(-1.0f, std::min(1.0f, sample));
-                        audioDataPtr[i] = static_cast<short>(clampedSample * 32767.0f);
-                    }
-                } catch (const std::exception&) {
-                    std::cout << "Error: Could not resize audio data buffer\n";
-                    return false;
-                }
-            }
+    std::cout << "Stream " << stream << ": " << filePath << " (" << std::fixed << std::setprecision(1)
+              << duration << "s" << (loop ? ", looped" : "") << ")\n";
+    std::cout.unsetf(std::ios::floatfield);
+    return stream;
+}
 
-            // Update format parameters with the new bitrate
-            if (targetBitrate != estimatedInputBitrate) {
-                pImpl->waveFormat.nAvgBytesPerSec = (targetBitrate * 1000) / 8; // Update bytes/second based on new bitrate
-            }
+bool AudioEngine::SetStreamGain(int stream, double gainDb) {
+    if (!pImpl->streamMixer.SetGain(stream, static_cast<float>(std::pow(10.0, gainDb / 20.0)))) {
+        std::cout << "Error: Stream " << stream << " is not playing\n";
+        return false;
+    }
+    return true;
+}
 
-            std::cout << "Audio bitrate converted from " << estimatedInputBitrate
-                      << "kbps to " << targetBitrate << "kbps using GPU\n";
-            std::cout << "File size adjusted: " << numSamples << " samples -> " << newNumSamples << " samples\n";
-            return true;
-        } else {
-            std::cout << "GPU bitrate conversion not supported or failed\n";
-            std::cout << "Using original audio data without bitrate change\n";
-            return false;
-        }
-    } else {
-        std::cout << "No GPU processor available for bitrate conversion\n";
+bool AudioEngine::SetStreamPan(int stream, double pan) {
+    if (pan < -1.0 || pan > 1.0) {
+        std::cout << "Error: Pan must be between -1 (left) and 1 (right)\n";
+        return false;
+    }
+    if (!pImpl->streamMixer.SetPan(stream, static_cast<float>(pan))) {
+        std::cout << "Error: Stream " << stream << " is not playing\n";
+        return false;
+    }
+    return true;
+}
+
+bool AudioEngine::StopStream(int stream) {
+    if (stream < 0) {
+        pImpl->streamMixer.StopAll();
+        return true;
+    }
+    if (!pImpl->streamMixer.StopVoice(stream)) {
+        std::cout << "Error: Stream " << stream << " is not playing\n";
+        return false;
+    }
+    return true;
+}
+
+void AudioEngine::SetStreamBudget(size_t streams) {
+    pImpl->streamMixer.SetVoiceBudget(streams);
+}
+
+std::string AudioEngine::GetStreamList() const {
+    std::ostringstream list;
+    list << std::fixed << std::setprecision(1);
+    for (const StreamMixer::VoiceInfo& voice : pImpl->streamMixer.GetVoices()) {
+        list << "Stream " << voice.id << ": " << 20.0 * std::log10(std::max(voice.gain, 1e-7f)) << "dB, pan "
+             << voice.pan << ", " << voice.position << "/" << voice.duration << "s"
+             << (voice.loop ? " (looped)" : "") << "\n";
+    }
+    return list.str();
+}
+
+void AudioEngine::SetConvolutionOffloadSize(size_t minPartitionFrames) {
+    pImpl->convolutionOffloadSize = minPartitionFrames;
+}
+
+bool AudioEngine::SetConvolutionFilter(const std::string& impulseResponsePath) {
+    if (!pImpl->initialized) {
         return false;
     }
+
+    std::string previousPath = pImpl->convolutionFilterPath;
+    pImpl->convolutionFilterPath = impulseResponsePath;
+
+    if (impulseResponsePath.empty()) {
+        pImpl->RebuildConvolutionStage();
+        std::cout << "Convolution filter disabled\n";
+        return true;
+    }
+
+    if (!pImpl->audioLoaded) {
+        // Device rate is not known yet; the filter is built when a file is loaded
+        std::cout << "Convolution filter will be applied when a file is loaded: " << impulseResponsePath << "\n";
+        return true;
+    }
+
+    if (!pImpl->RebuildConvolutionStage()) {
+        std::cout << "Error: Could not apply convolution filter - " << impulseResponsePath << "\n";
+        pImpl->convolutionFilterPath = previousPath;
+        return false;
+    }
+    return true;
+}
+
+bool AudioEngine::SetTargetBitrate(int targetBitrate) {
+    if (!pImpl->initialized) {
+        return false;
+    }
+
+    if (targetBitrate < 6 || targetBitrate > 510) {
+        std::cout << "Error: Target bitrate must be between 6 and 510 kbps\n";
+        return false;
+    }
+
+    // The PCM buffer is left untouched; the bitrate is applied by the encoder when saving
+    pImpl->targetBitrateKbps = targetBitrate;
+    std::cout << "Target bitrate set to " << targetBitrate << "kbps (used when saving to "
+              << EncoderFactory::GetAvailableFormats() << ")\n";
+    return true;
 }
 
 bool AudioEngine::SaveFile(const std::string& filePath) {
@@ -997,7 +3313,22 @@ bool AudioEngine::SaveFile(const std::string& filePath) {
         std::cout << "Error: No audio data to save\n";
         return false;
     }
+    if (pImpl->dsdStreamRate > 0) {
+        std::cout << "Error: The loaded DSD stream is kept as 1-bit data for " << DSDPacker::GetModeName(pImpl->dsdOutputMode)
+                  << " output; run 'dsd pcm' and load it again to save it as PCM\n";
+        return false;
+    }
+
+    if (EncoderFactory::IsLossyFormat(filePath)) {
+        return pImpl->EncodeToFile(filePath);
+    }
+    if (pImpl->targetBitrateKbps > 0) {
+        std::cout << "Note: WAV output is uncompressed; the target bitrate applies to "
+                  << EncoderFactory::GetAvailableFormats() << " output\n";
+    }
 
+    // The loaded track is written straight from its buffer, whole frames only
+    const ConstPcmBufferView track = MakePcmView(pImpl->audioData, pImpl->waveFormat);
     std::ofstream outputFile(filePath, std::ios::binary);
     if (!outputFile) {
         std::cout << "Error: Could not open file for writing: " << filePath << "\n";
@@ -1008,9 +3339,14 @@ bool AudioEngine::SaveFile(const std::string& filePath) {
     // RIFF header
     outputFile.write("RIFF", 4);
 
+    // More than two channels or more than 16 bits are written as WAVE_FORMAT_EXTENSIBLE
+    // so the speaker assignment survives the round trip
+    const bool extensible = track.Channels() > 2 || track.BitsPerSample() > 16;
+
     // Calculate data size
-    int dataSize = pImpl->audioData.size();
-    int totalFileSize = 36 + dataSize; // 36 = header size, dataSize = our data
+    int dataSize = static_cast<int>(track.ByteSize());
+    int subchunk1Size = extensible ? 40 : 16;
+    int totalFileSize = 20 + subchunk1Size + dataSize; // RIFF type, fmt and data chunk headers + format + data
 
     outputFile.write(reinterpret_cast<const char*>(&totalFileSize), 4);
     outputFile.write("WAVE", 4);
@@ -1018,16 +3354,16 @@ bool AudioEngine::SaveFile(const std::string& filePath) {
     // Format subchunk
     outputFile.write("fmt ", 4);
 
-    // Subchunk1 size (16 for PCM)
-    int subchunk1Size = 16;
+    // Subchunk1 size (16 for PCM, 40 for WAVE_FORMAT_EXTENSIBLE)
     outputFile.write(reinterpret_cast<const char*>(&subchunk1Size), 4);
 
     // Audio format (1 = PCM)
-    short audioFormat = 1;
+    unsigned short audioFormat = extensible ? WAVE_FORMAT_EXTENSIBLE : WAVE_FORMAT_PCM;
     outputFile.write(reinterpret_cast<const char*>(&audioFormat), 2);
 
     // Number of channels
-    outputFile.write(reinterpret_cast<const char*>(&pImpl->waveFormat.nChannels), 2);
+    unsigned short channels = static_cast<unsigned short>(track.Channels());
+    outputFile.write(reinterpret_cast<const char*>(&channels), 2);
 
     // Sample rate
     outputFile.write(reinterpret_cast<const char*>(&pImpl->waveFormat.nSamplesPerSec), 4);
@@ -1036,12 +3372,25 @@ bool AudioEngine::SaveFile(const std::string& filePath) {
     outputFile.write(reinterpret_cast<const char*>(&pImpl->waveFormat.nAvgBytesPerSec), 4);
 
     // Block align (channels * bits per sample / 8)
-    outputFile.write(reinterpret_cast<const char*>(&pImpl->waveFormat.nBlockAlign), 2);
+    unsigned short blockAlign = static_cast<unsigned short>(track.BlockAlign());
+    outputFile.write(reinterpret_cast<const char*>(&blockAlign), 2);
 
     // Bits per sample
-    short bitsPerSample = pImpl->waveFormat.wBitsPerSample;
+    short bitsPerSample = static_cast<short>(track.BitsPerSample());
     outputFile.write(reinterpret_cast<const char*>(&bitsPerSample), 2);
 
+    if (extensible) {
+        // Extension size, valid bits, speaker mask and the PCM sub-format GUID
+        static const unsigned char kSubtypePcm[16] = {0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+                                                      0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+        short extensionSize = 22;
+        uint32_t channelMask = pImpl->sourceLayout.GetMask();
+        outputFile.write(reinterpret_cast<const char*>(&extensionSize), 2);
+        outputFile.write(reinterpret_cast<const char*>(&bitsPerSample), 2);
+        outputFile.write(reinterpret_cast<const char*>(&channelMask), 4);
+        outputFile.write(reinterpret_cast<const char*>(kSubtypePcm), sizeof(kSubtypePcm));
+    }
+
     // Data subchunk
     outputFile.write("data", 4);
 
@@ -1049,12 +3398,12 @@ bool AudioEngine::SaveFile(const std::string& filePath) {
     outputFile.write(reinterpret_cast<const char*>(&dataSize), 4);
 
     // Actual audio data
-    outputFile.write(pImpl->audioData.data(), pImpl->audioData.size());
+    outputFile.write(track.Data(), track.ByteSize());
 
     outputFile.close();
 
     std::cout << "Saved processed audio to file: " << filePath
-              << " (" << pImpl->audioData.size() << " bytes)\n";
+              << " (" << track.ByteSize() << " bytes)\n";
     return true;
 }
 
@@ -1118,5 +3467,3 @@ bool AudioEngine::IsPaused() const {
 
     return pImpl->isPaused.load();
 }
-
-#endif // ENABLE_FLAC 
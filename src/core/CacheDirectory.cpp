@@ -0,0 +1,47 @@
+#include "CacheDirectory.h"
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+
+// Implementation of the on-disk cache location
+
+namespace CacheDirectory {
+
+std::string Get(const std::string& subdirectory) {
+    std::error_code error;
+    std::filesystem::path root;
+    const char* overridePath = std::getenv("GPU_PLAYER_CACHE_DIR");
+    if (overridePath && *overridePath) {
+        root = overridePath;
+    } else {
+        root = std::filesystem::temp_directory_path(error);
+        if (error) {
+            return std::string();
+        }
+        root /= "gpu_player_cache";
+    }
+
+    std::filesystem::path directory = root / subdirectory;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        return std::string();
+    }
+    return directory.string();
+}
+
+std::string HashKey(const std::string& text) {
+    // std::hash is not guaranteed to be stable between runs, FNV-1a is
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    std::ostringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+}
+
+} // namespace CacheDirectory
@@ -0,0 +1,31 @@
+#ifndef CACHE_DIRECTORY_H
+#define CACHE_DIRECTORY_H
+
+#include <string>
+
+/**
+ * @brief Location of data the player can regenerate but prefers to keep between runs
+ *
+ * The root is $GPU_PLAYER_CACHE_DIR if set, otherwise a "gpu_player_cache"
+ * directory under the system temporary directory. Callers must treat every
+ * cached file as optional and rebuild it if it is missing or unreadable.
+ */
+namespace CacheDirectory {
+
+    /**
+     * @brief Get (and create if needed) a subdirectory of the cache
+     * @param subdirectory Name of the subdirectory, e.g. "opencl"
+     * @return Path of the directory, or an empty string if it cannot be created
+     */
+    std::string Get(const std::string& subdirectory);
+
+    /**
+     * @brief Hash a string into a short hexadecimal key for cache file names
+     * @param text Text identifying the cached item (source, device, version...)
+     * @return 16 hex digits (FNV-1a, stable across runs and platforms)
+     */
+    std::string HashKey(const std::string& text);
+
+} // namespace CacheDirectory
+
+#endif // CACHE_DIRECTORY_H
@@ -1,8 +1,15 @@
 #include "CommandLineInterface.h"
+#include "core/OutputBuffering.h"
+#include "core/RealtimeThread.h"
+#include "core/Log.h"
+#include "core/Trace.h"
+#include "gpu/BackendAutotuner.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <vector>
+#include <cmath>
+#include <iomanip>
 
 // Implementation of CommandLineInterface
 
@@ -96,6 +103,97 @@ bool CommandLineInterface::ExecuteCommand(const std::vector<std::string>& args)
             return false;
         }
     }
+    else if (command == "convolve") {
+        if (args.size() < 2) {
+            std::cout << "Usage: convolve <impulse_response.wav> | convolve off\n";
+            return false;
+        }
+        return HandleConvolve(args[1]);
+    }
+    else if (command == "layout") {
+        if (args.size() < 2) {
+            std::cout << "Usage: layout <stereo|5.1|7.1|...> | layout source\n";
+            return false;
+        }
+        return HandleLayout(args[1]);
+    }
+    else if (command == "dsd") {
+        if (args.size() < 2) {
+            std::cout << "Usage: dsd <fast|standard|high> [pcm_rate] | dsd <pcm|dop|native>\n";
+            return false;
+        }
+
+        int pcmRate = 0;  // Default to 4x the base rate
+        if (args.size() >= 3) {
+            try {
+                pcmRate = std::stoi(args[2]);
+            } catch (...) {
+                std::cout << "Invalid PCM rate value\n";
+                return false;
+            }
+        }
+        return HandleDSD(args[1], pcmRate);
+    }
+    else if (command == "volume") {
+        if (args.size() < 2) {
+            std::cout << "Usage: volume <db> [ramp_seconds] [at_seconds] [linear|exp]\n";
+            return false;
+        }
+
+        try {
+            double gainDb = std::stod(args[1]);
+            double rampSeconds = args.size() >= 3 ? std::stod(args[2]) : 0.0;
+            double atSeconds = args.size() >= 4 ? std::stod(args[3]) : -1.0;
+            bool exponential = args.size() >= 5 && args[4] == "exp";
+            return HandleVolume(gainDb, rampSeconds, atSeconds, exponential);
+        } catch (...) {
+            std::cout << "Invalid volume parameter values\n";
+            return false;
+        }
+    }
+    else if (command == "queue") {
+        if (args.size() < 2) {
+            std::cout << "Usage: queue <file_path>\n";
+            return false;
+        }
+        return HandleQueue(args[1]);
+    }
+    else if (command == "crossfade") {
+        if (args.size() < 2) {
+            std::cout << "Usage: crossfade <seconds> [linear|equal-power|s-curve|<g0,g1,...>]\n";
+            return false;
+        }
+
+        try {
+            double seconds = std::stod(args[1]);
+            return HandleCrossfade(seconds, args.size() >= 3 ? args[2] : "equal-power");
+        } catch (...) {
+            std::cout << "Invalid crossfade length\n";
+            return false;
+        }
+    }
+    else if (command == "speed") {
+        if (args.size() < 2) {
+            std::cout << "Usage: speed <rate 0.5-2.0> [music|speech|varispeed]\n";
+            return false;
+        }
+
+        try {
+            double rate = std::stod(args[1]);
+            return HandleSpeed(rate, args.size() >= 3 ? args[2] : "music");
+        } catch (...) {
+            std::cout << "Invalid playback rate\n";
+            return false;
+        }
+    }
+    else if (command == "stream") {
+        if (args.size() < 2) {
+            std::cout << "Usage: stream <file> [gain_db] [pan] [loop] | stream gain|pan <id> <value> | "
+                         "stream stop <id>|all | stream budget <count> | stream list\n";
+            return false;
+        }
+        return HandleStream(args);
+    }
     else if (command == "bitrate") {
         if (args.size() < 2) {
             std::cout << "Usage: bitrate <target_kbps>\n";
@@ -140,6 +238,46 @@ bool CommandLineInterface::ExecuteCommand(const std::vector<std::string>& args)
     else if (command == "stats") {
         return HandleStats();
     }
+    else if (command == "levels") {
+        return HandleLevels();
+    }
+    else if (command == "spectrum") {
+        return HandleSpectrum();
+    }
+    else if (command == "waveform") {
+        try {
+            double startSeconds = args.size() >= 3 ? std::stod(args[1]) : 0.0;
+            double endSeconds = args.size() >= 3 ? std::stod(args[2]) : 0.0;
+            size_t width = args.size() >= 4 ? static_cast<size_t>(std::stoul(args[3])) : 64;
+            return HandleWaveform(args.size() >= 5 ? args[4] : (args.size() == 2 ? args[1] : ""),
+                                  startSeconds, endSeconds, width);
+        } catch (...) {
+            std::cout << "Usage: waveform [file] | waveform <start_s> <end_s> [width] [file]\n";
+            return false;
+        }
+    }
+    else if (command == "realtime") {
+        return HandleRealtime(args);
+    }
+    else if (command == "buffer") {
+        return HandleBuffer(args);
+    }
+    else if (command == "trace") {
+        return HandleTrace(args);
+    }
+    else if (command == "log") {
+        return HandleLog(args);
+    }
+    else if (command == "analysis") {
+        if (args.size() < 2) {
+            std::cout << "Usage: analysis on|off\n";
+            return false;
+        }
+        return HandleAnalysis(args[1]);
+    }
+    else if (command == "autotune") {
+        return HandleAutotune();
+    }
     else if (command == "quit" || command == "exit") {
         return HandleQuit();
     }
@@ -152,10 +290,31 @@ bool CommandLineInterface::ExecuteCommand(const std::vector<std::string>& args)
                   << "  stop - Stop playback\n"
                   << "  seek <seconds> - Seek to a specific position\n"
                   << "  eq <f1> <g1> <q1> <f2> <g2> <q2> - Set EQ parameters\n"
-                  << "  bitrate <kbps> - Set target bitrate for GPU conversion\n"
-                  << "  convert <input> <output> [bitrate] - Convert file with GPU acceleration\n"
-                  << "  save <file_path> - Save processed audio to file\n"
+                  << "  convolve <ir.wav>|off - Apply a room-correction/FIR impulse response\n"
+                  << "  layout <name>|source - Downmix/upmix the output to a speaker layout (e.g. stereo, 5.1, 7.1.4)\n"
+                  << "  dsd <fast|standard|high> [rate] - Set the DSD to PCM conversion for .dsf/.dff files\n"
+                  << "  dsd <pcm|dop|native> - Convert DSD to PCM, or send it bit-perfect as DoP or native DSD\n"
+                  << "  volume <db> [ramp_s] [at_s] [linear|exp] - Change the volume, optionally as a timed ramp\n"
+                  << "  queue <file_path> - Play a file after the current one (gapless or crossfaded)\n"
+                  << "  crossfade <seconds> [curve] - Crossfade queued tracks (linear, equal-power, s-curve or g0,g1,...)\n"
+                  << "  speed <rate> [mode] - Play at 0.5x to 2x; music and speech keep the pitch, varispeed does not\n"
+                  << "  stream <file> [gain_db] [pan] [loop] - Mix another WAV/DSF/DFF file over the playback\n"
+                  << "  stream gain|pan <id> <value>, stream stop <id>|all, stream budget <n>, stream list - Control streams\n"
+                  << "  bitrate <kbps> - Set target bitrate for .opus/.mp3 output\n"
+                  << "  convert <input> <output> [bitrate] - Convert file (.wav, .opus/.ogg, .mp3 by extension)\n"
+                  << "  save <file_path> - Save audio to file (.wav, .opus/.ogg, .mp3 by extension)\n"
                   << "  stats - Show performance statistics\n"
+                  << "  levels - Show output peak/RMS levels\n"
+                  << "  spectrum - Show output spectrum\n"
+                  << "  waveform [start end] [width] [file] - Show the min/max/RMS overview of a file (cached on disk)\n"
+                  << "  realtime on [fifo|rr] [priority] [cpus] [off|buffers|all] - Real-time playback thread; "
+                     "'realtime off', 'realtime' shows what was granted\n"
+                  << "  buffer <low-latency|balanced|power-saving> | buffer <frames> <count> [adaptive] - "
+                     "Output periods; 'buffer' shows latency and underruns\n"
+                  << "  trace start, trace stop [file.json] - Record pipeline stage timings as a Chrome trace\n"
+                  << "  log <category|all> <off|error|warning|info|debug> - Set log levels; 'log' shows them\n"
+                  << "  analysis on|off - Enable or disable output analysis\n"
+                  << "  autotune - Benchmark the processing backends again\n"
                   << "  help - Show this help message\n"
                   << "  quit/exit - Exit the player\n";
         return true;
@@ -228,6 +387,95 @@ bool CommandLineInterface::HandleEQ(double freq1, double gain1, double q1,
     return engine.SetEQ(freq1, gain1, q1, freq2, gain2, q2);  // ✅ Fixed: Added actual call to engine.SetEQ()
 }
 
+bool CommandLineInterface::HandleConvolve(const std::string& impulseResponsePath) {
+    if (impulseResponsePath == "off") {
+        return engine.SetConvolutionFilter("");
+    }
+
+    std::cout << "Loading impulse response: " << impulseResponsePath << "\n";
+    return engine.SetConvolutionFilter(impulseResponsePath);
+}
+
+bool CommandLineInterface::HandleLayout(const std::string& layout) {
+    return engine.SetOutputLayout(layout);
+}
+
+bool CommandLineInterface::HandleDSD(const std::string& setting, int pcmRate) {
+    if (setting == "pcm" || setting == "dop" || setting == "native") {
+        return engine.SetDSDOutput(setting);
+    }
+    return engine.SetDSDConversion(setting, pcmRate);
+}
+
+bool CommandLineInterface::HandleVolume(double gainDb, double rampSeconds, double atSeconds, bool exponential) {
+    return engine.SetVolume(gainDb, rampSeconds, atSeconds, exponential);
+}
+
+bool CommandLineInterface::HandleQueue(const std::string& filePath) {
+    return engine.QueueNext(filePath);
+}
+
+bool CommandLineInterface::HandleCrossfade(double seconds, const std::string& curve) {
+    if (!engine.SetCrossfade(seconds, curve)) {
+        return false;
+    }
+    if (seconds > 0.0) {
+        std::cout << "Crossfade set to " << seconds << "s " << curve << " for queued tracks\n";
+    } else {
+        std::cout << "Queued tracks follow gaplessly\n";
+    }
+    return true;
+}
+
+bool CommandLineInterface::HandleSpeed(double rate, const std::string& mode) {
+    return engine.SetPlaybackRate(rate, mode);
+}
+
+bool CommandLineInterface::HandleStream(const std::vector<std::string>& args) {
+    const std::string& action = args[1];
+    if (action == "list") {
+        std::string list = engine.GetStreamList();
+        std::cout << (list.empty() ? "No streams playing\n" : list);
+        return true;
+    }
+
+    try {
+        if (action == "stop") {
+            if (args.size() < 3) {
+                std::cout << "Usage: stream stop <id>|all\n";
+                return false;
+            }
+            return engine.StopStream(args[2] == "all" ? -1 : std::stoi(args[2]));
+        }
+        if (action == "gain" || action == "pan") {
+            if (args.size() < 4) {
+                std::cout << "Usage: stream " << action << " <id> <value>\n";
+                return false;
+            }
+            int stream = std::stoi(args[2]);
+            double value = std::stod(args[3]);
+            return action == "gain" ? engine.SetStreamGain(stream, value) : engine.SetStreamPan(stream, value);
+        }
+        if (action == "budget") {
+            if (args.size() < 3 || std::stoi(args[2]) < 1) {
+                std::cout << "Usage: stream budget <count>\n";
+                return false;
+            }
+            engine.SetStreamBudget(static_cast<size_t>(std::stoi(args[2])));
+            std::cout << "Mixing at most " << args[2] << " streams per block\n";
+            return true;
+        }
+
+        double gainDb = args.size() >= 3 ? std::stod(args[2]) : 0.0;
+        double pan = args.size() >= 4 ? std::stod(args[3]) : 0.0;
+        bool loop = args.size() >= 5 && args[4] == "loop";
+        return engine.AddStream(action, gainDb, pan, loop) >= 0;
+    } catch (...) {
+        std::cout << "Invalid stream parameter values\n";
+        return false;
+    }
+}
+
 bool CommandLineInterface::HandleStats() {
     std::cout << "Performance Statistics:\n";
     // In a real implementation, we would call engine.GetStats()
@@ -236,19 +484,274 @@ bool CommandLineInterface::HandleStats() {
     return true;
 }
 
-bool CommandLineInterface::HandleBitrate(int targetBitrate) {
-    std::cout << "Setting target bitrate to " << targetBitrate << " kbps using GPU acceleration\n";
+bool CommandLineInterface::HandleLevels() {
+    LevelSnapshot levels;
+    if (!engine.GetLevels(levels) || levels.channels == 0) {
+        std::cout << "No level data (load a file with analysis enabled)\n";
+        return false;
+    }
+
+    // Meter scale: -60dBFS to 0dBFS
+    const int kMeterWidth = 40;
+    std::cout << std::fixed << std::setprecision(1);
+    for (int ch = 0; ch < levels.channels; ch++) {
+        float peakDb = 20.0f * std::log10(std::max(levels.peak[ch], 1e-7f));
+        float rmsDb = 20.0f * std::log10(std::max(levels.rms[ch], 1e-7f));
+        int rmsWidth = static_cast<int>(std::max(0.0f, std::min(1.0f, (rmsDb + 60.0f) / 60.0f)) * kMeterWidth);
+        int peakColumn = static_cast<int>(std::max(0.0f, std::min(1.0f, (peakDb + 60.0f) / 60.0f)) * kMeterWidth);
+
+        std::string meter(kMeterWidth, ' ');
+        std::fill(meter.begin(), meter.begin() + rmsWidth, '#');
+        if (peakColumn > 0) {
+            meter[peakColumn - 1] = '|';
+        }
+        std::cout << "  Ch" << std::setw(2) << (ch + 1) << " [" << meter << "] peak "
+                  << std::setw(6) << peakDb << " dBFS, RMS " << std::setw(6) << rmsDb << " dBFS\n";
+    }
+    if (levels.framesDropped > 0) {
+        std::cout << "  (" << levels.framesDropped << " frames skipped by the analyzer)\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    return true;
+}
 
-    // In a real implementation, we would call engine.SetTargetBitrate(targetBitrate)
-    bool success = engine.SetTargetBitrate(targetBitrate);
+bool CommandLineInterface::HandleSpectrum() {
+    SpectrumSnapshot spectrum;
+    if (!engine.GetSpectrum(spectrum) || spectrum.sampleRate <= 0) {
+        std::cout << "No spectrum data (load a file with analysis enabled)\n";
+        return false;
+    }
 
-    if (success) {
-        std::cout << "Bitrate conversion successfully applied using GPU\n";
+    // Log-spaced bands from 20Hz to Nyquist, each showing its loudest bin
+    const int kBands = 32;
+    const int kRows = 12;
+    const float kFloorDb = -96.0f;
+    const double binHz = static_cast<double>(spectrum.sampleRate) / kSpectrumFFTSize;
+    const double lowHz = 20.0;
+    const double highHz = spectrum.sampleRate / 2.0;
+
+    std::vector<float> bandDb(kBands, kFloorDb);
+    for (int band = 0; band < kBands; band++) {
+        double startHz = lowHz * std::pow(highHz / lowHz, static_cast<double>(band) / kBands);
+        double endHz = lowHz * std::pow(highHz / lowHz, static_cast<double>(band + 1) / kBands);
+        size_t first = static_cast<size_t>(startHz / binHz);
+        size_t last = std::max(first, static_cast<size_t>(endHz / binHz));
+        for (size_t bin = first; bin <= last && bin < kSpectrumBinCount; bin++) {
+            bandDb[band] = std::max(bandDb[band], spectrum.magnitudeDb[bin]);
+        }
+    }
+
+    for (int row = kRows; row >= 1; row--) {
+        float rowDb = kFloorDb * (1.0f - static_cast<float>(row) / kRows);
+        std::cout << std::setw(5) << static_cast<int>(rowDb) << " dB |";
+        for (int band = 0; band < kBands; band++) {
+            std::cout << (bandDb[band] >= rowDb ? "##" : "  ");
+        }
+        std::cout << "\n";
+    }
+    std::cout << "         +" << std::string(2 * kBands, '-') << "\n"
+              << "          20Hz" << std::string(2 * kBands - 14, ' ')
+              << static_cast<int>(highHz / 1000) << "kHz\n";
+    return true;
+}
+
+bool CommandLineInterface::HandleWaveform(const std::string& filePath, double startSeconds, double endSeconds,
+                                          size_t width) {
+    if (width == 0 || width > 1000) {
+        std::cout << "Waveform width must be 1 to 1000 columns\n";
+        return false;
+    }
+    std::vector<WaveformColumn> columns;
+    int channels = engine.GetWaveform(filePath, startSeconds, endSeconds, width, columns);
+    if (channels == 0) {
+        return false;
+    }
+
+    // All channels in one plot: '#' spans min to max, '=' marks the RMS band around zero
+    const int kRows = 8;
+    for (int row = kRows; row >= -kRows; row--) {
+        if (row == 0) {
+            continue;
+        }
+        const float level = (row > 0 ? row - 0.5f : row + 0.5f) / kRows;
+        std::cout << std::setw(5) << std::fixed << std::setprecision(2) << level << " |";
+        for (size_t x = 0; x < width; x++) {
+            float minimum = 0.0f, maximum = 0.0f, rms = 0.0f;
+            for (int channel = 0; channel < channels; channel++) {
+                const WaveformColumn& column = columns[x * channels + channel];
+                minimum = std::min(minimum, column.min);
+                maximum = std::max(maximum, column.max);
+                rms = std::max(rms, column.rms);
+            }
+            char mark = ' ';
+            if (std::fabs(level) <= rms) {
+                mark = '=';
+            } else if (level >= minimum && level <= maximum) {
+                mark = '#';
+            }
+            std::cout << mark;
+        }
+        std::cout << "\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+    return true;
+}
+
+bool CommandLineInterface::HandleRealtime(const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        std::cout << engine.GetRealtimeReport();
+        return true;
+    }
+
+    RealtimeSettings settings;
+    if (args[1] == "off") {
+        engine.SetRealtime(settings);
+        std::cout << "Real-time setup disabled (normal scheduling from the next playback)\n";
+        return true;
+    }
+    if (args[1] != "on") {
+        std::cout << "Usage: realtime [on [fifo|rr] [priority] [cpus|any] [off|buffers|all] | off]\n";
+        return false;
+    }
+
+    settings.enabled = true;
+    if (args.size() >= 3) {
+        if (args[2] != "fifo" && args[2] != "rr") {
+            std::cout << "Unknown scheduling policy '" << args[2] << "' (fifo or rr)\n";
+            return false;
+        }
+        settings.roundRobin = args[2] == "rr";
+    }
+    if (args.size() >= 4) {
+        try {
+            settings.priority = std::stoi(args[3]);
+        } catch (...) {
+            std::cout << "Invalid priority\n";
+            return false;
+        }
+    }
+    if (args.size() >= 5 && args[4] != "any" && !RealtimeThread::ParseCpuList(args[4], settings.cpus)) {
+        std::cout << "Invalid CPU list '" << args[4] << "' (e.g. 2,3 or 2-3)\n";
+        return false;
+    }
+    if (args.size() >= 6) {
+        settings.memory = args[5];
+    }
+    if (!engine.SetRealtime(settings)) {
+        return false;
+    }
+    std::cout << engine.GetRealtimeReport();
+    return true;
+}
+
+bool CommandLineInterface::HandleBuffer(const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        std::cout << engine.GetBufferingReport();
+        return true;
+    }
+
+    BufferSettings settings;
+    if (args.size() == 2) {
+        if (!OutputBuffering::GetPreset(args[1], settings)) {
+            std::cout << "Unknown buffering preset '" << args[1] << "' (low-latency, balanced or power-saving)\n";
+            return false;
+        }
     } else {
-        std::cout << "Bitrate conversion failed. Using original audio quality.\n";
+        try {
+            settings.periodFrames = std::stoul(args[1]);
+            settings.periodCount = std::stoul(args[2]);
+        } catch (...) {
+            std::cout << "Usage: buffer [low-latency|balanced|power-saving | <frames> <count> [adaptive|fixed]]\n";
+            return false;
+        }
+        if (args.size() >= 4 && args[3] != "adaptive" && args[3] != "fixed") {
+            std::cout << "Unknown buffering mode '" << args[3] << "' (adaptive or fixed)\n";
+            return false;
+        }
+        settings.adaptive = args.size() >= 4 && args[3] == "adaptive";
     }
+    if (!engine.SetBuffering(settings)) {
+        return false;
+    }
+    std::cout << engine.GetBufferingReport();
+    return true;
+}
 
-    return success;
+bool CommandLineInterface::HandleTrace(const std::vector<std::string>& args) {
+    std::string result;
+    if (args.size() >= 2 && args[1] == "start") {
+        Trace::SetThreadName("control");
+        if (!Trace::Start(result)) {
+            std::cout << "Error: Could not start tracing: " << result << "\n";
+            return false;
+        }
+        std::cout << "Tracing decode, DSP, backend and device stages; 'trace stop' writes the trace\n";
+        return true;
+    }
+    if (args.size() >= 2 && args[1] == "stop") {
+        if (!Trace::Stop(args.size() >= 3 ? args[2] : "trace.json", result)) {
+            std::cout << "Error: Could not stop tracing: " << result << "\n";
+            return false;
+        }
+        std::cout << "Trace: " << result << " (open in ui.perfetto.dev or chrome://tracing)\n";
+        return true;
+    }
+    if (args.size() < 2) {
+        std::cout << "Tracing: " << (!Trace::IsCompiledIn() ? "compiled out" : Trace::IsRecording() ? "recording" : "off")
+                  << "\n";
+        return true;
+    }
+    std::cout << "Usage: trace [start | stop [file.json]]\n";
+    return false;
+}
+
+bool CommandLineInterface::HandleLog(const std::vector<std::string>& args) {
+    if (args.size() == 1) {
+        std::cout << "Log: " << Log::Describe() << "\n";
+        return true;
+    }
+    if (args.size() != 3) {
+        std::cout << "Usage: log [<engine|playback|decoder|device|gpu|dsp|all> <off|error|warning|info|debug>]\n";
+        return false;
+    }
+    std::string result;
+    if (!Log::SetLevel(args[1], args[2], result)) {
+        std::cout << "Error: " << result << "\n";
+        return false;
+    }
+    std::cout << "Log: " << result << "\n";
+    return true;
+}
+
+bool CommandLineInterface::HandleAnalysis(const std::string& mode) {
+    if (mode == "on") {
+        engine.SetAnalysisEnabled(true);
+        std::cout << "Output analysis enabled\n";
+        return true;
+    }
+    if (mode == "off") {
+        engine.SetAnalysisEnabled(false);
+        std::cout << "Output analysis disabled\n";
+        return true;
+    }
+    std::cout << "Usage: analysis on|off\n";
+    return false;
+}
+
+bool CommandLineInterface::HandleAutotune() {
+    BackendAutotuner autotuner;
+    if (!autotuner.Tune(true)) {
+        return false;
+    }
+    std::cout << autotuner.GetReport() << "\n";
+    std::cout << "Saved; the backend choice applies the next time the player starts\n";
+    return true;
+}
+
+bool CommandLineInterface::HandleBitrate(int targetBitrate) {
+    std::cout << "Setting target bitrate to " << targetBitrate << " kbps\n";
+    return engine.SetTargetBitrate(targetBitrate);
 }
 
 bool CommandLineInterface::HandleSave(const std::string& targetPath) {
@@ -0,0 +1,116 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief Bounded lock-free multi-producer/single-consumer queue
+ *
+ * Any number of threads push and one thread pops. Every slot carries a
+ * sequence number that says whether it is free for the producer of a given
+ * position or holds a value for the consumer, so producers only contend on
+ * the enqueue position (one compare-and-swap) and the consumer never waits
+ * for them. Storage is allocated once in Reset; Push and Pop never allocate
+ * and are safe on the audio thread.
+ */
+template <typename T>
+class CommandQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "Queue elements must be trivially copyable");
+
+public:
+    /**
+     * @brief Allocate storage and clear the queue (not thread-safe)
+     * @param minimumCapacity Minimum number of elements the queue can hold
+     */
+    void Reset(size_t minimumCapacity) {
+        size_t capacity = 1;
+        while (capacity < minimumCapacity) {
+            capacity <<= 1;
+        }
+        slots.reset(new Slot[capacity]);
+        for (size_t i = 0; i < capacity; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mask = capacity - 1;
+        enqueuePosition.store(0, std::memory_order_relaxed);
+        dequeuePosition.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the total capacity
+     * @return Number of elements the queue can hold
+     */
+    size_t GetCapacity() const { return slots ? mask + 1 : 0; }
+
+    /**
+     * @brief Append an element (any thread)
+     * @param value Element to append
+     * @return true if appended, false if the queue is full
+     */
+    bool Push(const T& value) {
+        if (!slots) {
+            return false;
+        }
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[position & mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                // The slot is free for this position; claim it
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                // The consumer has not freed this slot yet
+                return false;
+            } else {
+                // Another producer claimed the position first
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = value;
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest element (consumer thread only)
+     * @param value Receives the element
+     * @return true if an element was taken, false if the queue is empty
+     */
+    bool Pop(T& value) {
+        if (!slots) {
+            return false;
+        }
+        size_t position = dequeuePosition.load(std::memory_order_relaxed);
+        Slot& slot = slots[position & mask];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1) < 0) {
+            return false;
+        }
+        value = slot.value;
+        // Free the slot for the producer one lap ahead
+        slot.sequence.store(position + mask + 1, std::memory_order_release);
+        dequeuePosition.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> enqueuePosition{0};
+    alignas(64) std::atomic<size_t> dequeuePosition{0};
+};
+
+#endif // COMMAND_QUEUE_H
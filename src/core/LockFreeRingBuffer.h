@@ -0,0 +1,129 @@
+#ifndef LOCK_FREE_RING_BUFFER_H
+#define LOCK_FREE_RING_BUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Wait-free single-producer/single-consumer ring buffer
+ *
+ * One thread writes and one thread reads; neither ever blocks. Capacity is
+ * rounded up to a power of two and allocated once in Reset, so Write/Read
+ * never allocate and are safe to call from the audio thread.
+ */
+template <typename T>
+class LockFreeRingBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "Ring buffer elements must be trivially copyable");
+
+public:
+    /**
+     * @brief Allocate storage and clear the buffer (not thread-safe)
+     * @param minimumCapacity Minimum number of elements the buffer can hold
+     */
+    void Reset(size_t minimumCapacity) {
+        size_t capacity = 1;
+        while (capacity < minimumCapacity) {
+            capacity <<= 1;
+        }
+        storage.assign(capacity, T());
+        mask = capacity - 1;
+        writeIndex.store(0, std::memory_order_relaxed);
+        readIndex.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the total capacity
+     * @return Number of elements the buffer can hold
+     */
+    size_t GetCapacity() const { return storage.size(); }
+
+    /**
+     * @brief Number of elements that can be written without overwriting unread data
+     * @return Free space (producer side)
+     */
+    size_t GetWriteSpace() const {
+        size_t write = writeIndex.load(std::memory_order_relaxed);
+        size_t read = readIndex.load(std::memory_order_acquire);
+        return storage.size() - (write - read);
+    }
+
+    /**
+     * @brief Number of elements ready to be read
+     * @return Readable element count (consumer side)
+     */
+    size_t GetReadAvailable() const {
+        size_t write = writeIndex.load(std::memory_order_acquire);
+        size_t read = readIndex.load(std::memory_order_relaxed);
+        return write - read;
+    }
+
+    /**
+     * @brief Append elements (producer thread only)
+     * @param data Elements to write
+     * @param count Number of elements
+     * @return Number of elements written (less than count when the buffer is full)
+     */
+    size_t Write(const T* data, size_t count) {
+        if (storage.empty()) {
+            return 0;
+        }
+        size_t write = writeIndex.load(std::memory_order_relaxed);
+        size_t read = readIndex.load(std::memory_order_acquire);
+        size_t space = storage.size() - (write - read);
+        if (count > space) {
+            count = space;
+        }
+
+        size_t start = write & mask;
+        size_t first = std::min(count, storage.size() - start);
+        std::memcpy(&storage[start], data, first * sizeof(T));
+        if (first < count) {
+            std::memcpy(&storage[0], data + first, (count - first) * sizeof(T));
+        }
+
+        writeIndex.store(write + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Remove elements (consumer thread only)
+     * @param data Destination for the elements
+     * @param count Maximum number of elements to read
+     * @return Number of elements read
+     */
+    size_t Read(T* data, size_t count) {
+        if (storage.empty()) {
+            return 0;
+        }
+        size_t read = readIndex.load(std::memory_order_relaxed);
+        size_t write = writeIndex.load(std::memory_order_acquire);
+        size_t available = write - read;
+        if (count > available) {
+            count = available;
+        }
+
+        size_t start = read & mask;
+        size_t first = std::min(count, storage.size() - start);
+        std::memcpy(data, &storage[start], first * sizeof(T));
+        if (first < count) {
+            std::memcpy(data + first, &storage[0], (count - first) * sizeof(T));
+        }
+
+        readIndex.store(read + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    std::vector<T> storage;
+    size_t mask = 0;
+
+    // Free-running indices on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<size_t> writeIndex{0};
+    alignas(64) std::atomic<size_t> readIndex{0};
+};
+
+#endif // LOCK_FREE_RING_BUFFER_H
\ No newline at end of file
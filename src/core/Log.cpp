@@ -0,0 +1,228 @@
+#include "Log.h"
+#include "CommandQueue.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// Implementation of the asynchronous logger
+
+namespace Log {
+namespace detail {
+std::atomic<int> levels[kCategoryCount] = {
+    {static_cast<int>(Level::Info)}, {static_cast<int>(Level::Info)}, {static_cast<int>(Level::Info)},
+    {static_cast<int>(Level::Info)}, {static_cast<int>(Level::Info)}, {static_cast<int>(Level::Info)}};
+}
+}
+
+namespace {
+
+const char* const kCategoryNames[Log::kCategoryCount] = {"engine", "playback", "decoder", "device", "gpu", "dsp"};
+const char* const kLevelNames[] = {"off", "error", "warning", "info", "debug"};
+
+// How long queued messages wait for the background writer at most
+const std::chrono::milliseconds kFlushInterval(50);
+
+struct Record {
+    Log::Level level;
+    Log::Category category;
+    uint32_t suppressed;              // Repeats of this call site left out before it
+    char text[Log::kMessageBytes];
+};
+
+struct Writer {
+    CommandQueue<Record> queue;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> suppressed{0};
+    uint64_t reportedDropped = 0;     // (outputMutex)
+    std::mutex outputMutex;           // Held by whoever takes records and writes them
+
+    std::thread thread;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    bool stopping = false;            // (wakeMutex)
+
+    ~Writer() {
+        Log::Stop();
+    }
+};
+
+Writer& GetWriter() {
+    static Writer writer;
+    return writer;
+}
+
+// Caller holds outputMutex
+void WriteRecord(const Record& record) {
+    if (record.level == Log::Level::Error) {
+        std::cout << "Error: ";
+    } else if (record.level == Log::Level::Warning) {
+        std::cout << "Warning: ";
+    }
+    std::cout << record.text;
+    if (record.suppressed > 0) {
+        std::cout << " (" << record.suppressed << (record.suppressed == 1 ? " repeat" : " repeats") << " suppressed)";
+    }
+    std::cout << '\n';
+}
+
+void WriterLoop() {
+    Writer& writer = GetWriter();
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(writer.wakeMutex);
+            writer.wakeCondition.wait_for(lock, kFlushInterval, [&writer]() { return writer.stopping; });
+            if (writer.stopping) {
+                break;
+            }
+        }
+        Log::Flush();
+    }
+}
+
+} // namespace
+
+namespace Log {
+
+bool RateLimit::Allow(uint32_t& suppressed) {
+    const uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    uint64_t current = second.load(std::memory_order_relaxed);
+    if (now != current && second.compare_exchange_strong(current, now, std::memory_order_relaxed)) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    if (count.fetch_add(1, std::memory_order_relaxed) < kRepeatsPerSecond) {
+        suppressed = pending.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+    pending.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void Write(Category category, Level level, RateLimit* limit, const char* format, ...) {
+    Writer& writer = GetWriter();
+    Record record;
+    record.level = level;
+    record.category = category;
+    record.suppressed = 0;
+    if (limit && !limit->Allow(record.suppressed)) {
+        writer.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(record.text, sizeof(record.text), format, args);
+    va_end(args);
+
+    if (writer.running.load(std::memory_order_acquire)) {
+        if (!writer.queue.Push(record)) {
+            writer.dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+    std::lock_guard<std::mutex> lock(writer.outputMutex);
+    WriteRecord(record);
+    std::cout.flush();
+}
+
+void Start() {
+    Writer& writer = GetWriter();
+    if (writer.running.load()) {
+        return;
+    }
+    if (writer.queue.GetCapacity() == 0) {
+        writer.queue.Reset(kQueueRecords);
+    }
+    writer.stopping = false;
+    writer.running.store(true, std::memory_order_release);
+    writer.thread = std::thread(WriterLoop);
+}
+
+void Stop() {
+    Writer& writer = GetWriter();
+    if (!writer.running.load()) {
+        return;
+    }
+    writer.running.store(false);
+    {
+        std::lock_guard<std::mutex> lock(writer.wakeMutex);
+        writer.stopping = true;
+    }
+    writer.wakeCondition.notify_one();
+    if (writer.thread.joinable()) {
+        writer.thread.join();
+    }
+    Flush();
+}
+
+void Flush() {
+    Writer& writer = GetWriter();
+    std::lock_guard<std::mutex> lock(writer.outputMutex);
+    bool wrote = false;
+    Record record;
+    while (writer.queue.Pop(record)) {
+        WriteRecord(record);
+        wrote = true;
+    }
+    const uint64_t dropped = writer.dropped.load(std::memory_order_relaxed);
+    if (dropped != writer.reportedDropped) {
+        std::cout << "Warning: " << dropped - writer.reportedDropped << " log messages dropped (queue full)\n";
+        writer.reportedDropped = dropped;
+        wrote = true;
+    }
+    if (wrote) {
+        std::cout.flush();
+    }
+}
+
+bool SetLevel(const std::string& category, const std::string& level, std::string& result) {
+    int parsedLevel = -1;
+    for (int i = 0; i < static_cast<int>(sizeof(kLevelNames) / sizeof(kLevelNames[0])); i++) {
+        if (level == kLevelNames[i]) {
+            parsedLevel = i;
+        }
+    }
+    if (parsedLevel < 0) {
+        result = "unknown level '" + level + "' (off, error, warning, info or debug)";
+        return false;
+    }
+    bool found = false;
+    for (size_t i = 0; i < kCategoryCount; i++) {
+        if (category == "all" || category == kCategoryNames[i]) {
+            detail::levels[i].store(parsedLevel, std::memory_order_relaxed);
+            found = true;
+        }
+    }
+    if (!found) {
+        result = "unknown category '" + category + "' (all, engine, playback, decoder, device, gpu or dsp)";
+        return false;
+    }
+    result = category + " set to " + level;
+    return true;
+}
+
+std::string Describe() {
+    std::ostringstream text;
+    for (size_t i = 0; i < kCategoryCount; i++) {
+        text << (i > 0 ? " " : "") << kCategoryNames[i] << "="
+             << kLevelNames[detail::levels[i].load(std::memory_order_relaxed)];
+    }
+    text << "; " << GetDroppedCount() << " dropped, " << GetSuppressedCount() << " suppressed";
+    return text.str();
+}
+
+uint64_t GetDroppedCount() {
+    return GetWriter().dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t GetSuppressedCount() {
+    return GetWriter().suppressed.load(std::memory_order_relaxed);
+}
+
+} // namespace Log
@@ -0,0 +1,132 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Leveled, categorized logging that is safe on the audio path
+ *
+ * A message is formatted into a fixed-size record on the calling thread and
+ * pushed onto a lock-free queue; a background thread started by Start writes
+ * the records to the console. Callers never take a lock, allocate or wait for
+ * console I/O, and a full queue drops the message (the drop is counted and
+ * reported). Before Start and after Stop, messages are written directly.
+ *
+ * Messages are written with GPU_PLAYER_LOG, which costs one relaxed load when
+ * the level is disabled for the category, formats nothing in that case, and
+ * lets each call site through kRepeatsPerSecond times per second: further
+ * repeats are counted and reported with the next message that gets through.
+ */
+namespace Log {
+
+    enum class Level { Off, Error, Warning, Info, Debug };
+
+    enum class Category { Engine, Playback, Decoder, Device, GPU, DSP };
+
+    const size_t kCategoryCount = 6;
+
+    // Longest message kept; longer ones are truncated
+    const size_t kMessageBytes = 240;
+
+    // Records the queue holds before messages are dropped
+    const size_t kQueueRecords = 1024;
+
+    // Messages per call site and second before repeats are suppressed
+    const uint32_t kRepeatsPerSecond = 5;
+
+    namespace detail {
+        extern std::atomic<int> levels[kCategoryCount];
+    }
+
+    /**
+     * @brief Check whether messages of a level are written for a category
+     */
+    inline bool IsEnabled(Category category, Level level) {
+        return static_cast<int>(level) <= detail::levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Counts the messages of one call site (use GPU_PLAYER_LOG)
+     */
+    class RateLimit {
+    public:
+        /**
+         * @brief Count a message and decide whether it is written
+         * @param suppressed Receives the repeats suppressed since the last message written
+         * @return true if the message should be written
+         */
+        bool Allow(uint32_t& suppressed);
+
+    private:
+        std::atomic<uint64_t> second{0};
+        std::atomic<uint32_t> count{0};
+        std::atomic<uint32_t> pending{0};
+    };
+
+    /**
+     * @brief Format and queue a message (any thread)
+     * @param category Subsystem the message is about
+     * @param level Severity; "Error: " or "Warning: " is prepended when written
+     * @param limit Rate limit of the call site, or nullptr for none
+     * @param format printf-style format
+     */
+    void Write(Category category, Level level, RateLimit* limit, const char* format, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 4, 5)))
+#endif
+        ;
+
+    /**
+     * @brief Start the background writer (control thread)
+     */
+    void Start();
+
+    /**
+     * @brief Write the queued messages and stop the background writer (control thread)
+     */
+    void Stop();
+
+    /**
+     * @brief Write the queued messages now (control thread)
+     */
+    void Flush();
+
+    /**
+     * @brief Set the level of one category or of all of them
+     * @param category Category name ("engine", "playback", ...) or "all"
+     * @param level "off", "error", "warning", "info" or "debug"
+     * @param result Receives a description of what happened
+     * @return true if set, false if a name is unknown
+     */
+    bool SetLevel(const std::string& category, const std::string& level, std::string& result);
+
+    /**
+     * @brief Describe the levels and counters, e.g. "engine=info playback=info ... dsp=debug; 0 dropped, 12 suppressed"
+     */
+    std::string Describe();
+
+    /**
+     * @brief Get the number of messages dropped because the queue was full
+     */
+    uint64_t GetDroppedCount();
+
+    /**
+     * @brief Get the number of repeats suppressed by rate limiting
+     */
+    uint64_t GetSuppressedCount();
+
+} // namespace Log
+
+#define GPU_PLAYER_LOG(category, level, ...)                                        \
+    do {                                                                            \
+        if (Log::IsEnabled(Log::Category::category, Log::Level::level)) {           \
+            static Log::RateLimit logRateLimit;                                     \
+            Log::Write(Log::Category::category, Log::Level::level, &logRateLimit,   \
+                       __VA_ARGS__);                                                \
+        }                                                                           \
+    } while (0)
+
+#endif // LOG_H
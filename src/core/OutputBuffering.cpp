@@ -0,0 +1,82 @@
+#include "OutputBuffering.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+// Implementation of output buffering
+
+bool OutputBuffering::Validate(const BufferSettings& settings, std::string& error) {
+    if (settings.periodFrames < kMinPeriodFrames || settings.periodFrames > kMaxPeriodFrames) {
+        error = "period size must be " + std::to_string(kMinPeriodFrames) + " to " +
+                std::to_string(kMaxPeriodFrames) + " frames";
+        return false;
+    }
+    if (settings.periodCount < kMinPeriodCount || settings.periodCount > kMaxPeriodCount) {
+        error = "period count must be " + std::to_string(kMinPeriodCount) + " to " + std::to_string(kMaxPeriodCount);
+        return false;
+    }
+    return true;
+}
+
+bool OutputBuffering::GetPreset(const std::string& name, BufferSettings& settings) {
+    if (name == "low-latency") {
+        // About 9ms at 44.1kHz; adaptive so a busy system trades latency for continuity
+        settings = {128, 3, true};
+    } else if (name == "balanced") {
+        settings = BufferSettings();
+    } else if (name == "power-saving") {
+        // Large periods let the CPU sleep between wake-ups, at over half a second of latency
+        settings = {8192, 3, false};
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void OutputBuffering::Start(const BufferSettings& settings, int rate) {
+    periodFrames.store(settings.periodFrames, std::memory_order_relaxed);
+    periodCount.store(settings.periodCount, std::memory_order_relaxed);
+    minimumCount.store(settings.periodCount, std::memory_order_relaxed);
+    adaptive.store(settings.adaptive, std::memory_order_relaxed);
+    sampleRate.store(rate, std::memory_order_relaxed);
+    underruns.store(0, std::memory_order_relaxed);
+    stableFrames = 0;
+}
+
+void OutputBuffering::OnUnderrun() {
+    underruns.fetch_add(1, std::memory_order_relaxed);
+    stableFrames = 0;
+    if (adaptive.load(std::memory_order_relaxed)) {
+        periodCount.store(std::min(GetPeriodCount() * 2, kMaxPeriodCount), std::memory_order_relaxed);
+    }
+}
+
+void OutputBuffering::OnPeriodQueued() {
+    if (!adaptive.load(std::memory_order_relaxed)) {
+        return;
+    }
+    stableFrames += GetPeriodFrames();
+    const size_t count = GetPeriodCount();
+    if (count > minimumCount.load(std::memory_order_relaxed) &&
+        stableFrames >= static_cast<uint64_t>(kStableSeconds * sampleRate.load(std::memory_order_relaxed))) {
+        periodCount.store(count - 1, std::memory_order_relaxed);
+        stableFrames = 0;
+    }
+}
+
+double OutputBuffering::GetLatencyMs() const {
+    const int rate = sampleRate.load(std::memory_order_relaxed);
+    return rate > 0 ? 1000.0 * GetPeriodFrames() * GetPeriodCount() / rate : 0.0;
+}
+
+std::string OutputBuffering::Describe() const {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1);
+    text << GetPeriodCount() << " x " << GetPeriodFrames() << " frames (" << GetLatencyMs() << "ms)";
+    if (adaptive.load(std::memory_order_relaxed)) {
+        text << ", adaptive from " << minimumCount.load(std::memory_order_relaxed);
+    }
+    const uint64_t count = GetUnderrunCount();
+    text << ", " << count << (count == 1 ? " underrun" : " underruns");
+    return text.str();
+}
@@ -0,0 +1,99 @@
+#ifndef OUTPUT_BUFFERING_H
+#define OUTPUT_BUFFERING_H
+
+#include "AudioEngine.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Period queue depth, underrun count and adaptive sizing of the device output
+ *
+ * The playback thread keeps GetPeriodCount() periods of GetPeriodFrames()
+ * frames queued to the device and reports every underrun and every period it
+ * queues. In adaptive mode an underrun doubles the queue (up to
+ * kMaxPeriodCount), and every kStableSeconds of playback without one
+ * removes a period again, down to the configured count. State is held in
+ * atomics, so the control thread can report it while the playback thread
+ * updates it.
+ */
+class OutputBuffering {
+public:
+    static constexpr size_t kMinPeriodFrames = 64;
+    static constexpr size_t kMaxPeriodFrames = 16384;
+    static constexpr size_t kMinPeriodCount = 2;
+    static constexpr size_t kMaxPeriodCount = 16;
+
+    // Playback without an underrun before adaptive mode removes a period
+    static constexpr double kStableSeconds = 10.0;
+
+    /**
+     * @brief Check that settings are within the supported range
+     * @param settings Settings to check
+     * @param error Receives the reason if they are not
+     * @return true if valid, false otherwise
+     */
+    static bool Validate(const BufferSettings& settings, std::string& error);
+
+    /**
+     * @brief Get the settings of a named preset
+     * @param name "low-latency", "balanced" or "power-saving"
+     * @param settings Receives the preset
+     * @return true if the name is known, false otherwise
+     */
+    static bool GetPreset(const std::string& name, BufferSettings& settings);
+
+    /**
+     * @brief Start a playback session (before the playback thread starts)
+     * @param settings Validated settings
+     * @param sampleRate Device sample rate in Hz
+     */
+    void Start(const BufferSettings& settings, int sampleRate);
+
+    /**
+     * @brief Get the frames per period of the session
+     */
+    size_t GetPeriodFrames() const { return periodFrames.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of periods to keep queued now
+     */
+    size_t GetPeriodCount() const { return periodCount.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Record that the device ran out of audio (playback thread)
+     */
+    void OnUnderrun();
+
+    /**
+     * @brief Record that a period was queued (playback thread)
+     */
+    void OnPeriodQueued();
+
+    /**
+     * @brief Get the number of underruns since Start
+     */
+    uint64_t GetUnderrunCount() const { return underruns.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the latency of the current queue in milliseconds
+     */
+    double GetLatencyMs() const;
+
+    /**
+     * @brief Describe the session, e.g. "4 x 1024 frames (92.9ms), adaptive, 0 underruns"
+     */
+    std::string Describe() const;
+
+private:
+    std::atomic<size_t> periodFrames{1024};
+    std::atomic<size_t> periodCount{4};
+    std::atomic<size_t> minimumCount{4};     // Configured count; adaptive mode never goes below it
+    std::atomic<bool> adaptive{false};
+    std::atomic<int> sampleRate{0};
+    std::atomic<uint64_t> underruns{0};
+    uint64_t stableFrames = 0;               // Frames queued since the last underrun or shrink (playback thread)
+};
+
+#endif // OUTPUT_BUFFERING_H
@@ -0,0 +1,255 @@
+#include "RealtimeThread.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Implementation of real-time thread setup
+
+namespace {
+
+// Stack touched by PrefaultStack; covers the render path's deepest call chain with room to spare
+const size_t kStackPrefaultBytes = 256 * 1024;
+
+size_t GetPageSize() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+#else
+    long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? static_cast<size_t>(size) : 4096;
+#endif
+}
+
+#ifdef __linux__
+// CPUs removed from the general scheduler with isolcpus= (empty if none or unknown)
+std::vector<int> GetIsolatedCpus() {
+    std::vector<int> cpus;
+    std::ifstream file("/sys/devices/system/cpu/isolated");
+    std::string line;
+    if (file && std::getline(file, line) && !line.empty()) {
+        RealtimeThread::ParseCpuList(line, cpus);
+    }
+    return cpus;
+}
+#endif
+
+} // namespace
+
+namespace RealtimeThread {
+
+bool SetScheduling(std::thread& thread, bool roundRobin, int priority, std::string& result) {
+#ifdef _WIN32
+    (void)roundRobin;
+    (void)priority;
+    if (!SetThreadPriority(thread.native_handle(), THREAD_PRIORITY_TIME_CRITICAL)) {
+        result = "normal priority (time-critical priority denied, error " + std::to_string(GetLastError()) + ")";
+        return false;
+    }
+    result = "time-critical priority";
+    return true;
+#else
+    const int policy = roundRobin ? SCHED_RR : SCHED_FIFO;
+    const char* policyName = roundRobin ? "SCHED_RR" : "SCHED_FIFO";
+    sched_param parameters = {};
+    parameters.sched_priority = std::min(std::max(priority, sched_get_priority_min(policy)),
+                                         sched_get_priority_max(policy));
+    int error = pthread_setschedparam(thread.native_handle(), policy, &parameters);
+    if (error != 0) {
+        result = std::string("normal priority (") + policyName + " denied: " + std::strerror(error) +
+                 "; needs CAP_SYS_NICE or an rtprio limit)";
+        return false;
+    }
+
+    // Report what the kernel actually applied
+    int grantedPolicy = 0;
+    sched_param granted = {};
+    pthread_getschedparam(thread.native_handle(), &grantedPolicy, &granted);
+    result = std::string(grantedPolicy == SCHED_RR ? "SCHED_RR" : grantedPolicy == SCHED_FIFO ? "SCHED_FIFO" : "SCHED_OTHER") +
+             " priority " + std::to_string(granted.sched_priority);
+    return grantedPolicy == policy;
+#endif
+}
+
+bool SetAffinity(std::thread& thread, const std::vector<int>& cpus, std::string& result) {
+#ifdef _WIN32
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) {
+        if (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+            mask |= static_cast<DWORD_PTR>(1) << cpu;
+        }
+    }
+    if (cpus.empty()) {
+        // Back to every CPU the process may use
+        DWORD_PTR systemMask = 0;
+        GetProcessAffinityMask(GetCurrentProcess(), &mask, &systemMask);
+        result = "all CPUs";
+        return SetThreadAffinityMask(thread.native_handle(), mask) != 0;
+    }
+    if (mask == 0 || SetThreadAffinityMask(thread.native_handle(), mask) == 0) {
+        result = "all CPUs (affinity " + FormatCpuList(cpus) + " denied, error " + std::to_string(GetLastError()) + ")";
+        return false;
+    }
+    result = "CPUs " + FormatCpuList(cpus);
+    return true;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpus.empty()) {
+        // Back to every CPU the process may use
+        sched_getaffinity(0, sizeof(set), &set);
+        result = "all CPUs";
+        return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+    }
+    for (int cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    int error = pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+    if (error != 0) {
+        result = "all CPUs (affinity " + FormatCpuList(cpus) + " denied: " + std::strerror(error) + ")";
+        return false;
+    }
+    result = "CPUs " + FormatCpuList(cpus);
+
+    // Other threads still run on CPUs the scheduler has not been told to keep free
+    std::vector<int> isolated = GetIsolatedCpus();
+    bool allIsolated = std::all_of(cpus.begin(), cpus.end(), [&isolated](int cpu) {
+        return std::find(isolated.begin(), isolated.end(), cpu) != isolated.end();
+    });
+    result += allIsolated ? " (isolated)" : " (shared; isolate them with isolcpus= for exclusive use)";
+    return true;
+#else
+    (void)thread;
+    if (cpus.empty()) {
+        result = "all CPUs";
+        return true;
+    }
+    result = "all CPUs (thread affinity is not supported on this platform)";
+    return false;
+#endif
+}
+
+bool LockRange(const void* data, size_t bytes) {
+    if (!data || bytes == 0) {
+        return true;
+    }
+#ifdef _WIN32
+    return VirtualLock(const_cast<void*>(data), bytes) != 0;
+#else
+    return mlock(data, bytes) == 0;
+#endif
+}
+
+void UnlockRange(const void* data, size_t bytes) {
+    if (!data || bytes == 0) {
+        return;
+    }
+#ifdef _WIN32
+    VirtualUnlock(const_cast<void*>(data), bytes);
+#else
+    munlock(data, bytes);
+#endif
+}
+
+bool LockAllMemory(std::string& result) {
+#ifdef _WIN32
+    result = "not locked (locking all memory is not supported on this platform)";
+    return false;
+#else
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        result = std::string("not locked (mlockall denied: ") + std::strerror(errno) +
+                 "; needs CAP_IPC_LOCK or a higher memlock limit)";
+        return false;
+    }
+    result = "all process memory locked";
+    return true;
+#endif
+}
+
+void UnlockAllMemory() {
+#ifndef _WIN32
+    munlockall();
+#endif
+}
+
+void Prefault(const void* data, size_t bytes) {
+    const volatile char* bytesIn = static_cast<const volatile char*>(data);
+    const size_t pageSize = GetPageSize();
+    for (size_t offset = 0; offset < bytes; offset += pageSize) {
+        (void)bytesIn[offset];
+    }
+    if (bytes > 0) {
+        (void)bytesIn[bytes - 1];
+    }
+}
+
+void PrefaultStack() {
+    volatile char stack[kStackPrefaultBytes];
+    const size_t pageSize = GetPageSize();
+    for (size_t offset = 0; offset < kStackPrefaultBytes; offset += pageSize) {
+        stack[offset] = 0;
+    }
+    (void)stack[0];
+}
+
+bool ParseCpuList(const std::string& text, std::vector<int>& cpus) {
+    std::vector<int> parsed;
+    std::stringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        item.erase(std::remove_if(item.begin(), item.end(), [](char c) { return c == ' ' || c == '\n'; }), item.end());
+        if (item.empty()) {
+            continue;
+        }
+        size_t dash = item.find('-');
+        try {
+            int first = std::stoi(item.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+            if (first < 0 || last < first || last > 4095) {
+                return false;
+            }
+            for (int cpu = first; cpu <= last; cpu++) {
+                parsed.push_back(cpu);
+            }
+        } catch (...) {
+            return false;
+        }
+    }
+    if (parsed.empty()) {
+        return false;
+    }
+    std::sort(parsed.begin(), parsed.end());
+    parsed.erase(std::unique(parsed.begin(), parsed.end()), parsed.end());
+    cpus.swap(parsed);
+    return true;
+}
+
+std::string FormatCpuList(const std::vector<int>& cpus) {
+    std::ostringstream text;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t end = i;
+        while (end + 1 < cpus.size() && cpus[end + 1] == cpus[end] + 1) {
+            end++;
+        }
+        text << (i > 0 ? "," : "") << cpus[i];
+        if (end > i) {
+            text << "-" << cpus[end];
+        }
+        i = end + 1;
+    }
+    return text.str();
+}
+
+} // namespace RealtimeThread
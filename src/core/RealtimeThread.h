@@ -0,0 +1,89 @@
+#ifndef REALTIME_THREAD_H
+#define REALTIME_THREAD_H
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Real-time scheduling, CPU affinity and memory locking for audio threads
+ *
+ * Every function degrades gracefully: if the system refuses a request (no
+ * CAP_SYS_NICE, RLIMIT_RTPRIO or RLIMIT_MEMLOCK too low, unsupported
+ * platform), it returns false and describes what was granted instead, so
+ * the caller can report it.
+ */
+namespace RealtimeThread {
+
+    /**
+     * @brief Give a thread a real-time scheduling policy
+     *
+     * POSIX: SCHED_FIFO or SCHED_RR via pthread_setschedparam, with the
+     * priority clamped to the policy's range. Windows: time-critical priority.
+     * @param thread Thread to change
+     * @param roundRobin Use SCHED_RR instead of SCHED_FIFO
+     * @param priority Priority from 1 (lowest) to 99
+     * @param result Receives what was granted, e.g. "SCHED_FIFO priority 70"
+     * @return true if the policy was granted, false otherwise
+     */
+    bool SetScheduling(std::thread& thread, bool roundRobin, int priority, std::string& result);
+
+    /**
+     * @brief Restrict a thread to a set of CPUs
+     * @param thread Thread to change
+     * @param cpus CPU numbers (empty: all CPUs)
+     * @param result Receives what was granted, including whether the CPUs are isolated from the scheduler
+     * @return true if the affinity was set, false otherwise
+     */
+    bool SetAffinity(std::thread& thread, const std::vector<int>& cpus, std::string& result);
+
+    /**
+     * @brief Lock a range of memory into RAM (mlock/VirtualLock), faulting it in
+     * @return true if successful, false otherwise
+     */
+    bool LockRange(const void* data, size_t bytes);
+
+    /**
+     * @brief Undo LockRange
+     */
+    void UnlockRange(const void* data, size_t bytes);
+
+    /**
+     * @brief Lock all current and future memory of the process (mlockall)
+     * @param result Receives what was granted
+     * @return true if successful, false otherwise (not available on Windows)
+     */
+    bool LockAllMemory(std::string& result);
+
+    /**
+     * @brief Undo LockAllMemory
+     */
+    void UnlockAllMemory();
+
+    /**
+     * @brief Touch every page of a range so it is resident before it is needed
+     */
+    void Prefault(const void* data, size_t bytes);
+
+    /**
+     * @brief Touch the calling thread's stack ahead of time (call first thing on the thread)
+     */
+    void PrefaultStack();
+
+    /**
+     * @brief Parse a CPU list such as "2,3" or "4-7"
+     * @param text CPU list
+     * @param cpus Receives the CPU numbers, sorted and without duplicates
+     * @return true if the list is valid, false otherwise
+     */
+    bool ParseCpuList(const std::string& text, std::vector<int>& cpus);
+
+    /**
+     * @brief Format CPU numbers as a compact list such as "2-3,6"
+     */
+    std::string FormatCpuList(const std::vector<int>& cpus);
+
+} // namespace RealtimeThread
+
+#endif // REALTIME_THREAD_H
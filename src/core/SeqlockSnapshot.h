@@ -0,0 +1,105 @@
+#ifndef SEQLOCK_SNAPSHOT_H
+#define SEQLOCK_SNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @brief Single-writer, many-reader snapshot published with a sequence lock
+ *
+ * The writer never waits for readers and readers never block the writer: a
+ * reader copies the value and retries if the sequence number changed during
+ * the copy. The payload is stored as relaxed atomic words so concurrent
+ * copies are well defined. Any number of readers may poll concurrently.
+ */
+template <typename T>
+class SeqlockSnapshot {
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshot type must be trivially copyable");
+
+public:
+    SeqlockSnapshot() {
+        for (auto& word : words) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Publish a new value (single writer thread only)
+     * @param value Value to publish
+     */
+    void Publish(const T& value) {
+        uint64_t buffer[kWordCount] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        uint64_t sequence = sequenceNumber.load(std::memory_order_relaxed);
+        sequenceNumber.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < kWordCount; i++) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+
+        sequenceNumber.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Try to copy a consistent value
+     * @param value Receives the value on success
+     * @return true if a consistent copy was made, false if a write was in progress
+     */
+    bool TryRead(T& value) const {
+        uint64_t before = sequenceNumber.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+
+        uint64_t buffer[kWordCount];
+        for (size_t i = 0; i < kWordCount; i++) {
+            buffer[i] = words[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = sequenceNumber.load(std::memory_order_relaxed);
+        if (before != after) {
+            return false;
+        }
+
+        std::memcpy(&value, buffer, sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Copy a consistent value, retrying while the writer is active
+     * @param value Receives the value on success
+     * @param maxAttempts Number of attempts before giving up
+     * @return true if a consistent copy was made, false otherwise
+     */
+    bool Read(T& value, int maxAttempts = 100) const {
+        for (int attempt = 0; attempt < maxAttempts; attempt++) {
+            if (TryRead(value)) {
+                return true;
+            }
+            std::this_thread::yield();
+        }
+        return false;
+    }
+
+    /**
+     * @brief Get the number of values published so far
+     * @return Publication count
+     */
+    uint64_t GetVersion() const {
+        return sequenceNumber.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static const size_t kWordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> sequenceNumber{0};
+    std::atomic<uint64_t> words[kWordCount];
+};
+
+#endif // SEQLOCK_SNAPSHOT_H
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include "Trace.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+// Implementation of the pipeline trace recorder
+
+namespace Trace {
+namespace detail {
+std::atomic<bool> recording{false};
+}
+}
+
+namespace {
+
+static_assert((Trace::kEventsPerThread & (Trace::kEventsPerThread - 1)) == 0,
+              "Events per thread must be a power of two");
+
+// Fields are relaxed atomics so Stop can copy a ring while its thread keeps writing
+struct Event {
+    std::atomic<const char*> category{nullptr};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> start{0};
+    std::atomic<uint64_t> end{0};
+};
+
+struct ThreadBuffer {
+    std::unique_ptr<Event[]> events{new Event[Trace::kEventsPerThread]};
+    std::atomic<uint64_t> count{0};      // Events ever written; the ring holds the last kEventsPerThread
+    std::atomic<bool> released{false};   // The thread has exited; the buffer can be handed to a new thread
+    uint64_t sessionCount = 0;           // count when the recording started (registry mutex)
+    std::string name;                    // (registry mutex)
+    int id = 0;
+};
+
+// Copy of an event for sorting and writing
+struct EventCopy {
+    const char* category;
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+    int threadId;
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+uint64_t sessionStart = 0;
+
+// Gives the thread's buffer back when the thread exits
+struct ThreadSlot {
+    ThreadBuffer* buffer = nullptr;
+    ~ThreadSlot() {
+        if (buffer) {
+            buffer->released.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadSlot threadSlot;
+
+ThreadBuffer* RegisterThread(const std::string& name) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    ThreadBuffer* buffer = nullptr;
+    for (auto& candidate : registry) {
+        // A buffer holding events of the running recording stays with its exited thread until Stop
+        bool hasSessionEvents = Trace::IsRecording() &&
+                                candidate->count.load(std::memory_order_acquire) != candidate->sessionCount;
+        if (candidate->released.load(std::memory_order_acquire) && !hasSessionEvents) {
+            buffer = candidate.get();
+            buffer->released.store(false, std::memory_order_relaxed);
+            break;
+        }
+    }
+    if (!buffer) {
+        registry.push_back(std::make_unique<ThreadBuffer>());
+        buffer = registry.back().get();
+        buffer->id = static_cast<int>(registry.size());
+        buffer->sessionCount = buffer->count.load(std::memory_order_relaxed);
+    }
+    buffer->name = name.empty() ? "thread " + std::to_string(buffer->id) : name;
+    threadSlot.buffer = buffer;
+    return buffer;
+}
+
+void WriteJsonString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                << std::dec << std::setfill(' ');
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+namespace Trace {
+
+void SetThreadName(const std::string& name) {
+    if (threadSlot.buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        threadSlot.buffer->name = name;
+        return;
+    }
+    RegisterThread(name);
+}
+
+void Record(const char* category, const char* name, uint64_t start, uint64_t end) {
+    ThreadBuffer* buffer = threadSlot.buffer;
+    if (!buffer) {
+        buffer = RegisterThread("");
+    }
+    uint64_t index = buffer->count.load(std::memory_order_relaxed);
+    Event& event = buffer->events[index & (kEventsPerThread - 1)];
+    event.category.store(category, std::memory_order_relaxed);
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(start, std::memory_order_relaxed);
+    event.end.store(end, std::memory_order_relaxed);
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+bool Start(std::string& result) {
+    if (!IsCompiledIn()) {
+        result = "trace markers are compiled out (configure with -DENABLE_TRACING=ON)";
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (IsRecording()) {
+        result = "already recording";
+        return false;
+    }
+    for (auto& buffer : registry) {
+        buffer->sessionCount = buffer->count.load(std::memory_order_acquire);
+    }
+    sessionStart = Now();
+    detail::recording.store(true, std::memory_order_release);
+    result = "recording";
+    return true;
+}
+
+bool Stop(const std::string& filePath, std::string& result) {
+    std::vector<EventCopy> events;
+    std::vector<std::pair<int, std::string>> threads;
+    uint64_t overwritten = 0;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        if (!IsRecording()) {
+            result = "not recording";
+            return false;
+        }
+        detail::recording.store(false, std::memory_order_relaxed);
+        const uint64_t sessionEnd = Now();
+
+        for (auto& buffer : registry) {
+            // Copy the ring, then drop whatever the thread overwrote while it was being copied
+            uint64_t before = buffer->count.load(std::memory_order_acquire);
+            uint64_t first = std::max(buffer->sessionCount,
+                                      before > kEventsPerThread ? before - kEventsPerThread : 0);
+            std::vector<EventCopy> copied;
+            copied.reserve(static_cast<size_t>(before - first));
+            for (uint64_t index = first; index < before; index++) {
+                const Event& event = buffer->events[index & (kEventsPerThread - 1)];
+                copied.push_back({event.category.load(std::memory_order_relaxed),
+                                  event.name.load(std::memory_order_relaxed),
+                                  event.start.load(std::memory_order_relaxed),
+                                  event.end.load(std::memory_order_relaxed), buffer->id});
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t after = buffer->count.load(std::memory_order_relaxed);
+            uint64_t valid = after > kEventsPerThread ? after - kEventsPerThread : 0;
+
+            if (before - buffer->sessionCount > kEventsPerThread) {
+                overwritten += before - buffer->sessionCount - kEventsPerThread;
+            }
+            size_t kept = 0;
+            for (uint64_t index = first; index < before; index++) {
+                const EventCopy& event = copied[static_cast<size_t>(index - first)];
+                // Markers that were open when the recording started or stopped are left out
+                if (index >= valid && event.name && event.start >= sessionStart && event.end <= sessionEnd) {
+                    events.push_back(event);
+                    kept++;
+                }
+            }
+            if (kept > 0) {
+                threads.emplace_back(buffer->id, buffer->name);
+            }
+        }
+    }
+
+    std::sort(events.begin(), events.end(), [](const EventCopy& a, const EventCopy& b) {
+        return a.start < b.start;
+    });
+
+    std::ofstream file(filePath);
+    if (!file) {
+        result = "could not write " + filePath;
+        return false;
+    }
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU Music Player\"}}";
+    for (const auto& thread : threads) {
+        file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.first
+             << ",\"args\":{\"name\":";
+        WriteJsonString(file, thread.second);
+        file << "}}";
+    }
+    // Timestamps in microseconds from the start of the recording, to the nanosecond
+    file << std::fixed << std::setprecision(3);
+    for (const auto& event : events) {
+        file << ",\n{\"name\":";
+        WriteJsonString(file, event.name);
+        file << ",\"cat\":";
+        WriteJsonString(file, event.category ? event.category : "");
+        file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId
+             << ",\"ts\":" << (event.start - sessionStart) / 1000.0
+             << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+    }
+    file << "\n]}\n";
+    file.close();
+    if (!file) {
+        result = "could not write " + filePath;
+        return false;
+    }
+
+    std::ostringstream summary;
+    summary << events.size() << " events from " << threads.size() << (threads.size() == 1 ? " thread" : " threads")
+            << " written to " << filePath;
+    if (overwritten > 0) {
+        summary << " (" << overwritten << " older events overwritten; record shorter traces)";
+    }
+    result = summary.str();
+    return true;
+}
+
+bool IsCompiledIn() {
+#ifdef ENABLE_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace Trace
@@ -0,0 +1,490 @@
+#include "ALACDecoder.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// Implementation of the ALAC decoder; the bitstream and the arithmetic follow
+// Apple's reference decoder exactly, since a lossless decoder must reproduce
+// the encoder's predictor state bit for bit
+
+namespace {
+
+// Element types, as in AAC
+const uint32_t kElementMono = 0;      // Single channel element
+const uint32_t kElementPair = 1;      // Channel pair element
+const uint32_t kElementLfe = 3;       // Coded like a single channel element
+const uint32_t kElementData = 4;      // Data stream element, skipped
+const uint32_t kElementFill = 6;      // Fill element, skipped
+const uint32_t kElementEnd = 7;
+
+const size_t kConfigBytes = 24;
+const int kMaxChannels = 8;
+const uint32_t kMaxFrameLength = 65536;
+
+// Adaptive Rice coding
+const unsigned kHistoryShift = 9;     // Fixed-point position of the running mean
+const unsigned kMaxPrefix = 9;        // A unary prefix this long escapes to a plain value
+const unsigned kRunEscapeBits = 16;   // Size of an escaped run length
+const uint32_t kMaxHistory = 0xffff;
+const uint32_t kRunThreshold = 128;   // Below this mean, a run of zeros may follow
+
+// For each channel count, the WAV channel each ALAC channel goes to, and the speaker mask.
+// ALAC orders channels C L R ... (see ALACAudioTypes.h)
+struct ChannelOrder {
+    uint32_t mask;
+    unsigned char target[8];
+};
+
+const ChannelOrder kAlacOrders[kMaxChannels] = {
+    {0x4, {0}},                          // C
+    {0x3, {0, 1}},                       // L R
+    {0x7, {2, 0, 1}},                    // C L R
+    {0x107, {2, 0, 1, 3}},               // C L R Cs
+    {0x37, {2, 0, 1, 3, 4}},             // C L R Ls Rs
+    {0x3F, {2, 0, 1, 4, 5, 3}},          // C L R Ls Rs LFE
+    {0x70F, {2, 0, 1, 5, 6, 4, 3}},      // C L R Ls Rs Cs LFE
+    {0xFF, {2, 6, 7, 0, 1, 4, 5, 3}},    // C Lc Rc L R Ls Rs LFE
+};
+
+uint32_t ReadBE32(const unsigned char* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+// Keep the low bits of a value and extend its sign
+int32_t SignExtend(uint32_t value, unsigned bits) {
+    const unsigned shift = 32 - bits;
+    return static_cast<int32_t>(value << shift) >> shift;
+}
+
+int32_t SignOf(int32_t value) {
+    return (value > 0) - (value < 0);
+}
+
+unsigned CountLeadingZeros(uint32_t value) {
+    unsigned count = 0;
+    for (uint32_t bit = 0x80000000u; bit != 0 && !(value & bit); bit >>= 1) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Undo the adaptive predictor of one channel
+ *
+ * Order 0 copies the residuals and order 31 sums them (first-order
+ * prediction); other orders predict from the last order samples and nudge
+ * each coefficient by the sign of the residual, as the encoder did. Sums wrap
+ * at 32 bits like the reference's.
+ * @param residuals Residuals (may be the same buffer as out for orders 0 and 31)
+ * @param out Receives the samples
+ * @param count Number of samples
+ * @param coefficients Predictor coefficients, updated in place
+ * @param order Predictor order
+ * @param chanBits Significant bits of the samples
+ * @param denShift Quantization of the coefficients
+ */
+void Unpredict(const int32_t* residuals, int32_t* out, uint32_t count, int16_t* coefficients, unsigned order,
+               unsigned chanBits, unsigned denShift) {
+    if (count == 0) {
+        return;
+    }
+    out[0] = residuals[0];
+    if (order == 0) {
+        if (out != residuals) {
+            std::copy(residuals + 1, residuals + count, out + 1);
+        }
+        return;
+    }
+    if (order == 31) {
+        int32_t previous = out[0];
+        for (uint32_t j = 1; j < count; j++) {
+            previous = SignExtend(static_cast<uint32_t>(residuals[j]) + static_cast<uint32_t>(previous), chanBits);
+            out[j] = previous;
+        }
+        return;
+    }
+
+    for (uint32_t j = 1; j <= order && j < count; j++) {
+        out[j] = SignExtend(static_cast<uint32_t>(residuals[j]) + static_cast<uint32_t>(out[j - 1]), chanBits);
+    }
+
+    const uint32_t rounding = denShift > 0 ? 1u << (denShift - 1) : 0;
+    for (uint32_t j = order + 1; j < count; j++) {
+        // Predict from the differences between the last order samples and the one before them
+        const int32_t* history = out + j - 1;
+        const int32_t top = out[j - order - 1];
+        uint32_t sum = 0;
+        for (unsigned k = 0; k < order; k++) {
+            sum += static_cast<uint32_t>(coefficients[k]) *
+                   (static_cast<uint32_t>(history[-static_cast<int>(k)]) - static_cast<uint32_t>(top));
+        }
+        const int32_t prediction = static_cast<int32_t>(sum + rounding) >> denShift;
+
+        const int32_t residual = residuals[j];
+        out[j] = SignExtend(static_cast<uint32_t>(residual) + static_cast<uint32_t>(top) +
+                            static_cast<uint32_t>(prediction), chanBits);
+
+        // Move the coefficients towards a smaller residual, oldest sample first, until the
+        // residual is used up
+        const int32_t sign = SignOf(residual);
+        int32_t remaining = residual;
+        for (unsigned k = order; sign != 0 && k-- > 0;) {
+            const int32_t difference = static_cast<int32_t>(static_cast<uint32_t>(top) -
+                                                            static_cast<uint32_t>(history[-static_cast<int>(k)]));
+            const int32_t step = SignOf(difference) * sign;
+            coefficients[k] = static_cast<int16_t>(coefficients[k] - step);
+            remaining = static_cast<int32_t>(static_cast<uint32_t>(remaining) -
+                                             (order - k) * static_cast<uint32_t>((step * difference) >> denShift));
+            if (sign > 0 ? remaining <= 0 : remaining >= 0) {
+                break;
+            }
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Big-endian bit reader over a packet; bits past its end read as zeros
+ */
+class ALACDecoder::BitReader {
+public:
+    BitReader(const unsigned char* data, size_t size) : data(data), size(size) {}
+
+    // At least the next 57 bits, starting at the most significant bit
+    uint64_t Peek() const {
+        const size_t byte = position >> 3;
+        uint64_t value = 0;
+        if (byte + 8 <= size) {
+            for (size_t i = 0; i < 8; i++) {
+                value = (value << 8) | data[byte + i];
+            }
+        } else {
+            for (size_t i = 0; i < 8; i++) {
+                value = (value << 8) | (byte + i < size ? data[byte + i] : 0);
+            }
+        }
+        return value << (position & 7);
+    }
+
+    // Read up to 32 bits
+    uint32_t Read(unsigned count) {
+        if (count == 0) {
+            return 0;
+        }
+        const uint32_t value = static_cast<uint32_t>(Peek() >> (64 - count));
+        position += count;
+        return value;
+    }
+
+    /**
+     * @brief Read one adaptive Golomb-Rice code
+     *
+     * A unary prefix q (ones ended by a zero) and k more bits v give
+     * q * m + v - 1; when v is below 2 only k - 1 of those bits belong to the
+     * code and the value is q * m. A prefix of kMaxPrefix ones (no zero) is
+     * followed by the value itself in escapeBits bits.
+     */
+    uint32_t ReadRice(uint32_t m, unsigned k, unsigned escapeBits) {
+        const uint64_t window = Peek();
+        unsigned prefix = 0;
+        while (prefix < kMaxPrefix && ((window >> (63 - prefix)) & 1)) {
+            prefix++;
+        }
+        if (prefix == kMaxPrefix) {
+            position += kMaxPrefix;
+            return Read(escapeBits);
+        }
+        const uint32_t v = static_cast<uint32_t>((window << (prefix + 1)) >> (64 - k));
+        if (v < 2) {
+            position += prefix + k;
+            return prefix * m;
+        }
+        position += prefix + 1 + k;
+        return prefix * m + v - 1;
+    }
+
+    void Skip(size_t count) { position += count; }
+    void AlignToByte() { position = (position + 7) & ~static_cast<size_t>(7); }
+    bool Overrun() const { return position > size * 8; }
+
+private:
+    const unsigned char* data;
+    size_t size;
+    size_t position = 0;
+};
+
+ALACDecoder::ALACDecoder() = default;
+
+ALACDecoder::~ALACDecoder() = default;
+
+bool ALACDecoder::Initialize(const std::vector<unsigned char>& config, int, int) {
+    // Accept the configuration alone or inside its atom (size, 'alac', version and flags)
+    const unsigned char* cookie = config.data();
+    size_t size = config.size();
+    if (size >= 12 + kConfigBytes && std::memcmp(cookie + 4, "alac", 4) == 0) {
+        cookie += 12;
+        size -= 12;
+    }
+    if (size < kConfigBytes) {
+        std::cout << "Error: ALAC configuration is too short (" << size << " bytes)\n";
+        return false;
+    }
+
+    frameLength = ReadBE32(cookie);
+    const unsigned compatibleVersion = cookie[4];
+    bitDepth = cookie[5];
+    historyMult = cookie[6];
+    initialHistory = cookie[7];
+    riceLimit = cookie[8];
+    channels = cookie[9];
+    sampleRate = ReadBE32(cookie + 20);
+
+    if (compatibleVersion != 0 || (bitDepth != 16 && bitDepth != 20 && bitDepth != 24 && bitDepth != 32) ||
+        channels < 1 || channels > kMaxChannels || frameLength == 0 || frameLength > kMaxFrameLength ||
+        riceLimit == 0 || riceLimit > 31 || sampleRate == 0) {
+        std::cout << "Error: Unsupported ALAC configuration (version " << compatibleVersion << ", " << bitDepth
+                  << "-bit, " << channels << " channels, " << frameLength << " frames per packet)\n";
+        frameLength = 0;
+        return false;
+    }
+
+    residuals.assign(frameLength, 0);
+    mixU.assign(frameLength, 0);
+    mixV.assign(frameLength, 0);
+    lowBytes.assign(static_cast<size_t>(frameLength) * 2, 0);
+    return true;
+}
+
+unsigned ALACDecoder::GetBitsPerSample() const {
+    return bitDepth == 20 ? 24 : bitDepth;
+}
+
+ChannelLayout ALACDecoder::GetLayout() const {
+    return ChannelLayout::FromMask(channels >= 1 && channels <= kMaxChannels ? kAlacOrders[channels - 1].mask : 0,
+                                   channels);
+}
+
+bool ALACDecoder::Decode(const unsigned char* packet, size_t size, PcmBufferView output, size_t& frames) {
+    frames = 0;
+    if (frameLength == 0 || output.Channels() != channels || output.BitsPerSample() != GetBitsPerSample() ||
+        output.IsFloat() || output.Frames() < frameLength) {
+        return false;
+    }
+
+    // Elements follow each other until every channel is decoded
+    BitReader bits(packet, size);
+    int channelIndex = 0;
+    size_t elementFrames = 0;
+    while (channelIndex < channels) {
+        const uint32_t type = bits.Read(3);
+        if (type == kElementMono || type == kElementLfe || type == kElementPair) {
+            if (!DecodeElement(bits, type == kElementPair, output, channelIndex, elementFrames)) {
+                return false;
+            }
+        } else if (type == kElementData) {
+            bits.Skip(4);
+            const bool aligned = bits.Read(1) != 0;
+            size_t count = bits.Read(8);
+            if (count == 255) {
+                count += bits.Read(8);
+            }
+            if (aligned) {
+                bits.AlignToByte();
+            }
+            bits.Skip(count * 8);
+        } else if (type == kElementFill) {
+            size_t count = bits.Read(4);
+            if (count == 15) {
+                count += bits.Read(8) - 1;
+            }
+            bits.Skip(count * 8);
+        } else {
+            // The end element before all channels, or coupling and program elements, which ALAC never writes
+            return false;
+        }
+        if (bits.Overrun()) {
+            return false;
+        }
+    }
+    frames = elementFrames;
+    return true;
+}
+
+void ALACDecoder::ReadParameters(BitReader& bits, ChannelParameters& parameters) {
+    uint32_t header = bits.Read(8);
+    parameters.mode = header >> 4;
+    parameters.denShift = header & 0xf;
+    header = bits.Read(8);
+    parameters.historyFactor = header >> 5;
+    parameters.order = header & 0x1f;
+    for (unsigned i = 0; i < parameters.order; i++) {
+        parameters.coefficients[i] = static_cast<int16_t>(bits.Read(16));
+    }
+}
+
+bool ALACDecoder::DecodeResiduals(BitReader& bits, int32_t* out, uint32_t count, unsigned chanBits,
+                                  unsigned historyFactor) {
+    // The Rice parameter follows a running mean of the coded values (in 9-bit fixed point)
+    const uint32_t multiplier = historyMult * historyFactor / 4;
+    const uint32_t runMask = (1u << riceLimit) - 1;
+    uint32_t history = initialHistory;
+    uint32_t afterRun = 0;    // 1 after a short run of zeros: the next value cannot be 0
+    uint32_t i = 0;
+    while (i < count) {
+        if (bits.Overrun()) {
+            return false;
+        }
+        // k = floor(log2(mean + 3)), at most riceLimit
+        uint32_t scaled = (history >> kHistoryShift) + 3;
+        unsigned k = 0;
+        while (scaled >>= 1) {
+            k++;
+        }
+        k = std::min(k, riceLimit);
+        const uint32_t value = bits.ReadRice((1u << k) - 1, k, chanBits);
+
+        // The lowest bit of the coded value is the sign
+        const uint32_t coded = value + afterRun;
+        const uint32_t magnitude = (coded + 1) >> 1;
+        out[i++] = (coded & 1) ? -static_cast<int32_t>(magnitude) : static_cast<int32_t>(magnitude);
+
+        history = multiplier * coded + history - ((multiplier * history) >> kHistoryShift);
+        if (value > kMaxHistory) {
+            history = kMaxHistory;
+        }
+        afterRun = 0;
+
+        // A small mean announces a run of zeros
+        if (history < kRunThreshold && i < count) {
+            const unsigned runK = CountLeadingZeros(history) - 24 + ((history + 16) >> 6);
+            const uint32_t run = bits.ReadRice(((1u << runK) - 1) & runMask, runK, kRunEscapeBits);
+            if (run > count - i) {
+                return false;
+            }
+            std::fill(out + i, out + i + run, 0);
+            i += run;
+            afterRun = run < 65535 ? 1 : 0;
+            history = 0;
+        }
+    }
+    return true;
+}
+
+bool ALACDecoder::DecodeElement(BitReader& bits, bool pair, PcmBufferView output, int& channelIndex,
+                                size_t& frames) {
+    const int elementChannels = pair ? 2 : 1;
+    if (channelIndex + elementChannels > channels) {
+        return false;
+    }
+
+    // Instance tag, 12 unused bits, then partial frame, shifted bytes and escape flags
+    bits.Skip(4);
+    if (bits.Read(12) != 0) {
+        return false;
+    }
+    const uint32_t header = bits.Read(4);
+    const bool partial = (header & 0x8) != 0;
+    unsigned shift = ((header >> 1) & 0x3) * 8;
+    const bool escape = (header & 0x1) != 0;
+
+    const uint32_t count = partial ? bits.Read(32) : frameLength;
+    if (count == 0 || count > frameLength || (frames != 0 && count != frames)) {
+        return false;
+    }
+
+    int32_t* const samples[2] = {mixU.data(), mixV.data()};
+    if (!escape) {
+        // A channel pair is coded as a mix and a difference, which takes one more bit
+        if (shift >= bitDepth) {
+            return false;
+        }
+        const unsigned chanBits = bitDepth - shift + (pair ? 1 : 0);
+        if (chanBits > 32) {
+            return false;
+        }
+        const uint32_t mixBits = bits.Read(8);
+        const int32_t mixRes = static_cast<int8_t>(bits.Read(8));
+        ChannelParameters parameters[2];
+        for (int c = 0; c < elementChannels; c++) {
+            ReadParameters(bits, parameters[c]);
+        }
+
+        // The uncompressed low bytes come first; read them after the residuals
+        BitReader lowBits = bits;
+        bits.Skip(static_cast<size_t>(shift) * elementChannels * count);
+
+        for (int c = 0; c < elementChannels; c++) {
+            if (!DecodeResiduals(bits, residuals.data(), count, chanBits, parameters[c].historyFactor)) {
+                return false;
+            }
+            if (parameters[c].mode != 0) {
+                Unpredict(residuals.data(), residuals.data(), count, nullptr, 31, chanBits, 0);
+            }
+            Unpredict(residuals.data(), samples[c], count, parameters[c].coefficients, parameters[c].order,
+                      chanBits, parameters[c].denShift);
+        }
+
+        if (shift > 0) {
+            for (size_t i = 0; i < static_cast<size_t>(count) * elementChannels; i++) {
+                lowBytes[i] = static_cast<uint16_t>(lowBits.Read(shift));
+            }
+        }
+
+        // Left = u + v - (mixRes * v >> mixBits), right = left - v
+        if (pair && mixRes != 0) {
+            if (mixBits > 31) {
+                return false;
+            }
+            for (uint32_t i = 0; i < count; i++) {
+                const int32_t u = mixU[i];
+                const int32_t v = mixV[i];
+                const int32_t left = static_cast<int32_t>(
+                    static_cast<uint32_t>(u) + static_cast<uint32_t>(v) -
+                    static_cast<uint32_t>(static_cast<int32_t>(static_cast<uint32_t>(mixRes) *
+                                                               static_cast<uint32_t>(v)) >> mixBits));
+                mixU[i] = left;
+                mixV[i] = static_cast<int32_t>(static_cast<uint32_t>(left) - static_cast<uint32_t>(v));
+            }
+        }
+    } else {
+        // Escape: plain samples, interleaved for a pair
+        for (uint32_t i = 0; i < count; i++) {
+            for (int c = 0; c < elementChannels; c++) {
+                samples[c][i] = SignExtend(bits.Read(bitDepth), bitDepth);
+            }
+        }
+        shift = 0;
+    }
+    if (bits.Overrun()) {
+        return false;
+    }
+
+    for (int c = 0; c < elementChannels; c++) {
+        WriteChannel(samples[c], lowBytes.data() + c, elementChannels, shift, count, output, channelIndex + c);
+    }
+    channelIndex += elementChannels;
+    frames = count;
+    return true;
+}
+
+void ALACDecoder::WriteChannel(const int32_t* samples, const uint16_t* low, size_t lowStride, unsigned shift,
+                               uint32_t count, PcmBufferView output, int channel) const {
+    // Put the ALAC channel in its WAV position, and 20-bit samples at the top of 24 bits
+    const int target = kAlacOrders[channels - 1].target[channel];
+    const size_t bytes = output.BytesPerSample();
+    const size_t stride = output.BlockAlign();
+    const unsigned justify = bytes * 8 - bitDepth;
+    char* out = output.Data() + static_cast<size_t>(target) * bytes;
+    for (uint32_t i = 0; i < count; i++, out += stride) {
+        uint32_t value = static_cast<uint32_t>(samples[i]);
+        if (shift > 0) {
+            value = (value << shift) | low[i * lowStride];
+        }
+        value <<= justify;
+        for (size_t b = 0; b < bytes; b++) {
+            out[b] = static_cast<char>(value >> (8 * b));
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef ALAC_DECODER_H
+#define ALAC_DECODER_H
+
+#include "IPacketDecoder.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Apple Lossless (ALAC) packet decoder
+ *
+ * Decodes the channel elements of each packet: adaptive Golomb-Rice coded
+ * residuals (with runs of zeros), the adaptive LPC predictor, stereo
+ * unmixing, the low bytes sent uncompressed for 24- and 32-bit streams, and
+ * uncompressed escape packets. Samples come out exactly as encoded, in 16-,
+ * 24- (also for 20-bit streams, left-justified) or 32-bit containers, with
+ * the channels moved from ALAC order to WAV order. All buffers are sized by
+ * Initialize, so decoding allocates nothing.
+ */
+class ALACDecoder : public IPacketDecoder {
+public:
+    ALACDecoder();
+    ~ALACDecoder() override;
+
+    /**
+     * @brief Configure the decoder from the ALACSpecificConfig ("magic cookie")
+     * @param config The 24-byte configuration, optionally preceded by the 'alac' atom header
+     * @param channels Ignored; the configuration gives the channel count
+     * @param sampleRate Ignored; the configuration gives the sample rate
+     * @return true if the configuration is valid, false otherwise
+     */
+    bool Initialize(const std::vector<unsigned char>& config, int channels, int sampleRate) override;
+
+    bool Decode(const unsigned char* packet, size_t size, PcmBufferView output, size_t& frames) override;
+
+    /**
+     * @brief Nothing to reset; ALAC packets are independent
+     */
+    void Reset() override {}
+
+    int GetSampleRate() const override { return static_cast<int>(sampleRate); }
+    int GetChannels() const override { return channels; }
+    unsigned GetBitsPerSample() const override;
+    unsigned GetValidBits() const override { return bitDepth; }
+    bool IsFloat() const override { return false; }
+    size_t GetMaxFrames() const override { return frameLength; }
+    ChannelLayout GetLayout() const override;
+    std::string GetName() const override { return "ALAC"; }
+
+private:
+    /**
+     * @brief Parameters of one channel's residual coding and prediction
+     */
+    struct ChannelParameters {
+        unsigned mode = 0;          // 0: one predictor pass; otherwise a first-order pass before it
+        unsigned denShift = 0;      // Quantization of the predictor coefficients
+        unsigned historyFactor = 0; // Scales the Rice history multiplier, in quarters
+        unsigned order = 0;         // Predictor order (31: first-order difference only)
+        int16_t coefficients[32] = {};
+    };
+
+    class BitReader;
+
+    bool DecodeElement(BitReader& bits, bool pair, PcmBufferView output, int& channelIndex, size_t& frames);
+    void ReadParameters(BitReader& bits, ChannelParameters& parameters);
+    bool DecodeResiduals(BitReader& bits, int32_t* residuals, uint32_t count, unsigned chanBits,
+                         unsigned historyFactor);
+    void WriteChannel(const int32_t* samples, const uint16_t* lowBytes, size_t lowStride, unsigned shift,
+                      uint32_t count, PcmBufferView output, int channel) const;
+
+    // ALACSpecificConfig
+    uint32_t frameLength = 0;       // Frames per packet (a partial packet says how many it holds)
+    unsigned bitDepth = 0;
+    unsigned historyMult = 0;       // pb: Rice history multiplier
+    unsigned initialHistory = 0;    // mb
+    unsigned riceLimit = 0;         // kb: largest Rice parameter
+    int channels = 0;
+    uint32_t sampleRate = 0;
+
+    // Per-channel work buffers of frameLength samples
+    std::vector<int32_t> residuals;
+    std::vector<int32_t> mixU;
+    std::vector<int32_t> mixV;
+    std::vector<uint16_t> lowBytes; // Uncompressed low bytes, interleaved for channel pairs
+};
+
+#endif // ALAC_DECODER_H
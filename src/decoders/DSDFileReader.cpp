@@ -0,0 +1,317 @@
+#include "DSDFileReader.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// Implementation of the DSF and DSDIFF readers
+
+namespace {
+
+uint32_t ReadLE32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t ReadLE64(const uint8_t* p) {
+    return ReadLE32(p) | (static_cast<uint64_t>(ReadLE32(p + 4)) << 32);
+}
+
+uint32_t ReadBE32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+uint64_t ReadBE64(const uint8_t* p) {
+    return (static_cast<uint64_t>(ReadBE32(p)) << 32) | ReadBE32(p + 4);
+}
+
+bool ReadBytes(std::ifstream& file, uint8_t* data, size_t size) {
+    file.read(reinterpret_cast<char*>(data), size);
+    return static_cast<size_t>(file.gcount()) == size;
+}
+
+// DSF "channel type" field to WAVE_FORMAT_EXTENSIBLE speaker mask
+uint32_t DsfChannelMask(uint32_t channelType) {
+    switch (channelType) {
+        case 1: return 0x4;     // Mono
+        case 2: return 0x3;     // Stereo
+        case 3: return 0x7;     // 3 channels
+        case 4: return 0x33;    // Quad
+        case 5: return 0xF;     // 4 channels (FL FR FC LFE)
+        case 6: return 0x37;    // 5 channels
+        case 7: return 0x3F;    // 5.1
+        default: return 0;
+    }
+}
+
+// DSDIFF channel ID to speaker mask bit
+uint32_t DffSpeakerBit(const char* id) {
+    if (std::memcmp(id, "SLFT", 4) == 0 || std::memcmp(id, "MLFT", 4) == 0) return 0x1;
+    if (std::memcmp(id, "SRGT", 4) == 0 || std::memcmp(id, "MRGT", 4) == 0) return 0x2;
+    if (std::memcmp(id, "C   ", 4) == 0) return 0x4;
+    if (std::memcmp(id, "LFE ", 4) == 0) return 0x8;
+    if (std::memcmp(id, "LS  ", 4) == 0) return 0x10;
+    if (std::memcmp(id, "RS  ", 4) == 0) return 0x20;
+    return 0;
+}
+
+} // namespace
+
+class DSDFileReader::Impl {
+public:
+    std::ifstream file;
+    bool isDsf = false;
+    int sampleRate = 0;
+    int channels = 0;
+    uint64_t sampleCount = 0;
+    ChannelLayout layout;
+
+    uint64_t bytesPerChannel = 0;    // Total stream length
+    uint64_t bytesRead = 0;          // Per channel, so far
+
+    // DSF: one group of per-channel blocks
+    uint32_t blockSize = 0;
+    bool lsbFirst = false;
+    std::vector<uint8_t> blockGroup;
+    size_t blockPosition = 0;
+    uint8_t bitReverse[256];
+
+    bool OpenDsf() {
+        uint8_t header[28];
+        if (!ReadBytes(file, header, sizeof(header)) || ReadLE64(header + 4) != 28) {
+            std::cout << "Error: Invalid DSF header\n";
+            return false;
+        }
+
+        uint8_t fmt[52];
+        if (!ReadBytes(file, fmt, sizeof(fmt)) || std::memcmp(fmt, "fmt ", 4) != 0) {
+            std::cout << "Error: DSF file has no fmt chunk\n";
+            return false;
+        }
+        const uint32_t formatId = ReadLE32(fmt + 16);
+        const uint32_t channelType = ReadLE32(fmt + 20);
+        channels = static_cast<int>(ReadLE32(fmt + 24));
+        sampleRate = static_cast<int>(ReadLE32(fmt + 28));
+        const uint32_t bitsPerSample = ReadLE32(fmt + 32);
+        sampleCount = ReadLE64(fmt + 36);
+        blockSize = ReadLE32(fmt + 44);
+        if (formatId != 0 || (bitsPerSample != 1 && bitsPerSample != 8) || channels <= 0 || channels > 6 ||
+            blockSize == 0 || sampleRate <= 0) {
+            std::cout << "Error: Unsupported DSF format (id " << formatId << ", " << bitsPerSample << " bits, "
+                      << channels << " channels)\n";
+            return false;
+        }
+        lsbFirst = bitsPerSample == 1;
+
+        // Skip any fmt chunk extension, then find the data chunk
+        file.seekg(28 + ReadLE64(fmt + 4));
+        uint8_t data[12];
+        if (!ReadBytes(file, data, sizeof(data)) || std::memcmp(data, "data", 4) != 0) {
+            std::cout << "Error: DSF file has no data chunk\n";
+            return false;
+        }
+
+        // The data chunk size covers whole blocks; the sample count excludes the padding
+        const uint64_t storedPerChannel = (ReadLE64(data + 4) - 12) / channels;
+        bytesPerChannel = std::min<uint64_t>((sampleCount + 7) / 8, storedPerChannel);
+        layout = ChannelLayout::FromMask(DsfChannelMask(channelType), channels);
+        blockGroup.assign(static_cast<size_t>(blockSize) * channels, 0);
+        blockPosition = blockSize;
+        return true;
+    }
+
+    bool OpenDff() {
+        uint8_t header[12];
+        if (!ReadBytes(file, header, sizeof(header)) || std::memcmp(header + 8, "DSD ", 4) != 0) {
+            std::cout << "Error: DSDIFF file is not a DSD form\n";
+            return false;
+        }
+
+        bool compressed = false;
+        while (true) {
+            uint8_t chunk[12];
+            if (!ReadBytes(file, chunk, sizeof(chunk))) {
+                std::cout << "Error: DSDIFF file has no sound data\n";
+                return false;
+            }
+            const uint64_t size = ReadBE64(chunk + 4);
+            const std::streamoff next = static_cast<std::streamoff>(file.tellg()) + size + (size & 1);
+
+            if (std::memcmp(chunk, "PROP", 4) == 0) {
+                if (!ReadProperties(size, compressed)) {
+                    return false;
+                }
+            } else if (std::memcmp(chunk, "DSD ", 4) == 0) {
+                if (sampleRate <= 0 || channels <= 0) {
+                    std::cout << "Error: DSDIFF sound data precedes its properties\n";
+                    return false;
+                }
+                bytesPerChannel = size / channels;
+                sampleCount = bytesPerChannel * 8;
+                return true;   // Positioned at the first sample
+            } else if (std::memcmp(chunk, "DST ", 4) == 0 || compressed) {
+                std::cout << "Error: DST-compressed DSDIFF is not supported\n";
+                return false;
+            }
+            file.seekg(next);
+        }
+    }
+
+    bool ReadProperties(uint64_t size, bool& compressed) {
+        uint8_t type[4];
+        if (!ReadBytes(file, type, 4) || std::memcmp(type, "SND ", 4) != 0) {
+            return true;   // Not a sound property chunk
+        }
+
+        uint64_t offset = 4;
+        uint32_t mask = 0;
+        bool ordered = true;
+        while (offset + 12 <= size) {
+            uint8_t chunk[12];
+            if (!ReadBytes(file, chunk, sizeof(chunk))) {
+                return false;
+            }
+            const uint64_t chunkSize = ReadBE64(chunk + 4);
+            std::vector<uint8_t> body(static_cast<size_t>(std::min<uint64_t>(chunkSize, 1 << 16)));
+            if (!ReadBytes(file, body.data(), body.size())) {
+                return false;
+            }
+            file.seekg(static_cast<std::streamoff>(chunkSize - body.size() + (chunkSize & 1)), std::ios::cur);
+            offset += 12 + chunkSize + (chunkSize & 1);
+
+            if (std::memcmp(chunk, "FS  ", 4) == 0 && body.size() >= 4) {
+                sampleRate = static_cast<int>(ReadBE32(body.data()));
+            } else if (std::memcmp(chunk, "CHNL", 4) == 0 && body.size() >= 2) {
+                channels = (body[0] << 8) | body[1];
+                for (int channel = 0; channel < channels && 2 + channel * 4 + 4 <= static_cast<int>(body.size()); channel++) {
+                    uint32_t bit = DffSpeakerBit(reinterpret_cast<const char*>(&body[2 + channel * 4]));
+                    ordered = ordered && bit > mask;
+                    mask |= bit;
+                }
+            } else if (std::memcmp(chunk, "CMPR", 4) == 0 && body.size() >= 4) {
+                compressed = std::memcmp(body.data(), "DSD ", 4) != 0;
+            }
+        }
+
+        // Speaker IDs map onto a mask only when they appear in mask order
+        layout = ordered ? ChannelLayout::FromMask(mask, channels) : ChannelLayout::Default(channels);
+        return true;
+    }
+
+    size_t ReadDsf(uint8_t* bytes, size_t count) {
+        size_t done = 0;
+        while (done < count) {
+            if (blockPosition == blockSize) {
+                file.read(reinterpret_cast<char*>(blockGroup.data()), blockGroup.size());
+                if (file.gcount() <= 0) {
+                    break;
+                }
+                blockPosition = 0;
+            }
+
+            const size_t n = std::min(count - done, static_cast<size_t>(blockSize) - blockPosition);
+            for (int channel = 0; channel < channels; channel++) {
+                const uint8_t* source = &blockGroup[static_cast<size_t>(channel) * blockSize + blockPosition];
+                uint8_t* destination = bytes + done * channels + channel;
+                for (size_t i = 0; i < n; i++) {
+                    destination[i * channels] = lsbFirst ? bitReverse[source[i]] : source[i];
+                }
+            }
+            blockPosition += n;
+            done += n;
+        }
+        return done;
+    }
+};
+
+DSDFileReader::DSDFileReader() : pImpl(std::make_unique<Impl>()) {
+    for (int value = 0; value < 256; value++) {
+        uint8_t reversed = 0;
+        for (int bit = 0; bit < 8; bit++) {
+            reversed |= ((value >> bit) & 1) << (7 - bit);
+        }
+        pImpl->bitReverse[value] = reversed;
+    }
+}
+
+DSDFileReader::~DSDFileReader() = default;
+
+bool DSDFileReader::Open(const std::string& filePath) {
+    Close();
+    pImpl->file.open(filePath, std::ios::binary);
+    if (!pImpl->file.is_open()) {
+        std::cout << "Error: Could not open file for reading: " << filePath << "\n";
+        return false;
+    }
+
+    char magic[4] = {};
+    pImpl->file.read(magic, 4);
+    pImpl->file.seekg(0);
+    bool opened = false;
+    if (std::memcmp(magic, "DSD ", 4) == 0) {
+        pImpl->isDsf = true;
+        opened = pImpl->OpenDsf();
+    } else if (std::memcmp(magic, "FRM8", 4) == 0) {
+        pImpl->isDsf = false;
+        pImpl->file.seekg(4);
+        opened = pImpl->OpenDff();
+    } else {
+        std::cout << "Error: Not a DSF or DSDIFF file: " << filePath << "\n";
+    }
+
+    if (!opened) {
+        Close();
+    }
+    return opened;
+}
+
+size_t DSDFileReader::Read(uint8_t* bytes, size_t bytesPerChannel) {
+    if (!pImpl->file.is_open()) {
+        return 0;
+    }
+
+    const size_t count = static_cast<size_t>(std::min<uint64_t>(bytesPerChannel,
+                                                                pImpl->bytesPerChannel - pImpl->bytesRead));
+    size_t done = 0;
+    if (pImpl->isDsf) {
+        done = pImpl->ReadDsf(bytes, count);
+    } else {
+        pImpl->file.read(reinterpret_cast<char*>(bytes), count * pImpl->channels);
+        done = static_cast<size_t>(pImpl->file.gcount()) / pImpl->channels;
+    }
+    pImpl->bytesRead += done;
+    return done;
+}
+
+void DSDFileReader::Close() {
+    if (pImpl->file.is_open()) {
+        pImpl->file.close();
+    }
+    pImpl->file.clear();
+    pImpl->sampleRate = 0;
+    pImpl->channels = 0;
+    pImpl->sampleCount = 0;
+    pImpl->bytesPerChannel = 0;
+    pImpl->bytesRead = 0;
+    pImpl->layout = ChannelLayout();
+}
+
+int DSDFileReader::GetSampleRate() const {
+    return pImpl->sampleRate;
+}
+
+int DSDFileReader::GetChannels() const {
+    return pImpl->channels;
+}
+
+uint64_t DSDFileReader::GetSampleCount() const {
+    return pImpl->sampleCount;
+}
+
+ChannelLayout DSDFileReader::GetLayout() const {
+    return pImpl->layout;
+}
+
+std::string DSDFileReader::GetFormatName() const {
+    return pImpl->isDsf ? "DSF" : "DSDIFF";
+}
@@ -0,0 +1,79 @@
+#ifndef DSD_FILE_READER_H
+#define DSD_FILE_READER_H
+
+#include "dsp/ChannelLayout.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Streaming reader for DSD files (Sony DSF and Philips DSDIFF/DFF)
+ *
+ * Both containers are returned in one form: byte-interleaved 1-bit data
+ * (one byte per channel in turn), most significant bit first, which is what
+ * DSDConverter consumes. DSF stores each channel in 4096-byte blocks with
+ * the least significant bit first; the reader reinterleaves and bit-reverses
+ * those. Compressed DSDIFF (DST) is not supported.
+ */
+class DSDFileReader {
+public:
+    /**
+     * @brief Constructor
+     */
+    DSDFileReader();
+
+    /**
+     * @brief Destructor
+     */
+    ~DSDFileReader();
+
+    /**
+     * @brief Open a DSF or DFF file and parse its header
+     * @param filePath Path to the file; the container is detected from its contents
+     * @return true if successful, false otherwise
+     */
+    bool Open(const std::string& filePath);
+
+    /**
+     * @brief Read the next block of DSD data
+     * @param bytes Receives bytesPerChannel * channels byte-interleaved bytes
+     * @param bytesPerChannel Maximum number of bytes per channel to read
+     * @return Number of bytes per channel read, 0 at the end of the stream
+     */
+    size_t Read(uint8_t* bytes, size_t bytesPerChannel);
+
+    /**
+     * @brief Close the file
+     */
+    void Close();
+
+    /**
+     * @brief Get the DSD bit rate per channel in Hz (e.g. 2822400 for DSD64)
+     */
+    int GetSampleRate() const;
+
+    int GetChannels() const;
+
+    /**
+     * @brief Get the stream length in bits (samples) per channel
+     */
+    uint64_t GetSampleCount() const;
+
+    /**
+     * @brief Get the speaker layout declared by the file
+     */
+    ChannelLayout GetLayout() const;
+
+    /**
+     * @brief Get the container name, "DSF" or "DSDIFF"
+     */
+    std::string GetFormatName() const;
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // DSD_FILE_READER_H
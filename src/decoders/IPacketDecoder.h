@@ -0,0 +1,81 @@
+#ifndef I_PACKET_DECODER_H
+#define I_PACKET_DECODER_H
+
+#include "AudioBufferView.h"
+#include "dsp/ChannelLayout.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Interface for codecs that decode one container packet at a time
+ *
+ * The demuxer hands each packet over whole, so a codec keeps no file state
+ * and can be shared by any container that stores it. Output is PCM in the
+ * codec's own sample format: lossless codecs return their exact integer
+ * samples, lossy ones may return floats. Channels are returned in WAV order.
+ */
+class IPacketDecoder {
+public:
+    /**
+     * @brief Destructor
+     */
+    virtual ~IPacketDecoder() = default;
+
+    /**
+     * @brief Configure the codec from the container's codec configuration
+     * @param config Codec configuration (e.g. the ALAC magic cookie or the AAC AudioSpecificConfig)
+     * @param channels Channel count from the container, used if the configuration has none
+     * @param sampleRate Sample rate from the container, used if the configuration has none
+     * @return true if the codec can decode the stream, false otherwise
+     */
+    virtual bool Initialize(const std::vector<unsigned char>& config, int channels, int sampleRate) = 0;
+
+    /**
+     * @brief Decode one packet
+     * @param packet Packet data
+     * @param size Packet size in bytes
+     * @param output Receives the frames; must hold GetMaxFrames() frames in the codec's format
+     * @param frames Receives the number of frames decoded
+     * @return true if successful, false if the packet is damaged
+     */
+    virtual bool Decode(const unsigned char* packet, size_t size, PcmBufferView output, size_t& frames) = 0;
+
+    /**
+     * @brief Forget the state carried between packets, before decoding from another position
+     */
+    virtual void Reset() = 0;
+
+    virtual int GetSampleRate() const = 0;
+    virtual int GetChannels() const = 0;
+
+    /**
+     * @brief Get the container size of the decoded samples: 16, 24 or 32
+     */
+    virtual unsigned GetBitsPerSample() const = 0;
+
+    /**
+     * @brief Get the significant bits of each sample (e.g. 20 in a 24-bit container)
+     */
+    virtual unsigned GetValidBits() const = 0;
+
+    virtual bool IsFloat() const = 0;
+
+    /**
+     * @brief Get the most frames one packet decodes to
+     */
+    virtual size_t GetMaxFrames() const = 0;
+
+    /**
+     * @brief Get the speaker layout of the decoded channels
+     */
+    virtual ChannelLayout GetLayout() const = 0;
+
+    /**
+     * @brief Get the codec name, e.g. "ALAC"
+     */
+    virtual std::string GetName() const = 0;
+};
+
+#endif // I_PACKET_DECODER_H
@@ -1,4 +1,5 @@
 #include "MP3Decoder.h"
+#include "core/Log.h"
 #include <iostream>
 #include <algorithm>
 #include <cctype>
@@ -44,11 +45,19 @@ int MP3Decoder::ReadNextChunk(float* buffer, size_t bufferSize) {
     }
 
     // In a real implementation, we would read and decode the next chunk of audio data
-    std::cout << "Reading next chunk from MP3 file\n";
+    GPU_PLAYER_LOG(Decoder, Debug, "Reading next chunk from MP3 file");
     // Return some dummy bytes for demonstration purposes
     return static_cast<int>(bufferSize > 0 ? bufferSize : 1024);
 }
 
+int MP3Decoder::ReadNextChunk(AudioBufferView buffer) {
+    if (!buffer.IsInterleaved() || buffer.IsEmpty()) {
+        return buffer.IsEmpty() ? 0 : -1;
+    }
+    int bytes = ReadNextChunk(buffer.Data(), buffer.ByteSize());
+    return bytes < 0 ? -1 : static_cast<int>(static_cast<size_t>(bytes) / (buffer.Channels() * sizeof(float)));
+}
+
 std::string MP3Decoder::GetFileInfo(const std::string& filePath) const {
     if (!pImpl->isOpen) {
         return "File not opened";
@@ -2,6 +2,7 @@
 #define MP3_DECODER_H
 
 #include "IAudioDecoder.h"
+#include "AudioBufferView.h"
 #include <string>
 
 /**
@@ -40,6 +41,13 @@ public:
      * @return Number of bytes read, or -1 on error
      */
     int ReadNextChunk(float* buffer, size_t bufferSize) override;
+
+    /**
+     * @brief Decode the next chunk straight into a caller's interleaved buffer
+     * @param buffer Receives up to buffer.Frames() frames
+     * @return Number of frames decoded, or -1 on error
+     */
+    int ReadNextChunk(AudioBufferView buffer);
     
     /**
      * @brief Get information about an MP3 file
@@ -0,0 +1,254 @@
+#include "MP4Decoder.h"
+#include "ALACDecoder.h"
+#include "IPacketDecoder.h"
+#include "MP4Reader.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Implementation of the MP4 audio decoder
+
+namespace {
+
+const uint32_t kCodecALAC = 0x616c6163;   // 'alac'
+const uint32_t kCodecMP4A = 0x6d703461;   // 'mp4a'
+
+// MPEG-4 object type of AAC in 'mp4a' tracks
+const uint8_t kObjectTypeAAC = 0x40;
+
+/**
+ * @brief Create the packet decoder for a track's codec
+ *
+ * Codecs backed by optional libraries (AAC) are added here, each behind its
+ * ENABLE_ define.
+ * @param track Track description from the demuxer
+ * @return Decoder, or nullptr if the codec is not supported
+ */
+std::unique_ptr<IPacketDecoder> CreatePacketDecoder(const MP4Reader::Track& track) {
+    if (track.codec == kCodecALAC) {
+        return std::unique_ptr<IPacketDecoder>(new ALACDecoder());
+    }
+    if (track.codec == kCodecMP4A && track.objectType == kObjectTypeAAC) {
+        std::cout << "Error: AAC support not compiled in. AAC library not found.\n";
+        return nullptr;
+    }
+    std::cout << "Error: Unsupported MP4 audio codec '" << MP4Reader::GetCodecName(track.codec) << "'\n";
+    return nullptr;
+}
+
+} // namespace
+
+class MP4Decoder::Impl {
+public:
+    MP4Reader reader;
+    std::unique_ptr<IPacketDecoder> codec;
+    int sampleRate = 0;
+    uint32_t timescale = 0;
+
+    // Stream bounds in codec frames from the start of the media, from the edit list
+    uint64_t startFrame = 0;
+    uint64_t endFrame = 0;
+
+    size_t nextSample = 0;            // Next sample (packet) to decode
+    uint64_t trimBefore = 0;          // Frames before this are decoded but dropped (start or seek target)
+    std::vector<unsigned char> packet;
+
+    // Frames of the last packet not yet returned, when it did not fit in the caller's buffer
+    std::vector<char> decoded;
+    size_t decodedFrames = 0;
+    size_t decodedRead = 0;
+    size_t damagedPackets = 0;
+
+    uint64_t ToFrames(uint64_t mediaTime) const {
+        return timescale == static_cast<uint32_t>(sampleRate)
+                   ? mediaTime
+                   : mediaTime * static_cast<uint64_t>(sampleRate) / timescale;
+    }
+
+    uint64_t ToMediaTime(uint64_t frames) const {
+        return timescale == static_cast<uint32_t>(sampleRate)
+                   ? frames
+                   : frames * timescale / static_cast<uint64_t>(sampleRate);
+    }
+
+    /**
+     * @brief Decode the next packet into a buffer holding at least the codec's largest packet
+     * @param output Destination
+     * @param first Receives the index of the first frame to keep
+     * @param frames Receives the number of frames to keep
+     * @return true if a packet was decoded, false at the end of the stream
+     */
+    bool DecodePacket(PcmBufferView output, size_t& first, size_t& frames) {
+        while (nextSample < reader.GetSampleCount()) {
+            const size_t sample = nextSample++;
+            const uint64_t packetStart = ToFrames(reader.GetSampleTime(sample));
+            if (packetStart >= endFrame) {
+                nextSample = reader.GetSampleCount();
+                return false;
+            }
+
+            size_t decodedCount = 0;
+            if (!reader.ReadSample(sample, packet) ||
+                !codec->Decode(packet.data(), packet.size(), output, decodedCount)) {
+                // Keep the timeline: a damaged packet plays as silence
+                if (damagedPackets++ == 0) {
+                    std::cout << "Error: Damaged " << codec->GetName() << " packet " << sample
+                              << " in MP4 file; replaced with silence\n";
+                }
+                const uint64_t packetEnd = ToFrames(reader.GetSampleTime(sample + 1));
+                decodedCount = static_cast<size_t>(std::min<uint64_t>(packetEnd - packetStart, codec->GetMaxFrames()));
+                std::memset(output.Data(), 0, decodedCount * output.BlockAlign());
+            }
+
+            const uint64_t keepFrom = std::max(trimBefore, packetStart);
+            const uint64_t keepTo = std::min<uint64_t>(endFrame, packetStart + decodedCount);
+            if (keepTo <= keepFrom) {
+                continue;
+            }
+            first = static_cast<size_t>(keepFrom - packetStart);
+            frames = static_cast<size_t>(keepTo - keepFrom);
+            return true;
+        }
+        return false;
+    }
+};
+
+MP4Decoder::MP4Decoder() : pImpl(std::make_unique<Impl>()) {}
+
+MP4Decoder::~MP4Decoder() = default;
+
+bool MP4Decoder::Open(const std::string& filePath) {
+    Close();
+    if (!pImpl->reader.Open(filePath)) {
+        return false;
+    }
+    const MP4Reader::Track& track = pImpl->reader.GetTrack();
+    pImpl->codec = CreatePacketDecoder(track);
+    if (!pImpl->codec || !pImpl->codec->Initialize(track.config, track.channels, track.sampleRate)) {
+        std::cout << "Error: Cannot decode the audio track of " << filePath << "\n";
+        Close();
+        return false;
+    }
+
+    pImpl->sampleRate = pImpl->codec->GetSampleRate();
+    pImpl->timescale = track.timescale;
+    const uint64_t mediaFrames = pImpl->ToFrames(pImpl->reader.GetDuration());
+    pImpl->startFrame = std::min(pImpl->ToFrames(track.editStart), mediaFrames);
+    pImpl->endFrame = mediaFrames;
+    if (track.editDuration > 0) {
+        pImpl->endFrame = std::min(mediaFrames, pImpl->startFrame + pImpl->ToFrames(track.editDuration));
+    }
+    pImpl->trimBefore = pImpl->startFrame;
+    pImpl->nextSample = pImpl->reader.FindSample(track.editStart);
+
+    const IPacketDecoder& codec = *pImpl->codec;
+    pImpl->decoded.resize(codec.GetMaxFrames() * static_cast<size_t>(codec.GetChannels()) *
+                          (codec.GetBitsPerSample() / 8));
+    return true;
+}
+
+size_t MP4Decoder::Read(PcmBufferView output) {
+    if (!pImpl->codec || output.Channels() != GetChannels() || output.BitsPerSample() != GetBitsPerSample()) {
+        return 0;
+    }
+    const IPacketDecoder& codec = *pImpl->codec;
+    const size_t blockAlign = output.BlockAlign();
+    const PcmBufferView spill(pImpl->decoded.data(), codec.GetMaxFrames(), codec.GetChannels(),
+                              codec.GetBitsPerSample(), codec.IsFloat());
+
+    size_t written = 0;
+    while (written < output.Frames()) {
+        // Frames left from a packet that did not fit
+        if (pImpl->decodedRead < pImpl->decodedFrames) {
+            const size_t count = std::min(pImpl->decodedFrames - pImpl->decodedRead, output.Frames() - written);
+            std::memcpy(output.Data() + written * blockAlign, pImpl->decoded.data() + pImpl->decodedRead * blockAlign,
+                        count * blockAlign);
+            pImpl->decodedRead += count;
+            written += count;
+            continue;
+        }
+
+        // Decode straight into the caller's buffer while a whole packet fits
+        const bool direct = output.Frames() - written >= codec.GetMaxFrames();
+        const PcmBufferView target = direct ? output.Subview(written, output.Frames() - written) : spill;
+        size_t first = 0;
+        size_t frames = 0;
+        if (!pImpl->DecodePacket(target, first, frames)) {
+            break;
+        }
+        if (direct) {
+            if (first > 0) {
+                std::memmove(target.Data(), target.Data() + first * blockAlign, frames * blockAlign);
+            }
+            written += frames;
+        } else {
+            pImpl->decodedRead = first;
+            pImpl->decodedFrames = first + frames;
+        }
+    }
+    return written;
+}
+
+bool MP4Decoder::Seek(uint64_t frame) {
+    if (!pImpl->codec || frame > GetFrameCount()) {
+        return false;
+    }
+    const uint64_t target = pImpl->startFrame + frame;
+    pImpl->nextSample = pImpl->reader.FindSample(pImpl->ToMediaTime(target));
+    pImpl->trimBefore = target;
+    pImpl->decodedFrames = 0;
+    pImpl->decodedRead = 0;
+    pImpl->codec->Reset();
+    return true;
+}
+
+void MP4Decoder::Close() {
+    pImpl->reader.Close();
+    pImpl->codec.reset();
+    pImpl->sampleRate = 0;
+    pImpl->timescale = 0;
+    pImpl->startFrame = 0;
+    pImpl->endFrame = 0;
+    pImpl->nextSample = 0;
+    pImpl->trimBefore = 0;
+    pImpl->decodedFrames = 0;
+    pImpl->decodedRead = 0;
+    pImpl->damagedPackets = 0;
+}
+
+int MP4Decoder::GetSampleRate() const {
+    return pImpl->sampleRate;
+}
+
+int MP4Decoder::GetChannels() const {
+    return pImpl->codec ? pImpl->codec->GetChannels() : 0;
+}
+
+unsigned MP4Decoder::GetBitsPerSample() const {
+    return pImpl->codec ? pImpl->codec->GetBitsPerSample() : 0;
+}
+
+unsigned MP4Decoder::GetValidBits() const {
+    return pImpl->codec ? pImpl->codec->GetValidBits() : 0;
+}
+
+bool MP4Decoder::IsFloat() const {
+    return pImpl->codec && pImpl->codec->IsFloat();
+}
+
+uint64_t MP4Decoder::GetFrameCount() const {
+    return pImpl->endFrame - pImpl->startFrame;
+}
+
+ChannelLayout MP4Decoder::GetLayout() const {
+    return pImpl->codec ? pImpl->codec->GetLayout() : ChannelLayout();
+}
+
+std::string MP4Decoder::GetFormatName() const {
+    return pImpl->codec ? pImpl->codec->GetName() : std::string();
+}
+
+bool MP4Decoder::IsFragmented() const {
+    return pImpl->reader.IsFragmented();
+}
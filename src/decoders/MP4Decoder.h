@@ -0,0 +1,100 @@
+#ifndef MP4_DECODER_H
+#define MP4_DECODER_H
+
+#include "AudioBufferView.h"
+#include "dsp/ChannelLayout.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Streaming decoder for the audio track of MP4/M4A files
+ *
+ * The demuxer indexes every sample when the file is opened, so seeking
+ * looks the target's sample up and decodes from it, dropping the frames
+ * before the target. Packets are decoded by an IPacketDecoder chosen from
+ * the track's sample entry: ALAC is built in and decodes bit-exact into the
+ * caller's buffer; other codecs (AAC) plug in behind the same interface.
+ * The track's edit list trims the start and end of the stream.
+ */
+class MP4Decoder {
+public:
+    /**
+     * @brief Constructor
+     */
+    MP4Decoder();
+
+    /**
+     * @brief Destructor
+     */
+    ~MP4Decoder();
+
+    /**
+     * @brief Open an MP4 file and set up the decoder for its first audio track
+     * @param filePath Path to the file
+     * @return true if successful, false otherwise
+     */
+    bool Open(const std::string& filePath);
+
+    /**
+     * @brief Decode the next frames
+     * @param output Receives up to output.Frames() frames, in GetBitsPerSample() and IsFloat() format
+     * @return Number of frames decoded, 0 at the end of the stream
+     */
+    size_t Read(PcmBufferView output);
+
+    /**
+     * @brief Continue decoding from a frame
+     * @param frame Frame index from the start of the stream
+     * @return true if successful, false otherwise
+     */
+    bool Seek(uint64_t frame);
+
+    /**
+     * @brief Close the file
+     */
+    void Close();
+
+    int GetSampleRate() const;
+    int GetChannels() const;
+
+    /**
+     * @brief Get the container size of the returned samples: 16, 24 or 32
+     */
+    unsigned GetBitsPerSample() const;
+
+    /**
+     * @brief Get the significant bits of each sample (e.g. 20 for 20-bit ALAC in 24-bit containers)
+     */
+    unsigned GetValidBits() const;
+
+    bool IsFloat() const;
+
+    /**
+     * @brief Get the stream length in frames
+     */
+    uint64_t GetFrameCount() const;
+
+    /**
+     * @brief Get the speaker layout of the returned channels
+     */
+    ChannelLayout GetLayout() const;
+
+    /**
+     * @brief Get the codec name, e.g. "ALAC"
+     */
+    std::string GetFormatName() const;
+
+    /**
+     * @brief Check whether the samples came from movie fragments
+     */
+    bool IsFragmented() const;
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // MP4_DECODER_H
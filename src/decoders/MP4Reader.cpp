@@ -0,0 +1,736 @@
+#include "MP4Reader.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+// Implementation of the MP4 demuxer
+
+namespace {
+
+// Samples sharing one 64-bit base offset in the index
+const size_t kGroupSamples = 1024;
+
+// Largest 'moov' or 'moof' box read into memory
+const uint64_t kMaxHeaderBoxBytes = 256ull << 20;
+
+constexpr uint32_t FourCC(const char (&name)[5]) {
+    return (static_cast<uint32_t>(static_cast<unsigned char>(name[0])) << 24) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(name[1])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(name[2])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(name[3]));
+}
+
+uint16_t ReadBE16(const unsigned char* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t ReadBE32(const unsigned char* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+uint64_t ReadBE64(const unsigned char* p) {
+    return (static_cast<uint64_t>(ReadBE32(p)) << 32) | ReadBE32(p + 4);
+}
+
+// Track fragment header flags ('tfhd')
+const uint32_t kBaseDataOffset = 0x1;
+const uint32_t kSampleDescriptionIndex = 0x2;
+const uint32_t kDefaultDuration = 0x8;
+const uint32_t kDefaultSize = 0x10;
+const uint32_t kDefaultFlags = 0x20;
+const uint32_t kBaseIsMoof = 0x20000;
+
+// Track run flags ('trun')
+const uint32_t kDataOffset = 0x1;
+const uint32_t kFirstSampleFlags = 0x4;
+const uint32_t kSampleDuration = 0x100;
+const uint32_t kSampleSize = 0x200;
+const uint32_t kSampleFlags = 0x400;
+const uint32_t kCompositionOffset = 0x800;
+
+} // namespace
+
+/**
+ * @brief A box held in memory: its type and payload
+ */
+struct MP4Reader::Box {
+    uint32_t type = 0;
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+
+    /**
+     * @brief Read the box starting at position in the payload and move past it
+     * @param position Offset in the payload; advanced to the next box
+     * @param child Receives the box
+     * @return true if a whole box was there, false at the end or on a damaged box
+     */
+    bool NextChild(size_t& position, Box& child) const {
+        if (position + 8 > size) {
+            return false;
+        }
+        const unsigned char* p = data + position;
+        uint64_t boxSize = ReadBE32(p);
+        size_t header = 8;
+        if (boxSize == 1) {
+            if (position + 16 > size) {
+                return false;
+            }
+            boxSize = ReadBE64(p + 8);
+            header = 16;
+        } else if (boxSize == 0) {
+            boxSize = size - position;
+        }
+        if (boxSize < header || boxSize > size - position) {
+            return false;
+        }
+        child.type = ReadBE32(p + 4);
+        child.data = p + header;
+        child.size = static_cast<size_t>(boxSize) - header;
+        position += static_cast<size_t>(boxSize);
+        return true;
+    }
+
+    /**
+     * @brief Find the first child of a type
+     * @param childType Box type
+     * @param child Receives the box
+     * @param skip Bytes of the payload before the first child
+     * @return true if found, false otherwise
+     */
+    bool FindChild(uint32_t childType, Box& child, size_t skip = 0) const {
+        size_t position = skip;
+        while (NextChild(position, child)) {
+            if (child.type == childType) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Follow a path of child types, e.g. {'mdia', 'minf', 'stbl'}
+     */
+    bool FindPath(std::initializer_list<uint32_t> path, Box& found) const {
+        found = *this;
+        for (uint32_t type : path) {
+            Box child;
+            if (!found.FindChild(type, child)) {
+                return false;
+            }
+            found = child;
+        }
+        return true;
+    }
+};
+
+MP4Reader::MP4Reader() = default;
+
+MP4Reader::~MP4Reader() = default;
+
+bool MP4Reader::Open(const std::string& filePath) {
+    Close();
+    file.open(filePath, std::ios::binary);
+    if (!file) {
+        std::cout << "Error: Could not open file for reading: " << filePath << "\n";
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    fileSize = static_cast<uint64_t>(file.tellg());
+
+    // Walk the top-level boxes by their headers; only 'moov' and 'moof' payloads are read
+    std::vector<unsigned char> movie;
+    bool haveMovie = false;
+    struct FragmentBox {
+        uint64_t offset;
+        uint64_t headerSize;
+        uint64_t payloadSize;
+    };
+    std::vector<FragmentBox> fragments;
+    uint64_t offset = 0;
+    while (offset + 8 <= fileSize) {
+        unsigned char header[16];
+        if (!ReadAt(offset, header, 8)) {
+            break;
+        }
+        uint64_t boxSize = ReadBE32(header);
+        uint64_t headerSize = 8;
+        const uint32_t type = ReadBE32(header + 4);
+        if (boxSize == 1) {
+            if (offset + 16 > fileSize || !ReadAt(offset + 8, header + 8, 8)) {
+                break;
+            }
+            boxSize = ReadBE64(header + 8);
+            headerSize = 16;
+        } else if (boxSize == 0) {
+            boxSize = fileSize - offset;
+        }
+        if (boxSize < headerSize) {
+            break;
+        }
+        if (offset == 0 && type != FourCC("ftyp") && type != FourCC("moov") && type != FourCC("free") &&
+            type != FourCC("skip") && type != FourCC("wide") && type != FourCC("mdat") && type != FourCC("styp")) {
+            std::cout << "Error: Not an MP4 file: " << filePath << "\n";
+            Close();
+            return false;
+        }
+
+        const uint64_t payloadSize = std::min(boxSize, fileSize - offset) - headerSize;
+        if ((type == FourCC("moov") || type == FourCC("moof")) && payloadSize > kMaxHeaderBoxBytes) {
+            std::cout << "Error: MP4 '" << GetCodecName(type) << "' box is too large (" << payloadSize
+                      << " bytes) in " << filePath << "\n";
+            Close();
+            return false;
+        }
+        if (type == FourCC("moov") && !haveMovie) {
+            movie.resize(static_cast<size_t>(payloadSize));
+            if (!ReadAt(offset + headerSize, movie.data(), movie.size())) {
+                break;
+            }
+            haveMovie = true;
+            boxesRead++;
+        } else if (type == FourCC("moof")) {
+            fragments.push_back({offset, headerSize, payloadSize});
+        }
+        offset += boxSize;
+    }
+
+    if (!haveMovie) {
+        std::cout << "Error: No 'moov' box in MP4 file: " << filePath << "\n";
+        Close();
+        return false;
+    }
+    if (!ParseMovie(movie)) {
+        std::cout << "Error: Could not read the audio track of " << filePath << "\n";
+        Close();
+        return false;
+    }
+
+    // Fragments follow the movie's own samples; a damaged one is dropped whole
+    std::vector<unsigned char> fragment;
+    for (const auto& entry : fragments) {
+        const size_t samplesBefore = offsets.size();
+        const uint64_t durationBefore = duration;
+        fragment.resize(static_cast<size_t>(entry.payloadSize));
+        if (!ReadAt(entry.offset + entry.headerSize, fragment.data(), fragment.size()) ||
+            !ParseFragment(fragment, entry.offset)) {
+            std::cout << "Warning: Skipping damaged movie fragment at offset " << entry.offset << " in "
+                      << filePath << "\n";
+            offsets.resize(samplesBefore);
+            index.resize(samplesBefore);
+            while (!timeRuns.empty() && timeRuns.back().firstSample >= samplesBefore) {
+                timeRuns.pop_back();
+            }
+            duration = durationBefore;
+            continue;
+        }
+        boxesRead++;
+        fragmented = true;
+    }
+
+    if (!BuildIndex()) {
+        Close();
+        return false;
+    }
+    if (sampleCount == 0) {
+        std::cout << "Error: The audio track of " << filePath << " has no samples\n";
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MP4Reader::Close() {
+    if (file.is_open()) {
+        file.close();
+    }
+    file.clear();
+    fileSize = 0;
+    track = Track();
+    fragmented = false;
+    boxesRead = 0;
+    trackDefaults = FragmentDefaults();
+    offsets.clear();
+    bases.clear();
+    index.clear();
+    timeRuns.clear();
+    sampleCount = 0;
+    duration = 0;
+}
+
+std::string MP4Reader::GetCodecName(uint32_t codec) {
+    std::string name;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        const char c = static_cast<char>((codec >> shift) & 0xff);
+        name += (c >= 32 && c < 127) ? c : '?';
+    }
+    return name;
+}
+
+bool MP4Reader::ReadAt(uint64_t offset, unsigned char* data, size_t size) {
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(size));
+    return static_cast<size_t>(file.gcount()) == size;
+}
+
+bool MP4Reader::ParseMovie(const std::vector<unsigned char>& movie) {
+    Box moov;
+    moov.type = FourCC("moov");
+    moov.data = movie.data();
+    moov.size = movie.size();
+
+    uint32_t movieTimescale = 0;
+    Box mvhd;
+    if (moov.FindChild(FourCC("mvhd"), mvhd) && mvhd.size >= 24) {
+        movieTimescale = ReadBE32(mvhd.data + (mvhd.data[0] == 1 ? 20 : 12));
+    }
+
+    // The first audio track
+    Box trak;
+    bool found = false;
+    size_t position = 0;
+    while (!found && moov.NextChild(position, trak)) {
+        Box handler;
+        found = trak.type == FourCC("trak") && trak.FindPath({FourCC("mdia"), FourCC("hdlr")}, handler) &&
+                handler.size >= 12 && ReadBE32(handler.data + 8) == FourCC("soun");
+    }
+    if (!found) {
+        std::cout << "Error: No audio track in MP4 file\n";
+        return false;
+    }
+    if (!ParseTrack(trak, movieTimescale)) {
+        return false;
+    }
+
+    // Sample defaults for fragments
+    Box mvex;
+    Box child;
+    if (moov.FindChild(FourCC("mvex"), mvex)) {
+        position = 0;
+        while (mvex.NextChild(position, child)) {
+            if (child.type == FourCC("trex") && child.size >= 24 && ReadBE32(child.data + 4) == track.trackId) {
+                trackDefaults.duration = ReadBE32(child.data + 12);
+                trackDefaults.size = ReadBE32(child.data + 16);
+            }
+        }
+    }
+    return true;
+}
+
+bool MP4Reader::ParseTrack(const Box& trak, uint32_t movieTimescale) {
+    Box box;
+    track = Track();
+    if (trak.FindChild(FourCC("tkhd"), box) && box.size >= 24) {
+        track.trackId = ReadBE32(box.data + (box.data[0] == 1 ? 20 : 12));
+    }
+    if (!trak.FindPath({FourCC("mdia"), FourCC("mdhd")}, box) || box.size < 24) {
+        return false;
+    }
+    track.timescale = ReadBE32(box.data + (box.data[0] == 1 ? 20 : 12));
+    if (track.timescale == 0) {
+        return false;
+    }
+
+    // Presentation starts at the first edit with media (e.g. after an AAC encoder delay)
+    Box elst;
+    if (trak.FindPath({FourCC("edts"), FourCC("elst")}, elst) && elst.size >= 8) {
+        const bool wide = elst.data[0] == 1;
+        const size_t entrySize = wide ? 20 : 12;
+        const uint32_t count = ReadBE32(elst.data + 4);
+        for (uint32_t i = 0; i < count && 8 + (i + 1) * entrySize <= elst.size; i++) {
+            const unsigned char* entry = elst.data + 8 + i * entrySize;
+            const uint64_t segmentDuration = wide ? ReadBE64(entry) : ReadBE32(entry);
+            const int64_t mediaTime = wide ? static_cast<int64_t>(ReadBE64(entry + 8))
+                                           : static_cast<int32_t>(ReadBE32(entry + 4));
+            if (mediaTime >= 0) {
+                track.editStart = static_cast<uint64_t>(mediaTime);
+                if (movieTimescale > 0 && segmentDuration > 0) {
+                    track.editDuration = static_cast<uint64_t>(
+                        static_cast<double>(segmentDuration) * track.timescale / movieTimescale + 0.5);
+                }
+                break;
+            }
+        }
+    }
+
+    Box stbl;
+    if (!trak.FindPath({FourCC("mdia"), FourCC("minf"), FourCC("stbl")}, stbl) ||
+        !stbl.FindChild(FourCC("stsd"), box) || !ParseSampleDescription(box)) {
+        return false;
+    }
+    return ParseSampleTable(stbl);
+}
+
+bool MP4Reader::ParseSampleDescription(const Box& stsd) {
+    Box entry;
+    size_t position = 8;
+    if (stsd.size < 8 || !stsd.NextChild(position, entry)) {
+        return false;
+    }
+
+    // Audio sample entry: reserved, data reference index, QuickTime version, then the format fields
+    if (entry.size < 28) {
+        return false;
+    }
+    track.codec = entry.type;
+    const uint16_t version = ReadBE16(entry.data + 8);
+    track.channels = ReadBE16(entry.data + 16);
+    track.bitsPerSample = ReadBE16(entry.data + 18);
+    track.sampleRate = static_cast<int>(ReadBE32(entry.data + 24) >> 16);
+    if (track.sampleRate == 0) {
+        track.sampleRate = static_cast<int>(track.timescale);
+    }
+    const size_t childrenStart = 28 + (version == 1 ? 16 : version == 2 ? 36 : 0);
+    if (childrenStart > entry.size) {
+        return false;
+    }
+
+    // Codec configuration, possibly inside a QuickTime 'wave' box
+    Box container = entry;
+    size_t skip = childrenStart;
+    Box wave;
+    if (entry.FindChild(FourCC("wave"), wave, childrenStart)) {
+        container = wave;
+        skip = 0;
+    }
+
+    Box config;
+    if (track.codec == FourCC("alac")) {
+        if (!container.FindChild(FourCC("alac"), config, skip) || config.size < 24) {
+            std::cout << "Error: ALAC track has no decoder configuration\n";
+            return false;
+        }
+        // Version and flags precede the ALACSpecificConfig
+        const size_t start = config.size >= 28 ? 4 : 0;
+        track.config.assign(config.data + start, config.data + start + 24);
+    } else if (track.codec == FourCC("mp4a") && container.FindChild(FourCC("esds"), config, skip)) {
+        // ES_Descriptor > DecoderConfigDescriptor (object type) > DecoderSpecificInfo (AudioSpecificConfig)
+        const unsigned char* p = config.data + 4;
+        const unsigned char* end = config.data + config.size;
+        while (p + 2 <= end) {
+            const unsigned char tag = *p++;
+            size_t length = 0;
+            for (int i = 0; i < 4 && p < end; i++) {
+                const unsigned char byte = *p++;
+                length = (length << 7) | (byte & 0x7f);
+                if (!(byte & 0x80)) {
+                    break;
+                }
+            }
+            if (tag == 0x03) {
+                if (p + 3 > end) {
+                    break;
+                }
+                const unsigned char flags = p[2];
+                p += 3;
+                if (flags & 0x80) {
+                    p += 2;
+                }
+                if ((flags & 0x40) && p < end) {
+                    p += 1 + *p;
+                }
+                if (flags & 0x20) {
+                    p += 2;
+                }
+            } else if (tag == 0x04) {
+                if (p + 13 > end) {
+                    break;
+                }
+                track.objectType = p[0];
+                p += 13;
+            } else if (tag == 0x05) {
+                if (length > static_cast<size_t>(end - p)) {
+                    break;
+                }
+                track.config.assign(p, p + length);
+                break;
+            } else {
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+bool MP4Reader::ParseSampleTable(const Box& stbl) {
+    Box stsz, stsc, stco, stts;
+    bool wideOffsets = false;
+    bool haveOffsets = stbl.FindChild(FourCC("stco"), stco);
+    if (!haveOffsets) {
+        wideOffsets = haveOffsets = stbl.FindChild(FourCC("co64"), stco);
+    }
+    if (!stbl.FindChild(FourCC("stsz"), stsz) || !stbl.FindChild(FourCC("stsc"), stsc) ||
+        !stbl.FindChild(FourCC("stts"), stts) || !haveOffsets) {
+        if (stbl.FindChild(FourCC("stz2"), stsz)) {
+            std::cout << "Error: Compact sample sizes ('stz2') are not supported\n";
+        } else {
+            std::cout << "Error: MP4 sample table is incomplete\n";
+        }
+        return false;
+    }
+    if (stsz.size < 12 || stsc.size < 8 || stco.size < 8 || stts.size < 8) {
+        return false;
+    }
+
+    const uint32_t constantSize = ReadBE32(stsz.data + 4);
+    const uint32_t totalSamples = ReadBE32(stsz.data + 8);
+    const uint32_t chunkEntries = ReadBE32(stsc.data + 4);
+    const uint32_t chunkCount = ReadBE32(stco.data + 4);
+    const uint32_t timeEntries = ReadBE32(stts.data + 4);
+    const size_t offsetBytes = wideOffsets ? 8 : 4;
+    if ((constantSize == 0 && 12 + static_cast<uint64_t>(totalSamples) * 4 > stsz.size) ||
+        8 + static_cast<uint64_t>(chunkEntries) * 12 > stsc.size ||
+        8 + static_cast<uint64_t>(chunkCount) * offsetBytes > stco.size ||
+        8 + static_cast<uint64_t>(timeEntries) * 8 > stts.size) {
+        std::cout << "Error: MP4 sample table is damaged\n";
+        return false;
+    }
+
+    // Walk the chunks, the samples in each chunk, and the time-to-sample runs together
+    offsets.reserve(offsets.size() + totalSamples);
+    index.reserve(index.size() + totalSamples);
+    const unsigned char* sizeEntry = stsz.data + 12;
+    const unsigned char* timeEntry = stts.data + 8;
+    uint32_t timeEntriesLeft = timeEntries;
+    uint32_t timeSamplesLeft = 0;
+    uint32_t sampleDuration = 0;
+    uint32_t chunkEntry = 0;
+    uint32_t sample = 0;
+    for (uint32_t chunk = 1; chunk <= chunkCount && sample < totalSamples; chunk++) {
+        while (chunkEntry + 1 < chunkEntries && chunk >= ReadBE32(stsc.data + 8 + (chunkEntry + 1) * 12)) {
+            chunkEntry++;
+        }
+        const uint32_t samplesInChunk = chunkEntries > 0 ? ReadBE32(stsc.data + 8 + chunkEntry * 12 + 4) : 0;
+        const unsigned char* chunkOffset = stco.data + 8 + (chunk - 1) * offsetBytes;
+        uint64_t offset = wideOffsets ? ReadBE64(chunkOffset) : ReadBE32(chunkOffset);
+        for (uint32_t i = 0; i < samplesInChunk && sample < totalSamples; i++, sample++) {
+            uint32_t size = constantSize;
+            if (size == 0) {
+                size = ReadBE32(sizeEntry);
+                sizeEntry += 4;
+            }
+            while (timeSamplesLeft == 0 && timeEntriesLeft > 0) {
+                timeSamplesLeft = ReadBE32(timeEntry);
+                sampleDuration = ReadBE32(timeEntry + 4);
+                timeEntry += 8;
+                timeEntriesLeft--;
+            }
+            if (timeSamplesLeft > 0) {
+                timeSamplesLeft--;
+            }
+            AddSample(offset, size, sampleDuration);
+            offset += size;
+        }
+    }
+    if (sample != totalSamples) {
+        std::cout << "Error: MP4 sample table is inconsistent (" << sample << " of " << totalSamples
+                  << " samples in chunks)\n";
+        return false;
+    }
+    return true;
+}
+
+bool MP4Reader::ParseFragment(const std::vector<unsigned char>& fragment, uint64_t fragmentOffset) {
+    Box moof;
+    moof.type = FourCC("moof");
+    moof.data = fragment.data();
+    moof.size = fragment.size();
+
+    // Each track fragment's data follows the previous one's unless it gives a base offset
+    uint64_t dataEnd = fragmentOffset;
+    bool firstTraf = true;
+    size_t position = 0;
+    Box traf;
+    while (moof.NextChild(position, traf)) {
+        if (traf.type != FourCC("traf")) {
+            continue;
+        }
+        Box tfhd;
+        if (!traf.FindChild(FourCC("tfhd"), tfhd) || tfhd.size < 8) {
+            return false;
+        }
+        const uint32_t headerFlags = ReadBE32(tfhd.data) & 0xffffff;
+        const bool ours = ReadBE32(tfhd.data + 4) == track.trackId;
+        const unsigned char* field = tfhd.data + 8;
+        const unsigned char* fieldsEnd = tfhd.data + tfhd.size;
+        uint64_t base = (firstTraf || (headerFlags & kBaseIsMoof)) ? fragmentOffset : dataEnd;
+        FragmentDefaults defaults = ours ? trackDefaults : FragmentDefaults();
+        auto take = [&](size_t bytes) {
+            const unsigned char* value = field;
+            field += bytes;
+            return field <= fieldsEnd ? value : nullptr;
+        };
+        if (headerFlags & kBaseDataOffset) {
+            const unsigned char* value = take(8);
+            if (!value) {
+                return false;
+            }
+            base = ReadBE64(value);
+        }
+        if (headerFlags & kSampleDescriptionIndex) {
+            take(4);
+        }
+        if (headerFlags & kDefaultDuration) {
+            const unsigned char* value = take(4);
+            defaults.duration = value ? ReadBE32(value) : 0;
+        }
+        if (headerFlags & kDefaultSize) {
+            const unsigned char* value = take(4);
+            defaults.size = value ? ReadBE32(value) : 0;
+        }
+        if (headerFlags & kDefaultFlags) {
+            take(4);
+        }
+        if (field > fieldsEnd) {
+            return false;
+        }
+        firstTraf = false;
+
+        uint64_t offset = base;
+        size_t runPosition = 0;
+        Box trun;
+        while (traf.NextChild(runPosition, trun)) {
+            if (trun.type != FourCC("trun")) {
+                continue;
+            }
+            if (trun.size < 8) {
+                return false;
+            }
+            const uint32_t runFlags = ReadBE32(trun.data) & 0xffffff;
+            const uint32_t count = ReadBE32(trun.data + 4);
+            size_t headerBytes = 8;
+            if (runFlags & kDataOffset) {
+                if (trun.size < 12) {
+                    return false;
+                }
+                offset = base + static_cast<int64_t>(static_cast<int32_t>(ReadBE32(trun.data + 8)));
+                headerBytes += 4;
+            }
+            if (runFlags & kFirstSampleFlags) {
+                headerBytes += 4;
+            }
+            const size_t entryBytes = 4 * (((runFlags & kSampleDuration) != 0) + ((runFlags & kSampleSize) != 0) +
+                                           ((runFlags & kSampleFlags) != 0) + ((runFlags & kCompositionOffset) != 0));
+            if (headerBytes + static_cast<uint64_t>(count) * entryBytes > trun.size) {
+                return false;
+            }
+            const unsigned char* entry = trun.data + headerBytes;
+            if (ours) {
+                offsets.reserve(offsets.size() + count);
+                index.reserve(index.size() + count);
+            }
+            for (uint32_t i = 0; i < count; i++) {
+                uint32_t sampleDuration = defaults.duration;
+                uint32_t size = defaults.size;
+                if (runFlags & kSampleDuration) {
+                    sampleDuration = ReadBE32(entry);
+                    entry += 4;
+                }
+                if (runFlags & kSampleSize) {
+                    size = ReadBE32(entry);
+                    entry += 4;
+                }
+                entry += 4 * (((runFlags & kSampleFlags) != 0) + ((runFlags & kCompositionOffset) != 0));
+                if (ours) {
+                    AddSample(offset, size, sampleDuration);
+                }
+                offset += size;
+            }
+        }
+        dataEnd = offset;
+    }
+    return true;
+}
+
+void MP4Reader::AddSample(uint64_t offset, uint32_t size, uint32_t sampleDuration) {
+    if (timeRuns.empty() || timeRuns.back().duration != sampleDuration) {
+        timeRuns.push_back({offsets.size(), duration, sampleDuration});
+    }
+    offsets.push_back(offset);
+    index.push_back({0, size});
+    duration += sampleDuration;
+}
+
+bool MP4Reader::BuildIndex() {
+    // A file cut short keeps the samples before the first one missing
+    size_t count = offsets.size();
+    for (size_t i = 0; i < count; i++) {
+        if (offsets[i] + index[i].size > fileSize) {
+            std::cout << "Warning: MP4 file is truncated; " << i << " of " << count << " samples are present\n";
+            count = i;
+            break;
+        }
+    }
+    sampleCount = count;
+    index.resize(count);
+    while (!timeRuns.empty() && timeRuns.back().firstSample >= count) {
+        timeRuns.pop_back();
+    }
+    duration = timeRuns.empty() ? 0
+                                : timeRuns.back().firstTime +
+                                  static_cast<uint64_t>(count - timeRuns.back().firstSample) * timeRuns.back().duration;
+
+    // Offsets within each group of samples are kept relative to the group's lowest offset
+    bases.assign((count + kGroupSamples - 1) / kGroupSamples, 0);
+    for (size_t group = 0; group < bases.size(); group++) {
+        const size_t first = group * kGroupSamples;
+        const size_t last = std::min(count, first + kGroupSamples);
+        const uint64_t base = *std::min_element(offsets.begin() + first, offsets.begin() + last);
+        for (size_t i = first; i < last; i++) {
+            if (offsets[i] - base > std::numeric_limits<uint32_t>::max()) {
+                std::cout << "Error: MP4 samples are too far apart to index\n";
+                return false;
+            }
+            index[i].offset = static_cast<uint32_t>(offsets[i] - base);
+        }
+        bases[group] = base;
+    }
+    std::vector<uint64_t>().swap(offsets);
+    index.shrink_to_fit();
+    timeRuns.shrink_to_fit();
+    return true;
+}
+
+uint64_t MP4Reader::GetSampleOffset(size_t sample) const {
+    return bases[sample / kGroupSamples] + index[sample].offset;
+}
+
+uint64_t MP4Reader::GetSampleTime(size_t sample) const {
+    if (sample >= sampleCount) {
+        return duration;
+    }
+    auto run = std::upper_bound(timeRuns.begin(), timeRuns.end(), sample,
+                                [](size_t value, const TimeRun& entry) { return value < entry.firstSample; });
+    --run;
+    return run->firstTime + static_cast<uint64_t>(sample - run->firstSample) * run->duration;
+}
+
+size_t MP4Reader::FindSample(uint64_t time) const {
+    if (time >= duration) {
+        return sampleCount;
+    }
+    auto run = std::upper_bound(timeRuns.begin(), timeRuns.end(), time,
+                                [](uint64_t value, const TimeRun& entry) { return value < entry.firstTime; });
+    // Runs of zero-length samples share their start time with the run after them
+    --run;
+    const size_t runEnd = (run + 1 == timeRuns.end()) ? sampleCount : (run + 1)->firstSample;
+    if (run->duration == 0) {
+        return runEnd < sampleCount ? runEnd : sampleCount - 1;
+    }
+    return std::min(run->firstSample + static_cast<size_t>((time - run->firstTime) / run->duration), runEnd - 1);
+}
+
+bool MP4Reader::ReadSample(size_t sample, std::vector<unsigned char>& data) {
+    if (sample >= sampleCount || !file.is_open()) {
+        return false;
+    }
+    data.resize(index[sample].size);
+    return ReadAt(GetSampleOffset(sample), data.data(), data.size());
+}
+
+size_t MP4Reader::GetIndexBytes() const {
+    return index.capacity() * sizeof(IndexEntry) + bases.capacity() * sizeof(uint64_t) +
+           timeRuns.capacity() * sizeof(TimeRun);
+}
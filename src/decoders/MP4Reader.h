@@ -0,0 +1,164 @@
+#ifndef MP4_READER_H
+#define MP4_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief MP4/M4A demuxer for the first audio track of a file (ISO/IEC 14496-12)
+ *
+ * Open walks the top-level boxes by their headers alone, seeking over media
+ * data, so a 'moov' box at the end of the file costs one seek. The sample
+ * table ('stsz', 'stsc', 'stco'/'co64' and 'stts') and the track fragments of
+ * fragmented files ('moof' boxes) are expanded into a flat index of 8 bytes
+ * per sample, so finding a sample's bytes is an array lookup; times map to
+ * samples through runs of equal durations, one run for most audio.
+ */
+class MP4Reader {
+public:
+    /**
+     * @brief The audio track and its codec configuration
+     */
+    struct Track {
+        uint32_t trackId = 0;
+        uint32_t codec = 0;                  // Sample entry type, e.g. 'alac' or 'mp4a'
+        uint8_t objectType = 0;              // MPEG-4 object type of 'mp4a' tracks (0x40 for AAC)
+        int channels = 0;                    // From the sample entry; the codec configuration may refine it
+        int sampleRate = 0;
+        int bitsPerSample = 0;
+        uint32_t timescale = 0;              // Media time units per second
+        std::vector<unsigned char> config;   // ALACSpecificConfig, or the AAC AudioSpecificConfig
+        uint64_t editStart = 0;              // Media time where presentation starts (e.g. encoder delay)
+        uint64_t editDuration = 0;           // Presented media time from editStart, 0 for all of it
+    };
+
+    MP4Reader();
+    ~MP4Reader();
+
+    /**
+     * @brief Open a file and index its first audio track
+     * @param filePath Path to the file
+     * @return true if successful, false otherwise
+     */
+    bool Open(const std::string& filePath);
+
+    /**
+     * @brief Close the file
+     */
+    void Close();
+
+    const Track& GetTrack() const { return track; }
+
+    /**
+     * @brief Get a printable name for a sample entry type, e.g. "alac"
+     */
+    static std::string GetCodecName(uint32_t codec);
+
+    size_t GetSampleCount() const { return sampleCount; }
+
+    /**
+     * @brief Get the media time of all samples, in timescale units
+     */
+    uint64_t GetDuration() const { return duration; }
+
+    /**
+     * @brief Get the file offset of a sample
+     */
+    uint64_t GetSampleOffset(size_t sample) const;
+
+    uint32_t GetSampleSize(size_t sample) const { return index[sample].size; }
+
+    /**
+     * @brief Get the media time at which a sample starts
+     */
+    uint64_t GetSampleTime(size_t sample) const;
+
+    /**
+     * @brief Find the sample playing at a media time
+     * @param time Media time in timescale units
+     * @return Sample index, or GetSampleCount() if the time is past the end
+     */
+    size_t FindSample(uint64_t time) const;
+
+    /**
+     * @brief Read the bytes of a sample
+     * @param sample Sample index
+     * @param data Receives the bytes (reused, so it stops allocating once it holds the largest sample)
+     * @return true if successful, false otherwise
+     */
+    bool ReadSample(size_t sample, std::vector<unsigned char>& data);
+
+    /**
+     * @brief Check whether samples came from movie fragments
+     */
+    bool IsFragmented() const { return fragmented; }
+
+    /**
+     * @brief Get the memory taken by the sample index, in bytes
+     */
+    size_t GetIndexBytes() const;
+
+    /**
+     * @brief Get the number of top-level boxes whose payload was read while opening
+     */
+    size_t GetBoxesRead() const { return boxesRead; }
+
+private:
+    /**
+     * @brief Sample location, relative to the base offset of its group of samples
+     */
+    struct IndexEntry {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    /**
+     * @brief Samples with equal durations
+     */
+    struct TimeRun {
+        size_t firstSample;
+        uint64_t firstTime;
+        uint32_t duration;
+    };
+
+    /**
+     * @brief Defaults for the samples of a track fragment ('trex', overridden by 'tfhd')
+     */
+    struct FragmentDefaults {
+        uint32_t duration = 0;
+        uint32_t size = 0;
+    };
+
+    struct Box;
+
+    bool ReadAt(uint64_t offset, unsigned char* data, size_t size);
+    bool ParseMovie(const std::vector<unsigned char>& movie);
+    bool ParseTrack(const Box& trak, uint32_t movieTimescale);
+    bool ParseSampleDescription(const Box& stsd);
+    bool ParseSampleTable(const Box& stbl);
+    bool ParseFragment(const std::vector<unsigned char>& fragment, uint64_t fragmentOffset);
+    void AddSample(uint64_t offset, uint32_t size, uint32_t sampleDuration);
+    bool BuildIndex();
+
+    std::ifstream file;
+    uint64_t fileSize = 0;
+    Track track;
+    bool fragmented = false;
+    size_t boxesRead = 0;
+    FragmentDefaults trackDefaults;
+
+    // Sample offsets as they are found; BuildIndex packs them into index
+    std::vector<uint64_t> offsets;
+
+    // Index: the offset of sample n is bases[n / kGroupSamples] + index[n].offset
+    std::vector<uint64_t> bases;
+    std::vector<IndexEntry> index;
+    std::vector<TimeRun> timeRuns;
+    size_t sampleCount = 0;
+    uint64_t duration = 0;
+};
+
+#endif // MP4_READER_H
@@ -0,0 +1,625 @@
+#include "OggDecoder.h"
+#include "OggReader.h"
+#include "dsp/VectorOps.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#ifdef ENABLE_VORBIS
+#include <vorbis/codec.h>
+#endif
+
+#ifdef ENABLE_OPUS
+#include <opus/opus_multistream.h>
+#endif
+
+// Implementation of the Ogg Vorbis and Opus decoder
+
+namespace {
+
+// Frames per pooled block
+const size_t kBlockFrames = 8192;
+
+// Most frames one packet decodes to (120ms of Opus; Vorbis returns at most 4096)
+const size_t kMaxPacketFrames = 5760;
+
+// Opus decodes at 48kHz, and its granule positions count 48kHz samples
+const int kOpusRate = 48000;
+
+// Decoding Opus for 80ms before a seek target lets the decoder converge (RFC 7845 section 4.6)
+const int64_t kOpusPrerollFrames = 3840;
+
+uint16_t ReadLE16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadLE32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Vorbis channel order (Vorbis I section 4.3.9, also Opus mapping family 1) in WAV terms:
+// the speaker mask, and for each WAV channel the Vorbis channel that feeds it
+struct ChannelOrder {
+    uint32_t mask;
+    unsigned char source[8];
+};
+
+const ChannelOrder kVorbisOrders[8] = {
+    {0x4, {0}},                          // Mono
+    {0x3, {0, 1}},                       // L R
+    {0x7, {0, 2, 1}},                    // L C R
+    {0x33, {0, 1, 2, 3}},                // FL FR BL BR
+    {0x37, {0, 2, 1, 3, 4}},             // FL C FR BL BR
+    {0x3F, {0, 2, 1, 5, 3, 4}},          // FL C FR BL BR LFE
+    {0x70F, {0, 2, 1, 6, 5, 3, 4}},      // FL C FR SL SR BC LFE
+    {0x63F, {0, 2, 1, 7, 5, 6, 3, 4}},   // FL C FR SL SR BL BR LFE
+};
+
+enum class Codec { None, Vorbis, Opus };
+
+} // namespace
+
+class OggDecoder::Impl {
+public:
+    /**
+     * @brief Pooled block of decoded interleaved frames
+     */
+    struct Block {
+        std::vector<float> samples;   // kBlockFrames frames
+        size_t frames = 0;            // Frames decoded into the block
+        size_t read = 0;              // Frames already returned or dropped
+    };
+
+    OggReader reader;
+    Codec codec = Codec::None;
+    int sampleRate = 0;
+    int channels = 0;
+    int64_t preSkip = 0;              // Granule position of the first frame (Opus)
+    int64_t preroll = 0;              // Frames decoded ahead of a seek target
+    uint64_t frameCount = 0;
+    int64_t penultimateGranule = -1;  // Seeks start before this page, so they see the end trim
+    ChannelLayout layout;
+    unsigned char order[255] = {};    // Decoder channel feeding each output channel
+
+    // Block pool and the queue of decoded blocks
+    std::vector<std::unique_ptr<Block>> blocks;
+    std::vector<Block*> freeBlocks;
+    std::vector<Block*> queue;        // In stream order, from queueHead
+    size_t queueHead = 0;
+    size_t queuedFrames = 0;          // Decoded frames not yet returned
+    size_t pendingFrames = 0;         // Trailing queued frames whose page has not ended yet
+    std::vector<float> packetBuffer;  // Opus packet that does not fit the tail block
+
+    // Placement on the timeline
+    bool positionKnown = false;
+    bool atStreamStart = true;        // Decoding from the first audio page
+    int64_t headGranule = 0;          // Granule position of the first queued frame, once known
+    int64_t trimBefore = 0;           // Frames before this granule position are dropped
+    bool finished = false;
+
+#ifdef ENABLE_VORBIS
+    vorbis_info vorbisInfo;
+    vorbis_comment vorbisComment;
+    vorbis_dsp_state vorbisDsp;
+    vorbis_block vorbisBlock;
+    bool vorbisHeaders = false;
+    bool vorbisReady = false;
+#endif
+
+#ifdef ENABLE_OPUS
+    OpusMSDecoder* opusDecoder = nullptr;
+#endif
+
+    bool OpenVorbis(const OggReader::Packet& identification);
+    bool OpenOpus(const OggReader::Packet& head);
+    void SetVorbisOrder();
+    void ReleaseCodec();
+    void ResetCodec();
+    size_t DecodePacket(const OggReader::Packet& packet);
+    bool DecodeNext();
+    void Place(int64_t granulePosition, bool endOfStream);
+    Block* TailBlock(size_t frames);
+    void Append(const float* samples, size_t frames);
+    void PopFront();
+    void DropFront(size_t frames);
+    void DropBack(size_t frames);
+    void ClearQueue();
+};
+
+void OggDecoder::Impl::SetVorbisOrder() {
+    for (int channel = 0; channel < channels; channel++) {
+        order[channel] = static_cast<unsigned char>(channel);
+    }
+    if (channels <= 8) {
+        const ChannelOrder& vorbis = kVorbisOrders[channels - 1];
+        std::copy(vorbis.source, vorbis.source + channels, order);
+        layout = ChannelLayout::FromMask(vorbis.mask, channels);
+    } else {
+        layout = ChannelLayout::FromMask(0, channels);
+    }
+}
+
+bool OggDecoder::Impl::OpenVorbis(const OggReader::Packet& identification) {
+    // Identification header (Vorbis I section 4.2.2)
+    const unsigned char* header = identification.data;
+    if (identification.size < 30 || ReadLE32(header + 7) != 0 || header[11] == 0 || ReadLE32(header + 12) == 0) {
+        std::cout << "Error: Invalid Vorbis identification header\n";
+        return false;
+    }
+    channels = header[11];
+    sampleRate = static_cast<int>(ReadLE32(header + 12));
+    preSkip = 0;
+    preroll = int64_t(1) << (header[28] >> 4);   // Long block size
+    SetVorbisOrder();
+
+#ifdef ENABLE_VORBIS
+    vorbis_info_init(&vorbisInfo);
+    vorbis_comment_init(&vorbisComment);
+    vorbisHeaders = true;
+
+    // Identification, comment and setup headers
+    OggReader::Packet packet = identification;
+    for (int index = 0; index < 3; index++) {
+        if (index > 0 && !reader.ReadPacket(packet)) {
+            std::cout << "Error: Vorbis headers incomplete\n";
+            return false;
+        }
+        ogg_packet op = {};
+        op.packet = const_cast<unsigned char*>(packet.data);
+        op.bytes = static_cast<long>(packet.size);
+        op.b_o_s = index == 0;
+        op.granulepos = -1;
+        op.packetno = index;
+        if (vorbis_synthesis_headerin(&vorbisInfo, &vorbisComment, &op) != 0) {
+            std::cout << "Error: Invalid Vorbis header\n";
+            return false;
+        }
+    }
+    if (vorbis_synthesis_init(&vorbisDsp, &vorbisInfo) != 0) {
+        std::cout << "Error: Could not initialize Vorbis decoder\n";
+        return false;
+    }
+    vorbis_block_init(&vorbisDsp, &vorbisBlock);
+    vorbisReady = true;
+    codec = Codec::Vorbis;
+    return true;
+#else
+    std::cout << "Error: Vorbis support not compiled in. Vorbis library not found.\n";
+    return false;
+#endif
+}
+
+bool OggDecoder::Impl::OpenOpus(const OggReader::Packet& head) {
+    // Identification header (RFC 7845 section 5.1)
+    const unsigned char* header = head.data;
+    if (head.size < 19 || (header[8] & 0xF0) != 0 || header[9] == 0) {
+        std::cout << "Error: Invalid Opus identification header\n";
+        return false;
+    }
+    channels = header[9];
+    sampleRate = kOpusRate;
+    preSkip = ReadLE16(header + 10);
+    preroll = kOpusPrerollFrames;
+    const int16_t outputGain = static_cast<int16_t>(ReadLE16(header + 16));
+    const unsigned char family = header[18];
+
+    int streams = 1;
+    int coupledStreams = channels - 1;
+    unsigned char mapping[255] = {0, 1};
+    if (family == 0) {
+        if (channels > 2) {
+            std::cout << "Error: Invalid Opus identification header\n";
+            return false;
+        }
+    } else {
+        if (head.size < 21 + static_cast<size_t>(channels)) {
+            std::cout << "Error: Invalid Opus identification header\n";
+            return false;
+        }
+        streams = header[19];
+        coupledStreams = header[20];
+        std::copy(header + 21, header + 21 + channels, mapping);
+    }
+
+    // Family 0 and 1 use the Vorbis order; permuting the mapping makes the decoder write WAV order
+    if (family <= 1) {
+        SetVorbisOrder();
+        unsigned char coded[255];
+        std::copy(mapping, mapping + channels, coded);
+        for (int channel = 0; channel < channels; channel++) {
+            mapping[channel] = coded[order[channel]];
+        }
+    } else {
+        layout = ChannelLayout::FromMask(0, channels);
+    }
+
+    OggReader::Packet tags;
+    if (!reader.ReadPacket(tags) || tags.size < 8 || std::memcmp(tags.data, "OpusTags", 8) != 0) {
+        std::cout << "Error: Opus comment header missing\n";
+        return false;
+    }
+
+#ifdef ENABLE_OPUS
+    int error = OPUS_OK;
+    opusDecoder = opus_multistream_decoder_create(kOpusRate, channels, streams, coupledStreams, mapping, &error);
+    if (error != OPUS_OK || !opusDecoder) {
+        std::cout << "Error: Could not create Opus decoder: " << opus_strerror(error) << "\n";
+        opusDecoder = nullptr;
+        return false;
+    }
+    if (outputGain != 0) {
+        opus_multistream_decoder_ctl(opusDecoder, OPUS_SET_GAIN(outputGain));
+    }
+    packetBuffer.resize(kMaxPacketFrames * channels);
+    codec = Codec::Opus;
+    return true;
+#else
+    (void)outputGain;
+    (void)streams;
+    (void)coupledStreams;
+    std::cout << "Error: Opus support not compiled in. Opus library not found.\n";
+    return false;
+#endif
+}
+
+void OggDecoder::Impl::ReleaseCodec() {
+#ifdef ENABLE_VORBIS
+    if (vorbisReady) {
+        vorbis_block_clear(&vorbisBlock);
+        vorbis_dsp_clear(&vorbisDsp);
+        vorbisReady = false;
+    }
+    if (vorbisHeaders) {
+        vorbis_comment_clear(&vorbisComment);
+        vorbis_info_clear(&vorbisInfo);
+        vorbisHeaders = false;
+    }
+#endif
+#ifdef ENABLE_OPUS
+    if (opusDecoder) {
+        opus_multistream_decoder_destroy(opusDecoder);
+        opusDecoder = nullptr;
+    }
+#endif
+    codec = Codec::None;
+}
+
+void OggDecoder::Impl::ResetCodec() {
+#ifdef ENABLE_VORBIS
+    if (codec == Codec::Vorbis) {
+        vorbis_synthesis_restart(&vorbisDsp);
+    }
+#endif
+#ifdef ENABLE_OPUS
+    if (codec == Codec::Opus) {
+        opus_multistream_decoder_ctl(opusDecoder, OPUS_RESET_STATE);
+    }
+#endif
+}
+
+OggDecoder::Impl::Block* OggDecoder::Impl::TailBlock(size_t frames) {
+    if (queue.size() > queueHead && kBlockFrames - queue.back()->frames >= frames) {
+        return queue.back();
+    }
+    Block* block;
+    if (!freeBlocks.empty()) {
+        block = freeBlocks.back();
+        freeBlocks.pop_back();
+    } else {
+        blocks.push_back(std::make_unique<Block>());
+        block = blocks.back().get();
+        block->samples.resize(kBlockFrames * channels);
+    }
+    block->frames = 0;
+    block->read = 0;
+    queue.push_back(block);
+    return block;
+}
+
+void OggDecoder::Impl::Append(const float* samples, size_t frames) {
+    while (frames > 0) {
+        Block* block = TailBlock(1);
+        const size_t count = std::min(frames, kBlockFrames - block->frames);
+        std::copy(samples, samples + count * channels, block->samples.data() + block->frames * channels);
+        block->frames += count;
+        samples += count * channels;
+        frames -= count;
+    }
+}
+
+void OggDecoder::Impl::PopFront() {
+    freeBlocks.push_back(queue[queueHead++]);
+    // Compact once half the queue is spent, so it never grows past the pool size
+    if (queueHead == queue.size()) {
+        queue.clear();
+        queueHead = 0;
+    } else if (queueHead * 2 >= queue.size()) {
+        queue.erase(queue.begin(), queue.begin() + queueHead);
+        queueHead = 0;
+    }
+}
+
+void OggDecoder::Impl::DropFront(size_t frames) {
+    while (frames > 0 && queuedFrames > 0) {
+        Block* block = queue[queueHead];
+        const size_t count = std::min(frames, block->frames - block->read);
+        block->read += count;
+        queuedFrames -= count;
+        headGranule += static_cast<int64_t>(count);
+        frames -= count;
+        if (block->read == block->frames) {
+            PopFront();
+        }
+    }
+}
+
+void OggDecoder::Impl::DropBack(size_t frames) {
+    while (frames > 0 && queuedFrames > 0) {
+        Block* block = queue.back();
+        const size_t count = std::min(frames, block->frames - block->read);
+        block->frames -= count;
+        queuedFrames -= count;
+        pendingFrames -= std::min(pendingFrames, count);
+        frames -= count;
+        if (block->frames == block->read) {
+            queue.pop_back();
+            freeBlocks.push_back(block);
+        }
+    }
+}
+
+void OggDecoder::Impl::ClearQueue() {
+    for (size_t i = queueHead; i < queue.size(); i++) {
+        freeBlocks.push_back(queue[i]);
+    }
+    queue.clear();
+    queueHead = 0;
+    queuedFrames = 0;
+    pendingFrames = 0;
+}
+
+size_t OggDecoder::Impl::DecodePacket(const OggReader::Packet& packet) {
+#ifdef ENABLE_VORBIS
+    if (codec == Codec::Vorbis) {
+        ogg_packet op = {};
+        op.packet = const_cast<unsigned char*>(packet.data);
+        op.bytes = static_cast<long>(packet.size);
+        op.granulepos = -1;   // Placement is done here, from the page granule positions
+        op.e_o_s = packet.endOfStream;
+        if (vorbis_synthesis(&vorbisBlock, &op) != 0) {
+            return 0;   // Damaged or not an audio packet
+        }
+        vorbis_synthesis_blockin(&vorbisDsp, &vorbisBlock);
+
+        // Interleave straight from the decoder's planes into the pooled blocks
+        size_t total = 0;
+        float** pcm = nullptr;
+        int available;
+        while ((available = vorbis_synthesis_pcmout(&vorbisDsp, &pcm)) > 0) {
+            for (size_t done = 0; done < static_cast<size_t>(available);) {
+                Block* block = TailBlock(1);
+                const size_t count = std::min(static_cast<size_t>(available) - done, kBlockFrames - block->frames);
+                float* destination = block->samples.data() + block->frames * channels;
+                for (int channel = 0; channel < channels; channel++) {
+                    VectorOps::Interleave(pcm[order[channel]] + done, channels, channel, destination, count);
+                }
+                block->frames += count;
+                done += count;
+            }
+            vorbis_synthesis_read(&vorbisDsp, available);
+            total += available;
+        }
+        return total;
+    }
+#endif
+#ifdef ENABLE_OPUS
+    if (codec == Codec::Opus) {
+        // Decode straight into the tail block when the longest packet fits, else spill through a buffer
+        Block* block = TailBlock(1);
+        const bool direct = kBlockFrames - block->frames >= kMaxPacketFrames;
+        float* destination = direct ? block->samples.data() + block->frames * channels : packetBuffer.data();
+        const int decoded = opus_multistream_decode_float(opusDecoder, packet.data,
+                                                          static_cast<opus_int32>(packet.size), destination,
+                                                          static_cast<int>(kMaxPacketFrames), 0);
+        if (decoded <= 0) {
+            return 0;   // Damaged packet; the following granule position keeps the timeline right
+        }
+        if (direct) {
+            block->frames += decoded;
+        } else {
+            Append(packetBuffer.data(), static_cast<size_t>(decoded));
+        }
+        return static_cast<size_t>(decoded);
+    }
+#endif
+    (void)packet;
+    return 0;
+}
+
+void OggDecoder::Impl::Place(int64_t granulePosition, bool endOfStream) {
+    // The decoded frames end at the page's granule position, except that the last page
+    // may end early: its shorter granule position trims the stream
+    if (!positionKnown) {
+        headGranule = (endOfStream && atStreamStart) ? 0 : granulePosition - static_cast<int64_t>(queuedFrames);
+        positionKnown = true;
+    }
+    const int64_t end = headGranule + static_cast<int64_t>(queuedFrames);
+    if (endOfStream && granulePosition < end) {
+        DropBack(static_cast<size_t>(end - granulePosition));
+    }
+    pendingFrames = 0;
+    if (headGranule < trimBefore) {
+        DropFront(static_cast<size_t>(trimBefore - headGranule));
+    }
+}
+
+bool OggDecoder::Impl::DecodeNext() {
+    if (finished) {
+        return false;
+    }
+    OggReader::Packet packet;
+    if (!reader.ReadPacket(packet)) {
+        // A stream cut short plays what was decoded
+        finished = true;
+        if (!positionKnown) {
+            headGranule = atStreamStart ? 0 : trimBefore;
+            positionKnown = true;
+        }
+        pendingFrames = 0;
+        if (headGranule < trimBefore) {
+            DropFront(static_cast<size_t>(trimBefore - headGranule));
+        }
+        return false;
+    }
+
+    const size_t frames = DecodePacket(packet);
+    queuedFrames += frames;
+    pendingFrames += frames;
+    if (packet.granulePosition >= 0) {
+        Place(packet.granulePosition, packet.endOfStream);
+    }
+    finished = packet.endOfStream;
+    return true;
+}
+
+OggDecoder::OggDecoder() : pImpl(std::make_unique<Impl>()) {}
+
+OggDecoder::~OggDecoder() {
+    Close();
+}
+
+bool OggDecoder::Open(const std::string& filePath) {
+    Close();
+    if (!pImpl->reader.Open(filePath)) {
+        return false;
+    }
+
+    OggReader::Packet packet;
+    bool opened = false;
+    if (!pImpl->reader.ReadPacket(packet)) {
+        std::cout << "Error: Ogg file has no complete packets: " << filePath << "\n";
+    } else if (packet.size >= 8 && std::memcmp(packet.data, "OpusHead", 8) == 0) {
+        opened = pImpl->OpenOpus(packet);
+    } else if (packet.size >= 7 && packet.data[0] == 1 && std::memcmp(packet.data + 1, "vorbis", 6) == 0) {
+        opened = pImpl->OpenVorbis(packet);
+    } else {
+        std::cout << "Error: Ogg file holds neither Vorbis nor Opus: " << filePath << "\n";
+    }
+    if (!opened) {
+        Close();
+        return false;
+    }
+
+    pImpl->reader.MarkDataStart();
+    int64_t last = -1;
+    pImpl->reader.GetFinalGranulePositions(last, pImpl->penultimateGranule);
+    pImpl->frameCount = last > pImpl->preSkip ? static_cast<uint64_t>(last - pImpl->preSkip) : 0;
+    pImpl->positionKnown = false;
+    pImpl->atStreamStart = true;
+    pImpl->trimBefore = pImpl->preSkip;
+    pImpl->finished = false;
+    return true;
+}
+
+size_t OggDecoder::Read(AudioBufferView output) {
+    if (pImpl->codec == Codec::None || output.Channels() != pImpl->channels) {
+        return 0;
+    }
+
+    const int channels = pImpl->channels;
+    size_t frames = 0;
+    while (frames < output.Frames()) {
+        const size_t readable = pImpl->queuedFrames - pImpl->pendingFrames;
+        if (readable == 0) {
+            if (!pImpl->DecodeNext() && pImpl->queuedFrames == pImpl->pendingFrames) {
+                break;
+            }
+            continue;
+        }
+
+        Impl::Block* block = pImpl->queue[pImpl->queueHead];
+        const size_t count = std::min({block->frames - block->read, readable, output.Frames() - frames});
+        const float* source = block->samples.data() + block->read * channels;
+        if (output.IsInterleaved()) {
+            std::copy(source, source + count * channels, output.Data() + frames * channels);
+        } else {
+            for (int channel = 0; channel < channels; channel++) {
+                VectorOps::Deinterleave(source, channels, channel, output.Channel(channel) + frames, count);
+            }
+        }
+        block->read += count;
+        pImpl->queuedFrames -= count;
+        pImpl->headGranule += static_cast<int64_t>(count);
+        frames += count;
+        if (block->read == block->frames) {
+            pImpl->PopFront();
+        }
+    }
+    return frames;
+}
+
+bool OggDecoder::Seek(uint64_t frame) {
+    if (pImpl->codec == Codec::None) {
+        return false;
+    }
+
+    const int64_t target = static_cast<int64_t>(frame) + pImpl->preSkip;
+    const int64_t start = std::min(std::max<int64_t>(0, target - pImpl->preroll), pImpl->penultimateGranule);
+    int64_t pageGranule = -1;
+    if (!pImpl->reader.SeekToGranule(start, pageGranule)) {
+        return false;
+    }
+    pImpl->ClearQueue();
+    pImpl->ResetCodec();
+    pImpl->positionKnown = false;
+    pImpl->atStreamStart = pageGranule < 0;
+    pImpl->trimBefore = target;
+    pImpl->finished = false;
+    return true;
+}
+
+void OggDecoder::Close() {
+    pImpl->reader.Close();
+    pImpl->ReleaseCodec();
+    pImpl->ClearQueue();
+    pImpl->sampleRate = 0;
+    pImpl->channels = 0;
+    pImpl->preSkip = 0;
+    pImpl->frameCount = 0;
+    pImpl->penultimateGranule = -1;
+    pImpl->layout = ChannelLayout();
+    // Blocks are sized for the channel count, so the pool does not outlive the file
+    pImpl->freeBlocks.clear();
+    pImpl->blocks.clear();
+    pImpl->packetBuffer.clear();
+}
+
+int OggDecoder::GetSampleRate() const {
+    return pImpl->sampleRate;
+}
+
+int OggDecoder::GetChannels() const {
+    return pImpl->channels;
+}
+
+uint64_t OggDecoder::GetFrameCount() const {
+    return pImpl->frameCount;
+}
+
+ChannelLayout OggDecoder::GetLayout() const {
+    return pImpl->layout;
+}
+
+std::string OggDecoder::GetFormatName() const {
+    switch (pImpl->codec) {
+        case Codec::Vorbis: return "Vorbis";
+        case Codec::Opus: return "Opus";
+        default: return "";
+    }
+}
+
+size_t OggDecoder::GetPoolSize() const {
+    return pImpl->blocks.size();
+}
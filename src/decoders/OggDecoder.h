@@ -0,0 +1,95 @@
+#ifndef OGG_DECODER_H
+#define OGG_DECODER_H
+
+#include "AudioBufferView.h"
+#include "dsp/ChannelLayout.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Streaming decoder for Ogg Vorbis (requires ENABLE_VORBIS) and Ogg Opus
+ *        (requires ENABLE_OPUS) files
+ *
+ * Packets are decoded into fixed-size float blocks taken from a pool and
+ * returned to it as the caller reads them, so once the pool has grown to a
+ * page's worth of audio, decoding allocates nothing. Samples are placed on
+ * the timeline by page granule positions: the Opus pre-skip, the trim at the
+ * end of the stream and the start of decoding after a seek all come from
+ * them. Seeking bisects the file for a page shortly before the target, so
+ * the codec has time to settle, and drops the decoded samples that precede
+ * it. Channels are returned in WAV order.
+ */
+class OggDecoder {
+public:
+    /**
+     * @brief Constructor
+     */
+    OggDecoder();
+
+    /**
+     * @brief Destructor
+     */
+    ~OggDecoder();
+
+    /**
+     * @brief Open an Ogg file and read its codec headers
+     * @param filePath Path to the file; the codec is detected from its first packet
+     * @return true if successful, false otherwise
+     */
+    bool Open(const std::string& filePath);
+
+    /**
+     * @brief Decode the next frames
+     * @param output Receives up to output.Frames() frames (either layout, GetChannels() channels)
+     * @return Number of frames decoded, 0 at the end of the stream
+     */
+    size_t Read(AudioBufferView output);
+
+    /**
+     * @brief Continue decoding from a frame
+     * @param frame Frame index from the start of the stream
+     * @return true if successful, false otherwise
+     */
+    bool Seek(uint64_t frame);
+
+    /**
+     * @brief Close the file
+     */
+    void Close();
+
+    /**
+     * @brief Get the output rate in Hz (Opus always decodes at 48kHz)
+     */
+    int GetSampleRate() const;
+
+    int GetChannels() const;
+
+    /**
+     * @brief Get the stream length in frames, from the last page's granule position
+     */
+    uint64_t GetFrameCount() const;
+
+    /**
+     * @brief Get the speaker layout of the returned channels
+     */
+    ChannelLayout GetLayout() const;
+
+    /**
+     * @brief Get the codec name, "Vorbis" or "Opus"
+     */
+    std::string GetFormatName() const;
+
+    /**
+     * @brief Get the number of pooled blocks (the most that were in use at once)
+     */
+    size_t GetPoolSize() const;
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // OGG_DECODER_H
@@ -0,0 +1,344 @@
+#include "OggReader.h"
+#include "encoders/OggWriter.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// Implementation of the Ogg demuxer
+
+namespace {
+
+const size_t kHeaderBytes = 27;
+
+// Largest possible page: header, 255 lacing values and 255 full segments
+const size_t kMaxPageBytes = kHeaderBytes + 255 + 255 * 255;
+
+// Bytes read at a time while looking for a capture pattern
+const size_t kScanChunkBytes = 4096;
+
+// Seeking bisects until the range is this small, then scans it page by page
+const uint64_t kLinearScanBytes = 16384;
+
+// Initial size of the tail searched for the last granule position
+const uint64_t kTailBytes = 65536;
+
+// Header type flags
+const unsigned char kFlagContinued = 0x01;
+const unsigned char kFlagBeginOfStream = 0x02;
+const unsigned char kFlagEndOfStream = 0x04;
+
+uint32_t ReadLE32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+} // namespace
+
+OggReader::OggReader() = default;
+
+OggReader::~OggReader() = default;
+
+bool OggReader::Open(const std::string& filePath) {
+    Close();
+    file.open(filePath, std::ios::binary);
+    if (!file) {
+        std::cout << "Error: Could not open file for reading: " << filePath << "\n";
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    fileSize = static_cast<uint64_t>(file.tellg());
+
+    page.reserve(kMaxPageBytes);
+    scanPage.reserve(kMaxPageBytes);
+    packet.reserve(kMaxPageBytes);
+    scanChunk.resize(kScanChunkBytes);
+
+    PageInfo first;
+    if (!ParsePage(0, scanPage, first) || !(first.flags & kFlagBeginOfStream)) {
+        std::cout << "Error: Not an Ogg file: " << filePath << "\n";
+        Close();
+        return false;
+    }
+    serialNumber = first.serialNumber;
+    dataStart = 0;
+    ResetPackets(0);
+    return true;
+}
+
+void OggReader::Close() {
+    if (file.is_open()) {
+        file.close();
+    }
+    file.clear();
+    fileSize = 0;
+    serialNumber = 0;
+    dataStart = 0;
+    pagesRead = 0;
+    ResetPackets(0);
+}
+
+bool OggReader::ReadAt(uint64_t offset, unsigned char* data, size_t size) {
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(size));
+    return static_cast<size_t>(file.gcount()) == size;
+}
+
+bool OggReader::ParsePage(uint64_t offset, std::vector<unsigned char>& buffer, PageInfo& info) {
+    if (offset + kHeaderBytes > fileSize) {
+        return false;
+    }
+    buffer.resize(kHeaderBytes);
+    if (!ReadAt(offset, buffer.data(), kHeaderBytes) || std::memcmp(buffer.data(), "OggS", 4) != 0 ||
+        buffer[4] != 0) {
+        return false;
+    }
+
+    const size_t segments = buffer[26];
+    buffer.resize(kHeaderBytes + segments);
+    if (!ReadAt(offset + kHeaderBytes, buffer.data() + kHeaderBytes, segments)) {
+        return false;
+    }
+    size_t bodySize = 0;
+    for (size_t i = 0; i < segments; i++) {
+        bodySize += buffer[kHeaderBytes + i];
+    }
+    const size_t size = kHeaderBytes + segments + bodySize;
+    if (offset + size > fileSize) {
+        return false;
+    }
+    buffer.resize(size);
+    if (!ReadAt(offset + kHeaderBytes + segments, buffer.data() + kHeaderBytes + segments, bodySize)) {
+        return false;
+    }
+
+    // The checksum covers the page with its own field zeroed
+    const uint32_t expected = ReadLE32(&buffer[22]);
+    unsigned char stored[4];
+    std::memcpy(stored, &buffer[22], 4);
+    std::memset(&buffer[22], 0, 4);
+    const uint32_t actual = OggWriter::Checksum(buffer.data(), buffer.size());
+    std::memcpy(&buffer[22], stored, 4);
+    if (actual != expected) {
+        return false;
+    }
+
+    uint64_t granule = 0;
+    for (int i = 7; i >= 0; i--) {
+        granule = (granule << 8) | buffer[6 + i];
+    }
+    info.offset = offset;
+    info.size = size;
+    info.granulePosition = static_cast<int64_t>(granule);
+    info.serialNumber = ReadLE32(&buffer[14]);
+    info.sequence = ReadLE32(&buffer[18]);
+    info.flags = buffer[5];
+    info.segments = segments;
+    pagesRead++;
+    return true;
+}
+
+bool OggReader::FindPage(uint64_t offset, uint64_t limit, std::vector<unsigned char>& buffer, PageInfo& info) {
+    limit = std::min(limit, fileSize);
+    while (offset < limit) {
+        // Find the next capture pattern, then check that a valid page starts there
+        uint64_t capture = limit;
+        for (uint64_t chunk = offset; chunk + 4 <= fileSize && chunk < limit; chunk += kScanChunkBytes - 3) {
+            const size_t size = static_cast<size_t>(std::min<uint64_t>(kScanChunkBytes, fileSize - chunk));
+            if (!ReadAt(chunk, scanChunk.data(), size)) {
+                return false;
+            }
+            const unsigned char* begin = scanChunk.data();
+            const unsigned char* end = begin + size;
+            const unsigned char pattern[] = {'O', 'g', 'g', 'S'};
+            const unsigned char* found = std::search(begin, end, pattern, pattern + 4);
+            if (found != end) {
+                capture = chunk + (found - begin);
+                break;
+            }
+        }
+        if (capture >= limit) {
+            return false;
+        }
+        if (ParsePage(capture, buffer, info)) {
+            return true;
+        }
+        offset = capture + 1;
+    }
+    return false;
+}
+
+bool OggReader::FindStreamPage(uint64_t offset, uint64_t limit, bool withGranule, PageInfo& info) {
+    while (FindPage(offset, limit, scanPage, info)) {
+        if (info.serialNumber == serialNumber && (!withGranule || info.granulePosition >= 0)) {
+            return true;
+        }
+        offset = info.offset + info.size;
+    }
+    return false;
+}
+
+void OggReader::ResetPackets(uint64_t offset) {
+    pageLoaded = false;
+    segment = 0;
+    bodyOffset = 0;
+    lastCompleted = 0;
+    nextPageOffset = offset;
+    haveSequence = false;
+    continuing = false;
+    skipContinued = false;
+}
+
+bool OggReader::LoadNextPage() {
+    PageInfo info;
+    do {
+        if (!FindPage(nextPageOffset, fileSize, page, info)) {
+            return false;
+        }
+        nextPageOffset = info.offset + info.size;
+    } while (info.serialNumber != serialNumber);
+
+    // A packet loses its end when a page is missing or the next page starts afresh,
+    // and its start when the reader begins on a page continuing it
+    if (haveSequence && info.sequence != lastSequence + 1) {
+        continuing = false;
+    }
+    const bool continued = (info.flags & kFlagContinued) != 0;
+    if (!continued) {
+        continuing = false;
+        skipContinued = false;
+    } else if (!continuing) {
+        skipContinued = true;
+    }
+    lastSequence = info.sequence;
+    haveSequence = true;
+
+    current = info;
+    pageLoaded = true;
+    segment = 0;
+    bodyOffset = kHeaderBytes + info.segments;
+    lastCompleted = info.segments;
+    for (size_t i = info.segments; i-- > 0;) {
+        if (page[kHeaderBytes + i] < 255) {
+            lastCompleted = i;
+            break;
+        }
+    }
+    return true;
+}
+
+bool OggReader::ReadPacket(Packet& out) {
+    if (!file.is_open()) {
+        return false;
+    }
+    while (true) {
+        if (!pageLoaded || segment == current.segments) {
+            if (pageLoaded && (current.flags & kFlagEndOfStream)) {
+                return false;
+            }
+            if (!LoadNextPage()) {
+                return false;
+            }
+        }
+
+        // Gather the segments of one packet, or of the part of it on this page
+        const size_t start = bodyOffset;
+        bool complete = false;
+        while (segment < current.segments) {
+            const unsigned char value = page[kHeaderBytes + segment++];
+            bodyOffset += value;
+            if (value < 255) {
+                complete = true;
+                break;
+            }
+        }
+
+        if (skipContinued) {
+            skipContinued = !complete;
+            continue;
+        }
+        if (!complete || continuing) {
+            if (!continuing) {
+                packet.clear();
+            }
+            packet.insert(packet.end(), page.begin() + start, page.begin() + bodyOffset);
+            continuing = !complete;
+            if (!complete) {
+                continue;
+            }
+            out.data = packet.data();
+            out.size = packet.size();
+        } else {
+            out.data = page.data() + start;
+            out.size = bodyOffset - start;
+        }
+
+        const bool lastOnPage = segment - 1 == lastCompleted;
+        out.granulePosition = lastOnPage ? current.granulePosition : -1;
+        out.endOfStream = lastOnPage && (current.flags & kFlagEndOfStream) != 0;
+        return true;
+    }
+}
+
+void OggReader::MarkDataStart() {
+    dataStart = nextPageOffset;
+}
+
+bool OggReader::SeekToGranule(int64_t granulePosition, int64_t& pageGranule) {
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // Bisect on the first page with a granule position after the middle of the range
+    uint64_t low = dataStart;
+    uint64_t high = fileSize;
+    int64_t bestGranule = -1;
+    uint64_t bestEnd = dataStart;
+    PageInfo info;
+    while (high - low > kLinearScanBytes) {
+        const uint64_t middle = low + (high - low) / 2;
+        if (!FindStreamPage(middle, high, true, info)) {
+            high = middle;
+        } else if (info.granulePosition < granulePosition) {
+            bestGranule = info.granulePosition;
+            bestEnd = info.offset + info.size;
+            low = bestEnd;
+        } else {
+            high = middle;
+        }
+    }
+
+    // The remaining range holds a few pages
+    uint64_t offset = low;
+    while (FindStreamPage(offset, fileSize, true, info) && info.granulePosition < granulePosition) {
+        bestGranule = info.granulePosition;
+        bestEnd = info.offset + info.size;
+        offset = bestEnd;
+    }
+
+    pageGranule = bestGranule;
+    ResetPackets(bestEnd);
+    return true;
+}
+
+bool OggReader::GetFinalGranulePositions(int64_t& last, int64_t& previous) {
+    last = -1;
+    previous = -1;
+    if (!file.is_open()) {
+        return false;
+    }
+    for (uint64_t window = kTailBytes; ; window *= 4) {
+        const uint64_t start = fileSize > window ? fileSize - window : 0;
+        last = -1;
+        previous = -1;
+        PageInfo info;
+        for (uint64_t offset = start; FindStreamPage(offset, fileSize, true, info);
+             offset = info.offset + info.size) {
+            previous = last;
+            last = info.granulePosition;
+        }
+        if (previous >= 0 || start == 0) {
+            return last >= 0;
+        }
+    }
+}
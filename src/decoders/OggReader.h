@@ -0,0 +1,138 @@
+#ifndef OGG_READER_H
+#define OGG_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Streaming Ogg demuxer for the first logical stream of a file (RFC 3533)
+ *
+ * Pages are read one at a time into reused buffers and checked against their
+ * CRC; damaged pages and pages of other logical streams are skipped, and a
+ * packet that loses one of its pages is dropped. Seeking bisects the file on
+ * page granule positions, so it reads a few dozen pages however long the
+ * stream is. Chained streams end at the first stream's last page.
+ */
+class OggReader {
+public:
+    /**
+     * @brief One packet of the stream
+     */
+    struct Packet {
+        const unsigned char* data = nullptr;   // Valid until the next call to the reader
+        size_t size = 0;
+        int64_t granulePosition = -1;          // Set on the last packet completed on a page, else -1
+        bool endOfStream = false;              // Last packet of the stream
+    };
+
+    OggReader();
+    ~OggReader();
+
+    /**
+     * @brief Open a file; its first page must begin a logical stream
+     * @param filePath Path to the file
+     * @return true if successful, false otherwise
+     */
+    bool Open(const std::string& filePath);
+
+    /**
+     * @brief Close the file
+     */
+    void Close();
+
+    /**
+     * @brief Read the next packet
+     * @param packet Receives the packet
+     * @return true if a packet was read, false at the end of the stream
+     */
+    bool ReadPacket(Packet& packet);
+
+    /**
+     * @brief Mark where audio data begins, after the header packets
+     *
+     * Codecs start audio on a fresh page, so the mark is the page following
+     * the last packet read. Seeking never goes back further than this.
+     */
+    void MarkDataStart();
+
+    /**
+     * @brief Position the reader for decoding from a granule position
+     *
+     * Finds the last page whose granule position is below the target; the
+     * next packet read is then the first one that starts after that page.
+     * A packet continued from that page is skipped.
+     * @param granulePosition Target granule position
+     * @param pageGranule Receives the granule position of the page found, or -1
+     *                    if the target lies before the first such page (the
+     *                    reader is then at the start of the audio data)
+     * @return true if successful, false otherwise
+     */
+    bool SeekToGranule(int64_t granulePosition, int64_t& pageGranule);
+
+    /**
+     * @brief Get the granule positions of the stream's last two pages that carry one
+     * @param last Receives the last granule position, or -1 if no page carries one
+     * @param previous Receives the one before it, or -1
+     * @return true if the last granule position was found, false otherwise
+     */
+    bool GetFinalGranulePositions(int64_t& last, int64_t& previous);
+
+    /**
+     * @brief Get the number of pages read so far (including those read while seeking)
+     */
+    uint64_t GetPagesRead() const { return pagesRead; }
+
+    uint32_t GetSerialNumber() const { return serialNumber; }
+
+private:
+    /**
+     * @brief Header fields of a page
+     */
+    struct PageInfo {
+        uint64_t offset = 0;     // File offset of the capture pattern
+        size_t size = 0;         // Header, lacing and body
+        int64_t granulePosition = -1;
+        uint32_t serialNumber = 0;
+        uint32_t sequence = 0;
+        unsigned char flags = 0;
+        size_t segments = 0;
+    };
+
+    bool ReadAt(uint64_t offset, unsigned char* data, size_t size);
+    bool ParsePage(uint64_t offset, std::vector<unsigned char>& buffer, PageInfo& info);
+    bool FindPage(uint64_t offset, uint64_t limit, std::vector<unsigned char>& buffer, PageInfo& info);
+    bool FindStreamPage(uint64_t offset, uint64_t limit, bool withGranule, PageInfo& info);
+    bool LoadNextPage();
+    void ResetPackets(uint64_t offset);
+
+    std::ifstream file;
+    uint64_t fileSize = 0;
+    uint32_t serialNumber = 0;
+    uint64_t dataStart = 0;
+    uint64_t pagesRead = 0;
+
+    // Page being split into packets
+    std::vector<unsigned char> page;
+    PageInfo current;
+    bool pageLoaded = false;
+    size_t segment = 0;           // Next lacing value
+    size_t bodyOffset = 0;        // Next body byte, from the start of the page
+    size_t lastCompleted = 0;     // Lacing index that completes the page's last packet (segments if none)
+    uint64_t nextPageOffset = 0;
+    uint32_t lastSequence = 0;
+    bool haveSequence = false;
+
+    // Packet spanning pages
+    std::vector<unsigned char> packet;
+    bool continuing = false;      // packet holds the start of an unfinished packet
+    bool skipContinued = false;   // Drop the packet continued from a page that was not read
+
+    // Pages read while scanning, kept apart from the page being split
+    std::vector<unsigned char> scanPage;
+    std::vector<unsigned char> scanChunk;
+};
+
+#endif // OGG_READER_H
@@ -0,0 +1,223 @@
+#include "AnalysisTap.h"
+#include "FFT.h"
+#include "core/LockFreeRingBuffer.h"
+#include "core/SeqlockSnapshot.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Implementation of the playback analysis tap
+
+// Seconds of audio the ring buffer holds before the audio thread starts dropping frames
+static const double kRingSeconds = 0.25;
+
+// Frames consumed per analysis step (also the spectrum hop size)
+static const size_t kHopFrames = kSpectrumFFTSize / 2;
+
+// How long the analysis thread sleeps when the ring is empty
+static const int kPollMilliseconds = 10;
+
+// Meter ballistics
+static const double kPeakFallDbPerSecond = 20.0;
+static const double kRmsIntegrationSeconds = 0.3;
+
+// Weight of the previous spectrum in the running average
+static const float kSpectrumSmoothing = 0.5f;
+
+// Floor used when converting magnitudes to dB
+static const float kMinimumDb = -140.0f;
+
+class AnalysisTap::Impl {
+public:
+    int sampleRate = 0;
+    int channels = 0;
+
+    // Audio thread -> analysis thread
+    LockFreeRingBuffer<float> ring;
+    std::atomic<uint64_t> framesDropped{0};
+
+    // Analysis thread
+    std::thread thread;
+    std::atomic<bool> running{false};
+
+    // Analysis thread -> readers
+    SeqlockSnapshot<LevelSnapshot> levels;
+    SeqlockSnapshot<SpectrumSnapshot> spectrum;
+
+    void Run();
+    static void LowerThreadPriority();
+};
+
+void AnalysisTap::Impl::LowerThreadPriority() {
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__linux__) && defined(SCHED_IDLE)
+    sched_param parameters = {};
+    parameters.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &parameters);
+#endif
+}
+
+void AnalysisTap::Impl::Run() {
+    LowerThreadPriority();
+
+    const size_t meteredChannels = static_cast<size_t>(std::min(channels, kAnalysisMaxChannels));
+    const double hopSeconds = static_cast<double>(kHopFrames) / sampleRate;
+    const float peakFall = static_cast<float>(std::pow(10.0, -kPeakFallDbPerSecond * hopSeconds / 20.0));
+    const float rmsCoefficient = static_cast<float>(1.0 - std::exp(-hopSeconds / kRmsIntegrationSeconds));
+
+    // All buffers are allocated once, before the loop
+    std::vector<float> block(kHopFrames * channels);
+    std::vector<float> window(kSpectrumFFTSize);
+    std::vector<float> history(kSpectrumFFTSize, 0.0f);
+    std::vector<float> windowed(kSpectrumFFTSize);
+    std::vector<float> re(kSpectrumBinCount);
+    std::vector<float> im(kSpectrumBinCount);
+    std::vector<float> power(kSpectrumBinCount, 0.0f);
+    std::vector<double> meanSquare(meteredChannels, 0.0);
+    FFT fft(kSpectrumFFTSize);
+
+    double windowSum = 0.0;
+    for (size_t i = 0; i < kSpectrumFFTSize; i++) {
+        window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / kSpectrumFFTSize));
+        windowSum += window[i];
+    }
+    // A full-scale sine peaks at windowSum / 2 in its bin
+    const float magnitudeScale = static_cast<float>(2.0 / windowSum);
+
+    LevelSnapshot levelSnapshot;
+    levelSnapshot.channels = static_cast<int>(meteredChannels);
+    levelSnapshot.sampleRate = sampleRate;
+    SpectrumSnapshot spectrumSnapshot;
+    spectrumSnapshot.sampleRate = sampleRate;
+    std::fill(std::begin(spectrumSnapshot.magnitudeDb), std::end(spectrumSnapshot.magnitudeDb), kMinimumDb);
+
+    levels.Publish(levelSnapshot);
+    spectrum.Publish(spectrumSnapshot);
+
+    while (running.load()) {
+        if (ring.GetReadAvailable() < block.size()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kPollMilliseconds));
+            continue;
+        }
+        ring.Read(block.data(), block.size());
+
+        // Peak/RMS meters
+        for (size_t ch = 0; ch < meteredChannels; ch++) {
+            float blockPeak = 0.0f;
+            double sumOfSquares = 0.0;
+            for (size_t i = 0; i < kHopFrames; i++) {
+                float sample = block[i * channels + ch];
+                blockPeak = std::max(blockPeak, std::fabs(sample));
+                sumOfSquares += static_cast<double>(sample) * sample;
+            }
+            levelSnapshot.peak[ch] = std::max(blockPeak, levelSnapshot.peak[ch] * peakFall);
+            meanSquare[ch] += rmsCoefficient * (sumOfSquares / kHopFrames - meanSquare[ch]);
+            levelSnapshot.rms[ch] = static_cast<float>(std::sqrt(meanSquare[ch]));
+        }
+        levelSnapshot.framesAnalyzed += kHopFrames;
+        levelSnapshot.framesDropped = framesDropped.load(std::memory_order_relaxed);
+        levels.Publish(levelSnapshot);
+
+        // Slide the mono mix into the FFT history (50% overlap)
+        std::copy(history.begin() + kHopFrames, history.end(), history.begin());
+        const float mixGain = 1.0f / channels;
+        for (size_t i = 0; i < kHopFrames; i++) {
+            float sum = 0.0f;
+            for (int ch = 0; ch < channels; ch++) {
+                sum += block[i * channels + ch];
+            }
+            history[kSpectrumFFTSize - kHopFrames + i] = sum * mixGain;
+        }
+
+        for (size_t i = 0; i < kSpectrumFFTSize; i++) {
+            windowed[i] = history[i] * window[i];
+        }
+        fft.ForwardReal(windowed.data(), re.data(), im.data());
+
+        for (size_t bin = 0; bin < kSpectrumBinCount; bin++) {
+            float magnitude = std::sqrt(re[bin] * re[bin] + im[bin] * im[bin]) * magnitudeScale;
+            power[bin] = kSpectrumSmoothing * power[bin] + (1.0f - kSpectrumSmoothing) * magnitude * magnitude;
+            spectrumSnapshot.magnitudeDb[bin] = std::max(kMinimumDb, 10.0f * std::log10(power[bin] + 1e-30f));
+        }
+        spectrumSnapshot.frameCount++;
+        spectrum.Publish(spectrumSnapshot);
+    }
+}
+
+AnalysisTap::AnalysisTap() : pImpl(std::make_unique<Impl>()) {}
+
+AnalysisTap::~AnalysisTap() {
+    Stop();
+}
+
+bool AnalysisTap::Start(int sampleRate, int channels, size_t burstFrames) {
+    Stop();
+    if (sampleRate <= 0 || channels <= 0) {
+        return false;
+    }
+
+    pImpl->sampleRate = sampleRate;
+    pImpl->channels = channels;
+    size_t ringFrames = std::max(static_cast<size_t>(sampleRate * kRingSeconds), 4 * kHopFrames) + burstFrames;
+    pImpl->ring.Reset(ringFrames * channels);
+    pImpl->framesDropped.store(0);
+
+    pImpl->running.store(true);
+    pImpl->thread = std::thread(&Impl::Run, pImpl.get());
+    return true;
+}
+
+void AnalysisTap::Stop() {
+    pImpl->running.store(false);
+    if (pImpl->thread.joinable()) {
+        pImpl->thread.join();
+    }
+}
+
+bool AnalysisTap::IsRunning() const {
+    return pImpl->running.load();
+}
+
+void AnalysisTap::Push(const float* samples, size_t frameCount) {
+    if (!pImpl->running.load(std::memory_order_relaxed) || frameCount == 0) {
+        return;
+    }
+
+    // Only whole frames are written so the reader never loses channel alignment
+    const size_t channels = static_cast<size_t>(pImpl->channels);
+    size_t frames = std::min(frameCount, pImpl->ring.GetWriteSpace() / channels);
+    if (frames > 0) {
+        pImpl->ring.Write(samples, frames * channels);
+    }
+    if (frames < frameCount) {
+        pImpl->framesDropped.fetch_add(frameCount - frames, std::memory_order_relaxed);
+    }
+}
+
+bool AnalysisTap::GetLevels(LevelSnapshot& levels) const {
+    if (pImpl->levels.GetVersion() == 0) {
+        return false;
+    }
+    return pImpl->levels.Read(levels);
+}
+
+bool AnalysisTap::GetSpectrum(SpectrumSnapshot& spectrum) const {
+    if (pImpl->spectrum.GetVersion() == 0) {
+        return false;
+    }
+    return pImpl->spectrum.Read(spectrum);
+}
\ No newline at end of file
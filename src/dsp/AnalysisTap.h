@@ -0,0 +1,75 @@
+#ifndef ANALYSIS_TAP_H
+#define ANALYSIS_TAP_H
+
+#include "AudioAnalysis.h"
+#include <memory>
+
+/**
+ * @brief Level and spectrum analysis of the playback output off the audio thread
+ *
+ * The audio thread copies each rendered block into a lock-free ring buffer with
+ * Push, which never blocks or allocates (frames are dropped and counted if the
+ * analysis thread falls behind). A low-priority thread computes peak/RMS meters
+ * and a windowed FFT spectrum and publishes them through seqlock snapshots, so
+ * any number of readers can poll without affecting playback.
+ */
+class AnalysisTap {
+public:
+    /**
+     * @brief Constructor
+     */
+    AnalysisTap();
+
+    /**
+     * @brief Destructor, stops the analysis thread
+     */
+    ~AnalysisTap();
+
+    /**
+     * @brief Allocate buffers and start the analysis thread for a stream format
+     * @param sampleRate Sample rate in Hz
+     * @param channels Number of interleaved channels
+     * @param burstFrames Most frames the audio thread pushes in one go, e.g. to fill the device queue
+     * @return true if the analysis thread was started, false otherwise
+     */
+    bool Start(int sampleRate, int channels, size_t burstFrames = 0);
+
+    /**
+     * @brief Stop the analysis thread
+     */
+    void Stop();
+
+    /**
+     * @brief Check whether the analysis thread is running
+     * @return true if running, false otherwise
+     */
+    bool IsRunning() const;
+
+    /**
+     * @brief Copy a block of interleaved output samples into the tap (audio thread)
+     * @param samples Interleaved samples
+     * @param frameCount Number of frames
+     */
+    void Push(const float* samples, size_t frameCount);
+
+    /**
+     * @brief Read the latest meter values
+     * @param levels Receives the snapshot
+     * @return true if a snapshot was available, false otherwise
+     */
+    bool GetLevels(LevelSnapshot& levels) const;
+
+    /**
+     * @brief Read the latest spectrum
+     * @param spectrum Receives the snapshot
+     * @return true if a snapshot was available, false otherwise
+     */
+    bool GetSpectrum(SpectrumSnapshot& spectrum) const;
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // ANALYSIS_TAP_H
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "ChannelLayout.h"
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+// Implementation of channel layouts
+
+namespace {
+
+struct NamedLayout {
+    const char* name;
+    uint32_t mask;
+};
+
+// Common layouts as WAVE_FORMAT_EXTENSIBLE masks
+const NamedLayout kNamedLayouts[] = {
+    {"mono", 0x4},          // FC
+    {"stereo", 0x3},        // FL FR
+    {"2.1", 0xB},           // FL FR LFE
+    {"3.0", 0x7},           // FL FR FC
+    {"quad", 0x33},         // FL FR BL BR
+    {"5.0", 0x37},          // FL FR FC BL BR
+    {"5.1", 0x3F},          // FL FR FC LFE BL BR
+    {"6.1", 0x70F},         // FL FR FC LFE BC SL SR
+    {"7.1", 0x63F},         // FL FR FC LFE BL BR SL SR
+    {"5.1.4", 0x2D03F},     // 5.1 + TFL TFR TBL TBR
+    {"7.1.4", 0x2D63F}      // 7.1 + TFL TFR TBL TBR
+};
+
+const char* const kSpeakerNames[] = {
+    "FL", "FR", "FC", "LFE", "BL", "BR", "FLC", "FRC", "BC", "SL", "SR",
+    "TC", "TFL", "TFC", "TFR", "TBL", "TBC", "TBR"
+};
+
+int CountBits(uint32_t mask) {
+    int count = 0;
+    for (; mask != 0; mask &= mask - 1) {
+        count++;
+    }
+    return count;
+}
+
+} // namespace
+
+ChannelLayout ChannelLayout::FromMask(uint32_t mask, int channels) {
+    mask &= (1u << kSpeakerCount) - 1;
+    if (mask == 0) {
+        return Default(channels);
+    }
+
+    ChannelLayout layout;
+    for (int bit = 0; bit < kSpeakerCount && layout.GetChannelCount() < channels; bit++) {
+        if (mask & (1u << bit)) {
+            layout.speakers.push_back(static_cast<Speaker>(bit));
+        }
+    }
+    while (layout.GetChannelCount() < channels) {
+        layout.speakers.push_back(Speaker::Aux);
+    }
+    return layout;
+}
+
+ChannelLayout ChannelLayout::Default(int channels) {
+    // FLAC channel assignments (format specification, section "Channels")
+    static const uint32_t kDefaultMasks[] = {0, 0x4, 0x3, 0x7, 0x33, 0x37, 0x3F, 0x70F, 0x63F};
+
+    uint32_t mask = 0;
+    if (channels > 0 && channels <= 8) {
+        mask = kDefaultMasks[channels];
+    } else if (channels == 10) {
+        mask = 0x2D03F;
+    } else if (channels == 12) {
+        mask = 0x2D63F;
+    }
+
+    if (mask != 0) {
+        return FromMask(mask, channels);
+    }
+    ChannelLayout layout;
+    layout.speakers.assign(std::max(channels, 0), Speaker::Aux);
+    return layout;
+}
+
+bool ChannelLayout::Parse(const std::string& name, ChannelLayout& layout) {
+    for (const NamedLayout& named : kNamedLayouts) {
+        if (name == named.name) {
+            layout = FromMask(named.mask, CountBits(named.mask));
+            return true;
+        }
+    }
+
+    char* end = nullptr;
+    long channels = std::strtol(name.c_str(), &end, 10);
+    if (!name.empty() && *end == '\0' && channels >= 1 && channels <= 32) {
+        layout = Default(static_cast<int>(channels));
+        return true;
+    }
+    return false;
+}
+
+std::string ChannelLayout::GetKnownNames() {
+    std::string names;
+    for (const NamedLayout& named : kNamedLayouts) {
+        names += names.empty() ? "" : ", ";
+        names += named.name;
+    }
+    return names;
+}
+
+int ChannelLayout::Find(Speaker speaker) const {
+    if (speaker == Speaker::Aux) {
+        return -1;
+    }
+    for (size_t channel = 0; channel < speakers.size(); channel++) {
+        if (speakers[channel] == speaker) {
+            return static_cast<int>(channel);
+        }
+    }
+    return -1;
+}
+
+uint32_t ChannelLayout::GetMask() const {
+    uint32_t mask = 0;
+    for (Speaker speaker : speakers) {
+        if (speaker != Speaker::Aux) {
+            mask |= 1u << static_cast<int>(speaker);
+        }
+    }
+    return mask;
+}
+
+std::string ChannelLayout::GetName() const {
+    const uint32_t mask = GetMask();
+    if (CountBits(mask) == GetChannelCount() && FromMask(mask, GetChannelCount()) == *this) {
+        for (const NamedLayout& named : kNamedLayouts) {
+            if (named.mask == mask) {
+                return named.name;
+            }
+        }
+    }
+    return std::to_string(GetChannelCount()) + (GetChannelCount() == 1 ? " channel" : " channels");
+}
+
+std::string ChannelLayout::Describe() const {
+    std::ostringstream description;
+    description << GetName() << " (";
+    for (size_t channel = 0; channel < speakers.size(); channel++) {
+        description << (channel > 0 ? " " : "") << GetSpeakerName(speakers[channel]);
+    }
+    description << ")";
+    return description.str();
+}
+
+const char* ChannelLayout::GetSpeakerName(Speaker speaker) {
+    int index = static_cast<int>(speaker);
+    return index >= 0 && index < kSpeakerCount ? kSpeakerNames[index] : "AUX";
+}
@@ -0,0 +1,126 @@
+#ifndef CHANNEL_LAYOUT_H
+#define CHANNEL_LAYOUT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Speaker assignment of every channel in an interleaved stream
+ *
+ * Speaker positions follow the WAVE_FORMAT_EXTENSIBLE channel mask bits, so a
+ * mask converts losslessly: channels appear in ascending bit order. Channels
+ * without a position (more channels than mask bits, or formats beyond the
+ * mask such as wide speakers) are auxiliary channels identified by index.
+ */
+class ChannelLayout {
+public:
+    /**
+     * @brief Speaker positions, numbered like the WAVE_FORMAT_EXTENSIBLE mask bits
+     */
+    enum class Speaker {
+        FrontLeft = 0,
+        FrontRight,
+        FrontCenter,
+        LowFrequency,
+        BackLeft,
+        BackRight,
+        FrontLeftOfCenter,
+        FrontRightOfCenter,
+        BackCenter,
+        SideLeft,
+        SideRight,
+        TopCenter,
+        TopFrontLeft,
+        TopFrontCenter,
+        TopFrontRight,
+        TopBackLeft,
+        TopBackCenter,
+        TopBackRight,
+        Aux              // No defined position
+    };
+
+    /**
+     * @brief Number of speaker positions with a mask bit
+     */
+    static const int kSpeakerCount = 18;
+
+    ChannelLayout() = default;
+
+    /**
+     * @brief Build a layout from a WAVE_FORMAT_EXTENSIBLE channel mask
+     * @param mask Channel mask (0 selects the default layout for the channel count)
+     * @param channels Number of channels in the stream
+     * @return Layout; channels beyond the mask bits are auxiliary
+     */
+    static ChannelLayout FromMask(uint32_t mask, int channels);
+
+    /**
+     * @brief Get the default layout for a channel count
+     *
+     * Uses the FLAC channel assignments for 1 to 8 channels (which match the
+     * usual WAV masks), 5.1.4 for 10 and 7.1.4 for 12 channels. Other counts
+     * are auxiliary channels.
+     * @param channels Number of channels
+     * @return Default layout
+     */
+    static ChannelLayout Default(int channels);
+
+    /**
+     * @brief Parse a layout name
+     * @param name "mono", "stereo", "2.1", "quad", "5.0", "5.1", "7.1", "5.1.4", "7.1.4" or a channel count
+     * @param layout Receives the layout
+     * @return true if the name is known, false otherwise
+     */
+    static bool Parse(const std::string& name, ChannelLayout& layout);
+
+    /**
+     * @brief Get the names accepted by Parse
+     * @return Comma-separated list
+     */
+    static std::string GetKnownNames();
+
+    int GetChannelCount() const { return static_cast<int>(speakers.size()); }
+    Speaker GetSpeaker(int channel) const { return speakers[channel]; }
+    bool IsEmpty() const { return speakers.empty(); }
+
+    /**
+     * @brief Find the channel carrying a speaker position
+     * @param speaker Speaker position (not Aux)
+     * @return Channel index, or -1 if the layout has no such speaker
+     */
+    int Find(Speaker speaker) const;
+
+    /**
+     * @brief Get the WAVE_FORMAT_EXTENSIBLE channel mask
+     * @return Mask of the positioned channels (auxiliary channels have no bit)
+     */
+    uint32_t GetMask() const;
+
+    /**
+     * @brief Get a short name such as "5.1" or "10 channels"
+     * @return Layout name
+     */
+    std::string GetName() const;
+
+    /**
+     * @brief Get the name and the speaker of every channel, e.g. "5.1 (FL FR FC LFE BL BR)"
+     * @return Description
+     */
+    std::string Describe() const;
+
+    /**
+     * @brief Get the abbreviation of a speaker position
+     * @param speaker Speaker position
+     * @return Abbreviation such as "FL" or "TBR"
+     */
+    static const char* GetSpeakerName(Speaker speaker);
+
+    bool operator==(const ChannelLayout& other) const { return speakers == other.speakers; }
+    bool operator!=(const ChannelLayout& other) const { return speakers != other.speakers; }
+
+private:
+    std::vector<Speaker> speakers;
+};
+
+#endif // CHANNEL_LAYOUT_H
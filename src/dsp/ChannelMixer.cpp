@@ -0,0 +1,228 @@
+#include "ChannelMixer.h"
+#include "VectorOps.h"
+#include <algorithm>
+#include <cstring>
+
+// Implementation of the channel mixing matrix
+
+namespace {
+
+typedef ChannelLayout::Speaker Speaker;
+
+// Frames deinterleaved per step; small enough to keep 16+16 channels in L1
+const size_t kMixBlockFrames = 256;
+
+// -3dB, the equal-power fold-down gain
+const float kFoldGain = 0.70710678f;
+
+bool Has(const ChannelLayout& layout, Speaker speaker) {
+    return layout.Find(speaker) >= 0;
+}
+
+// Add an input speaker to the output gains, folding missing positions into their neighbours
+void Route(Speaker speaker, float gain, const ChannelLayout& output, std::vector<float>& outputGains) {
+    int channel = output.Find(speaker);
+    if (channel >= 0) {
+        outputGains[channel] += gain;
+        return;
+    }
+
+    switch (speaker) {
+        case Speaker::FrontLeft:
+        case Speaker::FrontRight:
+            if (Has(output, Speaker::FrontCenter)) {
+                Route(Speaker::FrontCenter, gain * kFoldGain, output, outputGains);
+            }
+            break;
+        case Speaker::FrontCenter:
+            if (Has(output, Speaker::FrontLeft) || Has(output, Speaker::FrontRight)) {
+                Route(Speaker::FrontLeft, gain * kFoldGain, output, outputGains);
+                Route(Speaker::FrontRight, gain * kFoldGain, output, outputGains);
+            }
+            break;
+        case Speaker::LowFrequency:
+            break;  // Not folded into full-range channels
+        case Speaker::BackLeft:
+            Route(Has(output, Speaker::SideLeft) ? Speaker::SideLeft : Speaker::FrontLeft,
+                  Has(output, Speaker::SideLeft) ? gain : gain * kFoldGain, output, outputGains);
+            break;
+        case Speaker::BackRight:
+            Route(Has(output, Speaker::SideRight) ? Speaker::SideRight : Speaker::FrontRight,
+                  Has(output, Speaker::SideRight) ? gain : gain * kFoldGain, output, outputGains);
+            break;
+        case Speaker::SideLeft:
+            Route(Has(output, Speaker::BackLeft) ? Speaker::BackLeft : Speaker::FrontLeft,
+                  Has(output, Speaker::BackLeft) ? gain : gain * kFoldGain, output, outputGains);
+            break;
+        case Speaker::SideRight:
+            Route(Has(output, Speaker::BackRight) ? Speaker::BackRight : Speaker::FrontRight,
+                  Has(output, Speaker::BackRight) ? gain : gain * kFoldGain, output, outputGains);
+            break;
+        case Speaker::BackCenter:
+            Route(Speaker::BackLeft, gain * kFoldGain, output, outputGains);
+            Route(Speaker::BackRight, gain * kFoldGain, output, outputGains);
+            break;
+        case Speaker::FrontLeftOfCenter:
+            Route(Speaker::FrontLeft, gain, output, outputGains);
+            break;
+        case Speaker::FrontRightOfCenter:
+            Route(Speaker::FrontRight, gain, output, outputGains);
+            break;
+        case Speaker::TopCenter:
+            Route(Speaker::FrontLeft, gain * 0.5f, output, outputGains);
+            Route(Speaker::FrontRight, gain * 0.5f, output, outputGains);
+            break;
+        case Speaker::TopFrontLeft:
+            Route(Speaker::FrontLeft, gain * kFoldGain, output, outputGains);
+            break;
+        case Speaker::TopFrontCenter:
+            Route(Speaker::FrontCenter, gain * kFoldGain, output, outputGains);
+            break;
+        case Speaker::TopFrontRight:
+            Route(Speaker::FrontRight, gain * kFoldGain, output, outputGains);
+            break;
+        case Speaker::TopBackLeft:
+            Route(Speaker::BackLeft, gain * kFoldGain, output, outputGains);
+            break;
+        case Speaker::TopBackCenter:
+            Route(Speaker::BackCenter, gain * kFoldGain, output, outputGains);
+            break;
+        case Speaker::TopBackRight:
+            Route(Speaker::BackRight, gain * kFoldGain, output, outputGains);
+            break;
+        case Speaker::Aux:
+            break;
+    }
+}
+
+} // namespace
+
+bool ChannelMixer::Configure(const ChannelLayout& input, const ChannelLayout& output, bool preventClipping) {
+    if (input.IsEmpty() || output.IsEmpty()) {
+        return false;
+    }
+
+    inputChannels = input.GetChannelCount();
+    outputChannels = output.GetChannelCount();
+    std::vector<float> gains(static_cast<size_t>(inputChannels) * outputChannels, 0.0f);
+
+    // Auxiliary channels have no position; they pair up in order
+    std::vector<int> outputAux;
+    for (int channel = 0; channel < outputChannels; channel++) {
+        if (output.GetSpeaker(channel) == Speaker::Aux) {
+            outputAux.push_back(channel);
+        }
+    }
+
+    size_t inputAux = 0;
+    std::vector<float> outputGains(outputChannels);
+    for (int in = 0; in < inputChannels; in++) {
+        std::fill(outputGains.begin(), outputGains.end(), 0.0f);
+        if (input.GetSpeaker(in) == Speaker::Aux) {
+            if (inputAux < outputAux.size()) {
+                outputGains[outputAux[inputAux]] = 1.0f;
+            }
+            inputAux++;
+        } else {
+            Route(input.GetSpeaker(in), 1.0f, output, outputGains);
+        }
+        for (int out = 0; out < outputChannels; out++) {
+            gains[static_cast<size_t>(out) * inputChannels + in] = outputGains[out];
+        }
+    }
+
+    if (preventClipping) {
+        for (int out = 0; out < outputChannels; out++) {
+            float* row = &gains[static_cast<size_t>(out) * inputChannels];
+            float sum = 0.0f;
+            for (int in = 0; in < inputChannels; in++) {
+                sum += row[in];
+            }
+            if (sum > 1.0f) {
+                VectorOps::Scale(row, 1.0f / sum, inputChannels);
+            }
+        }
+    }
+
+    SetMatrix(inputChannels, outputChannels, gains);
+
+    if (IsIdentity()) {
+        name = "pass-through " + input.GetName();
+    } else {
+        const char* kind = outputChannels < inputChannels ? "downmix " :
+                           outputChannels > inputChannels ? "upmix " : "remap ";
+        name = kind + input.GetName() + " -> " + output.GetName();
+    }
+    return true;
+}
+
+bool ChannelMixer::SetMatrix(int inputCount, int outputCount, const std::vector<float>& gains) {
+    if (inputCount <= 0 || outputCount <= 0 ||
+        gains.size() != static_cast<size_t>(inputCount) * outputCount) {
+        return false;
+    }
+
+    inputChannels = inputCount;
+    outputChannels = outputCount;
+    terms.clear();
+    for (int out = 0; out < outputChannels; out++) {
+        for (int in = 0; in < inputChannels; in++) {
+            float gain = gains[static_cast<size_t>(out) * inputChannels + in];
+            if (gain != 0.0f) {
+                terms.push_back({in, out, gain});
+            }
+        }
+    }
+    name = "matrix " + std::to_string(inputChannels) + " -> " + std::to_string(outputChannels);
+
+    identity = inputChannels == outputChannels && terms.size() == static_cast<size_t>(inputChannels);
+    for (const Term& term : terms) {
+        identity = identity && term.input == term.output && term.gain == 1.0f;
+    }
+
+    usedInputs.clear();
+    for (const Term& term : terms) {
+        if (std::find(usedInputs.begin(), usedInputs.end(), term.input) == usedInputs.end()) {
+            usedInputs.push_back(term.input);
+        }
+    }
+    planarInput.assign(kMixBlockFrames * inputChannels, 0.0f);
+    planarOutput.assign(kMixBlockFrames * outputChannels, 0.0f);
+    return true;
+}
+
+void ChannelMixer::Process(const float* input, float* output, size_t frameCount) {
+    if (IsIdentity()) {
+        std::memcpy(output, input, frameCount * inputChannels * sizeof(float));
+        return;
+    }
+
+    for (size_t start = 0; start < frameCount; start += kMixBlockFrames) {
+        const size_t count = std::min(kMixBlockFrames, frameCount - start);
+        const float* in = input + start * inputChannels;
+        float* out = output + start * outputChannels;
+
+        for (int channel : usedInputs) {
+            VectorOps::Deinterleave(in, inputChannels, channel, &planarInput[channel * kMixBlockFrames], count);
+        }
+
+        std::fill(planarOutput.begin(), planarOutput.end(), 0.0f);
+        for (const Term& term : terms) {
+            VectorOps::MultiplyAdd(&planarOutput[term.output * kMixBlockFrames],
+                                   &planarInput[term.input * kMixBlockFrames], term.gain, count);
+        }
+
+        for (int channel = 0; channel < outputChannels; channel++) {
+            VectorOps::Interleave(&planarOutput[channel * kMixBlockFrames], outputChannels, channel, out, count);
+        }
+    }
+}
+
+float ChannelMixer::GetGain(int outputChannel, int inputChannel) const {
+    for (const Term& term : terms) {
+        if (term.output == outputChannel && term.input == inputChannel) {
+            return term.gain;
+        }
+    }
+    return 0.0f;
+}
@@ -0,0 +1,91 @@
+#ifndef CHANNEL_MIXER_H
+#define CHANNEL_MIXER_H
+
+#include "ChannelLayout.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Mixing matrix between two interleaved channel layouts (downmix, upmix, remap)
+ *
+ * Only the non-zero matrix coefficients are kept, and they are applied as
+ * vectorized multiply-adds on short deinterleaved blocks. Typical layout
+ * conversions touch each channel a small, fixed number of times, so the cost
+ * per channel stays flat as the channel count grows.
+ */
+class ChannelMixer {
+public:
+    /**
+     * @brief Build the matrix converting one layout to another
+     *
+     * Speakers present in both layouts are copied. Missing positions fold into
+     * their neighbours at -3dB: the center into front left/right (or left/right
+     * into the center for mono), surrounds into back or side channels and then
+     * into the fronts, and height channels into the ear-level layer. LFE is
+     * dropped when the output has none. Auxiliary channels map by order.
+     * @param input Layout of the input stream
+     * @param output Layout of the output stream
+     * @param preventClipping Scale down output channels whose gains add up to more than 1
+     * @return true if the matrix was built, false if a layout is empty
+     */
+    bool Configure(const ChannelLayout& input, const ChannelLayout& output, bool preventClipping = true);
+
+    /**
+     * @brief Use a caller-provided matrix
+     * @param inputChannels Number of input channels
+     * @param outputChannels Number of output channels
+     * @param gains Row-major gains, gains[output * inputChannels + input]
+     * @return true if the matrix was accepted, false on a size mismatch
+     */
+    bool SetMatrix(int inputChannels, int outputChannels, const std::vector<float>& gains);
+
+    /**
+     * @brief Mix a block of interleaved frames
+     * @param input Interleaved input samples (frameCount * input channels)
+     * @param output Interleaved output samples (frameCount * output channels), must not alias input
+     * @param frameCount Number of frames
+     */
+    void Process(const float* input, float* output, size_t frameCount);
+
+    /**
+     * @brief Get one matrix coefficient
+     * @param outputChannel Output channel index
+     * @param inputChannel Input channel index
+     * @return Gain applied from the input to the output channel
+     */
+    float GetGain(int outputChannel, int inputChannel) const;
+
+    int GetInputChannels() const { return inputChannels; }
+    int GetOutputChannels() const { return outputChannels; }
+
+    /**
+     * @brief Check whether the matrix passes every channel through unchanged
+     * @return true for an identity matrix, false otherwise
+     */
+    bool IsIdentity() const { return identity; }
+
+    /**
+     * @brief Get a short description such as "downmix 5.1 -> stereo"
+     * @return Description
+     */
+    std::string GetName() const { return name; }
+
+private:
+    struct Term {
+        int input;
+        int output;
+        float gain;
+    };
+
+    int inputChannels = 0;
+    int outputChannels = 0;
+    std::vector<Term> terms;            // Non-zero coefficients, ordered by output channel
+    std::vector<int> usedInputs;        // Input channels referenced by a term
+    std::vector<float> planarInput;     // One deinterleaved block per input channel
+    std::vector<float> planarOutput;    // One block per output channel
+    bool identity = false;
+    std::string name;
+};
+
+#endif // CHANNEL_MIXER_H
@@ -0,0 +1,102 @@
+#include "ConvolutionStage.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+// Implementation of the convolution processing stage
+
+ConvolutionStage::ConvolutionStage(const ImpulseResponse& impulseResponse, const Options& options)
+    : impulseResponse(impulseResponse), options(options) {}
+
+ConvolutionStage::~ConvolutionStage() = default;
+
+bool ConvolutionStage::Prepare(int sampleRate, int channels, size_t maxBlockFrames) {
+    convolvers.clear();
+    channelCount = 0;
+
+    if (impulseResponse.GetChannelCount() == 0 || channels <= 0 || maxBlockFrames == 0) {
+        return false;
+    }
+
+    if (impulseResponse.GetSampleRate() != sampleRate) {
+        std::cout << "Error: Impulse response is " << impulseResponse.GetSampleRate()
+                  << "Hz but the stream runs at " << sampleRate << "Hz\n";
+        return false;
+    }
+
+    // The block size must divide the host block so no call ends mid-partition
+    size_t block = options.blockSize;
+    while (block > 2 && maxBlockFrames % block != 0) {
+        block >>= 1;
+    }
+    if (block < 2 || maxBlockFrames % block != 0) {
+        std::cout << "Error: Block size " << maxBlockFrames << " is not usable for convolution\n";
+        return false;
+    }
+
+    const size_t taps = impulseResponse.GetLength();
+    auto scheme = options.uniformPartitions ?
+        PartitionedConvolver::PlanUniform(taps, block) :
+        PartitionedConvolver::PlanNonUniform(taps, block, options.maxPartitionSize);
+
+    for (int channel = 0; channel < channels; channel++) {
+        // Mono responses apply to every channel, otherwise channels map one to one (wrapping)
+        const auto& response = impulseResponse.GetChannel(channel % impulseResponse.GetChannelCount());
+
+        auto convolver = std::make_unique<PartitionedConvolver>();
+        convolver->SetAccelerator(options.accelerator, options.acceleratorMinPartition);
+        if (!convolver->Initialize(response.data(), response.size(), block, scheme)) {
+            std::cout << "Error: Could not initialize convolution for channel " << channel << "\n";
+            convolvers.clear();
+            return false;
+        }
+        convolvers.push_back(std::move(convolver));
+    }
+
+    channelCount = channels;
+    blockSize = block;
+    channelBuffer.assign(block, 0.0f);
+    return true;
+}
+
+void ConvolutionStage::Process(AudioBufferView block) {
+    if (channelCount == 0) {
+        return;
+    }
+
+    const int channels = std::min(block.Channels(), channelCount);
+    for (int channel = 0; channel < channels; channel++) {
+        float* plane = block.Channel(channel);
+        for (size_t start = 0; start < block.Frames(); start += blockSize) {
+            size_t count = std::min(blockSize, block.Frames() - start);
+            if (count == blockSize) {
+                // Whole partitions are convolved in place in the channel's plane
+                convolvers[channel]->Process(plane + start, plane + start);
+                continue;
+            }
+            // Final partial block at the end of the stream
+            std::copy(plane + start, plane + start + count, channelBuffer.begin());
+            std::fill(channelBuffer.begin() + count, channelBuffer.end(), 0.0f);
+            convolvers[channel]->Process(channelBuffer.data(), channelBuffer.data());
+            std::copy(channelBuffer.begin(), channelBuffer.begin() + count, plane + start);
+        }
+    }
+}
+
+void ConvolutionStage::Reset() {
+    for (auto& convolver : convolvers) {
+        convolver->Reset();
+    }
+}
+
+std::string ConvolutionStage::GetName() const {
+    std::ostringstream name;
+    name << "Convolution (" << impulseResponse.GetLength() << " taps, "
+         << impulseResponse.GetChannelCount() << " ch";
+    if (!convolvers.empty()) {
+        name << ", " << convolvers.front()->GetSchemeDescription();
+    }
+    name << ")";
+    return name.str();
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef CONVOLUTION_STAGE_H
+#define CONVOLUTION_STAGE_H
+
+#include "IProcessingStage.h"
+#include "ImpulseResponse.h"
+#include "PartitionedConvolver.h"
+#include <memory>
+#include <vector>
+
+class IGPUProcessor;
+
+/**
+ * @brief Processing stage applying a long FIR (e.g. room correction) per channel
+ *
+ * Each output channel is convolved with the matching impulse response channel;
+ * a mono response is applied to every channel. Blocks are processed with zero
+ * added latency as long as Process is called with multiples of the block size.
+ */
+class ConvolutionStage : public IProcessingStage {
+public:
+    /**
+     * @brief Convolution engine options
+     */
+    struct Options {
+        size_t blockSize = 256;              // First (lowest latency) partition size
+        bool uniformPartitions = false;      // Use a single partition size for the whole response
+        size_t maxPartitionSize = 16384;     // Largest partition for non-uniform schemes
+        IGPUProcessor* accelerator = nullptr; // Optional backend for the large partitions
+        size_t acceleratorMinPartition = 4096;
+    };
+
+    /**
+     * @brief Constructor
+     * @param impulseResponse Impulse response, already at the device sample rate
+     * @param options Partitioning and offload options
+     */
+    ConvolutionStage(const ImpulseResponse& impulseResponse, const Options& options);
+
+    /**
+     * @brief Destructor
+     */
+    ~ConvolutionStage() override;
+
+    bool Prepare(int sampleRate, int channels, size_t maxBlockFrames) override;
+    void Process(AudioBufferView block) override;
+    void Reset() override;
+    std::string GetName() const override;
+
+private:
+    ImpulseResponse impulseResponse;
+    Options options;
+
+    int channelCount = 0;
+    size_t blockSize = 0;
+    std::vector<std::unique_ptr<PartitionedConvolver>> convolvers;
+    std::vector<float> channelBuffer;   // Zero-padded final partial block
+};
+
+#endif // CONVOLUTION_STAGE_H
\ No newline at end of file
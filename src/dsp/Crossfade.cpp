@@ -0,0 +1,91 @@
+#include "Crossfade.h"
+#include "VectorOps.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Implementation of crossfade curves
+
+namespace Crossfade {
+
+bool ParseCurve(const std::string& text, Curve& curve, std::vector<float>& points) {
+    points.clear();
+    for (Curve candidate : {Curve::Linear, Curve::EqualPower, Curve::SCurve}) {
+        if (text == GetCurveName(candidate)) {
+            curve = candidate;
+            return true;
+        }
+    }
+
+    std::stringstream stream(text);
+    std::string item;
+    std::vector<float> parsed;
+    while (std::getline(stream, item, ',')) {
+        char* end = nullptr;
+        float value = std::strtof(item.c_str(), &end);
+        if (item.empty() || *end != '\0' || !(value >= 0.0f && value <= 1.0f)) {
+            return false;
+        }
+        parsed.push_back(value);
+    }
+    if (parsed.size() < 2) {
+        return false;
+    }
+    curve = Curve::Custom;
+    points.swap(parsed);
+    return true;
+}
+
+const char* GetCurveName(Curve curve) {
+    switch (curve) {
+        case Curve::Linear: return "linear";
+        case Curve::SCurve: return "s-curve";
+        case Curve::Custom: return "custom";
+        default: return "equal-power";
+    }
+}
+
+// Fade-in gain at t in [0, 1]
+static float Evaluate(Curve curve, const std::vector<float>& points, double t) {
+    switch (curve) {
+        case Curve::Linear:
+            return static_cast<float>(t);
+        case Curve::SCurve:
+            return static_cast<float>(0.5 - 0.5 * std::cos(M_PI * t));
+        case Curve::Custom: {
+            const double position = t * (points.size() - 1);
+            const size_t index = std::min(static_cast<size_t>(position), points.size() - 2);
+            const double fraction = position - index;
+            return static_cast<float>(points[index] + (points[index + 1] - points[index]) * fraction);
+        }
+        default:
+            return static_cast<float>(std::sin(0.5 * M_PI * t));
+    }
+}
+
+void BuildGains(Curve curve, const std::vector<float>& points, size_t frames,
+                std::vector<float>& fadeIn, std::vector<float>& fadeOut) {
+    if (curve == Curve::Custom && points.size() < 2) {
+        curve = Curve::EqualPower;
+    }
+    fadeIn.resize(frames);
+    fadeOut.resize(frames);
+    for (size_t k = 0; k < frames; k++) {
+        fadeIn[k] = Evaluate(curve, points, (k + 0.5) / frames);
+    }
+    std::reverse_copy(fadeIn.begin(), fadeIn.end(), fadeOut.begin());
+}
+
+void Mix(float* outgoing, float* incoming, const float* fadeOut, const float* fadeIn,
+         int channels, size_t frameCount) {
+    VectorOps::MultiplyFrames(outgoing, fadeOut, channels, frameCount);
+    VectorOps::MultiplyFrames(incoming, fadeIn, channels, frameCount);
+    VectorOps::Add(outgoing, incoming, frameCount * channels);
+}
+
+} // namespace Crossfade
@@ -0,0 +1,68 @@
+#ifndef CROSSFADE_H
+#define CROSSFADE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Gain curves and mixing for track-to-track crossfades
+ *
+ * The curves are computed once per crossfade into tables of per-frame gains,
+ * so the audio thread only multiplies and adds. Frame k of an n-frame fade
+ * uses the curve at t = (k + 0.5) / n; the fade-out table is the fade-in table
+ * reversed, so the two tracks meet symmetrically in the middle.
+ */
+namespace Crossfade {
+
+    /**
+     * @brief Shape of a crossfade
+     */
+    enum class Curve {
+        Linear,       // Gains sum to 1: constant level for correlated (identical) material
+        EqualPower,   // sin/cos: constant power for uncorrelated material, the usual choice between songs
+        SCurve,       // Raised cosine: short overlap in the middle, gentle at both ends
+        Custom        // Fade-in gains at evenly spaced points, interpolated linearly
+    };
+
+    /**
+     * @brief Parse a curve name or a custom curve
+     * @param text "linear", "equal-power", "s-curve", or comma-separated fade-in gains (at least two, 0 to 1)
+     * @param curve Receives the curve
+     * @param points Receives the custom fade-in gains (cleared for the named curves)
+     * @return true if the text is valid, false otherwise
+     */
+    bool ParseCurve(const std::string& text, Curve& curve, std::vector<float>& points);
+
+    /**
+     * @brief Get the name of a curve ("custom" for custom curves)
+     */
+    const char* GetCurveName(Curve curve);
+
+    /**
+     * @brief Compute the per-frame gains of a crossfade
+     * @param curve Curve shape
+     * @param points Fade-in gains of a custom curve
+     * @param frames Length of the crossfade
+     * @param fadeIn Receives frames gains for the incoming track
+     * @param fadeOut Receives frames gains for the outgoing track
+     */
+    void BuildGains(Curve curve, const std::vector<float>& points, size_t frames,
+                    std::vector<float>& fadeIn, std::vector<float>& fadeOut);
+
+    /**
+     * @brief Mix the incoming track into the outgoing one
+     *
+     * outgoing[i] = outgoing[i] * fadeOut[frame] + incoming[i] * fadeIn[frame]
+     * @param outgoing Interleaved outgoing audio; receives the mix
+     * @param incoming Interleaved incoming audio; scaled in place
+     * @param fadeOut Gains of the outgoing track, one per frame
+     * @param fadeIn Gains of the incoming track, one per frame
+     * @param channels Number of channels
+     * @param frameCount Number of frames
+     */
+    void Mix(float* outgoing, float* incoming, const float* fadeOut, const float* fadeIn,
+             int channels, size_t frameCount);
+}
+
+#endif // CROSSFADE_H
@@ -0,0 +1,326 @@
+#include "DSDConverter.h"
+#include "VectorOps.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Implementation of the DSD to PCM converter
+
+namespace {
+
+// DSD bytes per channel converted per step
+const size_t kChunkBytes = 4096;
+
+struct QualityPreset {
+    const char* name;
+    size_t lookupTaps;       // Length of the decimate-by-8 filter (multiple of 8)
+    size_t halfbandTaps;     // Non-zero side taps per half-band stage (filter length 2 * n - 1)
+    double kaiserBeta;       // Window shape: stopband attenuation of roughly 8.7 + beta / 0.1102 dB
+};
+
+const QualityPreset kPresets[] = {
+    {"fast", 64, 12, 6.5},
+    {"standard", 96, 24, 9.0},
+    {"high", 160, 48, 12.0}
+};
+
+double BesselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+// Kaiser-windowed sinc low-pass of the given length, cutoff as a fraction of the sample rate
+std::vector<double> DesignLowpass(size_t length, double cutoff, double beta) {
+    std::vector<double> taps(length);
+    const double center = (length - 1) / 2.0;
+    const double norm = BesselI0(beta);
+    double sum = 0.0;
+    for (size_t n = 0; n < length; n++) {
+        double t = n - center;
+        double sinc = t == 0.0 ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+        double r = t / (center + 0.5);
+        double window = BesselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+        taps[n] = sinc * window;
+        sum += taps[n];
+    }
+    for (double& tap : taps) {
+        tap /= sum;
+    }
+    return taps;
+}
+
+/**
+ * Decimate-by-2 half-band FIR. Every other tap of a half-band filter is zero
+ * except the center one (0.5), so each output is a dot product of the even
+ * input samples with the non-zero taps plus half of one odd sample.
+ */
+class HalfbandDecimator {
+public:
+    void Initialize(const std::vector<float>& sideTaps, size_t maxInput) {
+        taps = sideTaps;
+        history = taps.size() - 1;
+        even.assign(history + maxInput / 2 + 2, 0.0f);
+        odd.assign(history + maxInput / 2 + 2, 0.0f);
+        Reset();
+    }
+
+    void Reset() {
+        std::fill(even.begin(), even.end(), 0.0f);
+        std::fill(odd.begin(), odd.end(), 0.0f);
+        evenCount = history;
+        oddCount = history;
+        nextIsOdd = false;
+    }
+
+    // Output may alias input
+    size_t Process(const float* input, size_t count, float* output) {
+        for (size_t i = 0; i < count; i++) {
+            if (nextIsOdd) {
+                odd[oddCount++] = input[i];
+            } else {
+                even[evenCount++] = input[i];
+            }
+            nextIsOdd = !nextIsOdd;
+        }
+
+        // y[m] = sum taps[i] * even[m + i] + 0.5 * odd[m + center], center = taps / 2 - 1
+        const size_t length = taps.size();
+        const size_t center = length / 2 - 1;
+        size_t outputs = 0;
+        while (outputs + length <= evenCount && outputs + center < oddCount) {
+            output[outputs] = VectorOps::DotProduct(&even[outputs], taps.data(), length) +
+                              0.5f * odd[outputs + center];
+            outputs++;
+        }
+
+        std::memmove(even.data(), even.data() + outputs, (evenCount - outputs) * sizeof(float));
+        std::memmove(odd.data(), odd.data() + outputs, (oddCount - outputs) * sizeof(float));
+        evenCount -= outputs;
+        oddCount -= outputs;
+        return outputs;
+    }
+
+private:
+    std::vector<float> taps;
+    std::vector<float> even;
+    std::vector<float> odd;
+    size_t history = 0;
+    size_t evenCount = 0;
+    size_t oddCount = 0;
+    bool nextIsOdd = false;
+};
+
+} // namespace
+
+class DSDConverter::Impl {
+public:
+    int dsdRate = 0;
+    int outputRate = 0;
+    int channels = 0;
+    Quality quality = Quality::Standard;
+    size_t halfbandStages = 0;
+
+    // Stage 1: per filter byte, the summed response of all 256 bit patterns
+    size_t lookupBytes = 0;
+    std::vector<float> lookupTables;     // lookupBytes * 256
+
+    struct Channel {
+        std::vector<uint8_t> bytes;      // lookupBytes - 1 history bytes, then the current chunk
+        std::vector<float> samples;      // Stage outputs, converted in place
+        std::vector<HalfbandDecimator> halfbands;
+    };
+    std::vector<Channel> channelStates;
+
+    void DesignLookupStage(const QualityPreset& preset) {
+        // Cutoff at half the stage output rate (DSD rate / 16)
+        std::vector<double> taps = DesignLowpass(preset.lookupTaps, 1.0 / 16.0, preset.kaiserBeta);
+        lookupBytes = preset.lookupTaps / 8;
+        lookupTables.assign(lookupBytes * 256, 0.0f);
+
+        // Byte n - j holds taps 8j..8j+7; its least significant bit is the latest sample
+        for (size_t j = 0; j < lookupBytes; j++) {
+            for (int pattern = 0; pattern < 256; pattern++) {
+                double sum = 0.0;
+                for (int bit = 0; bit < 8; bit++) {
+                    sum += ((pattern >> bit) & 1 ? 1.0 : -1.0) * taps[8 * j + bit];
+                }
+                lookupTables[j * 256 + pattern] = static_cast<float>(sum);
+            }
+        }
+    }
+
+    std::vector<float> DesignHalfband(const QualityPreset& preset) {
+        // Length 2n - 1 around the center; the even offsets from the center are zero
+        std::vector<double> full = DesignLowpass(2 * preset.halfbandTaps - 1, 0.25, preset.kaiserBeta);
+        std::vector<float> sideTaps(preset.halfbandTaps);
+        for (size_t i = 0; i < preset.halfbandTaps; i++) {
+            sideTaps[i] = static_cast<float>(full[2 * i]);
+        }
+        // Keep unity DC gain with the center tap fixed at 0.5
+        double sum = 0.0;
+        for (float tap : sideTaps) {
+            sum += tap;
+        }
+        for (float& tap : sideTaps) {
+            tap = static_cast<float>(tap * 0.5 / sum);
+        }
+        return sideTaps;
+    }
+
+    // Run stage 1 over the chunk in channel.bytes, writing one sample per byte
+    void ProcessLookupStage(Channel& channel, size_t count) {
+        const float* tables = lookupTables.data();
+        const uint8_t* bytes = channel.bytes.data();
+        float* out = channel.samples.data();
+        const size_t last = lookupBytes - 1;
+        for (size_t n = 0; n < count; n++) {
+            const uint8_t* newest = bytes + n + last;
+            float sum = 0.0f;
+            for (size_t j = 0; j < lookupBytes; j++) {
+                sum += tables[j * 256 + newest[-static_cast<ptrdiff_t>(j)]];
+            }
+            out[n] = sum;
+        }
+        std::memmove(channel.bytes.data(), channel.bytes.data() + count, last);
+    }
+};
+
+DSDConverter::DSDConverter() : pImpl(std::make_unique<Impl>()) {}
+
+DSDConverter::~DSDConverter() = default;
+
+bool DSDConverter::Initialize(int dsdRate, int channels, const Options& options) {
+    if (dsdRate <= 0 || channels <= 0) {
+        std::cout << "Error: Invalid DSD stream (" << dsdRate << "Hz, " << channels << " channels)\n";
+        return false;
+    }
+
+    // DSD rates are 64 * 2^k times 44.1kHz or 48kHz; the default output is 4x that base rate
+    int outputRate = options.outputRate;
+    if (outputRate <= 0) {
+        const int base = dsdRate % 48000 == 0 ? 48000 : 44100;
+        outputRate = base * 4;
+    }
+
+    size_t decimation = outputRate > 0 && dsdRate % outputRate == 0 ? static_cast<size_t>(dsdRate / outputRate) : 0;
+    if (decimation < 8 || (decimation & (decimation - 1)) != 0) {
+        std::cout << "Error: Cannot convert " << GetRateName(dsdRate) << " to " << outputRate
+                  << "Hz (the DSD rate must be the PCM rate times 8, 16, 32, ...)\n";
+        return false;
+    }
+
+    const QualityPreset& preset = kPresets[static_cast<int>(options.quality)];
+    pImpl->dsdRate = dsdRate;
+    pImpl->outputRate = outputRate;
+    pImpl->channels = channels;
+    pImpl->quality = options.quality;
+    pImpl->halfbandStages = 0;
+    for (size_t d = decimation / 8; d > 1; d /= 2) {
+        pImpl->halfbandStages++;
+    }
+
+    pImpl->DesignLookupStage(preset);
+    std::vector<float> halfbandTaps = pImpl->DesignHalfband(preset);
+
+    pImpl->channelStates.assign(channels, Impl::Channel());
+    for (Impl::Channel& channel : pImpl->channelStates) {
+        channel.bytes.assign(pImpl->lookupBytes - 1 + kChunkBytes, 0x69);   // 0x69: DSD silence pattern
+        channel.samples.assign(kChunkBytes, 0.0f);
+        channel.halfbands.resize(pImpl->halfbandStages);
+        size_t stageInput = kChunkBytes;
+        for (HalfbandDecimator& halfband : channel.halfbands) {
+            halfband.Initialize(halfbandTaps, stageInput);
+            stageInput = stageInput / 2 + 1;
+        }
+    }
+    return true;
+}
+
+size_t DSDConverter::Process(const uint8_t* bytes, size_t bytesPerChannel, float* output) {
+    const int channels = pImpl->channels;
+    size_t framesWritten = 0;
+
+    for (size_t start = 0; start < bytesPerChannel; start += kChunkBytes) {
+        const size_t count = std::min(kChunkBytes, bytesPerChannel - start);
+        const uint8_t* chunk = bytes + start * channels;
+        size_t frames = 0;
+
+        for (int ch = 0; ch < channels; ch++) {
+            Impl::Channel& channel = pImpl->channelStates[ch];
+            uint8_t* destination = channel.bytes.data() + pImpl->lookupBytes - 1;
+            for (size_t i = 0; i < count; i++) {
+                destination[i] = chunk[i * channels + ch];
+            }
+
+            pImpl->ProcessLookupStage(channel, count);
+            frames = count;
+            for (HalfbandDecimator& halfband : channel.halfbands) {
+                frames = halfband.Process(channel.samples.data(), frames, channel.samples.data());
+            }
+            VectorOps::Interleave(channel.samples.data(), channels, ch, output + framesWritten * channels, frames);
+        }
+        framesWritten += frames;
+    }
+    return framesWritten;
+}
+
+size_t DSDConverter::GetMaxOutputFrames(size_t bytesPerChannel) const {
+    const size_t chunks = (bytesPerChannel + kChunkBytes - 1) / kChunkBytes;
+    return (bytesPerChannel >> pImpl->halfbandStages) + chunks * (pImpl->halfbandStages + 1);
+}
+
+void DSDConverter::Reset() {
+    for (Impl::Channel& channel : pImpl->channelStates) {
+        std::fill(channel.bytes.begin(), channel.bytes.end(), 0x69);
+        for (HalfbandDecimator& halfband : channel.halfbands) {
+            halfband.Reset();
+        }
+    }
+}
+
+int DSDConverter::GetOutputRate() const {
+    return pImpl->outputRate;
+}
+
+int DSDConverter::GetChannelCount() const {
+    return pImpl->channels;
+}
+
+std::string DSDConverter::GetName() const {
+    return GetRateName(pImpl->dsdRate) + " -> " + std::to_string(pImpl->outputRate) + "Hz PCM (" +
+           kPresets[static_cast<int>(pImpl->quality)].name + ", " + std::to_string(pImpl->halfbandStages + 1) +
+           (pImpl->halfbandStages == 0 ? " stage)" : " stages)");
+}
+
+std::string DSDConverter::GetRateName(int dsdRate) {
+    for (int multiple = 64; multiple <= 1024; multiple *= 2) {
+        if (dsdRate == 44100 * multiple || dsdRate == 48000 * multiple) {
+            return "DSD" + std::to_string(multiple);
+        }
+    }
+    return "DSD " + std::to_string(dsdRate / 1e6).substr(0, 6) + "MHz";
+}
+
+bool DSDConverter::ParseQuality(const std::string& name, Quality& quality) {
+    for (int i = 0; i < 3; i++) {
+        if (name == kPresets[i].name) {
+            quality = static_cast<Quality>(i);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,113 @@
+#ifndef DSD_CONVERTER_H
+#define DSD_CONVERTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Streaming DSD (1-bit) to PCM converter
+ *
+ * Conversion runs in stages:
+ * 1. A lookup-table FIR decimates by 8. Each filter byte position has a
+ *    256-entry table with the summed response of its 8 bits, so one output
+ *    sample costs one table lookup per 8 filter taps.
+ * 2. Polyphase half-band FIR stages decimate by 2 until the output rate is
+ *    reached. Only the non-zero half-band taps are evaluated, as vectorized
+ *    dot products.
+ *
+ * The filter lengths come from the quality preset. A DSD stream at 0dB SACD
+ * modulation (50%) converts to PCM at -6dBFS, which leaves headroom for
+ * overmodulated peaks.
+ */
+class DSDConverter {
+public:
+    /**
+     * @brief Filter quality presets
+     */
+    enum class Quality {
+        Fast,       // Short filters (about 70dB alias rejection)
+        Standard,   // About 100dB alias rejection
+        High        // Longest filters, steepest transition bands
+    };
+
+    /**
+     * @brief Conversion options
+     */
+    struct Options {
+        Quality quality = Quality::Standard;
+        int outputRate = 0;    // PCM rate in Hz; 0 selects 4x the base rate (176.4kHz or 192kHz)
+    };
+
+    /**
+     * @brief Constructor
+     */
+    DSDConverter();
+
+    /**
+     * @brief Destructor
+     */
+    ~DSDConverter();
+
+    /**
+     * @brief Configure the converter for a DSD stream
+     * @param dsdRate DSD bit rate per channel in Hz (e.g. 2822400 for DSD64)
+     * @param channels Number of channels
+     * @param options Quality and output rate
+     * @return true if successful, false if the rates cannot be converted
+     */
+    bool Initialize(int dsdRate, int channels, const Options& options);
+
+    /**
+     * @brief Convert a block of DSD data
+     * @param bytes Byte-interleaved DSD (one byte per channel in turn), most significant bit first
+     * @param bytesPerChannel Number of bytes per channel
+     * @param output Receives interleaved PCM; must hold GetMaxOutputFrames(bytesPerChannel) frames
+     * @return Number of frames written
+     */
+    size_t Process(const uint8_t* bytes, size_t bytesPerChannel, float* output);
+
+    /**
+     * @brief Get the largest number of frames Process can produce for a block
+     * @param bytesPerChannel Number of bytes per channel in the block
+     * @return Frame count
+     */
+    size_t GetMaxOutputFrames(size_t bytesPerChannel) const;
+
+    /**
+     * @brief Clear the filter state
+     */
+    void Reset();
+
+    int GetOutputRate() const;
+    int GetChannelCount() const;
+
+    /**
+     * @brief Get a description of the conversion, e.g. "DSD64 -> 176400Hz PCM (standard, 2 stages)"
+     * @return Description
+     */
+    std::string GetName() const;
+
+    /**
+     * @brief Get the name of a DSD rate
+     * @param dsdRate DSD bit rate in Hz
+     * @return Name such as "DSD128", or the rate in MHz for unusual rates
+     */
+    static std::string GetRateName(int dsdRate);
+
+    /**
+     * @brief Parse a quality preset name
+     * @param name "fast", "standard" or "high"
+     * @param quality Receives the preset
+     * @return true if the name is known, false otherwise
+     */
+    static bool ParseQuality(const std::string& name, Quality& quality);
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // DSD_CONVERTER_H
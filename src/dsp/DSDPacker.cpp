@@ -0,0 +1,105 @@
+#include "DSDPacker.h"
+#include "VectorOps.h"
+
+#ifdef GPU_PLAYER_HAVE_SSE
+#include <emmintrin.h>
+#endif
+
+// Implementation of DoP and native DSD packing
+
+namespace DSDPacker {
+
+size_t PackDoP(const uint8_t* dsd, size_t bytesPerChannel, int channels, uint8_t& marker, int32_t* output) {
+    const size_t frames = bytesPerChannel / 2;
+    size_t frame = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+    if (channels == 2) {
+        // Four frames per step. Each 32-bit lane holds one frame's input, bytes L0 R0 L1 R1
+        // from low to high; left becomes L1 << 8 | L0 << 16 and right R1 << 8 | R0 << 16.
+        // An even frame count per step keeps the marker phase the same on every step.
+        const __m128i lowByte = _mm_set1_epi32(0xFF);
+        const __m128i secondByte = _mm_set1_epi32(0xFF00);
+        const uint32_t first = static_cast<uint32_t>(marker) << 24;
+        const uint32_t second = static_cast<uint32_t>(static_cast<uint8_t>(~marker)) << 24;
+        const __m128i markers = _mm_setr_epi32(first, first, second, second);
+        for (; frame + 4 <= frames; frame += 4) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dsd + frame * 4));
+            __m128i left = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(bytes, 8), secondByte),
+                                        _mm_slli_epi32(_mm_and_si128(bytes, lowByte), 16));
+            __m128i right = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(bytes, 16), secondByte),
+                                         _mm_slli_epi32(_mm_and_si128(bytes, secondByte), 8));
+            // Frame pairs (0, 1) and (2, 3), each as L R L R
+            __m128i low = _mm_or_si128(_mm_unpacklo_epi32(left, right), markers);
+            __m128i high = _mm_or_si128(_mm_unpackhi_epi32(left, right), markers);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + frame * 2), low);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + frame * 2 + 4), high);
+        }
+    }
+#endif
+    for (; frame < frames; frame++) {
+        const uint8_t frameMarker = frame % 2 == 0 ? marker : static_cast<uint8_t>(~marker);
+        const uint8_t* earlier = dsd + frame * 2 * channels;
+        const uint8_t* later = earlier + channels;
+        for (int channel = 0; channel < channels; channel++) {
+            uint32_t sample = (static_cast<uint32_t>(frameMarker) << 24) | (earlier[channel] << 16) | (later[channel] << 8);
+            output[frame * channels + channel] = static_cast<int32_t>(sample);
+        }
+    }
+
+    if (frames % 2 == 1) {
+        marker = static_cast<uint8_t>(~marker);
+    }
+    return frames;
+}
+
+size_t PackNative(const uint8_t* dsd, size_t bytesPerChannel, int channels, uint8_t* output) {
+    const size_t frames = bytesPerChannel / 4;
+    size_t frame = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+    if (channels == 2) {
+        // Two frames per step: split L0 R0 L1 R1 ... L7 R7 into even and odd bytes,
+        // then order the 32-bit groups L0-3 R0-3 L4-7 R4-7
+        const __m128i evenBytes = _mm_set1_epi16(0xFF);
+        for (; frame + 2 <= frames; frame += 2) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dsd + frame * 8));
+            __m128i split = _mm_packus_epi16(_mm_and_si128(bytes, evenBytes), _mm_srli_epi16(bytes, 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + frame * 8),
+                             _mm_shuffle_epi32(split, _MM_SHUFFLE(3, 1, 2, 0)));
+        }
+    }
+#endif
+    for (; frame < frames; frame++) {
+        const uint8_t* source = dsd + frame * 4 * channels;
+        uint8_t* destination = output + frame * 4 * channels;
+        for (int channel = 0; channel < channels; channel++) {
+            for (int i = 0; i < 4; i++) {
+                destination[channel * 4 + i] = source[i * channels + channel];
+            }
+        }
+    }
+    return frames;
+}
+
+int GetBytesPerFrame(Mode mode) {
+    return mode == Mode::DoP ? 2 : 4;
+}
+
+bool ParseMode(const std::string& name, Mode& mode) {
+    for (Mode candidate : {Mode::PCM, Mode::DoP, Mode::Native}) {
+        if (name == GetModeName(candidate)) {
+            mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* GetModeName(Mode mode) {
+    switch (mode) {
+        case Mode::DoP: return "dop";
+        case Mode::Native: return "native";
+        default: return "pcm";
+    }
+}
+
+} // namespace DSDPacker
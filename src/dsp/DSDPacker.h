@@ -0,0 +1,83 @@
+#ifndef DSD_PACKER_H
+#define DSD_PACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Packing of DSD streams for bit-perfect output (no conversion to PCM)
+ *
+ * Input is byte-interleaved DSD (one byte per channel in turn), most
+ * significant bit first, as produced by DSDFileReader. Stereo, the common
+ * case, is packed with SSE2 byte shuffles; other channel counts use a scalar
+ * loop.
+ */
+namespace DSDPacker {
+
+    // First DoP marker of a stream; it alternates with its complement, 0xFA
+    const uint8_t kDoPMarker = 0x05;
+
+    /**
+     * @brief How DSD sources reach the output device
+     */
+    enum class Mode {
+        PCM,      // Convert to PCM with DSDConverter
+        DoP,      // DSD over PCM: 16 DSD bits plus a marker byte per 24-bit PCM sample
+        Native    // Raw DSD, 32 bits per channel per device frame
+    };
+
+    /**
+     * @brief Pack DSD as DoP (DSD over PCM, v1.1)
+     *
+     * Each output sample carries two DSD bytes per channel, the earlier one in
+     * bits 16-23 and the later one in bits 8-15, with the marker (0x05 or 0xFA,
+     * alternating every frame) in bits 24-31. Samples are 32-bit little-endian
+     * with the low byte zero, i.e. 24-bit PCM left-justified, so a DoP DAC
+     * sees the bits unchanged. The output rate is the DSD rate / 16.
+     * @param dsd Byte-interleaved DSD
+     * @param bytesPerChannel Number of bytes per channel; must be even
+     * @param channels Number of channels
+     * @param marker Marker of the first frame; receives the marker of the next frame
+     * @param output Receives bytesPerChannel / 2 frames of interleaved samples
+     * @return Number of frames written
+     */
+    size_t PackDoP(const uint8_t* dsd, size_t bytesPerChannel, int channels, uint8_t& marker, int32_t* output);
+
+    /**
+     * @brief Pack DSD into 32-bit words for native DSD output
+     *
+     * Each channel gets four consecutive DSD bytes per frame, the earliest at
+     * the lowest address (the DSD_U32_BE layout of ALSA and ASIO drivers).
+     * The output rate is the DSD rate / 32.
+     * @param dsd Byte-interleaved DSD
+     * @param bytesPerChannel Number of bytes per channel; must be a multiple of 4
+     * @param channels Number of channels
+     * @param output Receives bytesPerChannel / 4 frames of 4 * channels bytes
+     * @return Number of frames written
+     */
+    size_t PackNative(const uint8_t* dsd, size_t bytesPerChannel, int channels, uint8_t* output);
+
+    /**
+     * @brief Get the DSD bytes per channel consumed by one output frame
+     * @param mode DoP or Native
+     * @return 2 for DoP, 4 for native output
+     */
+    int GetBytesPerFrame(Mode mode);
+
+    /**
+     * @brief Parse an output mode name
+     * @param name "pcm", "dop" or "native"
+     * @param mode Receives the mode
+     * @return true if the name is known, false otherwise
+     */
+    bool ParseMode(const std::string& name, Mode& mode);
+
+    /**
+     * @brief Get the name of an output mode
+     */
+    const char* GetModeName(Mode mode);
+
+} // namespace DSDPacker
+
+#endif // DSD_PACKER_H
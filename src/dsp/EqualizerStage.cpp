@@ -0,0 +1,120 @@
+#include "EqualizerStage.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Implementation of the two-band equalizer stage
+
+namespace {
+
+// Centre frequencies are kept below this fraction of the sample rate
+const double kMaxFrequencyRatio = 0.45;
+
+// State this small is flushed to zero between blocks so silence does not decay into denormals
+const float kDenormalThreshold = 1e-15f;
+
+EqualizerStage::Coefficients Peaking(const EqualizerStage::Band& band, int sampleRate) {
+    const double frequency = std::min(band.frequency, kMaxFrequencyRatio * sampleRate);
+    const double a = std::pow(10.0, band.gainDb / 40.0);
+    const double w0 = 2.0 * M_PI * frequency / sampleRate;
+    const double alpha = std::sin(w0) / (2.0 * band.q);
+    const double cosine = std::cos(w0);
+    const double a0 = 1.0 + alpha / a;
+
+    EqualizerStage::Coefficients c;
+    c.b0 = static_cast<float>((1.0 + alpha * a) / a0);
+    c.b1 = static_cast<float>(-2.0 * cosine / a0);
+    c.b2 = static_cast<float>((1.0 - alpha * a) / a0);
+    c.a1 = static_cast<float>(-2.0 * cosine / a0);
+    c.a2 = static_cast<float>((1.0 - alpha / a) / a0);
+    return c;
+}
+
+// Run both bands over Channels planes at once; the recursions of different
+// channels and bands are independent, so they overlap in the pipeline
+template <int Channels>
+void RunBands(float* const* planes, size_t frames, const EqualizerStage::Coefficients* c,
+              EqualizerStage::State* state) {
+    const int kBands = EqualizerStage::kBandCount;
+    float z1[Channels][kBands], z2[Channels][kBands];
+    for (int ch = 0; ch < Channels; ch++) {
+        for (int band = 0; band < kBands; band++) {
+            z1[ch][band] = state[ch * kBands + band].z1;
+            z2[ch][band] = state[ch * kBands + band].z2;
+        }
+    }
+
+    for (size_t i = 0; i < frames; i++) {
+        for (int ch = 0; ch < Channels; ch++) {
+            float x = planes[ch][i];
+            for (int band = 0; band < kBands; band++) {
+                const float y = c[band].b0 * x + z1[ch][band];
+                z1[ch][band] = c[band].b1 * x - c[band].a1 * y + z2[ch][band];
+                z2[ch][band] = c[band].b2 * x - c[band].a2 * y;
+                x = y;
+            }
+            planes[ch][i] = x;
+        }
+    }
+
+    for (int ch = 0; ch < Channels; ch++) {
+        for (int band = 0; band < kBands; band++) {
+            EqualizerStage::State& s = state[ch * kBands + band];
+            s.z1 = std::fabs(z1[ch][band]) < kDenormalThreshold ? 0.0f : z1[ch][band];
+            s.z2 = std::fabs(z2[ch][band]) < kDenormalThreshold ? 0.0f : z2[ch][band];
+        }
+    }
+}
+
+} // namespace
+
+EqualizerStage::EqualizerStage(const Band& low, const Band& high) : bands{low, high} {}
+
+bool EqualizerStage::IsFlat() const {
+    return bands[0].gainDb == 0.0 && bands[1].gainDb == 0.0;
+}
+
+bool EqualizerStage::Prepare(int sampleRate, int channels, size_t maxBlockFrames) {
+    if (sampleRate <= 0 || channels <= 0 || maxBlockFrames == 0) {
+        return false;
+    }
+    for (int band = 0; band < kBandCount; band++) {
+        if (bands[band].frequency <= 0.0 || bands[band].q <= 0.0) {
+            return false;
+        }
+        coefficients[band] = Peaking(bands[band], sampleRate);
+    }
+    channelCount = channels;
+    state.assign(static_cast<size_t>(channels) * kBandCount, State());
+    return true;
+}
+
+void EqualizerStage::Process(AudioBufferView block) {
+    const int channels = std::min(block.Channels(), channelCount);
+    int channel = 0;
+    for (; channel + 2 <= channels; channel += 2) {
+        float* const planes[2] = {block.Channel(channel), block.Channel(channel + 1)};
+        RunBands<2>(planes, block.Frames(), coefficients, &state[channel * kBandCount]);
+    }
+    if (channel < channels) {
+        float* const plane[1] = {block.Channel(channel)};
+        RunBands<1>(plane, block.Frames(), coefficients, &state[channel * kBandCount]);
+    }
+}
+
+void EqualizerStage::Reset() {
+    std::fill(state.begin(), state.end(), State());
+}
+
+std::string EqualizerStage::GetName() const {
+    std::ostringstream name;
+    name << std::fixed << std::setprecision(1) << "EQ (" << bands[0].frequency << "Hz " << bands[0].gainDb
+         << "dB Q" << bands[0].q << ", " << bands[1].frequency << "Hz " << bands[1].gainDb << "dB Q"
+         << bands[1].q << ")";
+    return name.str();
+}
@@ -0,0 +1,70 @@
+#ifndef EQUALIZER_STAGE_H
+#define EQUALIZER_STAGE_H
+
+#include "IProcessingStage.h"
+#include <vector>
+
+/**
+ * @brief Processing stage applying the two-band parametric equalizer
+ *
+ * Each band is a peaking biquad (RBJ cookbook). Both bands run in one pass
+ * over each channel plane, two channels at a time, so four independent filter
+ * recursions are in flight per frame.
+ */
+class EqualizerStage : public IProcessingStage {
+public:
+    /**
+     * @brief One peaking band
+     */
+    struct Band {
+        double frequency = 1000.0;  // Centre frequency in Hz
+        double gainDb = 0.0;        // Boost or cut in dB
+        double q = 0.707;           // Quality factor
+    };
+
+    /**
+     * @brief Constructor
+     * @param low Low band
+     * @param high High band
+     */
+    EqualizerStage(const Band& low, const Band& high);
+
+    /**
+     * @brief Check whether both bands are at 0 dB, so the stage can be left out
+     */
+    bool IsFlat() const;
+
+    bool Prepare(int sampleRate, int channels, size_t maxBlockFrames) override;
+    void Process(AudioBufferView block) override;
+    void Reset() override;
+    std::string GetName() const override;
+
+    static const int kBandCount = 2;
+
+    /**
+     * @brief Biquad coefficients normalized so that a0 = 1
+     */
+    struct Coefficients {
+        float b0 = 1.0f;
+        float b1 = 0.0f;
+        float b2 = 0.0f;
+        float a1 = 0.0f;
+        float a2 = 0.0f;
+    };
+
+    /**
+     * @brief Transposed direct form II state of one band on one channel
+     */
+    struct State {
+        float z1 = 0.0f;
+        float z2 = 0.0f;
+    };
+
+private:
+    Band bands[kBandCount];
+    Coefficients coefficients[kBandCount];
+    int channelCount = 0;
+    std::vector<State> state;   // kBandCount entries per channel
+};
+
+#endif // EQUALIZER_STAGE_H
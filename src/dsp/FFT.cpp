@@ -0,0 +1,196 @@
+#include "FFT.h"
+#include "VectorOps.h"
+#include <cmath>
+#include <utility>
+
+#ifdef GPU_PLAYER_HAVE_SSE
+#include <xmmintrin.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Implementation of split-format radix-2 FFT
+
+FFT::FFT(size_t size) : size(size), half(size / 2) {
+    // Bit reversal table for the half-size complex transform
+    size_t bits = 0;
+    while ((static_cast<size_t>(1) << bits) < half) {
+        bits++;
+    }
+
+    bitReverse.resize(half);
+    for (size_t i = 0; i < half; i++) {
+        size_t reversed = 0;
+        for (size_t b = 0; b < bits; b++) {
+            if (i & (static_cast<size_t>(1) << b)) {
+                reversed |= static_cast<size_t>(1) << (bits - 1 - b);
+            }
+        }
+        bitReverse[i] = reversed;
+    }
+
+    // Twiddles for every butterfly span, laid out contiguously per stage
+    twiddleRe.resize(half > 1 ? half - 1 : 1);
+    twiddleIm.resize(half > 1 ? half - 1 : 1);
+    for (size_t h = 1; h < half; h <<= 1) {
+        for (size_t j = 0; j < h; j++) {
+            double angle = -M_PI * static_cast<double>(j) / static_cast<double>(h);
+            twiddleRe[h - 1 + j] = static_cast<float>(std::cos(angle));
+            twiddleIm[h - 1 + j] = static_cast<float>(std::sin(angle));
+        }
+    }
+
+    // Twiddles for splitting the packed real transform
+    realTwiddleRe.resize(half + 1);
+    realTwiddleIm.resize(half + 1);
+    for (size_t k = 0; k <= half; k++) {
+        double angle = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(size);
+        realTwiddleRe[k] = static_cast<float>(std::cos(angle));
+        realTwiddleIm[k] = static_cast<float>(std::sin(angle));
+    }
+
+    workRe.resize(half);
+    workIm.resize(half);
+}
+
+bool FFT::IsValidSize(size_t value) {
+    return value >= 4 && (value & (value - 1)) == 0;
+}
+
+void FFT::ComplexForward(float* re, float* im) {
+    const size_t n = half;
+
+    for (size_t i = 0; i < n; i++) {
+        size_t j = bitReverse[i];
+        if (i < j) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+
+    // Span 1: twiddle is 1
+    for (size_t s = 0; s + 1 < n; s += 2) {
+        float ar = re[s], ai = im[s];
+        float br = re[s + 1], bi = im[s + 1];
+        re[s] = ar + br;     im[s] = ai + bi;
+        re[s + 1] = ar - br; im[s + 1] = ai - bi;
+    }
+
+    // Span 2: twiddles are 1 and -i
+    for (size_t s = 0; s + 3 < n; s += 4) {
+        float ar = re[s], ai = im[s];
+        float br = re[s + 2], bi = im[s + 2];
+        re[s] = ar + br;     im[s] = ai + bi;
+        re[s + 2] = ar - br; im[s + 2] = ai - bi;
+
+        ar = re[s + 1]; ai = im[s + 1];
+        br = im[s + 3]; bi = -re[s + 3];
+        re[s + 1] = ar + br; im[s + 1] = ai + bi;
+        re[s + 3] = ar - br; im[s + 3] = ai - bi;
+    }
+
+    // Remaining spans have at least four butterflies per group
+    for (size_t h = 4; h < n; h <<= 1) {
+        const float* wr = twiddleRe.data() + h - 1;
+        const float* wi = twiddleIm.data() + h - 1;
+
+        for (size_t s = 0; s < n; s += 2 * h) {
+            float* xr = re + s;
+            float* xi = im + s;
+            float* yr = re + s + h;
+            float* yi = im + s + h;
+
+            size_t j = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+            for (; j + 4 <= h; j += 4) {
+                __m128 tr = _mm_loadu_ps(wr + j);
+                __m128 ti = _mm_loadu_ps(wi + j);
+                __m128 br = _mm_loadu_ps(yr + j);
+                __m128 bi = _mm_loadu_ps(yi + j);
+
+                __m128 pr = _mm_sub_ps(_mm_mul_ps(br, tr), _mm_mul_ps(bi, ti));
+                __m128 pi = _mm_add_ps(_mm_mul_ps(br, ti), _mm_mul_ps(bi, tr));
+
+                __m128 ar = _mm_loadu_ps(xr + j);
+                __m128 ai = _mm_loadu_ps(xi + j);
+
+                _mm_storeu_ps(xr + j, _mm_add_ps(ar, pr));
+                _mm_storeu_ps(xi + j, _mm_add_ps(ai, pi));
+                _mm_storeu_ps(yr + j, _mm_sub_ps(ar, pr));
+                _mm_storeu_ps(yi + j, _mm_sub_ps(ai, pi));
+            }
+#endif
+            for (; j < h; j++) {
+                float pr = yr[j] * wr[j] - yi[j] * wi[j];
+                float pi = yr[j] * wi[j] + yi[j] * wr[j];
+                float ar = xr[j], ai = xi[j];
+                xr[j] = ar + pr; xi[j] = ai + pi;
+                yr[j] = ar - pr; yi[j] = ai - pi;
+            }
+        }
+    }
+}
+
+void FFT::ForwardReal(const float* input, float* re, float* im) {
+    // Pack even samples as real and odd samples as imaginary parts
+    for (size_t n = 0; n < half; n++) {
+        workRe[n] = input[2 * n];
+        workIm[n] = input[2 * n + 1];
+    }
+
+    ComplexForward(workRe.data(), workIm.data());
+
+    // Split the packed spectrum into the spectrum of the real sequence
+    float z0r = workRe[0];
+    float z0i = workIm[0];
+    re[0] = z0r + z0i;
+    im[0] = 0.0f;
+    re[half] = z0r - z0i;
+    im[half] = 0.0f;
+
+    for (size_t k = 1; k < half; k++) {
+        float ar = workRe[k], ai = workIm[k];
+        float br = workRe[half - k], bi = workIm[half - k];
+
+        float evenRe = 0.5f * (ar + br);
+        float evenIm = 0.5f * (ai - bi);
+        float oddRe = 0.5f * (ai + bi);
+        float oddIm = -0.5f * (ar - br);
+
+        float wr = realTwiddleRe[k], wi = realTwiddleIm[k];
+        re[k] = evenRe + wr * oddRe - wi * oddIm;
+        im[k] = evenIm + wr * oddIm + wi * oddRe;
+    }
+}
+
+void FFT::InverseReal(const float* re, const float* im, float* output) {
+    // Rebuild the packed half-size spectrum
+    for (size_t k = 0; k < half; k++) {
+        float ar = re[k], ai = im[k];
+        float br = re[half - k], bi = -im[half - k];
+
+        float evenRe = 0.5f * (ar + br);
+        float evenIm = 0.5f * (ai + bi);
+        float diffRe = 0.5f * (ar - br);
+        float diffIm = 0.5f * (ai - bi);
+
+        // Multiply by the conjugate twiddle
+        float wr = realTwiddleRe[k], wi = -realTwiddleIm[k];
+        float oddRe = diffRe * wr - diffIm * wi;
+        float oddIm = diffRe * wi + diffIm * wr;
+
+        workRe[k] = evenRe - oddIm;
+        workIm[k] = evenIm + oddRe;
+    }
+
+    // Inverse transform via the forward kernel with swapped real/imaginary parts
+    ComplexForward(workIm.data(), workRe.data());
+
+    const float scale = 1.0f / static_cast<float>(half);
+    for (size_t n = 0; n < half; n++) {
+        output[2 * n] = workRe[n] * scale;
+        output[2 * n + 1] = workIm[n] * scale;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Power-of-two FFT working on split (separate real/imaginary) arrays
+ *
+ * The split layout keeps every butterfly stage a contiguous loop so the
+ * radix-2 passes run four butterflies per SSE instruction. Real transforms
+ * are computed with a half-size complex FFT plus a post-processing pass.
+ * An instance owns scratch memory and must not be shared between threads.
+ */
+class FFT {
+public:
+    /**
+     * @brief Constructor
+     * @param size Real transform size (power of two, at least 4)
+     */
+    explicit FFT(size_t size);
+
+    /**
+     * @brief Get the real transform size
+     * @return Number of real samples per transform
+     */
+    size_t GetSize() const { return size; }
+
+    /**
+     * @brief Get the number of complex bins produced by ForwardReal
+     * @return size / 2 + 1
+     */
+    size_t GetBinCount() const { return size / 2 + 1; }
+
+    /**
+     * @brief Forward transform of real input
+     * @param input GetSize() real samples
+     * @param re Output real parts (GetBinCount() values)
+     * @param im Output imaginary parts (GetBinCount() values)
+     */
+    void ForwardReal(const float* input, float* re, float* im);
+
+    /**
+     * @brief Inverse transform back to real samples
+     *
+     * Normalized so that InverseReal(ForwardReal(x)) reproduces x.
+     * @param re Real parts (GetBinCount() values)
+     * @param im Imaginary parts (GetBinCount() values)
+     * @param output GetSize() real samples
+     */
+    void InverseReal(const float* re, const float* im, float* output);
+
+    /**
+     * @brief Check whether a value is a supported transform size
+     * @param value Candidate size
+     * @return true for powers of two >= 4
+     */
+    static bool IsValidSize(size_t value);
+
+private:
+    // In-place unscaled complex FFT of size/2 points on the split arrays
+    void ComplexForward(float* re, float* im);
+
+    size_t size;
+    size_t half;
+
+    std::vector<size_t> bitReverse;   // Permutation table for the complex FFT
+    std::vector<float> twiddleRe;     // Per-stage twiddles, stage with span h at offset h - 1
+    std::vector<float> twiddleIm;
+    std::vector<float> realTwiddleRe; // e^{-2*pi*i*k/size} for the real post-processing pass
+    std::vector<float> realTwiddleIm;
+    std::vector<float> workRe;        // Scratch buffers of size/2 points
+    std::vector<float> workIm;
+};
+
+#endif // FFT_H
\ No newline at end of file
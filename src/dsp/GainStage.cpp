@@ -0,0 +1,49 @@
+#include "GainStage.h"
+#include "VectorOps.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+// Implementation of the automated gain stage
+
+GainStage::GainStage(float initialGain) : gain(initialGain) {}
+
+bool GainStage::Prepare(int /*sampleRate*/, int channels, size_t maxBlockFrames) {
+    if (channels <= 0 || maxBlockFrames == 0) {
+        return false;
+    }
+    channelCount = channels;
+    gainBuffer.assign(maxBlockFrames, 1.0f);
+    return true;
+}
+
+void GainStage::Process(AudioBufferView block) {
+    const size_t frameCount = std::min(block.Frames(), gainBuffer.size());
+    const int channels = std::min(block.Channels(), channelCount);
+    if (gain.Render(position, frameCount, gainBuffer.data())) {
+        for (int channel = 0; channel < channels; channel++) {
+            VectorOps::Multiply(block.Channel(channel), block.Channel(channel), gainBuffer.data(), frameCount);
+        }
+    } else {
+        const float value = gain.GetValue();
+        if (value != 1.0f) {
+            for (int channel = 0; channel < channels; channel++) {
+                VectorOps::Scale(block.Channel(channel), value, frameCount);
+            }
+        }
+    }
+    position += frameCount;
+}
+
+void GainStage::Reset() {
+    // A ramp interrupted by a seek or stop lands on its target rather than resuming elsewhere
+    gain.FinishRamp();
+}
+
+std::string GainStage::GetName() const {
+    std::ostringstream name;
+    name << std::fixed << std::setprecision(1) << "Gain (" << 20.0f * std::log10(std::max(gain.GetValue(), 1e-7f))
+         << " dB" << (gain.IsAutomating() ? ", automating" : "") << ")";
+    return name.str();
+}
@@ -0,0 +1,48 @@
+#ifndef GAIN_STAGE_H
+#define GAIN_STAGE_H
+
+#include "IProcessingStage.h"
+#include "ParameterAutomation.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Processing stage applying an automated gain to every channel
+ *
+ * The gain follows the events scheduled on GetGain(), on the timeline set with
+ * SetTimelinePosition (the stage counts processed frames between calls). While
+ * the gain is constant each block costs one vectorized scale, or nothing at
+ * unity gain.
+ */
+class GainStage : public IProcessingStage {
+public:
+    /**
+     * @brief Constructor
+     * @param initialGain Linear gain before any event
+     */
+    explicit GainStage(float initialGain = 1.0f);
+
+    /**
+     * @brief Get the gain parameter, to schedule changes from the control thread
+     */
+    AutomatedParameter& GetGain() { return gain; }
+
+    /**
+     * @brief Set the timeline frame of the next block (audio thread, before Process)
+     * @param frame Timeline frame, e.g. the playback position in frames
+     */
+    void SetTimelinePosition(uint64_t frame) { position = frame; }
+
+    bool Prepare(int sampleRate, int channels, size_t maxBlockFrames) override;
+    void Process(AudioBufferView block) override;
+    void Reset() override;
+    std::string GetName() const override;
+
+private:
+    AutomatedParameter gain;
+    int channelCount = 0;
+    uint64_t position = 0;
+    std::vector<float> gainBuffer;   // Per-frame gain of the current block
+};
+
+#endif // GAIN_STAGE_H
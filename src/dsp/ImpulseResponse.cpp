@@ -0,0 +1,171 @@
+#include "ImpulseResponse.h"
+#include "Resampler.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// Implementation of impulse response loading
+
+namespace {
+
+const uint16_t kFormatPcm = 1;
+const uint16_t kFormatFloat = 3;
+const uint16_t kFormatExtensible = 0xFFFE;
+
+uint16_t ReadLE16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t ReadLE32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Decode one little-endian sample to float
+float DecodeSample(const unsigned char* p, uint16_t format, int bitsPerSample) {
+    if (format == kFormatFloat) {
+        if (bitsPerSample == 64) {
+            double value;
+            std::memcpy(&value, p, sizeof(value));
+            return static_cast<float>(value);
+        }
+        float value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    switch (bitsPerSample) {
+        case 8:
+            return (static_cast<int>(p[0]) - 128) / 128.0f;
+        case 16:
+            return static_cast<int16_t>(ReadLE16(p)) / 32768.0f;
+        case 24: {
+            int32_t value = static_cast<int32_t>(p[0] | (p[1] << 8) | (p[2] << 16));
+            if (value & 0x800000) {
+                value |= ~0xFFFFFF;
+            }
+            return value / 8388608.0f;
+        }
+        case 32:
+            return static_cast<int32_t>(ReadLE32(p)) / 2147483648.0f;
+        default:
+            return 0.0f;
+    }
+}
+
+} // namespace
+
+bool ImpulseResponse::LoadWav(const std::string& path, int targetSampleRate) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "Error: Could not open impulse response - " << path << "\n";
+        return false;
+    }
+
+    unsigned char riffHeader[12];
+    file.read(reinterpret_cast<char*>(riffHeader), sizeof(riffHeader));
+    if (!file.good() || std::memcmp(riffHeader, "RIFF", 4) != 0 || std::memcmp(riffHeader + 8, "WAVE", 4) != 0) {
+        std::cout << "Error: Impulse response is not a WAV file - " << path << "\n";
+        return false;
+    }
+
+    uint16_t format = 0;
+    int channelCount = 0;
+    int fileSampleRate = 0;
+    int bitsPerSample = 0;
+    bool haveFormat = false;
+    std::vector<unsigned char> data;
+
+    // Walk the chunk list; fmt must precede data in valid files
+    while (file.good()) {
+        unsigned char chunkHeader[8];
+        file.read(reinterpret_cast<char*>(chunkHeader), sizeof(chunkHeader));
+        if (!file.good()) {
+            break;
+        }
+        uint32_t chunkSize = ReadLE32(chunkHeader + 4);
+
+        if (std::memcmp(chunkHeader, "fmt ", 4) == 0 && chunkSize >= 16) {
+            std::vector<unsigned char> fmt(chunkSize);
+            file.read(reinterpret_cast<char*>(fmt.data()), chunkSize);
+            format = ReadLE16(&fmt[0]);
+            channelCount = ReadLE16(&fmt[2]);
+            fileSampleRate = static_cast<int>(ReadLE32(&fmt[4]));
+            bitsPerSample = ReadLE16(&fmt[14]);
+            if (format == kFormatExtensible && chunkSize >= 26) {
+                // Sub-format GUID starts with the actual format tag
+                format = ReadLE16(&fmt[24]);
+            }
+            haveFormat = true;
+        } else if (std::memcmp(chunkHeader, "data", 4) == 0) {
+            data.resize(chunkSize);
+            file.read(reinterpret_cast<char*>(data.data()), chunkSize);
+            data.resize(static_cast<size_t>(file.gcount()));
+            break;
+        } else {
+            file.seekg(chunkSize, std::ios::cur);
+        }
+
+        if (chunkSize & 1) {
+            file.seekg(1, std::ios::cur);  // Chunks are word aligned
+        }
+    }
+
+    if (!haveFormat || data.empty()) {
+        std::cout << "Error: Impulse response has no format or data chunk - " << path << "\n";
+        return false;
+    }
+
+    bool supported = (format == kFormatPcm && (bitsPerSample == 8 || bitsPerSample == 16 ||
+                                               bitsPerSample == 24 || bitsPerSample == 32)) ||
+                     (format == kFormatFloat && (bitsPerSample == 32 || bitsPerSample == 64));
+    if (!supported || channelCount <= 0 || fileSampleRate <= 0) {
+        std::cout << "Error: Unsupported impulse response format (" << format << ", "
+                  << bitsPerSample << " bits) - " << path << "\n";
+        return false;
+    }
+
+    const size_t bytesPerSample = bitsPerSample / 8;
+    const size_t frameBytes = bytesPerSample * channelCount;
+    const size_t frameCount = data.size() / frameBytes;
+
+    std::vector<std::vector<float>> decoded(channelCount, std::vector<float>(frameCount));
+    for (size_t frame = 0; frame < frameCount; frame++) {
+        const unsigned char* p = data.data() + frame * frameBytes;
+        for (int channel = 0; channel < channelCount; channel++) {
+            decoded[channel][frame] = DecodeSample(p + channel * bytesPerSample, format, bitsPerSample);
+        }
+    }
+
+    int rate = fileSampleRate;
+    if (targetSampleRate > 0 && targetSampleRate != fileSampleRate) {
+        // Resampling spreads each tap over more (or fewer) samples; rescale so the
+        // filter keeps the same frequency response at the new rate
+        const float gain = static_cast<float>(fileSampleRate) / targetSampleRate;
+        for (auto& channel : decoded) {
+            std::vector<float> resampled;
+            if (!Resampler::ResampleOffline(channel, fileSampleRate, targetSampleRate, resampled)) {
+                std::cout << "Error: Could not resample impulse response to " << targetSampleRate << "Hz\n";
+                return false;
+            }
+            for (auto& sample : resampled) {
+                sample *= gain;
+            }
+            channel.swap(resampled);
+        }
+        rate = targetSampleRate;
+        std::cout << "Impulse response resampled: " << fileSampleRate << "Hz -> " << targetSampleRate << "Hz\n";
+    }
+
+    channels.swap(decoded);
+    sampleRate = rate;
+    filePath = path;
+    return true;
+}
+
+void ImpulseResponse::SetMono(const std::vector<float>& taps, int rate) {
+    channels.assign(1, taps);
+    sampleRate = rate;
+    filePath.clear();
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef IMPULSE_RESPONSE_H
+#define IMPULSE_RESPONSE_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Multichannel impulse response loaded from a WAV file
+ *
+ * Supports 16/24/32-bit integer and 32/64-bit float WAV files (including
+ * WAVE_FORMAT_EXTENSIBLE). The response is resampled to the requested device
+ * sample rate with its frequency response preserved.
+ */
+class ImpulseResponse {
+public:
+    /**
+     * @brief Load an impulse response from a WAV file
+     * @param filePath Path to the WAV file
+     * @param targetSampleRate Sample rate the filter will run at (0 keeps the file rate)
+     * @return true if loading was successful, false otherwise
+     */
+    bool LoadWav(const std::string& filePath, int targetSampleRate);
+
+    /**
+     * @brief Use caller-provided taps as a single-channel impulse response
+     * @param taps Impulse response samples
+     * @param sampleRate Sample rate of the taps
+     */
+    void SetMono(const std::vector<float>& taps, int sampleRate);
+
+    /**
+     * @brief Get the number of channels in the impulse response
+     * @return Channel count (0 if nothing is loaded)
+     */
+    int GetChannelCount() const { return static_cast<int>(channels.size()); }
+
+    /**
+     * @brief Get the impulse response length
+     * @return Number of taps per channel
+     */
+    size_t GetLength() const { return channels.empty() ? 0 : channels.front().size(); }
+
+    /**
+     * @brief Get the sample rate of the taps
+     * @return Sample rate in Hz
+     */
+    int GetSampleRate() const { return sampleRate; }
+
+    /**
+     * @brief Get the taps of one channel
+     * @param channel Channel index
+     * @return Impulse response samples for that channel
+     */
+    const std::vector<float>& GetChannel(int channel) const { return channels[channel]; }
+
+    /**
+     * @brief Get the path the response was loaded from
+     * @return File path (empty for caller-provided taps)
+     */
+    const std::string& GetFilePath() const { return filePath; }
+
+private:
+    std::vector<std::vector<float>> channels;
+    int sampleRate = 0;
+    std::string filePath;
+};
+
+#endif // IMPULSE_RESPONSE_H
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "ParameterAutomation.h"
+#include "VectorOps.h"
+#include "core/LockFreeRingBuffer.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+// Implementation of sample-accurate parameter automation
+
+class AutomatedParameter::Impl {
+public:
+    // Control thread -> audio thread
+    LockFreeRingBuffer<AutomationEvent> queue;
+    std::atomic<size_t> droppedEvents{0};
+
+    // Audio thread: events waiting for their start frame, sorted by start frame
+    std::vector<AutomationEvent> pending;
+    size_t pendingCount = 0;
+
+    // Audio thread: current value and the ramp in progress
+    float value = 0.0f;
+    bool ramping = false;
+    bool exponential = false;
+    uint64_t rampStart = 0;
+    uint64_t rampFrames = 0;
+    float startValue = 0.0f;
+    float targetValue = 0.0f;
+    double logRatio = 0.0;   // log(target / start) for exponential ramps
+
+    // Published for other threads at the end of each block
+    std::atomic<float> publishedValue{0.0f};
+    std::atomic<bool> publishedAutomating{false};
+
+    void Drain() {
+        AutomationEvent event;
+        while (queue.Read(&event, 1) == 1) {
+            if (pendingCount == pending.size()) {
+                droppedEvents.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            // Insert after events with the same start frame, so they apply in order
+            size_t index = pendingCount;
+            while (index > 0 && pending[index - 1].startFrame > event.startFrame) {
+                pending[index] = pending[index - 1];
+                index--;
+            }
+            pending[index] = event;
+            pendingCount++;
+        }
+    }
+
+    void Begin(const AutomationEvent& event, uint64_t frame) {
+        if (event.rampFrames == 0 || event.curve == AutomationEvent::Curve::Step) {
+            value = event.value;
+            ramping = false;
+            return;
+        }
+        startValue = value;
+        targetValue = event.value;
+        rampStart = frame;
+        rampFrames = event.rampFrames;
+        exponential = event.curve == AutomationEvent::Curve::Exponential && startValue * targetValue > 0.0f;
+        if (exponential) {
+            logRatio = std::log(static_cast<double>(targetValue) / startValue);
+        }
+        ramping = true;
+    }
+
+    void PopFront() {
+        std::copy(pending.begin() + 1, pending.begin() + pendingCount, pending.begin());
+        pendingCount--;
+    }
+
+    void Publish() {
+        publishedValue.store(value, std::memory_order_relaxed);
+        publishedAutomating.store(ramping || pendingCount > 0, std::memory_order_relaxed);
+    }
+};
+
+AutomatedParameter::AutomatedParameter(float initialValue, size_t maxPendingEvents) : pImpl(std::make_unique<Impl>()) {
+    pImpl->queue.Reset(maxPendingEvents);
+    pImpl->pending.resize(std::max<size_t>(maxPendingEvents, 1));
+    pImpl->value = initialValue;
+    pImpl->Publish();
+}
+
+AutomatedParameter::~AutomatedParameter() = default;
+
+bool AutomatedParameter::Schedule(const AutomationEvent& event) {
+    if (pImpl->queue.Write(&event, 1) != 1) {
+        return false;
+    }
+    pImpl->publishedAutomating.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+bool AutomatedParameter::Render(uint64_t blockStart, size_t frameCount, float* values) {
+    pImpl->Drain();
+    const uint64_t blockEnd = blockStart + frameCount;
+    if (frameCount == 0 || (!pImpl->ramping && (pImpl->pendingCount == 0 || pImpl->pending[0].startFrame >= blockEnd))) {
+        pImpl->Publish();
+        return false;
+    }
+
+    // Split the block at every event start and ramp end
+    size_t position = 0;
+    while (position < frameCount) {
+        const uint64_t frame = blockStart + position;
+        while (pImpl->pendingCount > 0 && pImpl->pending[0].startFrame <= frame) {
+            pImpl->Begin(pImpl->pending[0], frame);
+            pImpl->PopFront();
+        }
+
+        size_t end = frameCount;
+        if (pImpl->pendingCount > 0) {
+            end = static_cast<size_t>(std::min<uint64_t>(end, pImpl->pending[0].startFrame - blockStart));
+        }
+        if (!pImpl->ramping) {
+            std::fill(values + position, values + end, pImpl->value);
+            position = end;
+            continue;
+        }
+
+        const uint64_t rampEnd = pImpl->rampStart + pImpl->rampFrames;
+        end = static_cast<size_t>(std::min<uint64_t>(end, rampEnd - blockStart));
+        const size_t count = end - position;
+        // Frame k of the ramp (from 0) holds the value after k + 1 of rampFrames steps
+        const double done = static_cast<double>(frame - pImpl->rampStart + 1);
+        if (pImpl->exponential) {
+            const double stepLog = pImpl->logRatio / pImpl->rampFrames;
+            VectorOps::FillGeometric(values + position, static_cast<float>(pImpl->startValue * std::exp(stepLog * done)),
+                                     static_cast<float>(std::exp(stepLog)), count);
+        } else {
+            const double step = (static_cast<double>(pImpl->targetValue) - pImpl->startValue) / pImpl->rampFrames;
+            VectorOps::FillRamp(values + position, static_cast<float>(pImpl->startValue + step * done),
+                                static_cast<float>(step), count);
+        }
+        pImpl->value = values[end - 1];
+        if (blockStart + end >= rampEnd) {
+            pImpl->ramping = false;
+            pImpl->value = pImpl->targetValue;
+            values[end - 1] = pImpl->targetValue;
+        }
+        position = end;
+    }
+
+    pImpl->Publish();
+    return true;
+}
+
+void AutomatedParameter::FinishRamp() {
+    if (pImpl->ramping) {
+        pImpl->value = pImpl->targetValue;
+        pImpl->ramping = false;
+    }
+    pImpl->Publish();
+}
+
+float AutomatedParameter::GetValue() const {
+    return pImpl->publishedValue.load(std::memory_order_relaxed);
+}
+
+bool AutomatedParameter::IsAutomating() const {
+    return pImpl->publishedAutomating.load(std::memory_order_relaxed);
+}
+
+size_t AutomatedParameter::GetDroppedEventCount() const {
+    return pImpl->droppedEvents.load(std::memory_order_relaxed);
+}
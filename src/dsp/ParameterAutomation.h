@@ -0,0 +1,90 @@
+#ifndef PARAMETER_AUTOMATION_H
+#define PARAMETER_AUTOMATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief A scheduled change of an automated parameter
+ */
+struct AutomationEvent {
+    enum class Curve {
+        Step,          // Jump to the value at startFrame
+        Linear,        // Straight line from the current value
+        Exponential    // Constant ratio per frame (equal dB steps for a gain); linear if either end is 0
+    };
+
+    uint64_t startFrame = 0;   // Timeline frame where the change begins; a past frame starts it with the next block
+    uint64_t rampFrames = 0;   // Frames until the value is reached; 0 jumps to it
+    float value = 0.0f;        // Value at the end of the ramp
+    Curve curve = Curve::Linear;
+};
+
+/**
+ * @brief A parameter changed by timestamped ramps, rendered sample by sample
+ *
+ * The control thread schedules events through a lock-free queue; the audio
+ * thread renders the parameter's value for every frame of a block, so a change
+ * lands on the exact frame it was scheduled for and ramps never step at block
+ * boundaries. A new event cuts off a ramp still in progress and continues from
+ * the value reached. While nothing is scheduled, Render reports a constant
+ * value and the caller can use a static (scalar) path.
+ */
+class AutomatedParameter {
+public:
+    /**
+     * @brief Constructor
+     * @param initialValue Value before any event
+     * @param maxPendingEvents Events that can wait for their start frame at once
+     */
+    explicit AutomatedParameter(float initialValue, size_t maxPendingEvents = 64);
+
+    /**
+     * @brief Destructor
+     */
+    ~AutomatedParameter();
+
+    /**
+     * @brief Schedule a change (control thread)
+     * @param event Change to apply
+     * @return true if queued, false if too many events are pending
+     */
+    bool Schedule(const AutomationEvent& event);
+
+    /**
+     * @brief Render the value of every frame of a block (audio thread)
+     * @param blockStart Timeline frame of the first frame
+     * @param frameCount Number of frames
+     * @param values Receives frameCount values, only when the function returns true
+     * @return true if the value changes within the block, false if it is GetValue() throughout
+     */
+    bool Render(uint64_t blockStart, size_t frameCount, float* values);
+
+    /**
+     * @brief Complete the ramp in progress immediately (audio thread, e.g. after a seek)
+     */
+    void FinishRamp();
+
+    /**
+     * @brief Get the value at the end of the last rendered block (any thread)
+     */
+    float GetValue() const;
+
+    /**
+     * @brief Check whether a ramp is in progress or events are pending (any thread)
+     */
+    bool IsAutomating() const;
+
+    /**
+     * @brief Get the number of events dropped because too many were pending
+     */
+    size_t GetDroppedEventCount() const;
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // PARAMETER_AUTOMATION_H
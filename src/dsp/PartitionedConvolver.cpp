@@ -0,0 +1,359 @@
+#include "PartitionedConvolver.h"
+#include "FFT.h"
+#include "VectorOps.h"
+#include "IGPUProcessor.h"
+#include "core/Trace.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+// Implementation of partitioned overlap-save convolution
+
+namespace {
+
+// Growth factor between consecutive segment partition sizes
+const size_t kPartitionGrowth = 4;
+
+size_t NextPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// One uniformly partitioned overlap-save convolution over a slice of the impulse response
+struct ConvolutionSegment {
+    size_t partitionSize = 0;
+    size_t partitionCount = 0;
+    size_t offset = 0;             // Position of the first tap of this segment in the impulse response
+
+    std::unique_ptr<FFT> fft;
+    size_t binCount = 0;
+
+    std::vector<float> kernelRe;   // partitionCount spectra of binCount values
+    std::vector<float> kernelIm;
+    std::vector<float> delayRe;    // Frequency-domain delay line of input spectra
+    std::vector<float> delayIm;
+    size_t delayHead = 0;
+
+    std::vector<float> inputWindow;  // Previous partition followed by the partition being filled
+    size_t inputFill = 0;
+
+    std::vector<float> accRe;
+    std::vector<float> accIm;
+    std::vector<float> timeOutput;   // 2 * partitionSize samples, the last half is valid
+
+    IGPUProcessor* accelerator = nullptr;
+    int acceleratorKernelId = -1;
+
+    void Reset() {
+        std::fill(delayRe.begin(), delayRe.end(), 0.0f);
+        std::fill(delayIm.begin(), delayIm.end(), 0.0f);
+        std::fill(inputWindow.begin(), inputWindow.end(), 0.0f);
+        delayHead = 0;
+        inputFill = 0;
+    }
+
+    // Compute the segment output for the partition that was just completed.
+    // Result is written to timeOutput[partitionSize, 2 * partitionSize).
+    void ProcessPartition() {
+        const size_t P = partitionSize;
+        float* result = timeOutput.data() + P;
+
+        if (accelerator && acceleratorKernelId >= 0) {
+            GPU_PLAYER_TRACE_SCOPE("backend", "accelerator convolution");
+            if (accelerator->ProcessConvolution(acceleratorKernelId, inputWindow.data() + P, result, P)) {
+                return;
+            }
+        }
+
+        // Transform the current window into the head of the delay line
+        float* headRe = delayRe.data() + delayHead * binCount;
+        float* headIm = delayIm.data() + delayHead * binCount;
+        fft->ForwardReal(inputWindow.data(), headRe, headIm);
+
+        // Sum of input spectra against partition spectra, newest input with first partition
+        std::fill(accRe.begin(), accRe.end(), 0.0f);
+        std::fill(accIm.begin(), accIm.end(), 0.0f);
+        size_t slot = delayHead;
+        for (size_t k = 0; k < partitionCount; k++) {
+            VectorOps::ComplexMultiplyAccumulate(delayRe.data() + slot * binCount,
+                                                 delayIm.data() + slot * binCount,
+                                                 kernelRe.data() + k * binCount,
+                                                 kernelIm.data() + k * binCount,
+                                                 accRe.data(), accIm.data(), binCount);
+            slot = (slot == 0) ? partitionCount - 1 : slot - 1;
+        }
+
+        fft->InverseReal(accRe.data(), accIm.data(), timeOutput.data());
+        delayHead = (delayHead + 1) % partitionCount;
+    }
+};
+
+} // namespace
+
+class PartitionedConvolver::Impl {
+public:
+    Impl() = default;
+
+    size_t blockSize = 0;
+    std::vector<ConvolutionSegment> segments;
+
+    // Output accumulator indexed by absolute stream position modulo its size
+    std::vector<float> outputRing;
+    size_t ringMask = 0;
+    size_t streamPosition = 0;
+
+    IGPUProcessor* accelerator = nullptr;
+    size_t acceleratorMinPartition = 0;
+
+    void ReleaseAcceleratorKernels() {
+        for (auto& segment : segments) {
+            if (segment.accelerator && segment.acceleratorKernelId >= 0) {
+                segment.accelerator->ReleaseConvolutionKernel(segment.acceleratorKernelId);
+            }
+            segment.acceleratorKernelId = -1;
+            segment.accelerator = nullptr;
+        }
+    }
+};
+
+PartitionedConvolver::PartitionedConvolver() : pImpl(std::make_unique<Impl>()) {}
+
+PartitionedConvolver::~PartitionedConvolver() {
+    pImpl->ReleaseAcceleratorKernels();
+}
+
+std::vector<PartitionedConvolver::Segment> PartitionedConvolver::PlanUniform(size_t tapCount, size_t blockSize) {
+    std::vector<Segment> scheme;
+    if (tapCount == 0 || blockSize == 0) {
+        return scheme;
+    }
+    scheme.push_back({blockSize, (tapCount + blockSize - 1) / blockSize});
+    return scheme;
+}
+
+std::vector<PartitionedConvolver::Segment> PartitionedConvolver::PlanNonUniform(size_t tapCount, size_t blockSize,
+                                                                                size_t maxPartitionSize) {
+    std::vector<Segment> scheme;
+    if (tapCount == 0 || blockSize == 0) {
+        return scheme;
+    }
+
+    size_t offset = 0;
+    size_t partition = blockSize;
+    maxPartitionSize = std::max(maxPartitionSize, blockSize);
+
+    while (offset < tapCount) {
+        size_t remaining = tapCount - offset;
+        size_t remainingPartitions = (remaining + partition - 1) / partition;
+        size_t nextPartition = partition * kPartitionGrowth;
+
+        if (nextPartition > maxPartitionSize) {
+            scheme.push_back({partition, remainingPartitions});
+            break;
+        }
+
+        // A segment with partition P produces its output P samples late, so it may only
+        // start once the earlier segments cover at least P - blockSize taps
+        size_t requiredOffset = nextPartition - blockSize;
+        size_t count = (requiredOffset > offset) ? (requiredOffset - offset + partition - 1) / partition : 1;
+        count = std::max<size_t>(count, 1);
+
+        if (count >= remainingPartitions) {
+            scheme.push_back({partition, remainingPartitions});
+            break;
+        }
+
+        scheme.push_back({partition, count});
+        offset += count * partition;
+        partition = nextPartition;
+    }
+
+    return scheme;
+}
+
+void PartitionedConvolver::SetAccelerator(IGPUProcessor* processor, size_t minPartitionSize) {
+    pImpl->accelerator = processor;
+    pImpl->acceleratorMinPartition = minPartitionSize;
+}
+
+bool PartitionedConvolver::Initialize(const float* impulseResponse, size_t tapCount, size_t blockSize,
+                                      const std::vector<Segment>& scheme) {
+    pImpl->ReleaseAcceleratorKernels();
+    pImpl->segments.clear();
+    pImpl->blockSize = 0;
+
+    if (!impulseResponse || tapCount == 0 || !FFT::IsValidSize(blockSize * 2) || scheme.empty()) {
+        return false;
+    }
+
+    if (scheme.front().partitionSize != blockSize) {
+        return false;
+    }
+
+    // Validate the scheme before allocating anything
+    size_t offset = 0;
+    for (const auto& entry : scheme) {
+        const size_t P = entry.partitionSize;
+        if (!FFT::IsValidSize(P * 2) || P % blockSize != 0 || entry.partitionCount == 0) {
+            return false;
+        }
+        if (offset + blockSize < P) {
+            // Segment would have to produce output before its input is complete
+            return false;
+        }
+        offset += entry.partitionCount * P;
+    }
+    if (offset < tapCount) {
+        // Scheme does not cover the whole impulse response
+        return false;
+    }
+
+    offset = 0;
+    size_t ringSpan = 0;
+    for (const auto& entry : scheme) {
+        const size_t P = entry.partitionSize;
+
+        pImpl->segments.emplace_back();
+        ConvolutionSegment& segment = pImpl->segments.back();
+        segment.partitionSize = P;
+        segment.partitionCount = entry.partitionCount;
+        segment.offset = offset;
+        segment.fft = std::make_unique<FFT>(P * 2);
+        segment.binCount = segment.fft->GetBinCount();
+
+        const size_t bins = segment.binCount;
+        segment.kernelRe.assign(entry.partitionCount * bins, 0.0f);
+        segment.kernelIm.assign(entry.partitionCount * bins, 0.0f);
+        segment.delayRe.assign(entry.partitionCount * bins, 0.0f);
+        segment.delayIm.assign(entry.partitionCount * bins, 0.0f);
+        segment.inputWindow.assign(P * 2, 0.0f);
+        segment.accRe.assign(bins, 0.0f);
+        segment.accIm.assign(bins, 0.0f);
+        segment.timeOutput.assign(P * 2, 0.0f);
+
+        size_t segmentTaps = 0;
+        if (offset < tapCount) {
+            segmentTaps = std::min(tapCount - offset, entry.partitionCount * P);
+        }
+
+        // Pre-transform every partition of the kernel (zero-padded to 2P)
+        std::vector<float> padded(P * 2, 0.0f);
+        for (size_t k = 0; k < entry.partitionCount; k++) {
+            std::fill(padded.begin(), padded.end(), 0.0f);
+            size_t start = k * P;
+            if (start < segmentTaps) {
+                size_t count = std::min(P, segmentTaps - start);
+                std::memcpy(padded.data(), impulseResponse + offset + start, count * sizeof(float));
+            }
+            segment.fft->ForwardReal(padded.data(),
+                                     segment.kernelRe.data() + k * bins,
+                                     segment.kernelIm.data() + k * bins);
+        }
+
+        // Offer large partitions to the GPU backend
+        if (pImpl->accelerator && P >= pImpl->acceleratorMinPartition && P > blockSize && segmentTaps > 0) {
+            int kernelId = -1;
+            if (pImpl->accelerator->CreateConvolutionKernel(impulseResponse + offset, segmentTaps, P, kernelId)) {
+                segment.accelerator = pImpl->accelerator;
+                segment.acceleratorKernelId = kernelId;
+            }
+        }
+
+        ringSpan = std::max(ringSpan, offset + P);
+        offset += entry.partitionCount * P;
+    }
+
+    size_t ringSize = NextPowerOfTwo(ringSpan + blockSize);
+    pImpl->outputRing.assign(ringSize, 0.0f);
+    pImpl->ringMask = ringSize - 1;
+    pImpl->streamPosition = 0;
+    pImpl->blockSize = blockSize;
+    return true;
+}
+
+void PartitionedConvolver::Process(const float* input, float* output) {
+    const size_t B = pImpl->blockSize;
+    if (B == 0) {
+        return;
+    }
+
+    const size_t position = pImpl->streamPosition;
+    const size_t mask = pImpl->ringMask;
+    float* ring = pImpl->outputRing.data();
+
+    for (auto& segment : pImpl->segments) {
+        const size_t P = segment.partitionSize;
+        std::memcpy(segment.inputWindow.data() + P + segment.inputFill, input, B * sizeof(float));
+        segment.inputFill += B;
+
+        if (segment.inputFill < P) {
+            continue;
+        }
+
+        segment.ProcessPartition();
+
+        // The partition ending at position + B covers [position + B - P, position + B);
+        // this segment's contribution lands 'offset' samples later
+        size_t writePosition = position + B - P + segment.offset;
+        const float* result = segment.timeOutput.data() + P;
+        size_t start = writePosition & mask;
+        size_t first = std::min(P, mask + 1 - start);
+        VectorOps::Add(ring + start, result, first);
+        if (first < P) {
+            VectorOps::Add(ring, result + first, P - first);
+        }
+
+        // Slide the overlap-save window
+        std::memcpy(segment.inputWindow.data(), segment.inputWindow.data() + P, P * sizeof(float));
+        segment.inputFill = 0;
+    }
+
+    size_t readStart = position & mask;
+    std::memcpy(output, ring + readStart, B * sizeof(float));
+    std::memset(ring + readStart, 0, B * sizeof(float));
+
+    pImpl->streamPosition = position + B;
+}
+
+void PartitionedConvolver::Reset() {
+    for (auto& segment : pImpl->segments) {
+        segment.Reset();
+        if (segment.accelerator && segment.acceleratorKernelId >= 0) {
+            segment.accelerator->ResetConvolutionKernel(segment.acceleratorKernelId);
+        }
+    }
+    std::fill(pImpl->outputRing.begin(), pImpl->outputRing.end(), 0.0f);
+    pImpl->streamPosition = 0;
+}
+
+size_t PartitionedConvolver::GetBlockSize() const {
+    return pImpl->blockSize;
+}
+
+size_t PartitionedConvolver::GetAcceleratedSegmentCount() const {
+    size_t count = 0;
+    for (const auto& segment : pImpl->segments) {
+        if (segment.acceleratorKernelId >= 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+std::string PartitionedConvolver::GetSchemeDescription() const {
+    std::ostringstream description;
+    for (size_t i = 0; i < pImpl->segments.size(); i++) {
+        const auto& segment = pImpl->segments[i];
+        if (i > 0) {
+            description << " + ";
+        }
+        description << segment.partitionSize << "x" << segment.partitionCount;
+        if (segment.acceleratorKernelId >= 0) {
+            description << " (GPU)";
+        }
+    }
+    return description.str();
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#ifndef PARTITIONED_CONVOLVER_H
+#define PARTITIONED_CONVOLVER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class IGPUProcessor;
+
+/**
+ * @brief Single-channel partitioned overlap-save FFT convolver for long impulse responses
+ *
+ * The impulse response is split into segments. Every segment is convolved with
+ * uniformly partitioned overlap-save (a frequency-domain delay line of partition
+ * spectra), and later segments may use larger partitions. The first segment always
+ * uses the processing block size, so output is produced in the same call as its
+ * input with no added latency. Larger partitions only run every few blocks, which
+ * keeps the cost of 64k-256k tap room-correction filters low.
+ */
+class PartitionedConvolver {
+public:
+    /**
+     * @brief Describes one run of equally sized partitions
+     */
+    struct Segment {
+        size_t partitionSize;   // Partition length in samples (power of two)
+        size_t partitionCount;  // Number of partitions in this segment
+    };
+
+    /**
+     * @brief Constructor
+     */
+    PartitionedConvolver();
+
+    /**
+     * @brief Destructor
+     */
+    ~PartitionedConvolver();
+
+    /**
+     * @brief Build a uniform partitioning (every partition has the block size)
+     * @param tapCount Impulse response length
+     * @param blockSize Processing block size in samples
+     * @return Partition scheme with a single segment
+     */
+    static std::vector<Segment> PlanUniform(size_t tapCount, size_t blockSize);
+
+    /**
+     * @brief Build a non-uniform partitioning that grows partitions 4x per segment
+     * @param tapCount Impulse response length
+     * @param blockSize Processing block size (first partition size)
+     * @param maxPartitionSize Largest partition to use
+     * @return Partition scheme satisfying the latency constraint of every segment
+     */
+    static std::vector<Segment> PlanNonUniform(size_t tapCount, size_t blockSize,
+                                               size_t maxPartitionSize = 16384);
+
+    /**
+     * @brief Offer large partitions to a GPU processor
+     *
+     * Must be called before Initialize. Segments whose partition size is at least
+     * minPartitionSize are handed to IGPUProcessor::CreateConvolutionKernel; if the
+     * backend declines, they stay on the CPU.
+     * @param processor GPU processor (not owned, may be nullptr)
+     * @param minPartitionSize Smallest partition size to offload
+     */
+    void SetAccelerator(IGPUProcessor* processor, size_t minPartitionSize);
+
+    /**
+     * @brief Prepare the convolver for an impulse response
+     * @param impulseResponse Impulse response taps
+     * @param tapCount Number of taps
+     * @param blockSize Number of frames per Process call (power of two)
+     * @param scheme Partition scheme from PlanUniform/PlanNonUniform
+     * @return true if initialization was successful, false otherwise
+     */
+    bool Initialize(const float* impulseResponse, size_t tapCount, size_t blockSize,
+                    const std::vector<Segment>& scheme);
+
+    /**
+     * @brief Convolve one block of samples
+     * @param input Input samples (blockSize values)
+     * @param output Output samples (blockSize values, may alias input)
+     */
+    void Process(const float* input, float* output);
+
+    /**
+     * @brief Clear all filter state without releasing the impulse response
+     */
+    void Reset();
+
+    /**
+     * @brief Get the block size passed to Initialize
+     * @return Block size in samples
+     */
+    size_t GetBlockSize() const;
+
+    /**
+     * @brief Get the number of segments that were offloaded to the GPU processor
+     * @return Offloaded segment count
+     */
+    size_t GetAcceleratedSegmentCount() const;
+
+    /**
+     * @brief Get a description of the partition scheme
+     * @return String such as "256x3 + 1024x3 + 4096x12"
+     */
+    std::string GetSchemeDescription() const;
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // PARTITIONED_CONVOLVER_H
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "ProcessingChain.h"
+#include "VectorOps.h"
+#include <algorithm>
+
+// Implementation of the processing chain
+
+std::unique_ptr<IProcessingStage> ProcessingChain::SetStage(const std::string& slot,
+                                                            std::unique_ptr<IProcessingStage> stage) {
+    auto it = std::find_if(stages.begin(), stages.end(),
+                           [&slot](const Entry& entry) { return entry.slot == slot; });
+
+    std::unique_ptr<IProcessingStage> previous;
+    if (it != stages.end()) {
+        previous = std::move(it->stage);
+        if (stage) {
+            it->stage = std::move(stage);
+        } else {
+            stages.erase(it);
+        }
+    } else if (stage) {
+        stages.push_back({slot, std::move(stage)});
+    }
+
+    return previous;
+}
+
+IProcessingStage* ProcessingChain::GetStage(const std::string& slot) const {
+    for (const auto& entry : stages) {
+        if (entry.slot == slot) {
+            return entry.stage.get();
+        }
+    }
+    return nullptr;
+}
+
+void ProcessingChain::Prepare(int channels, size_t maxBlockFrames) {
+    channelCount = std::max(channels, 1);
+    planeFrames = maxBlockFrames;
+    planes.assign(planeFrames * channelCount, 0.0f);
+}
+
+void ProcessingChain::Process(AudioBufferView block) {
+    if (stages.empty() || block.IsEmpty()) {
+        return;
+    }
+    if (!block.IsInterleaved()) {
+        for (auto& entry : stages) {
+            entry.stage->Process(block);
+        }
+        return;
+    }
+    if (block.Channels() != channelCount || planeFrames == 0) {
+        return;
+    }
+
+    for (size_t start = 0; start < block.Frames(); start += planeFrames) {
+        const AudioBufferView part = block.Subview(start, planeFrames);
+        const size_t frames = part.Frames();
+        AudioBufferView planar(planes.data(), frames, channelCount, SampleLayout::Planar);
+        for (int channel = 0; channel < channelCount; channel++) {
+            VectorOps::Deinterleave(part.Data(), channelCount, channel, planar.Channel(channel), frames);
+        }
+
+        for (auto& entry : stages) {
+            entry.stage->Process(planar);
+        }
+
+        if (channelCount == 2) {
+            VectorOps::InterleaveStereo(planar.Channel(0), planar.Channel(1), part.Data(), frames);
+        } else {
+            for (int channel = 0; channel < channelCount; channel++) {
+                VectorOps::Interleave(planar.Channel(channel), channelCount, channel, part.Data(), frames);
+            }
+        }
+    }
+}
+
+void ProcessingChain::Reset() {
+    for (auto& entry : stages) {
+        entry.stage->Reset();
+    }
+}
+
+std::string ProcessingChain::Describe() const {
+    if (stages.empty()) {
+        return "- DSP chain: bypassed (bit-perfect)\n";
+    }
+
+    std::string description;
+    for (const auto& entry : stages) {
+        description += "- DSP " + entry.slot + ": " + entry.stage->GetName() + "\n";
+    }
+    return description;
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef PROCESSING_CHAIN_H
+#define PROCESSING_CHAIN_H
+
+#include "IProcessingStage.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Ordered list of processing stages run on each playback block
+ *
+ * Stages are identified by a slot name so they can be replaced independently
+ * (e.g. "convolution"). Interleaved blocks are split into channel planes once
+ * on entry and interleaved again on exit, so every stage runs on planar
+ * samples. The chain itself does no locking; the owner serializes changes
+ * against Process.
+ */
+class ProcessingChain {
+public:
+    // Slots reserved up front, so inserting a stage on the audio thread does not allocate
+    static const size_t kReservedSlots = 8;
+
+    ProcessingChain() { stages.reserve(kReservedSlots); }
+
+    /**
+     * @brief Insert, replace or remove the stage in a slot
+     * @param slot Slot name
+     * @param stage Prepared stage, or nullptr to remove the slot
+     * @return Previous stage in the slot (to be destroyed outside the audio thread)
+     */
+    std::unique_ptr<IProcessingStage> SetStage(const std::string& slot,
+                                               std::unique_ptr<IProcessingStage> stage);
+
+    /**
+     * @brief Get the stage in a slot
+     * @param slot Slot name
+     * @return Stage pointer or nullptr
+     */
+    IProcessingStage* GetStage(const std::string& slot) const;
+
+    /**
+     * @brief Allocate the planar buffer for a stream format (off the audio thread)
+     * @param channels Number of channels
+     * @param maxBlockFrames Largest block passed to Process
+     */
+    void Prepare(int channels, size_t maxBlockFrames);
+
+    /**
+     * @brief Run all stages over a block in place
+     *
+     * Planar blocks are handed to the stages as they are; interleaved blocks
+     * go through the prepared planar buffer, at most maxBlockFrames at a time.
+     * @param block Samples of the prepared channel count
+     */
+    void Process(AudioBufferView block);
+
+    /**
+     * @brief Reset the state of all stages
+     */
+    void Reset();
+
+    /**
+     * @brief Check whether the chain has no stages (bit-perfect path)
+     * @return true if empty, false otherwise
+     */
+    bool IsEmpty() const { return stages.empty(); }
+
+    /**
+     * @brief Get a description of the active stages
+     * @return One line per stage
+     */
+    std::string Describe() const;
+
+private:
+    struct Entry {
+        std::string slot;
+        std::unique_ptr<IProcessingStage> stage;
+    };
+
+    std::vector<Entry> stages;
+    int channelCount = 0;
+    size_t planeFrames = 0;
+    std::vector<float> planes;  // channelCount planes of planeFrames samples
+};
+
+#endif // PROCESSING_CHAIN_H
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "Resampler.h"
+#include "VectorOps.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Implementation of sample rate conversion helpers
+
+namespace {
+
+// Kaiser window shape parameter (~80dB stopband)
+const double kKaiserBeta = 8.0;
+
+// Zeroth-order modified Bessel function of the first kind
+double BesselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x * 0.5;
+    for (int k = 1; k < 32; k++) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+} // namespace
+
+namespace Resampler {
+
+bool ResampleOffline(const std::vector<float>& input,
+                     int inputRate,
+                     int outputRate,
+                     std::vector<float>& output,
+                     int halfTaps) {
+    if (inputRate <= 0 || outputRate <= 0 || halfTaps <= 0) {
+        return false;
+    }
+
+    if (inputRate == outputRate || input.empty()) {
+        output = input;
+        return true;
+    }
+
+    const double step = static_cast<double>(inputRate) / outputRate;   // Input samples per output sample
+    const double cutoff = std::min(1.0, 1.0 / step);                    // Relative to input Nyquist
+    const double halfWidth = halfTaps / cutoff;                         // Kernel half-width in input samples
+    const double windowNorm = 1.0 / BesselI0(kKaiserBeta);
+
+    size_t outputCount = static_cast<size_t>(std::ceil(input.size() / step));
+    output.assign(outputCount, 0.0f);
+
+    const long long lastIndex = static_cast<long long>(input.size()) - 1;
+    for (size_t n = 0; n < outputCount; n++) {
+        double position = n * step;
+        long long first = static_cast<long long>(std::ceil(position - halfWidth));
+        long long last = static_cast<long long>(std::floor(position + halfWidth));
+        first = std::max<long long>(first, 0);
+        last = std::min(last, lastIndex);
+
+        double sum = 0.0;
+        for (long long k = first; k <= last; k++) {
+            double distance = position - static_cast<double>(k);
+            double x = distance * cutoff;
+            double sinc = (std::fabs(x) < 1e-9) ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+            double ratio = distance / halfWidth;
+            double window = BesselI0(kKaiserBeta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) * windowNorm;
+            sum += input[static_cast<size_t>(k)] * sinc * window;
+        }
+        output[n] = static_cast<float>(sum * cutoff);
+    }
+
+    return true;
+}
+
+} // namespace Resampler
+// Largest reduced output rate accepted for the phase table
+static const size_t kMaxPhases = 4096;
+
+static size_t GreatestCommonDivisor(size_t a, size_t b) {
+    while (b != 0) {
+        size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+bool PolyphaseResampler::Initialize(int inputRate, int outputRate, int channelCount, int halfTaps) {
+    if (inputRate <= 0 || outputRate <= 0 || channelCount <= 0 || halfTaps <= 0) {
+        return false;
+    }
+
+    size_t divisor = GreatestCommonDivisor(static_cast<size_t>(inputRate), static_cast<size_t>(outputRate));
+    inputStep = static_cast<size_t>(inputRate) / divisor;
+    phaseCount = static_cast<size_t>(outputRate) / divisor;
+    if (phaseCount > kMaxPhases) {
+        return false;
+    }
+    channels = channelCount;
+
+    const double cutoff = std::min(1.0, static_cast<double>(outputRate) / inputRate);
+    const double halfWidth = halfTaps / cutoff;
+    const double windowNorm = 1.0 / BesselI0(kKaiserBeta);
+    const size_t halfTapCount = static_cast<size_t>(std::ceil(halfWidth));
+    tapCount = 2 * halfTapCount;
+
+    // Tap j of phase p weights input frame (floor(position) - halfTapCount + 1 + j)
+    phaseTable.assign(phaseCount * tapCount, 0.0f);
+    for (size_t phase = 0; phase < phaseCount; phase++) {
+        double fraction = static_cast<double>(phase) / phaseCount;
+        for (size_t j = 0; j < tapCount; j++) {
+            double distance = fraction + static_cast<double>(halfTapCount) - 1.0 - static_cast<double>(j);
+            if (std::fabs(distance) > halfWidth) {
+                continue;
+            }
+            double x = distance * cutoff;
+            double sinc = (std::fabs(x) < 1e-9) ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+            double ratio = distance / halfWidth;
+            double window = BesselI0(kKaiserBeta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) * windowNorm;
+            phaseTable[phase * tapCount + j] = static_cast<float>(sinc * window * cutoff);
+        }
+    }
+
+    Reset();
+    return true;
+}
+
+void PolyphaseResampler::Reset() {
+    // The stream starts with silence before the first input frame
+    const size_t halfTapCount = tapCount / 2;
+    history.assign(channels, std::vector<float>(halfTapCount, 0.0f));
+    historyStart = 0;
+    inputFrames = 0;
+    outputFrames = 0;
+}
+
+size_t PolyphaseResampler::Process(const float* input, size_t frameCount, std::vector<float>& output) {
+    if (channels == 0) {
+        return 0;
+    }
+    for (int ch = 0; ch < channels; ch++) {
+        std::vector<float>& plane = history[ch];
+        const size_t offset = plane.size();
+        plane.resize(offset + frameCount);
+        VectorOps::Deinterleave(input, channels, ch, plane.data() + offset, frameCount);
+    }
+    inputFrames += frameCount;
+    return Produce(output, inputFrames);
+}
+
+size_t PolyphaseResampler::Flush(std::vector<float>& output) {
+    if (channels == 0) {
+        return 0;
+    }
+    // Pad with silence so every output up to the end of the input can be computed
+    for (std::vector<float>& plane : history) {
+        plane.resize(plane.size() + tapCount, 0.0f);
+    }
+    size_t produced = Produce(output, inputFrames + tapCount);
+
+    // Drop outputs that would lie beyond the last input frame
+    size_t totalOutput = (inputFrames * phaseCount + inputStep - 1) / inputStep;
+    if (outputFrames > totalOutput) {
+        size_t excess = std::min(outputFrames - totalOutput, produced);
+        output.resize(output.size() - excess * channels);
+        produced -= excess;
+        outputFrames -= excess;
+    }
+    return produced;
+}
+
+size_t PolyphaseResampler::Produce(std::vector<float>& output, size_t availableFrames) {
+    // history[ch][0] holds absolute frame (historyStart - halfTapCount)
+    const size_t halfTapCount = tapCount / 2;
+    size_t produced = 0;
+
+    for (;;) {
+        size_t numerator = outputFrames * inputStep;
+        size_t base = numerator / phaseCount;
+        size_t phase = numerator % phaseCount;
+        // Needs frames up to base + halfTapCount
+        if (base + halfTapCount >= availableFrames) {
+            break;
+        }
+
+        const float* coefficients = &phaseTable[phase * tapCount];
+        // First tap is frame base - halfTapCount + 1, i.e. history index base - historyStart + 1
+        const size_t first = base - historyStart + 1;
+        size_t offset = output.size();
+        output.resize(offset + channels, 0.0f);
+        for (int ch = 0; ch < channels; ch++) {
+            output[offset + ch] = VectorOps::DotProduct(coefficients, history[ch].data() + first, tapCount);
+        }
+        outputFrames++;
+        produced++;
+    }
+
+    // Discard input no future output can reach
+    size_t nextBase = (outputFrames * inputStep) / phaseCount;
+    if (nextBase > historyStart) {
+        size_t discard = nextBase - historyStart;
+        for (std::vector<float>& plane : history) {
+            plane.erase(plane.begin(), plane.begin() + discard);
+        }
+        historyStart += discard;
+    }
+    return produced;
+}
@@ -0,0 +1,105 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Sample rate conversion helpers
+ */
+namespace Resampler {
+
+    /**
+     * @brief Band-limited offline resampling of a mono signal
+     *
+     * Uses a Kaiser-windowed sinc kernel evaluated at every output position, so any
+     * rate ratio is supported. When downsampling the kernel is widened to keep the
+     * cutoff below the output Nyquist frequency. Intended for preparing filters and
+     * other data ahead of playback, not for the real-time path.
+     * @param input Input samples
+     * @param inputRate Input sample rate in Hz
+     * @param outputRate Output sample rate in Hz
+     * @param output Receives the resampled signal
+     * @param halfTaps Kernel half-width in zero crossings (quality)
+     * @return true if conversion was successful, false otherwise
+     */
+    bool ResampleOffline(const std::vector<float>& input,
+                         int inputRate,
+                         int outputRate,
+                         std::vector<float>& output,
+                         int halfTaps = 32);
+
+} // namespace Resampler
+
+/**
+ * @brief Streaming polyphase resampler for rational rate ratios
+ *
+ * Uses the same Kaiser-windowed sinc kernel as Resampler::ResampleOffline, but
+ * tabulated once per phase of the reduced ratio (e.g. 160 phases for 44.1kHz ->
+ * 48kHz), so each output sample is a plain dot product. The input history is
+ * kept planar, so that dot product runs over contiguous samples with the
+ * vector kernel; input and output stay interleaved. Output sample n lies at
+ * input position n * inputRate / outputRate, exactly as in the offline version,
+ * and input may be pushed in blocks of any size.
+ */
+class PolyphaseResampler {
+public:
+    /**
+     * @brief Build the phase table for a rate pair
+     * @param inputRate Input sample rate in Hz
+     * @param outputRate Output sample rate in Hz
+     * @param channels Number of interleaved channels
+     * @param halfTaps Kernel half-width in zero crossings (quality)
+     * @return true if initialized, false if the reduced ratio needs too many phases
+     */
+    bool Initialize(int inputRate, int outputRate, int channels, int halfTaps = 32);
+
+    /**
+     * @brief Resample a block of interleaved input
+     * @param input Interleaved input samples
+     * @param frameCount Number of input frames
+     * @param output Receives the interleaved output frames (appended)
+     * @return Number of output frames appended
+     */
+    size_t Process(const float* input, size_t frameCount, std::vector<float>& output);
+
+    /**
+     * @brief Emit the remaining output at end of stream (call Reset before reuse)
+     * @param output Receives the interleaved output frames (appended)
+     * @return Number of output frames appended
+     */
+    size_t Flush(std::vector<float>& output);
+
+    /**
+     * @brief Clear the stream history
+     */
+    void Reset();
+
+    /**
+     * @brief Get the phase table, for backends that run the same filter elsewhere
+     *
+     * Output frame n uses phase (n * GetInputStep()) % GetPhaseCount(); tap j of
+     * that phase weights input frame floor(n * GetInputStep() / GetPhaseCount())
+     * - GetTapCount() / 2 + 1 + j, with frames before 0 being silence.
+     * @return GetPhaseCount() x GetTapCount() coefficients
+     */
+    const std::vector<float>& GetPhaseTable() const { return phaseTable; }
+    size_t GetPhaseCount() const { return phaseCount; }
+    size_t GetInputStep() const { return inputStep; }
+    size_t GetTapCount() const { return tapCount; }
+
+private:
+    size_t Produce(std::vector<float>& output, size_t availableFrames);
+
+    int channels = 0;
+    size_t inputStep = 1;       // Reduced input rate (M)
+    size_t phaseCount = 1;      // Reduced output rate (L)
+    size_t tapCount = 0;        // Taps per phase
+    std::vector<float> phaseTable;      // phaseCount x tapCount coefficients
+    std::vector<std::vector<float>> history;   // Input not yet fully consumed, one plane per channel
+    size_t historyStart = 0;    // Absolute input frame index of history[0]
+    size_t inputFrames = 0;     // Total input frames pushed
+    size_t outputFrames = 0;    // Total output frames produced
+};
+
+#endif // RESAMPLER_H
\ No newline at end of file
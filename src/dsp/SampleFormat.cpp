@@ -0,0 +1,70 @@
+#include "SampleFormat.h"
+
+// Dispatch tables of the sample format kernels
+
+namespace {
+
+void DecodeUnsupported(const char*, float* destination, size_t sampleCount) {
+    std::fill_n(destination, sampleCount, 0.0f);
+}
+
+void EncodeUnsupported(const float*, char*, size_t) {
+}
+
+template <typename Format>
+SampleFormat::Codec MakeCodec(const char* name) {
+    return {name, static_cast<unsigned>(Format::kBits), Format::kFloat,
+            &SampleFormat::Decode<Format>, &SampleFormat::Encode<Format>};
+}
+
+const SampleFormat::Codec kCodecs[] = {
+    MakeCodec<SampleFormat::UInt8>("8-bit unsigned"),
+    MakeCodec<SampleFormat::Int16>("16-bit signed little-endian"),
+    MakeCodec<SampleFormat::Int24>("24-bit signed little-endian"),
+    MakeCodec<SampleFormat::Int32>("32-bit signed little-endian"),
+    MakeCodec<SampleFormat::Float32>("32-bit float little-endian"),
+};
+
+const SampleFormat::Codec kUnsupportedCodec = {"unsupported", 0, false, &DecodeUnsupported, &EncodeUnsupported};
+
+// Mono and stereo get kernels with the channel count built in
+template <typename Format>
+SampleFormat::InterleaveKernel SelectInterleave(unsigned channels) {
+    if (channels == 1) {
+        return &SampleFormat::Interleave<Format, 1>;
+    }
+    if (channels == 2) {
+        return &SampleFormat::Interleave<Format, 2>;
+    }
+    return &SampleFormat::Interleave<Format, 0>;
+}
+
+} // namespace
+
+namespace SampleFormat {
+
+const Codec& GetCodec(unsigned bitsPerSample, bool isFloat) {
+    for (const Codec& codec : kCodecs) {
+        if (codec.bitsPerSample == bitsPerSample && codec.isFloat == isFloat) {
+            return codec;
+        }
+    }
+    return kUnsupportedCodec;
+}
+
+InterleaveKernel GetInterleaveKernel(unsigned bitsPerSample, unsigned channels) {
+    switch (bitsPerSample) {
+    case 8:
+        return SelectInterleave<UInt8>(channels);
+    case 16:
+        return SelectInterleave<Int16>(channels);
+    case 24:
+        return SelectInterleave<Int24>(channels);
+    case 32:
+        return SelectInterleave<Int32>(channels);
+    default:
+        return nullptr;
+    }
+}
+
+} // namespace SampleFormat
@@ -0,0 +1,249 @@
+#ifndef SAMPLE_FORMAT_H
+#define SAMPLE_FORMAT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Compile-time sample formats and the conversion kernels built from them
+ *
+ * A Traits instantiation fixes container size, signedness, byte order and
+ * encoding (integer or IEEE float) at compile time, so each kernel is a
+ * straight loop without per-sample branches that the compiler can unroll and
+ * vectorize. Streams pick their kernels once, through GetCodec and
+ * GetInterleaveKernel, when their format is known.
+ *
+ * Integer samples are scaled to [-1, 1) on decode and clipped and rounded to
+ * nearest (ties to even, as lrint) on encode; 8-bit samples are unsigned,
+ * as in WAV files.
+ */
+namespace SampleFormat {
+
+    /**
+     * @brief Description of one sample format
+     * @tparam Bytes Container size in bytes (1 to 4)
+     * @tparam Signed Whether integer samples are two's complement (else offset binary)
+     * @tparam BigEndian Byte order of the container
+     * @tparam Float Whether samples are IEEE floats (4 bytes)
+     */
+    template <int Bytes, bool Signed, bool BigEndian = false, bool Float = false>
+    struct Traits {
+        static_assert(Bytes >= 1 && Bytes <= 4, "Samples are 1 to 4 bytes");
+        static_assert(!Float || Bytes == 4, "Float samples are 4 bytes");
+
+        static constexpr int kBytes = Bytes;
+        static constexpr int kBits = 8 * Bytes;
+        static constexpr bool kSigned = Signed || Float;
+        static constexpr bool kBigEndian = BigEndian;
+        static constexpr bool kFloat = Float;
+
+        // Integer full scale and largest positive value
+        static constexpr double kFullScale = static_cast<double>(1ULL << (kBits - 1));
+        static constexpr double kMaxValue = kFullScale - 1.0;
+
+        /**
+         * @brief Read the raw container bits
+         */
+        static uint32_t LoadBits(const unsigned char* source) {
+            uint32_t bits = 0;
+            for (int byte = 0; byte < Bytes; byte++) {
+                bits |= static_cast<uint32_t>(source[BigEndian ? Bytes - 1 - byte : byte]) << (8 * byte);
+            }
+            return bits;
+        }
+
+        /**
+         * @brief Write the raw container bits
+         */
+        static void StoreBits(uint32_t bits, unsigned char* destination) {
+            for (int byte = 0; byte < Bytes; byte++) {
+                destination[BigEndian ? Bytes - 1 - byte : byte] = static_cast<unsigned char>(bits >> (8 * byte));
+            }
+        }
+
+        /**
+         * @brief Read an integer sample as a signed value in [-kFullScale, kMaxValue]
+         */
+        static int32_t LoadInt(const unsigned char* source) {
+            const uint32_t bits = LoadBits(source);
+            if (Signed) {
+                // Move the sign bit to bit 31, then shift back with sign extension
+                return static_cast<int32_t>(bits << (32 - kBits)) >> (32 - kBits);
+            }
+            return static_cast<int32_t>(bits) - static_cast<int32_t>(1U << (kBits - 1));
+        }
+
+        /**
+         * @brief Write a signed integer sample in [-kFullScale, kMaxValue]
+         */
+        static void StoreInt(int32_t value, unsigned char* destination) {
+            const uint32_t bits = static_cast<uint32_t>(value);
+            StoreBits(Signed ? bits : bits + (1U << (kBits - 1)), destination);
+        }
+
+        /**
+         * @brief Read one sample as float
+         */
+        static float Load(const unsigned char* source) {
+            if (Float) {
+                const uint32_t bits = LoadBits(source);
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
+            return static_cast<float>(LoadInt(source)) * static_cast<float>(1.0 / kFullScale);
+        }
+
+        // Clipped, scaled sample before rounding: float up to 24 bits (as the
+        // reference conversion), double for 32 bits, where float lacks precision
+        typedef typename std::conditional<(kBits > 24), double, float>::type Scaled;
+
+        /**
+         * @brief Clip a float sample to [-1, 1] and scale it to the integer range
+         */
+        static Scaled Scale(float sample) {
+            // Clipping after scaling gives the same result and, unlike the other
+            // order, lets the compiler vectorize the loop
+            const Scaled maxValue = static_cast<Scaled>(kMaxValue);
+            const Scaled scaled = static_cast<Scaled>(sample) * maxValue;
+            return std::max(-maxValue, std::min(maxValue, scaled));
+        }
+
+        /**
+         * @brief Round a scaled sample to the nearest integer, ties to even (as lrint)
+         *
+         * Adding and subtracting 1.5 * 2^(mantissa bits) does the rounding in
+         * the FPU's default mode without a library call, so loops vectorize.
+         */
+        static int32_t Round(Scaled value) {
+            if (kBits <= 16) {
+                const float magic = 12582912.0f;
+                return static_cast<int32_t>((static_cast<float>(value) + magic) - magic);
+            }
+            const double magic = 6755399441055744.0;
+            return static_cast<int32_t>((static_cast<double>(value) + magic) - magic);
+        }
+
+        /**
+         * @brief Write one float sample, clipped to the integer range
+         */
+        static void Store(float sample, unsigned char* destination) {
+            if (Float) {
+                uint32_t bits;
+                std::memcpy(&bits, &sample, sizeof(bits));
+                StoreBits(bits, destination);
+                return;
+            }
+            StoreInt(Round(Scale(sample)), destination);
+        }
+    };
+
+    typedef Traits<1, false> UInt8;
+    typedef Traits<2, true> Int16;
+    typedef Traits<3, true> Int24;
+    typedef Traits<4, true> Int32;
+    typedef Traits<4, true, false, true> Float32;
+    typedef Traits<2, true, true> Int16BigEndian;
+    typedef Traits<3, true, true> Int24BigEndian;
+
+    /**
+     * @brief Convert interleaved samples to float
+     */
+    template <typename Format>
+    void Decode(const char* source, float* destination, size_t sampleCount) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(source);
+        for (size_t i = 0; i < sampleCount; i++) {
+            destination[i] = Format::Load(bytes + i * Format::kBytes);
+        }
+    }
+
+    /**
+     * @brief Convert float samples to the format, with clipping
+     */
+    template <typename Format>
+    void Encode(const float* source, char* destination, size_t sampleCount) {
+        unsigned char* bytes = reinterpret_cast<unsigned char*>(destination);
+        if (Format::kFloat) {
+            for (size_t i = 0; i < sampleCount; i++) {
+                Format::Store(source[i], bytes + i * Format::kBytes);
+            }
+            return;
+        }
+        // Clipping and rounding run as separate loops over short chunks: each
+        // vectorizes on its own, but not together, as the float to integer
+        // conversion may trap and keeps the clipping branches in place
+        const size_t kChunk = 256;
+        typename Format::Scaled scaled[kChunk];
+        for (size_t start = 0; start < sampleCount; start += kChunk) {
+            const size_t count = std::min(kChunk, sampleCount - start);
+            for (size_t i = 0; i < count; i++) {
+                scaled[i] = Format::Scale(source[start + i]);
+            }
+            unsigned char* chunk = bytes + start * Format::kBytes;
+            for (size_t i = 0; i < count; i++) {
+                Format::StoreInt(Format::Round(scaled[i]), chunk + i * Format::kBytes);
+            }
+        }
+    }
+
+    /**
+     * @brief Interleave planar integer channels (as libFLAC delivers them) into the format
+     * @tparam Format Integer format of the destination
+     * @tparam Channels Channel count, or 0 to take it from the argument
+     * @param planes One array of right-justified samples per channel
+     * @param channels Channel count (used when Channels is 0)
+     * @param frames Number of frames
+     * @param shift Left shift that moves the samples to the top of the container
+     * @param destination Receives frames * channels samples
+     */
+    template <typename Format, unsigned Channels>
+    void Interleave(const int32_t* const* planes, unsigned channels, size_t frames, unsigned shift, char* destination) {
+        static_assert(!Format::kFloat, "Interleaving is for integer samples");
+        const unsigned count = Channels > 0 ? Channels : channels;
+        unsigned char* bytes = reinterpret_cast<unsigned char*>(destination);
+        for (size_t frame = 0; frame < frames; frame++) {
+            for (unsigned channel = 0; channel < count; channel++) {
+                const int32_t value = static_cast<int32_t>(static_cast<uint32_t>(planes[channel][frame]) << shift);
+                Format::StoreInt(value, bytes + (frame * count + channel) * Format::kBytes);
+            }
+        }
+    }
+
+    typedef void (*DecodeKernel)(const char* source, float* destination, size_t sampleCount);
+    typedef void (*EncodeKernel)(const float* source, char* destination, size_t sampleCount);
+    typedef void (*InterleaveKernel)(const int32_t* const* planes, unsigned channels, size_t frames,
+                                     unsigned shift, char* destination);
+
+    /**
+     * @brief Kernels of one format, selected once per stream
+     */
+    struct Codec {
+        const char* name;           // e.g. "24-bit signed little-endian"
+        unsigned bitsPerSample;     // 0 for the unsupported codec
+        bool isFloat;
+        DecodeKernel decode;        // Writes silence for the unsupported codec
+        EncodeKernel encode;        // Writes nothing for the unsupported codec
+    };
+
+    /**
+     * @brief Get the codec of a little-endian PCM format (WAV and device byte order)
+     * @param bitsPerSample Container size: 8, 16, 24 or 32
+     * @param isFloat Whether 32-bit samples are IEEE floats
+     * @return The codec; its bitsPerSample is 0 if the format is not supported
+     */
+    const Codec& GetCodec(unsigned bitsPerSample, bool isFloat = false);
+
+    /**
+     * @brief Get the kernel that interleaves planar integer channels into a little-endian container
+     * @param bitsPerSample Container size: 8, 16, 24 or 32
+     * @param channels Channel count; mono and stereo have their own kernels
+     * @return The kernel, or nullptr if the container size is not supported
+     */
+    InterleaveKernel GetInterleaveKernel(unsigned bitsPerSample, unsigned channels);
+
+} // namespace SampleFormat
+
+#endif // SAMPLE_FORMAT_H
@@ -0,0 +1,376 @@
+#include "StreamMixer.h"
+#include "VectorOps.h"
+#include "core/LockFreeRingBuffer.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Implementation of the multi-stream mixer
+
+namespace {
+
+// Commands a voice can queue between two blocks
+const size_t kCommandQueueSize = 16;
+
+// Slot states; the control thread owns Free slots, the audio thread Playing ones
+const int kVoiceFree = 0;
+const int kVoicePlaying = 1;
+const int kVoiceFinished = 2;
+
+struct Command {
+    enum Type { Gain, Pan, Stop };
+    Type type;
+    float value;
+};
+
+struct Route {
+    int input;
+    int output;
+};
+
+struct Voice {
+    std::atomic<int> state{kVoiceFree};
+    LockFreeRingBuffer<Command> commands;
+
+    // Written by the control thread while the slot is free
+    std::shared_ptr<const AudioClip> clip;
+    std::vector<Route> routes;
+    bool loop = false;
+
+    // Control thread only
+    unsigned generation = 0;
+    float requestedGain = 0.0f;
+    float requestedPan = 0.0f;
+
+    // Audio thread only
+    float gain = 0.0f;
+    float pan = 0.0f;
+    bool stopping = false;
+    size_t position = 0;
+    std::vector<float> routeGains;   // Gains applied at the end of the last block
+    std::vector<float> targetGains;
+
+    // Written by the audio thread, read by the control thread
+    std::atomic<size_t> framesPlayed{0};
+};
+
+} // namespace
+
+class StreamMixer::Impl {
+public:
+    int outputChannels = 0;
+    size_t maxBlockFrames = 0;
+    size_t maxVoices = 0;
+    std::unique_ptr<Voice[]> voices;
+
+    std::atomic<size_t> playingCount{0};
+    std::atomic<size_t> mixedCount{0};
+    std::atomic<size_t> voiceBudget{SIZE_MAX};
+
+    // Audio thread scratch
+    std::vector<float> accumulator;   // One block per output channel
+    std::vector<Voice*> active;
+
+    Voice* Find(int id) {
+        if (id < 0 || maxVoices == 0) {
+            return nullptr;
+        }
+        Voice& voice = voices[id % maxVoices];
+        if (voice.generation != static_cast<unsigned>(id) / maxVoices ||
+            voice.state.load(std::memory_order_acquire) != kVoicePlaying) {
+            return nullptr;
+        }
+        return &voice;
+    }
+
+    bool Send(int id, Command::Type type, float value) {
+        Voice* voice = Find(id);
+        if (!voice) {
+            return false;
+        }
+        Command command = {type, value};
+        return voice->commands.Write(&command, 1) == 1;
+    }
+
+    // Release the clips of finished voices (control thread)
+    void Reclaim() {
+        for (size_t slot = 0; slot < maxVoices; slot++) {
+            Voice& voice = voices[slot];
+            if (voice.state.load(std::memory_order_acquire) == kVoiceFinished) {
+                // A new generation makes the old ID stale
+                voice.clip.reset();
+                voice.generation = (voice.generation + 1) % static_cast<unsigned>(INT_MAX / maxVoices);
+                voice.state.store(kVoiceFree, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void ComputeTargets(Voice& voice) {
+        const float gain = voice.stopping ? 0.0f : voice.gain;
+        const float pan = std::max(-1.0f, std::min(1.0f, voice.pan));
+        const size_t clipChannels = voice.clip->channels.size();
+        for (size_t r = 0; r < voice.routes.size(); r++) {
+            float routeGain = gain;
+            if (clipChannels == 1 && outputChannels >= 2) {
+                // Equal-power pan
+                double angle = (pan + 1.0) * M_PI / 4.0;
+                routeGain *= static_cast<float>(voice.routes[r].output == 0 ? std::cos(angle) : std::sin(angle));
+            } else if (clipChannels == 2 && outputChannels >= 2) {
+                // Balance: attenuate the opposite side only
+                routeGain *= voice.routes[r].output == 0 ? std::min(1.0f, 1.0f - pan) : std::min(1.0f, 1.0f + pan);
+            } else if (clipChannels == 2 && outputChannels == 1) {
+                routeGain *= 0.5f;
+            }
+            voice.targetGains[r] = routeGain;
+        }
+    }
+
+    // Mix one voice into the accumulator, or only advance it when it is over budget
+    void Render(Voice& voice, size_t frames, bool audible) {
+        ComputeTargets(voice);
+        const AudioClip& clip = *voice.clip;
+        const size_t clipFrames = clip.GetFrameCount();
+        bool finished = false;
+
+        size_t done = 0;
+        while (done < frames) {
+            const size_t count = std::min(frames - done, clipFrames - voice.position);
+            if (audible) {
+                for (size_t r = 0; r < voice.routes.size(); r++) {
+                    // Ramp from the last block's gain to the target across the whole block
+                    const float from = voice.routeGains[r];
+                    const float delta = voice.targetGains[r] - from;
+                    const float start = from + delta * done / frames;
+                    const float end = from + delta * (done + count) / frames;
+                    float* destination = &accumulator[voice.routes[r].output * maxBlockFrames + done];
+                    const float* source = &clip.channels[voice.routes[r].input][voice.position];
+                    if (start == end) {
+                        if (start != 0.0f) {
+                            VectorOps::MultiplyAdd(destination, source, start, count);
+                        }
+                    } else {
+                        VectorOps::MultiplyAddRamp(destination, source, start, end, count);
+                    }
+                }
+            }
+            voice.position += count;
+            done += count;
+            if (voice.position == clipFrames) {
+                if (!voice.loop || voice.stopping) {
+                    finished = true;
+                    break;
+                }
+                voice.position = 0;
+            }
+        }
+
+        // A skipped voice fades in when it is mixed again
+        for (size_t r = 0; r < voice.routes.size(); r++) {
+            voice.routeGains[r] = audible ? voice.targetGains[r] : 0.0f;
+        }
+        voice.framesPlayed.store(voice.position, std::memory_order_relaxed);
+
+        if (finished || voice.stopping) {
+            playingCount.fetch_sub(1, std::memory_order_relaxed);
+            voice.state.store(kVoiceFinished, std::memory_order_release);
+        }
+    }
+};
+
+StreamMixer::StreamMixer() : pImpl(std::make_unique<Impl>()) {}
+
+StreamMixer::~StreamMixer() = default;
+
+bool StreamMixer::Prepare(int outputChannels, size_t maxBlockFrames, size_t maxVoices) {
+    if (outputChannels <= 0 || maxBlockFrames == 0 || maxVoices == 0) {
+        return false;
+    }
+
+    pImpl->outputChannels = outputChannels;
+    pImpl->maxBlockFrames = maxBlockFrames;
+    pImpl->maxVoices = maxVoices;
+    pImpl->voices.reset(new Voice[maxVoices]);
+    for (size_t slot = 0; slot < maxVoices; slot++) {
+        Voice& voice = pImpl->voices[slot];
+        voice.commands.Reset(kCommandQueueSize);
+        voice.routes.reserve(outputChannels);
+        voice.routeGains.assign(outputChannels, 0.0f);
+        voice.targetGains.assign(outputChannels, 0.0f);
+    }
+    pImpl->accumulator.assign(static_cast<size_t>(outputChannels) * maxBlockFrames, 0.0f);
+    pImpl->active.assign(maxVoices, nullptr);
+    pImpl->playingCount.store(0);
+    pImpl->mixedCount.store(0);
+    return true;
+}
+
+int StreamMixer::AddVoice(std::shared_ptr<const AudioClip> clip, float gain, float pan, bool loop) {
+    if (!clip || clip->GetFrameCount() == 0 || pImpl->maxVoices == 0) {
+        return -1;
+    }
+
+    const int clipChannels = static_cast<int>(clip->channels.size());
+    const int outputChannels = pImpl->outputChannels;
+    std::vector<Route> routes;
+    if (clipChannels == 1) {
+        routes.push_back({0, 0});
+        if (outputChannels >= 2) {
+            routes.push_back({0, 1});
+        }
+    } else if (clipChannels == 2) {
+        routes.push_back({0, 0});
+        routes.push_back({1, outputChannels >= 2 ? 1 : 0});
+    } else if (clipChannels == outputChannels) {
+        for (int channel = 0; channel < clipChannels; channel++) {
+            routes.push_back({channel, channel});
+        }
+    } else {
+        return -1;
+    }
+
+    pImpl->Reclaim();
+    for (size_t slot = 0; slot < pImpl->maxVoices; slot++) {
+        Voice& voice = pImpl->voices[slot];
+        if (voice.state.load(std::memory_order_acquire) != kVoiceFree) {
+            continue;
+        }
+
+        voice.clip = std::move(clip);
+        voice.routes.assign(routes.begin(), routes.end());
+        voice.loop = loop;
+        voice.requestedGain = gain;
+        voice.requestedPan = pan;
+        voice.gain = gain;
+        voice.pan = pan;
+        voice.stopping = false;
+        voice.position = 0;
+        voice.framesPlayed.store(0, std::memory_order_relaxed);
+        voice.commands.Reset(kCommandQueueSize);
+
+        // Start at the target gain rather than fading in, so transients are kept
+        pImpl->ComputeTargets(voice);
+        voice.routeGains = voice.targetGains;
+
+        pImpl->playingCount.fetch_add(1, std::memory_order_relaxed);
+        voice.state.store(kVoicePlaying, std::memory_order_release);
+        return static_cast<int>(voice.generation * pImpl->maxVoices + slot);
+    }
+    return -1;
+}
+
+bool StreamMixer::SetGain(int voice, float gain) {
+    if (!pImpl->Send(voice, Command::Gain, gain)) {
+        return false;
+    }
+    pImpl->voices[voice % pImpl->maxVoices].requestedGain = gain;
+    return true;
+}
+
+bool StreamMixer::SetPan(int voice, float pan) {
+    if (!pImpl->Send(voice, Command::Pan, pan)) {
+        return false;
+    }
+    pImpl->voices[voice % pImpl->maxVoices].requestedPan = pan;
+    return true;
+}
+
+bool StreamMixer::StopVoice(int voice) {
+    return pImpl->Send(voice, Command::Stop, 0.0f);
+}
+
+void StreamMixer::StopAll() {
+    for (size_t slot = 0; slot < pImpl->maxVoices; slot++) {
+        Voice& voice = pImpl->voices[slot];
+        if (voice.state.load(std::memory_order_acquire) == kVoicePlaying) {
+            Command command = {Command::Stop, 0.0f};
+            voice.commands.Write(&command, 1);
+        }
+    }
+}
+
+void StreamMixer::SetVoiceBudget(size_t voices) {
+    pImpl->voiceBudget.store(voices, std::memory_order_relaxed);
+}
+
+void StreamMixer::Process(float* output, size_t frameCount) {
+    if (!pImpl->voices || frameCount == 0 || frameCount > pImpl->maxBlockFrames ||
+        pImpl->playingCount.load(std::memory_order_relaxed) == 0) {
+        pImpl->mixedCount.store(0, std::memory_order_relaxed);
+        return;
+    }
+
+    // Apply queued commands and collect the playing voices
+    size_t activeCount = 0;
+    for (size_t slot = 0; slot < pImpl->maxVoices; slot++) {
+        Voice& voice = pImpl->voices[slot];
+        if (voice.state.load(std::memory_order_acquire) != kVoicePlaying) {
+            continue;
+        }
+        Command command;
+        while (voice.commands.Read(&command, 1) == 1) {
+            switch (command.type) {
+                case Command::Gain: voice.gain = command.value; break;
+                case Command::Pan: voice.pan = command.value; break;
+                case Command::Stop: voice.stopping = true; break;
+            }
+        }
+        pImpl->active[activeCount++] = &voice;
+    }
+
+    // Over budget: move the loudest voices to the front and mix only those
+    size_t mixed = std::min(activeCount, pImpl->voiceBudget.load(std::memory_order_relaxed));
+    if (mixed < activeCount) {
+        auto loudness = [](const Voice* voice) { return voice->stopping ? 0.0f : std::fabs(voice->gain); };
+        std::nth_element(pImpl->active.begin(), pImpl->active.begin() + mixed, pImpl->active.begin() + activeCount,
+                         [&](const Voice* a, const Voice* b) { return loudness(a) > loudness(b); });
+    }
+
+    const int channels = pImpl->outputChannels;
+    for (int channel = 0; channel < channels; channel++) {
+        std::fill_n(&pImpl->accumulator[channel * pImpl->maxBlockFrames], frameCount, 0.0f);
+    }
+    for (size_t i = 0; i < activeCount; i++) {
+        pImpl->Render(*pImpl->active[i], frameCount, i < mixed);
+    }
+    pImpl->mixedCount.store(mixed, std::memory_order_relaxed);
+
+    for (int channel = 0; channel < channels; channel++) {
+        const float* source = &pImpl->accumulator[channel * pImpl->maxBlockFrames];
+        for (size_t frame = 0; frame < frameCount; frame++) {
+            output[frame * channels + channel] += source[frame];
+        }
+    }
+}
+
+size_t StreamMixer::GetActiveVoiceCount() const {
+    return pImpl->playingCount.load(std::memory_order_relaxed);
+}
+
+size_t StreamMixer::GetMixedVoiceCount() const {
+    return pImpl->mixedCount.load(std::memory_order_relaxed);
+}
+
+std::vector<StreamMixer::VoiceInfo> StreamMixer::GetVoices() const {
+    std::vector<VoiceInfo> result;
+    for (size_t slot = 0; slot < pImpl->maxVoices; slot++) {
+        const Voice& voice = pImpl->voices[slot];
+        if (voice.state.load(std::memory_order_acquire) != kVoicePlaying) {
+            continue;
+        }
+        const double rate = voice.clip->sampleRate > 0 ? voice.clip->sampleRate : 1.0;
+        VoiceInfo info;
+        info.id = static_cast<int>(voice.generation * pImpl->maxVoices + slot);
+        info.gain = voice.requestedGain;
+        info.pan = voice.requestedPan;
+        info.position = voice.framesPlayed.load(std::memory_order_relaxed) / rate;
+        info.duration = voice.clip->GetFrameCount() / rate;
+        info.loop = voice.loop;
+        result.push_back(info);
+    }
+    return result;
+}
@@ -0,0 +1,145 @@
+#ifndef STREAM_MIXER_H
+#define STREAM_MIXER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Decoded audio held in memory for playback as a mixer voice
+ */
+struct AudioClip {
+    int sampleRate = 0;
+    std::vector<std::vector<float>> channels;   // One array of samples per channel
+
+    size_t GetFrameCount() const { return channels.empty() ? 0 : channels[0].size(); }
+};
+
+/**
+ * @brief Mixes many decoded streams (voices) with per-voice gain and pan
+ *
+ * Voices live in a fixed set of slots allocated by Prepare. Each slot has its
+ * own lock-free command queue: the control thread starts voices and queues
+ * gain, pan and stop commands, and the audio thread applies them at the start
+ * of the next block, so Process never locks or allocates. Clips are released
+ * on the control thread after their voice ends.
+ *
+ * Voices are summed into one planar block per output channel with vectorized
+ * multiply-adds; gain and pan changes ramp over one block. When more voices
+ * play than the voice budget allows, only the loudest are mixed and the rest
+ * keep their position silently, which bounds the cost of a block.
+ *
+ * Control methods must be called from one thread at a time.
+ */
+class StreamMixer {
+public:
+    /**
+     * @brief State of one voice as seen by the control thread
+     */
+    struct VoiceInfo {
+        int id;
+        float gain;            // Linear gain
+        float pan;             // -1 (left) to 1 (right)
+        double position;       // Seconds played
+        double duration;       // Clip length in seconds
+        bool loop;
+    };
+
+    /**
+     * @brief Constructor
+     */
+    StreamMixer();
+
+    /**
+     * @brief Destructor
+     */
+    ~StreamMixer();
+
+    /**
+     * @brief Allocate the voice slots and mix buffers; stops every voice (not thread-safe with Process)
+     * @param outputChannels Number of interleaved output channels
+     * @param maxBlockFrames Largest frame count passed to Process
+     * @param maxVoices Number of voice slots
+     * @return true if successful, false on invalid parameters
+     */
+    bool Prepare(int outputChannels, size_t maxBlockFrames, size_t maxVoices);
+
+    /**
+     * @brief Start a voice
+     *
+     * Mono and stereo clips are panned across the first two output channels
+     * (equal-power for mono, balance for stereo). Clips with as many channels
+     * as the output map channel to channel and ignore pan.
+     * @param clip Clip at the output sample rate
+     * @param gain Linear gain
+     * @param pan -1 (left) to 1 (right)
+     * @param loop Restart the clip when it ends
+     * @return Voice ID, or -1 if no slot is free or the clip's channels cannot be mapped
+     */
+    int AddVoice(std::shared_ptr<const AudioClip> clip, float gain, float pan, bool loop = false);
+
+    /**
+     * @brief Change the gain of a voice
+     * @param voice Voice ID
+     * @param gain Linear gain
+     * @return true if the voice is playing, false otherwise
+     */
+    bool SetGain(int voice, float gain);
+
+    /**
+     * @brief Change the pan of a voice
+     * @param voice Voice ID
+     * @param pan -1 (left) to 1 (right)
+     * @return true if the voice is playing, false otherwise
+     */
+    bool SetPan(int voice, float pan);
+
+    /**
+     * @brief Stop a voice (fades out over one block)
+     * @param voice Voice ID
+     * @return true if the voice was playing, false otherwise
+     */
+    bool StopVoice(int voice);
+
+    /**
+     * @brief Stop every voice
+     */
+    void StopAll();
+
+    /**
+     * @brief Limit how many voices are mixed per block
+     * @param voices Maximum voices mixed; quieter voices beyond it are skipped
+     */
+    void SetVoiceBudget(size_t voices);
+
+    /**
+     * @brief Add the active voices to a block of interleaved output (audio thread)
+     * @param output Interleaved samples the voices are added to
+     * @param frameCount Number of frames, at most maxBlockFrames
+     */
+    void Process(float* output, size_t frameCount);
+
+    /**
+     * @brief Get the number of voices started and not yet finished
+     */
+    size_t GetActiveVoiceCount() const;
+
+    /**
+     * @brief Get the number of voices mixed in the last block
+     */
+    size_t GetMixedVoiceCount() const;
+
+    /**
+     * @brief Get the state of the active voices
+     * @return One entry per active voice, by slot
+     */
+    std::vector<VoiceInfo> GetVoices() const;
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // STREAM_MIXER_H
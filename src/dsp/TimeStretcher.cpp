@@ -0,0 +1,642 @@
+#include "TimeStretcher.h"
+#include "FFT.h"
+#include "VectorOps.h"
+#include "IGPUProcessor.h"
+#include "core/Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Implementation of varispeed, WSOLA and phase vocoder rate changes
+
+namespace {
+
+// Phase vocoder window at 44.1/48kHz; doubled for each doubling of the sample rate
+const size_t kVocoderWindow = 2048;
+
+// Phase vocoder windows per synthesis hop (75% overlap)
+const size_t kVocoderOverlap = 4;
+
+// WSOLA segments per second (20ms segments, 50% overlap)
+const int kSegmentsPerSecond = 50;
+
+// Decimation of the coarse WSOLA search; segment and search lengths are multiples of it
+const size_t kSearchDecimation = 4;
+
+// Cost of a transcendental function in GetOperationsPerFrame
+const double kTranscendentalCost = 20.0;
+
+const float kTwoPi = static_cast<float>(2.0 * M_PI);
+
+float WrapPhase(float phase) {
+    return phase - kTwoPi * std::floor(phase / kTwoPi + 0.5f);
+}
+
+// Periodic Hann window: overlap-adds to a constant at hops of length / 2 and length / 4
+void MakeHann(std::vector<float>& window, size_t length) {
+    window.resize(length);
+    for (size_t n = 0; n < length; n++) {
+        window[n] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * n / length));
+    }
+}
+
+} // namespace
+
+class TimeStretcher::Impl {
+public:
+    Mode mode = Mode::Varispeed;
+    size_t channels = 1;
+    size_t maxBlock = 0;
+    double rate = 1.0;
+
+    // Input FIFO (interleaved); frame 0 is the oldest frame still needed
+    std::vector<float> input;
+    size_t inputFrames = 0;
+    size_t inputCapacity = 0;
+
+    // Output FIFO (interleaved), read from the front
+    std::vector<float> output;
+    size_t outputFrames = 0;
+    size_t skipFrames = 0;      // Output frames still dropped to compensate for the window delay
+
+    // Next hop's nominal analysis frame, or the next interpolated frame (varispeed)
+    double position = 0.0;
+
+    // Hop-based modes
+    size_t windowLength = 0;
+    size_t synthesisHop = 0;
+    size_t searchRange = 0;            // WSOLA: largest offset from the nominal position
+    std::vector<float> window;         // Analysis window (WSOLA: also the synthesis window)
+    std::vector<float> synthesisWindow;  // Phase vocoder: window scaled for unity overlap-add
+    std::vector<float> accumulator;    // Overlap-add, windowLength per channel
+    std::vector<float> frames;         // Windowed frames, windowLength per channel
+    bool hasPrevious = false;
+    int64_t previousStart = 0;         // Input frame of the previous hop (WSOLA: of the aligned segment)
+
+    // WSOLA search on the channel sum
+    std::vector<float> monoCandidates;   // 2 * searchRange + windowLength frames around the nominal position
+    std::vector<float> monoTemplate;     // Natural continuation of the previous segment
+    std::vector<float> monoScratch;
+    std::vector<float> coarseCandidates;
+    std::vector<float> coarseTemplate;
+    std::vector<float> coarseScores;     // Normalized correlation per coarse lag
+
+    // Phase vocoder
+    std::unique_ptr<FFT> fft;
+    size_t binCount = 0;
+    std::vector<float> re;             // binCount per channel
+    std::vector<float> im;
+    std::vector<float> magnitude;
+    std::vector<float> phase;
+    std::vector<float> newPhase;
+    std::vector<float> previousPhase;  // Analysis phase of the previous hop, binCount per channel
+    std::vector<float> synthesisPhase; // Output phase of the previous hop, binCount per channel
+    std::vector<size_t> peaks;
+    IGPUProcessor* accelerator = nullptr;
+
+    size_t GetPaddingFrames() const {
+        switch (mode) {
+            case Mode::Speech: return windowLength - synthesisHop + searchRange;
+            case Mode::Music: return windowLength - synthesisHop;
+            default: return 1;
+        }
+    }
+
+    // Input frames (from the FIFO start) a hop at the given nominal position reads
+    size_t GetHopEnd(double hopPosition, bool previous, int64_t previousSegment) const {
+        const size_t start = static_cast<size_t>(hopPosition);
+        if (mode == Mode::Music) {
+            return start + windowLength;
+        }
+        size_t end = start + searchRange + windowLength;
+        if (previous) {
+            end = std::max(end, static_cast<size_t>(previousSegment) + synthesisHop + windowLength);
+        }
+        return end;
+    }
+
+    void ProduceInterpolated(size_t frameCount) {
+        float* out = output.data() + outputFrames * channels;
+        size_t produced = 0;
+        while (produced < frameCount) {
+            const size_t index = static_cast<size_t>(position);
+            if (index + 3 > inputFrames) {
+                break;
+            }
+            // Catmull-Rom spline through the frames around the read position
+            const float t = static_cast<float>(position - index);
+            const float* p0 = input.data() + (index - 1) * channels;
+            for (size_t channel = 0; channel < channels; channel++) {
+                const float y0 = p0[channel];
+                const float y1 = p0[channel + channels];
+                const float y2 = p0[channel + 2 * channels];
+                const float y3 = p0[channel + 3 * channels];
+                const float a = -0.5f * y0 + 1.5f * y1 - 1.5f * y2 + 0.5f * y3;
+                const float b = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+                const float c = 0.5f * (y2 - y0);
+                *out++ = ((a * t + b) * t + c) * t + y1;
+            }
+            position += rate;
+            produced++;
+        }
+        outputFrames += produced;
+    }
+
+    void MixToMono(size_t startFrame, size_t frameCount, float* destination) {
+        const float* source = input.data() + startFrame * channels;
+        VectorOps::Deinterleave(source, static_cast<int>(channels), 0, destination, frameCount);
+        for (size_t channel = 1; channel < channels; channel++) {
+            VectorOps::Deinterleave(source, static_cast<int>(channels), static_cast<int>(channel),
+                                    monoScratch.data(), frameCount);
+            VectorOps::Add(destination, monoScratch.data(), frameCount);
+        }
+    }
+
+    static void Decimate(const float* source, size_t frameCount, float* destination) {
+        for (size_t i = 0; i < frameCount / kSearchDecimation; i++) {
+            const float* group = source + i * kSearchDecimation;
+            destination[i] = group[0] + group[1] + group[2] + group[3];
+        }
+    }
+
+    // Offset (0 to 2 * searchRange) of the candidate most similar to the template
+    size_t FindBestOffset() {
+        const size_t span = 2 * searchRange + windowLength;
+        const size_t coarseLength = windowLength / kSearchDecimation;
+        const size_t coarseLags = 2 * searchRange / kSearchDecimation + 1;
+        Decimate(monoCandidates.data(), span, coarseCandidates.data());
+        Decimate(monoTemplate.data(), windowLength, coarseTemplate.data());
+
+        // Coarse search: normalized cross-correlation at every fourth lag, energies as a running sum
+        // Ties (silence, DC) keep the nominal position so the output stays aligned with the input
+        const float* candidates = coarseCandidates.data();
+        float energy = VectorOps::DotProduct(candidates, candidates, coarseLength);
+        const size_t nominalLag = searchRange / kSearchDecimation;
+        size_t bestLag = nominalLag;
+        std::vector<float>& scores = coarseScores;
+        for (size_t lag = 0; lag < coarseLags; lag++) {
+            if (lag > 0) {
+                const float leaving = candidates[lag - 1];
+                const float entering = candidates[lag + coarseLength - 1];
+                energy = std::max(energy - leaving * leaving + entering * entering, 0.0f);
+            }
+            scores[lag] = VectorOps::DotProduct(candidates + lag, coarseTemplate.data(), coarseLength) /
+                          std::sqrt(energy + 1e-9f);
+        }
+        float bestScore = scores[nominalLag];
+        for (size_t lag = 0; lag < coarseLags; lag++) {
+            if (scores[lag] > bestScore * 1.0001f + 1e-6f) {
+                bestScore = scores[lag];
+                bestLag = lag;
+            }
+        }
+
+        // Fine search around the coarse lag at full resolution
+        const size_t center = bestLag * kSearchDecimation;
+        const size_t first = center >= kSearchDecimation - 1 ? center - (kSearchDecimation - 1) : 0;
+        const size_t last = std::min(center + kSearchDecimation - 1, 2 * searchRange);
+        auto score = [this](size_t offset) {
+            const float* candidate = monoCandidates.data() + offset;
+            return VectorOps::DotProduct(candidate, monoTemplate.data(), windowLength) /
+                   std::sqrt(VectorOps::DotProduct(candidate, candidate, windowLength) + 1e-9f);
+        };
+        size_t bestOffset = center;
+        bestScore = score(center);
+        for (size_t offset = first; offset <= last; offset++) {
+            const float candidateScore = offset == center ? bestScore : score(offset);
+            if (candidateScore > bestScore * 1.0001f + 1e-6f) {
+                bestScore = candidateScore;
+                bestOffset = offset;
+            }
+        }
+        return bestOffset;
+    }
+
+    void ProcessSegment(size_t start) {
+        size_t segment = start;
+        if (hasPrevious) {
+            // Align the segment with the natural continuation of the previous one
+            const size_t candidatesStart = start - searchRange;
+            MixToMono(candidatesStart, 2 * searchRange + windowLength, monoCandidates.data());
+            MixToMono(static_cast<size_t>(previousStart) + synthesisHop, windowLength, monoTemplate.data());
+            segment = candidatesStart + FindBestOffset();
+        }
+
+        for (size_t channel = 0; channel < channels; channel++) {
+            float* frame = frames.data() + channel * windowLength;
+            VectorOps::Deinterleave(input.data() + segment * channels, static_cast<int>(channels),
+                                    static_cast<int>(channel), frame, windowLength);
+            VectorOps::MultiplyAccumulate(accumulator.data() + channel * windowLength, frame, window.data(),
+                                          windowLength);
+        }
+        previousStart = static_cast<int64_t>(segment);
+        hasPrevious = true;
+    }
+
+    void ProcessSpectrum(size_t channel, int64_t hop) {
+        float* frameRe = re.data() + channel * binCount;
+        float* frameIm = im.data() + channel * binCount;
+        float* lastPhase = previousPhase.data() + channel * binCount;
+        float* lastSynthesis = synthesisPhase.data() + channel * binCount;
+
+        for (size_t k = 0; k < binCount; k++) {
+            magnitude[k] = std::sqrt(frameRe[k] * frameRe[k] + frameIm[k] * frameIm[k]);
+            phase[k] = std::atan2(frameIm[k], frameRe[k]);
+        }
+
+        if (hop <= 0) {
+            std::copy(phase.begin(), phase.end(), newPhase.begin());
+        } else {
+            // Peaks carry their phase forward at their measured frequency
+            peaks.clear();
+            for (size_t k = 2; k + 2 < binCount; k++) {
+                const float m = magnitude[k];
+                if (m > magnitude[k - 1] && m > magnitude[k - 2] && m >= magnitude[k + 1] && m >= magnitude[k + 2]) {
+                    peaks.push_back(k);
+                }
+            }
+            if (peaks.empty()) {
+                for (size_t k = 0; k < binCount; k++) {
+                    peaks.push_back(k);
+                }
+            }
+            const float hopFrames = static_cast<float>(hop);
+            const float ratio = static_cast<float>(synthesisHop) / hopFrames;
+            for (size_t peak : peaks) {
+                const float expected = kTwoPi * peak / windowLength * hopFrames;
+                const float deviation = WrapPhase(phase[peak] - lastPhase[peak] - expected);
+                newPhase[peak] = lastSynthesis[peak] + (expected + deviation) * ratio;
+            }
+
+            // Identity phase locking: bins around a peak keep their phase relative to it
+            size_t k = 0;
+            for (size_t j = 0; j < peaks.size(); j++) {
+                const size_t peak = peaks[j];
+                const size_t regionEnd = j + 1 < peaks.size() ? (peak + peaks[j + 1]) / 2 + 1 : binCount;
+                const float offset = newPhase[peak] - phase[peak];
+                for (; k < regionEnd; k++) {
+                    if (k != peak) {
+                        newPhase[k] = phase[k] + offset;
+                    }
+                }
+            }
+        }
+
+        for (size_t k = 0; k < binCount; k++) {
+            lastPhase[k] = phase[k];
+            lastSynthesis[k] = WrapPhase(newPhase[k]);
+            frameRe[k] = magnitude[k] * std::cos(newPhase[k]);
+            frameIm[k] = magnitude[k] * std::sin(newPhase[k]);
+        }
+    }
+
+    void ProcessVocoderFrame(size_t start) {
+        const size_t length = windowLength;
+        for (size_t channel = 0; channel < channels; channel++) {
+            float* frame = frames.data() + channel * length;
+            VectorOps::Deinterleave(input.data() + start * channels, static_cast<int>(channels),
+                                    static_cast<int>(channel), frame, length);
+            VectorOps::Multiply(frame, frame, window.data(), length);
+        }
+
+        // The accelerator gets every channel's transform at once; if it declines, it is not asked again
+        bool transformed = false;
+        if (accelerator) {
+            GPU_PLAYER_TRACE_SCOPE("backend", "accelerator forward spectra");
+            transformed = accelerator->ForwardSpectra(frames.data(), length, channels, re.data(), im.data());
+        }
+        if (!transformed) {
+            accelerator = nullptr;
+            for (size_t channel = 0; channel < channels; channel++) {
+                fft->ForwardReal(frames.data() + channel * length, re.data() + channel * binCount,
+                                 im.data() + channel * binCount);
+            }
+        }
+
+        const int64_t hop = hasPrevious ? static_cast<int64_t>(start) - previousStart : 0;
+        for (size_t channel = 0; channel < channels; channel++) {
+            ProcessSpectrum(channel, hop);
+        }
+
+        transformed = false;
+        if (accelerator) {
+            GPU_PLAYER_TRACE_SCOPE("backend", "accelerator inverse spectra");
+            transformed = accelerator->InverseSpectra(re.data(), im.data(), length, channels, frames.data());
+        }
+        if (!transformed) {
+            accelerator = nullptr;
+            for (size_t channel = 0; channel < channels; channel++) {
+                fft->InverseReal(re.data() + channel * binCount, im.data() + channel * binCount,
+                                 frames.data() + channel * length);
+            }
+        }
+        for (size_t channel = 0; channel < channels; channel++) {
+            VectorOps::MultiplyAccumulate(accumulator.data() + channel * length, frames.data() + channel * length,
+                                          synthesisWindow.data(), length);
+        }
+        previousStart = static_cast<int64_t>(start);
+        hasPrevious = true;
+    }
+
+    // Move one synthesis hop from the overlap-add accumulator to the output FIFO
+    void EmitHop() {
+        const size_t dropped = std::min(skipFrames, synthesisHop);
+        const size_t count = synthesisHop - dropped;
+        skipFrames -= dropped;
+        for (size_t channel = 0; channel < channels; channel++) {
+            float* accumulated = accumulator.data() + channel * windowLength;
+            if (count > 0) {
+                VectorOps::Interleave(accumulated + dropped, static_cast<int>(channels), static_cast<int>(channel),
+                                      output.data() + outputFrames * channels, count);
+            }
+            std::memmove(accumulated, accumulated + synthesisHop, (windowLength - synthesisHop) * sizeof(float));
+            std::fill(accumulated + windowLength - synthesisHop, accumulated + windowLength, 0.0f);
+        }
+        outputFrames += count;
+    }
+
+    void ProduceHops(size_t frameCount) {
+        while (outputFrames < frameCount && GetHopEnd(position, hasPrevious, previousStart) <= inputFrames) {
+            const size_t start = static_cast<size_t>(position);
+            if (mode == Mode::Music) {
+                ProcessVocoderFrame(start);
+            } else {
+                ProcessSegment(start);
+            }
+            EmitHop();
+            position += synthesisHop * rate;
+        }
+    }
+
+    // Drop input frames no later hop reads
+    void Compact() {
+        size_t keepFrom = 0;
+        const size_t start = static_cast<size_t>(position);
+        switch (mode) {
+            case Mode::Varispeed:
+                keepFrom = start - 1;
+                break;
+            case Mode::Music:
+                keepFrom = start;
+                break;
+            case Mode::Speech:
+                keepFrom = start - searchRange;
+                if (hasPrevious) {
+                    keepFrom = std::min(keepFrom, static_cast<size_t>(previousStart) + synthesisHop);
+                }
+                break;
+        }
+        keepFrom = std::min(keepFrom, inputFrames);
+        if (keepFrom == 0) {
+            return;
+        }
+        std::memmove(input.data(), input.data() + keepFrom * channels, (inputFrames - keepFrom) * channels * sizeof(float));
+        inputFrames -= keepFrom;
+        position -= static_cast<double>(keepFrom);
+        previousStart -= static_cast<int64_t>(keepFrom);
+    }
+};
+
+TimeStretcher::TimeStretcher() : pImpl(std::make_unique<Impl>()) {}
+
+TimeStretcher::~TimeStretcher() = default;
+
+bool TimeStretcher::Prepare(int sampleRate, int channels, size_t maxBlockFrames, Mode mode,
+                            IGPUProcessor* accelerator, size_t acceleratorMinSize) {
+    if (sampleRate <= 0 || channels <= 0 || maxBlockFrames == 0) {
+        return false;
+    }
+    Impl& impl = *pImpl;
+    impl.mode = mode;
+    impl.channels = static_cast<size_t>(channels);
+    impl.maxBlock = maxBlockFrames;
+    impl.accelerator = nullptr;
+    impl.fft.reset();
+
+    size_t hops = 0;
+    switch (mode) {
+        case Mode::Varispeed:
+            impl.windowLength = 0;
+            impl.synthesisHop = 0;
+            impl.searchRange = 0;
+            impl.inputCapacity = static_cast<size_t>(kMaxRate * maxBlockFrames) + 8;
+            impl.output.assign(maxBlockFrames * impl.channels, 0.0f);
+            break;
+
+        case Mode::Speech: {
+            const size_t step = 2 * kSearchDecimation;
+            impl.windowLength = std::max<size_t>(sampleRate / kSegmentsPerSecond / step, 1) * step;
+            impl.synthesisHop = impl.windowLength / 2;
+            impl.searchRange = impl.windowLength / 2;
+            MakeHann(impl.window, impl.windowLength);
+            const size_t span = 2 * impl.searchRange + impl.windowLength;
+            impl.monoCandidates.assign(span, 0.0f);
+            impl.monoTemplate.assign(impl.windowLength, 0.0f);
+            impl.monoScratch.assign(span, 0.0f);
+            impl.coarseCandidates.assign(span / kSearchDecimation, 0.0f);
+            impl.coarseTemplate.assign(impl.windowLength / kSearchDecimation, 0.0f);
+            impl.coarseScores.assign(2 * impl.searchRange / kSearchDecimation + 1, 0.0f);
+            break;
+        }
+
+        case Mode::Music: {
+            impl.windowLength = kVocoderWindow;
+            for (int rate = 48000; rate < sampleRate; rate *= 2) {
+                impl.windowLength *= 2;
+            }
+            impl.synthesisHop = impl.windowLength / kVocoderOverlap;
+            impl.searchRange = 0;
+            MakeHann(impl.window, impl.windowLength);
+            // Hann analysis and synthesis windows at 75% overlap add up to 1.5
+            impl.synthesisWindow = impl.window;
+            VectorOps::Scale(impl.synthesisWindow.data(), 1.0f / 1.5f, impl.windowLength);
+            impl.fft = std::make_unique<FFT>(impl.windowLength);
+            impl.binCount = impl.fft->GetBinCount();
+            impl.re.assign(impl.binCount * impl.channels, 0.0f);
+            impl.im.assign(impl.binCount * impl.channels, 0.0f);
+            impl.magnitude.assign(impl.binCount, 0.0f);
+            impl.phase.assign(impl.binCount, 0.0f);
+            impl.newPhase.assign(impl.binCount, 0.0f);
+            impl.previousPhase.assign(impl.binCount * impl.channels, 0.0f);
+            impl.synthesisPhase.assign(impl.binCount * impl.channels, 0.0f);
+            impl.peaks.reserve(impl.binCount);
+            if (accelerator && impl.windowLength >= acceleratorMinSize) {
+                impl.accelerator = accelerator;
+            }
+            break;
+        }
+    }
+
+    if (mode != Mode::Varispeed) {
+        // Worst case between two reads: the window delay, a partial hop and a block, all at the fastest rate
+        hops = (maxBlockFrames + impl.windowLength) / impl.synthesisHop + 2;
+        impl.inputCapacity = static_cast<size_t>(kMaxRate * impl.synthesisHop * hops) + 2 * impl.windowLength +
+                             2 * impl.searchRange + 8;
+        impl.output.assign((maxBlockFrames + impl.synthesisHop) * impl.channels, 0.0f);
+        impl.accumulator.assign(impl.windowLength * impl.channels, 0.0f);
+        impl.frames.assign(impl.windowLength * impl.channels, 0.0f);
+    }
+    impl.input.assign(impl.inputCapacity * impl.channels, 0.0f);
+    Reset();
+    return true;
+}
+
+void TimeStretcher::SetRate(double rate) {
+    pImpl->rate = std::min(std::max(rate, kMinRate), kMaxRate);
+}
+
+double TimeStretcher::GetRate() const {
+    return pImpl->rate;
+}
+
+TimeStretcher::Mode TimeStretcher::GetMode() const {
+    return pImpl->mode;
+}
+
+size_t TimeStretcher::GetInputFramesNeeded(size_t outputFrames) const {
+    const Impl& impl = *pImpl;
+    if (outputFrames <= impl.outputFrames) {
+        return 0;
+    }
+    const size_t missing = outputFrames - impl.outputFrames;
+
+    size_t end = 0;
+    if (impl.mode == Mode::Varispeed) {
+        end = static_cast<size_t>(impl.position + (missing - 1) * impl.rate) + 3;
+    } else {
+        // Walk the hops a read would process; WSOLA segments are assumed at their latest possible frame
+        double hopPosition = impl.position;
+        size_t skip = impl.skipFrames;
+        bool previous = impl.hasPrevious;
+        int64_t previousSegment = impl.previousStart;
+        size_t produced = 0;
+        while (produced < missing) {
+            end = std::max(end, impl.GetHopEnd(hopPosition, previous, previousSegment));
+            const size_t dropped = std::min(skip, impl.synthesisHop);
+            skip -= dropped;
+            produced += impl.synthesisHop - dropped;
+            previousSegment = static_cast<int64_t>(static_cast<size_t>(hopPosition) + impl.searchRange);
+            previous = true;
+            hopPosition += impl.synthesisHop * impl.rate;
+        }
+    }
+    return end > impl.inputFrames ? std::min(end - impl.inputFrames, impl.inputCapacity - impl.inputFrames) : 0;
+}
+
+size_t TimeStretcher::GetMaxInputFrames() const {
+    return pImpl->inputCapacity;
+}
+
+void TimeStretcher::Write(const float* input, size_t frameCount) {
+    Impl& impl = *pImpl;
+    frameCount = std::min(frameCount, impl.inputCapacity - impl.inputFrames);
+    std::memcpy(impl.input.data() + impl.inputFrames * impl.channels, input, frameCount * impl.channels * sizeof(float));
+    impl.inputFrames += frameCount;
+}
+
+size_t TimeStretcher::Read(float* output, size_t frameCount) {
+    Impl& impl = *pImpl;
+    frameCount = std::min(frameCount, impl.maxBlock);
+    if (impl.outputFrames < frameCount) {
+        if (impl.mode == Mode::Varispeed) {
+            impl.ProduceInterpolated(frameCount - impl.outputFrames);
+        } else {
+            impl.ProduceHops(frameCount);
+        }
+    }
+
+    const size_t count = std::min(frameCount, impl.outputFrames);
+    const size_t samples = count * impl.channels;
+    std::memcpy(output, impl.output.data(), samples * sizeof(float));
+    std::memmove(impl.output.data(), impl.output.data() + samples, (impl.outputFrames - count) * impl.channels * sizeof(float));
+    impl.outputFrames -= count;
+    impl.Compact();
+    return count;
+}
+
+void TimeStretcher::Reset() {
+    Impl& impl = *pImpl;
+    // Silence before the first frame lets the first windows start before it
+    impl.inputFrames = impl.GetPaddingFrames();
+    std::fill_n(impl.input.begin(), impl.inputFrames * impl.channels, 0.0f);
+    impl.outputFrames = 0;
+    impl.skipFrames = impl.mode == Mode::Varispeed ? 0 : impl.windowLength - impl.synthesisHop;
+    impl.position = impl.mode == Mode::Varispeed ? 1.0 : static_cast<double>(impl.searchRange);
+    impl.hasPrevious = false;
+    impl.previousStart = 0;
+    std::fill(impl.accumulator.begin(), impl.accumulator.end(), 0.0f);
+}
+
+size_t TimeStretcher::GetWindowFrames() const {
+    return pImpl->mode == Mode::Varispeed ? 4 : pImpl->windowLength + pImpl->searchRange;
+}
+
+double TimeStretcher::GetOperationsPerFrame() const {
+    const Impl& impl = *pImpl;
+    const double length = static_cast<double>(impl.windowLength);
+    const double hop = static_cast<double>(impl.synthesisHop);
+    const double channels = static_cast<double>(impl.channels);
+    switch (impl.mode) {
+        case Mode::Speech: {
+            // Shared by all channels: channel sums, decimation, coarse and fine correlation
+            const double span = 2.0 * impl.searchRange + length;
+            const double coarseLags = 2.0 * impl.searchRange / kSearchDecimation + 1.0;
+            const double search = (span + length) * (channels + 1.0) +
+                                  coarseLags * (2.0 * length / kSearchDecimation + 6.0) +
+                                  (2.0 * kSearchDecimation - 1.0) * 4.0 * length;
+            // Per channel: gather, windowed overlap-add, output
+            return search / (hop * channels) + (3.0 * length + 2.0 * hop) / hop;
+        }
+        case Mode::Music: {
+            const double transform = 2.5 * length * std::log2(length);
+            const double bins = static_cast<double>(impl.binCount);
+            const double spectrum = bins * (4.0 * kTranscendentalCost + 16.0);
+            return (2.0 * transform + spectrum + 5.0 * length + 2.0 * hop) / hop;
+        }
+        default:
+            return 14.0;
+    }
+}
+
+std::string TimeStretcher::GetName() const {
+    const Impl& impl = *pImpl;
+    std::ostringstream name;
+    name << impl.rate << "x, ";
+    switch (impl.mode) {
+        case Mode::Speech:
+            name << "WSOLA, " << impl.windowLength << "-frame segments";
+            break;
+        case Mode::Music:
+            name << "phase vocoder, " << impl.windowLength << "-point FFT" << (impl.accelerator ? " on the GPU" : "");
+            break;
+        default:
+            name << "varispeed";
+            break;
+    }
+    return name.str();
+}
+
+bool TimeStretcher::ParseMode(const std::string& name, Mode& mode) {
+    for (Mode candidate : {Mode::Varispeed, Mode::Speech, Mode::Music}) {
+        if (name == GetModeName(candidate)) {
+            mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* TimeStretcher::GetModeName(Mode mode) {
+    switch (mode) {
+        case Mode::Speech: return "speech";
+        case Mode::Music: return "music";
+        default: return "varispeed";
+    }
+}
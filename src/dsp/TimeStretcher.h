@@ -0,0 +1,145 @@
+#ifndef TIME_STRETCHER_H
+#define TIME_STRETCHER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+class IGPUProcessor;
+
+/**
+ * @brief Streaming playback-rate change of interleaved audio, with or without pitch preservation
+ *
+ * Input is written in whatever amounts GetInputFramesNeeded asks for and
+ * output is read in blocks, so the caller controls the output block size
+ * while the input advances by rate frames per output frame. The work per
+ * output frame does not depend on the signal: every mode processes fixed-size
+ * hops, so GetOperationsPerFrame is an upper bound of the cost.
+ *
+ * The hop-based modes delay the output internally by their window, but
+ * compensate for it: the first output frame after Reset corresponds to the
+ * first input frame.
+ */
+class TimeStretcher {
+public:
+    /**
+     * @brief How the rate is changed
+     */
+    enum class Mode {
+        Varispeed,   // Cubic interpolation; pitch follows the rate like a tape machine
+        Speech,      // WSOLA: overlap-add of input segments aligned by cross-correlation; pitch preserved
+        Music        // Phase vocoder with identity phase locking; pitch preserved, no repeated transients
+    };
+
+    static constexpr double kMinRate = 0.5;
+    static constexpr double kMaxRate = 2.0;
+
+    /**
+     * @brief Constructor
+     */
+    TimeStretcher();
+
+    /**
+     * @brief Destructor
+     */
+    ~TimeStretcher();
+
+    /**
+     * @brief Allocate the buffers for a stream format and mode (control thread)
+     * @param sampleRate Sample rate in Hz
+     * @param channels Number of interleaved channels
+     * @param maxBlockFrames Largest number of frames read at once
+     * @param mode Stretching algorithm
+     * @param accelerator Optional backend for the phase vocoder's transforms
+     * @param acceleratorMinSize Smallest transform handed to the accelerator
+     * @return true if successful, false otherwise
+     */
+    bool Prepare(int sampleRate, int channels, size_t maxBlockFrames, Mode mode,
+                 IGPUProcessor* accelerator = nullptr, size_t acceleratorMinSize = 0);
+
+    /**
+     * @brief Set the playback rate (audio thread, or with the audio thread excluded)
+     * @param rate Input frames per output frame, clamped to kMinRate..kMaxRate
+     */
+    void SetRate(double rate);
+
+    /**
+     * @brief Get the playback rate
+     */
+    double GetRate() const;
+
+    /**
+     * @brief Get the stretching algorithm
+     */
+    Mode GetMode() const;
+
+    /**
+     * @brief Get how many input frames must be written before Read can return outputFrames frames
+     * @param outputFrames Frames to read, at most the maxBlockFrames given to Prepare
+     * @return Number of frames to write, at most GetMaxInputFrames()
+     */
+    size_t GetInputFramesNeeded(size_t outputFrames) const;
+
+    /**
+     * @brief Get the largest value GetInputFramesNeeded can return
+     */
+    size_t GetMaxInputFrames() const;
+
+    /**
+     * @brief Append input frames
+     * @param input Interleaved samples
+     * @param frameCount Number of frames, at most the last GetInputFramesNeeded result
+     */
+    void Write(const float* input, size_t frameCount);
+
+    /**
+     * @brief Read stretched output
+     * @param output Receives interleaved samples
+     * @param frameCount Number of frames wanted, at most the maxBlockFrames given to Prepare
+     * @return Number of frames read; less than frameCount only if too little input was written
+     */
+    size_t Read(float* output, size_t frameCount);
+
+    /**
+     * @brief Drop all buffered audio, e.g. after a seek (no allocation)
+     */
+    void Reset();
+
+    /**
+     * @brief Get the analysis window length in frames (input needed to flush the output at the end)
+     */
+    size_t GetWindowFrames() const;
+
+    /**
+     * @brief Get the upper bound of arithmetic operations per output frame and channel
+     *
+     * Counts multiplies and adds per hop, which do not depend on the rate;
+     * transcendental functions in the phase vocoder count as 20 operations.
+     */
+    double GetOperationsPerFrame() const;
+
+    /**
+     * @brief Get a description such as "1.25x, phase vocoder, 2048-point FFT"
+     */
+    std::string GetName() const;
+
+    /**
+     * @brief Parse a mode name
+     * @param name "varispeed", "speech" or "music"
+     * @param mode Receives the mode
+     * @return true if the name is known, false otherwise
+     */
+    static bool ParseMode(const std::string& name, Mode& mode);
+
+    /**
+     * @brief Get the name of a mode
+     */
+    static const char* GetModeName(Mode mode);
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // TIME_STRETCHER_H
@@ -0,0 +1,288 @@
+#include "VectorOps.h"
+#include <algorithm>
+
+#ifdef GPU_PLAYER_HAVE_SSE
+#include <xmmintrin.h>
+#endif
+
+// Implementation of vectorized DSP kernels
+
+namespace VectorOps {
+
+void ComplexMultiplyAccumulate(const float* aRe, const float* aIm,
+                               const float* bRe, const float* bIm,
+                               float* accRe, float* accIm,
+                               size_t count) {
+    size_t i = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+    for (; i + 4 <= count; i += 4) {
+        __m128 ar = _mm_loadu_ps(aRe + i);
+        __m128 ai = _mm_loadu_ps(aIm + i);
+        __m128 br = _mm_loadu_ps(bRe + i);
+        __m128 bi = _mm_loadu_ps(bIm + i);
+
+        __m128 re = _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi));
+        __m128 im = _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br));
+
+        _mm_storeu_ps(accRe + i, _mm_add_ps(_mm_loadu_ps(accRe + i), re));
+        _mm_storeu_ps(accIm + i, _mm_add_ps(_mm_loadu_ps(accIm + i), im));
+    }
+#endif
+    for (; i < count; i++) {
+        accRe[i] += aRe[i] * bRe[i] - aIm[i] * bIm[i];
+        accIm[i] += aRe[i] * bIm[i] + aIm[i] * bRe[i];
+    }
+}
+
+void Add(float* dst, const float* src, size_t count) {
+    size_t i = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] += src[i];
+    }
+}
+
+void MultiplyAdd(float* dst, const float* src, float gain, size_t count) {
+    size_t i = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+    __m128 g = _mm_set1_ps(gain);
+    for (; i + 4 <= count; i += 4) {
+        __m128 scaled = _mm_mul_ps(_mm_loadu_ps(src + i), g);
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), scaled));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+void MultiplyAddRamp(float* dst, const float* src, float startGain, float endGain, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    const float step = (endGain - startGain) / count;
+    size_t i = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+    __m128 g = _mm_add_ps(_mm_set1_ps(startGain), _mm_mul_ps(_mm_set1_ps(step), _mm_setr_ps(1.0f, 2.0f, 3.0f, 4.0f)));
+    const __m128 step4 = _mm_set1_ps(4.0f * step);
+    for (; i + 4 <= count; i += 4) {
+        __m128 scaled = _mm_mul_ps(_mm_loadu_ps(src + i), g);
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), scaled));
+        g = _mm_add_ps(g, step4);
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] += src[i] * (startGain + step * (i + 1));
+    }
+}
+
+void Scale(float* data, float gain, size_t count) {
+    size_t i = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+    __m128 g = _mm_set1_ps(gain);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), g));
+    }
+#endif
+    for (; i < count; i++) {
+        data[i] *= gain;
+    }
+}
+
+void MultiplyFrames(float* samples, const float* gains, int channels, size_t frames) {
+    if (channels == 1) {
+        size_t i = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+        for (; i + 4 <= frames; i += 4) {
+            _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), _mm_loadu_ps(gains + i)));
+        }
+#endif
+        for (; i < frames; i++) {
+            samples[i] *= gains[i];
+        }
+        return;
+    }
+
+    size_t i = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+    if (channels == 2) {
+        // Four frames per step: duplicate each gain for the left and right sample
+        for (; i + 4 <= frames; i += 4) {
+            __m128 g = _mm_loadu_ps(gains + i);
+            float* frame = samples + 2 * i;
+            _mm_storeu_ps(frame, _mm_mul_ps(_mm_loadu_ps(frame), _mm_unpacklo_ps(g, g)));
+            _mm_storeu_ps(frame + 4, _mm_mul_ps(_mm_loadu_ps(frame + 4), _mm_unpackhi_ps(g, g)));
+        }
+    }
+#endif
+    for (; i < frames; i++) {
+        float* frame = samples + i * channels;
+        for (int channel = 0; channel < channels; channel++) {
+            frame[channel] *= gains[i];
+        }
+    }
+}
+
+void FillRamp(float* dst, float firstValue, float step, size_t count) {
+    size_t i = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+    // Each value is computed from its index, so long ramps do not accumulate rounding
+    __m128 index = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 four = _mm_set1_ps(4.0f);
+    const __m128 first = _mm_set1_ps(firstValue);
+    const __m128 steps = _mm_set1_ps(step);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_add_ps(first, _mm_mul_ps(steps, index)));
+        index = _mm_add_ps(index, four);
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = firstValue + step * static_cast<float>(i);
+    }
+}
+
+void FillGeometric(float* dst, float firstValue, float ratio, size_t count) {
+    size_t i = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+    if (count >= 4) {
+        const float ratio2 = ratio * ratio;
+        __m128 value = _mm_setr_ps(firstValue, firstValue * ratio, firstValue * ratio2, firstValue * ratio2 * ratio);
+        const __m128 ratio4 = _mm_set1_ps(ratio2 * ratio2);
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(dst + i, value);
+            value = _mm_mul_ps(value, ratio4);
+        }
+    }
+#endif
+    float value = i > 0 ? dst[i - 1] * ratio : firstValue;
+    for (; i < count; i++) {
+        dst[i] = value;
+        value *= ratio;
+    }
+}
+
+void Multiply(float* dst, const float* a, const float* b, size_t count) {
+    size_t i = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = a[i] * b[i];
+    }
+}
+
+void MultiplyAccumulate(float* dst, const float* a, const float* b, size_t count) {
+    size_t i = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+    for (; i + 4 <= count; i += 4) {
+        __m128 product = _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), product));
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] += a[i] * b[i];
+    }
+}
+
+float DotProduct(const float* a, const float* b, size_t count) {
+    size_t i = 0;
+    float sum = 0.0f;
+#ifdef GPU_PLAYER_HAVE_SSE
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+    for (; i < count; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+void AccumulateRange(const float* src, size_t count, float& minimum, float& maximum, float& sumSquares) {
+    size_t i = 0;
+    float lo = minimum, hi = maximum, sum = 0.0f;
+#ifdef GPU_PLAYER_HAVE_SSE
+    if (count >= 4) {
+        __m128 vmin = _mm_set1_ps(lo);
+        __m128 vmax = _mm_set1_ps(hi);
+        __m128 acc = _mm_setzero_ps();
+        for (; i + 4 <= count; i += 4) {
+            __m128 v = _mm_loadu_ps(src + i);
+            vmin = _mm_min_ps(vmin, v);
+            vmax = _mm_max_ps(vmax, v);
+            acc = _mm_add_ps(acc, _mm_mul_ps(v, v));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, vmin);
+        lo = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+        _mm_storeu_ps(lanes, vmax);
+        hi = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+        _mm_storeu_ps(lanes, acc);
+        sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+#endif
+    for (; i < count; i++) {
+        lo = std::min(lo, src[i]);
+        hi = std::max(hi, src[i]);
+        sum += src[i] * src[i];
+    }
+    minimum = lo;
+    maximum = hi;
+    sumSquares += sum;
+}
+
+void Deinterleave(const float* interleaved, int channels, int channel, float* dst, size_t count) {
+    const float* src = interleaved + channel;
+    size_t i = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+    if (channels == 2) {
+        // Stereo is common enough to merit a shuffle: four frames per step
+        for (; i + 4 <= count; i += 4) {
+            __m128 a = _mm_loadu_ps(interleaved + 2 * i);
+            __m128 b = _mm_loadu_ps(interleaved + 2 * i + 4);
+            _mm_storeu_ps(dst + i, channel == 0 ? _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))
+                                                : _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = src[i * channels];
+    }
+}
+
+void Interleave(const float* src, int channels, int channel, float* interleaved, size_t count) {
+    float* dst = interleaved + channel;
+    for (size_t i = 0; i < count; i++) {
+        dst[i * channels] = src[i];
+    }
+}
+
+void InterleaveStereo(const float* left, const float* right, float* interleaved, size_t count) {
+    size_t i = 0;
+#ifdef GPU_PLAYER_HAVE_SSE
+    for (; i + 4 <= count; i += 4) {
+        __m128 l = _mm_loadu_ps(left + i);
+        __m128 r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(interleaved + 2 * i, _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(interleaved + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+#endif
+    for (; i < count; i++) {
+        interleaved[2 * i] = left[i];
+        interleaved[2 * i + 1] = right[i];
+    }
+}
+
+} // namespace VectorOps
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef VECTOR_OPS_H
+#define VECTOR_OPS_H
+
+#include <cstddef>
+
+// SSE is part of the x86-64 baseline (GCC/Clang define __SSE2__, MSVC defines _M_X64)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GPU_PLAYER_HAVE_SSE 1
+#endif
+
+/**
+ * @brief Small set of vectorized kernels shared by the DSP stages
+ *
+ * All functions operate on unaligned float arrays and fall back to scalar
+ * loops when SSE is not available.
+ */
+namespace VectorOps {
+
+    /**
+     * @brief Complex multiply-accumulate on split (re/im) arrays: acc += a * b
+     * @param aRe Real parts of the first operand
+     * @param aIm Imaginary parts of the first operand
+     * @param bRe Real parts of the second operand
+     * @param bIm Imaginary parts of the second operand
+     * @param accRe Real parts of the accumulator
+     * @param accIm Imaginary parts of the accumulator
+     * @param count Number of complex values
+     */
+    void ComplexMultiplyAccumulate(const float* aRe, const float* aIm,
+                                   const float* bRe, const float* bIm,
+                                   float* accRe, float* accIm,
+                                   size_t count);
+
+    /**
+     * @brief Element-wise addition: dst += src
+     */
+    void Add(float* dst, const float* src, size_t count);
+
+    /**
+     * @brief Scaled addition: dst += src * gain
+     */
+    void MultiplyAdd(float* dst, const float* src, float gain, size_t count);
+
+    /**
+     * @brief Scaled addition with a linear gain ramp: dst += src * gain, where gain
+     *        moves from startGain and reaches endGain on the last sample
+     */
+    void MultiplyAddRamp(float* dst, const float* src, float startGain, float endGain, size_t count);
+
+    /**
+     * @brief In-place scaling: data *= gain
+     */
+    void Scale(float* data, float gain, size_t count);
+
+    /**
+     * @brief Per-frame scaling of interleaved samples: samples[i * channels + c] *= gains[i]
+     */
+    void MultiplyFrames(float* samples, const float* gains, int channels, size_t frames);
+
+    /**
+     * @brief Linear sequence: dst[i] = firstValue + step * i
+     */
+    void FillRamp(float* dst, float firstValue, float step, size_t count);
+
+    /**
+     * @brief Geometric sequence: dst[i] = firstValue * ratio^i
+     */
+    void FillGeometric(float* dst, float firstValue, float ratio, size_t count);
+
+    /**
+     * @brief Element-wise product: dst[i] = a[i] * b[i] (dst may alias a or b)
+     */
+    void Multiply(float* dst, const float* a, const float* b, size_t count);
+
+    /**
+     * @brief Element-wise multiply-accumulate: dst[i] += a[i] * b[i]
+     */
+    void MultiplyAccumulate(float* dst, const float* a, const float* b, size_t count);
+
+    /**
+     * @brief Dot product: sum of a[i] * b[i]
+     */
+    float DotProduct(const float* a, const float* b, size_t count);
+
+    /**
+     * @brief Fold count samples into a running minimum, maximum and sum of squares
+     */
+    void AccumulateRange(const float* src, size_t count, float& minimum, float& maximum, float& sumSquares);
+
+    /**
+     * @brief Copy one channel out of interleaved samples: dst[i] = interleaved[i * channels + channel]
+     */
+    void Deinterleave(const float* interleaved, int channels, int channel, float* dst, size_t count);
+
+    /**
+     * @brief Copy one channel into interleaved samples: interleaved[i * channels + channel] = src[i]
+     */
+    void Interleave(const float* src, int channels, int channel, float* interleaved, size_t count);
+
+    /**
+     * @brief Interleave two channels at once: interleaved[2 * i] = left[i], interleaved[2 * i + 1] = right[i]
+     */
+    void InterleaveStereo(const float* left, const float* right, float* interleaved, size_t count);
+
+} // namespace VectorOps
+
+#endif // VECTOR_OPS_H
\ No newline at end of file
@@ -0,0 +1,278 @@
+#include "WaveformOverview.h"
+#include "VectorOps.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+// Implementation of the multi-resolution waveform overview
+
+namespace {
+
+const char kMagic[4] = {'G', 'P', 'W', 'F'};
+const uint32_t kFormatVersion = 1;
+
+// Header: magic, version, sample rate, channels, frame count, base bucket frames, level count
+const size_t kHeaderBytes = 4 + 4 + 4 + 4 + 8 + 4 + 4;
+
+const int kMaxChannels = 64;
+
+void PutLE(unsigned char* destination, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        destination[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+uint64_t GetLE(const unsigned char* source, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(source[i]) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+bool WaveformOverview::Begin(int sampleRate, int channels) {
+    if (sampleRate <= 0 || channels <= 0 || channels > kMaxChannels) {
+        return false;
+    }
+    this->sampleRate = sampleRate;
+    this->channels = channels;
+    frameCount = 0;
+    levels.clear();
+    bucketMin.assign(channels, 0.0f);
+    bucketMax.assign(channels, 0.0f);
+    bucketSquares.assign(channels, 0.0f);
+    baseMin.clear();
+    baseMax.clear();
+    baseMeanSquare.clear();
+    bucketFrames = 0;
+    scratch.resize(kBaseBucketFrames);
+    return true;
+}
+
+void WaveformOverview::Append(const float* samples, size_t frames) {
+    if (channels == 0) {
+        return;
+    }
+    while (frames > 0) {
+        if (bucketFrames == 0) {
+            std::fill(bucketMin.begin(), bucketMin.end(), 1e30f);
+            std::fill(bucketMax.begin(), bucketMax.end(), -1e30f);
+            std::fill(bucketSquares.begin(), bucketSquares.end(), 0.0f);
+        }
+        const size_t count = std::min(frames, kBaseBucketFrames - bucketFrames);
+        for (int channel = 0; channel < channels; channel++) {
+            const float* source = samples;
+            if (channels > 1) {
+                VectorOps::Deinterleave(samples, channels, channel, scratch.data(), count);
+                source = scratch.data();
+            }
+            VectorOps::AccumulateRange(source, count, bucketMin[channel], bucketMax[channel], bucketSquares[channel]);
+        }
+        bucketFrames += count;
+        frameCount += count;
+        samples += count * channels;
+        frames -= count;
+
+        if (bucketFrames == kBaseBucketFrames) {
+            for (int channel = 0; channel < channels; channel++) {
+                baseMin.push_back(bucketMin[channel]);
+                baseMax.push_back(bucketMax[channel]);
+                baseMeanSquare.push_back(bucketSquares[channel] / kBaseBucketFrames);
+            }
+            bucketFrames = 0;
+        }
+    }
+}
+
+void WaveformOverview::Finish() {
+    if (channels == 0) {
+        return;
+    }
+    if (bucketFrames > 0) {
+        for (int channel = 0; channel < channels; channel++) {
+            baseMin.push_back(bucketMin[channel]);
+            baseMax.push_back(bucketMax[channel]);
+            baseMeanSquare.push_back(bucketSquares[channel] / bucketFrames);
+        }
+        bucketFrames = 0;
+    }
+
+    // Each level pairs up the buckets of the one below; the last bucket may be partial
+    std::vector<float> minimum = std::move(baseMin);
+    std::vector<float> maximum = std::move(baseMax);
+    std::vector<float> meanSquare = std::move(baseMeanSquare);
+    levels.clear();
+    for (size_t level = 0; frameCount > 0; level++) {
+        const size_t count = GetBucketCount(level);
+        std::vector<Entry> entries(count * channels);
+        for (size_t i = 0; i < entries.size(); i++) {
+            entries[i].min = static_cast<int16_t>(std::max(std::floor(minimum[i] * 32767.0f), -32768.0f));
+            entries[i].max = static_cast<int16_t>(std::min(std::ceil(maximum[i] * 32767.0f), 32767.0f));
+            entries[i].rms = static_cast<uint16_t>(std::min(std::sqrt(meanSquare[i]) * 65535.0f + 0.5f, 65535.0f));
+        }
+        levels.push_back(std::move(entries));
+        if (count <= 1) {
+            break;
+        }
+
+        const uint64_t childFrames = static_cast<uint64_t>(kBaseBucketFrames) << level;
+        const size_t parents = GetBucketCount(level + 1);
+        for (size_t parent = 0; parent < parents; parent++) {
+            const size_t first = 2 * parent;
+            const bool pair = first + 1 < count;
+            const double firstWeight = static_cast<double>(std::min(childFrames, frameCount - first * childFrames));
+            const double secondWeight =
+                pair ? static_cast<double>(std::min(childFrames, frameCount - (first + 1) * childFrames)) : 0.0;
+            for (int channel = 0; channel < channels; channel++) {
+                const size_t a = first * channels + channel;
+                const size_t b = pair ? a + channels : a;
+                const size_t out = parent * channels + channel;
+                minimum[out] = std::min(minimum[a], minimum[b]);
+                maximum[out] = std::max(maximum[a], maximum[b]);
+                meanSquare[out] = static_cast<float>((meanSquare[a] * firstWeight + meanSquare[b] * secondWeight) /
+                                                     (firstWeight + secondWeight));
+            }
+        }
+        minimum.resize(parents * channels);
+        maximum.resize(parents * channels);
+        meanSquare.resize(parents * channels);
+    }
+}
+
+size_t WaveformOverview::GetBucketCount(size_t level) const {
+    const uint64_t bucket = static_cast<uint64_t>(kBaseBucketFrames) << level;
+    return static_cast<size_t>((frameCount + bucket - 1) / bucket);
+}
+
+size_t WaveformOverview::GetByteSize() const {
+    size_t bytes = 0;
+    for (const auto& level : levels) {
+        bytes += level.size() * sizeof(Entry);
+    }
+    return bytes;
+}
+
+bool WaveformOverview::Save(const std::string& filePath) const {
+    if (levels.empty()) {
+        return false;
+    }
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    unsigned char header[kHeaderBytes];
+    std::memcpy(header, kMagic, 4);
+    PutLE(header + 4, kFormatVersion, 4);
+    PutLE(header + 8, static_cast<uint64_t>(sampleRate), 4);
+    PutLE(header + 12, static_cast<uint64_t>(channels), 4);
+    PutLE(header + 16, frameCount, 8);
+    PutLE(header + 24, kBaseBucketFrames, 4);
+    PutLE(header + 28, levels.size(), 4);
+    file.write(reinterpret_cast<const char*>(header), kHeaderBytes);
+
+    std::vector<unsigned char> buffer;
+    for (const auto& level : levels) {
+        buffer.resize(level.size() * 6);
+        for (size_t i = 0; i < level.size(); i++) {
+            PutLE(&buffer[6 * i], static_cast<uint16_t>(level[i].min), 2);
+            PutLE(&buffer[6 * i + 2], static_cast<uint16_t>(level[i].max), 2);
+            PutLE(&buffer[6 * i + 4], level[i].rms, 2);
+        }
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    }
+    return static_cast<bool>(file);
+}
+
+bool WaveformOverview::Load(const std::string& filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    unsigned char header[kHeaderBytes];
+    if (!file || !file.read(reinterpret_cast<char*>(header), kHeaderBytes) || std::memcmp(header, kMagic, 4) != 0 ||
+        GetLE(header + 4, 4) != kFormatVersion || GetLE(header + 24, 4) != kBaseBucketFrames) {
+        return false;
+    }
+    const uint64_t rate = GetLE(header + 8, 4);
+    const uint64_t channelCount = GetLE(header + 12, 4);
+    if (rate == 0 || rate > 0x7fffffff || channelCount == 0 || channelCount > kMaxChannels) {
+        return false;
+    }
+
+    WaveformOverview loaded;
+    loaded.sampleRate = static_cast<int>(rate);
+    loaded.channels = static_cast<int>(channelCount);
+    loaded.frameCount = GetLE(header + 16, 8);
+    const uint64_t levelCount = GetLE(header + 28, 4);
+    if (loaded.frameCount == 0 || levelCount > 64) {
+        return false;
+    }
+
+    // The level sizes follow from the length, so a truncated or padded file is rejected
+    std::vector<unsigned char> buffer;
+    for (size_t level = 0; level < levelCount; level++) {
+        const size_t count = loaded.GetBucketCount(level);
+        if ((level + 1 == levelCount) != (count <= 1)) {
+            return false;
+        }
+        buffer.resize(count * loaded.channels * 6);
+        if (!file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()))) {
+            return false;
+        }
+        std::vector<Entry> entries(count * loaded.channels);
+        for (size_t i = 0; i < entries.size(); i++) {
+            entries[i].min = static_cast<int16_t>(GetLE(&buffer[6 * i], 2));
+            entries[i].max = static_cast<int16_t>(GetLE(&buffer[6 * i + 2], 2));
+            entries[i].rms = static_cast<uint16_t>(GetLE(&buffer[6 * i + 4], 2));
+        }
+        loaded.levels.push_back(std::move(entries));
+    }
+    if (loaded.levels.empty() || file.peek() != std::ifstream::traits_type::eof()) {
+        return false;
+    }
+    *this = std::move(loaded);
+    return true;
+}
+
+bool WaveformOverview::Query(uint64_t startFrame, uint64_t endFrame, size_t width,
+                             std::vector<WaveformColumn>& columns) const {
+    if (levels.empty() || endFrame <= startFrame || width == 0) {
+        return false;
+    }
+
+    // Coarsest level whose buckets are no wider than a pixel
+    const double framesPerPixel = static_cast<double>(endFrame - startFrame) / width;
+    size_t level = 0;
+    while (level + 1 < levels.size() && static_cast<double>(kBaseBucketFrames << (level + 1)) <= framesPerPixel) {
+        level++;
+    }
+    const uint64_t bucket = static_cast<uint64_t>(kBaseBucketFrames) << level;
+    const std::vector<Entry>& entries = levels[level];
+    const size_t count = entries.size() / channels;
+
+    columns.assign(width * channels, WaveformColumn());
+    for (size_t x = 0; x < width; x++) {
+        const uint64_t first = startFrame + static_cast<uint64_t>(x * framesPerPixel);
+        const uint64_t last = std::max(first + 1, startFrame + static_cast<uint64_t>((x + 1) * framesPerPixel));
+        if (first >= frameCount) {
+            break;
+        }
+        const size_t firstBucket = static_cast<size_t>(first / bucket);
+        const size_t endBucket = std::min(static_cast<size_t>((last + bucket - 1) / bucket), count);
+        for (int channel = 0; channel < channels; channel++) {
+            int minimum = 32767, maximum = -32768;
+            double squares = 0.0;
+            for (size_t i = firstBucket; i < endBucket; i++) {
+                const Entry& entry = entries[i * channels + channel];
+                minimum = std::min<int>(minimum, entry.min);
+                maximum = std::max<int>(maximum, entry.max);
+                squares += static_cast<double>(entry.rms) * entry.rms;
+            }
+            WaveformColumn& column = columns[x * channels + channel];
+            column.min = minimum / 32767.0f;
+            column.max = maximum / 32767.0f;
+            column.rms = static_cast<float>(std::sqrt(squares / (endBucket - firstBucket)) / 65535.0);
+        }
+    }
+    return true;
+}
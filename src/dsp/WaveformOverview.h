@@ -0,0 +1,124 @@
+#ifndef WAVEFORM_OVERVIEW_H
+#define WAVEFORM_OVERVIEW_H
+
+#include "AudioAnalysis.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Min/max/RMS overview of a track at every zoom level, like a mip-map
+ *
+ * Level 0 holds one entry per channel for every kBaseBucketFrames frames;
+ * each further level halves the resolution, up to a single entry for the
+ * whole track, so all levels together take about twice the size of level 0
+ * (6 bytes per entry). The overview is built in one pass over the decoded
+ * audio, can be saved to and loaded from a compact binary file, and answers
+ * Query for any time range by reading at most three entries per pixel from
+ * the level that matches the zoom.
+ */
+class WaveformOverview {
+public:
+    // Frames per entry at the finest level
+    static const size_t kBaseBucketFrames = 512;
+
+    /**
+     * @brief Start building an overview, dropping any previous one
+     * @param sampleRate Sample rate of the audio
+     * @param channels Number of interleaved channels
+     * @return true if the format is valid, false otherwise
+     */
+    bool Begin(int sampleRate, int channels);
+
+    /**
+     * @brief Add the next frames of the track
+     * @param samples Interleaved samples (1.0 = full scale)
+     * @param frameCount Number of frames
+     */
+    void Append(const float* samples, size_t frameCount);
+
+    /**
+     * @brief Complete the finest level and derive the coarser ones
+     */
+    void Finish();
+
+    /**
+     * @brief Save the overview to a file
+     * @param filePath Path of the file
+     * @return true if successful, false otherwise
+     */
+    bool Save(const std::string& filePath) const;
+
+    /**
+     * @brief Load an overview saved by Save
+     * @param filePath Path of the file
+     * @return true if the file holds a complete overview, false otherwise
+     */
+    bool Load(const std::string& filePath);
+
+    /**
+     * @brief Get min/max/RMS columns for a range of frames
+     * @param startFrame First frame of the range
+     * @param endFrame Frame after the range
+     * @param width Number of columns
+     * @param columns Receives width * channels columns, channels interleaved (past the end: silence)
+     * @return true if successful, false if nothing is built or the range is empty
+     */
+    bool Query(uint64_t startFrame, uint64_t endFrame, size_t width, std::vector<WaveformColumn>& columns) const;
+
+    /**
+     * @brief Get the sample rate of the audio
+     */
+    int GetSampleRate() const { return sampleRate; }
+
+    /**
+     * @brief Get the number of channels
+     */
+    int GetChannelCount() const { return channels; }
+
+    /**
+     * @brief Get the length of the track in frames
+     */
+    uint64_t GetFrameCount() const { return frameCount; }
+
+    /**
+     * @brief Get the number of zoom levels (0 until Finish or Load)
+     */
+    size_t GetLevelCount() const { return levels.size(); }
+
+    /**
+     * @brief Get the size of all levels in bytes (the file adds a small header)
+     */
+    size_t GetByteSize() const;
+
+private:
+    /**
+     * @brief Get the number of buckets per channel of a level
+     */
+    size_t GetBucketCount(size_t level) const;
+
+    // Quantized entry: min/max as 16-bit samples, RMS scaled to 0..65535
+    struct Entry {
+        int16_t min;
+        int16_t max;
+        uint16_t rms;
+    };
+
+    int sampleRate = 0;
+    int channels = 0;
+    uint64_t frameCount = 0;
+    std::vector<std::vector<Entry>> levels;   // Level k: one entry per channel per kBaseBucketFrames << k frames
+
+    // Finest level while building, unquantized
+    std::vector<float> bucketMin;
+    std::vector<float> bucketMax;
+    std::vector<float> bucketSquares;   // Sum of squares
+    std::vector<float> baseMin;
+    std::vector<float> baseMax;
+    std::vector<float> baseMeanSquare;
+    size_t bucketFrames = 0;            // Frames in the bucket being filled
+    std::vector<float> scratch;
+};
+
+#endif // WAVEFORM_OVERVIEW_H
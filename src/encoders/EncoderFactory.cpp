@@ -0,0 +1,56 @@
+#include "EncoderFactory.h"
+#include "OpusFileEncoder.h"
+#include "LameMP3Encoder.h"
+#include <algorithm>
+
+// Implementation of EncoderFactory
+
+static std::string GetExtension(const std::string& filePath) {
+    size_t dotPos = filePath.find_last_of('.');
+    if (dotPos == std::string::npos) {
+        return "";
+    }
+
+    std::string format = filePath.substr(dotPos + 1);
+    std::transform(format.begin(), format.end(), format.begin(),
+                   [](unsigned char c){ return std::tolower(c); });
+    return format;
+}
+
+bool EncoderFactory::IsLossyFormat(const std::string& filePath) {
+    std::string format = GetExtension(filePath);
+    return format == "opus" || format == "ogg" || format == "mp3";
+}
+
+std::unique_ptr<IAudioEncoder> EncoderFactory::CreateEncoder(const std::string& filePath) {
+    std::string format = GetExtension(filePath);
+
+#ifdef ENABLE_OPUS
+    if (format == "opus" || format == "ogg") {
+        return std::make_unique<OpusFileEncoder>();
+    }
+#endif
+#ifdef ENABLE_LAME
+    if (format == "mp3") {
+        return std::make_unique<LameMP3Encoder>();
+    }
+#endif
+
+    (void)format;
+    return nullptr;
+}
+
+std::string EncoderFactory::GetAvailableFormats() {
+    std::string formats;
+#ifdef ENABLE_OPUS
+    formats += "opus ogg ";
+#endif
+#ifdef ENABLE_LAME
+    formats += "mp3 ";
+#endif
+    if (formats.empty()) {
+        return "none";
+    }
+    formats.pop_back();
+    return formats;
+}
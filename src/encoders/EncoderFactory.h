@@ -0,0 +1,34 @@
+#ifndef ENCODER_FACTORY_H
+#define ENCODER_FACTORY_H
+
+#include <memory>
+#include <string>
+#include "IAudioEncoder.h"
+
+/**
+ * @brief Factory class for creating lossy encoders based on the output file extension
+ */
+class EncoderFactory {
+public:
+    /**
+     * @brief Check whether a path names a lossy format (.opus, .ogg, .mp3)
+     * @param filePath Output file path
+     * @return true for lossy formats, false otherwise (e.g. WAV)
+     */
+    static bool IsLossyFormat(const std::string& filePath);
+
+    /**
+     * @brief Create an encoder for the given output path
+     * @param filePath Output file path
+     * @return Unique pointer to a new IAudioEncoder instance, or nullptr if the format is unsupported in this build
+     */
+    static std::unique_ptr<IAudioEncoder> CreateEncoder(const std::string& filePath);
+
+    /**
+     * @brief List the lossy formats compiled into this build
+     * @return Space-separated extensions, or "none"
+     */
+    static std::string GetAvailableFormats();
+};
+
+#endif // ENCODER_FACTORY_H
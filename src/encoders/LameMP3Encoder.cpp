@@ -0,0 +1,152 @@
+#include "LameMP3Encoder.h"
+
+#ifdef ENABLE_LAME
+
+#include <lame/lame.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+// Implementation of the LAME MP3 encoder
+
+// Frames passed to LAME per call
+static const size_t kChunkFrames = 4096;
+
+class LameMP3Encoder::Impl {
+public:
+    lame_global_flags* lame = nullptr;
+    std::ofstream file;
+    std::vector<unsigned char> mp3Buffer;
+    int channels = 0;
+    int bitrateKbps = 0;
+    uint64_t bytesWritten = 0;
+
+    bool Emit(int bytes) {
+        if (bytes < 0) {
+            std::cout << "Error: LAME encoding failed (" << bytes << ")\n";
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(mp3Buffer.data()), bytes);
+        bytesWritten += static_cast<uint64_t>(bytes);
+        return static_cast<bool>(file);
+    }
+
+    void Release() {
+        if (lame) {
+            lame_close(lame);
+            lame = nullptr;
+        }
+    }
+};
+
+LameMP3Encoder::LameMP3Encoder() : pImpl(std::make_unique<Impl>()) {}
+
+LameMP3Encoder::~LameMP3Encoder() {
+    pImpl->Release();
+}
+
+bool LameMP3Encoder::Open(const std::string& filePath, int sampleRate, int channels, int bitrateKbps) {
+    if (channels < 1 || channels > 2) {
+        std::cout << "Error: MP3 encoding supports mono and stereo only (" << channels << " channels)\n";
+        return false;
+    }
+    if (bitrateKbps < 8 || bitrateKbps > 320) {
+        std::cout << "Error: MP3 bitrate must be between 8 and 320 kbps\n";
+        return false;
+    }
+
+    pImpl->lame = lame_init();
+    if (!pImpl->lame) {
+        std::cout << "Error: Could not create LAME encoder\n";
+        return false;
+    }
+
+    lame_set_in_samplerate(pImpl->lame, sampleRate);
+    lame_set_num_channels(pImpl->lame, channels);
+    lame_set_mode(pImpl->lame, channels == 1 ? MONO : JOINT_STEREO);
+    lame_set_brate(pImpl->lame, bitrateKbps);
+    lame_set_VBR(pImpl->lame, vbr_off);
+    lame_set_quality(pImpl->lame, 2);
+    lame_set_bWriteVbrTag(pImpl->lame, 1);
+    lame_set_write_id3tag_automatic(pImpl->lame, 0);
+    if (lame_init_params(pImpl->lame) < 0) {
+        std::cout << "Error: LAME rejected " << sampleRate << "Hz, " << channels << " channels, "
+                  << bitrateKbps << "kbps\n";
+        pImpl->Release();
+        return false;
+    }
+
+    pImpl->file.open(filePath, std::ios::binary);
+    if (!pImpl->file) {
+        std::cout << "Error: Could not open file for writing: " << filePath << "\n";
+        pImpl->Release();
+        return false;
+    }
+
+    // Worst case from lame.h: 1.25 * samples + 7200
+    pImpl->mp3Buffer.resize(kChunkFrames * 5 / 4 + 7200);
+    pImpl->channels = channels;
+    pImpl->bitrateKbps = bitrateKbps;
+    pImpl->bytesWritten = 0;
+    return true;
+}
+
+bool LameMP3Encoder::Write(const float* samples, size_t frameCount) {
+    if (!pImpl->lame) {
+        return false;
+    }
+
+    const int bufferSize = static_cast<int>(pImpl->mp3Buffer.size());
+    for (size_t offset = 0; offset < frameCount; offset += kChunkFrames) {
+        const int frames = static_cast<int>(std::min(kChunkFrames, frameCount - offset));
+        const float* chunk = samples + offset * pImpl->channels;
+        int bytes;
+        if (pImpl->channels == 1) {
+            bytes = lame_encode_buffer_ieee_float(pImpl->lame, chunk, chunk, frames,
+                                                  pImpl->mp3Buffer.data(), bufferSize);
+        } else {
+            bytes = lame_encode_buffer_interleaved_ieee_float(pImpl->lame, chunk, frames,
+                                                              pImpl->mp3Buffer.data(), bufferSize);
+        }
+        if (!pImpl->Emit(bytes)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LameMP3Encoder::Close() {
+    if (!pImpl->lame) {
+        return false;
+    }
+
+    bool success = pImpl->Emit(lame_encode_flush(pImpl->lame, pImpl->mp3Buffer.data(),
+                                                 static_cast<int>(pImpl->mp3Buffer.size())));
+
+    // Replace the placeholder first frame with the final LAME/Info tag
+    if (success) {
+        size_t tagSize = lame_get_lametag_frame(pImpl->lame, pImpl->mp3Buffer.data(), pImpl->mp3Buffer.size());
+        if (tagSize > 0 && tagSize <= pImpl->mp3Buffer.size()) {
+            pImpl->file.seekp(0);
+            pImpl->file.write(reinterpret_cast<const char*>(pImpl->mp3Buffer.data()), tagSize);
+        }
+    }
+
+    pImpl->file.close();
+    pImpl->Release();
+    return success && !pImpl->file.fail();
+}
+
+uint64_t LameMP3Encoder::GetBytesWritten() const {
+    return pImpl->bytesWritten;
+}
+
+std::string LameMP3Encoder::GetName() const {
+    std::ostringstream name;
+    name << "MP3 (LAME) " << pImpl->bitrateKbps << "kbps CBR";
+    return name.str();
+}
+
+#endif // ENABLE_LAME
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef LAME_MP3_ENCODER_H
+#define LAME_MP3_ENCODER_H
+
+#include "IAudioEncoder.h"
+#include <memory>
+
+/**
+ * @brief Constant-bitrate MP3 file encoder based on LAME (requires ENABLE_LAME)
+ *
+ * MP3 frames share the bit reservoir and filterbank state, so the stream is
+ * encoded serially. A LAME/Info tag with encoder delay and padding is written
+ * at the start of the file for gapless playback.
+ */
+class LameMP3Encoder : public IAudioEncoder {
+public:
+    /**
+     * @brief Constructor
+     */
+    LameMP3Encoder();
+
+    /**
+     * @brief Destructor
+     */
+    ~LameMP3Encoder() override;
+
+    bool Open(const std::string& filePath, int sampleRate, int channels, int bitrateKbps) override;
+    bool Write(const float* samples, size_t frameCount) override;
+    bool Close() override;
+    uint64_t GetBytesWritten() const override;
+    std::string GetName() const override;
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // LAME_MP3_ENCODER_H
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "OggWriter.h"
+#include <algorithm>
+#include <array>
+
+// Implementation of the Ogg page muxer
+
+// Pages are written once their body reaches this size
+static const size_t kTargetPageBytes = 4096;
+
+// Maximum number of lacing values in one page
+static const size_t kMaxLacing = 255;
+
+// Header type flags
+static const unsigned char kFlagBeginOfStream = 0x02;
+static const unsigned char kFlagEndOfStream = 0x04;
+
+OggWriter::OggWriter(std::ostream& output, uint32_t serialNumber)
+    : output(output), serialNumber(serialNumber) {}
+
+uint32_t OggWriter::Checksum(const unsigned char* data, size_t size) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> entries{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t value = i << 24;
+            for (int bit = 0; bit < 8; bit++) {
+                value = (value & 0x80000000u) ? (value << 1) ^ 0x04C11DB7u : (value << 1);
+            }
+            entries[i] = value;
+        }
+        return entries;
+    }();
+
+    uint32_t crc = 0;
+    for (size_t i = 0; i < size; i++) {
+        crc = (crc << 8) ^ table[((crc >> 24) ^ data[i]) & 0xFF];
+    }
+    return crc;
+}
+
+bool OggWriter::WritePacket(const unsigned char* data, size_t size, int64_t granulePosition,
+                            bool flushPage, bool endOfStream) {
+    const size_t lacingNeeded = size / 255 + 1;
+    if (lacingNeeded > kMaxLacing) {
+        return false;
+    }
+    if (lacing.size() + lacingNeeded > kMaxLacing && !WritePage(false)) {
+        return false;
+    }
+
+    for (size_t remaining = size; ; remaining -= 255) {
+        if (remaining < 255) {
+            lacing.push_back(static_cast<unsigned char>(remaining));
+            break;
+        }
+        lacing.push_back(255);
+    }
+    body.insert(body.end(), data, data + size);
+    pageGranule = granulePosition;
+
+    if (flushPage || endOfStream || body.size() >= kTargetPageBytes) {
+        return WritePage(endOfStream);
+    }
+    return true;
+}
+
+bool OggWriter::Flush() {
+    if (lacing.empty()) {
+        return true;
+    }
+    return WritePage(false);
+}
+
+bool OggWriter::WritePage(bool endOfStream) {
+    std::vector<unsigned char> page(27 + lacing.size());
+    page[0] = 'O';
+    page[1] = 'g';
+    page[2] = 'g';
+    page[3] = 'S';
+    page[4] = 0;   // Version
+    page[5] = static_cast<unsigned char>((firstPage ? kFlagBeginOfStream : 0) | (endOfStream ? kFlagEndOfStream : 0));
+
+    uint64_t granule = static_cast<uint64_t>(pageGranule);
+    for (int i = 0; i < 8; i++) {
+        page[6 + i] = static_cast<unsigned char>(granule >> (8 * i));
+    }
+    for (int i = 0; i < 4; i++) {
+        page[14 + i] = static_cast<unsigned char>(serialNumber >> (8 * i));
+        page[18 + i] = static_cast<unsigned char>(pageSequence >> (8 * i));
+        page[22 + i] = 0;   // Checksum, filled in below
+    }
+    page[26] = static_cast<unsigned char>(lacing.size());
+    std::copy(lacing.begin(), lacing.end(), page.begin() + 27);
+    page.insert(page.end(), body.begin(), body.end());
+
+    uint32_t crc = Checksum(page.data(), page.size());
+    for (int i = 0; i < 4; i++) {
+        page[22 + i] = static_cast<unsigned char>(crc >> (8 * i));
+    }
+
+    output.write(reinterpret_cast<const char*>(page.data()), page.size());
+    bytesWritten += page.size();
+    pageSequence++;
+    firstPage = false;
+    lacing.clear();
+    body.clear();
+    return static_cast<bool>(output);
+}
\ No newline at end of file
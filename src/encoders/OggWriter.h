@@ -0,0 +1,71 @@
+#ifndef OGG_WRITER_H
+#define OGG_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief Minimal Ogg page muxer for a single logical stream (RFC 3533)
+ *
+ * Packets are collected into pages of up to about 4kB; a page always ends on a
+ * packet boundary, so its granule position is that of its last packet. Packets
+ * larger than one page are not supported (Opus packets are at most 1275 bytes
+ * per frame).
+ */
+class OggWriter {
+public:
+    /**
+     * @brief Constructor
+     * @param output Destination stream (binary)
+     * @param serialNumber Bitstream serial number
+     */
+    OggWriter(std::ostream& output, uint32_t serialNumber);
+
+    /**
+     * @brief Add a packet to the stream
+     * @param data Packet data
+     * @param size Packet size in bytes (at most 65025)
+     * @param granulePosition Granule position at the end of this packet
+     * @param flushPage true to end the page after this packet (header packets)
+     * @param endOfStream true for the last packet of the stream
+     * @return true if successful, false otherwise
+     */
+    bool WritePacket(const unsigned char* data, size_t size, int64_t granulePosition,
+                     bool flushPage, bool endOfStream);
+
+    /**
+     * @brief Write out the pending page, if any
+     * @return true if successful, false otherwise
+     */
+    bool Flush();
+
+    /**
+     * @brief Get the number of bytes written so far
+     * @return Byte count
+     */
+    uint64_t GetBytesWritten() const { return bytesWritten; }
+
+    /**
+     * @brief Ogg CRC-32 (polynomial 0x04C11DB7, no reflection, zero initial value)
+     * @param data Bytes to checksum
+     * @param size Number of bytes
+     * @return Checksum
+     */
+    static uint32_t Checksum(const unsigned char* data, size_t size);
+
+private:
+    bool WritePage(bool endOfStream);
+
+    std::ostream& output;
+    uint32_t serialNumber;
+    uint32_t pageSequence = 0;
+    bool firstPage = true;
+    int64_t pageGranule = -1;
+    std::vector<unsigned char> lacing;
+    std::vector<unsigned char> body;
+    uint64_t bytesWritten = 0;
+};
+
+#endif // OGG_WRITER_H
\ No newline at end of file
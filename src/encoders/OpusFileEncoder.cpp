@@ -0,0 +1,363 @@
+#include "OpusFileEncoder.h"
+
+#ifdef ENABLE_OPUS
+
+#include "OggWriter.h"
+#include "dsp/Resampler.h"
+#include <opus/opus.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// Implementation of the parallel Ogg Opus encoder
+
+// Opus always runs at 48kHz here; granule positions are in 48kHz samples as well
+static const int kOpusRate = 48000;
+
+// 20ms frames
+static const size_t kFrameSize = 960;
+
+// Packets per parallel segment (5 seconds)
+static const size_t kSegmentPackets = 250;
+
+// Packets encoded and discarded at the start of every segment but the first
+static const size_t kPrerollPackets = 4;
+
+// Largest packet libopus can produce for one frame, with headroom
+static const int kMaxPacketBytes = 4000;
+
+class OpusFileEncoder::Impl {
+public:
+    struct Segment {
+        size_t index = 0;
+        size_t prerollPackets = 0;
+        std::vector<float> samples;   // Interleaved, whole frames
+    };
+
+    typedef std::vector<std::vector<unsigned char>> PacketList;
+
+    unsigned int threadCount = 0;
+    int channels = 0;
+    int bitrateKbps = 0;
+    int preSkip = 0;
+
+    std::ofstream file;
+    std::unique_ptr<OggWriter> ogg;
+
+    bool resampling = false;
+    PolyphaseResampler resampler;
+    std::vector<float> pending;         // 48kHz samples not yet dispatched
+    std::vector<float> previousTail;    // Pre-roll for the next segment
+    uint64_t signalFrames = 0;          // 48kHz frames of real signal
+    uint64_t packetsWritten = 0;
+    uint64_t bytesWritten = 0;          // Final file size once closed
+    size_t threadsUsed = 0;
+
+    // Worker pool
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable resultReady;
+    std::deque<Segment> queue;
+    std::map<size_t, PacketList> results;
+    size_t segmentsDispatched = 0;
+    size_t segmentsWritten = 0;
+    bool stopping = false;
+    bool failed = false;
+
+    void WorkerLoop();
+    void Dispatch(const float* body, size_t frames);
+    bool WriteCompleted(bool waitForAll, bool finalSegmentQueued);
+    bool WriteHeaders(int inputRate);
+    void StopWorkers();
+};
+
+void OpusFileEncoder::Impl::WorkerLoop() {
+    int error = OPUS_OK;
+    OpusEncoder* encoder = opus_encoder_create(kOpusRate, channels, OPUS_APPLICATION_AUDIO, &error);
+    if (error != OPUS_OK || !encoder) {
+        std::lock_guard<std::mutex> lock(mutex);
+        failed = true;
+        resultReady.notify_all();
+        return;
+    }
+    opus_encoder_ctl(encoder, OPUS_SET_BITRATE(bitrateKbps * 1000));
+    opus_encoder_ctl(encoder, OPUS_SET_VBR(1));
+    opus_encoder_ctl(encoder, OPUS_SET_COMPLEXITY(10));
+    opus_encoder_ctl(encoder, OPUS_SET_SIGNAL(OPUS_SIGNAL_MUSIC));
+
+    unsigned char packet[kMaxPacketBytes];
+    for (;;) {
+        Segment segment;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                break;
+            }
+            segment = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        opus_encoder_ctl(encoder, OPUS_RESET_STATE);
+        PacketList packets;
+        bool ok = true;
+        const size_t frameCount = segment.samples.size() / (channels * kFrameSize);
+        for (size_t f = 0; f < frameCount && ok; f++) {
+            // The first kept packet must not depend on state the decoder never saw
+            bool independent = segment.prerollPackets > 0 && f == segment.prerollPackets;
+            if (independent) {
+                opus_encoder_ctl(encoder, OPUS_SET_PREDICTION_DISABLED(1));
+            }
+            int bytes = opus_encode_float(encoder, &segment.samples[f * kFrameSize * channels],
+                                          static_cast<int>(kFrameSize), packet, kMaxPacketBytes);
+            if (independent) {
+                opus_encoder_ctl(encoder, OPUS_SET_PREDICTION_DISABLED(0));
+            }
+            if (bytes < 0) {
+                ok = false;
+            } else if (f >= segment.prerollPackets) {
+                packets.emplace_back(packet, packet + bytes);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!ok) {
+            failed = true;
+        }
+        results[segment.index] = std::move(packets);
+        resultReady.notify_all();
+    }
+
+    opus_encoder_destroy(encoder);
+}
+
+void OpusFileEncoder::Impl::Dispatch(const float* body, size_t frames) {
+    Segment segment;
+    segment.index = segmentsDispatched++;
+    segment.prerollPackets = previousTail.empty() ? 0 : kPrerollPackets;
+    segment.samples.reserve(previousTail.size() + frames * channels);
+    segment.samples.insert(segment.samples.end(), previousTail.begin(), previousTail.end());
+    segment.samples.insert(segment.samples.end(), body, body + frames * channels);
+
+    const size_t tailSamples = kPrerollPackets * kFrameSize * channels;
+    if (segment.samples.size() >= tailSamples) {
+        previousTail.assign(segment.samples.end() - tailSamples, segment.samples.end());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.push_back(std::move(segment));
+    workAvailable.notify_one();
+}
+
+bool OpusFileEncoder::Impl::WriteCompleted(bool waitForAll, bool finalSegmentQueued) {
+    // Keep at most two segments per thread in flight so memory stays bounded
+    const size_t maxInFlight = 2 * std::max<size_t>(workers.size(), 1);
+
+    for (;;) {
+        PacketList packets;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (failed) {
+                return false;
+            }
+            auto next = results.find(segmentsWritten);
+            if (next == results.end()) {
+                bool mustWait = waitForAll ? (segmentsWritten < segmentsDispatched)
+                                           : (segmentsDispatched - segmentsWritten >= maxInFlight);
+                if (!mustWait) {
+                    return true;
+                }
+                resultReady.wait(lock);
+                continue;
+            }
+            packets = std::move(next->second);
+            results.erase(next);
+        }
+
+        const bool lastSegment = finalSegmentQueued && segmentsWritten + 1 == segmentsDispatched;
+        for (size_t i = 0; i < packets.size(); i++) {
+            bool endOfStream = lastSegment && i + 1 == packets.size();
+            packetsWritten++;
+            int64_t granule = endOfStream ? static_cast<int64_t>(preSkip + signalFrames)
+                                          : static_cast<int64_t>(packetsWritten * kFrameSize);
+            if (!ogg->WritePacket(packets[i].data(), packets[i].size(), granule, false, endOfStream)) {
+                return false;
+            }
+        }
+        segmentsWritten++;
+    }
+}
+
+bool OpusFileEncoder::Impl::WriteHeaders(int inputRate) {
+    // Identification header (RFC 7845 section 5.1), channel mapping family 0
+    unsigned char head[19] = {'O', 'p', 'u', 's', 'H', 'e', 'a', 'd'};
+    head[8] = 1;
+    head[9] = static_cast<unsigned char>(channels);
+    head[10] = static_cast<unsigned char>(preSkip & 0xFF);
+    head[11] = static_cast<unsigned char>(preSkip >> 8);
+    for (int i = 0; i < 4; i++) {
+        head[12 + i] = static_cast<unsigned char>(static_cast<uint32_t>(inputRate) >> (8 * i));
+    }
+    head[16] = 0;   // Output gain
+    head[17] = 0;
+    head[18] = 0;   // Mapping family
+
+    // Comment header with the libopus version as vendor string
+    std::string vendor = opus_get_version_string();
+    std::vector<unsigned char> tags = {'O', 'p', 'u', 's', 'T', 'a', 'g', 's'};
+    uint32_t vendorLength = static_cast<uint32_t>(vendor.size());
+    for (int i = 0; i < 4; i++) {
+        tags.push_back(static_cast<unsigned char>(vendorLength >> (8 * i)));
+    }
+    tags.insert(tags.end(), vendor.begin(), vendor.end());
+    tags.insert(tags.end(), 4, 0);   // No user comments
+
+    return ogg->WritePacket(head, sizeof(head), 0, true, false) &&
+           ogg->WritePacket(tags.data(), tags.size(), 0, true, false);
+}
+
+void OpusFileEncoder::Impl::StopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+}
+
+OpusFileEncoder::OpusFileEncoder(unsigned int threadCount) : pImpl(std::make_unique<Impl>()) {
+    pImpl->threadCount = threadCount;
+}
+
+OpusFileEncoder::~OpusFileEncoder() {
+    pImpl->StopWorkers();
+}
+
+bool OpusFileEncoder::Open(const std::string& filePath, int sampleRate, int channels, int bitrateKbps) {
+    if (channels < 1 || channels > 2) {
+        std::cout << "Error: Opus encoding supports mono and stereo only (" << channels << " channels)\n";
+        return false;
+    }
+    if (bitrateKbps < 6 || bitrateKbps > 510) {
+        std::cout << "Error: Opus bitrate must be between 6 and 510 kbps\n";
+        return false;
+    }
+
+    pImpl->channels = channels;
+    pImpl->bitrateKbps = bitrateKbps;
+    pImpl->resampling = (sampleRate != kOpusRate);
+    if (pImpl->resampling && !pImpl->resampler.Initialize(sampleRate, kOpusRate, channels)) {
+        std::cout << "Error: Cannot resample " << sampleRate << "Hz to 48kHz for Opus\n";
+        return false;
+    }
+
+    // The encoder lookahead becomes the pre-skip the decoder drops
+    int error = OPUS_OK;
+    OpusEncoder* probe = opus_encoder_create(kOpusRate, channels, OPUS_APPLICATION_AUDIO, &error);
+    if (error != OPUS_OK || !probe) {
+        std::cout << "Error: Could not create Opus encoder: " << opus_strerror(error) << "\n";
+        return false;
+    }
+    opus_int32 lookahead = 0;
+    opus_encoder_ctl(probe, OPUS_GET_LOOKAHEAD(&lookahead));
+    opus_encoder_destroy(probe);
+    pImpl->preSkip = lookahead;
+
+    pImpl->file.open(filePath, std::ios::binary);
+    if (!pImpl->file) {
+        std::cout << "Error: Could not open file for writing: " << filePath << "\n";
+        return false;
+    }
+    pImpl->ogg = std::make_unique<OggWriter>(pImpl->file, std::random_device()());
+    if (!pImpl->WriteHeaders(sampleRate)) {
+        return false;
+    }
+
+    unsigned int threads = pImpl->threadCount;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    pImpl->stopping = false;
+    pImpl->threadsUsed = threads;
+    for (unsigned int i = 0; i < threads; i++) {
+        pImpl->workers.emplace_back(&Impl::WorkerLoop, pImpl.get());
+    }
+    return true;
+}
+
+bool OpusFileEncoder::Write(const float* samples, size_t frameCount) {
+    if (!pImpl->ogg) {
+        return false;
+    }
+
+    if (pImpl->resampling) {
+        pImpl->signalFrames += pImpl->resampler.Process(samples, frameCount, pImpl->pending);
+    } else {
+        pImpl->pending.insert(pImpl->pending.end(), samples, samples + frameCount * pImpl->channels);
+        pImpl->signalFrames += frameCount;
+    }
+
+    const size_t segmentSamples = kSegmentPackets * kFrameSize * pImpl->channels;
+    size_t consumed = 0;
+    while (pImpl->pending.size() - consumed >= segmentSamples) {
+        pImpl->Dispatch(&pImpl->pending[consumed], kSegmentPackets * kFrameSize);
+        consumed += segmentSamples;
+        if (!pImpl->WriteCompleted(false, false)) {
+            return false;
+        }
+    }
+    pImpl->pending.erase(pImpl->pending.begin(), pImpl->pending.begin() + consumed);
+    return true;
+}
+
+bool OpusFileEncoder::Close() {
+    if (!pImpl->ogg) {
+        return false;
+    }
+
+    if (pImpl->resampling) {
+        pImpl->signalFrames += pImpl->resampler.Flush(pImpl->pending);
+    }
+
+    // Pad with silence until the packets cover the pre-skip plus the whole signal
+    const uint64_t dispatchedFrames = static_cast<uint64_t>(pImpl->segmentsDispatched) * kSegmentPackets * kFrameSize;
+    const uint64_t totalPackets = (pImpl->preSkip + pImpl->signalFrames + kFrameSize - 1) / kFrameSize;
+    const size_t finalFrames = static_cast<size_t>(totalPackets * kFrameSize - dispatchedFrames);
+    pImpl->pending.resize(finalFrames * pImpl->channels, 0.0f);
+    pImpl->Dispatch(pImpl->pending.data(), finalFrames);
+    pImpl->pending.clear();
+
+    bool success = pImpl->WriteCompleted(true, true) && pImpl->ogg->Flush();
+    pImpl->StopWorkers();
+    pImpl->bytesWritten = pImpl->ogg->GetBytesWritten();
+    pImpl->file.close();
+    pImpl->ogg.reset();
+    return success && !pImpl->file.fail();
+}
+
+uint64_t OpusFileEncoder::GetBytesWritten() const {
+    return pImpl->ogg ? pImpl->ogg->GetBytesWritten() : pImpl->bytesWritten;
+}
+
+std::string OpusFileEncoder::GetName() const {
+    std::ostringstream name;
+    name << "Opus " << pImpl->bitrateKbps << "kbps VBR (" << pImpl->threadsUsed << " threads)";
+    return name.str();
+}
+
+#endif // ENABLE_OPUS
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef OPUS_FILE_ENCODER_H
+#define OPUS_FILE_ENCODER_H
+
+#include "IAudioEncoder.h"
+#include <memory>
+
+/**
+ * @brief Ogg Opus file encoder (requires ENABLE_OPUS)
+ *
+ * Input at rates Opus does not support natively is resampled to 48kHz. The
+ * stream is cut into segments of a few seconds that are encoded in parallel by
+ * a pool of libopus encoders. Each segment encoder first runs over the tail of
+ * the previous segment (pre-roll) so its state matches a continuous encode, and
+ * the first kept packet is coded without inter-frame prediction so it decodes
+ * cleanly after the previous segment's packets. Packets are muxed in order.
+ */
+class OpusFileEncoder : public IAudioEncoder {
+public:
+    /**
+     * @brief Constructor
+     * @param threadCount Number of encoding threads (0 = one per hardware thread)
+     */
+    explicit OpusFileEncoder(unsigned int threadCount = 0);
+
+    /**
+     * @brief Destructor
+     */
+    ~OpusFileEncoder() override;
+
+    bool Open(const std::string& filePath, int sampleRate, int channels, int bitrateKbps) override;
+    bool Write(const float* samples, size_t frameCount) override;
+    bool Close() override;
+    uint64_t GetBytesWritten() const override;
+    std::string GetName() const override;
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // OPUS_FILE_ENCODER_H
\ No newline at end of file
@@ -0,0 +1,515 @@
+#include "BackendAutotuner.h"
+#include "GPUProcessorFactory.h"
+#include "core/CacheDirectory.h"
+#include "dsp/PartitionedConvolver.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+// Implementation of the backend autotuner
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// An accelerator must be this much faster than the CPU to be chosen
+const double kAcceleratorMargin = 0.9;
+
+// Bump when the benchmark changes so old results are not reused
+const char* kFormatVersion = "autotune-v1";
+
+// Convolution segments are measured with this many partitions, as in the non-uniform plans
+const size_t kPartitionsPerSegment = 3;
+
+const IGPUProcessor::Backend kAllBackends[] = {
+    IGPUProcessor::Backend::CUDA,
+    IGPUProcessor::Backend::OPENCL,
+    IGPUProcessor::Backend::VULKAN,
+    IGPUProcessor::Backend::CPU
+};
+
+const BackendAutotuner::Operation kAllOperations[] = {
+    BackendAutotuner::Operation::Copy,
+    BackendAutotuner::Operation::Gain,
+    BackendAutotuner::Operation::BiquadCascade,
+    BackendAutotuner::Operation::Convolution
+};
+
+double MicrosecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+double Median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+std::vector<float> RandomSignal(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    std::vector<float> signal(count);
+    for (auto& sample : signal) {
+        sample = dist(rng);
+    }
+    return signal;
+}
+
+} // namespace
+
+class BackendAutotuner::Impl {
+public:
+    struct Candidate {
+        IGPUProcessor::Backend backend;
+        std::unique_ptr<IGPUProcessor> processor;   // nullptr for the inline CPU path
+        std::string description;
+    };
+
+    Options options;
+    std::vector<Measurement> measurements;
+    bool loadedFromCache = false;
+
+    const Measurement* Find(IGPUProcessor::Backend backend, Operation operation, size_t frames) const {
+        for (const auto& measurement : measurements) {
+            if (measurement.backend == backend && measurement.operation == operation && measurement.frames == frames) {
+                return &measurement;
+            }
+        }
+        return nullptr;
+    }
+
+    std::vector<size_t> MeasuredSizes(Operation operation) const {
+        std::vector<size_t> sizes;
+        for (const auto& measurement : measurements) {
+            if (measurement.operation == operation &&
+                std::find(sizes.begin(), sizes.end(), measurement.frames) == sizes.end()) {
+                sizes.push_back(measurement.frames);
+            }
+        }
+        std::sort(sizes.begin(), sizes.end());
+        return sizes;
+    }
+
+    // Time used for comparisons; accelerators carry the margin
+    static double Cost(const Measurement& measurement, Workload workload) {
+        double time = workload == Workload::Realtime ? measurement.realtimeMicroseconds : measurement.batchMicroseconds;
+        return measurement.backend == IGPUProcessor::Backend::CPU ? time : time / kAcceleratorMargin;
+    }
+
+    IGPUProcessor::Backend ChooseAt(Operation operation, size_t frames, Workload workload) const {
+        IGPUProcessor::Backend best = IGPUProcessor::Backend::CPU;
+        double bestCost = 0.0;
+        bool found = false;
+        for (IGPUProcessor::Backend backend : kAllBackends) {
+            const Measurement* measurement = Find(backend, operation, frames);
+            if (!measurement) {
+                continue;
+            }
+            double cost = Cost(*measurement, workload);
+            // Ties resolve to the CPU
+            if (!found || cost < bestCost || (cost == bestCost && backend == IGPUProcessor::Backend::CPU)) {
+                best = backend;
+                bestCost = cost;
+                found = true;
+            }
+        }
+        return best;
+    }
+
+    std::vector<Candidate> CreateCandidates() const {
+        std::vector<IGPUProcessor::Backend> backends = options.backends;
+        if (backends.empty()) {
+            backends = GPUProcessorFactory::GetSupportedBackends();
+        }
+
+        std::vector<Candidate> candidates;
+        for (IGPUProcessor::Backend backend : backends) {
+            Candidate candidate;
+            candidate.backend = backend;
+            if (backend == IGPUProcessor::Backend::CPU) {
+                candidate.description = "CPU inline";
+            } else {
+                candidate.processor = GPUProcessorFactory::CreateProcessor(backend);
+                if (!candidate.processor || !candidate.processor->Initialize(backend)) {
+                    continue;
+                }
+                // The first line of the description names the device
+                std::string info = candidate.processor->GetGPUInfo();
+                candidate.description = info.substr(0, info.find('\n'));
+            }
+            candidates.push_back(std::move(candidate));
+        }
+
+        // The CPU is the baseline of every comparison
+        bool hasCPU = std::any_of(candidates.begin(), candidates.end(),
+                                  [](const Candidate& c) { return c.backend == IGPUProcessor::Backend::CPU; });
+        if (!hasCPU) {
+            Candidate cpu;
+            cpu.backend = IGPUProcessor::Backend::CPU;
+            cpu.description = "CPU inline";
+            candidates.push_back(std::move(cpu));
+        }
+        return candidates;
+    }
+
+    std::string CachePath(const std::vector<Candidate>& candidates) const {
+        std::string directory = CacheDirectory::Get("autotune");
+        if (directory.empty()) {
+            return "";
+        }
+        std::ostringstream signature;
+        signature << kFormatVersion << "|channels=" << options.channels << "|stages=" << options.biquadStages
+                  << "|runs=" << options.realtimeRuns << "|jobs=" << options.batchJobs << "|depth=" << options.batchDepth
+                  << "|limit=" << options.maxBlockMicroseconds << "|blocks=";
+        for (size_t frames : options.blockFrames) signature << frames << ",";
+        signature << "|partitions=";
+        for (size_t frames : options.convolutionPartitions) signature << frames << ",";
+        for (const auto& candidate : candidates) {
+            signature << "|" << GetBackendName(candidate.backend) << "=" << candidate.description;
+        }
+        return directory + "/" + CacheDirectory::HashKey(signature.str()) + ".txt";
+    }
+
+    bool Load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            return false;
+        }
+        std::vector<Measurement> loaded;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream fields(line);
+            std::string backendName, operationName;
+            Measurement measurement;
+            if (!(fields >> backendName >> operationName >> measurement.frames
+                         >> measurement.realtimeMicroseconds >> measurement.batchMicroseconds)) {
+                return false;
+            }
+            bool known = false;
+            for (IGPUProcessor::Backend backend : kAllBackends) {
+                if (GetBackendName(backend) == backendName) {
+                    measurement.backend = backend;
+                    known = true;
+                }
+            }
+            bool knownOperation = false;
+            for (Operation operation : kAllOperations) {
+                if (GetOperationName(operation) == operationName) {
+                    measurement.operation = operation;
+                    knownOperation = true;
+                }
+            }
+            if (!known || !knownOperation) {
+                return false;
+            }
+            loaded.push_back(measurement);
+        }
+        if (loaded.empty()) {
+            return false;
+        }
+        measurements = loaded;
+        return true;
+    }
+
+    void Save(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file) {
+            std::cout << "Warning: Could not save autotuning results to " << path << "\n";
+            return;
+        }
+        file << "# backend operation frames realtime_us batch_us\n";
+        for (const auto& measurement : measurements) {
+            file << GetBackendName(measurement.backend) << " " << GetOperationName(measurement.operation) << " "
+                 << measurement.frames << " " << measurement.realtimeMicroseconds << " "
+                 << measurement.batchMicroseconds << "\n";
+        }
+    }
+
+    // Realtime and batch timings of one job operation on one backend
+    bool MeasureJob(Candidate& candidate, Operation operation, size_t frames, Measurement& measurement) {
+        const size_t samples = frames * options.channels;
+        std::vector<float> input = RandomSignal(samples, static_cast<unsigned>(frames));
+        std::vector<std::vector<float>> outputs(std::max<size_t>(options.batchDepth, 1), std::vector<float>(samples));
+        std::vector<BiquadCoefficients> biquads(options.biquadStages);
+        for (auto& biquad : biquads) {
+            // Gentle low-pass, stable for any stage count
+            biquad.b0 = 0.2f; biquad.b1 = 0.4f; biquad.b2 = 0.2f;
+            biquad.a1 = -0.6f; biquad.a2 = 0.2f;
+        }
+        std::vector<BiquadState> state(options.biquadStages * options.channels);
+
+        GPUJobDesc job;
+        job.operation = operation == Operation::Gain ? GPUOperation::Gain :
+                        operation == Operation::BiquadCascade ? GPUOperation::BiquadCascade : GPUOperation::Copy;
+        job.input = ConstAudioBufferView(input.data(), frames, options.channels);
+        job.gain = 0.5f;
+        job.biquads = biquads.data();
+        job.biquadCount = biquads.size();
+        job.biquadState = state.data();
+
+        IGPUProcessor* processor = candidate.processor.get();
+        auto runOne = [&](std::vector<float>& output) {
+            job.output = AudioBufferView(output.data(), frames, options.channels);
+            if (!processor) {
+                return GPUJobs::ExecuteReference(job);
+            }
+            return processor->SubmitJob(job).get().success;
+        };
+
+        // Warm up caches, allocations and lazily built device resources
+        if (processor) {
+            processor->SetMaxJobsInFlight(1);
+        }
+        if (!runOne(outputs[0]) || !runOne(outputs[0])) {
+            return false;
+        }
+
+        std::vector<double> latencies;
+        for (size_t run = 0; run < options.realtimeRuns; run++) {
+            auto start = Clock::now();
+            if (!runOne(outputs[0])) {
+                return false;
+            }
+            latencies.push_back(MicrosecondsSince(start));
+        }
+        measurement.realtimeMicroseconds = Median(latencies);
+
+        bool success = true;
+        auto start = Clock::now();
+        if (processor) {
+            processor->SetMaxJobsInFlight(options.batchDepth);
+            std::vector<GPUJobFuture> futures;
+            for (size_t j = 0; j < options.batchJobs; j++) {
+                job.output = AudioBufferView(outputs[j % outputs.size()].data(), frames, options.channels);
+                futures.push_back(processor->SubmitJob(job));
+            }
+            processor->WaitIdle();
+            for (auto& future : futures) {
+                success &= future.get().success;
+            }
+        } else {
+            for (size_t j = 0; j < options.batchJobs; j++) {
+                success &= runOne(outputs[j % outputs.size()]);
+            }
+        }
+        measurement.batchMicroseconds = MicrosecondsSince(start) / std::max<size_t>(options.batchJobs, 1);
+        return success;
+    }
+
+    // Per-partition cost of one convolution segment, on the CPU engine or the backend's kernel
+    bool MeasureConvolution(Candidate& candidate, size_t partition, Measurement& measurement) {
+        const size_t taps = partition * kPartitionsPerSegment;
+        std::vector<float> impulseResponse = RandomSignal(taps, 7);
+        std::vector<float> input = RandomSignal(partition, 8);
+        std::vector<float> output(partition);
+        const size_t runs = std::max<size_t>(options.realtimeRuns, 1);
+
+        std::vector<double> times;
+        IGPUProcessor* processor = candidate.processor.get();
+        if (!processor) {
+            PartitionedConvolver convolver;
+            if (!convolver.Initialize(impulseResponse.data(), taps, partition,
+                                      PartitionedConvolver::PlanUniform(taps, partition))) {
+                return false;
+            }
+            convolver.Process(input.data(), output.data());
+            for (size_t run = 0; run < runs; run++) {
+                auto start = Clock::now();
+                convolver.Process(input.data(), output.data());
+                times.push_back(MicrosecondsSince(start));
+            }
+        } else {
+            int kernelId = -1;
+            if (!processor->CreateConvolutionKernel(impulseResponse.data(), taps, partition, kernelId)) {
+                return false;   // The backend keeps convolution on the CPU
+            }
+            bool success = processor->ProcessConvolution(kernelId, input.data(), output.data(), partition);
+            for (size_t run = 0; success && run < runs; run++) {
+                auto start = Clock::now();
+                success = processor->ProcessConvolution(kernelId, input.data(), output.data(), partition);
+                times.push_back(MicrosecondsSince(start));
+                if (times.back() > options.maxBlockMicroseconds) {
+                    break;   // Enough to know it is too slow
+                }
+            }
+            processor->ReleaseConvolutionKernel(kernelId);
+            if (!success) {
+                return false;
+            }
+        }
+
+        // Convolution calls are synchronous, so batch cost is the mean of the same runs
+        measurement.realtimeMicroseconds = Median(times);
+        double total = 0.0;
+        for (double time : times) {
+            total += time;
+        }
+        measurement.batchMicroseconds = total / times.size();
+        return true;
+    }
+
+    void MeasureAll(std::vector<Candidate>& candidates) {
+        measurements.clear();
+        std::vector<size_t> blockFrames = options.blockFrames;
+        std::vector<size_t> partitions = options.convolutionPartitions;
+        std::sort(blockFrames.begin(), blockFrames.end());
+        std::sort(partitions.begin(), partitions.end());
+
+        for (auto& candidate : candidates) {
+            std::cout << "Autotuning " << candidate.description << "...\n";
+            for (Operation operation : kAllOperations) {
+                const std::vector<size_t>& sizes = operation == Operation::Convolution ? partitions : blockFrames;
+                for (size_t frames : sizes) {
+                    Measurement measurement;
+                    measurement.backend = candidate.backend;
+                    measurement.operation = operation;
+                    measurement.frames = frames;
+                    bool measured = operation == Operation::Convolution
+                                        ? MeasureConvolution(candidate, frames, measurement)
+                                        : MeasureJob(candidate, operation, frames, measurement);
+                    if (!measured) {
+                        break;
+                    }
+                    measurements.push_back(measurement);
+                    // Larger blocks only get slower; skip them once a block is over the limit
+                    if (measurement.realtimeMicroseconds > options.maxBlockMicroseconds) {
+                        break;
+                    }
+                }
+            }
+        }
+    }
+};
+
+BackendAutotuner::BackendAutotuner() : BackendAutotuner(Options()) {
+}
+
+BackendAutotuner::BackendAutotuner(const Options& options) : pImpl(std::make_unique<Impl>()) {
+    pImpl->options = options;
+    pImpl->options.channels = std::max(options.channels, 1);
+    pImpl->options.batchDepth = std::max<size_t>(options.batchDepth, 1);
+}
+
+BackendAutotuner::~BackendAutotuner() = default;
+
+bool BackendAutotuner::Tune(bool remeasure) {
+    std::vector<Impl::Candidate> candidates = pImpl->CreateCandidates();
+    std::string path = pImpl->options.persist ? pImpl->CachePath(candidates) : "";
+
+    pImpl->loadedFromCache = false;
+    if (!remeasure && !path.empty() && pImpl->Load(path)) {
+        pImpl->loadedFromCache = true;
+        return true;
+    }
+
+    pImpl->MeasureAll(candidates);
+    if (pImpl->measurements.empty()) {
+        std::cout << "Error: Autotuning produced no measurements\n";
+        return false;
+    }
+    if (!path.empty()) {
+        pImpl->Save(path);
+    }
+    return true;
+}
+
+IGPUProcessor::Backend BackendAutotuner::Choose(Operation operation, size_t frames, Workload workload) const {
+    std::vector<size_t> sizes = pImpl->MeasuredSizes(operation);
+    if (sizes.empty()) {
+        return IGPUProcessor::Backend::CPU;
+    }
+    auto size = std::lower_bound(sizes.begin(), sizes.end(), frames);
+    return pImpl->ChooseAt(operation, size == sizes.end() ? sizes.back() : *size, workload);
+}
+
+IGPUProcessor::Backend BackendAutotuner::ChooseDefault() const {
+    std::vector<size_t> sizes = pImpl->MeasuredSizes(Operation::BiquadCascade);
+    if (sizes.empty()) {
+        return IGPUProcessor::Backend::CPU;
+    }
+    return pImpl->ChooseAt(Operation::BiquadCascade, sizes.back(), Workload::Batch);
+}
+
+size_t BackendAutotuner::GetConvolutionOffloadSize(IGPUProcessor::Backend backend) const {
+    // Offloading applies to every partition from the threshold up, so the
+    // backend has to win at each measured size above it
+    size_t offloadSize = std::numeric_limits<size_t>::max();
+    std::vector<size_t> sizes = pImpl->MeasuredSizes(Operation::Convolution);
+    for (auto it = sizes.rbegin(); it != sizes.rend(); ++it) {
+        const Measurement* accelerated = pImpl->Find(backend, Operation::Convolution, *it);
+        const Measurement* cpu = pImpl->Find(IGPUProcessor::Backend::CPU, Operation::Convolution, *it);
+        if (backend == IGPUProcessor::Backend::CPU || !accelerated || !cpu ||
+            Impl::Cost(*accelerated, Workload::Batch) >= Impl::Cost(*cpu, Workload::Batch)) {
+            break;
+        }
+        offloadSize = *it;
+    }
+    return offloadSize;
+}
+
+const std::vector<BackendAutotuner::Measurement>& BackendAutotuner::GetMeasurements() const {
+    return pImpl->measurements;
+}
+
+void BackendAutotuner::SetMeasurements(const std::vector<Measurement>& measurements) {
+    pImpl->measurements = measurements;
+    pImpl->loadedFromCache = false;
+}
+
+bool BackendAutotuner::LoadedFromCache() const {
+    return pImpl->loadedFromCache;
+}
+
+std::string BackendAutotuner::GetReport() const {
+    std::ostringstream report;
+    report << "Backend autotuning" << (pImpl->loadedFromCache ? " (cached)" : "")
+           << ", microseconds per block (realtime / batch):\n";
+    report << std::fixed << std::setprecision(1);
+    for (Operation operation : kAllOperations) {
+        for (size_t frames : pImpl->MeasuredSizes(operation)) {
+            report << "  " << std::left << std::setw(12) << GetOperationName(operation)
+                   << std::right << std::setw(6) << frames << ":";
+            for (IGPUProcessor::Backend backend : kAllBackends) {
+                const Measurement* measurement = pImpl->Find(backend, operation, frames);
+                if (measurement) {
+                    report << "  " << GetBackendName(backend) << " " << measurement->realtimeMicroseconds
+                           << " / " << measurement->batchMicroseconds;
+                }
+            }
+            report << "  -> realtime " << GetBackendName(pImpl->ChooseAt(operation, frames, Workload::Realtime))
+                   << ", batch " << GetBackendName(pImpl->ChooseAt(operation, frames, Workload::Batch)) << "\n";
+        }
+    }
+    report << "Engine backend: " << GetBackendName(ChooseDefault());
+    return report.str();
+}
+
+std::string BackendAutotuner::GetBackendName(IGPUProcessor::Backend backend) {
+    switch (backend) {
+        case IGPUProcessor::Backend::CUDA: return "CUDA";
+        case IGPUProcessor::Backend::OPENCL: return "OpenCL";
+        case IGPUProcessor::Backend::VULKAN: return "Vulkan";
+        case IGPUProcessor::Backend::CPU: return "CPU";
+    }
+    return "Unknown";
+}
+
+std::string BackendAutotuner::GetOperationName(Operation operation) {
+    switch (operation) {
+        case Operation::Copy: return "copy";
+        case Operation::Gain: return "gain";
+        case Operation::BiquadCascade: return "biquad";
+        case Operation::Convolution: return "convolution";
+    }
+    return "unknown";
+}
@@ -0,0 +1,172 @@
+#ifndef BACKEND_AUTOTUNER_H
+#define BACKEND_AUTOTUNER_H
+
+#include "IGPUProcessor.h"
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Chooses processing backends from measurements instead of device names
+ *
+ * Tune() micro-benchmarks every available backend on the job operations and
+ * on partitioned convolution, over a range of block sizes. Each combination
+ * gets two figures:
+ * - a realtime latency: one block submitted and waited for;
+ * - a batch cost: the time per block with several jobs in flight.
+ * The CPU is measured by running jobs inline with GPUJobs::ExecuteReference,
+ * which is what a latency-critical caller does when it skips the accelerator.
+ *
+ * Results are saved under CacheDirectory("autotune"). They are keyed by the
+ * backends' device descriptions and the benchmark settings, so later runs load
+ * them instantly and re-measure only when the hardware or drivers change.
+ * Choose() then answers per operation and block size. Small realtime blocks
+ * usually stay on the CPU, while large batch work goes to the accelerator
+ * when it is measurably faster.
+ */
+class BackendAutotuner {
+public:
+    /**
+     * @brief What the caller is optimizing for
+     */
+    enum class Workload {
+        Realtime,   // One block at a time, the result is needed immediately
+        Batch       // Many blocks, only throughput matters
+    };
+
+    /**
+     * @brief Measured operations: the job operations plus convolution partitions
+     */
+    enum class Operation {
+        Copy,
+        Gain,
+        BiquadCascade,
+        Convolution
+    };
+
+    /**
+     * @brief Timing of one backend on one operation and block size
+     */
+    struct Measurement {
+        IGPUProcessor::Backend backend = IGPUProcessor::Backend::CPU;
+        Operation operation = Operation::Copy;
+        size_t frames = 0;
+        double realtimeMicroseconds = 0.0;   // Median latency of a single block
+        double batchMicroseconds = 0.0;      // Average time per block with jobs in flight
+    };
+
+    /**
+     * @brief Benchmark settings
+     */
+    struct Options {
+        std::vector<size_t> blockFrames = {64, 256, 1024, 4096, 16384};
+        std::vector<size_t> convolutionPartitions = {1024, 4096, 16384};
+        int channels = 2;
+        size_t biquadStages = 8;
+        size_t realtimeRuns = 15;             // Single-block runs per measurement (median is kept)
+        size_t batchJobs = 32;                // Jobs per batch measurement
+        size_t batchDepth = 4;                // Jobs in flight during batch measurements
+        double maxBlockMicroseconds = 50000;  // Larger sizes are skipped once a block takes longer
+        std::vector<IGPUProcessor::Backend> backends;   // Empty: every supported backend
+        bool persist = true;                  // Load and save results in the cache directory
+    };
+
+    /**
+     * @brief Constructor with the default benchmark settings
+     */
+    BackendAutotuner();
+
+    /**
+     * @brief Constructor
+     * @param options Benchmark settings
+     */
+    explicit BackendAutotuner(const Options& options);
+
+    /**
+     * @brief Destructor
+     */
+    ~BackendAutotuner();
+
+    /**
+     * @brief Load persisted results or measure every backend
+     * @param remeasure Ignore persisted results and benchmark again
+     * @return true if measurements are available, false otherwise
+     */
+    bool Tune(bool remeasure = false);
+
+    /**
+     * @brief Pick the fastest backend for an operation
+     *
+     * Uses the smallest measured block size that holds frames (or the largest
+     * one). An accelerator must beat the CPU by a margin, so near-ties stay on
+     * the CPU.
+     * @param operation Operation to run
+     * @param frames Block size in frames
+     * @param workload Realtime latency or batch throughput
+     * @return Selected backend, CPU if nothing was measured
+     */
+    IGPUProcessor::Backend Choose(Operation operation, size_t frames, Workload workload) const;
+
+    /**
+     * @brief Pick the backend to hand to the audio engine
+     *
+     * The engine gives its accelerator batch-like work (large convolution
+     * partitions and jobs), so this is the fastest backend for a biquad cascade
+     * on the largest measured block.
+     * @return Selected backend, CPU if no accelerator is faster
+     */
+    IGPUProcessor::Backend ChooseDefault() const;
+
+    /**
+     * @brief Smallest convolution partition worth offloading to a backend
+     * @param backend Accelerator that would run the partitions
+     * @return Partition size in frames, or SIZE_MAX if the CPU is always faster
+     */
+    size_t GetConvolutionOffloadSize(IGPUProcessor::Backend backend) const;
+
+    /**
+     * @brief Get all measurements
+     * @return Measurements of the last Tune call
+     */
+    const std::vector<Measurement>& GetMeasurements() const;
+
+    /**
+     * @brief Use measurements taken elsewhere instead of calling Tune
+     * @param measurements Measurements to choose from
+     */
+    void SetMeasurements(const std::vector<Measurement>& measurements);
+
+    /**
+     * @brief Check whether the last Tune call loaded persisted results
+     * @return true if results came from the cache directory
+     */
+    bool LoadedFromCache() const;
+
+    /**
+     * @brief Get a table of the measurements and the resulting choices
+     * @return Multi-line report
+     */
+    std::string GetReport() const;
+
+    /**
+     * @brief Get the short name of a backend
+     * @param backend Backend
+     * @return Name such as "Vulkan"
+     */
+    static std::string GetBackendName(IGPUProcessor::Backend backend);
+
+    /**
+     * @brief Get the short name of an operation
+     * @param operation Operation
+     * @return Name such as "biquad"
+     */
+    static std::string GetOperationName(Operation operation);
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // BACKEND_AUTOTUNER_H
@@ -0,0 +1,264 @@
+#include "CPUReferenceProcessor.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// Implementation of the pipelined CPU reference processor
+
+// Number of staging buffers ("device memory") shared by the pipeline
+static const int kStagingSlotCount = 2;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double MicrosecondsBetween(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+// Blocking FIFO used between pipeline stages
+template <typename T>
+class StageQueue {
+public:
+    void Push(T value) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            items.push_back(std::move(value));
+        }
+        available.notify_one();
+    }
+
+    // Returns false once the queue is closed and drained
+    bool Pop(T& value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        available.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+        value = std::move(items.front());
+        items.pop_front();
+        return true;
+    }
+
+    void Close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        available.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable available;
+    std::deque<T> items;
+    bool closed = false;
+};
+
+} // namespace
+
+class CPUReferenceProcessor::Impl {
+public:
+    struct Job {
+        GPUJobDesc desc;
+        std::promise<GPUJobResult> promise;
+        GPUJobResult result;
+        Clock::time_point submitted;
+        int slot = -1;
+    };
+    typedef std::unique_ptr<Job> JobPtr;
+
+    Options options;
+
+    std::vector<float> staging[kStagingSlotCount];
+    StageQueue<int> freeSlots;
+    StageQueue<JobPtr> uploadQueue;
+    StageQueue<JobPtr> computeQueue;
+    StageQueue<JobPtr> downloadQueue;
+    std::thread uploadThread;
+    std::thread computeThread;
+    std::thread downloadThread;
+
+    std::mutex flightMutex;
+    std::condition_variable flightChanged;
+    size_t jobsInFlight = 0;
+    size_t maxJobsInFlight = 4;
+
+    // Hold the stage busy for the simulated duration of a transfer or launch
+    static void WaitUntil(Clock::time_point deadline) {
+        if (Clock::now() < deadline) {
+            std::this_thread::sleep_until(deadline);
+        }
+    }
+
+    Clock::time_point TransferDeadline(Clock::time_point start, size_t bytes) const {
+        if (options.transferBytesPerSecond <= 0.0) {
+            return start;
+        }
+        auto duration = std::chrono::duration<double>(bytes / options.transferBytesPerSecond);
+        return start + std::chrono::duration_cast<Clock::duration>(duration);
+    }
+
+    void UploadLoop() {
+        JobPtr job;
+        while (uploadQueue.Pop(job)) {
+            int slot = 0;
+            if (!freeSlots.Pop(slot)) {
+                break;
+            }
+            auto start = Clock::now();
+            job->result.queueMicroseconds = MicrosecondsBetween(job->submitted, start);
+            job->slot = slot;
+
+            std::vector<float>& buffer = staging[slot];
+            const size_t samples = job->desc.input.SampleCount();
+            if (buffer.size() < samples) {
+                buffer.resize(samples);
+            }
+            std::memcpy(buffer.data(), job->desc.input.Data(), samples * sizeof(float));
+            WaitUntil(TransferDeadline(start, samples * sizeof(float)));
+
+            job->result.uploadMicroseconds = MicrosecondsBetween(start, Clock::now());
+            computeQueue.Push(std::move(job));
+        }
+    }
+
+    void ComputeLoop() {
+        JobPtr job;
+        while (computeQueue.Pop(job)) {
+            auto start = Clock::now();
+            auto latency = std::chrono::duration<double, std::micro>(options.launchLatencyMicroseconds);
+            WaitUntil(start + std::chrono::duration_cast<Clock::duration>(latency));
+
+            // Run the kernel in place on the staging buffer
+            GPUJobDesc kernel = job->desc;
+            float* device = staging[job->slot].data();
+            kernel.input = ConstAudioBufferView(device, job->desc.input.Frames(), job->desc.input.Channels(),
+                                                job->desc.input.Layout());
+            kernel.output = AudioBufferView(device, job->desc.input.Frames(), job->desc.input.Channels(),
+                                            job->desc.input.Layout());
+            job->result.success = GPUJobs::ExecuteReference(kernel);
+
+            job->result.computeMicroseconds = MicrosecondsBetween(start, Clock::now());
+            downloadQueue.Push(std::move(job));
+        }
+    }
+
+    void DownloadLoop() {
+        JobPtr job;
+        while (downloadQueue.Pop(job)) {
+            auto start = Clock::now();
+            const size_t bytes = job->desc.output.ByteSize();
+            std::memcpy(job->desc.output.Data(), staging[job->slot].data(), bytes);
+            WaitUntil(TransferDeadline(start, bytes));
+            freeSlots.Push(job->slot);
+
+            job->result.downloadMicroseconds = MicrosecondsBetween(start, Clock::now());
+            job->promise.set_value(job->result);
+
+            {
+                std::lock_guard<std::mutex> lock(flightMutex);
+                jobsInFlight--;
+            }
+            flightChanged.notify_all();
+        }
+    }
+};
+
+CPUReferenceProcessor::CPUReferenceProcessor() : CPUReferenceProcessor(Options()) {
+}
+
+CPUReferenceProcessor::CPUReferenceProcessor(const Options& options) : pImpl(std::make_unique<Impl>()) {
+    pImpl->options = options;
+    pImpl->maxJobsInFlight = std::max<size_t>(options.maxJobsInFlight, 1);
+    for (int slot = 0; slot < kStagingSlotCount; slot++) {
+        pImpl->freeSlots.Push(slot);
+    }
+    pImpl->uploadThread = std::thread(&Impl::UploadLoop, pImpl.get());
+    pImpl->computeThread = std::thread(&Impl::ComputeLoop, pImpl.get());
+    pImpl->downloadThread = std::thread(&Impl::DownloadLoop, pImpl.get());
+}
+
+CPUReferenceProcessor::~CPUReferenceProcessor() {
+    WaitIdle();
+    pImpl->uploadQueue.Close();
+    pImpl->computeQueue.Close();
+    pImpl->downloadQueue.Close();
+    pImpl->freeSlots.Close();
+    pImpl->uploadThread.join();
+    pImpl->computeThread.join();
+    pImpl->downloadThread.join();
+}
+
+bool CPUReferenceProcessor::Initialize(Backend backend) {
+    return backend == Backend::CPU;
+}
+
+bool CPUReferenceProcessor::ProcessAudio(const float* inputBuffer, float* outputBuffer, size_t bufferSize) {
+    GPUJobDesc job;
+    job.operation = GPUOperation::Copy;
+    job.input = ConstAudioBufferView(inputBuffer, bufferSize, 1);
+    job.output = AudioBufferView(outputBuffer, bufferSize, 1);
+    return SubmitJob(job).get().success;
+}
+
+std::string CPUReferenceProcessor::GetGPUInfo() const {
+    std::ostringstream info;
+    info << "CPU reference processor (no GPU)\n"
+         << "- Pipeline: upload / compute / download threads, " << kStagingSlotCount << " staging buffers\n"
+         << "- Jobs in flight: up to " << GetMaxJobsInFlight();
+    if (pImpl->options.transferBytesPerSecond > 0.0) {
+        info << "\n- Simulated transfer: " << pImpl->options.transferBytesPerSecond / 1e9 << " GB/s";
+    }
+    if (pImpl->options.launchLatencyMicroseconds > 0.0) {
+        info << "\n- Simulated launch latency: " << pImpl->options.launchLatencyMicroseconds << " us";
+    }
+    return info.str();
+}
+
+bool CPUReferenceProcessor::IsAvailable() const {
+    return true;
+}
+
+GPUJobFuture CPUReferenceProcessor::SubmitJob(const GPUJobDesc& job) {
+    if (!GPUJobs::Validate(job)) {
+        return GPUJobs::MakeReadyFuture(GPUJobResult());
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(pImpl->flightMutex);
+        pImpl->flightChanged.wait(lock, [this] { return pImpl->jobsInFlight < pImpl->maxJobsInFlight; });
+        pImpl->jobsInFlight++;
+    }
+
+    auto pending = std::make_unique<Impl::Job>();
+    pending->desc = job;
+    pending->submitted = Clock::now();
+    GPUJobFuture future = pending->promise.get_future().share();
+    pImpl->uploadQueue.Push(std::move(pending));
+    return future;
+}
+
+void CPUReferenceProcessor::SetMaxJobsInFlight(size_t depth) {
+    {
+        std::lock_guard<std::mutex> lock(pImpl->flightMutex);
+        pImpl->maxJobsInFlight = std::max<size_t>(depth, 1);
+    }
+    pImpl->flightChanged.notify_all();
+}
+
+size_t CPUReferenceProcessor::GetMaxJobsInFlight() const {
+    std::lock_guard<std::mutex> lock(pImpl->flightMutex);
+    return pImpl->maxJobsInFlight;
+}
+
+void CPUReferenceProcessor::WaitIdle() {
+    std::unique_lock<std::mutex> lock(pImpl->flightMutex);
+    pImpl->flightChanged.wait(lock, [this] { return pImpl->jobsInFlight == 0; });
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef CPU_REFERENCE_PROCESSOR_H
+#define CPU_REFERENCE_PROCESSOR_H
+
+#include "IGPUProcessor.h"
+#include <memory>
+
+/**
+ * @brief CPU implementation of IGPUProcessor that models an accelerator pipeline
+ *
+ * Jobs go through three stages on separate threads, like a discrete GPU:
+ * upload into one of two staging buffers, compute on the staging buffer, and
+ * download into the caller's output. With two staging buffers the upload of
+ * the next job overlaps the compute of the current one and the download of
+ * the previous one. Transfer bandwidth and kernel launch latency can be
+ * simulated, so pipelining and in-flight depth can be tested and benchmarked
+ * on machines without a GPU. Results are bit-identical to GPUJobs::ExecuteReference.
+ */
+class CPUReferenceProcessor : public IGPUProcessor {
+public:
+    /**
+     * @brief Simulated device characteristics
+     */
+    struct Options {
+        double transferBytesPerSecond = 0.0;    // Host/device bandwidth (0 = plain memcpy speed)
+        double launchLatencyMicroseconds = 0.0; // Fixed cost per kernel launch
+        size_t maxJobsInFlight = 4;             // Initial in-flight limit
+    };
+
+    /**
+     * @brief Constructor, no simulated transfer or launch cost
+     */
+    CPUReferenceProcessor();
+
+    /**
+     * @brief Constructor
+     * @param options Simulated device characteristics
+     */
+    explicit CPUReferenceProcessor(const Options& options);
+
+    /**
+     * @brief Destructor, waits for outstanding jobs
+     */
+    ~CPUReferenceProcessor() override;
+
+    bool Initialize(Backend backend) override;
+    using IGPUProcessor::ProcessAudio;
+    bool ProcessAudio(const float* inputBuffer, float* outputBuffer, size_t bufferSize) override;
+    std::string GetGPUInfo() const override;
+    bool IsAvailable() const override;
+
+    GPUJobFuture SubmitJob(const GPUJobDesc& job) override;
+    void SetMaxJobsInFlight(size_t depth) override;
+    size_t GetMaxJobsInFlight() const override;
+    void WaitIdle() override;
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // CPU_REFERENCE_PROCESSOR_H
\ No newline at end of file
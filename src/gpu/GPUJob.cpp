@@ -0,0 +1,81 @@
+#include "GPUJob.h"
+#include <cstring>
+
+// Reference implementation of accelerator job operations
+
+namespace GPUJobs {
+
+bool Validate(const GPUJobDesc& job) {
+    if (job.input.IsEmpty() || job.output.IsEmpty() || !job.input.HasSameShape(job.output)) {
+        return false;
+    }
+    // Backends transfer whole buffers; copy and gain are per sample and work on
+    // either layout, the filters walk interleaved frames
+    if (!job.input.IsContiguous() || !job.output.IsContiguous() || job.input.Layout() != job.output.Layout()) {
+        return false;
+    }
+    if (job.operation == GPUOperation::BiquadCascade) {
+        return job.input.IsInterleaved() && job.biquadCount > 0 && job.biquads != nullptr &&
+               job.biquadState != nullptr;
+    }
+    return true;
+}
+
+bool ExecuteReference(const GPUJobDesc& job) {
+    if (!Validate(job)) {
+        return false;
+    }
+
+    const float* input = job.input.Data();
+    float* output = job.output.Data();
+    const size_t sampleCount = job.input.SampleCount();
+
+    switch (job.operation) {
+        case GPUOperation::Copy:
+            if (output != input) {
+                std::memmove(output, input, job.input.ByteSize());
+            }
+            return true;
+
+        case GPUOperation::Gain:
+            for (size_t i = 0; i < sampleCount; i++) {
+                output[i] = input[i] * job.gain;
+            }
+            return true;
+
+        case GPUOperation::BiquadCascade: {
+            const int channels = job.input.Channels();
+            const size_t frames = job.input.Frames();
+            for (size_t stage = 0; stage < job.biquadCount; stage++) {
+                const BiquadCoefficients& c = job.biquads[stage];
+                // The first stage reads the input, later stages work in place
+                const float* source = (stage == 0) ? input : output;
+                for (int ch = 0; ch < channels; ch++) {
+                    BiquadState& state = job.biquadState[stage * channels + ch];
+                    float z1 = state.z1;
+                    float z2 = state.z2;
+                    for (size_t i = 0; i < frames; i++) {
+                        const size_t index = i * channels + ch;
+                        float x = source[index];
+                        float y = c.b0 * x + z1;
+                        z1 = c.b1 * x - c.a1 * y + z2;
+                        z2 = c.b2 * x - c.a2 * y;
+                        output[index] = y;
+                    }
+                    state.z1 = z1;
+                    state.z2 = z2;
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+GPUJobFuture MakeReadyFuture(const GPUJobResult& result) {
+    std::promise<GPUJobResult> promise;
+    promise.set_value(result);
+    return promise.get_future().share();
+}
+
+} // namespace GPUJobs
\ No newline at end of file
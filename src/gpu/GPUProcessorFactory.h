@@ -18,8 +18,12 @@ public:
     static std::unique_ptr<IGPUProcessor> CreateProcessor(IGPUProcessor::Backend backend);
 
     /**
-     * @brief Detect and select the best available GPU backend automatically
-     * @return Backend type that was selected, or UNKNOWN if no GPUs found
+     * @brief Select the fastest available backend by measurement
+     *
+     * Runs BackendAutotuner (or loads its cached results) and returns its
+     * choice for the audio engine. See BackendAutotuner for per-operation
+     * and per-block-size choices.
+     * @return Backend type that was selected, CPU if no accelerator is faster
      */
     static IGPUProcessor::Backend AutoDetectBestGPU();
 
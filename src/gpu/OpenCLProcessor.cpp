@@ -0,0 +1,1081 @@
+#include "OpenCLProcessor.h"
+
+#ifdef ENABLE_OPENCL
+
+#define CL_TARGET_OPENCL_VERSION 120
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+#include "core/CacheDirectory.h"
+#include "core/Log.h"
+#include "dsp/Resampler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Implementation of the OpenCL processor
+
+static_assert(sizeof(BiquadCoefficients) == 5 * sizeof(float), "Coefficients are uploaded as 5 floats per stage");
+static_assert(sizeof(BiquadState) == 2 * sizeof(float), "State is uploaded as 2 floats per stage and channel");
+
+// Kernels for every operation. FP_CONTRACT is off so results match the CPU reference
+static const char* kKernelSource = R"CLC(
+#pragma OPENCL FP_CONTRACT OFF
+
+__kernel void apply_gain(__global float* data, const float gain, const uint count) {
+    uint i = get_global_id(0);
+    if (i < count) {
+        data[i] = data[i] * gain;
+    }
+}
+
+// One work-item per channel; stages run in sequence over the whole block in place
+__kernel void biquad_cascade(__global float* data,
+                             __global const float* coefficients,
+                             __global float* state,
+                             const uint stages,
+                             const uint channels,
+                             const uint frames) {
+    uint ch = get_global_id(0);
+    if (ch >= channels) {
+        return;
+    }
+    for (uint s = 0; s < stages; s++) {
+        float b0 = coefficients[s * 5 + 0];
+        float b1 = coefficients[s * 5 + 1];
+        float b2 = coefficients[s * 5 + 2];
+        float a1 = coefficients[s * 5 + 3];
+        float a2 = coefficients[s * 5 + 4];
+        uint stateIndex = (s * channels + ch) * 2;
+        float z1 = state[stateIndex];
+        float z2 = state[stateIndex + 1];
+        for (uint i = 0; i < frames; i++) {
+            uint index = i * channels + ch;
+            float x = data[index];
+            float y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            data[index] = y;
+        }
+        state[stateIndex] = z1;
+        state[stateIndex + 1] = z2;
+    }
+}
+
+// One work-item per output sample, same phase table layout as PolyphaseResampler
+__kernel void resample_polyphase(__global const float* input,
+                                 const uint inputCount,
+                                 __global const float* phaseTable,
+                                 const uint tapCount,
+                                 const uint phaseCount,
+                                 const uint inputStep,
+                                 __global float* output,
+                                 const uint outputCount) {
+    uint n = get_global_id(0);
+    if (n >= outputCount) {
+        return;
+    }
+    ulong numerator = (ulong)n * inputStep;
+    long first = (long)(numerator / phaseCount) - (long)(tapCount / 2) + 1;
+    __global const float* coefficients = phaseTable + (numerator % phaseCount) * tapCount;
+    float sum = 0.0f;
+    for (uint j = 0; j < tapCount; j++) {
+        long k = first + j;
+        float x = (k >= 0 && k < (long)inputCount) ? input[k] : 0.0f;
+        sum += coefficients[j] * x;
+    }
+    output[n] = sum;
+}
+
+// Direct convolution of the newest block against the kernel over a power-of-two history ring
+__kernel void convolve_direct(__global const float* history,
+                              const uint historyMask,
+                              const uint blockEnd,
+                              __global const float* taps,
+                              const uint tapCount,
+                              __global float* output,
+                              const uint frames) {
+    uint n = get_global_id(0);
+    if (n >= frames) {
+        return;
+    }
+    uint position = blockEnd - frames + n;
+    float sum = 0.0f;
+    for (uint k = 0; k < tapCount; k++) {
+        sum += taps[k] * history[(position - k) & historyMask];
+    }
+    output[n] = sum;
+}
+
+// Direct real DFT of a batch of frames, one work-item per bin of each frame
+__kernel void dft_forward(__global const float* frames,
+                          __global const float* cosTable,
+                          __global const float* sinTable,
+                          const uint frameSize,
+                          const uint binCount,
+                          __global float* re,
+                          __global float* im) {
+    uint bin = get_global_id(0);
+    uint frame = get_global_id(1);
+    if (bin >= binCount) {
+        return;
+    }
+    __global const float* x = frames + frame * frameSize;
+    uint mask = frameSize - 1;
+    uint index = 0;   // bin * n modulo frameSize
+    float sumRe = 0.0f;
+    float sumIm = 0.0f;
+    for (uint n = 0; n < frameSize; n++) {
+        sumRe += x[n] * cosTable[index];
+        sumIm -= x[n] * sinTable[index];
+        index = (index + bin) & mask;
+    }
+    re[frame * binCount + bin] = sumRe;
+    im[frame * binCount + bin] = sumIm;
+}
+
+// Inverse of dft_forward, one work-item per sample; bins between DC and Nyquist count twice
+__kernel void dft_inverse(__global const float* re,
+                          __global const float* im,
+                          __global const float* cosTable,
+                          __global const float* sinTable,
+                          const uint frameSize,
+                          const uint binCount,
+                          __global float* frames) {
+    uint n = get_global_id(0);
+    uint frame = get_global_id(1);
+    if (n >= frameSize) {
+        return;
+    }
+    __global const float* r = re + frame * binCount;
+    __global const float* i = im + frame * binCount;
+    uint mask = frameSize - 1;
+    uint index = n & mask;   // k * n modulo frameSize, from k = 1
+    float sum = r[0] + ((n & 1) ? -r[binCount - 1] : r[binCount - 1]);
+    for (uint k = 1; k + 1 < binCount; k++) {
+        sum += 2.0f * (r[k] * cosTable[index] - i[k] * sinTable[index]);
+        index = (index + n) & mask;
+    }
+    frames[frame * frameSize + n] = sum / frameSize;
+}
+)CLC";
+
+namespace {
+
+std::string PlatformString(cl_platform_id platform, cl_platform_info param) {
+    size_t size = 0;
+    if (clGetPlatformInfo(platform, param, 0, nullptr, &size) != CL_SUCCESS || size == 0) {
+        return std::string();
+    }
+    std::string value(size, '\0');
+    clGetPlatformInfo(platform, param, size, &value[0], nullptr);
+    value.resize(std::strlen(value.c_str()));
+    return value;
+}
+
+std::string DeviceString(cl_device_id device, cl_device_info param) {
+    size_t size = 0;
+    if (clGetDeviceInfo(device, param, 0, nullptr, &size) != CL_SUCCESS || size == 0) {
+        return std::string();
+    }
+    std::string value(size, '\0');
+    clGetDeviceInfo(device, param, size, &value[0], nullptr);
+    value.resize(std::strlen(value.c_str()));
+    return value;
+}
+
+// Pick a device: GPUs first, then accelerators, then CPU implementations such as PoCL
+bool SelectDevice(cl_platform_id& selectedPlatform, cl_device_id& selectedDevice) {
+    cl_uint platformCount = 0;
+    if (clGetPlatformIDs(0, nullptr, &platformCount) != CL_SUCCESS || platformCount == 0) {
+        return false;
+    }
+    std::vector<cl_platform_id> platforms(platformCount);
+    clGetPlatformIDs(platformCount, platforms.data(), nullptr);
+
+    const char* nameFilter = std::getenv("GPU_PLAYER_OPENCL_DEVICE");
+    const cl_device_type preference[] = {CL_DEVICE_TYPE_GPU, CL_DEVICE_TYPE_ACCELERATOR, CL_DEVICE_TYPE_CPU};
+    for (cl_device_type type : preference) {
+        for (cl_platform_id platform : platforms) {
+            cl_uint deviceCount = 0;
+            if (clGetDeviceIDs(platform, type, 0, nullptr, &deviceCount) != CL_SUCCESS || deviceCount == 0) {
+                continue;
+            }
+            std::vector<cl_device_id> devices(deviceCount);
+            clGetDeviceIDs(platform, type, deviceCount, devices.data(), nullptr);
+            for (cl_device_id device : devices) {
+                if (nameFilter && *nameFilter &&
+                    DeviceString(device, CL_DEVICE_NAME).find(nameFilter) == std::string::npos) {
+                    continue;
+                }
+                selectedPlatform = platform;
+                selectedDevice = device;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+double EventMicroseconds(cl_event event, cl_profiling_info from, cl_profiling_info to) {
+    if (!event) {
+        return 0.0;
+    }
+    cl_ulong start = 0;
+    cl_ulong end = 0;
+    if (clGetEventProfilingInfo(event, from, sizeof(start), &start, nullptr) != CL_SUCCESS ||
+        clGetEventProfilingInfo(event, to, sizeof(end), &end, nullptr) != CL_SUCCESS || end < start) {
+        return 0.0;
+    }
+    return (end - start) / 1000.0;
+}
+
+size_t NextPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+class OpenCLProcessor::Impl {
+public:
+    // Persistent device memory owned by one in-flight job at a time
+    struct Slot {
+        cl_mem data = nullptr;
+        size_t dataBytes = 0;
+        cl_mem coefficients = nullptr;
+        size_t coefficientBytes = 0;
+    };
+
+    // Device copy of a caller's biquad state, kept while jobs using it are in flight
+    struct StateEntry {
+        cl_mem buffer = nullptr;
+        size_t bytes = 0;
+        size_t pending = 0;
+    };
+
+    struct Job {
+        Impl* owner = nullptr;
+        std::promise<GPUJobResult> promise;
+        int slot = -1;
+        Slot* slotData = nullptr;
+        BiquadState* statePointer = nullptr;
+        std::vector<BiquadCoefficients> coefficients;   // Host copy read by the non-blocking upload
+        cl_event uploadEvent = nullptr;
+        cl_event computeEvent = nullptr;
+        cl_event downloadEvent = nullptr;
+    };
+
+    struct ConvolutionKernel {
+        cl_mem taps = nullptr;
+        cl_mem history = nullptr;
+        cl_mem output = nullptr;
+        cl_uint tapCount = 0;
+        size_t partitionSize = 0;
+        size_t ringSize = 0;
+        cl_uint writePosition = 0;
+    };
+
+    bool initialized = false;
+    cl_platform_id platform = nullptr;
+    cl_device_id device = nullptr;
+    cl_context context = nullptr;
+    cl_command_queue queue = nullptr;
+    cl_program program = nullptr;
+    cl_kernel gainKernel = nullptr;
+    cl_kernel biquadKernel = nullptr;
+    cl_kernel resampleKernel = nullptr;
+    cl_kernel convolveKernel = nullptr;
+
+    std::string deviceName;
+    std::string platformName;
+    std::string deviceVersion;
+    cl_device_type deviceType = 0;
+    cl_uint computeUnits = 0;
+    cl_ulong globalMemory = 0;
+    bool programFromCache = false;
+
+    // Serializes enqueues and kernel argument updates
+    std::mutex queueMutex;
+
+    // Protects the in-flight bookkeeping below; also taken by completion callbacks
+    std::mutex flightMutex;
+    std::condition_variable flightChanged;
+    size_t jobsInFlight = 0;
+    size_t maxJobsInFlight = 4;
+    std::vector<std::unique_ptr<Slot>> slots;   // Slots never move, enqueueing may run alongside growth
+    std::vector<int> freeSlots;
+    std::map<BiquadState*, StateEntry> states;
+
+    std::map<int, ConvolutionKernel> convolutionKernels;
+    int nextKernelId = 0;
+
+    // Spectral transforms: twiddle tables for one frame size and buffers reused between calls
+    cl_kernel dftForwardKernel = nullptr;
+    cl_kernel dftInverseKernel = nullptr;
+    cl_mem twiddleCos = nullptr;
+    cl_mem twiddleSin = nullptr;
+    size_t twiddleFrameSize = 0;
+    size_t twiddleCosCapacity = 0;
+    size_t twiddleSinCapacity = 0;
+    cl_mem spectralFrames = nullptr;
+    cl_mem spectralRe = nullptr;
+    cl_mem spectralIm = nullptr;
+    size_t spectralFramesCapacity = 0;
+    size_t spectralReCapacity = 0;
+    size_t spectralImCapacity = 0;
+
+    ~Impl() {
+        for (auto& slot : slots) {
+            if (slot->data) clReleaseMemObject(slot->data);
+            if (slot->coefficients) clReleaseMemObject(slot->coefficients);
+        }
+        for (auto& entry : states) {
+            if (entry.second.buffer) clReleaseMemObject(entry.second.buffer);
+        }
+        for (auto& entry : convolutionKernels) {
+            ReleaseBuffers(entry.second);
+        }
+        if (gainKernel) clReleaseKernel(gainKernel);
+        if (biquadKernel) clReleaseKernel(biquadKernel);
+        if (resampleKernel) clReleaseKernel(resampleKernel);
+        if (convolveKernel) clReleaseKernel(convolveKernel);
+        if (dftForwardKernel) clReleaseKernel(dftForwardKernel);
+        if (dftInverseKernel) clReleaseKernel(dftInverseKernel);
+        for (cl_mem buffer : {twiddleCos, twiddleSin, spectralFrames, spectralRe, spectralIm}) {
+            if (buffer) clReleaseMemObject(buffer);
+        }
+        if (program) clReleaseProgram(program);
+        if (queue) clReleaseCommandQueue(queue);
+        if (context) clReleaseContext(context);
+    }
+
+    /**
+     * @brief Prepare the twiddle tables and buffers of a batch of spectral transforms (queueMutex held)
+     * @return true if successful, false otherwise
+     */
+    bool PrepareSpectra(size_t frameSize, size_t frameCount) {
+        const size_t binCount = frameSize / 2 + 1;
+        if (!EnsureBuffer(spectralFrames, spectralFramesCapacity, frameSize * frameCount * sizeof(float),
+                          CL_MEM_READ_WRITE)) {
+            return false;
+        }
+        if (!EnsureBuffer(spectralRe, spectralReCapacity, binCount * frameCount * sizeof(float), CL_MEM_READ_WRITE) ||
+            !EnsureBuffer(spectralIm, spectralImCapacity, binCount * frameCount * sizeof(float), CL_MEM_READ_WRITE)) {
+            return false;
+        }
+        if (twiddleFrameSize == frameSize) {
+            return true;
+        }
+
+        std::vector<float> cosines(frameSize);
+        std::vector<float> sines(frameSize);
+        for (size_t n = 0; n < frameSize; n++) {
+            const double angle = 2.0 * M_PI * n / frameSize;
+            cosines[n] = static_cast<float>(std::cos(angle));
+            sines[n] = static_cast<float>(std::sin(angle));
+        }
+        if (!EnsureBuffer(twiddleCos, twiddleCosCapacity, frameSize * sizeof(float), CL_MEM_READ_ONLY) ||
+            !EnsureBuffer(twiddleSin, twiddleSinCapacity, frameSize * sizeof(float), CL_MEM_READ_ONLY)) {
+            return false;
+        }
+        cl_int error = clEnqueueWriteBuffer(queue, twiddleCos, CL_TRUE, 0, frameSize * sizeof(float), cosines.data(),
+                                            0, nullptr, nullptr);
+        if (error == CL_SUCCESS) {
+            error = clEnqueueWriteBuffer(queue, twiddleSin, CL_TRUE, 0, frameSize * sizeof(float), sines.data(),
+                                         0, nullptr, nullptr);
+        }
+        if (error != CL_SUCCESS) {
+            GPU_PLAYER_LOG(GPU, Error, "OpenCL twiddle upload failed (%d)", static_cast<int>(error));
+            return false;
+        }
+        twiddleFrameSize = frameSize;
+        return true;
+    }
+
+    static void ReleaseBuffers(ConvolutionKernel& kernel) {
+        if (kernel.taps) clReleaseMemObject(kernel.taps);
+        if (kernel.history) clReleaseMemObject(kernel.history);
+        if (kernel.output) clReleaseMemObject(kernel.output);
+        kernel.taps = kernel.history = kernel.output = nullptr;
+    }
+
+    // (Re)allocate a buffer if it is smaller than needed
+    bool EnsureBuffer(cl_mem& buffer, size_t& capacity, size_t bytes, cl_mem_flags flags) {
+        if (buffer && capacity >= bytes) {
+            return true;
+        }
+        if (buffer) {
+            clReleaseMemObject(buffer);
+            buffer = nullptr;
+            capacity = 0;
+        }
+        cl_int error = CL_SUCCESS;
+        buffer = clCreateBuffer(context, flags, bytes, nullptr, &error);
+        if (error != CL_SUCCESS) {
+            GPU_PLAYER_LOG(GPU, Error, "OpenCL buffer allocation of %zu bytes failed (%d)", bytes, static_cast<int>(error));
+            buffer = nullptr;
+            return false;
+        }
+        capacity = bytes;
+        return true;
+    }
+
+    bool BuildProgram() {
+        std::string driverVersion = DeviceString(device, CL_DRIVER_VERSION);
+        std::string cacheKey = CacheDirectory::HashKey(std::string(kKernelSource) + "|" + deviceName + "|" +
+                                                       driverVersion + "|" + PlatformString(platform, CL_PLATFORM_VERSION));
+        std::string cacheDirectory = CacheDirectory::Get("opencl");
+        std::string cachePath = cacheDirectory.empty() ? std::string() : cacheDirectory + "/" + cacheKey + ".bin";
+        cl_int error = CL_SUCCESS;
+
+        // Try the binary from an earlier run first
+        if (!cachePath.empty()) {
+            std::ifstream cached(cachePath, std::ios::binary);
+            std::vector<unsigned char> binary((std::istreambuf_iterator<char>(cached)), std::istreambuf_iterator<char>());
+            if (!binary.empty()) {
+                const unsigned char* binaryData = binary.data();
+                size_t binarySize = binary.size();
+                cl_int binaryStatus = CL_SUCCESS;
+                program = clCreateProgramWithBinary(context, 1, &device, &binarySize, &binaryData, &binaryStatus, &error);
+                if (error == CL_SUCCESS && binaryStatus == CL_SUCCESS &&
+                    clBuildProgram(program, 1, &device, "", nullptr, nullptr) == CL_SUCCESS) {
+                    programFromCache = true;
+                    return true;
+                }
+                if (program) {
+                    clReleaseProgram(program);
+                    program = nullptr;
+                }
+            }
+        }
+
+        const char* source = kKernelSource;
+        program = clCreateProgramWithSource(context, 1, &source, nullptr, &error);
+        if (error != CL_SUCCESS) {
+            std::cout << "Error: clCreateProgramWithSource failed (" << error << ")\n";
+            return false;
+        }
+        error = clBuildProgram(program, 1, &device, "", nullptr, nullptr);
+        if (error != CL_SUCCESS) {
+            size_t logSize = 0;
+            clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, 0, nullptr, &logSize);
+            std::string log(logSize, '\0');
+            if (logSize > 0) {
+                clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, logSize, &log[0], nullptr);
+            }
+            std::cout << "Error: OpenCL program build failed (" << error << ")\n" << log << "\n";
+            return false;
+        }
+
+        // Store the binary for the next run; failure here only costs a rebuild
+        size_t binarySize = 0;
+        if (!cachePath.empty() &&
+            clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(binarySize), &binarySize, nullptr) == CL_SUCCESS &&
+            binarySize > 0) {
+            std::vector<unsigned char> binary(binarySize);
+            unsigned char* binaryData = binary.data();
+            if (clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(binaryData), &binaryData, nullptr) == CL_SUCCESS) {
+                std::ofstream cached(cachePath, std::ios::binary);
+                cached.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+            }
+        }
+        return true;
+    }
+
+    cl_kernel CreateKernel(const char* name) {
+        cl_int error = CL_SUCCESS;
+        cl_kernel kernel = clCreateKernel(program, name, &error);
+        if (error != CL_SUCCESS) {
+            std::cout << "Error: clCreateKernel(" << name << ") failed (" << error << ")\n";
+            return nullptr;
+        }
+        return kernel;
+    }
+
+    bool Setup() {
+        if (!SelectDevice(platform, device)) {
+            std::cout << "Error: No OpenCL device found\n";
+            return false;
+        }
+        deviceName = DeviceString(device, CL_DEVICE_NAME);
+        platformName = PlatformString(platform, CL_PLATFORM_NAME);
+        deviceVersion = DeviceString(device, CL_DEVICE_VERSION);
+        clGetDeviceInfo(device, CL_DEVICE_TYPE, sizeof(deviceType), &deviceType, nullptr);
+        clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(computeUnits), &computeUnits, nullptr);
+        clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(globalMemory), &globalMemory, nullptr);
+
+        cl_int error = CL_SUCCESS;
+        context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &error);
+        if (error != CL_SUCCESS) {
+            std::cout << "Error: clCreateContext failed (" << error << ")\n";
+            return false;
+        }
+        queue = clCreateCommandQueue(context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+        if (error != CL_SUCCESS) {
+            std::cout << "Error: clCreateCommandQueue failed (" << error << ")\n";
+            return false;
+        }
+        if (!BuildProgram()) {
+            return false;
+        }
+        gainKernel = CreateKernel("apply_gain");
+        biquadKernel = CreateKernel("biquad_cascade");
+        resampleKernel = CreateKernel("resample_polyphase");
+        convolveKernel = CreateKernel("convolve_direct");
+        dftForwardKernel = CreateKernel("dft_forward");
+        dftInverseKernel = CreateKernel("dft_inverse");
+        return gainKernel && biquadKernel && resampleKernel && convolveKernel && dftForwardKernel && dftInverseKernel;
+    }
+
+    // Enqueue upload, kernel and download of a job; the download event completes it
+    bool EnqueueJob(const GPUJobDesc& desc, Job* job, StateEntry* state, bool uploadState) {
+        Slot& slot = *job->slotData;
+        const size_t bytes = desc.input.ByteSize();
+        if (!EnsureBuffer(slot.data, slot.dataBytes, bytes, CL_MEM_READ_WRITE)) {
+            return false;
+        }
+
+        cl_int error = clEnqueueWriteBuffer(queue, slot.data, CL_FALSE, 0, bytes, desc.input.Data(),
+                                            0, nullptr, &job->uploadEvent);
+        if (error != CL_SUCCESS) {
+            GPU_PLAYER_LOG(GPU, Error, "OpenCL upload failed (%d)", static_cast<int>(error));
+            return false;
+        }
+
+        if (desc.operation == GPUOperation::Gain) {
+            cl_uint count = static_cast<cl_uint>(desc.input.SampleCount());
+            size_t globalSize = count;
+            clSetKernelArg(gainKernel, 0, sizeof(cl_mem), &slot.data);
+            clSetKernelArg(gainKernel, 1, sizeof(float), &desc.gain);
+            clSetKernelArg(gainKernel, 2, sizeof(cl_uint), &count);
+            error = clEnqueueNDRangeKernel(queue, gainKernel, 1, nullptr, &globalSize, nullptr,
+                                           0, nullptr, &job->computeEvent);
+        } else if (desc.operation == GPUOperation::BiquadCascade) {
+            const size_t coefficientBytes = job->coefficients.size() * sizeof(BiquadCoefficients);
+            if (!EnsureBuffer(slot.coefficients, slot.coefficientBytes, coefficientBytes, CL_MEM_READ_ONLY)) {
+                return false;
+            }
+            error = clEnqueueWriteBuffer(queue, slot.coefficients, CL_FALSE, 0, coefficientBytes,
+                                         job->coefficients.data(), 0, nullptr, nullptr);
+            if (error == CL_SUCCESS && uploadState) {
+                error = clEnqueueWriteBuffer(queue, state->buffer, CL_FALSE, 0, state->bytes,
+                                             job->statePointer, 0, nullptr, nullptr);
+            }
+            if (error != CL_SUCCESS) {
+                GPU_PLAYER_LOG(GPU, Error, "OpenCL upload failed (%d)", static_cast<int>(error));
+                return false;
+            }
+            cl_uint stages = static_cast<cl_uint>(desc.biquadCount);
+            cl_uint channels = static_cast<cl_uint>(desc.input.Channels());
+            cl_uint frames = static_cast<cl_uint>(desc.input.Frames());
+            size_t globalSize = channels;
+            clSetKernelArg(biquadKernel, 0, sizeof(cl_mem), &slot.data);
+            clSetKernelArg(biquadKernel, 1, sizeof(cl_mem), &slot.coefficients);
+            clSetKernelArg(biquadKernel, 2, sizeof(cl_mem), &state->buffer);
+            clSetKernelArg(biquadKernel, 3, sizeof(cl_uint), &stages);
+            clSetKernelArg(biquadKernel, 4, sizeof(cl_uint), &channels);
+            clSetKernelArg(biquadKernel, 5, sizeof(cl_uint), &frames);
+            error = clEnqueueNDRangeKernel(queue, biquadKernel, 1, nullptr, &globalSize, nullptr,
+                                           0, nullptr, &job->computeEvent);
+            if (error == CL_SUCCESS) {
+                // Keep the caller's copy current; later jobs of the stream use the device copy
+                error = clEnqueueReadBuffer(queue, state->buffer, CL_FALSE, 0, state->bytes,
+                                            job->statePointer, 0, nullptr, nullptr);
+            }
+        }
+        if (error != CL_SUCCESS) {
+            GPU_PLAYER_LOG(GPU, Error, "OpenCL kernel launch failed (%d)", static_cast<int>(error));
+            return false;
+        }
+
+        error = clEnqueueReadBuffer(queue, slot.data, CL_FALSE, 0, bytes, desc.output.Data(),
+                                    0, nullptr, &job->downloadEvent);
+        if (error != CL_SUCCESS) {
+            GPU_PLAYER_LOG(GPU, Error, "OpenCL download failed (%d)", static_cast<int>(error));
+            return false;
+        }
+        error = clSetEventCallback(job->downloadEvent, CL_COMPLETE, &Impl::OnJobComplete, job);
+        if (error != CL_SUCCESS) {
+            GPU_PLAYER_LOG(GPU, Error, "clSetEventCallback failed (%d)", static_cast<int>(error));
+            return false;
+        }
+        clFlush(queue);
+        return true;
+    }
+
+    static void CL_CALLBACK OnJobComplete(cl_event event, cl_int status, void* userData) {
+        Job* job = static_cast<Job*>(userData);
+        job->owner->FinishJob(job, status == CL_COMPLETE);
+    }
+
+    void FinishJob(Job* job, bool success) {
+        GPUJobResult result;
+        result.success = success;
+        if (success) {
+            result.queueMicroseconds = EventMicroseconds(job->uploadEvent, CL_PROFILING_COMMAND_QUEUED, CL_PROFILING_COMMAND_START);
+            result.uploadMicroseconds = EventMicroseconds(job->uploadEvent, CL_PROFILING_COMMAND_START, CL_PROFILING_COMMAND_END);
+            result.computeMicroseconds = EventMicroseconds(job->computeEvent, CL_PROFILING_COMMAND_START, CL_PROFILING_COMMAND_END);
+            result.downloadMicroseconds = EventMicroseconds(job->downloadEvent, CL_PROFILING_COMMAND_START, CL_PROFILING_COMMAND_END);
+        }
+        if (job->uploadEvent) clReleaseEvent(job->uploadEvent);
+        if (job->computeEvent) clReleaseEvent(job->computeEvent);
+        if (job->downloadEvent) clReleaseEvent(job->downloadEvent);
+
+        job->promise.set_value(result);
+        {
+            // Notify under the lock: the processor may be destroyed as soon as it is released
+            std::lock_guard<std::mutex> lock(flightMutex);
+            freeSlots.push_back(job->slot);
+            if (job->statePointer) {
+                states[job->statePointer].pending--;
+            }
+            jobsInFlight--;
+            flightChanged.notify_all();
+        }
+        delete job;
+    }
+};
+
+OpenCLProcessor::OpenCLProcessor() : pImpl(std::make_unique<Impl>()) {
+}
+
+OpenCLProcessor::~OpenCLProcessor() {
+    if (pImpl->initialized) {
+        WaitIdle();
+        clFinish(pImpl->queue);
+    }
+}
+
+bool OpenCLProcessor::Initialize(Backend backend) {
+    if (backend != Backend::OPENCL) return false;
+    if (pImpl->initialized) return true;
+
+    if (!pImpl->Setup()) {
+        return false;
+    }
+    pImpl->initialized = true;
+    std::cout << "Initializing OpenCL processor on " << pImpl->deviceName << " (" << pImpl->platformName << ")\n";
+    return true;
+}
+
+bool OpenCLProcessor::ProcessAudio(const float* inputBuffer, float* outputBuffer, size_t bufferSize) {
+    GPUJobDesc job;
+    job.operation = GPUOperation::Copy;
+    job.input = ConstAudioBufferView(inputBuffer, bufferSize, 1);
+    job.output = AudioBufferView(outputBuffer, bufferSize, 1);
+    return SubmitJob(job).get().success;
+}
+
+std::string OpenCLProcessor::GetGPUInfo() const {
+    if (!pImpl->initialized) {
+        return "OpenCL (not initialized)";
+    }
+    const char* type = (pImpl->deviceType & CL_DEVICE_TYPE_GPU) ? "GPU"
+                     : (pImpl->deviceType & CL_DEVICE_TYPE_CPU) ? "CPU"
+                     : (pImpl->deviceType & CL_DEVICE_TYPE_ACCELERATOR) ? "Accelerator" : "Other";
+    std::ostringstream info;
+    info << "OpenCL " << type << ": " << pImpl->deviceName << " (" << pImpl->platformName << ")\n"
+         << "- Version: " << pImpl->deviceVersion << "\n"
+         << "- Compute units: " << pImpl->computeUnits << "\n"
+         << "- Global memory: " << (pImpl->globalMemory >> 20) << " MB\n"
+         << "- Program: " << (pImpl->programFromCache ? "loaded from cache" : "compiled from source") << "\n"
+         << "- Jobs in flight: up to " << GetMaxJobsInFlight();
+    return info.str();
+}
+
+bool OpenCLProcessor::IsAvailable() const {
+    if (pImpl->initialized) {
+        return true;
+    }
+    cl_platform_id platform = nullptr;
+    cl_device_id device = nullptr;
+    return SelectDevice(platform, device);
+}
+
+GPUJobFuture OpenCLProcessor::SubmitJob(const GPUJobDesc& desc) {
+    if (!pImpl->initialized) {
+        std::cout << "Error: OpenCL processor is not initialized\n";
+        return GPUJobs::MakeReadyFuture(GPUJobResult());
+    }
+    if (!GPUJobs::Validate(desc)) {
+        return GPUJobs::MakeReadyFuture(GPUJobResult());
+    }
+
+    Impl::Job* job = new Impl::Job();
+    job->owner = pImpl.get();
+    GPUJobFuture future = job->promise.get_future().share();
+
+    Impl::StateEntry* state = nullptr;
+    bool uploadState = false;
+    {
+        std::unique_lock<std::mutex> lock(pImpl->flightMutex);
+        pImpl->flightChanged.wait(lock, [this] { return pImpl->jobsInFlight < pImpl->maxJobsInFlight; });
+        pImpl->jobsInFlight++;
+        if (pImpl->freeSlots.empty()) {
+            pImpl->slots.push_back(std::make_unique<Impl::Slot>());
+            job->slot = static_cast<int>(pImpl->slots.size()) - 1;
+        } else {
+            job->slot = pImpl->freeSlots.back();
+            pImpl->freeSlots.pop_back();
+        }
+        job->slotData = pImpl->slots[job->slot].get();
+
+        if (desc.operation == GPUOperation::BiquadCascade) {
+            // Drop device copies of streams that have no job in flight
+            for (auto it = pImpl->states.begin(); it != pImpl->states.end();) {
+                if (it->second.pending == 0 && it->first != desc.biquadState) {
+                    clReleaseMemObject(it->second.buffer);
+                    it = pImpl->states.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            job->statePointer = desc.biquadState;
+            job->coefficients.assign(desc.biquads, desc.biquads + desc.biquadCount);
+            state = &pImpl->states[desc.biquadState];
+            const size_t stateBytes = desc.biquadCount * desc.input.Channels() * sizeof(BiquadState);
+            // With earlier jobs of the stream still in flight the device copy is newer than the caller's
+            uploadState = state->pending == 0;
+            if (uploadState && state->bytes != stateBytes) {
+                size_t capacity = 0;
+                if (state->buffer) clReleaseMemObject(state->buffer);
+                state->buffer = nullptr;
+                pImpl->EnsureBuffer(state->buffer, capacity, stateBytes, CL_MEM_READ_WRITE);
+                state->bytes = state->buffer ? stateBytes : 0;
+            }
+            state->pending++;
+        }
+    }
+
+    bool enqueued = false;
+    {
+        std::lock_guard<std::mutex> lock(pImpl->queueMutex);
+        if (!state || state->buffer) {
+            enqueued = pImpl->EnqueueJob(desc, job, state, uploadState);
+        }
+        if (!enqueued) {
+            // Let anything already enqueued for this job drain before releasing its slot
+            clFinish(pImpl->queue);
+        }
+    }
+    if (!enqueued) {
+        pImpl->FinishJob(job, false);
+    }
+    return future;
+}
+
+void OpenCLProcessor::SetMaxJobsInFlight(size_t depth) {
+    std::lock_guard<std::mutex> lock(pImpl->flightMutex);
+    pImpl->maxJobsInFlight = std::max<size_t>(depth, 1);
+    pImpl->flightChanged.notify_all();
+}
+
+size_t OpenCLProcessor::GetMaxJobsInFlight() const {
+    std::lock_guard<std::mutex> lock(pImpl->flightMutex);
+    return pImpl->maxJobsInFlight;
+}
+
+void OpenCLProcessor::WaitIdle() {
+    std::unique_lock<std::mutex> lock(pImpl->flightMutex);
+    pImpl->flightChanged.wait(lock, [this] { return pImpl->jobsInFlight == 0; });
+}
+
+bool OpenCLProcessor::ConvertSampleRate(const float* inputBuffer,
+                                        int inputSampleRate,
+                                        float* outputBuffer,
+                                        int outputSampleRate,
+                                        size_t inputSampleCount,
+                                        size_t& outputSampleCount) {
+    if (!pImpl->initialized || !inputBuffer || !outputBuffer || inputSampleCount == 0) {
+        return false;
+    }
+
+    // Reuse the CPU resampler's filter design so both paths produce the same output
+    PolyphaseResampler design;
+    if (!design.Initialize(inputSampleRate, outputSampleRate, 1)) {
+        std::cout << "Error: Unsupported rate pair " << inputSampleRate << " -> " << outputSampleRate << "\n";
+        return false;
+    }
+    const std::vector<float>& table = design.GetPhaseTable();
+    const size_t outputCount = (inputSampleCount * design.GetPhaseCount() + design.GetInputStep() - 1) / design.GetInputStep();
+    if (outputSampleCount < outputCount) {
+        std::cout << "Error: Resampler output buffer holds " << outputSampleCount
+                  << " samples, " << outputCount << " needed\n";
+        return false;
+    }
+
+    cl_mem input = nullptr, phaseTable = nullptr, output = nullptr;
+    size_t inputCapacity = 0, tableCapacity = 0, outputCapacity = 0;
+    bool success = pImpl->EnsureBuffer(input, inputCapacity, inputSampleCount * sizeof(float), CL_MEM_READ_ONLY) &&
+                   pImpl->EnsureBuffer(phaseTable, tableCapacity, table.size() * sizeof(float), CL_MEM_READ_ONLY) &&
+                   pImpl->EnsureBuffer(output, outputCapacity, outputCount * sizeof(float), CL_MEM_READ_WRITE);
+
+    if (success) {
+        std::lock_guard<std::mutex> lock(pImpl->queueMutex);
+        cl_uint inputCount = static_cast<cl_uint>(inputSampleCount);
+        cl_uint tapCount = static_cast<cl_uint>(design.GetTapCount());
+        cl_uint phaseCount = static_cast<cl_uint>(design.GetPhaseCount());
+        cl_uint inputStep = static_cast<cl_uint>(design.GetInputStep());
+        cl_uint count = static_cast<cl_uint>(outputCount);
+        size_t globalSize = outputCount;
+
+        cl_int error = clEnqueueWriteBuffer(pImpl->queue, input, CL_FALSE, 0, inputSampleCount * sizeof(float),
+                                            inputBuffer, 0, nullptr, nullptr);
+        if (error == CL_SUCCESS) {
+            error = clEnqueueWriteBuffer(pImpl->queue, phaseTable, CL_FALSE, 0, table.size() * sizeof(float),
+                                         table.data(), 0, nullptr, nullptr);
+        }
+        cl_kernel kernel = pImpl->resampleKernel;
+        clSetKernelArg(kernel, 0, sizeof(cl_mem), &input);
+        clSetKernelArg(kernel, 1, sizeof(cl_uint), &inputCount);
+        clSetKernelArg(kernel, 2, sizeof(cl_mem), &phaseTable);
+        clSetKernelArg(kernel, 3, sizeof(cl_uint), &tapCount);
+        clSetKernelArg(kernel, 4, sizeof(cl_uint), &phaseCount);
+        clSetKernelArg(kernel, 5, sizeof(cl_uint), &inputStep);
+        clSetKernelArg(kernel, 6, sizeof(cl_mem), &output);
+        clSetKernelArg(kernel, 7, sizeof(cl_uint), &count);
+        if (error == CL_SUCCESS) {
+            error = clEnqueueNDRangeKernel(pImpl->queue, kernel, 1, nullptr, &globalSize, nullptr, 0, nullptr, nullptr);
+        }
+        if (error == CL_SUCCESS) {
+            error = clEnqueueReadBuffer(pImpl->queue, output, CL_TRUE, 0, outputCount * sizeof(float),
+                                        outputBuffer, 0, nullptr, nullptr);
+        }
+        if (error != CL_SUCCESS) {
+            GPU_PLAYER_LOG(GPU, Error, "OpenCL resampling failed (%d)", static_cast<int>(error));
+            clFinish(pImpl->queue);
+            success = false;
+        }
+    }
+
+    if (input) clReleaseMemObject(input);
+    if (phaseTable) clReleaseMemObject(phaseTable);
+    if (output) clReleaseMemObject(output);
+    if (success) {
+        outputSampleCount = outputCount;
+    }
+    return success;
+}
+
+bool OpenCLProcessor::CreateConvolutionKernel(const float* impulseResponse,
+                                              size_t tapCount,
+                                              size_t partitionSize,
+                                              int& kernelId) {
+    if (!pImpl->initialized || !impulseResponse || tapCount == 0 || partitionSize == 0) {
+        return false;
+    }
+
+    Impl::ConvolutionKernel kernel;
+    kernel.tapCount = static_cast<cl_uint>(tapCount);
+    kernel.partitionSize = partitionSize;
+    kernel.ringSize = NextPowerOfTwo(tapCount + partitionSize);
+    size_t tapCapacity = 0, historyCapacity = 0, outputCapacity = 0;
+    if (!pImpl->EnsureBuffer(kernel.taps, tapCapacity, tapCount * sizeof(float), CL_MEM_READ_ONLY) ||
+        !pImpl->EnsureBuffer(kernel.history, historyCapacity, kernel.ringSize * sizeof(float), CL_MEM_READ_WRITE) ||
+        !pImpl->EnsureBuffer(kernel.output, outputCapacity, partitionSize * sizeof(float), CL_MEM_READ_WRITE)) {
+        Impl::ReleaseBuffers(kernel);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(pImpl->queueMutex);
+    const float zero = 0.0f;
+    cl_int error = clEnqueueWriteBuffer(pImpl->queue, kernel.taps, CL_TRUE, 0, tapCount * sizeof(float),
+                                        impulseResponse, 0, nullptr, nullptr);
+    if (error == CL_SUCCESS) {
+        error = clEnqueueFillBuffer(pImpl->queue, kernel.history, &zero, sizeof(zero), 0,
+                                    kernel.ringSize * sizeof(float), 0, nullptr, nullptr);
+    }
+    if (error != CL_SUCCESS) {
+        GPU_PLAYER_LOG(GPU, Error, "OpenCL convolution kernel upload failed (%d)", static_cast<int>(error));
+        clFinish(pImpl->queue);
+        Impl::ReleaseBuffers(kernel);
+        return false;
+    }
+
+    kernelId = pImpl->nextKernelId++;
+    pImpl->convolutionKernels[kernelId] = kernel;
+    return true;
+}
+
+bool OpenCLProcessor::ProcessConvolution(int kernelId,
+                                         const float* inputBlock,
+                                         float* outputBlock,
+                                         size_t frameCount) {
+    std::lock_guard<std::mutex> lock(pImpl->queueMutex);
+    auto it = pImpl->convolutionKernels.find(kernelId);
+    if (it == pImpl->convolutionKernels.end() || frameCount != it->second.partitionSize) {
+        return false;
+    }
+    Impl::ConvolutionKernel& kernel = it->second;
+
+    // Append the block to the history ring, in two parts if it wraps
+    const size_t mask = kernel.ringSize - 1;
+    const size_t start = kernel.writePosition & mask;
+    const size_t firstPart = std::min(frameCount, kernel.ringSize - start);
+    cl_int error = clEnqueueWriteBuffer(pImpl->queue, kernel.history, CL_FALSE, start * sizeof(float),
+                                        firstPart * sizeof(float), inputBlock, 0, nullptr, nullptr);
+    if (error == CL_SUCCESS && firstPart < frameCount) {
+        error = clEnqueueWriteBuffer(pImpl->queue, kernel.history, CL_FALSE, 0, (frameCount - firstPart) * sizeof(float),
+                                     inputBlock + firstPart, 0, nullptr, nullptr);
+    }
+    kernel.writePosition += static_cast<cl_uint>(frameCount);
+
+    cl_uint historyMask = static_cast<cl_uint>(mask);
+    cl_uint frames = static_cast<cl_uint>(frameCount);
+    size_t globalSize = frameCount;
+    cl_kernel convolve = pImpl->convolveKernel;
+    clSetKernelArg(convolve, 0, sizeof(cl_mem), &kernel.history);
+    clSetKernelArg(convolve, 1, sizeof(cl_uint), &historyMask);
+    clSetKernelArg(convolve, 2, sizeof(cl_uint), &kernel.writePosition);
+    clSetKernelArg(convolve, 3, sizeof(cl_mem), &kernel.taps);
+    clSetKernelArg(convolve, 4, sizeof(cl_uint), &kernel.tapCount);
+    clSetKernelArg(convolve, 5, sizeof(cl_mem), &kernel.output);
+    clSetKernelArg(convolve, 6, sizeof(cl_uint), &frames);
+    if (error == CL_SUCCESS) {
+        error = clEnqueueNDRangeKernel(pImpl->queue, convolve, 1, nullptr, &globalSize, nullptr, 0, nullptr, nullptr);
+    }
+    if (error == CL_SUCCESS) {
+        error = clEnqueueReadBuffer(pImpl->queue, kernel.output, CL_TRUE, 0, frameCount * sizeof(float),
+                                    outputBlock, 0, nullptr, nullptr);
+    }
+    if (error != CL_SUCCESS) {
+        GPU_PLAYER_LOG(GPU, Error, "OpenCL convolution failed (%d)", static_cast<int>(error));
+        clFinish(pImpl->queue);
+        return false;
+    }
+    return true;
+}
+
+void OpenCLProcessor::ResetConvolutionKernel(int kernelId) {
+    std::lock_guard<std::mutex> lock(pImpl->queueMutex);
+    auto it = pImpl->convolutionKernels.find(kernelId);
+    if (it == pImpl->convolutionKernels.end()) {
+        return;
+    }
+    const float zero = 0.0f;
+    clEnqueueFillBuffer(pImpl->queue, it->second.history, &zero, sizeof(zero), 0,
+                        it->second.ringSize * sizeof(float), 0, nullptr, nullptr);
+    it->second.writePosition = 0;
+}
+
+void OpenCLProcessor::ReleaseConvolutionKernel(int kernelId) {
+    std::lock_guard<std::mutex> lock(pImpl->queueMutex);
+    auto it = pImpl->convolutionKernels.find(kernelId);
+    if (it == pImpl->convolutionKernels.end()) {
+        return;
+    }
+    clFinish(pImpl->queue);
+    Impl::ReleaseBuffers(it->second);
+    pImpl->convolutionKernels.erase(it);
+}
+
+bool OpenCLProcessor::ForwardSpectra(const float* frames, size_t frameSize, size_t frameCount, float* re, float* im) {
+    if (!pImpl->initialized || !frames || frameCount == 0 || frameSize < 4 || (frameSize & (frameSize - 1)) != 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(pImpl->queueMutex);
+    if (!pImpl->PrepareSpectra(frameSize, frameCount)) {
+        return false;
+    }
+
+    const size_t binCount = frameSize / 2 + 1;
+    cl_uint size = static_cast<cl_uint>(frameSize);
+    cl_uint bins = static_cast<cl_uint>(binCount);
+    size_t globalSize[2] = {binCount, frameCount};
+    cl_kernel kernel = pImpl->dftForwardKernel;
+    clSetKernelArg(kernel, 0, sizeof(cl_mem), &pImpl->spectralFrames);
+    clSetKernelArg(kernel, 1, sizeof(cl_mem), &pImpl->twiddleCos);
+    clSetKernelArg(kernel, 2, sizeof(cl_mem), &pImpl->twiddleSin);
+    clSetKernelArg(kernel, 3, sizeof(cl_uint), &size);
+    clSetKernelArg(kernel, 4, sizeof(cl_uint), &bins);
+    clSetKernelArg(kernel, 5, sizeof(cl_mem), &pImpl->spectralRe);
+    clSetKernelArg(kernel, 6, sizeof(cl_mem), &pImpl->spectralIm);
+
+    cl_int error = clEnqueueWriteBuffer(pImpl->queue, pImpl->spectralFrames, CL_FALSE, 0,
+                                        frameSize * frameCount * sizeof(float), frames, 0, nullptr, nullptr);
+    if (error == CL_SUCCESS) {
+        error = clEnqueueNDRangeKernel(pImpl->queue, kernel, 2, nullptr, globalSize, nullptr, 0, nullptr, nullptr);
+    }
+    if (error == CL_SUCCESS) {
+        error = clEnqueueReadBuffer(pImpl->queue, pImpl->spectralRe, CL_FALSE, 0, binCount * frameCount * sizeof(float),
+                                    re, 0, nullptr, nullptr);
+    }
+    if (error == CL_SUCCESS) {
+        error = clEnqueueReadBuffer(pImpl->queue, pImpl->spectralIm, CL_TRUE, 0, binCount * frameCount * sizeof(float),
+                                    im, 0, nullptr, nullptr);
+    }
+    if (error != CL_SUCCESS) {
+        GPU_PLAYER_LOG(GPU, Error, "OpenCL forward transform failed (%d)", static_cast<int>(error));
+        clFinish(pImpl->queue);
+        return false;
+    }
+    return true;
+}
+
+bool OpenCLProcessor::InverseSpectra(const float* re, const float* im, size_t frameSize, size_t frameCount,
+                                     float* frames) {
+    if (!pImpl->initialized || !frames || frameCount == 0 || frameSize < 4 || (frameSize & (frameSize - 1)) != 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(pImpl->queueMutex);
+    if (!pImpl->PrepareSpectra(frameSize, frameCount)) {
+        return false;
+    }
+
+    const size_t binCount = frameSize / 2 + 1;
+    cl_uint size = static_cast<cl_uint>(frameSize);
+    cl_uint bins = static_cast<cl_uint>(binCount);
+    size_t globalSize[2] = {frameSize, frameCount};
+    cl_kernel kernel = pImpl->dftInverseKernel;
+    clSetKernelArg(kernel, 0, sizeof(cl_mem), &pImpl->spectralRe);
+    clSetKernelArg(kernel, 1, sizeof(cl_mem), &pImpl->spectralIm);
+    clSetKernelArg(kernel, 2, sizeof(cl_mem), &pImpl->twiddleCos);
+    clSetKernelArg(kernel, 3, sizeof(cl_mem), &pImpl->twiddleSin);
+    clSetKernelArg(kernel, 4, sizeof(cl_uint), &size);
+    clSetKernelArg(kernel, 5, sizeof(cl_uint), &bins);
+    clSetKernelArg(kernel, 6, sizeof(cl_mem), &pImpl->spectralFrames);
+
+    cl_int error = clEnqueueWriteBuffer(pImpl->queue, pImpl->spectralRe, CL_FALSE, 0,
+                                        binCount * frameCount * sizeof(float), re, 0, nullptr, nullptr);
+    if (error == CL_SUCCESS) {
+        error = clEnqueueWriteBuffer(pImpl->queue, pImpl->spectralIm, CL_FALSE, 0,
+                                     binCount * frameCount * sizeof(float), im, 0, nullptr, nullptr);
+    }
+    if (error == CL_SUCCESS) {
+        error = clEnqueueNDRangeKernel(pImpl->queue, kernel, 2, nullptr, globalSize, nullptr, 0, nullptr, nullptr);
+    }
+    if (error == CL_SUCCESS) {
+        error = clEnqueueReadBuffer(pImpl->queue, pImpl->spectralFrames, CL_TRUE, 0,
+                                    frameSize * frameCount * sizeof(float), frames, 0, nullptr, nullptr);
+    }
+    if (error != CL_SUCCESS) {
+        GPU_PLAYER_LOG(GPU, Error, "OpenCL inverse transform failed (%d)", static_cast<int>(error));
+        clFinish(pImpl->queue);
+        return false;
+    }
+    return true;
+}
+
+#endif // ENABLE_OPENCL
@@ -0,0 +1,76 @@
+#ifndef OPENCL_PROCESSOR_H
+#define OPENCL_PROCESSOR_H
+
+#include "IGPUProcessor.h"
+#include <memory>
+
+/**
+ * @brief IGPUProcessor backed by OpenCL 1.2 kernels
+ *
+ * Picks the first GPU device found by clGetPlatformIDs/clGetDeviceIDs, then
+ * accelerators, then CPU devices, so it also runs on CPU implementations such
+ * as PoCL. Set GPU_PLAYER_OPENCL_DEVICE to a substring of a device name to
+ * choose a device explicitly. The program is built once per processor and its
+ * binary is cached on disk (see CacheDirectory), keyed by source, device and
+ * driver version.
+ *
+ * Jobs are enqueued without blocking on one in-order queue and each in-flight
+ * job owns a persistent device buffer, so the host can prepare the next block
+ * while the device works. Biquad state stays on the device while consecutive
+ * jobs of a stream are in flight. Convolution kernels are evaluated in the
+ * time domain, one work-item per output sample, and spectra as direct DFTs,
+ * one work-item per bin (or per sample for the inverse).
+ *
+ * Only compiled with ENABLE_OPENCL.
+ */
+class OpenCLProcessor : public IGPUProcessor {
+public:
+    /**
+     * @brief Constructor
+     */
+    OpenCLProcessor();
+
+    /**
+     * @brief Destructor, waits for outstanding jobs and releases device resources
+     */
+    ~OpenCLProcessor() override;
+
+    bool Initialize(Backend backend) override;
+    using IGPUProcessor::ProcessAudio;
+    bool ProcessAudio(const float* inputBuffer, float* outputBuffer, size_t bufferSize) override;
+    std::string GetGPUInfo() const override;
+    bool IsAvailable() const override;
+
+    GPUJobFuture SubmitJob(const GPUJobDesc& job) override;
+    void SetMaxJobsInFlight(size_t depth) override;
+    size_t GetMaxJobsInFlight() const override;
+    void WaitIdle() override;
+
+    bool ConvertSampleRate(const float* inputBuffer,
+                           int inputSampleRate,
+                           float* outputBuffer,
+                           int outputSampleRate,
+                           size_t inputSampleCount,
+                           size_t& outputSampleCount) override;
+
+    bool CreateConvolutionKernel(const float* impulseResponse,
+                                 size_t tapCount,
+                                 size_t partitionSize,
+                                 int& kernelId) override;
+    bool ProcessConvolution(int kernelId,
+                            const float* inputBlock,
+                            float* outputBlock,
+                            size_t frameCount) override;
+    void ResetConvolutionKernel(int kernelId) override;
+    void ReleaseConvolutionKernel(int kernelId) override;
+
+    bool ForwardSpectra(const float* frames, size_t frameSize, size_t frameCount, float* re, float* im) override;
+    bool InverseSpectra(const float* re, const float* im, size_t frameSize, size_t frameCount, float* frames) override;
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // OPENCL_PROCESSOR_H
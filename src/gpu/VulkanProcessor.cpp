@@ -0,0 +1,1195 @@
+#include "VulkanProcessor.h"
+
+#ifdef ENABLE_VULKAN
+
+#include <vulkan/vulkan.h>
+#include "VulkanShaders.h"   // Generated from src/gpu/shaders at build time
+#include "core/CacheDirectory.h"
+#include "core/Log.h"
+#include "dsp/Resampler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// Implementation of the Vulkan compute processor
+
+static_assert(sizeof(BiquadCoefficients) == 5 * sizeof(float), "Coefficients are uploaded as 5 floats per stage");
+static_assert(sizeof(BiquadState) == 2 * sizeof(float), "State is uploaded as 2 floats per stage and channel");
+
+// Must match local_size_x in the shaders
+static const uint32_t kWorkgroupSize = 64;
+
+// Smallest maxComputeWorkGroupCount[0] allowed by the spec; the shaders loop over larger ranges
+static const uint32_t kMaxWorkgroups = 65535;
+
+// Storage buffer bindings shared by every shader
+static const uint32_t kBindingCount = 3;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double MicrosecondsBetween(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+uint32_t GroupCount(size_t items) {
+    size_t groups = (items + kWorkgroupSize - 1) / kWorkgroupSize;
+    return static_cast<uint32_t>(std::max<size_t>(1, std::min<size_t>(groups, kMaxWorkgroups)));
+}
+
+size_t NextPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+bool CreateInstance(VkInstance& instance) {
+    VkApplicationInfo application = {};
+    application.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    application.pApplicationName = "GPU Music Player";
+    application.apiVersion = VK_API_VERSION_1_2;
+
+    VkInstanceCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    createInfo.pApplicationInfo = &application;
+    return vkCreateInstance(&createInfo, nullptr, &instance) == VK_SUCCESS;
+}
+
+// Lower is better: real GPUs first, software implementations last
+int DeviceRank(VkPhysicalDeviceType type) {
+    switch (type) {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: return 0;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return 1;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU: return 2;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU: return 3;
+        default: return 4;
+    }
+}
+
+// Pick the best device with Vulkan 1.2, a compute queue and timeline semaphores
+bool SelectDevice(VkInstance instance, VkPhysicalDevice& selected, uint32_t& selectedQueueFamily) {
+    uint32_t deviceCount = 0;
+    if (vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr) != VK_SUCCESS || deviceCount == 0) {
+        return false;
+    }
+    std::vector<VkPhysicalDevice> devices(deviceCount);
+    vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
+
+    const char* nameFilter = std::getenv("GPU_PLAYER_VULKAN_DEVICE");
+    int bestRank = -1;
+    for (VkPhysicalDevice device : devices) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(device, &properties);
+        if (properties.apiVersion < VK_API_VERSION_1_2) {
+            continue;
+        }
+        if (nameFilter && *nameFilter && std::strstr(properties.deviceName, nameFilter) == nullptr) {
+            continue;
+        }
+
+        VkPhysicalDeviceTimelineSemaphoreFeatures timeline = {};
+        timeline.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+        VkPhysicalDeviceFeatures2 features = {};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features.pNext = &timeline;
+        vkGetPhysicalDeviceFeatures2(device, &features);
+        if (!timeline.timelineSemaphore) {
+            continue;
+        }
+
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, families.data());
+        for (uint32_t family = 0; family < familyCount; family++) {
+            if (!(families[family].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+                continue;
+            }
+            int rank = DeviceRank(properties.deviceType);
+            if (bestRank < 0 || rank < bestRank) {
+                bestRank = rank;
+                selected = device;
+                selectedQueueFamily = family;
+            }
+            break;
+        }
+    }
+    return bestRank >= 0;
+}
+
+} // namespace
+
+class VulkanProcessor::Impl {
+public:
+    struct Buffer {
+        VkBuffer handle = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        void* mapped = nullptr;          // Persistently mapped when host visible and coherent
+        VkDeviceSize size = 0;
+        uint64_t serial = 0;             // Unique per allocation; handle values can be reused
+    };
+
+    // Storage buffer used by the shaders, plus a staging buffer when it cannot be mapped
+    struct DeviceArray {
+        Buffer storage;
+        Buffer staging;
+
+        void* Host() const { return storage.mapped ? storage.mapped : staging.mapped; }
+        bool Staged() const { return storage.mapped == nullptr; }
+    };
+
+    enum PipelineIndex {
+        kGainPipeline,
+        kBiquadPipeline,
+        kResamplePipeline,
+        kConvolvePipeline,
+        kPipelineCount
+    };
+
+    // Persistent resources owned by one in-flight job at a time
+    struct Slot {
+        DeviceArray data;
+        Buffer coefficients;
+        VkCommandBuffer commands = VK_NULL_HANDLE;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        uint64_t bound[kBindingCount] = {};   // Serials of the buffers the descriptor set points to
+    };
+
+    // Host-visible copy of a caller's biquad state, used while jobs of the stream are in flight
+    struct StateEntry {
+        Buffer buffer;
+        size_t bytes = 0;
+        size_t pending = 0;
+    };
+
+    struct Job {
+        std::promise<GPUJobResult> promise;
+        GPUJobResult result;
+        float* output = nullptr;
+        size_t bytes = 0;
+        int slot = -1;
+        Slot* slotData = nullptr;
+        BiquadState* statePointer = nullptr;
+        StateEntry* state = nullptr;
+        uint64_t timelineValue = 0;
+        Clock::time_point submitted;
+    };
+
+    struct ConvolutionKernel {
+        DeviceArray taps;
+        DeviceArray history;
+        DeviceArray output;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        uint32_t tapCount = 0;
+        size_t partitionSize = 0;
+        size_t ringSize = 0;
+        uint32_t writePosition = 0;
+        bool historyCleared = true;      // History must be uploaded in full before the next block
+    };
+
+    bool initialized = false;
+    VkInstance instance = VK_NULL_HANDLE;
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties properties = {};
+    VkPhysicalDeviceMemoryProperties memoryProperties = {};
+    uint32_t queueFamily = 0;
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+    VkPipeline pipelines[kPipelineCount] = {};
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer syncCommands = VK_NULL_HANDLE;
+    VkSemaphore timeline = VK_NULL_HANDLE;
+    bool pipelineCacheLoaded = false;
+    std::string pipelineCachePath;
+    std::atomic<uint64_t> nextBufferSerial{1};
+
+    // Serializes command recording, descriptor updates, pool use and queue submission
+    std::mutex queueMutex;
+    uint64_t timelineValue = 0;
+
+    // Protects the in-flight bookkeeping below
+    std::mutex flightMutex;
+    std::condition_variable flightChanged;
+    size_t jobsInFlight = 0;
+    size_t maxJobsInFlight = 4;
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::vector<int> freeSlots;
+    std::map<BiquadState*, StateEntry> states;
+
+    // Submitted jobs in timeline order, completed by the completion thread
+    std::mutex completionMutex;
+    std::condition_variable completionReady;
+    std::deque<Job*> completions;
+    bool stopCompletion = false;
+    std::thread completionThread;
+
+    std::map<int, ConvolutionKernel> convolutionKernels;
+    int nextKernelId = 0;
+
+    ~Impl() {
+        if (device) {
+            vkDeviceWaitIdle(device);
+            for (auto& slot : slots) {
+                DestroyArray(slot->data);
+                DestroyBuffer(slot->coefficients);
+            }
+            for (auto& entry : states) {
+                DestroyBuffer(entry.second.buffer);
+            }
+            for (auto& entry : convolutionKernels) {
+                DestroyKernelBuffers(entry.second);
+            }
+            for (VkPipeline pipeline : pipelines) {
+                if (pipeline) vkDestroyPipeline(device, pipeline, nullptr);
+            }
+            if (pipelineCache) vkDestroyPipelineCache(device, pipelineCache, nullptr);
+            if (pipelineLayout) vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+            if (descriptorSetLayout) vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+            if (descriptorPool) vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+            if (commandPool) vkDestroyCommandPool(device, commandPool, nullptr);
+            if (timeline) vkDestroySemaphore(device, timeline, nullptr);
+            vkDestroyDevice(device, nullptr);
+        }
+        if (instance) {
+            vkDestroyInstance(instance, nullptr);
+        }
+    }
+
+    // First memory type allowed by typeBits that has all flags of one candidate, in order
+    int FindMemoryType(uint32_t typeBits, std::initializer_list<VkMemoryPropertyFlags> candidates) const {
+        for (VkMemoryPropertyFlags flags : candidates) {
+            for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+                if ((typeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & flags) == flags) {
+                    return static_cast<int>(i);
+                }
+            }
+        }
+        return -1;
+    }
+
+    bool CreateBuffer(Buffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage,
+                      std::initializer_list<VkMemoryPropertyFlags> memoryCandidates) {
+        VkBufferCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        createInfo.size = size;
+        createInfo.usage = usage;
+        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vkCreateBuffer(device, &createInfo, nullptr, &buffer.handle) != VK_SUCCESS) {
+            std::cout << "Error: Vulkan buffer creation failed\n";
+            return false;
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(device, buffer.handle, &requirements);
+        int memoryType = FindMemoryType(requirements.memoryTypeBits, memoryCandidates);
+        VkMemoryAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = static_cast<uint32_t>(memoryType);
+        if (memoryType < 0 || vkAllocateMemory(device, &allocateInfo, nullptr, &buffer.memory) != VK_SUCCESS ||
+            vkBindBufferMemory(device, buffer.handle, buffer.memory, 0) != VK_SUCCESS) {
+            GPU_PLAYER_LOG(GPU, Error, "Vulkan allocation of %llu bytes failed", static_cast<unsigned long long>(size));
+            DestroyBuffer(buffer);
+            return false;
+        }
+
+        const VkMemoryPropertyFlags mappable = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        if ((memoryProperties.memoryTypes[memoryType].propertyFlags & mappable) == mappable &&
+            vkMapMemory(device, buffer.memory, 0, VK_WHOLE_SIZE, 0, &buffer.mapped) != VK_SUCCESS) {
+            buffer.mapped = nullptr;
+        }
+        buffer.size = size;
+        buffer.serial = nextBufferSerial++;
+        return true;
+    }
+
+    void DestroyBuffer(Buffer& buffer) {
+        if (buffer.handle) vkDestroyBuffer(device, buffer.handle, nullptr);
+        if (buffer.memory) vkFreeMemory(device, buffer.memory, nullptr);   // Also unmaps
+        buffer = Buffer();
+    }
+
+    // Host-visible buffer the shaders can use directly (small or rarely large data)
+    bool CreateHostBuffer(Buffer& buffer, VkDeviceSize size) {
+        return CreateBuffer(buffer, size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                            {VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT});
+    }
+
+    bool CreateArray(DeviceArray& array, VkDeviceSize size) {
+        const VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                         VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        // Mappable device memory (integrated GPUs, software devices, resizable BAR) avoids the staging copies
+        if (!CreateBuffer(array.storage, size, usage,
+                          {VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                           VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                           0})) {
+            return false;
+        }
+        if (array.Staged() &&
+            !CreateBuffer(array.staging, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                          {VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT})) {
+            DestroyBuffer(array.storage);
+            return false;
+        }
+        return true;
+    }
+
+    void DestroyArray(DeviceArray& array) {
+        DestroyBuffer(array.storage);
+        DestroyBuffer(array.staging);
+    }
+
+    bool EnsureArray(DeviceArray& array, VkDeviceSize size) {
+        if (array.storage.handle && array.storage.size >= size) {
+            return true;
+        }
+        DestroyArray(array);
+        return CreateArray(array, size);
+    }
+
+    bool EnsureHostBuffer(Buffer& buffer, VkDeviceSize size) {
+        if (buffer.handle && buffer.size >= size) {
+            return true;
+        }
+        DestroyBuffer(buffer);
+        return CreateHostBuffer(buffer, size);
+    }
+
+    void DestroyKernelBuffers(ConvolutionKernel& kernel) {
+        DestroyArray(kernel.taps);
+        DestroyArray(kernel.history);
+        DestroyArray(kernel.output);
+    }
+
+    static void RecordBarrier(VkCommandBuffer commands, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                              VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+        VkMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        vkCmdPipelineBarrier(commands, srcStage, dstStage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    static void RecordUpload(VkCommandBuffer commands, const DeviceArray& array, VkDeviceSize offset, VkDeviceSize size) {
+        if (array.Staged() && size > 0) {
+            VkBufferCopy region = {offset, offset, size};
+            vkCmdCopyBuffer(commands, array.staging.handle, array.storage.handle, 1, &region);
+        }
+    }
+
+    static void RecordDownload(VkCommandBuffer commands, const DeviceArray& array, VkDeviceSize size) {
+        if (array.Staged() && size > 0) {
+            VkBufferCopy region = {0, 0, size};
+            vkCmdCopyBuffer(commands, array.storage.handle, array.staging.handle, 1, &region);
+        }
+    }
+
+    // Point the bindings of a descriptor set at buffers, skipping those already bound
+    void BindBuffers(VkDescriptorSet set, uint64_t* bound, const Buffer* const* buffers) {
+        VkDescriptorBufferInfo infos[kBindingCount];
+        VkWriteDescriptorSet writes[kBindingCount];
+        uint32_t writeCount = 0;
+        for (uint32_t binding = 0; binding < kBindingCount; binding++) {
+            if (!buffers[binding] || !buffers[binding]->handle || (bound && bound[binding] == buffers[binding]->serial)) {
+                continue;
+            }
+            infos[writeCount] = {buffers[binding]->handle, 0, VK_WHOLE_SIZE};
+            writes[writeCount] = {};
+            writes[writeCount].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[writeCount].dstSet = set;
+            writes[writeCount].dstBinding = binding;
+            writes[writeCount].descriptorCount = 1;
+            writes[writeCount].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[writeCount].pBufferInfo = &infos[writeCount];
+            writeCount++;
+            if (bound) {
+                bound[binding] = buffers[binding]->serial;
+            }
+        }
+        if (writeCount > 0) {
+            vkUpdateDescriptorSets(device, writeCount, writes, 0, nullptr);
+        }
+    }
+
+    VkDescriptorSet AllocateDescriptorSet() {
+        VkDescriptorSetAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.descriptorPool = descriptorPool;
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts = &descriptorSetLayout;
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        if (vkAllocateDescriptorSets(device, &allocateInfo, &set) != VK_SUCCESS) {
+            std::cout << "Error: Vulkan descriptor set allocation failed\n";
+            return VK_NULL_HANDLE;
+        }
+        return set;
+    }
+
+    VkCommandBuffer AllocateCommandBuffer() {
+        VkCommandBufferAllocateInfo allocateInfo = {};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = commandPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = 1;
+        VkCommandBuffer commands = VK_NULL_HANDLE;
+        if (vkAllocateCommandBuffers(device, &allocateInfo, &commands) != VK_SUCCESS) {
+            std::cout << "Error: Vulkan command buffer allocation failed\n";
+            return VK_NULL_HANDLE;
+        }
+        return commands;
+    }
+
+    static void BeginCommands(VkCommandBuffer commands) {
+        vkResetCommandBuffer(commands, 0);
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(commands, &beginInfo);
+        // Order against every earlier submission: consecutive jobs of a stream share biquad state
+        RecordBarrier(commands,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                      VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT);
+    }
+
+    static void EndCommands(VkCommandBuffer commands) {
+        // Make results visible to the host once the timeline value is signaled
+        RecordBarrier(commands,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+        vkEndCommandBuffer(commands);
+    }
+
+    static void AfterUpload(VkCommandBuffer commands) {
+        RecordBarrier(commands, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    }
+
+    static void BeforeDownload(VkCommandBuffer commands) {
+        RecordBarrier(commands, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+    }
+
+    void RecordDispatch(VkCommandBuffer commands, PipelineIndex pipeline, VkDescriptorSet set,
+                        const void* pushConstants, uint32_t pushSize, uint32_t groups) {
+        vkCmdBindPipeline(commands, VK_PIPELINE_BIND_POINT_COMPUTE, pipelines[pipeline]);
+        vkCmdBindDescriptorSets(commands, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &set, 0, nullptr);
+        vkCmdPushConstants(commands, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, pushSize, pushConstants);
+        vkCmdDispatch(commands, groups, 1, 1);
+    }
+
+    // Submit commands that signal the next timeline value (queueMutex must be held)
+    bool Submit(VkCommandBuffer commands, uint64_t& signalValue) {
+        signalValue = timelineValue + 1;
+        VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.signalSemaphoreValueCount = 1;
+        timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commands;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &timeline;
+        VkResult result = vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+        if (result != VK_SUCCESS) {
+            GPU_PLAYER_LOG(GPU, Error, "vkQueueSubmit failed (%d)", static_cast<int>(result));
+            return false;
+        }
+        timelineValue = signalValue;
+        return true;
+    }
+
+    bool WaitForValue(uint64_t value) {
+        VkSemaphoreWaitInfo waitInfo = {};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &timeline;
+        waitInfo.pValues = &value;
+        return vkWaitSemaphores(device, &waitInfo, UINT64_MAX) == VK_SUCCESS;
+    }
+
+    // Record, submit and wait for a one-off command buffer (queueMutex must be held)
+    template <typename Record>
+    bool RunSync(Record record) {
+        BeginCommands(syncCommands);
+        record(syncCommands);
+        EndCommands(syncCommands);
+        uint64_t value = 0;
+        return Submit(syncCommands, value) && WaitForValue(value);
+    }
+
+    VkShaderModule CreateShaderModule(const uint32_t* code, size_t size) {
+        VkShaderModuleCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        createInfo.codeSize = size;
+        createInfo.pCode = code;
+        VkShaderModule module = VK_NULL_HANDLE;
+        if (vkCreateShaderModule(device, &createInfo, nullptr, &module) != VK_SUCCESS) {
+            std::cout << "Error: vkCreateShaderModule failed\n";
+            return VK_NULL_HANDLE;
+        }
+        return module;
+    }
+
+    bool CreatePipelines() {
+        VkDescriptorSetLayoutBinding bindings[kBindingCount] = {};
+        for (uint32_t binding = 0; binding < kBindingCount; binding++) {
+            bindings[binding].binding = binding;
+            bindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[binding].descriptorCount = 1;
+            bindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+        VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = kBindingCount;
+        layoutInfo.pBindings = bindings;
+        if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS) {
+            std::cout << "Error: vkCreateDescriptorSetLayout failed\n";
+            return false;
+        }
+
+        VkPushConstantRange pushRange = {VK_SHADER_STAGE_COMPUTE_BIT, 0, 32};
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushRange;
+        if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+            std::cout << "Error: vkCreatePipelineLayout failed\n";
+            return false;
+        }
+
+        // Load the pipeline cache from an earlier run; the driver rejects data from other devices or versions
+        std::ostringstream uuid;
+        for (uint8_t byte : properties.pipelineCacheUUID) {
+            uuid << static_cast<int>(byte) << ".";
+        }
+        std::string cacheDirectory = CacheDirectory::Get("vulkan");
+        if (!cacheDirectory.empty()) {
+            pipelineCachePath = cacheDirectory + "/" + CacheDirectory::HashKey(std::string(properties.deviceName) + "|" +
+                                                                              uuid.str()) + ".bin";
+        }
+        std::vector<char> cacheData;
+        if (!pipelineCachePath.empty()) {
+            std::ifstream cached(pipelineCachePath, std::ios::binary);
+            cacheData.assign(std::istreambuf_iterator<char>(cached), std::istreambuf_iterator<char>());
+        }
+        VkPipelineCacheCreateInfo cacheInfo = {};
+        cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        cacheInfo.initialDataSize = cacheData.size();
+        cacheInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+        if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS) {
+            cacheInfo.initialDataSize = 0;
+            cacheInfo.pInitialData = nullptr;
+            if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS) {
+                pipelineCache = VK_NULL_HANDLE;
+            }
+        } else {
+            pipelineCacheLoaded = !cacheData.empty();
+        }
+
+        struct ShaderCode {
+            const uint32_t* code;
+            size_t size;
+        };
+        const ShaderCode shaders[kPipelineCount] = {
+            {kGainSpirv, sizeof(kGainSpirv)},
+            {kBiquadCascadeSpirv, sizeof(kBiquadCascadeSpirv)},
+            {kResamplePolyphaseSpirv, sizeof(kResamplePolyphaseSpirv)},
+            {kConvolveDirectSpirv, sizeof(kConvolveDirectSpirv)},
+        };
+        for (int i = 0; i < kPipelineCount; i++) {
+            VkShaderModule module = CreateShaderModule(shaders[i].code, shaders[i].size);
+            if (!module) {
+                return false;
+            }
+            VkComputePipelineCreateInfo pipelineInfo = {};
+            pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+            pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+            pipelineInfo.stage.module = module;
+            pipelineInfo.stage.pName = "main";
+            pipelineInfo.layout = pipelineLayout;
+            VkResult result = vkCreateComputePipelines(device, pipelineCache, 1, &pipelineInfo, nullptr, &pipelines[i]);
+            vkDestroyShaderModule(device, module, nullptr);
+            if (result != VK_SUCCESS) {
+                std::cout << "Error: vkCreateComputePipelines failed (" << result << ")\n";
+                return false;
+            }
+        }
+
+        // Store the cache for the next run; failure here only costs recompilation
+        size_t cacheSize = 0;
+        if (pipelineCache && !pipelineCachePath.empty() &&
+            vkGetPipelineCacheData(device, pipelineCache, &cacheSize, nullptr) == VK_SUCCESS && cacheSize > 0) {
+            std::vector<char> data(cacheSize);
+            if (vkGetPipelineCacheData(device, pipelineCache, &cacheSize, data.data()) == VK_SUCCESS) {
+                std::ofstream cached(pipelineCachePath, std::ios::binary);
+                cached.write(data.data(), cacheSize);
+            }
+        }
+        return true;
+    }
+
+    bool Setup() {
+        if (!CreateInstance(instance)) {
+            std::cout << "Error: Vulkan 1.2 instance creation failed\n";
+            return false;
+        }
+        if (!SelectDevice(instance, physicalDevice, queueFamily)) {
+            std::cout << "Error: No Vulkan 1.2 device with compute and timeline semaphores found\n";
+            return false;
+        }
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+        const float priority = 1.0f;
+        VkDeviceQueueCreateInfo queueInfo = {};
+        queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queueInfo.queueFamilyIndex = queueFamily;
+        queueInfo.queueCount = 1;
+        queueInfo.pQueuePriorities = &priority;
+
+        VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeature = {};
+        timelineFeature.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+        timelineFeature.timelineSemaphore = 1;
+        VkDeviceCreateInfo deviceInfo = {};
+        deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        deviceInfo.pNext = &timelineFeature;
+        deviceInfo.queueCreateInfoCount = 1;
+        deviceInfo.pQueueCreateInfos = &queueInfo;
+        if (vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device) != VK_SUCCESS) {
+            std::cout << "Error: vkCreateDevice failed\n";
+            return false;
+        }
+        vkGetDeviceQueue(device, queueFamily, 0, &queue);
+
+        VkSemaphoreTypeCreateInfo semaphoreType = {};
+        semaphoreType.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        semaphoreType.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        semaphoreType.initialValue = 0;
+        VkSemaphoreCreateInfo semaphoreInfo = {};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &semaphoreType;
+        if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &timeline) != VK_SUCCESS) {
+            std::cout << "Error: Timeline semaphore creation failed\n";
+            return false;
+        }
+
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = queueFamily;
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS) {
+            std::cout << "Error: vkCreateCommandPool failed\n";
+            return false;
+        }
+
+        const uint32_t maxSets = 256;
+        VkDescriptorPoolSize poolSize = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, maxSets * kBindingCount};
+        VkDescriptorPoolCreateInfo descriptorPoolInfo = {};
+        descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        descriptorPoolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+        descriptorPoolInfo.maxSets = maxSets;
+        descriptorPoolInfo.poolSizeCount = 1;
+        descriptorPoolInfo.pPoolSizes = &poolSize;
+        if (vkCreateDescriptorPool(device, &descriptorPoolInfo, nullptr, &descriptorPool) != VK_SUCCESS) {
+            std::cout << "Error: vkCreateDescriptorPool failed\n";
+            return false;
+        }
+
+        if (!CreatePipelines()) {
+            return false;
+        }
+        syncCommands = AllocateCommandBuffer();
+        if (!syncCommands) {
+            return false;
+        }
+        completionThread = std::thread(&Impl::CompletionLoop, this);
+        return true;
+    }
+
+    void StopCompletionThread() {
+        if (!completionThread.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(completionMutex);
+            stopCompletion = true;
+        }
+        completionReady.notify_all();
+        completionThread.join();
+    }
+
+    // Waits for submitted jobs in timeline order and copies their results back
+    void CompletionLoop() {
+        for (;;) {
+            Job* job = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(completionMutex);
+                completionReady.wait(lock, [this] { return stopCompletion || !completions.empty(); });
+                if (completions.empty()) {
+                    return;
+                }
+                job = completions.front();
+                completions.pop_front();
+            }
+
+            bool success = WaitForValue(job->timelineValue);
+            auto downloadStart = Clock::now();
+            job->result.computeMicroseconds = MicrosecondsBetween(job->submitted, downloadStart);
+            if (success) {
+                std::memcpy(job->output, job->slotData->data.Host(), job->bytes);
+                if (job->state) {
+                    // Newer jobs of the stream may already have advanced the device copy; the
+                    // caller's state is exact once the stream's last job has completed
+                    std::memcpy(job->statePointer, job->state->buffer.mapped, job->state->bytes);
+                }
+            }
+            job->result.downloadMicroseconds = MicrosecondsBetween(downloadStart, Clock::now());
+            FinishJob(job, success);
+        }
+    }
+
+    void FinishJob(Job* job, bool success) {
+        job->result.success = success;
+        job->promise.set_value(job->result);
+        {
+            // Notify under the lock: the processor may be destroyed as soon as it is released
+            std::lock_guard<std::mutex> lock(flightMutex);
+            freeSlots.push_back(job->slot);
+            if (job->state) {
+                job->state->pending--;
+            }
+            jobsInFlight--;
+            flightChanged.notify_all();
+        }
+        delete job;
+    }
+};
+
+VulkanProcessor::VulkanProcessor() : pImpl(std::make_unique<Impl>()) {
+}
+
+VulkanProcessor::~VulkanProcessor() {
+    if (pImpl->initialized) {
+        WaitIdle();
+    }
+    pImpl->StopCompletionThread();
+}
+
+bool VulkanProcessor::Initialize(Backend backend) {
+    if (backend != Backend::VULKAN) return false;
+    if (pImpl->initialized) return true;
+
+    if (!pImpl->Setup()) {
+        return false;
+    }
+    pImpl->initialized = true;
+    std::cout << "Initializing Vulkan processor on " << pImpl->properties.deviceName << "\n";
+    return true;
+}
+
+bool VulkanProcessor::ProcessAudio(const float* inputBuffer, float* outputBuffer, size_t bufferSize) {
+    GPUJobDesc job;
+    job.operation = GPUOperation::Copy;
+    job.input = ConstAudioBufferView(inputBuffer, bufferSize, 1);
+    job.output = AudioBufferView(outputBuffer, bufferSize, 1);
+    return SubmitJob(job).get().success;
+}
+
+std::string VulkanProcessor::GetGPUInfo() const {
+    if (!pImpl->initialized) {
+        return "Vulkan (not initialized)";
+    }
+    const VkPhysicalDeviceProperties& properties = pImpl->properties;
+    const char* type = "Other";
+    switch (properties.deviceType) {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: type = "Discrete GPU"; break;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: type = "Integrated GPU"; break;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU: type = "Virtual GPU"; break;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU: type = "CPU"; break;
+        default: break;
+    }
+
+    VkDeviceSize deviceLocal = 0;
+    for (uint32_t i = 0; i < pImpl->memoryProperties.memoryHeapCount; i++) {
+        if (pImpl->memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            deviceLocal += pImpl->memoryProperties.memoryHeaps[i].size;
+        }
+    }
+
+    std::ostringstream info;
+    info << "Vulkan " << type << ": " << properties.deviceName << "\n"
+         << "- API version: " << VK_API_VERSION_MAJOR(properties.apiVersion) << "."
+         << VK_API_VERSION_MINOR(properties.apiVersion) << "." << VK_API_VERSION_PATCH(properties.apiVersion) << "\n"
+         << "- Device memory: " << (deviceLocal >> 20) << " MB\n"
+         << "- Pipeline cache: " << (pImpl->pipelineCacheLoaded ? "loaded from disk" : "created") << "\n"
+         << "- Jobs in flight: up to " << GetMaxJobsInFlight();
+    return info.str();
+}
+
+bool VulkanProcessor::IsAvailable() const {
+    if (pImpl->initialized) {
+        return true;
+    }
+    VkInstance instance = VK_NULL_HANDLE;
+    if (!CreateInstance(instance)) {
+        return false;
+    }
+    VkPhysicalDevice device = VK_NULL_HANDLE;
+    uint32_t queueFamily = 0;
+    bool found = SelectDevice(instance, device, queueFamily);
+    vkDestroyInstance(instance, nullptr);
+    return found;
+}
+
+GPUJobFuture VulkanProcessor::SubmitJob(const GPUJobDesc& desc) {
+    if (!pImpl->initialized) {
+        std::cout << "Error: Vulkan processor is not initialized\n";
+        return GPUJobs::MakeReadyFuture(GPUJobResult());
+    }
+    if (!GPUJobs::Validate(desc)) {
+        return GPUJobs::MakeReadyFuture(GPUJobResult());
+    }
+
+    Impl::Job* job = new Impl::Job();
+    job->output = desc.output.Data();
+    job->bytes = desc.input.ByteSize();
+    job->submitted = Clock::now();
+    GPUJobFuture future = job->promise.get_future().share();
+
+    bool newSlot = false;
+    bool uploadState = false;
+    {
+        std::unique_lock<std::mutex> lock(pImpl->flightMutex);
+        pImpl->flightChanged.wait(lock, [this] { return pImpl->jobsInFlight < pImpl->maxJobsInFlight; });
+        pImpl->jobsInFlight++;
+        if (pImpl->freeSlots.empty()) {
+            pImpl->slots.push_back(std::make_unique<Impl::Slot>());
+            job->slot = static_cast<int>(pImpl->slots.size()) - 1;
+            newSlot = true;
+        } else {
+            job->slot = pImpl->freeSlots.back();
+            pImpl->freeSlots.pop_back();
+        }
+        job->slotData = pImpl->slots[job->slot].get();
+
+        if (desc.operation == GPUOperation::BiquadCascade) {
+            // Drop copies of streams that have no job in flight
+            for (auto it = pImpl->states.begin(); it != pImpl->states.end();) {
+                if (it->second.pending == 0 && it->first != desc.biquadState) {
+                    pImpl->DestroyBuffer(it->second.buffer);
+                    it = pImpl->states.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            Impl::StateEntry& state = pImpl->states[desc.biquadState];
+            const size_t stateBytes = desc.biquadCount * desc.input.Channels() * sizeof(BiquadState);
+            // With earlier jobs of the stream still in flight the device copy is newer than the caller's
+            uploadState = state.pending == 0;
+            if (uploadState && state.bytes != stateBytes) {
+                pImpl->DestroyBuffer(state.buffer);
+                state.bytes = pImpl->CreateHostBuffer(state.buffer, stateBytes) ? stateBytes : 0;
+            }
+            state.pending++;
+            job->state = &state;
+            job->statePointer = desc.biquadState;
+        }
+    }
+    job->result.queueMicroseconds = MicrosecondsBetween(job->submitted, Clock::now());
+
+    Impl::Slot& slot = *job->slotData;
+    bool submitted = false;
+    {
+        std::lock_guard<std::mutex> lock(pImpl->queueMutex);
+        bool ready = true;
+        if (newSlot) {
+            slot.commands = pImpl->AllocateCommandBuffer();
+            slot.descriptorSet = pImpl->AllocateDescriptorSet();
+            ready = slot.commands && slot.descriptorSet;
+        }
+        const size_t coefficientBytes = desc.biquadCount * sizeof(BiquadCoefficients);
+        ready = ready && pImpl->EnsureArray(slot.data, job->bytes);
+        if (desc.operation == GPUOperation::BiquadCascade) {
+            ready = ready && job->state->bytes > 0 && pImpl->EnsureHostBuffer(slot.coefficients, coefficientBytes);
+        }
+
+        if (ready) {
+            // Host side of the upload; the device reads mapped memory or copies from staging
+            auto uploadStart = Clock::now();
+            std::memcpy(slot.data.Host(), desc.input.Data(), job->bytes);
+            if (desc.operation == GPUOperation::BiquadCascade) {
+                std::memcpy(slot.coefficients.mapped, desc.biquads, coefficientBytes);
+                if (uploadState) {
+                    std::memcpy(job->state->buffer.mapped, desc.biquadState, job->state->bytes);
+                }
+            }
+            job->result.uploadMicroseconds = MicrosecondsBetween(uploadStart, Clock::now());
+
+            const Impl::Buffer* buffers[kBindingCount] = {
+                &slot.data.storage,
+                &slot.coefficients,
+                job->state ? &job->state->buffer : nullptr
+            };
+            pImpl->BindBuffers(slot.descriptorSet, slot.bound, buffers);
+
+            VkCommandBuffer commands = slot.commands;
+            Impl::BeginCommands(commands);
+            Impl::RecordUpload(commands, slot.data, 0, job->bytes);
+            Impl::AfterUpload(commands);
+            if (desc.operation == GPUOperation::Gain) {
+                struct { float gain; uint32_t count; } push = {desc.gain, static_cast<uint32_t>(desc.input.SampleCount())};
+                pImpl->RecordDispatch(commands, Impl::kGainPipeline, slot.descriptorSet, &push, sizeof(push),
+                                      GroupCount(desc.input.SampleCount()));
+            } else if (desc.operation == GPUOperation::BiquadCascade) {
+                struct { uint32_t stages, channels, frames; } push = {
+                    static_cast<uint32_t>(desc.biquadCount),
+                    static_cast<uint32_t>(desc.input.Channels()),
+                    static_cast<uint32_t>(desc.input.Frames())
+                };
+                pImpl->RecordDispatch(commands, Impl::kBiquadPipeline, slot.descriptorSet, &push, sizeof(push),
+                                      GroupCount(desc.input.Channels()));
+            }
+            Impl::BeforeDownload(commands);
+            Impl::RecordDownload(commands, slot.data, job->bytes);
+            Impl::EndCommands(commands);
+
+            job->submitted = Clock::now();
+            submitted = pImpl->Submit(commands, job->timelineValue);
+            if (submitted) {
+                // Queued under queueMutex so completions stay in timeline order
+                std::lock_guard<std::mutex> completionLock(pImpl->completionMutex);
+                pImpl->completions.push_back(job);
+            }
+        }
+    }
+
+    if (submitted) {
+        pImpl->completionReady.notify_one();
+    } else {
+        pImpl->FinishJob(job, false);
+    }
+    return future;
+}
+
+void VulkanProcessor::SetMaxJobsInFlight(size_t depth) {
+    std::lock_guard<std::mutex> lock(pImpl->flightMutex);
+    pImpl->maxJobsInFlight = std::max<size_t>(depth, 1);
+    pImpl->flightChanged.notify_all();
+}
+
+size_t VulkanProcessor::GetMaxJobsInFlight() const {
+    std::lock_guard<std::mutex> lock(pImpl->flightMutex);
+    return pImpl->maxJobsInFlight;
+}
+
+void VulkanProcessor::WaitIdle() {
+    std::unique_lock<std::mutex> lock(pImpl->flightMutex);
+    pImpl->flightChanged.wait(lock, [this] { return pImpl->jobsInFlight == 0; });
+}
+
+bool VulkanProcessor::ConvertSampleRate(const float* inputBuffer,
+                                        int inputSampleRate,
+                                        float* outputBuffer,
+                                        int outputSampleRate,
+                                        size_t inputSampleCount,
+                                        size_t& outputSampleCount) {
+    if (!pImpl->initialized || !inputBuffer || !outputBuffer || inputSampleCount == 0) {
+        return false;
+    }
+
+    // Reuse the CPU resampler's filter design so both paths produce the same output
+    PolyphaseResampler design;
+    if (!design.Initialize(inputSampleRate, outputSampleRate, 1)) {
+        std::cout << "Error: Unsupported rate pair " << inputSampleRate << " -> " << outputSampleRate << "\n";
+        return false;
+    }
+    const std::vector<float>& table = design.GetPhaseTable();
+    const size_t outputCount = (inputSampleCount * design.GetPhaseCount() + design.GetInputStep() - 1) / design.GetInputStep();
+    if (outputSampleCount < outputCount) {
+        std::cout << "Error: Resampler output buffer holds " << outputSampleCount
+                  << " samples, " << outputCount << " needed\n";
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(pImpl->queueMutex);
+    Impl::DeviceArray input, phaseTable, output;
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    bool success = pImpl->CreateArray(input, inputSampleCount * sizeof(float)) &&
+                   pImpl->CreateArray(phaseTable, table.size() * sizeof(float)) &&
+                   pImpl->CreateArray(output, outputCount * sizeof(float)) &&
+                   (set = pImpl->AllocateDescriptorSet()) != VK_NULL_HANDLE;
+
+    if (success) {
+        std::memcpy(input.Host(), inputBuffer, inputSampleCount * sizeof(float));
+        std::memcpy(phaseTable.Host(), table.data(), table.size() * sizeof(float));
+        const Impl::Buffer* buffers[kBindingCount] = {&input.storage, &phaseTable.storage, &output.storage};
+        pImpl->BindBuffers(set, nullptr, buffers);
+
+        struct { uint32_t inputCount, tapCount, phaseCount, inputStep, outputCount; } push = {
+            static_cast<uint32_t>(inputSampleCount),
+            static_cast<uint32_t>(design.GetTapCount()),
+            static_cast<uint32_t>(design.GetPhaseCount()),
+            static_cast<uint32_t>(design.GetInputStep()),
+            static_cast<uint32_t>(outputCount)
+        };
+        success = pImpl->RunSync([&](VkCommandBuffer commands) {
+            Impl::RecordUpload(commands, input, 0, inputSampleCount * sizeof(float));
+            Impl::RecordUpload(commands, phaseTable, 0, table.size() * sizeof(float));
+            Impl::AfterUpload(commands);
+            pImpl->RecordDispatch(commands, Impl::kResamplePipeline, set, &push, sizeof(push), GroupCount(outputCount));
+            Impl::BeforeDownload(commands);
+            Impl::RecordDownload(commands, output, outputCount * sizeof(float));
+        });
+        if (success) {
+            std::memcpy(outputBuffer, output.Host(), outputCount * sizeof(float));
+            outputSampleCount = outputCount;
+        } else {
+            std::cout << "Error: Vulkan resampling failed\n";
+        }
+    }
+
+    if (set) vkFreeDescriptorSets(pImpl->device, pImpl->descriptorPool, 1, &set);
+    pImpl->DestroyArray(input);
+    pImpl->DestroyArray(phaseTable);
+    pImpl->DestroyArray(output);
+    return success;
+}
+
+bool VulkanProcessor::CreateConvolutionKernel(const float* impulseResponse,
+                                              size_t tapCount,
+                                              size_t partitionSize,
+                                              int& kernelId) {
+    if (!pImpl->initialized || !impulseResponse || tapCount == 0 || partitionSize == 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(pImpl->queueMutex);
+    Impl::ConvolutionKernel kernel;
+    kernel.tapCount = static_cast<uint32_t>(tapCount);
+    kernel.partitionSize = partitionSize;
+    kernel.ringSize = NextPowerOfTwo(tapCount + partitionSize);
+    if (!pImpl->CreateArray(kernel.taps, tapCount * sizeof(float)) ||
+        !pImpl->CreateArray(kernel.history, kernel.ringSize * sizeof(float)) ||
+        !pImpl->CreateArray(kernel.output, partitionSize * sizeof(float)) ||
+        !(kernel.descriptorSet = pImpl->AllocateDescriptorSet())) {
+        pImpl->DestroyKernelBuffers(kernel);
+        return false;
+    }
+
+    std::memcpy(kernel.taps.Host(), impulseResponse, tapCount * sizeof(float));
+    std::memset(kernel.history.Host(), 0, kernel.ringSize * sizeof(float));
+    const Impl::Buffer* buffers[kBindingCount] = {&kernel.history.storage, &kernel.taps.storage, &kernel.output.storage};
+    pImpl->BindBuffers(kernel.descriptorSet, nullptr, buffers);
+
+    if (kernel.taps.Staged() && !pImpl->RunSync([&](VkCommandBuffer commands) {
+            Impl::RecordUpload(commands, kernel.taps, 0, tapCount * sizeof(float));
+        })) {
+        std::cout << "Error: Vulkan convolution kernel upload failed\n";
+        vkFreeDescriptorSets(pImpl->device, pImpl->descriptorPool, 1, &kernel.descriptorSet);
+        pImpl->DestroyKernelBuffers(kernel);
+        return false;
+    }
+
+    kernelId = pImpl->nextKernelId++;
+    pImpl->convolutionKernels[kernelId] = kernel;
+    return true;
+}
+
+bool VulkanProcessor::ProcessConvolution(int kernelId,
+                                         const float* inputBlock,
+                                         float* outputBlock,
+                                         size_t frameCount) {
+    std::lock_guard<std::mutex> lock(pImpl->queueMutex);
+    auto it = pImpl->convolutionKernels.find(kernelId);
+    if (it == pImpl->convolutionKernels.end() || frameCount != it->second.partitionSize) {
+        return false;
+    }
+    Impl::ConvolutionKernel& kernel = it->second;
+
+    // Append the block to the history ring, in two parts if it wraps
+    const size_t mask = kernel.ringSize - 1;
+    const size_t start = kernel.writePosition & mask;
+    const size_t firstPart = std::min(frameCount, kernel.ringSize - start);
+    float* history = static_cast<float*>(kernel.history.Host());
+    std::memcpy(history + start, inputBlock, firstPart * sizeof(float));
+    std::memcpy(history, inputBlock + firstPart, (frameCount - firstPart) * sizeof(float));
+    kernel.writePosition += static_cast<uint32_t>(frameCount);
+
+    struct { uint32_t historyMask, blockEnd, tapCount, frames; } push = {
+        static_cast<uint32_t>(mask), kernel.writePosition, kernel.tapCount, static_cast<uint32_t>(frameCount)
+    };
+    bool success = pImpl->RunSync([&](VkCommandBuffer commands) {
+        if (kernel.historyCleared) {
+            Impl::RecordUpload(commands, kernel.history, 0, kernel.ringSize * sizeof(float));
+        } else {
+            Impl::RecordUpload(commands, kernel.history, start * sizeof(float), firstPart * sizeof(float));
+            Impl::RecordUpload(commands, kernel.history, 0, (frameCount - firstPart) * sizeof(float));
+        }
+        Impl::AfterUpload(commands);
+        pImpl->RecordDispatch(commands, Impl::kConvolvePipeline, kernel.descriptorSet, &push, sizeof(push),
+                              GroupCount(frameCount));
+        Impl::BeforeDownload(commands);
+        Impl::RecordDownload(commands, kernel.output, frameCount * sizeof(float));
+    });
+    if (!success) {
+        std::cout << "Error: Vulkan convolution failed\n";
+        return false;
+    }
+    kernel.historyCleared = false;
+    std::memcpy(outputBlock, kernel.output.Host(), frameCount * sizeof(float));
+    return true;
+}
+
+void VulkanProcessor::ResetConvolutionKernel(int kernelId) {
+    std::lock_guard<std::mutex> lock(pImpl->queueMutex);
+    auto it = pImpl->convolutionKernels.find(kernelId);
+    if (it == pImpl->convolutionKernels.end()) {
+        return;
+    }
+    std::memset(it->second.history.Host(), 0, it->second.ringSize * sizeof(float));
+    it->second.writePosition = 0;
+    it->second.historyCleared = true;
+}
+
+void VulkanProcessor::ReleaseConvolutionKernel(int kernelId) {
+    std::lock_guard<std::mutex> lock(pImpl->queueMutex);
+    auto it = pImpl->convolutionKernels.find(kernelId);
+    if (it == pImpl->convolutionKernels.end()) {
+        return;
+    }
+    // Synchronous operations have completed, so the buffers are idle
+    vkFreeDescriptorSets(pImpl->device, pImpl->descriptorPool, 1, &it->second.descriptorSet);
+    pImpl->DestroyKernelBuffers(it->second);
+    pImpl->convolutionKernels.erase(it);
+}
+
+#endif // ENABLE_VULKAN
@@ -0,0 +1,74 @@
+#ifndef VULKAN_PROCESSOR_H
+#define VULKAN_PROCESSOR_H
+
+#include "IGPUProcessor.h"
+#include <memory>
+
+/**
+ * @brief IGPUProcessor backed by Vulkan 1.2 compute shaders
+ *
+ * Picks a discrete GPU, then an integrated or virtual GPU, then a CPU device,
+ * so it also runs on software implementations such as lavapipe or
+ * SwiftShader. Set GPU_PLAYER_VULKAN_DEVICE to a substring of a device name
+ * to choose a device explicitly. The device must support timeline semaphores.
+ *
+ * The shaders in src/gpu/shaders are compiled to SPIR-V at build time. The
+ * pipeline cache is saved on disk (see CacheDirectory), so later runs skip
+ * most of the driver's shader compilation.
+ *
+ * Each in-flight job owns a slot with persistent buffers, a descriptor set
+ * and a command buffer. Submissions signal one timeline semaphore with
+ * increasing values, and a completion thread waits on those values in order
+ * to copy results back and complete the futures. When device memory cannot be
+ * mapped, data goes through host-visible staging buffers.
+ *
+ * Only compiled with ENABLE_VULKAN.
+ */
+class VulkanProcessor : public IGPUProcessor {
+public:
+    /**
+     * @brief Constructor
+     */
+    VulkanProcessor();
+
+    /**
+     * @brief Destructor, waits for outstanding jobs and releases device resources
+     */
+    ~VulkanProcessor() override;
+
+    bool Initialize(Backend backend) override;
+    using IGPUProcessor::ProcessAudio;
+    bool ProcessAudio(const float* inputBuffer, float* outputBuffer, size_t bufferSize) override;
+    std::string GetGPUInfo() const override;
+    bool IsAvailable() const override;
+
+    GPUJobFuture SubmitJob(const GPUJobDesc& job) override;
+    void SetMaxJobsInFlight(size_t depth) override;
+    size_t GetMaxJobsInFlight() const override;
+    void WaitIdle() override;
+
+    bool ConvertSampleRate(const float* inputBuffer,
+                           int inputSampleRate,
+                           float* outputBuffer,
+                           int outputSampleRate,
+                           size_t inputSampleCount,
+                           size_t& outputSampleCount) override;
+
+    bool CreateConvolutionKernel(const float* impulseResponse,
+                                 size_t tapCount,
+                                 size_t partitionSize,
+                                 int& kernelId) override;
+    bool ProcessConvolution(int kernelId,
+                            const float* inputBlock,
+                            float* outputBlock,
+                            size_t frameCount) override;
+    void ResetConvolutionKernel(int kernelId) override;
+    void ReleaseConvolutionKernel(int kernelId) override;
+
+private:
+    // Private implementation details
+    class Impl;
+    std::unique_ptr<Impl> pImpl;
+};
+
+#endif // VULKAN_PROCESSOR_H
@@ -2,6 +2,8 @@
 #include "CommandLineInterface.h"  // Fixed include path
 #include "IGPUProcessor.h"          // Include GPU processor interface
 #include "gpu/GPUProcessorFactory.h" // Include GPU processor factory
+#include "gpu/BackendAutotuner.h"    // Measured backend selection
+#include "core/Log.h"                // Asynchronous logging
 #include <iostream>
 #include <string>
 #include <memory>                   // Include memory for std::move
@@ -11,6 +13,9 @@
 int main(int argc, char* argv[]) {
     std::cout << "GPU Music Player v1.0\n";
 
+    // Messages from the playback and worker threads are written by a background thread
+    Log::Start();
+
     // Create an instance of the audio engine
     AudioEngine player;
 
@@ -32,14 +37,19 @@ int main(int argc, char* argv[]) {
                 case IGPUProcessor::Backend::VULKAN:
                     std::cout << "Vulkan ";
                     break;
+                case IGPUProcessor::Backend::CPU:
+                    std::cout << "CPU ";
+                    break;
             }
             if (i < supportedBackends.size() - 1) std::cout << ", ";
         }
         std::cout << "\n";
     }
 
-    // Auto-detect the best GPU processor available
-    auto bestBackend = GPUProcessorFactory::AutoDetectBestGPU();
+    // Measure the available backends; results are cached after the first run
+    BackendAutotuner autotuner;
+    autotuner.Tune();
+    auto bestBackend = autotuner.ChooseDefault();
 
     std::cout << "Auto-selected GPU backend: ";
     switch(bestBackend) {
@@ -47,14 +57,23 @@ int main(int argc, char* argv[]) {
             std::cout << "CUDA (NVIDIA GPU)\n";
             break;
         case IGPUProcessor::Backend::OPENCL:
-            std::cout << "OpenCL (AMD/Intel GPU)\n";
+            std::cout << "OpenCL\n";
             break;
         case IGPUProcessor::Backend::VULKAN:
             std::cout << "Vulkan (Universal GPU API)\n";
             break;
+        case IGPUProcessor::Backend::CPU:
+            std::cout << "CPU reference (no GPU)\n";
+            break;
     }
 
     auto gpuProcessor = GPUProcessorFactory::CreateProcessor(bestBackend);
+    if (!gpuProcessor || !gpuProcessor->Initialize(bestBackend)) {
+        std::cout << "GPU backend failed to initialize, using the CPU reference processor\n";
+        gpuProcessor = GPUProcessorFactory::CreateProcessor(IGPUProcessor::Backend::CPU);
+        gpuProcessor->Initialize(IGPUProcessor::Backend::CPU);
+    }
+    player.SetConvolutionOffloadSize(autotuner.GetConvolutionOffloadSize(bestBackend));
     if (!player.Initialize(std::move(gpuProcessor))) {
         std::cout << "Failed to initialize audio engine\n";
         return 1;
@@ -86,6 +105,8 @@ int main(int argc, char* argv[]) {
     std::string command;
 
     while (true) {
+        // Show what the background threads logged before prompting again
+        Log::Flush();
         std::cout << "> ";
         if (!std::getline(std::cin, command)) break;
 
@@ -98,5 +119,6 @@ int main(int argc, char* argv[]) {
     }
 
     std::cout << "Exiting GPU Music Player...\n";
+    Log::Stop();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "gpu/CPUReferenceProcessor.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Checks the buffer views: interleaved and planar indexing, frame ranges and
+// their contiguity, alignment, PCM byte views, and that processors accept
+// views of either layout in place while rejecting ones they cannot transfer
+// as a single run of samples.
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+static bool TestLayouts() {
+    // Three frames of stereo, sample value = 10 * frame + channel
+    std::vector<float> interleaved = {0, 1, 10, 11, 20, 21};
+    std::vector<float> planar = {0, 10, 20, 1, 11, 21};
+    AudioBufferView a(interleaved.data(), 3, 2);
+    AudioBufferView p(planar.data(), 3, 2, SampleLayout::Planar);
+
+    bool same = true;
+    for (size_t frame = 0; frame < 3; frame++) {
+        for (int channel = 0; channel < 2; channel++) {
+            same &= a.At(frame, channel) == p.At(frame, channel) && a.At(frame, channel) == 10.0f * frame + channel;
+        }
+    }
+    bool allPassed = Check(same && a.FrameStride() == 2 && p.FrameStride() == 1 && p.Channel(1)[2] == 21.0f,
+                           "Interleaved and planar views index the same samples");
+
+    AudioBufferView tail = p.Subview(1, 5);
+    ConstAudioBufferView readOnly = tail;
+    allPassed &= Check(tail.Frames() == 2 && tail.At(0, 1) == 11.0f && readOnly.Layout() == SampleLayout::Planar &&
+                       !tail.IsContiguous() && a.Subview(1, 1).IsContiguous() && p.Subview(0, 3).IsContiguous(),
+                       "Frame ranges keep the layout; planar ranges are not contiguous");
+    allPassed &= Check(a.Subview(7, 1).Frames() == 0 && AudioBufferView().Subview(0, 4).IsEmpty(),
+                       "Ranges past the end are empty");
+
+    alignas(32) float block[16] = {};
+    allPassed &= Check(AudioBufferView(block, 8, 2).IsAligned(32) && !AudioBufferView(block + 1, 7, 2).IsAligned(32) &&
+                       AudioBufferView(block, 8, 2, SampleLayout::Planar).IsAligned(32) &&
+                       !AudioBufferView(block, 7, 2, SampleLayout::Planar).IsAligned(32),
+                       "Alignment checked for the buffer and each plane");
+    return allPassed;
+}
+
+static bool TestPcmView() {
+    std::vector<char> bytes(6 * 5 + 2);   // Five 24-bit stereo frames and a partial one
+    PcmBufferView pcm(bytes.data(), bytes.size() / 6, 2, 24);
+    ConstPcmBufferView range = pcm.Subview(3, 10);
+    return Check(pcm.Frames() == 5 && pcm.BlockAlign() == 6 && pcm.ByteSize() == 30 && pcm.SampleCount() == 10 &&
+                 range.Frames() == 2 && range.Data() == bytes.data() + 18 && range.BitsPerSample() == 24,
+                 "PCM views count whole frames and keep their format");
+}
+
+static bool TestProcessorViews() {
+    CPUReferenceProcessor processor;
+    processor.Initialize(IGPUProcessor::Backend::CPU);
+
+    std::vector<float> planar = {1, 2, 3, 4, 5, 6};
+    AudioBufferView view(planar.data(), 3, 2, SampleLayout::Planar);
+    bool allPassed = Check(processor.ProcessAudio(view, view) && planar[5] == 6.0f,
+                           "Planar buffer processed in place");
+
+    GPUJobDesc gain;
+    gain.operation = GPUOperation::Gain;
+    gain.gain = 0.5f;
+    gain.input = view;
+    gain.output = view;
+    allPassed &= Check(processor.SubmitJob(gain).get().success && planar[0] == 0.5f && planar[5] == 3.0f,
+                       "Gain job runs on a planar buffer");
+
+    std::vector<float> other(6);
+    GPUJobDesc filter = gain;
+    BiquadCoefficients biquad;
+    BiquadState state[2];
+    filter.operation = GPUOperation::BiquadCascade;
+    filter.biquads = &biquad;
+    filter.biquadCount = 1;
+    filter.biquadState = state;
+    allPassed &= Check(!processor.ProcessAudio(view.Subview(0, 2), view.Subview(1, 2)) &&
+                       !processor.ProcessAudio(view, AudioBufferView(other.data(), 3, 2)) &&
+                       !processor.SubmitJob(filter).get().success,
+                       "Strided ranges, mixed layouts and planar filters rejected");
+    return allPassed;
+}
+
+int main() {
+    std::cout << "=== Audio Buffer View Test ===\n";
+
+    bool allPassed = TestLayouts();
+    allPassed &= TestPcmView();
+    allPassed &= TestProcessorViews();
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
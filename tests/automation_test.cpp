@@ -0,0 +1,149 @@
+#include "dsp/GainStage.h"
+#include "dsp/ParameterAutomation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Checks parameter automation: steps land on the scheduled frame, linear and
+// exponential ramps hit their targets independent of the block size, late
+// events start with the next block, and the gain stage's cost with a ramp in
+// progress compared to a static gain.
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+// Render frameCount values in blocks of blockSize, constant blocks included
+static std::vector<float> RenderAll(AutomatedParameter& parameter, size_t frameCount, size_t blockSize) {
+    std::vector<float> values(frameCount);
+    for (size_t start = 0; start < frameCount; start += blockSize) {
+        size_t count = std::min(blockSize, frameCount - start);
+        if (!parameter.Render(start, count, &values[start])) {
+            std::fill_n(&values[start], count, parameter.GetValue());
+        }
+    }
+    return values;
+}
+
+static AutomationEvent Event(uint64_t start, uint64_t ramp, float value, AutomationEvent::Curve curve) {
+    AutomationEvent event;
+    event.startFrame = start;
+    event.rampFrames = ramp;
+    event.value = value;
+    event.curve = curve;
+    return event;
+}
+
+static bool TestStep() {
+    AutomatedParameter parameter(1.0f);
+    parameter.Schedule(Event(1000, 0, 0.25f, AutomationEvent::Curve::Step));
+    std::vector<float> values = RenderAll(parameter, 2048, 256);
+    return Check(values[999] == 1.0f && values[1000] == 0.25f && values[2047] == 0.25f,
+                 "Step lands on its frame inside a block");
+}
+
+static bool TestLinear() {
+    bool allPassed = true;
+    for (size_t blockSize : {64, 100, 1024}) {
+        AutomatedParameter parameter(0.0f);
+        parameter.Schedule(Event(300, 1000, 1.0f, AutomationEvent::Curve::Linear));
+        std::vector<float> values = RenderAll(parameter, 2048, blockSize);
+        bool matches = values[299] == 0.0f && values[1299] == 1.0f && values[2000] == 1.0f;
+        for (size_t i = 300; i < 1300; i++) {
+            matches &= std::fabs(values[i] - (i - 299) / 1000.0f) < 1e-5f;
+        }
+        allPassed &= Check(matches, "Linear ramp in blocks of " + std::to_string(blockSize) + " frames");
+    }
+    return allPassed;
+}
+
+static bool TestExponential() {
+    AutomatedParameter parameter(1.0f);
+    parameter.Schedule(Event(0, 4800, 0.001f, AutomationEvent::Curve::Exponential));
+    std::vector<float> values = RenderAll(parameter, 4800, 512);
+    // Equal dB steps: -60 dB over 4800 frames, so -30 dB half way
+    bool allPassed = Check(std::fabs(20.0f * std::log10(values[2399]) + 30.0f) < 0.01f && values[4799] == 0.001f,
+                           "Exponential ramp moves in equal dB steps");
+
+    AutomatedParameter toZero(1.0f);
+    toZero.Schedule(Event(0, 100, 0.0f, AutomationEvent::Curve::Exponential));
+    values = RenderAll(toZero, 100, 100);
+    allPassed &= Check(std::fabs(values[49] - 0.5f) < 1e-5f && values[99] == 0.0f,
+                       "Exponential ramp to zero falls back to linear");
+    return allPassed;
+}
+
+static bool TestInterruptAndLate() {
+    AutomatedParameter parameter(0.0f);
+    parameter.Schedule(Event(0, 1000, 1.0f, AutomationEvent::Curve::Linear));
+    parameter.Schedule(Event(500, 0, 0.75f, AutomationEvent::Curve::Step));
+    std::vector<float> values = RenderAll(parameter, 1024, 256);
+    bool allPassed = Check(std::fabs(values[499] - 0.5f) < 1e-5f && values[500] == 0.75f && values[1023] == 0.75f,
+                           "New event cuts off a running ramp");
+
+    // Scheduled for frame 10 but first seen in the block starting at 1024
+    parameter.Schedule(Event(10, 0, 0.5f, AutomationEvent::Curve::Step));
+    std::vector<float> block(256);
+    bool changed = parameter.Render(1024, 256, block.data());
+    allPassed &= Check(changed && block[0] == 0.5f && !parameter.IsAutomating(), "Late event applies at the next block");
+    return allPassed;
+}
+
+static bool TestGainStage() {
+    GainStage stage(0.5f);
+    stage.Prepare(48000, 2, 256);
+    std::vector<float> samples(512, 1.0f);
+    AudioBufferView block(samples.data(), 256, 2, SampleLayout::Planar);
+    stage.Process(block);
+    bool allPassed = Check(samples[0] == 0.5f && samples[511] == 0.5f, "Static gain scales every channel");
+
+    stage.GetGain().Schedule(Event(256 + 100, 0, 2.0f, AutomationEvent::Curve::Step));
+    samples.assign(512, 1.0f);
+    stage.Process(block);
+    allPassed &= Check(samples[99] == 0.5f && samples[100] == 2.0f && samples[256 + 99] == 0.5f &&
+                       samples[256 + 100] == 2.0f, "Automated gain follows the stage's own timeline");
+    return allPassed;
+}
+
+// Seconds to process one minute of stereo 48 kHz audio in 1024-frame blocks
+static double TimeGain(bool automated) {
+    const size_t kBlock = 1024;
+    const size_t blocks = 48000 * 60 / kBlock;
+    GainStage stage(0.5f);
+    stage.Prepare(48000, 2, kBlock);
+    if (automated) {
+        stage.GetGain().Schedule(Event(0, blocks * kBlock, 0.001f, AutomationEvent::Curve::Exponential));
+    }
+    std::vector<float> samples(kBlock * 2, 0.25f);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t block = 0; block < blocks; block++) {
+        std::fill(samples.begin(), samples.end(), 0.25f);   // Keep the values from decaying to denormals
+        stage.Process(AudioBufferView(samples.data(), kBlock, 2, SampleLayout::Planar));
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool TestCost() {
+    double staticSeconds = TimeGain(false);
+    double automatedSeconds = TimeGain(true);
+    return Check(automatedSeconds < 4.0 * staticSeconds + 0.002,
+                 "Exponential ramp costs " + std::to_string(automatedSeconds * 1000.0) + "ms vs static " +
+                 std::to_string(staticSeconds * 1000.0) + "ms per minute of stereo audio");
+}
+
+int main() {
+    std::cout << "=== Parameter Automation Test ===\n";
+
+    bool allPassed = TestStep();
+    allPassed &= TestLinear();
+    allPassed &= TestExponential();
+    allPassed &= TestInterruptAndLate();
+    allPassed &= TestGainStage();
+    allPassed &= TestCost();
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+#include "gpu/BackendAutotuner.h"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+// Checks the backend autotuner: measuring and persisting the CPU path, and
+// choosing per operation, block size and workload from known timings.
+
+typedef IGPUProcessor::Backend Backend;
+typedef BackendAutotuner::Operation Operation;
+typedef BackendAutotuner::Workload Workload;
+
+static BackendAutotuner::Measurement Make(Backend backend, Operation operation, size_t frames,
+                                          double realtime, double batch) {
+    BackendAutotuner::Measurement measurement;
+    measurement.backend = backend;
+    measurement.operation = operation;
+    measurement.frames = frames;
+    measurement.realtimeMicroseconds = realtime;
+    measurement.batchMicroseconds = batch;
+    return measurement;
+}
+
+static bool Check(bool condition, const char* description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+static bool TestMeasureAndPersist() {
+    BackendAutotuner::Options options;
+    options.backends = {Backend::CPU};
+    options.blockFrames = {64, 1024};
+    options.convolutionPartitions = {1024};
+    options.realtimeRuns = 3;
+    options.batchJobs = 4;
+
+    BackendAutotuner first(options);
+    bool allPassed = Check(first.Tune() && !first.LoadedFromCache(), "CPU backend measured on first run");
+    // copy, gain and biquad at two sizes, convolution at one
+    allPassed &= Check(first.GetMeasurements().size() == 7, "Every operation and size measured");
+    bool positive = true;
+    for (const auto& measurement : first.GetMeasurements()) {
+        positive &= measurement.realtimeMicroseconds > 0.0 && measurement.batchMicroseconds > 0.0;
+    }
+    allPassed &= Check(positive, "Timings are positive");
+
+    BackendAutotuner second(options);
+    allPassed &= Check(second.Tune() && second.LoadedFromCache() &&
+                       second.GetMeasurements().size() == first.GetMeasurements().size(),
+                       "Second run loads the persisted results");
+    allPassed &= Check(second.Tune(true) && !second.LoadedFromCache(), "Remeasuring ignores the cache");
+
+    options.blockFrames = {64, 2048};
+    BackendAutotuner changed(options);
+    allPassed &= Check(changed.Tune() && !changed.LoadedFromCache(), "Different settings are measured again");
+    allPassed &= Check(changed.Choose(Operation::BiquadCascade, 512, Workload::Realtime) == Backend::CPU,
+                       "Only the CPU measured: CPU chosen");
+    return allPassed;
+}
+
+static bool TestChoices() {
+    std::vector<BackendAutotuner::Measurement> measurements;
+    // The accelerator has a fixed 200us round trip but much higher throughput
+    const size_t sizes[] = {64, 256, 1024, 4096, 16384};
+    for (size_t frames : sizes) {
+        measurements.push_back(Make(Backend::CPU, Operation::BiquadCascade, frames, frames * 0.1, frames * 0.1));
+        measurements.push_back(Make(Backend::VULKAN, Operation::BiquadCascade, frames, 200 + frames * 0.01,
+                                    20 + frames * 0.01));
+    }
+    // Near-tie for gain: the accelerator is only 5% faster
+    measurements.push_back(Make(Backend::CPU, Operation::Gain, 4096, 100, 100));
+    measurements.push_back(Make(Backend::VULKAN, Operation::Gain, 4096, 95, 95));
+    // Direct convolution wins from 4096 up
+    measurements.push_back(Make(Backend::CPU, Operation::Convolution, 1024, 50, 50));
+    measurements.push_back(Make(Backend::VULKAN, Operation::Convolution, 1024, 80, 80));
+    measurements.push_back(Make(Backend::CPU, Operation::Convolution, 4096, 250, 250));
+    measurements.push_back(Make(Backend::VULKAN, Operation::Convolution, 4096, 150, 150));
+    measurements.push_back(Make(Backend::CPU, Operation::Convolution, 16384, 1200, 1200));
+    measurements.push_back(Make(Backend::VULKAN, Operation::Convolution, 16384, 600, 600));
+
+    BackendAutotuner autotuner;
+    autotuner.SetMeasurements(measurements);
+
+    bool allPassed = Check(autotuner.Choose(Operation::BiquadCascade, 256, Workload::Realtime) == Backend::CPU,
+                           "Small realtime blocks stay on the CPU");
+    allPassed &= Check(autotuner.Choose(Operation::BiquadCascade, 256, Workload::Batch) == Backend::VULKAN,
+                       "Small batch work goes to the faster accelerator");
+    allPassed &= Check(autotuner.Choose(Operation::BiquadCascade, 16384, Workload::Realtime) == Backend::VULKAN,
+                       "Large realtime blocks go to the accelerator once it is faster");
+    allPassed &= Check(autotuner.Choose(Operation::BiquadCascade, 48, Workload::Batch) == Backend::CPU,
+                       "Sizes below the smallest measurement use it (CPU at 64 frames)");
+    allPassed &= Check(autotuner.Choose(Operation::BiquadCascade, 3000, Workload::Realtime) == Backend::VULKAN,
+                       "Sizes between measurements round up (4096 frames)");
+    allPassed &= Check(autotuner.Choose(Operation::BiquadCascade, 1 << 20, Workload::Realtime) == Backend::VULKAN,
+                       "Sizes above the largest measurement use it");
+    allPassed &= Check(autotuner.Choose(Operation::Gain, 4096, Workload::Batch) == Backend::CPU,
+                       "Near-ties stay on the CPU");
+    allPassed &= Check(autotuner.Choose(Operation::Copy, 4096, Workload::Batch) == Backend::CPU,
+                       "Unmeasured operations use the CPU");
+    allPassed &= Check(autotuner.ChooseDefault() == Backend::VULKAN, "Engine backend is the batch winner");
+    allPassed &= Check(autotuner.GetConvolutionOffloadSize(Backend::VULKAN) == 4096,
+                       "Convolution is offloaded from the first partition size that wins");
+    allPassed &= Check(autotuner.GetConvolutionOffloadSize(Backend::OPENCL) == std::numeric_limits<size_t>::max(),
+                       "Unmeasured backends are never offloaded to");
+
+    // An accelerator that loses at the largest partition must not get any
+    measurements.push_back(Make(Backend::OPENCL, Operation::Convolution, 4096, 100, 100));
+    measurements.push_back(Make(Backend::OPENCL, Operation::Convolution, 16384, 5000, 5000));
+    autotuner.SetMeasurements(measurements);
+    allPassed &= Check(autotuner.GetConvolutionOffloadSize(Backend::OPENCL) == std::numeric_limits<size_t>::max(),
+                       "No offload when the largest partition is slower");
+    return allPassed;
+}
+
+int main() {
+    std::cout << "=== Backend Autotuner Test ===\n";
+
+    // Keep the persisted results away from the user's cache
+    std::filesystem::path cacheDirectory = std::filesystem::temp_directory_path() / "gpu_player_autotuner_test";
+    std::filesystem::remove_all(cacheDirectory);
+#ifdef _WIN32
+    _putenv_s("GPU_PLAYER_CACHE_DIR", cacheDirectory.string().c_str());
+#else
+    setenv("GPU_PLAYER_CACHE_DIR", cacheDirectory.string().c_str(), 1);
+#endif
+
+    bool allPassed = TestMeasureAndPersist();
+    allPassed &= TestChoices();
+    std::filesystem::remove_all(cacheDirectory);
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+#include "dsp/ChannelLayout.h"
+#include "dsp/ChannelMixer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Checks speaker layouts (WAV masks, FLAC defaults, names) and the channel
+// mixing matrix: fold-down gains, block processing against a scalar
+// reference, and the cost per channel as the channel count grows.
+
+typedef ChannelLayout::Speaker Speaker;
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+static bool Near(float a, float b) {
+    return std::fabs(a - b) < 1e-5f;
+}
+
+static bool TestLayouts() {
+    bool allPassed = Check(ChannelLayout::FromMask(0x3F, 6).Describe() == "5.1 (FL FR FC LFE BL BR)",
+                           "5.1 mask: " + ChannelLayout::FromMask(0x3F, 6).Describe());
+    allPassed &= Check(ChannelLayout::Default(7).Describe() == "6.1 (FL FR FC LFE BC SL SR)",
+                       "FLAC 7-channel assignment: " + ChannelLayout::Default(7).Describe());
+    allPassed &= Check(ChannelLayout::Default(8).GetName() == "7.1" && ChannelLayout::Default(12).GetName() == "7.1.4",
+                       "8 and 12 channels default to 7.1 and 7.1.4");
+    allPassed &= Check(ChannelLayout::FromMask(0, 2) == ChannelLayout::Default(2), "Empty mask uses the default layout");
+
+    ChannelLayout partial = ChannelLayout::FromMask(0x3, 4);
+    allPassed &= Check(partial.Describe() == "4 channels (FL FR AUX AUX)",
+                       "Channels beyond the mask are auxiliary: " + partial.Describe());
+    allPassed &= Check(partial.GetMask() == 0x3 && partial.Find(Speaker::FrontRight) == 1 &&
+                       partial.Find(Speaker::FrontCenter) == -1, "Mask and speaker lookup");
+
+    ChannelLayout parsed;
+    allPassed &= Check(ChannelLayout::Parse("7.1.4", parsed) && parsed.GetChannelCount() == 12 &&
+                       parsed.GetMask() == 0x2D63F, "Parse 7.1.4");
+    allPassed &= Check(ChannelLayout::Parse("16", parsed) && parsed.GetChannelCount() == 16 &&
+                       parsed.GetSpeaker(15) == Speaker::Aux, "Parse a channel count");
+    allPassed &= Check(!ChannelLayout::Parse("9.2.7", parsed), "Unknown names are rejected");
+    return allPassed;
+}
+
+static bool TestFoldDown() {
+    ChannelLayout mono, stereo, surround51, surround71, atmos;
+    ChannelLayout::Parse("mono", mono);
+    ChannelLayout::Parse("stereo", stereo);
+    ChannelLayout::Parse("5.1", surround51);
+    ChannelLayout::Parse("7.1", surround71);
+    ChannelLayout::Parse("7.1.4", atmos);
+
+    ChannelMixer mixer;
+    bool allPassed = Check(mixer.Configure(stereo, stereo) && mixer.IsIdentity(), "Same layout passes through");
+
+    // L = FL + 0.707 FC + 0.707 BL, scaled to unity sum
+    mixer.Configure(surround51, stereo);
+    const float sum = 1.0f + 2.0f * 0.70710678f;
+    allPassed &= Check(Near(mixer.GetGain(0, 0), 1.0f / sum) && Near(mixer.GetGain(0, 2), 0.70710678f / sum) &&
+                       Near(mixer.GetGain(0, 4), 0.70710678f / sum) && mixer.GetGain(0, 1) == 0.0f &&
+                       mixer.GetGain(0, 3) == 0.0f && mixer.GetGain(0, 5) == 0.0f,
+                       "5.1 -> stereo: center and surround at -3dB, LFE dropped (" + mixer.GetName() + ")");
+
+    mixer.Configure(surround51, stereo, false);
+    allPassed &= Check(mixer.GetGain(1, 1) == 1.0f && Near(mixer.GetGain(1, 5), 0.70710678f),
+                       "Unnormalized fold-down keeps unity front gain");
+
+    mixer.Configure(mono, stereo);
+    allPassed &= Check(Near(mixer.GetGain(0, 0), 0.70710678f) && Near(mixer.GetGain(1, 0), 0.70710678f),
+                       "Mono -> stereo is equal power");
+
+    mixer.Configure(stereo, surround51);
+    allPassed &= Check(mixer.GetGain(0, 0) == 1.0f && mixer.GetGain(1, 1) == 1.0f && mixer.GetGain(2, 0) == 0.0f,
+                       "Stereo -> 5.1 routes the fronts only");
+
+    // 7.1 side channels land on the 5.1 back pair; heights fold into their ear-level speaker
+    mixer.Configure(surround71, surround51, false);
+    allPassed &= Check(mixer.GetGain(4, 6) == 1.0f && mixer.GetGain(5, 7) == 1.0f,
+                       "7.1 -> 5.1 folds sides into backs");
+    mixer.Configure(atmos, surround71, false);
+    allPassed &= Check(Near(mixer.GetGain(0, 8), 0.70710678f) && Near(mixer.GetGain(5, 11), 0.70710678f),
+                       "7.1.4 -> 7.1 folds heights at -3dB");
+    return allPassed;
+}
+
+static bool TestProcessMatchesMatrix() {
+    ChannelLayout atmos, surround51;
+    ChannelLayout::Parse("7.1.4", atmos);
+    ChannelLayout::Parse("5.1", surround51);
+
+    ChannelMixer mixer;
+    mixer.Configure(atmos, surround51);
+
+    const size_t frames = 1000;   // Not a multiple of the internal block size
+    const int in = atmos.GetChannelCount();
+    const int out = surround51.GetChannelCount();
+    std::vector<float> input(frames * in);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = std::sin(0.013f * i) * (1.0f + (i % in) * 0.1f);
+    }
+    std::vector<float> output(frames * out);
+    mixer.Process(input.data(), output.data(), frames);
+
+    double maxError = 0.0;
+    for (size_t frame = 0; frame < frames; frame++) {
+        for (int o = 0; o < out; o++) {
+            double expected = 0.0;
+            for (int i = 0; i < in; i++) {
+                expected += mixer.GetGain(o, i) * input[frame * in + i];
+            }
+            maxError = std::max(maxError, std::fabs(expected - output[frame * out + o]));
+        }
+    }
+    return Check(maxError < 1e-5, "7.1.4 -> 5.1 block processing matches the matrix (max error " +
+                 std::to_string(maxError) + ")");
+}
+
+static bool TestCustomMatrix() {
+    ChannelMixer mixer;
+    bool allPassed = Check(!mixer.SetMatrix(2, 2, {1.0f}), "Matrix size is validated");
+    mixer.SetMatrix(2, 2, {0.0f, 1.0f, 1.0f, 0.0f});
+
+    std::vector<float> input = {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f};
+    std::vector<float> output(input.size());
+    mixer.Process(input.data(), output.data(), 3);
+    allPassed &= Check(!mixer.IsIdentity() && output[0] == 0.2f && output[1] == 0.1f && output[5] == 0.5f,
+                       "Swapped channels");
+    return allPassed;
+}
+
+// Time a channel permutation (one term per channel) and return nanoseconds per sample
+static double TimePermutation(int channels) {
+    std::vector<float> gains(static_cast<size_t>(channels) * channels, 0.0f);
+    for (int out = 0; out < channels; out++) {
+        gains[static_cast<size_t>(out) * channels + (channels - 1 - out)] = 1.0f;
+    }
+    ChannelMixer mixer;
+    mixer.SetMatrix(channels, channels, gains);
+
+    const size_t frames = 4096;
+    std::vector<float> input(frames * channels, 0.5f);
+    std::vector<float> output(frames * channels);
+    const int runs = 200;
+    mixer.Process(input.data(), output.data(), frames);
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < runs; run++) {
+        mixer.Process(input.data(), output.data(), frames);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / (static_cast<double>(runs) * frames * channels);
+}
+
+static bool TestCostPerChannel() {
+    bool allPassed = true;
+    for (int channels : {2, 6, 12, 16}) {
+        double nanoseconds = TimePermutation(channels);
+        std::cout << "  " << channels << " channels: " << nanoseconds << "ns per sample\n";
+        allPassed &= nanoseconds > 0.0;
+    }
+    return Check(allPassed, "Remap cost per channel measured");
+}
+
+int main() {
+    std::cout << "=== Channel Layout and Mixer Test ===\n";
+
+    bool allPassed = TestLayouts();
+    allPassed &= TestFoldDown();
+    allPassed &= TestProcessMatchesMatrix();
+    allPassed &= TestCustomMatrix();
+    allPassed &= TestCostPerChannel();
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include "core/CommandQueue.h"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Checks the control command queue: capacity is rounded up to a power of
+// two, a full queue refuses pushes until the consumer frees a slot, and
+// commands pushed by several threads at once all arrive exactly once, in
+// the order each thread pushed them.
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+struct Command {
+    int producer;
+    int sequence;
+};
+
+static bool TestCapacity() {
+    CommandQueue<Command> queue;
+    Command command = {0, 0};
+    bool allPassed = Check(!queue.Push(command) && !queue.Pop(command), "Queue without storage refuses pushes");
+
+    queue.Reset(5);
+    allPassed &= Check(queue.GetCapacity() == 8, "Capacity rounded up to " + std::to_string(queue.GetCapacity()));
+
+    bool filled = true;
+    for (int i = 0; i < 8; i++) {
+        filled &= queue.Push({0, i});
+    }
+    allPassed &= Check(filled && !queue.Push({0, 8}), "Full queue refuses a push");
+
+    bool popped = queue.Pop(command) && command.sequence == 0;
+    allPassed &= Check(popped && queue.Push({0, 8}), "Popping frees a slot");
+
+    bool ordered = true;
+    for (int i = 1; i <= 8; i++) {
+        ordered &= queue.Pop(command) && command.sequence == i;
+    }
+    allPassed &= Check(ordered && !queue.Pop(command), "Elements come out in push order across the wrap");
+    return allPassed;
+}
+
+static bool TestProducers() {
+    const int kProducers = 4;
+    const int kCommandsPerProducer = 100000;
+
+    CommandQueue<Command> queue;
+    queue.Reset(64);
+    std::atomic<int> fullRetries{0};
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < kProducers; producer++) {
+        producers.emplace_back([&queue, &fullRetries, producer]() {
+            for (int i = 0; i < kCommandsPerProducer; i++) {
+                while (!queue.Push({producer, i})) {
+                    fullRetries.fetch_add(1, std::memory_order_relaxed);
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(kProducers, 0);
+    int received = 0;
+    bool ordered = true;
+    Command command;
+    while (received < kProducers * kCommandsPerProducer) {
+        if (!queue.Pop(command)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered &= command.producer >= 0 && command.producer < kProducers && command.sequence == next[command.producer];
+        if (command.producer >= 0 && command.producer < kProducers) {
+            next[command.producer] = command.sequence + 1;
+        }
+        received++;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    bool allPassed = Check(ordered, "Every producer's commands arrive in order");
+    bool complete = !queue.Pop(command);
+    for (int producer = 0; producer < kProducers; producer++) {
+        complete &= next[producer] == kCommandsPerProducer;
+    }
+    allPassed &= Check(complete, std::to_string(received) + " commands from " + std::to_string(kProducers) +
+                       " threads received exactly once (" + std::to_string(fullRetries.load()) + " pushes retried while full)");
+    return allPassed;
+}
+
+int main() {
+    std::cout << "=== Command Queue Test ===\n";
+
+    bool allPassed = TestCapacity();
+    allPassed &= TestProducers();
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include "dsp/Crossfade.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Checks the crossfade curves: linear gains sum to one, equal-power gains keep
+// the power constant, fade-out mirrors fade-in, custom curves are parsed and
+// interpolated, and mixing applies the gains frame by frame.
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+static bool TestNamedCurves() {
+    const size_t kFrames = 1000;
+    std::vector<float> fadeIn;
+    std::vector<float> fadeOut;
+    std::vector<float> none;
+
+    Crossfade::BuildGains(Crossfade::Curve::Linear, none, kFrames, fadeIn, fadeOut);
+    bool sum = true;
+    for (size_t k = 0; k < kFrames; k++) {
+        sum &= std::fabs(fadeIn[k] + fadeOut[k] - 1.0f) < 1e-6f;
+    }
+    bool allPassed = Check(sum && fadeIn[0] < 0.001f && fadeIn[kFrames - 1] > 0.999f, "Linear gains sum to 1");
+
+    Crossfade::BuildGains(Crossfade::Curve::EqualPower, none, kFrames, fadeIn, fadeOut);
+    bool power = true;
+    bool rising = true;
+    for (size_t k = 0; k < kFrames; k++) {
+        power &= std::fabs(fadeIn[k] * fadeIn[k] + fadeOut[k] * fadeOut[k] - 1.0f) < 1e-5f;
+        rising &= k == 0 || fadeIn[k] > fadeIn[k - 1];
+    }
+    allPassed &= Check(power && rising, "Equal-power gains keep the power constant");
+
+    Crossfade::BuildGains(Crossfade::Curve::SCurve, none, kFrames, fadeIn, fadeOut);
+    bool mirrored = true;
+    for (size_t k = 0; k < kFrames; k++) {
+        mirrored &= fadeOut[k] == fadeIn[kFrames - 1 - k];
+    }
+    allPassed &= Check(mirrored && std::fabs(fadeIn[kFrames / 2] - 0.5f) < 0.002f && fadeIn[10] < 0.001f,
+                       "S-curve is symmetric and gentle at the ends");
+    return allPassed;
+}
+
+static bool TestCustomCurve() {
+    Crossfade::Curve curve;
+    std::vector<float> points;
+    bool allPassed = Check(Crossfade::ParseCurve("equal-power", curve, points) &&
+                           curve == Crossfade::Curve::EqualPower && points.empty(), "Curve names are parsed");
+    allPassed &= Check(!Crossfade::ParseCurve("0.5", curve, points) && !Crossfade::ParseCurve("0,2", curve, points) &&
+                       !Crossfade::ParseCurve("0,,1", curve, points) && !Crossfade::ParseCurve("fast", curve, points),
+                       "Invalid curves are rejected");
+
+    allPassed &= Check(Crossfade::ParseCurve("0,0.8,1", curve, points) && curve == Crossfade::Curve::Custom &&
+                       points.size() == 3, "Custom curve is parsed");
+    std::vector<float> fadeIn;
+    std::vector<float> fadeOut;
+    Crossfade::BuildGains(curve, points, 4, fadeIn, fadeOut);
+    // Points at t = 0, 0.5, 1; frames at t = 0.125, 0.375, 0.625, 0.875
+    allPassed &= Check(std::fabs(fadeIn[0] - 0.2f) < 1e-6f && std::fabs(fadeIn[1] - 0.6f) < 1e-6f &&
+                       std::fabs(fadeIn[2] - 0.85f) < 1e-6f && std::fabs(fadeIn[3] - 0.95f) < 1e-6f &&
+                       fadeOut[0] == fadeIn[3], "Custom curve is interpolated between its points");
+    return allPassed;
+}
+
+static bool TestMix() {
+    const size_t kFrames = 8;
+    std::vector<float> fadeIn;
+    std::vector<float> fadeOut;
+    Crossfade::BuildGains(Crossfade::Curve::Linear, std::vector<float>(), kFrames, fadeIn, fadeOut);
+
+    std::vector<float> outgoing(kFrames * 2);
+    std::vector<float> incoming(kFrames * 2);
+    for (size_t i = 0; i < kFrames; i++) {
+        outgoing[i * 2] = 1.0f;
+        outgoing[i * 2 + 1] = -1.0f;
+        incoming[i * 2] = 0.5f;
+        incoming[i * 2 + 1] = 0.25f;
+    }
+    Crossfade::Mix(outgoing.data(), incoming.data(), fadeOut.data(), fadeIn.data(), 2, kFrames);
+
+    bool matches = true;
+    for (size_t i = 0; i < kFrames; i++) {
+        matches &= std::fabs(outgoing[i * 2] - (fadeOut[i] + 0.5f * fadeIn[i])) < 1e-6f;
+        matches &= std::fabs(outgoing[i * 2 + 1] - (-fadeOut[i] + 0.25f * fadeIn[i])) < 1e-6f;
+    }
+    return Check(matches, "Mix applies one gain per frame to every channel");
+}
+
+int main() {
+    std::cout << "=== Crossfade Test ===\n";
+
+    bool allPassed = TestNamedCurves();
+    allPassed &= TestCustomCurve();
+    allPassed &= TestMix();
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
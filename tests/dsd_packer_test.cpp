@@ -0,0 +1,139 @@
+#include "dsp/DSDPacker.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Checks DoP and native DSD packing against a bit-level reference for
+// stereo (vectorized) and other channel counts, DoP marker continuity across
+// calls, and the packing cost at DSD512 as a share of one core.
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+static std::vector<uint8_t> MakeDSD(size_t bytesPerChannel, int channels) {
+    std::vector<uint8_t> dsd(bytesPerChannel * channels);
+    for (size_t i = 0; i < dsd.size(); i++) {
+        dsd[i] = static_cast<uint8_t>((i * 2654435761u) >> 11);
+    }
+    return dsd;
+}
+
+static bool TestDoP(int channels) {
+    const size_t bytesPerChannel = 2 * 37;   // Odd frame count, not a multiple of the vector step
+    std::vector<uint8_t> dsd = MakeDSD(bytesPerChannel, channels);
+    std::vector<int32_t> output(bytesPerChannel / 2 * channels);
+
+    uint8_t marker = DSDPacker::kDoPMarker;
+    size_t frames = DSDPacker::PackDoP(dsd.data(), bytesPerChannel, channels, marker, output.data());
+
+    bool matches = frames == bytesPerChannel / 2;
+    for (size_t frame = 0; frame < frames; frame++) {
+        for (int channel = 0; channel < channels; channel++) {
+            uint32_t sample = static_cast<uint32_t>(output[frame * channels + channel]);
+            uint8_t expectedMarker = frame % 2 == 0 ? 0x05 : 0xFA;
+            matches &= (sample >> 24) == expectedMarker;
+            matches &= ((sample >> 16) & 0xFF) == dsd[(frame * 2) * channels + channel];
+            matches &= ((sample >> 8) & 0xFF) == dsd[(frame * 2 + 1) * channels + channel];
+            matches &= (sample & 0xFF) == 0;
+        }
+    }
+    bool allPassed = Check(matches, std::to_string(channels) + " channels: DoP samples carry marker, earlier byte, later byte");
+    allPassed &= Check(marker == 0xFA, std::to_string(channels) + " channels: marker continues after an odd frame count");
+    return allPassed;
+}
+
+static bool TestDoPSplitCalls() {
+    // Packing in uneven pieces must give the same stream as one call
+    const size_t bytesPerChannel = 2 * 100;
+    std::vector<uint8_t> dsd = MakeDSD(bytesPerChannel, 2);
+    std::vector<int32_t> whole(bytesPerChannel);
+    std::vector<int32_t> pieces(bytesPerChannel);
+
+    uint8_t marker = DSDPacker::kDoPMarker;
+    DSDPacker::PackDoP(dsd.data(), bytesPerChannel, 2, marker, whole.data());
+
+    marker = DSDPacker::kDoPMarker;
+    size_t frame = 0;
+    for (size_t count : {7, 13, 1, 29}) {
+        frame += DSDPacker::PackDoP(&dsd[frame * 4], count * 2, 2, marker, &pieces[frame * 2]);
+    }
+    DSDPacker::PackDoP(&dsd[frame * 4], bytesPerChannel - frame * 2, 2, marker, &pieces[frame * 2]);
+    return Check(whole == pieces, "DoP stream is identical when packed in pieces");
+}
+
+static bool TestNative(int channels) {
+    const size_t bytesPerChannel = 4 * 21;
+    std::vector<uint8_t> dsd = MakeDSD(bytesPerChannel, channels);
+    std::vector<uint8_t> output(dsd.size());
+    size_t frames = DSDPacker::PackNative(dsd.data(), bytesPerChannel, channels, output.data());
+
+    bool matches = frames == bytesPerChannel / 4;
+    for (size_t frame = 0; frame < frames; frame++) {
+        for (int channel = 0; channel < channels; channel++) {
+            for (int i = 0; i < 4; i++) {
+                matches &= output[(frame * channels + channel) * 4 + i] == dsd[(frame * 4 + i) * channels + channel];
+            }
+        }
+    }
+    return Check(matches, std::to_string(channels) + " channels: native words hold four consecutive bytes per channel");
+}
+
+static bool TestModes() {
+    DSDPacker::Mode mode;
+    bool allPassed = Check(DSDPacker::ParseMode("dop", mode) && mode == DSDPacker::Mode::DoP &&
+                           DSDPacker::ParseMode("native", mode) && mode == DSDPacker::Mode::Native &&
+                           !DSDPacker::ParseMode("dsd", mode), "Output mode names");
+    allPassed &= Check(DSDPacker::GetBytesPerFrame(DSDPacker::Mode::DoP) == 2 &&
+                       DSDPacker::GetBytesPerFrame(DSDPacker::Mode::Native) == 4, "Bytes per output frame");
+    return allPassed;
+}
+
+// Pack one second of stereo DSD512 and return the share of one core used
+static double TimePacking(DSDPacker::Mode mode) {
+    const size_t bytesPerChannel = 44100 * 512 / 8;
+    const size_t kBlockBytes = 4096;
+    std::vector<uint8_t> dsd = MakeDSD(bytesPerChannel, 2);
+    std::vector<int32_t> output(kBlockBytes * 2);
+    uint8_t marker = DSDPacker::kDoPMarker;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset < bytesPerChannel; offset += kBlockBytes) {
+        // One second is not a whole number of blocks; the last one is shorter
+        const size_t bytes = std::min(kBlockBytes, bytesPerChannel - offset);
+        if (mode == DSDPacker::Mode::DoP) {
+            DSDPacker::PackDoP(&dsd[offset * 2], bytes, 2, marker, output.data());
+        } else {
+            DSDPacker::PackNative(&dsd[offset * 2], bytes, 2, reinterpret_cast<uint8_t*>(output.data()));
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool TestCost() {
+    bool allPassed = true;
+    for (DSDPacker::Mode mode : {DSDPacker::Mode::DoP, DSDPacker::Mode::Native}) {
+        double load = TimePacking(mode);
+        allPassed &= Check(load < 0.05, std::string("DSD512 stereo ") + DSDPacker::GetModeName(mode) + " packing: " +
+                           std::to_string(100.0 * load) + "% of one core");
+    }
+    return allPassed;
+}
+
+int main() {
+    std::cout << "=== DSD Output Packing Test ===\n";
+
+    bool allPassed = TestDoP(2);
+    allPassed &= TestDoP(6);
+    allPassed &= TestDoPSplitCalls();
+    allPassed &= TestNative(2);
+    allPassed &= TestNative(5);
+    allPassed &= TestModes();
+    allPassed &= TestCost();
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
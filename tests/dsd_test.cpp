@@ -0,0 +1,248 @@
+#include "decoders/DSDFileReader.h"
+#include "dsp/DSDConverter.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// Checks DSD to PCM conversion (level, frequency and noise of a modulated
+// sine), the DSF and DSDIFF readers against known byte patterns, and the
+// conversion speed at DSD512 and DSD1024.
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+// Second-order sigma-delta modulator; returns byte-interleaved, MSB-first DSD
+static std::vector<uint8_t> ModulateSine(double frequency, double amplitude, int dsdRate, int channels, size_t bytesPerChannel) {
+    std::vector<uint8_t> bytes(bytesPerChannel * channels, 0);
+    for (int channel = 0; channel < channels; channel++) {
+        double integrator1 = 0.0;
+        double integrator2 = 0.0;
+        double feedback = 0.0;
+        for (size_t i = 0; i < bytesPerChannel * 8; i++) {
+            double input = amplitude * std::sin(2.0 * M_PI * frequency * i / dsdRate);
+            integrator1 += input - feedback;
+            integrator2 += integrator1 - feedback;
+            feedback = integrator2 >= 0.0 ? 1.0 : -1.0;
+            if (feedback > 0.0) {
+                bytes[(i / 8) * channels + channel] |= 0x80 >> (i % 8);
+            }
+        }
+    }
+    return bytes;
+}
+
+static bool TestSineConversion() {
+    const int dsdRate = 2822400;
+    const double frequency = 1000.0;
+    const size_t bytesPerChannel = dsdRate / 8 / 4;   // 250ms
+    std::vector<uint8_t> dsd = ModulateSine(frequency, 0.5, dsdRate, 2, bytesPerChannel);
+
+    DSDConverter converter;
+    DSDConverter::Options options;
+    bool initialized = converter.Initialize(dsdRate, 2, options);
+    bool allPassed = Check(initialized && converter.GetOutputRate() == 176400,
+                           "DSD64 defaults to 176.4kHz: " + converter.GetName());
+
+    // Feed uneven blocks to exercise the streaming state
+    std::vector<float> pcm(converter.GetMaxOutputFrames(bytesPerChannel) * 2);
+    size_t frames = 0;
+    for (size_t offset = 0, block = 1000; offset < bytesPerChannel; offset += block, block = block * 3 % 7001 + 1) {
+        size_t count = std::min(block, bytesPerChannel - offset);
+        frames += converter.Process(&dsd[offset * 2], count, &pcm[frames * 2]);
+    }
+    allPassed &= Check(frames + 8 >= bytesPerChannel / 2 && frames <= bytesPerChannel / 2,
+                       "Output length matches the decimation (" + std::to_string(frames) + " frames)");
+
+    // Least-squares fit of a 1kHz sine over the settled part. The residual, averaged over
+    // 8 samples to suppress the modulator's shaped noise above the audio band, is the
+    // conversion error.
+    const int rate = converter.GetOutputRate();
+    double sinSum = 0.0, cosSum = 0.0;
+    const size_t start = 2000;
+    const size_t length = (frames - start - 8) / 176 * 176;   // Whole periods
+    for (size_t i = start; i < start + length; i++) {
+        sinSum += pcm[i * 2] * std::sin(2.0 * M_PI * frequency * i / rate);
+        cosSum += pcm[i * 2] * std::cos(2.0 * M_PI * frequency * i / rate);
+    }
+    const double a = 2.0 * sinSum / length;
+    const double b = 2.0 * cosSum / length;
+    const double amplitude = std::sqrt(a * a + b * b);
+    double residual = 0.0;
+    for (size_t i = start; i < start + length; i++) {
+        double error = 0.0;
+        for (size_t j = i; j < i + 8; j++) {
+            error += pcm[j * 2] - (a * std::sin(2.0 * M_PI * frequency * j / rate) +
+                                   b * std::cos(2.0 * M_PI * frequency * j / rate));
+        }
+        residual += (error / 8.0) * (error / 8.0);
+    }
+    const double noiseDb = 10.0 * std::log10(residual / length / (amplitude * amplitude / 2.0));
+
+    allPassed &= Check(std::fabs(amplitude - 0.5) < 0.01, "50% modulation converts to -6dBFS (amplitude " +
+                       std::to_string(amplitude) + ")");
+    allPassed &= Check(noiseDb < -60.0, "Audio-band noise and distortion below the sine: " + std::to_string(noiseDb) + "dB");
+    allPassed &= Check(std::fabs(pcm[(start + 100) * 2] - pcm[(start + 100) * 2 + 1]) < 1e-6f,
+                       "Identical channels convert identically");
+
+    // The DSD idle pattern decodes to silence
+    converter.Reset();
+    std::vector<uint8_t> silence(8192 * 2, 0x69);
+    frames = converter.Process(silence.data(), 8192, pcm.data());
+    float peak = 0.0f;
+    for (size_t i = frames; i-- > frames / 2;) {
+        peak = std::max(peak, std::fabs(pcm[i * 2]));
+    }
+    allPassed &= Check(peak < 1e-3f, "Idle pattern is silent (peak " + std::to_string(peak) + ")");
+
+    allPassed &= Check(!converter.Initialize(dsdRate, 2, {DSDConverter::Quality::Fast, 48000}),
+                       "A PCM rate that is not a power-of-two fraction is rejected");
+    options.outputRate = 352800;
+    allPassed &= Check(converter.Initialize(dsdRate, 2, options) && converter.GetName().find("1 stage") != std::string::npos,
+                       "DSD64 -> 352.8kHz uses the lookup stage alone");
+    return allPassed;
+}
+
+static void WriteLE(std::ofstream& file, uint64_t value, int size) {
+    for (int i = 0; i < size; i++) {
+        file.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+static void WriteBE(std::ofstream& file, uint64_t value, int size) {
+    for (int i = size - 1; i >= 0; i--) {
+        file.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+static uint8_t Reverse(uint8_t value) {
+    uint8_t reversed = 0;
+    for (int bit = 0; bit < 8; bit++) {
+        reversed |= ((value >> bit) & 1) << (7 - bit);
+    }
+    return reversed;
+}
+
+static void ReadAll(DSDFileReader& reader, std::vector<uint8_t>& bytes) {
+    bytes.clear();
+    std::vector<uint8_t> block(1000 * reader.GetChannels());
+    size_t count;
+    while ((count = reader.Read(block.data(), 1000)) > 0) {
+        bytes.insert(bytes.end(), block.begin(), block.begin() + count * reader.GetChannels());
+    }
+}
+
+static bool TestFileReaders() {
+    const int channels = 2;
+    const size_t bytesPerChannel = 10000;   // Spans three DSF blocks, the last one padded
+    std::vector<uint8_t> expected(bytesPerChannel * channels);
+    for (size_t i = 0; i < expected.size(); i++) {
+        expected[i] = static_cast<uint8_t>(i * 37 + i / 251);
+    }
+
+    // DSF: per-channel 4096-byte blocks, least significant bit first
+    const char* dsfPath = "dsd_test.dsf";
+    {
+        const size_t blocks = (bytesPerChannel + 4095) / 4096;
+        std::ofstream file(dsfPath, std::ios::binary);
+        const uint64_t dataSize = 12 + blocks * 4096 * channels;
+        file.write("DSD ", 4); WriteLE(file, 28, 8); WriteLE(file, 28 + 52 + dataSize, 8); WriteLE(file, 0, 8);
+        file.write("fmt ", 4); WriteLE(file, 52, 8); WriteLE(file, 1, 4); WriteLE(file, 0, 4);
+        WriteLE(file, 2, 4); WriteLE(file, channels, 4); WriteLE(file, 5644800, 4); WriteLE(file, 1, 4);
+        WriteLE(file, bytesPerChannel * 8, 8); WriteLE(file, 4096, 4); WriteLE(file, 0, 4);
+        file.write("data", 4); WriteLE(file, dataSize, 8);
+        for (size_t block = 0; block < blocks; block++) {
+            for (int channel = 0; channel < channels; channel++) {
+                for (size_t i = block * 4096; i < (block + 1) * 4096; i++) {
+                    file.put(static_cast<char>(i < bytesPerChannel ? Reverse(expected[i * channels + channel]) : 0));
+                }
+            }
+        }
+    }
+
+    DSDFileReader reader;
+    std::vector<uint8_t> bytes;
+    bool allPassed = Check(reader.Open(dsfPath) && reader.GetFormatName() == "DSF" && reader.GetSampleRate() == 5644800 &&
+                           reader.GetChannels() == 2 && reader.GetLayout().GetName() == "stereo",
+                           "DSF header parsed");
+    ReadAll(reader, bytes);
+    allPassed &= Check(bytes == expected, "DSF blocks are reinterleaved and bit-reversed");
+    reader.Close();
+    std::remove(dsfPath);
+
+    // DSDIFF: byte-interleaved, most significant bit first, big-endian chunks
+    const char* dffPath = "dsd_test.dff";
+    {
+        std::ofstream file(dffPath, std::ios::binary);
+        const uint64_t propSize = 4 + (12 + 4) + (12 + 2 + 4 * channels) + (12 + 20);
+        file.write("FRM8", 4); WriteBE(file, 4 + 12 + 4 + 12 + propSize + 12 + expected.size(), 8); file.write("DSD ", 4);
+        file.write("FVER", 4); WriteBE(file, 4, 8); WriteBE(file, 0x01050000, 4);
+        file.write("PROP", 4); WriteBE(file, propSize, 8); file.write("SND ", 4);
+        file.write("FS  ", 4); WriteBE(file, 4, 8); WriteBE(file, 2822400, 4);
+        file.write("CHNL", 4); WriteBE(file, 2 + 4 * channels, 8); WriteBE(file, channels, 2);
+        file.write("SLFTSRGT", 8);
+        file.write("CMPR", 4); WriteBE(file, 20, 8); file.write("DSD ", 4);
+        file.put(14); file.write("not compressed", 14); file.put(0);
+        file.write("DSD ", 4); WriteBE(file, expected.size(), 8);
+        file.write(reinterpret_cast<const char*>(expected.data()), expected.size());
+    }
+
+    allPassed &= Check(reader.Open(dffPath) && reader.GetFormatName() == "DSDIFF" && reader.GetSampleRate() == 2822400 &&
+                       reader.GetSampleCount() == bytesPerChannel * 8 && reader.GetLayout().GetName() == "stereo",
+                       "DSDIFF properties parsed");
+    ReadAll(reader, bytes);
+    allPassed &= Check(bytes == expected, "DSDIFF sound data read unchanged");
+    reader.Close();
+    std::remove(dffPath);
+
+    allPassed &= Check(!reader.Open("dsd_test_missing.dsf"), "Missing files are rejected");
+    return allPassed;
+}
+
+// Convert one second of stereo DSD and return the realtime factor
+static double TimeConversion(int dsdRate, DSDConverter::Quality quality) {
+    const size_t bytesPerChannel = dsdRate / 8;
+    std::vector<uint8_t> dsd(bytesPerChannel * 2);
+    for (size_t i = 0; i < dsd.size(); i++) {
+        dsd[i] = static_cast<uint8_t>((i * 2654435761u) >> 13);
+    }
+
+    DSDConverter converter;
+    converter.Initialize(dsdRate, 2, {quality, 0});
+    std::vector<float> pcm(converter.GetMaxOutputFrames(65536) * 2);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset < bytesPerChannel; offset += 65536) {
+        converter.Process(&dsd[offset * 2], std::min<size_t>(65536, bytesPerChannel - offset), pcm.data());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return 1.0 / seconds;
+}
+
+static bool TestSpeed() {
+    bool allPassed = true;
+    const char* names[] = {"fast", "standard", "high"};
+    for (int multiple : {512, 1024}) {
+        for (int quality = 0; quality < 3; quality++) {
+            double factor = TimeConversion(44100 * multiple, static_cast<DSDConverter::Quality>(quality));
+            allPassed &= Check(factor > 1.0, "DSD" + std::to_string(multiple) + " stereo, " + names[quality] + ": " +
+                               std::to_string(factor) + "x realtime on one core");
+        }
+    }
+    return allPassed;
+}
+
+int main() {
+    std::cout << "=== DSD Conversion Test ===\n";
+
+    bool allPassed = TestSineConversion();
+    allPassed &= TestFileReaders();
+    allPassed &= TestSpeed();
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+#include "dsp/Resampler.h"
+#include "encoders/OggWriter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+// Checks the pieces of the encoding path that do not need codec libraries:
+// the streaming polyphase resampler and the Ogg page muxer.
+
+static bool TestPolyphaseMatchesOffline(int inputRate, int outputRate) {
+    std::vector<float> input(20000);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = std::sin(0.05f * i) + 0.3f * std::sin(0.71f * i);
+    }
+
+    std::vector<float> expected;
+    Resampler::ResampleOffline(input, inputRate, outputRate, expected);
+
+    // Feed blocks of varying size to exercise the streaming state
+    PolyphaseResampler resampler;
+    if (!resampler.Initialize(inputRate, outputRate, 1)) {
+        std::cout << "✗ Polyphase " << inputRate << " -> " << outputRate << ": initialization failed\n";
+        return false;
+    }
+    std::vector<float> output;
+    size_t block = 1;
+    for (size_t position = 0; position < input.size(); ) {
+        size_t count = std::min(block, input.size() - position);
+        resampler.Process(&input[position], count, output);
+        position += count;
+        block = block * 3 % 997 + 1;
+    }
+    resampler.Flush(output);
+
+    double maxError = 0.0;
+    for (size_t i = 0; i < std::min(output.size(), expected.size()); i++) {
+        maxError = std::max(maxError, static_cast<double>(std::fabs(output[i] - expected[i])));
+    }
+    bool passed = output.size() == expected.size() && maxError < 1e-5;
+    std::cout << (passed ? "✓ " : "✗ ") << "Polyphase " << inputRate << " -> " << outputRate
+              << ": " << output.size() << " samples, max error " << maxError << "\n";
+    return passed;
+}
+
+static bool TestOggPages() {
+    std::ostringstream stream;
+    OggWriter writer(stream, 0x1234);
+    const unsigned char header[] = {'h', 'e', 'a', 'd'};
+    writer.WritePacket(header, sizeof(header), 0, true, false);
+
+    std::vector<unsigned char> packet(300);
+    const int packetCount = 40;
+    for (int i = 0; i < packetCount; i++) {
+        std::memset(packet.data(), i, packet.size());
+        writer.WritePacket(packet.data(), packet.size(), (i + 1) * 960, false, i + 1 == packetCount);
+    }
+
+    // Walk the pages and verify sync, checksums, flags and the packet payloads
+    std::string data = stream.str();
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.data());
+    size_t position = 0;
+    int pages = 0;
+    int packets = 0;
+    bool passed = true;
+    unsigned char lastFlags = 0;
+    int64_t lastGranule = 0;
+    while (position + 27 <= data.size()) {
+        passed &= std::memcmp(bytes + position, "OggS", 4) == 0;
+        size_t segments = bytes[position + 26];
+        size_t bodySize = 0;
+        for (size_t s = 0; s < segments; s++) {
+            bodySize += bytes[position + 27 + s];
+        }
+        size_t pageSize = 27 + segments + bodySize;
+
+        std::vector<unsigned char> page(bytes + position, bytes + position + pageSize);
+        uint32_t stored = page[22] | (page[23] << 8) | (page[24] << 16) | (static_cast<uint32_t>(page[25]) << 24);
+        std::memset(&page[22], 0, 4);
+        passed &= OggWriter::Checksum(page.data(), page.size()) == stored;
+        passed &= (pages == 0) == ((bytes[position + 5] & 0x02) != 0);
+
+        // A lacing value below 255 ends a packet
+        size_t packetStart = position + 27 + segments;
+        size_t packetSize = 0;
+        for (size_t s = 0; s < segments; s++) {
+            packetSize += bytes[position + 27 + s];
+            if (bytes[position + 27 + s] < 255) {
+                if (pages > 0) {
+                    passed &= bytes[packetStart] == static_cast<unsigned char>(packets);
+                    packets++;
+                }
+                packetStart += packetSize;
+                packetSize = 0;
+            }
+        }
+
+        std::memcpy(&lastGranule, bytes + position + 6, 8);
+        lastFlags = bytes[position + 5];
+        position += pageSize;
+        pages++;
+    }
+
+    passed &= position == data.size() && packets == packetCount && (lastFlags & 0x04) &&
+              lastGranule == packetCount * 960 && writer.GetBytesWritten() == data.size();
+    std::cout << (passed ? "✓ " : "✗ ") << "Ogg muxing: " << pages << " pages, " << packets << " packets\n";
+    return passed;
+}
+
+int main() {
+    std::cout << "=== Encoder Path Test ===\n";
+    bool allPassed = TestPolyphaseMatchesOffline(44100, 48000);
+    allPassed &= TestPolyphaseMatchesOffline(96000, 44100);
+    allPassed &= TestOggPages();
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "dsp/EqualizerStage.h"
+#include "dsp/GainStage.h"
+#include "dsp/ProcessingChain.h"
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Checks the planar processing path: the equalizer's response at its band
+// centres, channel independence, and that the chain gives the same result
+// for interleaved and planar blocks of any channel count and size.
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+static EqualizerStage::Band MakeBand(double frequency, double gainDb, double q) {
+    EqualizerStage::Band band;
+    band.frequency = frequency;
+    band.gainDb = gainDb;
+    band.q = q;
+    return band;
+}
+
+// Gain in dB of the equalizer for a sine, measured after the filters settle
+static double MeasureGain(EqualizerStage& stage, double frequency) {
+    const int kRate = 48000;
+    const size_t kFrames = 4096;
+    stage.Reset();
+    std::vector<float> plane(kFrames);
+    double sumSquares = 0.0;
+    size_t measured = 0;
+    for (int block = 0; block < 8; block++) {
+        for (size_t i = 0; i < kFrames; i++) {
+            plane[i] = static_cast<float>(0.25 * std::sin(2.0 * M_PI * frequency * (block * kFrames + i) / kRate));
+        }
+        stage.Process(AudioBufferView(plane.data(), kFrames, 1, SampleLayout::Planar));
+        if (block >= 4) {
+            for (float sample : plane) {
+                sumSquares += static_cast<double>(sample) * sample;
+            }
+            measured += kFrames;
+        }
+    }
+    // RMS rather than peak: at a few samples per period the peaks fall between samples
+    return 20.0 * std::log10(std::sqrt(sumSquares / measured) / (0.25 / std::sqrt(2.0)));
+}
+
+static bool TestResponse() {
+    EqualizerStage stage(MakeBand(100.0, 6.0, 1.0), MakeBand(8000.0, -9.0, 2.0));
+    stage.Prepare(48000, 1, 4096);
+    const double low = MeasureGain(stage, 100.0);
+    const double high = MeasureGain(stage, 8000.0);
+    const double middle = MeasureGain(stage, 1000.0);
+    bool allPassed = Check(std::fabs(low - 6.0) < 0.2 && std::fabs(high + 9.0) < 0.2 && std::fabs(middle) < 0.5,
+                           "Band centres at +6 and -9 dB (" + std::to_string(low) + ", " + std::to_string(high) +
+                           "), 1kHz at " + std::to_string(middle) + " dB");
+
+    EqualizerStage flat(MakeBand(100.0, 0.0, 1.0), MakeBand(8000.0, 0.0, 1.0));
+    allPassed &= Check(flat.IsFlat() && !stage.IsFlat() && !flat.Prepare(48000, 0, 256),
+                       "Flat settings detected; invalid formats rejected");
+    return allPassed;
+}
+
+static std::vector<float> Signal(size_t count) {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = static_cast<float>(std::sin(0.37 * i) * 0.5 + std::sin(0.011 * i) * 0.3);
+    }
+    return samples;
+}
+
+static bool TestChainLayouts(int channels) {
+    const size_t kPrepared = 256;
+    const size_t kFrames = 1000;   // Several prepared blocks and a partial one
+    auto makeChain = [&](ProcessingChain& chain) {
+        chain.Prepare(channels, kPrepared);
+        auto eq = std::make_unique<EqualizerStage>(MakeBand(200.0, 4.0, 0.8), MakeBand(5000.0, -3.0, 1.5));
+        auto gain = std::make_unique<GainStage>(0.5f);
+        eq->Prepare(48000, channels, kPrepared);
+        gain->Prepare(48000, channels, kFrames);
+        chain.SetStage("eq", std::move(eq));
+        chain.SetStage("volume", std::move(gain));
+    };
+
+    // Channel c carries the signal scaled by c + 1; the last channel is silent
+    const std::vector<float> signal = Signal(kFrames);
+    std::vector<float> interleaved(kFrames * channels), planar(kFrames * channels);
+    for (size_t i = 0; i < kFrames; i++) {
+        for (int c = 0; c < channels; c++) {
+            const float value = c + 1 == channels && channels > 1 ? 0.0f : signal[i] * (c + 1) * 0.25f;
+            interleaved[i * channels + c] = value;
+            planar[c * kFrames + i] = value;
+        }
+    }
+
+    ProcessingChain interleavedChain, planarChain;
+    makeChain(interleavedChain);
+    makeChain(planarChain);
+    interleavedChain.Process(AudioBufferView(interleaved.data(), kFrames, channels));
+    for (size_t start = 0; start < kFrames; start += kPrepared) {
+        // Planar blocks go to the stages directly, so they are kept within the prepared size
+        AudioBufferView block(planar.data(), kFrames, channels, SampleLayout::Planar);
+        std::vector<float> part(kPrepared * channels);
+        AudioBufferView range = block.Subview(start, kPrepared);
+        AudioBufferView packed(part.data(), range.Frames(), channels, SampleLayout::Planar);
+        for (int c = 0; c < channels; c++) {
+            std::copy(range.Channel(c), range.Channel(c) + range.Frames(), packed.Channel(c));
+        }
+        planarChain.Process(packed);
+        for (int c = 0; c < channels; c++) {
+            std::copy(packed.Channel(c), packed.Channel(c) + range.Frames(), range.Channel(c));
+        }
+    }
+
+    bool identical = true;
+    bool silent = true;
+    for (size_t i = 0; i < kFrames; i++) {
+        for (int c = 0; c < channels; c++) {
+            identical &= interleaved[i * channels + c] == planar[c * kFrames + i];
+        }
+        silent &= channels == 1 || interleaved[i * channels + channels - 1] == 0.0f;
+    }
+    return Check(identical && silent, std::to_string(channels) + " channels: interleaved and planar blocks match, "
+                 "channels stay independent");
+}
+
+int main() {
+    std::cout << "=== Equalizer and Planar Chain Test ===\n";
+
+    bool allPassed = TestResponse();
+    for (int channels : {1, 2, 3, 6}) {
+        allPassed &= TestChainLayouts(channels);
+    }
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+#include "core/Log.h"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// Checks the asynchronous logger: disabled levels do not evaluate their
+// arguments, messages queued from another thread reach the console only
+// through the writer, repeats of a call site are suppressed and counted,
+// and a flood of messages is dropped and reported instead of blocking.
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+static size_t CountLines(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t position = text.find(pattern); position != std::string::npos; position = text.find(pattern, position + 1)) {
+        count++;
+    }
+    return count;
+}
+
+static int evaluations = 0;
+
+static int Evaluate() {
+    return ++evaluations;
+}
+
+// Runs the logger with the console redirected into a string
+static std::string Capture(void (*body)()) {
+    std::ostringstream captured;
+    std::streambuf* console = std::cout.rdbuf(captured.rdbuf());
+    Log::Start();
+    body();
+    Log::Stop();
+    std::cout.rdbuf(console);
+    return captured.str();
+}
+
+static bool TestLevels() {
+    std::string result;
+    bool allPassed = Check(Log::SetLevel("dsp", "warning", result) && !Log::SetLevel("dsp", "loud", result) &&
+                           !Log::SetLevel("network", "info", result), "Levels set by name; unknown names rejected");
+
+    std::string output = Capture([]() {
+        GPU_PLAYER_LOG(DSP, Info, "skipped %d", Evaluate());
+        GPU_PLAYER_LOG(DSP, Warning, "written %d", Evaluate());
+    });
+    allPassed &= Check(evaluations == 1 && output.find("skipped") == std::string::npos &&
+                       output.find("Warning: written 1") != std::string::npos,
+                       "Disabled level skips formatting and its arguments");
+    Log::SetLevel("all", "info", result);
+    return allPassed;
+}
+
+static bool TestRateLimit() {
+    std::string output = Capture([]() {
+        std::thread worker([]() {
+            for (int i = 0; i < 100; i++) {
+                GPU_PLAYER_LOG(Playback, Info, "block %d", i);
+            }
+        });
+        worker.join();
+    });
+    // The loop may straddle a second boundary, which lets a second burst through
+    const size_t written = CountLines(output, "block ");
+    bool allPassed = Check(written >= Log::kRepeatsPerSecond && written <= 2 * Log::kRepeatsPerSecond,
+                           std::to_string(written) + " of 100 repeats written from the worker thread");
+    allPassed &= Check(Log::GetSuppressedCount() == 100 - written, "Repeats counted: " + Log::Describe());
+    return allPassed;
+}
+
+static bool TestFlood() {
+    std::string output = Capture([]() {
+        for (size_t i = 0; i < Log::kQueueRecords * 4; i++) {
+            Log::Write(Log::Category::Engine, Log::Level::Info, nullptr, "flood %zu", i);
+        }
+    });
+    const size_t written = CountLines(output, "flood ");
+    bool allPassed = Check(Log::GetDroppedCount() > 0 && written + Log::GetDroppedCount() == Log::kQueueRecords * 4 &&
+                           output.find("log messages dropped") != std::string::npos,
+                           std::to_string(written) + " written, " + std::to_string(Log::GetDroppedCount()) +
+                           " dropped and reported");
+
+    std::ostringstream captured;
+    std::streambuf* console = std::cout.rdbuf(captured.rdbuf());
+    GPU_PLAYER_LOG(Engine, Error, "direct");
+    std::cout.rdbuf(console);
+    allPassed &= Check(captured.str() == "Error: direct\n", "Written directly when the writer is stopped");
+    return allPassed;
+}
+
+int main() {
+    std::cout << "=== Log Test ===\n";
+
+    bool allPassed = TestLevels();
+    allPassed &= TestRateLimit();
+    allPassed &= TestFlood();
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
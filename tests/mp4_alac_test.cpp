@@ -0,0 +1,796 @@
+#include "decoders/MP4Decoder.h"
+#include "decoders/MP4Reader.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Checks MP4/ALAC decoding against files built here: an ALAC encoder that
+// follows the reference bitstream (Rice codes with runs of zeros, adaptive
+// prediction, stereo mixing, shifted low bytes, escape and partial packets)
+// wrapped in MP4 files with the 'moov' box at the end, at the start with an
+// edit list, and split into movie fragments. Decoding must return the source
+// samples exactly, in WAV channel order, and seeks must land on the frame.
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+typedef std::vector<unsigned char> Bytes;
+
+// ---------------------------------------------------------------------------
+// ALAC encoder
+
+struct AlacConfig {
+    uint32_t frameLength = 4096;
+    unsigned bitDepth = 16;
+    unsigned historyMult = 40;
+    unsigned initialHistory = 10;
+    unsigned riceLimit = 14;
+    int channels = 2;
+    uint32_t sampleRate = 44100;
+};
+
+// How one packet is coded
+struct PacketStyle {
+    bool escape = false;
+    unsigned order = 4;         // 0, 31 or an LPC order
+    unsigned mode = 0;          // Nonzero: first-order pass before the predictor
+    unsigned bytesShifted = 0;
+    int mixRes = 2;             // Stereo mix weight (0: left and right coded apart)
+};
+
+class BitWriter {
+public:
+    void Put(uint32_t value, unsigned count) {
+        for (unsigned i = count; i-- > 0;) {
+            if (bits % 8 == 0) {
+                bytes.push_back(0);
+            }
+            if ((value >> i) & 1) {
+                bytes.back() |= static_cast<unsigned char>(0x80 >> (bits % 8));
+            }
+            bits++;
+        }
+    }
+    Bytes bytes;
+    size_t bits = 0;
+};
+
+static int32_t SignExtend(uint32_t value, unsigned bits) {
+    const unsigned shift = 32 - bits;
+    return static_cast<int32_t>(value << shift) >> shift;
+}
+
+static int32_t SignOf(int32_t value) {
+    return (value > 0) - (value < 0);
+}
+
+static void PutRice(BitWriter& out, uint32_t value, uint32_t m, unsigned k, unsigned escapeBits) {
+    const uint32_t prefix = value / m;
+    if (prefix >= 9) {
+        out.Put(0x1ff, 9);
+        out.Put(value, escapeBits);
+        return;
+    }
+    out.Put((1u << prefix) - 1, prefix);
+    out.Put(0, 1);
+    const uint32_t rest = value - prefix * m;
+    if (rest == 0) {
+        out.Put(0, k - 1);
+    } else {
+        out.Put(rest + 1, k);
+    }
+}
+
+static void PutResiduals(BitWriter& out, const std::vector<int32_t>& residuals, unsigned chanBits,
+                         unsigned multiplierFactor, const AlacConfig& config) {
+    const uint32_t multiplier = config.historyMult * multiplierFactor / 4;
+    uint32_t history = config.initialHistory;
+    uint32_t afterRun = 0;
+    size_t i = 0;
+    while (i < residuals.size()) {
+        uint32_t scaled = (history >> 9) + 3;
+        unsigned k = 0;
+        while (scaled >>= 1) {
+            k++;
+        }
+        k = std::min(k, config.riceLimit);
+        const int32_t residual = residuals[i++];
+        const uint32_t coded = residual >= 0 ? 2u * static_cast<uint32_t>(residual)
+                                             : 2u * static_cast<uint32_t>(-static_cast<int64_t>(residual)) - 1;
+        const uint32_t value = coded - afterRun;
+        PutRice(out, value, (1u << k) - 1, k, chanBits);
+        history = multiplier * coded + history - ((multiplier * history) >> 9);
+        if (value > 0xffff) {
+            history = 0xffff;
+        }
+        afterRun = 0;
+        if (history < 128 && i < residuals.size()) {
+            uint32_t run = 0;
+            while (i + run < residuals.size() && residuals[i + run] == 0 && run < 65535) {
+                run++;
+            }
+            unsigned zeros = 0;
+            for (uint32_t bit = 0x80000000u; bit && !(history & bit); bit >>= 1) {
+                zeros++;
+            }
+            const unsigned runK = zeros - 24 + ((history + 16) >> 6);
+            PutRice(out, run, ((1u << runK) - 1) & ((1u << config.riceLimit) - 1), runK, 16);
+            i += run;
+            afterRun = run < 65535 ? 1 : 0;
+            history = 0;
+        }
+    }
+}
+
+// The encoder side of the adaptive predictor: residuals that the decoder turns back into samples
+static std::vector<int32_t> Predict(const std::vector<int32_t>& samples, int16_t* coefficients, unsigned order,
+                                    unsigned chanBits, unsigned denShift) {
+    std::vector<int32_t> residuals(samples.size());
+    const size_t count = samples.size();
+    residuals[0] = samples[0];
+    if (order == 0) {
+        return samples;
+    }
+    if (order == 31) {
+        for (size_t j = 1; j < count; j++) {
+            residuals[j] = SignExtend(static_cast<uint32_t>(samples[j]) - static_cast<uint32_t>(samples[j - 1]),
+                                      chanBits);
+        }
+        return residuals;
+    }
+    for (size_t j = 1; j <= order && j < count; j++) {
+        residuals[j] = SignExtend(static_cast<uint32_t>(samples[j]) - static_cast<uint32_t>(samples[j - 1]), chanBits);
+    }
+    const uint32_t rounding = 1u << (denShift - 1);
+    for (size_t j = order + 1; j < count; j++) {
+        const int32_t* history = samples.data() + j - 1;
+        const int32_t top = samples[j - order - 1];
+        uint32_t sum = 0;
+        for (unsigned k = 0; k < order; k++) {
+            sum += static_cast<uint32_t>(coefficients[k]) *
+                   (static_cast<uint32_t>(history[-static_cast<int>(k)]) - static_cast<uint32_t>(top));
+        }
+        const int32_t prediction = static_cast<int32_t>(sum + rounding) >> denShift;
+        const int32_t residual = SignExtend(static_cast<uint32_t>(samples[j]) - static_cast<uint32_t>(top) -
+                                            static_cast<uint32_t>(prediction), chanBits);
+        residuals[j] = residual;
+
+        // Reference encoder adaptation (pc_block), written as its two sign cases
+        int32_t remaining = residual;
+        if (residual > 0) {
+            for (int k = static_cast<int>(order) - 1; k >= 0; k--) {
+                const int32_t difference = top - history[-k];
+                const int32_t sign = SignOf(difference);
+                coefficients[k] = static_cast<int16_t>(coefficients[k] - sign);
+                remaining -= static_cast<int32_t>(order - k) * ((sign * difference) >> denShift);
+                if (remaining <= 0) {
+                    break;
+                }
+            }
+        } else if (residual < 0) {
+            for (int k = static_cast<int>(order) - 1; k >= 0; k--) {
+                const int32_t difference = top - history[-k];
+                const int32_t sign = SignOf(difference);
+                coefficients[k] = static_cast<int16_t>(coefficients[k] + sign);
+                remaining -= static_cast<int32_t>(order - k) * ((-sign * difference) >> denShift);
+                if (remaining >= 0) {
+                    break;
+                }
+            }
+        }
+    }
+    return residuals;
+}
+
+// ALAC channel order into elements: SCE, CPE, CPE, SCE for 5.1 and so on
+static std::vector<int> ElementSizes(int channels) {
+    switch (channels) {
+    case 1: return {1};
+    case 2: return {2};
+    case 3: return {1, 2};
+    case 4: return {1, 2, 1};
+    case 5: return {1, 2, 2};
+    case 6: return {1, 2, 2, 1};
+    case 7: return {1, 2, 2, 1, 1};
+    default: return {1, 2, 2, 2, 1};
+    }
+}
+
+// Encode frames of samples (one vector per channel, ALAC order)
+static Bytes EncodePacket(const std::vector<std::vector<int32_t>>& channels, const AlacConfig& config,
+                          const PacketStyle& style) {
+    BitWriter out;
+    const uint32_t count = static_cast<uint32_t>(channels[0].size());
+    const bool partial = count != config.frameLength;
+    size_t channel = 0;
+    for (int elementChannels : ElementSizes(config.channels)) {
+        const bool pair = elementChannels == 2;
+        const bool lfe = !pair && config.channels == 6 && channel == 5;
+        out.Put(pair ? 1 : (lfe ? 3 : 0), 3);
+        out.Put(0, 4);
+        out.Put(0, 12);
+        const unsigned bytesShifted = style.escape ? 0 : style.bytesShifted;
+        const unsigned shift = bytesShifted * 8;
+        out.Put((partial ? 8 : 0) | (bytesShifted << 1) | (style.escape ? 1 : 0), 4);
+        if (partial) {
+            out.Put(count, 32);
+        }
+
+        if (style.escape) {
+            for (uint32_t i = 0; i < count; i++) {
+                for (int c = 0; c < elementChannels; c++) {
+                    out.Put(static_cast<uint32_t>(channels[channel + c][i]) & ((1ull << config.bitDepth) - 1),
+                            config.bitDepth);
+                }
+            }
+            channel += elementChannels;
+            continue;
+        }
+
+        // Split off the low bytes, then mix a pair into u (weighted) and v (difference)
+        std::vector<std::vector<int32_t>> coded(elementChannels, std::vector<int32_t>(count));
+        std::vector<uint32_t> low;
+        for (uint32_t i = 0; i < count; i++) {
+            for (int c = 0; c < elementChannels; c++) {
+                const int32_t sample = channels[channel + c][i];
+                coded[c][i] = sample >> shift;
+                if (shift > 0) {
+                    low.push_back(static_cast<uint32_t>(sample) & ((1u << shift) - 1));
+                }
+            }
+        }
+        const unsigned mixBits = 2;
+        const int mixRes = pair ? style.mixRes : 0;
+        if (pair && mixRes != 0) {
+            for (uint32_t i = 0; i < count; i++) {
+                const int32_t left = coded[0][i];
+                const int32_t right = coded[1][i];
+                coded[0][i] = (mixRes * left + ((1 << mixBits) - mixRes) * right) >> mixBits;
+                coded[1][i] = left - right;
+            }
+        }
+
+        const unsigned chanBits = config.bitDepth - shift + (pair ? 1 : 0);
+        const unsigned denShift = 9;
+        const unsigned factor = 4;
+        out.Put(pair ? mixBits : 0, 8);
+        out.Put(static_cast<uint8_t>(mixRes), 8);
+        const int16_t initial[8] = {700, -300, 120, -40, 20, -10, 5, -2};
+        std::vector<std::vector<int32_t>> residuals;
+        for (int c = 0; c < elementChannels; c++) {
+            out.Put((style.mode << 4) | denShift, 8);
+            out.Put((factor << 5) | style.order, 8);
+            // Order 31 (first-order prediction) still carries 31 unused coefficients
+            int16_t coefficients[32] = {};
+            for (unsigned k = 0; k < style.order; k++) {
+                coefficients[k] = style.order == 31 ? 0 : initial[k % 8];
+                out.Put(static_cast<uint16_t>(coefficients[k]), 16);
+            }
+            std::vector<int32_t> r = Predict(coded[c], coefficients, style.order, chanBits, denShift);
+            if (style.mode != 0) {
+                r = Predict(r, nullptr, 31, chanBits, 0);
+            }
+            residuals.push_back(r);
+        }
+        for (uint32_t value : low) {
+            out.Put(value, shift);
+        }
+        for (int c = 0; c < elementChannels; c++) {
+            PutResiduals(out, residuals[c], chanBits, factor, config);
+        }
+        channel += elementChannels;
+    }
+    out.Put(7, 3);
+    return out.bytes;
+}
+
+static Bytes MakeCookie(const AlacConfig& config) {
+    Bytes cookie(24, 0);
+    auto put32 = [&](size_t at, uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            cookie[at + i] = static_cast<unsigned char>(value >> (24 - 8 * i));
+        }
+    };
+    put32(0, config.frameLength);
+    cookie[5] = static_cast<unsigned char>(config.bitDepth);
+    cookie[6] = static_cast<unsigned char>(config.historyMult);
+    cookie[7] = static_cast<unsigned char>(config.initialHistory);
+    cookie[8] = static_cast<unsigned char>(config.riceLimit);
+    cookie[9] = static_cast<unsigned char>(config.channels);
+    cookie[10] = 0;
+    cookie[11] = 255;
+    put32(20, config.sampleRate);
+    return cookie;
+}
+
+// ---------------------------------------------------------------------------
+// MP4 writer
+
+static void Put32(Bytes& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<unsigned char>(value >> (24 - 8 * i)));
+    }
+}
+
+static void Put16(Bytes& out, uint16_t value) {
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+static Bytes MakeBox(const char* type, const Bytes& payload) {
+    Bytes box;
+    Put32(box, static_cast<uint32_t>(payload.size() + 8));
+    box.insert(box.end(), type, type + 4);
+    box.insert(box.end(), payload.begin(), payload.end());
+    return box;
+}
+
+static Bytes FullBoxPayload(uint8_t version, uint32_t flags) {
+    Bytes payload;
+    Put32(payload, (static_cast<uint32_t>(version) << 24) | flags);
+    return payload;
+}
+
+static Bytes Join(std::initializer_list<Bytes> parts) {
+    Bytes joined;
+    for (const Bytes& part : parts) {
+        joined.insert(joined.end(), part.begin(), part.end());
+    }
+    return joined;
+}
+
+struct Movie {
+    AlacConfig config;
+    std::vector<Bytes> packets;
+    std::vector<uint32_t> durations;
+    uint32_t editStart = 0;       // Edit list when editDuration > 0
+    uint32_t editDuration = 0;
+};
+
+// Sample table with chunks of 5 samples, then 3, at the given offsets
+static Bytes MakeTrack(const Movie& movie, const std::vector<uint64_t>& chunkOffsets,
+                       const std::vector<uint32_t>& chunkSamples, bool fragmented) {
+    const AlacConfig& config = movie.config;
+    Bytes entry(6, 0);
+    Put16(entry, 1);
+    entry.insert(entry.end(), 8, 0);
+    Put16(entry, static_cast<uint16_t>(config.channels));
+    Put16(entry, static_cast<uint16_t>(config.bitDepth));
+    Put32(entry, 0);
+    Put32(entry, config.sampleRate << 16);
+    const Bytes cookie = MakeCookie(config);
+    Bytes alacPayload = FullBoxPayload(0, 0);
+    alacPayload.insert(alacPayload.end(), cookie.begin(), cookie.end());
+    entry = Join({entry, MakeBox("alac", alacPayload)});
+    Bytes stsd = FullBoxPayload(0, 0);
+    Put32(stsd, 1);
+    stsd = Join({stsd, MakeBox("alac", entry)});
+
+    Bytes stts = FullBoxPayload(0, 0);
+    Bytes stsz = FullBoxPayload(0, 0);
+    Bytes stsc = FullBoxPayload(0, 0);
+    Bytes stco = FullBoxPayload(0, 0);
+    if (fragmented) {
+        Put32(stts, 0);
+        Put32(stsz, 0);
+        Put32(stsz, 0);
+        Put32(stsc, 0);
+        Put32(stco, 0);
+    } else {
+        std::vector<std::pair<uint32_t, uint32_t>> runs;
+        for (uint32_t d : movie.durations) {
+            if (runs.empty() || runs.back().second != d) {
+                runs.push_back({0, d});
+            }
+            runs.back().first++;
+        }
+        Put32(stts, static_cast<uint32_t>(runs.size()));
+        for (const auto& run : runs) {
+            Put32(stts, run.first);
+            Put32(stts, run.second);
+        }
+        Put32(stsz, 0);
+        Put32(stsz, static_cast<uint32_t>(movie.packets.size()));
+        for (const Bytes& packet : movie.packets) {
+            Put32(stsz, static_cast<uint32_t>(packet.size()));
+        }
+        std::vector<std::pair<uint32_t, uint32_t>> chunkRuns;
+        for (size_t c = 0; c < chunkSamples.size(); c++) {
+            if (chunkRuns.empty() || chunkRuns.back().second != chunkSamples[c]) {
+                chunkRuns.push_back({static_cast<uint32_t>(c + 1), chunkSamples[c]});
+            }
+        }
+        Put32(stsc, static_cast<uint32_t>(chunkRuns.size()));
+        for (const auto& run : chunkRuns) {
+            Put32(stsc, run.first);
+            Put32(stsc, run.second);
+            Put32(stsc, 1);
+        }
+        Put32(stco, static_cast<uint32_t>(chunkOffsets.size()));
+        for (uint64_t offset : chunkOffsets) {
+            Put32(stco, static_cast<uint32_t>(offset));
+        }
+    }
+    const Bytes stbl = MakeBox("stbl", Join({MakeBox("stsd", stsd), MakeBox("stts", stts), MakeBox("stsc", stsc),
+                                             MakeBox("stsz", stsz), MakeBox("stco", stco)}));
+
+    Bytes mdhd = FullBoxPayload(0, 0);
+    Put32(mdhd, 0);
+    Put32(mdhd, 0);
+    Put32(mdhd, config.sampleRate);
+    Put32(mdhd, 0);
+    Put32(mdhd, 0);
+    Bytes hdlr = FullBoxPayload(0, 0);
+    Put32(hdlr, 0);
+    hdlr.insert(hdlr.end(), {'s', 'o', 'u', 'n'});
+    hdlr.insert(hdlr.end(), 13, 0);
+    Bytes tkhd = FullBoxPayload(0, 7);
+    Put32(tkhd, 0);
+    Put32(tkhd, 0);
+    Put32(tkhd, 1);
+    tkhd.insert(tkhd.end(), 68, 0);
+    Bytes edts;
+    if (movie.editDuration > 0) {
+        Bytes elst = FullBoxPayload(0, 0);
+        Put32(elst, 1);
+        Put32(elst, movie.editDuration);
+        Put32(elst, movie.editStart);
+        Put32(elst, 0x10000);
+        edts = MakeBox("edts", MakeBox("elst", elst));
+    }
+    const Bytes minf = MakeBox("minf", Join({MakeBox("smhd", FullBoxPayload(0, 0)), stbl}));
+    return MakeBox("trak", Join({MakeBox("tkhd", tkhd), edts,
+                                 MakeBox("mdia", Join({MakeBox("mdhd", mdhd), MakeBox("hdlr", hdlr), minf}))}));
+}
+
+static Bytes MakeMovieBox(const Movie& movie, const std::vector<uint64_t>& chunkOffsets,
+                          const std::vector<uint32_t>& chunkSamples, bool fragmented) {
+    Bytes mvhd = FullBoxPayload(0, 0);
+    Put32(mvhd, 0);
+    Put32(mvhd, 0);
+    Put32(mvhd, movie.config.sampleRate);
+    mvhd.insert(mvhd.end(), 84, 0);
+    Bytes mvex;
+    if (fragmented) {
+        Bytes trex = FullBoxPayload(0, 0);
+        Put32(trex, 1);
+        Put32(trex, 1);
+        Put32(trex, movie.config.frameLength);
+        Put32(trex, 0);
+        Put32(trex, 0);
+        mvex = MakeBox("mvex", MakeBox("trex", trex));
+    }
+    return MakeBox("moov", Join({MakeBox("mvhd", mvhd), MakeTrack(movie, chunkOffsets, chunkSamples, fragmented),
+                                 mvex}));
+}
+
+static Bytes MakeFileType() {
+    Bytes ftyp = {'M', '4', 'A', ' ', 0, 0, 0, 0, 'M', '4', 'A', ' ', 'i', 's', 'o', 'm'};
+    return MakeBox("ftyp", ftyp);
+}
+
+// Chunks of 5 samples, then of 3, and a gap of padding between chunks
+static void LayOutChunks(const Movie& movie, uint64_t dataStart, Bytes& data, std::vector<uint64_t>& chunkOffsets,
+                         std::vector<uint32_t>& chunkSamples) {
+    size_t sample = 0;
+    while (sample < movie.packets.size()) {
+        const uint32_t count = static_cast<uint32_t>(std::min<size_t>(chunkOffsets.size() < 4 ? 5 : 3,
+                                                                      movie.packets.size() - sample));
+        data.insert(data.end(), 7, 0xEE);
+        chunkOffsets.push_back(dataStart + data.size());
+        chunkSamples.push_back(count);
+        for (uint32_t i = 0; i < count; i++, sample++) {
+            data.insert(data.end(), movie.packets[sample].begin(), movie.packets[sample].end());
+        }
+    }
+}
+
+static Bytes WriteMoovLast(const Movie& movie) {
+    const Bytes ftyp = MakeFileType();
+    Bytes data;
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> samples;
+    LayOutChunks(movie, ftyp.size() + 8, data, offsets, samples);
+    return Join({ftyp, MakeBox("mdat", data), MakeMovieBox(movie, offsets, samples, false)});
+}
+
+static Bytes WriteMoovFirst(const Movie& movie) {
+    const Bytes ftyp = MakeFileType();
+    Bytes data;
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> samples;
+    LayOutChunks(movie, 0, data, offsets, samples);
+    const size_t moovSize = MakeMovieBox(movie, offsets, samples, false).size();
+    for (uint64_t& offset : offsets) {
+        offset += ftyp.size() + moovSize + 8;
+    }
+    return Join({ftyp, MakeMovieBox(movie, offsets, samples, false), MakeBox("mdat", data)});
+}
+
+// Fragments of up to 6 samples; sample durations come from 'trex' except where they differ
+static Bytes WriteFragmented(const Movie& movie) {
+    Bytes file = Join({MakeFileType(), MakeMovieBox(movie, {}, {}, true)});
+    for (size_t first = 0, sequence = 1; first < movie.packets.size(); first += 6, sequence++) {
+        const size_t count = std::min<size_t>(6, movie.packets.size() - first);
+        Bytes tfhd = FullBoxPayload(0, 0x20000);
+        Put32(tfhd, 1);
+        Bytes tfdt = FullBoxPayload(0, 0);
+        Put32(tfdt, 0);
+        Bytes data;
+        auto makeTrun = [&](uint32_t dataOffset) {
+            Bytes trun = FullBoxPayload(0, 0x1 | 0x100 | 0x200);
+            Put32(trun, static_cast<uint32_t>(count));
+            Put32(trun, dataOffset);
+            for (size_t i = first; i < first + count; i++) {
+                Put32(trun, movie.durations[i]);
+                Put32(trun, static_cast<uint32_t>(movie.packets[i].size()));
+            }
+            return trun;
+        };
+        for (size_t i = first; i < first + count; i++) {
+            data.insert(data.end(), movie.packets[i].begin(), movie.packets[i].end());
+        }
+        Bytes mfhd = FullBoxPayload(0, 0);
+        Put32(mfhd, static_cast<uint32_t>(sequence));
+        auto makeMoof = [&](uint32_t dataOffset) {
+            return MakeBox("moof", Join({MakeBox("mfhd", mfhd),
+                                         MakeBox("traf", Join({MakeBox("tfhd", tfhd), MakeBox("tfdt", tfdt),
+                                                               MakeBox("trun", makeTrun(dataOffset))}))}));
+        };
+        const size_t moofSize = makeMoof(0).size();
+        file = Join({file, makeMoof(static_cast<uint32_t>(moofSize + 8)), MakeBox("mdat", data)});
+    }
+    return file;
+}
+
+static void WriteFile(const std::string& path, const Bytes& bytes) {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+// ---------------------------------------------------------------------------
+// Source material
+
+struct Source {
+    std::vector<std::vector<int32_t>> channels;   // ALAC order
+};
+
+// Tones with noise, a stretch of digital silence, and full-scale peaks
+static Source MakeSource(int channels, size_t frames, unsigned bitDepth) {
+    Source source;
+    const double full = std::ldexp(1.0, static_cast<int>(bitDepth) - 1);
+    uint32_t noise = 12345;
+    for (int c = 0; c < channels; c++) {
+        std::vector<int32_t> samples(frames);
+        for (size_t i = 0; i < frames; i++) {
+            noise = noise * 1664525u + 1013904223u;
+            double value = 0.5 * std::sin(2.0 * M_PI * (220.0 + 110.0 * c) * i / 44100.0) +
+                           0.01 * ((noise >> 8) / 16777216.0 - 0.5);
+            if (i >= frames / 3 && i < frames / 3 + 6000) {
+                value = 0.0;
+            }
+            int64_t sample = static_cast<int64_t>(std::lround(value * full));
+            if (i % 5000 == 77) {
+                sample = c % 2 ? static_cast<int64_t>(-full) : static_cast<int64_t>(full) - 1;
+            }
+            samples[i] = static_cast<int32_t>(sample);
+        }
+        source.channels.push_back(samples);
+    }
+    return source;
+}
+
+// Packets of frameLength frames (the last one partial), coded in turn with each style
+static Movie Encode(const Source& source, const AlacConfig& config, const std::vector<PacketStyle>& styles) {
+    Movie movie;
+    movie.config = config;
+    const size_t frames = source.channels[0].size();
+    for (size_t start = 0, n = 0; start < frames; start += config.frameLength, n++) {
+        const size_t count = std::min<size_t>(config.frameLength, frames - start);
+        std::vector<std::vector<int32_t>> block;
+        for (const auto& channel : source.channels) {
+            block.emplace_back(channel.begin() + start, channel.begin() + start + count);
+        }
+        movie.packets.push_back(EncodePacket(block, config, styles[n % styles.size()]));
+        movie.durations.push_back(static_cast<uint32_t>(count));
+    }
+    return movie;
+}
+
+// Interleaved little-endian PCM in WAV order, as the decoder returns it
+static Bytes ExpectedPcm(const Source& source, unsigned bitDepth, const std::vector<int>& wavChannel) {
+    const size_t bytes = bitDepth == 16 ? 2 : bitDepth == 32 ? 4 : 3;
+    const unsigned justify = static_cast<unsigned>(bytes * 8) - bitDepth;
+    const size_t channels = source.channels.size();
+    const size_t frames = source.channels[0].size();
+    Bytes pcm(frames * channels * bytes);
+    for (size_t i = 0; i < frames; i++) {
+        for (size_t c = 0; c < channels; c++) {
+            const uint32_t value = static_cast<uint32_t>(source.channels[c][i]) << justify;
+            for (size_t b = 0; b < bytes; b++) {
+                pcm[(i * channels + wavChannel[c]) * bytes + b] = static_cast<unsigned char>(value >> (8 * b));
+            }
+        }
+    }
+    return pcm;
+}
+
+static Bytes DecodeAll(MP4Decoder& decoder, size_t chunkFrames) {
+    const size_t blockAlign = static_cast<size_t>(decoder.GetChannels()) * decoder.GetBitsPerSample() / 8;
+    std::vector<char> buffer(chunkFrames * blockAlign);
+    Bytes all;
+    size_t frames;
+    while ((frames = decoder.Read(PcmBufferView(buffer.data(), chunkFrames, decoder.GetChannels(),
+                                                decoder.GetBitsPerSample()))) > 0) {
+        all.insert(all.end(), buffer.begin(), buffer.begin() + frames * blockAlign);
+    }
+    return all;
+}
+
+static bool TestFormat(const std::string& path, const std::string& name, int channels, unsigned bitDepth,
+                       const std::vector<PacketStyle>& styles, const std::vector<int>& wavChannel) {
+    AlacConfig config;
+    config.channels = channels;
+    config.bitDepth = bitDepth;
+    const Source source = MakeSource(channels, 4096 * 9 + 1234, bitDepth);
+    const Movie movie = Encode(source, config, styles);
+    const Bytes expected = ExpectedPcm(source, bitDepth, wavChannel);
+    WriteFile(path, WriteMoovLast(movie));
+
+    MP4Decoder decoder;
+    if (!decoder.Open(path)) {
+        return Check(false, name + " opened");
+    }
+    const Bytes whole = DecodeAll(decoder, 100000);
+    bool allPassed = Check(whole == expected && decoder.GetFrameCount() == source.channels[0].size(),
+                           name + " decodes exactly (" + std::to_string(movie.packets.size()) + " packets)");
+
+    decoder.Seek(0);
+    allPassed &= Check(DecodeAll(decoder, 1000) == expected, name + " decodes exactly in small reads");
+    return allPassed;
+}
+
+static bool TestLayoutsAndSeeking(const std::string& path) {
+    AlacConfig config;
+    const Source source = MakeSource(2, 4096 * 40 + 999, 16);
+    std::vector<PacketStyle> styles(5);
+    styles[1].order = 8;
+    styles[1].mixRes = 0;
+    styles[2].order = 31;
+    styles[3].escape = true;
+    styles[4].mode = 1;
+    const Movie movie = Encode(source, config, styles);
+    const Bytes expected = ExpectedPcm(source, 16, {0, 1});
+    const size_t blockAlign = 4;
+    bool allPassed = true;
+
+    struct Variant {
+        const char* name;
+        Bytes bytes;
+        size_t boxesRead;
+        bool fragmented;
+    };
+    const size_t fragments = (movie.packets.size() + 5) / 6;
+    std::vector<Variant> variants = {
+        {"'moov' after 'mdat'", WriteMoovLast(movie), 1, false},
+        {"'moov' before 'mdat'", WriteMoovFirst(movie), 1, false},
+        {"Fragmented", WriteFragmented(movie), 1 + fragments, true},
+    };
+    for (const Variant& variant : variants) {
+        WriteFile(path, variant.bytes);
+        MP4Decoder decoder;
+        MP4Reader reader;
+        if (!decoder.Open(path) || !reader.Open(path)) {
+            allPassed &= Check(false, std::string(variant.name) + " opened");
+            continue;
+        }
+        allPassed &= Check(reader.GetSampleCount() == movie.packets.size() &&
+                           reader.GetBoxesRead() == variant.boxesRead &&
+                           reader.IsFragmented() == variant.fragmented &&
+                           reader.GetDuration() == source.channels[0].size() &&
+                           reader.GetTrack().channels == 2 && reader.GetTrack().config.size() == 24,
+                           std::string(variant.name) + ": indexed by reading " +
+                           std::to_string(reader.GetBoxesRead()) + " box(es)");
+        allPassed &= Check(DecodeAll(decoder, 3000) == expected && decoder.GetLayout().GetName() == "stereo",
+                           std::string(variant.name) + ": decoded exactly");
+
+        // Seeks anywhere, including inside a packet, at the last frame and past it
+        bool landed = true;
+        for (uint64_t frame : {uint64_t(0), uint64_t(1), uint64_t(4095), uint64_t(4096), uint64_t(70001),
+                               uint64_t(4096 * 40 + 500), static_cast<uint64_t>(source.channels[0].size() - 1)}) {
+            std::vector<char> buffer(777 * blockAlign);
+            landed &= decoder.Seek(frame);
+            const size_t frames = decoder.Read(PcmBufferView(buffer.data(), 777, 2, 16));
+            const size_t expectedFrames = std::min<size_t>(777, source.channels[0].size() - frame);
+            landed &= frames == expectedFrames &&
+                      std::memcmp(buffer.data(), expected.data() + frame * blockAlign, frames * blockAlign) == 0;
+        }
+        landed &= !decoder.Seek(source.channels[0].size() + 1);
+        allPassed &= Check(landed, std::string(variant.name) + ": seeks land on the requested frame");
+    }
+
+    // An edit list starting 1000 frames in and stopping 500 frames early
+    Movie edited = movie;
+    edited.editStart = 1000;
+    edited.editDuration = static_cast<uint32_t>(source.channels[0].size() - 1500);
+    WriteFile(path, WriteMoovFirst(edited));
+    MP4Decoder decoder;
+    bool trimmed = decoder.Open(path);
+    const Bytes expectedTrimmed(expected.begin() + 1000 * blockAlign, expected.end() - 500 * blockAlign);
+    trimmed &= decoder.GetFrameCount() == source.channels[0].size() - 1500 &&
+               DecodeAll(decoder, 5000) == expectedTrimmed;
+    std::vector<char> buffer(10 * blockAlign);
+    trimmed &= decoder.Seek(10) && decoder.Read(PcmBufferView(buffer.data(), 10, 2, 16)) == 10 &&
+               std::memcmp(buffer.data(), expectedTrimmed.data() + 10 * blockAlign, 10 * blockAlign) == 0;
+    allPassed &= Check(trimmed, "Edit list trims the start and end");
+    return allPassed;
+}
+
+// Half a million samples in a 'moov' at the end of the file, all pointing at one packet
+static bool TestLargeIndex(const std::string& path) {
+    const uint32_t kSamples = 500000;
+    AlacConfig config;
+    config.frameLength = 1024;
+    const Source source = MakeSource(2, 1024, 16);
+    Movie movie = Encode(source, config, {PacketStyle()});
+    const Bytes ftyp = MakeFileType();
+    const Bytes mdat = MakeBox("mdat", movie.packets[0]);
+    movie.packets.assign(kSamples, movie.packets[0]);
+    movie.durations.assign(kSamples, 1024);
+    const std::vector<uint64_t> offsets(kSamples, ftyp.size() + 8);
+    const std::vector<uint32_t> samples(kSamples, 1);
+    WriteFile(path, Join({ftyp, mdat, MakeMovieBox(movie, offsets, samples, false)}));
+
+    MP4Reader reader;
+    const auto start = std::chrono::steady_clock::now();
+    bool opened = reader.Open(path);
+    const double milliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const double bytesPerSample = static_cast<double>(reader.GetIndexBytes()) / kSamples;
+    bool allPassed = Check(opened && reader.GetSampleCount() == kSamples && bytesPerSample < 8.1,
+                           "Indexed " + std::to_string(kSamples) + " samples in " +
+                           std::to_string(static_cast<int>(milliseconds)) + " ms, " +
+                           std::to_string(bytesPerSample).substr(0, 4) + " bytes per sample");
+    allPassed &= Check(reader.FindSample(1024ull * 400000 + 5) == 400000 &&
+                       reader.GetSampleTime(400000) == 1024ull * 400000 &&
+                       reader.GetSampleOffset(499999) == ftyp.size() + 8 &&
+                       reader.FindSample(1024ull * kSamples) == kSamples,
+                       "Sample lookups by time and by index");
+    return allPassed;
+}
+
+int main() {
+    std::cout << "=== MP4 / ALAC Test ===\n";
+    const std::string path = "mp4_alac_test.m4a";
+
+    bool allPassed = TestLayoutsAndSeeking(path);
+
+    std::vector<PacketStyle> shifted(3);
+    for (PacketStyle& style : shifted) {
+        style.bytesShifted = 1;
+    }
+    shifted[1].order = 31;
+    shifted[2].escape = true;
+    allPassed &= TestFormat(path, "24-bit stereo with shifted low bytes", 2, 24, shifted, {0, 1});
+
+    std::vector<PacketStyle> mono(2);
+    mono[1].mode = 1;
+    allPassed &= TestFormat(path, "20-bit mono", 1, 20, mono, {0});
+
+    std::vector<PacketStyle> surround(2);
+    surround[1].escape = true;
+    allPassed &= TestFormat(path, "5.1 (C L R Ls Rs LFE reordered to WAV)", 6, 16, surround, {2, 0, 1, 4, 5, 3});
+
+    allPassed &= TestLargeIndex(path);
+    std::remove(path.c_str());
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
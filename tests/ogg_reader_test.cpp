@@ -0,0 +1,196 @@
+#include "decoders/OggReader.h"
+#include "encoders/OggWriter.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Checks the Ogg demuxer: packets written by OggWriter read back intact with
+// their granule positions, packets spanning pages are reassembled, damaged
+// pages and foreign streams are skipped, and seeking lands on the last page
+// before the target after reading only a few pages.
+
+static const int64_t kPacketSamples = 960;
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+// Packet n starts with its index, followed by a pattern depending on it
+static std::vector<unsigned char> MakePacket(uint32_t index) {
+    std::vector<unsigned char> packet(8 + (index * 37) % 1500);
+    for (size_t i = 0; i < packet.size(); i++) {
+        packet[i] = i < 4 ? static_cast<unsigned char>(index >> (8 * i)) : static_cast<unsigned char>(index + i);
+    }
+    return packet;
+}
+
+static bool IsPacket(const OggReader::Packet& packet, uint32_t& index) {
+    if (packet.size < 8) {
+        return false;
+    }
+    index = packet.data[0] | (packet.data[1] << 8) | (packet.data[2] << 16) | (static_cast<uint32_t>(packet.data[3]) << 24);
+    const std::vector<unsigned char> expected = MakePacket(index);
+    return expected.size() == packet.size && std::equal(expected.begin(), expected.end(), packet.data);
+}
+
+// Two header packets on their own pages, then packets of 960 samples each
+static void WriteStream(const std::string& path, uint32_t packets) {
+    std::ofstream file(path, std::ios::binary);
+    OggWriter writer(file, 0x1234);
+    const unsigned char head[] = {'h', 'e', 'a', 'd'};
+    writer.WritePacket(head, sizeof(head), 0, true, false);
+    writer.WritePacket(head, sizeof(head), 0, true, false);
+    for (uint32_t i = 0; i < packets; i++) {
+        const std::vector<unsigned char> packet = MakePacket(i);
+        writer.WritePacket(packet.data(), packet.size(), (i + 1) * kPacketSamples, false, i + 1 == packets);
+    }
+}
+
+static bool OpenPastHeaders(OggReader& reader, const std::string& path) {
+    OggReader::Packet packet;
+    if (!reader.Open(path) || !reader.ReadPacket(packet) || !reader.ReadPacket(packet)) {
+        return false;
+    }
+    reader.MarkDataStart();
+    return true;
+}
+
+static bool TestRoundTrip(const std::string& path) {
+    const uint32_t kPackets = 3000;
+    WriteStream(path, kPackets);
+
+    OggReader reader;
+    bool intact = OpenPastHeaders(reader, path);
+    uint32_t count = 0;
+    bool granulesRight = true;
+    bool endMarked = false;
+    OggReader::Packet packet;
+    uint32_t index = 0;
+    while (reader.ReadPacket(packet)) {
+        intact &= IsPacket(packet, index) && index == count;
+        granulesRight &= packet.granulePosition < 0 || packet.granulePosition == (count + 1) * kPacketSamples;
+        endMarked = packet.endOfStream;
+        count++;
+    }
+    bool allPassed = Check(intact && count == kPackets && granulesRight && endMarked,
+                           "All packets read back with their granule positions");
+    int64_t last = 0;
+    int64_t previous = 0;
+    allPassed &= Check(reader.GetFinalGranulePositions(last, previous) && last == kPackets * kPacketSamples &&
+                       previous > 0 && previous < last && (last - previous) % kPacketSamples == 0,
+                       "Last two granule positions found from the end of the file");
+    return allPassed;
+}
+
+static bool TestSeeking(const std::string& path) {
+    const uint32_t kPackets = 20000;
+    WriteStream(path, kPackets);
+
+    OggReader reader;
+    if (!OpenPastHeaders(reader, path)) {
+        return Check(false, "Stream opened for seeking");
+    }
+
+    bool landed = true;
+    uint64_t mostPages = 0;
+    for (int64_t target : {int64_t(0), int64_t(500), int64_t(960 * 777 + 1), int64_t(960 * 10000),
+                           int64_t(960 * 19999 + 5), int64_t(960 * 30000)}) {
+        int64_t pageGranule = 0;
+        const uint64_t pagesBefore = reader.GetPagesRead();
+        landed &= reader.SeekToGranule(target, pageGranule);
+        mostPages = std::max(mostPages, reader.GetPagesRead() - pagesBefore);
+
+        // The next packet starts where the page found ends, and the next page reaches the target
+        OggReader::Packet packet;
+        uint32_t index = 0;
+        if (!reader.ReadPacket(packet)) {
+            landed &= pageGranule == kPackets * kPacketSamples;
+            continue;
+        }
+        landed &= IsPacket(packet, index) && pageGranule < target &&
+                  static_cast<int64_t>(index) * kPacketSamples == std::max<int64_t>(pageGranule, 0);
+        while (packet.granulePosition < 0 && reader.ReadPacket(packet)) {
+        }
+        landed &= packet.granulePosition >= target;
+    }
+    return Check(landed && mostPages <= 48, "Seeks land on the last page before the target (at most " +
+                 std::to_string(mostPages) + " pages read per seek)");
+}
+
+// Append a page built by hand, to cover what OggWriter never writes
+static void AppendPage(std::vector<unsigned char>& file, uint32_t serial, uint32_t sequence, unsigned char flags,
+                       int64_t granule, const std::vector<unsigned char>& lacing) {
+    std::vector<unsigned char> page = {'O', 'g', 'g', 'S', 0, flags};
+    for (int i = 0; i < 8; i++) {
+        page.push_back(static_cast<unsigned char>(static_cast<uint64_t>(granule) >> (8 * i)));
+    }
+    for (int i = 0; i < 4; i++) {
+        page.push_back(static_cast<unsigned char>(serial >> (8 * i)));
+    }
+    for (int i = 0; i < 4; i++) {
+        page.push_back(static_cast<unsigned char>(sequence >> (8 * i)));
+    }
+    page.insert(page.end(), {0, 0, 0, 0, static_cast<unsigned char>(lacing.size())});
+    page.insert(page.end(), lacing.begin(), lacing.end());
+    size_t bodySize = 0;
+    for (unsigned char value : lacing) {
+        bodySize += value;
+    }
+    for (size_t i = 0; i < bodySize; i++) {
+        page.push_back(static_cast<unsigned char>(sequence * 31 + i));
+    }
+    const uint32_t crc = OggWriter::Checksum(page.data(), page.size());
+    for (int i = 0; i < 4; i++) {
+        page[22 + i] = static_cast<unsigned char>(crc >> (8 * i));
+    }
+    file.insert(file.end(), page.begin(), page.end());
+}
+
+static bool TestSpanningAndDamage(const std::string& path) {
+    // Header page, then a 300-byte packet and the start of a 610-byte one, a page of another
+    // stream, the rest of that packet with a 50-byte packet, a page that will be damaged, and a last page
+    std::vector<unsigned char> bytes;
+    AppendPage(bytes, 7, 0, 0x02, 0, {10});
+    AppendPage(bytes, 7, 1, 0x00, 100, {255, 45, 255, 255});
+    AppendPage(bytes, 9, 0, 0x02, 0, {20});
+    AppendPage(bytes, 7, 2, 0x01, 200, {100, 50});
+    const size_t damaged = bytes.size();
+    AppendPage(bytes, 7, 3, 0x00, 300, {80, 255});
+    AppendPage(bytes, 7, 4, 0x05, 400, {10, 70});
+    bytes[damaged + 30] ^= 0x40;
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    OggReader reader;
+    std::vector<size_t> sizes;
+    std::vector<int64_t> granules;
+    OggReader::Packet packet;
+    bool opened = reader.Open(path);
+    while (opened && reader.ReadPacket(packet)) {
+        sizes.push_back(packet.size);
+        granules.push_back(packet.granulePosition);
+    }
+    // The damaged page's packets are lost, as is the one it continued into the last page
+    return Check(sizes == std::vector<size_t>({10, 300, 610, 50, 70}) &&
+                 granules == std::vector<int64_t>({0, 100, -1, 200, 400}),
+                 "Spanning packet reassembled; damaged page and other streams skipped");
+}
+
+int main() {
+    std::cout << "=== Ogg Reader Test ===\n";
+    const std::string path = "ogg_reader_test.ogg";
+
+    bool allPassed = TestRoundTrip(path);
+    allPassed &= TestSeeking(path);
+    allPassed &= TestSpanningAndDamage(path);
+    std::remove(path.c_str());
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+#include "core/OutputBuffering.h"
+#include <iostream>
+#include <string>
+
+// Checks the output buffering policy: settings outside the supported range
+// are rejected, the presets give the documented latencies, fixed buffering
+// only counts underruns, and adaptive buffering doubles the queue after an
+// underrun and gives one period back per stable interval, never going below
+// the configured count or above the maximum.
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+static const int kSampleRate = 44100;
+
+// Queue periods for a number of seconds without an underrun
+static void PlayStable(OutputBuffering& buffering, double seconds) {
+    const size_t periods = static_cast<size_t>(seconds * kSampleRate / buffering.GetPeriodFrames());
+    for (size_t i = 0; i < periods; i++) {
+        buffering.OnPeriodQueued();
+    }
+}
+
+static bool TestSettings() {
+    std::string error;
+    bool allPassed = Check(OutputBuffering::Validate(BufferSettings(), error), "Default settings are valid");
+    bool rejected = !OutputBuffering::Validate({32, 4, false}, error) && !OutputBuffering::Validate({1024, 1, false}, error) &&
+                    !OutputBuffering::Validate({1024, 17, true}, error);
+    allPassed &= Check(rejected, "Out-of-range settings rejected: " + error);
+
+    BufferSettings lowLatency, powerSaving;
+    OutputBuffering low, saving;
+    bool known = OutputBuffering::GetPreset("low-latency", lowLatency) && OutputBuffering::GetPreset("power-saving", powerSaving);
+    low.Start(lowLatency, kSampleRate);
+    saving.Start(powerSaving, kSampleRate);
+    allPassed &= Check(known && lowLatency.adaptive && low.GetLatencyMs() < 10.0 && saving.GetLatencyMs() > 500.0 &&
+                       OutputBuffering::Validate(lowLatency, error) && OutputBuffering::Validate(powerSaving, error),
+                       "Presets: " + low.Describe() + "; " + saving.Describe());
+    allPassed &= Check(!OutputBuffering::GetPreset("turbo", lowLatency), "Unknown preset rejected");
+    return allPassed;
+}
+
+static bool TestFixed() {
+    OutputBuffering buffering;
+    buffering.Start({256, 4, false}, kSampleRate);
+    buffering.OnUnderrun();
+    buffering.OnUnderrun();
+    PlayStable(buffering, 30.0);
+    return Check(buffering.GetPeriodCount() == 4 && buffering.GetUnderrunCount() == 2,
+                 "Fixed buffering counts underruns without resizing: " + buffering.Describe());
+}
+
+static bool TestAdaptive() {
+    OutputBuffering buffering;
+    buffering.Start({128, 3, true}, kSampleRate);
+
+    buffering.OnUnderrun();
+    bool allPassed = Check(buffering.GetPeriodCount() == 6, "Underrun doubles the queue: " + buffering.Describe());
+    buffering.OnUnderrun();
+    buffering.OnUnderrun();
+    allPassed &= Check(buffering.GetPeriodCount() == OutputBuffering::kMaxPeriodCount,
+                       "Queue capped at the maximum: " + buffering.Describe());
+
+    PlayStable(buffering, OutputBuffering::kStableSeconds * 0.9);
+    allPassed &= Check(buffering.GetPeriodCount() == OutputBuffering::kMaxPeriodCount, "No shrinking before the stable interval");
+    PlayStable(buffering, OutputBuffering::kStableSeconds * 0.2);
+    allPassed &= Check(buffering.GetPeriodCount() == OutputBuffering::kMaxPeriodCount - 1,
+                       "One period removed after a stable interval: " + buffering.Describe());
+
+    PlayStable(buffering, OutputBuffering::kStableSeconds * 30);
+    allPassed &= Check(buffering.GetPeriodCount() == 3 && buffering.GetUnderrunCount() == 3,
+                       "Shrinks back to the configured count: " + buffering.Describe());
+
+    buffering.Start({128, 3, true}, kSampleRate);
+    allPassed &= Check(buffering.GetPeriodCount() == 3 && buffering.GetUnderrunCount() == 0, "Start resets the session");
+    return allPassed;
+}
+
+int main() {
+    std::cout << "=== Output Buffering Test ===\n";
+
+    bool allPassed = TestSettings();
+    allPassed &= TestFixed();
+    allPassed &= TestAdaptive();
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,200 @@
+#include "dsp/SampleFormat.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Checks the sample format kernels against straightforward per-sample
+// conversions: decoding every 8- and 16-bit code and random 24/32-bit codes,
+// encoding random, clipped, exactly-halfway and out-of-range samples with
+// the same rounding as lrint, big-endian containers, FLAC-style planar
+// interleaving, and the dispatch table. Also reports the kernel speed
+// against a runtime-dispatched reference loop.
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+// Reference conversions, branching on the sample size per call
+static float ReferenceDecode(const unsigned char* pcm, int bits) {
+    if (bits == 8) {
+        return (static_cast<int>(pcm[0]) - 128) / 128.0f;
+    }
+    if (bits == 16) {
+        return static_cast<int16_t>(pcm[0] | (pcm[1] << 8)) / 32768.0f;
+    }
+    if (bits == 24) {
+        int32_t value = static_cast<int32_t>((static_cast<uint32_t>(pcm[0]) << 8) | (static_cast<uint32_t>(pcm[1]) << 16) |
+                                             (static_cast<uint32_t>(pcm[2]) << 24));
+        return (value >> 8) / 8388608.0f;
+    }
+    int32_t value = static_cast<int32_t>(pcm[0] | (pcm[1] << 8) | (pcm[2] << 16) | (static_cast<uint32_t>(pcm[3]) << 24));
+    return value / 2147483648.0f;
+}
+
+static void ReferenceEncode(float sample, unsigned char* pcm, int bits) {
+    if (bits == 32) {
+        double clipped = std::max(-1.0, std::min(1.0, static_cast<double>(sample)));
+        uint32_t value = static_cast<uint32_t>(static_cast<int32_t>(std::lrint(clipped * 2147483647.0)));
+        for (int byte = 0; byte < 4; byte++) {
+            pcm[byte] = static_cast<unsigned char>(value >> (8 * byte));
+        }
+        return;
+    }
+    float clipped = std::max(-1.0f, std::min(1.0f, sample));
+    float scale = bits == 8 ? 127.0f : bits == 16 ? 32767.0f : 8388607.0f;
+    int32_t value = static_cast<int32_t>(std::lrintf(clipped * scale));
+    if (bits == 8) {
+        pcm[0] = static_cast<unsigned char>(value + 128);
+        return;
+    }
+    for (int byte = 0; byte < bits / 8; byte++) {
+        pcm[byte] = static_cast<unsigned char>(static_cast<uint32_t>(value) >> (8 * byte));
+    }
+}
+
+static std::vector<float> TestSamples(int bits) {
+    std::mt19937 random(bits);
+    std::uniform_real_distribution<float> distribution(-1.2f, 1.2f);
+    std::vector<float> samples = {0.0f, -0.0f, 1.0f, -1.0f, 1.5f, -1.5f, 1e9f, -1e9f, 1e-30f};
+    // Values whose scaled form lies exactly halfway between two integers
+    const double scale = (1ULL << (bits - 1)) - 1.0;
+    for (int halfway = -41; halfway <= 41; halfway += 2) {
+        samples.push_back(static_cast<float>(halfway * 0.5 / scale));
+    }
+    for (int i = 0; i < 100000; i++) {
+        samples.push_back(distribution(random));
+    }
+    return samples;
+}
+
+template <typename Format>
+static bool TestFormat() {
+    const int bits = Format::kBits;
+    const SampleFormat::Codec& codec = SampleFormat::GetCodec(bits);
+    std::mt19937 random(bits + 1);
+
+    // Every code for 8 and 16 bits; random codes for 24 and 32
+    const size_t codes = bits <= 16 ? (size_t(1) << bits) : 200000;
+    std::vector<unsigned char> pcm(codes * Format::kBytes);
+    for (size_t i = 0; i < codes; i++) {
+        uint32_t value = bits <= 16 ? static_cast<uint32_t>(i) : random();
+        for (int byte = 0; byte < Format::kBytes; byte++) {
+            pcm[i * Format::kBytes + byte] = static_cast<unsigned char>(value >> (8 * byte));
+        }
+    }
+    std::vector<float> decoded(codes);
+    codec.decode(reinterpret_cast<const char*>(pcm.data()), decoded.data(), codes);
+    bool decodeMatches = true;
+    for (size_t i = 0; i < codes; i++) {
+        decodeMatches &= decoded[i] == ReferenceDecode(&pcm[i * Format::kBytes], bits);
+    }
+    bool allPassed = Check(decodeMatches, std::string(codec.name) + ": decode matches the reference for " +
+                           std::to_string(codes) + " codes");
+
+    std::vector<float> samples = TestSamples(bits);
+    std::vector<unsigned char> encoded(samples.size() * Format::kBytes);
+    std::vector<unsigned char> expected(samples.size() * Format::kBytes);
+    codec.encode(samples.data(), reinterpret_cast<char*>(encoded.data()), samples.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        ReferenceEncode(samples[i], &expected[i * Format::kBytes], bits);
+    }
+    allPassed &= Check(encoded == expected, std::string(codec.name) + ": encode matches lrint rounding and clipping for " +
+                       std::to_string(samples.size()) + " samples");
+    return allPassed;
+}
+
+static bool TestLayouts() {
+    // Big-endian containers round-trip and store the most significant byte first
+    const unsigned char bytes[3] = {0x80, 0x00, 0x01};
+    bool allPassed = Check(SampleFormat::Int24BigEndian::LoadInt(bytes) == -8388607 &&
+                           SampleFormat::Int16BigEndian::LoadInt(bytes) == -32768, "Big-endian samples decoded");
+    unsigned char stored[2];
+    SampleFormat::Int16BigEndian::Store(0.5f, stored);
+    allPassed &= Check(stored[0] == 0x40 && stored[1] == 0x00, "Big-endian samples encoded");
+
+    const float floats[3] = {0.25f, -1.5f, 3.0f};
+    std::vector<char> raw(sizeof(floats));
+    std::vector<float> back(3);
+    const SampleFormat::Codec& floatCodec = SampleFormat::GetCodec(32, true);
+    floatCodec.encode(floats, raw.data(), 3);
+    floatCodec.decode(raw.data(), back.data(), 3);
+    allPassed &= Check(floatCodec.isFloat && std::memcmp(back.data(), floats, sizeof(floats)) == 0,
+                       "Float samples pass through unclipped");
+
+    // 20-bit stereo and 12-bit 3-channel FLAC-style planes, shifted to the top of the container
+    const int32_t left[2] = {-524288, 1};
+    const int32_t right[2] = {524287, -1};
+    const int32_t* stereo[2] = {left, right};
+    std::vector<char> interleaved(2 * 2 * 3);
+    SampleFormat::GetInterleaveKernel(24, 2)(stereo, 2, 2, 4, interleaved.data());
+    const unsigned char* out = reinterpret_cast<const unsigned char*>(interleaved.data());
+    allPassed &= Check(SampleFormat::Int24::LoadInt(out) == -8388608 && SampleFormat::Int24::LoadInt(out + 3) == 8388592 &&
+                       SampleFormat::Int24::LoadInt(out + 6) == 16 && SampleFormat::Int24::LoadInt(out + 9) == -16,
+                       "Stereo planes interleaved into 24-bit samples");
+
+    const int32_t a[1] = {-2048}, b[1] = {0}, c[1] = {2047};
+    const int32_t* three[3] = {a, b, c};
+    std::vector<char> bytes8(3);
+    SampleFormat::GetInterleaveKernel(16, 3)(three, 3, 1, 4, interleaved.data());
+    SampleFormat::GetInterleaveKernel(8, 1)(three + 2, 1, 1, 0, bytes8.data());
+    const unsigned char* out16 = reinterpret_cast<const unsigned char*>(interleaved.data());
+    allPassed &= Check(SampleFormat::Int16::LoadInt(out16) == -32768 && SampleFormat::Int16::LoadInt(out16 + 2) == 0 &&
+                       SampleFormat::Int16::LoadInt(out16 + 4) == 32752 &&
+                       static_cast<unsigned char>(bytes8[0]) == static_cast<unsigned char>(2047 + 128),
+                       "Other channel counts interleaved; 8-bit samples stored unsigned");
+
+    allPassed &= Check(SampleFormat::GetCodec(20).bitsPerSample == 0 && !SampleFormat::GetInterleaveKernel(12, 2),
+                       "Unsupported sizes have no kernels");
+    return allPassed;
+}
+
+static void Benchmark() {
+    const size_t samples = 1 << 20;
+    std::vector<float> source = TestSamples(16);
+    source.resize(samples, 0.25f);
+    std::vector<unsigned char> pcm(samples * 2);
+    std::vector<float> decoded(samples);
+    const SampleFormat::Codec& codec = SampleFormat::GetCodec(16);
+
+    auto time = [](auto body) {
+        auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < 20; pass++) {
+            body();
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / 20;
+    };
+    double reference = time([&]() {
+        for (size_t i = 0; i < samples; i++) {
+            ReferenceEncode(source[i], &pcm[2 * i], 16);
+        }
+        for (size_t i = 0; i < samples; i++) {
+            decoded[i] = ReferenceDecode(&pcm[2 * i], 16);
+        }
+    });
+    double kernels = time([&]() {
+        codec.encode(source.data(), reinterpret_cast<char*>(pcm.data()), samples);
+        codec.decode(reinterpret_cast<const char*>(pcm.data()), decoded.data(), samples);
+    });
+    std::cout << "  16-bit encode + decode of " << samples << " samples: " << kernels << "ms (reference loop "
+              << reference << "ms)\n";
+}
+
+int main() {
+    std::cout << "=== Sample Format Test ===\n";
+
+    bool allPassed = TestFormat<SampleFormat::UInt8>();
+    allPassed &= TestFormat<SampleFormat::Int16>();
+    allPassed &= TestFormat<SampleFormat::Int24>();
+    allPassed &= TestFormat<SampleFormat::Int32>();
+    allPassed &= TestLayouts();
+    Benchmark();
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+#include "dsp/StreamMixer.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Checks the stream mixer: equal-power pan and balance, gain ramps applied
+// through the command queues, end of clip and looping, the voice budget, and
+// the cost of mixing hundreds of voices as a share of real time.
+
+static const size_t kBlock = 256;
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+static std::shared_ptr<const AudioClip> MakeClip(int channels, size_t frames, float value) {
+    auto clip = std::make_shared<AudioClip>();
+    clip->sampleRate = 48000;
+    clip->channels.assign(channels, std::vector<float>(frames, value));
+    return clip;
+}
+
+static bool Near(float a, float b) {
+    return std::fabs(a - b) < 1e-5f;
+}
+
+static bool TestPan() {
+    StreamMixer mixer;
+    mixer.Prepare(2, kBlock, 8);
+    std::vector<float> output(kBlock * 2, 0.0f);
+
+    // Mono panned hard left, mono centered, stereo balanced half right
+    int left = mixer.AddVoice(MakeClip(1, 4096, 1.0f), 1.0f, -1.0f);
+    mixer.Process(output.data(), kBlock);
+    bool allPassed = Check(left >= 0 && Near(output[0], 1.0f) && Near(output[1], 0.0f), "Mono voice panned hard left");
+    mixer.StopAll();
+    mixer.Process(output.data(), kBlock);
+
+    output.assign(output.size(), 0.0f);
+    mixer.AddVoice(MakeClip(1, 4096, 1.0f), 0.5f, 0.0f);
+    mixer.Process(output.data(), kBlock);
+    allPassed &= Check(Near(output[0], 0.5f * std::sqrt(0.5f)) && Near(output[1], 0.5f * std::sqrt(0.5f)),
+                       "Centered mono voice is -3 dB on each side");
+    mixer.StopAll();
+    mixer.Process(output.data(), kBlock);
+
+    output.assign(output.size(), 0.0f);
+    mixer.AddVoice(MakeClip(2, 4096, 1.0f), 1.0f, 0.5f);
+    mixer.Process(output.data(), kBlock);
+    allPassed &= Check(Near(output[0], 0.5f) && Near(output[1], 1.0f), "Stereo balance attenuates the opposite side");
+    return allPassed;
+}
+
+static bool TestCommands() {
+    StreamMixer mixer;
+    mixer.Prepare(1, kBlock, 4);
+    std::vector<float> output(kBlock, 0.0f);
+
+    int voice = mixer.AddVoice(MakeClip(1, 48000, 1.0f), 1.0f, 0.0f);
+    mixer.Process(output.data(), kBlock);
+    bool allPassed = Check(Near(output[0], 1.0f) && Near(output[kBlock - 1], 1.0f), "Voice starts at its gain");
+
+    // The new gain ramps in over the next block
+    mixer.SetGain(voice, 0.0f);
+    output.assign(kBlock, 0.0f);
+    mixer.Process(output.data(), kBlock);
+    bool ramp = output[0] < 1.0f && output[0] > 0.99f && Near(output[kBlock - 1], 0.0f);
+    for (size_t i = 1; i < kBlock; i++) {
+        ramp &= output[i] < output[i - 1];
+    }
+    allPassed &= Check(ramp, "Gain change ramps down over one block");
+
+    allPassed &= Check(mixer.StopVoice(voice), "Stop is queued");
+    mixer.Process(output.data(), kBlock);
+    allPassed &= Check(mixer.GetActiveVoiceCount() == 0 && !mixer.SetGain(voice, 1.0f),
+                       "Stopped voice is gone and its ID is rejected");
+    int reused = mixer.AddVoice(MakeClip(1, 16, 1.0f), 1.0f, 0.0f);
+    allPassed &= Check(reused >= 0 && reused != voice, "Slot is reused with a new ID");
+    return allPassed;
+}
+
+static bool TestEndAndLoop() {
+    StreamMixer mixer;
+    mixer.Prepare(1, kBlock, 4);
+    std::vector<float> output(kBlock, 0.0f);
+
+    auto clip = std::make_shared<AudioClip>();
+    clip->sampleRate = 48000;
+    clip->channels.assign(1, std::vector<float>(100));
+    for (size_t i = 0; i < 100; i++) {
+        clip->channels[0][i] = static_cast<float>(i);
+    }
+
+    mixer.AddVoice(clip, 1.0f, 0.0f);
+    mixer.Process(output.data(), kBlock);
+    bool allPassed = Check(output[99] == 99.0f && output[100] == 0.0f && mixer.GetActiveVoiceCount() == 0,
+                           "One-shot voice ends with its clip");
+
+    output.assign(kBlock, 0.0f);
+    mixer.AddVoice(clip, 1.0f, 0.0f, true);
+    mixer.Process(output.data(), kBlock);
+    std::vector<StreamMixer::VoiceInfo> voices = mixer.GetVoices();
+    allPassed &= Check(output[100] == 0.0f && output[150] == 50.0f && output[255] == 55.0f &&
+                       voices.size() == 1 && Near(static_cast<float>(voices[0].position), 56.0f / 48000),
+                       "Looping voice wraps around within a block");
+    return allPassed;
+}
+
+static bool TestBudget() {
+    StreamMixer mixer;
+    mixer.Prepare(1, kBlock, 16);
+    mixer.SetVoiceBudget(4);
+    std::vector<float> output(kBlock, 0.0f);
+
+    for (int i = 1; i <= 10; i++) {
+        mixer.AddVoice(MakeClip(1, 48000, 1.0f), i * 0.01f, 0.0f);
+    }
+    mixer.Process(output.data(), kBlock);
+    return Check(mixer.GetActiveVoiceCount() == 10 && mixer.GetMixedVoiceCount() == 4 &&
+                 Near(output[0], 0.07f + 0.08f + 0.09f + 0.10f), "Only the four loudest voices are mixed");
+}
+
+// Mix stereo voices into a stereo output and return the share of real time used
+static double TimeMixing(size_t voiceCount, size_t budget) {
+    const size_t kRenderBlock = 1024;
+    StreamMixer mixer;
+    mixer.Prepare(2, kRenderBlock, voiceCount);
+    mixer.SetVoiceBudget(budget);
+    auto clip = MakeClip(2, 48000 * 2, 0.001f);
+    for (size_t i = 0; i < voiceCount; i++) {
+        mixer.AddVoice(clip, 0.5f + 0.001f * i, (i % 21) / 10.0f - 1.0f, true);
+    }
+
+    std::vector<float> output(kRenderBlock * 2);
+    const size_t blocks = 48000 * 2 / kRenderBlock;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t block = 0; block < blocks; block++) {
+        if (block % 8 == 0) {
+            mixer.SetGain(static_cast<int>(block % voiceCount), 0.25f);
+        }
+        mixer.Process(output.data(), kRenderBlock);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds / (blocks * kRenderBlock / 48000.0);
+}
+
+static bool TestCost() {
+    double full = TimeMixing(256, 256);
+    bool allPassed = Check(full < 0.25, "256 stereo voices at 48 kHz: " + std::to_string(100.0 * full) + "% of real time");
+    double limited = TimeMixing(256, 64);
+    allPassed &= Check(limited < full, "Budget of 64 voices: " + std::to_string(100.0 * limited) + "% of real time");
+    return allPassed;
+}
+
+int main() {
+    std::cout << "=== Stream Mixer Test ===\n";
+
+    bool allPassed = TestPan();
+    allPassed &= TestCommands();
+    allPassed &= TestEndAndLoop();
+    allPassed &= TestBudget();
+    allPassed &= TestCost();
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
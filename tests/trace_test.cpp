@@ -0,0 +1,140 @@
+// The markers under test compile to nothing without this; the player's build
+// defines it only for its own target
+#ifndef ENABLE_TRACING
+#define ENABLE_TRACING 1
+#endif
+
+#include "core/Trace.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Checks the trace recorder: markers from several threads end up in the
+// Chrome trace JSON with their thread names and in time order, markers
+// outside the recording are left out, a thread that records more than its
+// ring holds keeps its newest events, and a marker costs far less than 1% of
+// a render block. The recorder itself is skipped when Trace.cpp was built
+// without ENABLE_TRACING.
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+static std::string ReadFile(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+static size_t CountOf(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) {
+        count++;
+    }
+    return count;
+}
+
+static bool TestRecording() {
+    const std::string path = "trace_test.json";
+    {
+        GPU_PLAYER_TRACE_SCOPE("test", "before start");
+    }
+
+    std::string result;
+    bool started = Trace::Start(result);
+    bool startedTwice = Trace::Start(result);
+    GPU_PLAYER_TRACE_THREAD("main \"test\"");
+    {
+        GPU_PLAYER_TRACE_SCOPE("test", "outer");
+        GPU_PLAYER_TRACE_SCOPE("test", "inner");
+    }
+    std::thread worker([]() {
+        GPU_PLAYER_TRACE_THREAD("worker");
+        for (int i = 0; i < 10; i++) {
+            GPU_PLAYER_TRACE_SCOPE("test", "worker block");
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+    worker.join();
+    bool stopped = Trace::Stop(path, result);
+    {
+        GPU_PLAYER_TRACE_SCOPE("test", "after stop");
+    }
+
+    std::string json = ReadFile(path);
+    std::remove(path.c_str());
+    bool allPassed = Check(started && !startedTwice && stopped, "Start, second Start refused, Stop: " + result);
+    allPassed &= Check(json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[") == 0 && json.find("\n]}") != std::string::npos,
+                       "Chrome trace JSON written");
+    allPassed &= Check(CountOf(json, "\"ph\":\"X\"") == 12 && CountOf(json, "\"worker block\"") == 10,
+                       "12 complete events recorded");
+    allPassed &= Check(json.find("before start") == std::string::npos && json.find("after stop") == std::string::npos,
+                       "Markers outside the recording left out");
+    allPassed &= Check(json.find("\"name\":\"main \\\"test\\\"\"") != std::string::npos &&
+                       json.find("\"name\":\"worker\"") != std::string::npos, "Thread names written and escaped");
+    allPassed &= Check(json.find("\"outer\"") < json.find("\"inner\"") && json.find("\"inner\"") < json.find("\"worker block\""),
+                       "Events sorted by start time");
+    allPassed &= Check(!Trace::Stop(path, result), "Stop without a recording refused");
+    return allPassed;
+}
+
+static bool TestOverwrite() {
+    const std::string path = "trace_overwrite_test.json";
+    std::string result;
+    Trace::Start(result);
+    for (size_t i = 0; i < Trace::kEventsPerThread + 100; i++) {
+        GPU_PLAYER_TRACE_SCOPE("test", "flood");
+    }
+    Trace::Stop(path, result);
+    std::string json = ReadFile(path);
+    std::remove(path.c_str());
+    return Check(CountOf(json, "\"ph\":\"X\"") == Trace::kEventsPerThread &&
+                 result.find("100 older events overwritten") != std::string::npos,
+                 "Full ring keeps the newest events: " + result);
+}
+
+static bool TestOverhead() {
+    const int kMarkers = 1000000;
+    std::string result;
+    auto measure = [&]() {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kMarkers; i++) {
+            GPU_PLAYER_TRACE_SCOPE("test", "overhead");
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kMarkers;
+    };
+    double idle = measure();
+    Trace::Start(result);
+    double recording = measure();
+    Trace::Stop("trace_overhead_test.json", result);
+    std::remove("trace_overhead_test.json");
+
+    // A render block (1024 frames at 44.1kHz, 23ms) passes about 8 markers
+    double blockShare = 8.0 * recording / (1024.0 / 44100.0 * 1e9);
+    std::ostringstream description;
+    description << "Marker cost " << recording << "ns recording, " << idle << "ns idle ("
+                << blockShare * 100.0 << "% of a render block)";
+    return Check(blockShare < 0.01, description.str());
+}
+
+int main() {
+    std::cout << "=== Trace Test ===\n";
+    if (!Trace::IsCompiledIn()) {
+        std::cout << "Trace markers are compiled out, skipping\n";
+        return 0;
+    }
+
+    bool allPassed = TestRecording();
+    allPassed &= TestOverwrite();
+    allPassed &= TestOverhead();
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+#include "dsp/WaveformOverview.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Checks the waveform overview: every zoom level matches min/max/RMS computed
+// directly from the samples, ranges are answered at any width, a saved file
+// loads back identically and damaged files are rejected, and building runs
+// far faster than realtime.
+
+static bool Check(bool condition, const std::string& description) {
+    std::cout << (condition ? "✓ " : "✗ ") << description << "\n";
+    return condition;
+}
+
+static const int kSampleRate = 44100;
+
+// Stereo test signal: a decaying sine on the left, a louder square wave on the right
+static std::vector<float> MakeSignal(size_t frames) {
+    std::vector<float> samples(frames * 2);
+    for (size_t i = 0; i < frames; i++) {
+        double t = static_cast<double>(i) / kSampleRate;
+        samples[2 * i] = static_cast<float>(0.8 * std::exp(-t) * std::sin(2.0 * M_PI * 220.0 * t));
+        samples[2 * i + 1] = (i / 300) % 2 ? 0.25f : -0.5f;
+    }
+    return samples;
+}
+
+static WaveformOverview Build(const std::vector<float>& samples, size_t blockFrames) {
+    WaveformOverview overview;
+    overview.Begin(kSampleRate, 2);
+    const size_t frames = samples.size() / 2;
+    for (size_t start = 0; start < frames; start += blockFrames) {
+        overview.Append(&samples[start * 2], std::min(blockFrames, frames - start));
+    }
+    overview.Finish();
+    return overview;
+}
+
+// Compare each column against the samples it covers, allowing for the quantization
+static bool MatchesSamples(const WaveformOverview& overview, const std::vector<float>& samples,
+                           uint64_t start, uint64_t end, size_t width) {
+    std::vector<WaveformColumn> columns;
+    if (!overview.Query(start, end, width, columns) || columns.size() != width * 2) {
+        return false;
+    }
+    const double framesPerPixel = static_cast<double>(end - start) / width;
+    const float tolerance = 2.0f / 32767.0f;
+    for (size_t x = 0; x < width; x++) {
+        const uint64_t first = start + static_cast<uint64_t>(x * framesPerPixel);
+        const uint64_t last = std::max(first + 1, start + static_cast<uint64_t>((x + 1) * framesPerPixel));
+        for (int channel = 0; channel < 2; channel++) {
+            float minimum = 1.0f, maximum = -1.0f;
+            for (uint64_t i = first; i < last; i++) {
+                minimum = std::min(minimum, samples[2 * i + channel]);
+                maximum = std::max(maximum, samples[2 * i + channel]);
+            }
+            // Columns cover whole buckets, so they may reach a little beyond the exact range
+            const WaveformColumn& column = columns[x * 2 + channel];
+            if (column.min > minimum + tolerance || column.max < maximum - tolerance ||
+                column.rms > std::max(std::fabs(column.min), std::fabs(column.max)) + tolerance) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool TestLevels() {
+    const size_t frames = 10 * kSampleRate + 123;
+    std::vector<float> samples = MakeSignal(frames);
+    WaveformOverview overview = Build(samples, 1000);
+    bool allPassed = Check(overview.GetFrameCount() == frames && overview.GetLevelCount() == 11,
+                           "11 zoom levels for 10s at " + std::to_string(WaveformOverview::kBaseBucketFrames) +
+                           " frames per entry (" + std::to_string(overview.GetByteSize()) + " bytes)");
+
+    bool matches = true;
+    for (size_t width : {1, 7, 100, 1000, 5000}) {
+        matches &= MatchesSamples(overview, samples, 0, frames, width);
+        matches &= MatchesSamples(overview, samples, 12345, 12345 + 3 * kSampleRate, width);
+    }
+    allPassed &= Check(matches, "Columns bound the samples at widths from 1 to 5000");
+
+    // Whole-track RMS of the square wave: 300-frame halves at 0.25 and -0.5
+    std::vector<WaveformColumn> columns;
+    overview.Query(0, frames, 1, columns);
+    const float squareRms = std::sqrt((0.25f * 0.25f + 0.5f * 0.5f) / 2.0f);
+    allPassed &= Check(std::fabs(columns[1].rms - squareRms) < 0.002f && std::fabs(columns[1].min + 0.5f) < 1e-4f &&
+                       std::fabs(columns[1].max - 0.25f) < 1e-4f, "Top level holds the whole track's min/max/RMS");
+
+    WaveformOverview blocked = Build(samples, 77);
+    std::vector<WaveformColumn> other;
+    blocked.Query(0, frames, 1000, other);
+    overview.Query(0, frames, 1000, columns);
+    bool same = columns.size() == other.size();
+    for (size_t i = 0; same && i < columns.size(); i++) {
+        same = columns[i].min == other[i].min && columns[i].max == other[i].max &&
+               std::fabs(columns[i].rms - other[i].rms) < 2e-5f;
+    }
+    allPassed &= Check(same, "Result does not depend on the block size while building");
+
+    allPassed &= Check(overview.Query(frames - 100, frames + 10000, 50, columns) && columns.back().max == 0.0f,
+                       "Columns past the end are silent");
+    return allPassed;
+}
+
+static bool TestFile() {
+    std::vector<float> samples = MakeSignal(3 * kSampleRate);
+    WaveformOverview overview = Build(samples, 4096);
+    const std::string path = "waveform_test.wfo";
+    bool allPassed = Check(overview.Save(path), "Overview saved");
+
+    WaveformOverview loaded;
+    std::vector<WaveformColumn> expected, actual;
+    overview.Query(1000, 100000, 333, expected);
+    bool same = loaded.Load(path) && loaded.Query(1000, 100000, 333, actual) && loaded.GetSampleRate() == kSampleRate &&
+                loaded.GetChannelCount() == 2 && loaded.GetFrameCount() == overview.GetFrameCount();
+    for (size_t i = 0; same && i < expected.size(); i++) {
+        same = expected[i].min == actual[i].min && expected[i].max == actual[i].max && expected[i].rms == actual[i].rms;
+    }
+    allPassed &= Check(same, "Loaded overview answers queries identically");
+
+    // Drop the last byte: the level sizes no longer add up
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    std::vector<char> bytes(1024 * 1024);
+    size_t size = std::fread(bytes.data(), 1, bytes.size(), file);
+    std::fclose(file);
+    file = std::fopen(path.c_str(), "wb");
+    std::fwrite(bytes.data(), 1, size - 1, file);
+    std::fclose(file);
+    WaveformOverview damaged;
+    allPassed &= Check(!damaged.Load(path) && damaged.GetLevelCount() == 0, "Truncated file is rejected");
+    std::remove(path.c_str());
+    return allPassed;
+}
+
+static bool TestSpeed() {
+    // One hour of stereo 44.1 kHz audio, fed in 4096-frame blocks
+    const size_t kBlock = 4096;
+    std::vector<float> block = MakeSignal(kBlock);
+    const size_t blocks = 3600 * kSampleRate / kBlock;
+    WaveformOverview overview;
+    overview.Begin(kSampleRate, 2);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < blocks; i++) {
+        overview.Append(block.data(), kBlock);
+    }
+    overview.Finish();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<WaveformColumn> columns;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1000; i++) {
+        overview.Query(i * 1000, overview.GetFrameCount(), 1920, columns);
+    }
+    double querySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 1000;
+    return Check(seconds < 1.0 && querySeconds < 0.001,
+                 "One hour of stereo built in " + std::to_string(seconds * 1000.0) + "ms (" +
+                 std::to_string(overview.GetByteSize() / 1024) + " KB), 1920 columns queried in " +
+                 std::to_string(querySeconds * 1e6) + "us");
+}
+
+int main() {
+    std::cout << "=== Waveform Overview Test ===\n";
+
+    bool allPassed = TestLevels();
+    allPassed &= TestFile();
+    allPassed &= TestSpeed();
+
+    std::cout << (allPassed ? "All tests passed!\n" : "Some tests failed\n");
+    return allPassed ? 0 : 1;
+}